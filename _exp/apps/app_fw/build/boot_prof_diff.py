@@ -0,0 +1,191 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder and comparison of boot phase profiles
+#
+# NOTES        :  A profile is read from either
+#                   - the EXP_FW_READ_BOOT_PROFILE TWI response data
+#                     (app_fw_boot_prof_struct, see app_fw_boot_prof.h), or
+#                   - a saved log read with EXP_FW_LOG_OP_READ_SAVED_JOURNAL,
+#                     where each boot appended one log_app_entry_struct per
+#                     milestone reached, starting with milestone 'main'.
+#
+#                 With one profile the phases are printed. With two, or a
+#                 saved log holding two boots or more, the phases of the
+#                 older (A) and newer (B) boot are compared.
+#
+#                 A phase is the time from the previous milestone reached
+#                 to a milestone, the phase of 'main' the time from reset. CP0 Count wraps within seconds, so phases
+#                 of 2 seconds or more use the timer0 seconds instead.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+BOOT_PROF_MAGIC = 0x46525042
+BOOT_PROF_VERSION = 1
+BOOT_PROF_HDR_FMT = '<IBBHIII'
+BOOT_PROF_MS_FMT = '<II'
+
+LOG_ENTRY_FMT = '<IIIIIIII'
+LOG_CODE_MID_APPFW = 0x0020
+LOG_CODE_BOOT_PROF = 0xB000
+
+# app_fw_boot_ms_enum order
+MILESTONES = [
+    'main',
+    'mem_init',
+    'console_init',
+    'log_init',
+    'gic_init',
+    'spi_flash_init',
+    'red_fw_image_update',
+    'ech_init',
+    'modules_init',
+    'twi_init',
+    'temp_sensor_init',
+    'main_loop',
+    'serdes_init',
+    'boot_cfg_0',
+    'boot_cfg_1',
+    'ddr_train',
+    'ddr_cal_save',
+]
+
+
+class BootProfile(object):
+    """Milestones of one boot: {index: (count, seconds)}."""
+
+    def __init__(self, ticks_per_ms, fw_version, ms):
+        self.ticks_per_ms = ticks_per_ms
+        self.fw_version = fw_version
+        self.ms = ms
+
+    def phases_us(self):
+        """Return [(name, phase_us)] in milestone order. The phase of 'main' is
+        the time from reset, None for a first milestone that is not 'main'."""
+        out = []
+        prev = None
+        for idx in sorted(self.ms):
+            count, seconds = self.ms[idx]
+            phase = None
+            if prev is None:
+                if 0 == idx and self.ticks_per_ms:
+                    phase = count * 1000.0 / self.ticks_per_ms
+            else:
+                d_sec = (seconds - prev[1]) & 0xFFFFFFFF
+                if d_sec < 2 and self.ticks_per_ms:
+                    phase = ((count - prev[0]) & 0xFFFFFFFF) * 1000.0 / self.ticks_per_ms
+                else:
+                    phase = d_sec * 1000000.0
+            name = MILESTONES[idx] if idx < len(MILESTONES) else 'ms_%d' % idx
+            out.append((name, phase))
+            prev = (count, seconds)
+        return out
+
+
+def twi_parse(data):
+    """Return [BootProfile] from a TWI response, [] if it is not one."""
+    hdr_size = struct.calcsize(BOOT_PROF_HDR_FMT)
+    if len(data) < hdr_size:
+        return []
+    magic, version, num_ms, _, ticks_per_ms, fw_version, mask = struct.unpack_from(BOOT_PROF_HDR_FMT, data, 0)
+    if magic != BOOT_PROF_MAGIC:
+        return []
+    if version != BOOT_PROF_VERSION:
+        raise ValueError('unsupported version %d' % version)
+    ms = {}
+    for idx in range(num_ms):
+        if mask & (1 << idx):
+            ms[idx] = struct.unpack_from(BOOT_PROF_MS_FMT, data, hdr_size + idx * struct.calcsize(BOOT_PROF_MS_FMT))
+    return [BootProfile(ticks_per_ms, fw_version, ms)]
+
+
+def saved_log_parse(data):
+    """Return [BootProfile] from a saved log, oldest boot first."""
+    size = struct.calcsize(LOG_ENTRY_FMT)
+    boots = []
+    for off in range(0, len(data) - size + 1, size):
+        ts_u, ts_l, code, w0, w1, _, _, _ = struct.unpack_from(LOG_ENTRY_FMT, data, off)
+        if (code >> 16) != LOG_CODE_MID_APPFW or (code & 0xF000) != LOG_CODE_BOOT_PROF:
+            continue
+        idx = code & 0x0FFF
+        if 0 == idx or not boots or idx in boots[-1].ms:
+            boots.append(BootProfile(w0, w1, {}))
+        boots[-1].ms[idx] = (ts_l, ts_u)
+    return boots
+
+
+def file_parse(name):
+    with open(name, 'rb') as f:
+        data = f.read()
+    return twi_parse(data) or saved_log_parse(data)
+
+
+def us_str(us):
+    return '-' if us is None else '%.0f' % us
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Print or compare boot phase profiles')
+    parser.add_argument('files', nargs='+', help='TWI boot profile or saved log files, oldest first')
+    parser.add_argument('-t', dest='threshold', type=float, default=0.0,
+                        help='only show phases that changed by more than this many percent')
+    args = parser.parse_args()
+
+    boots = []
+    for name in args.files:
+        try:
+            found = file_parse(name)
+        except (ValueError, struct.error) as e:
+            print('%s: %s' % (name, e))
+            return 1
+        if not found:
+            print('%s: no boot profile found' % name)
+            return 1
+        boots.extend(found)
+
+    if 1 == len(boots):
+        print('fw %d' % boots[0].fw_version)
+        print('%-20s %12s' % ('milestone', 'phase_us'))
+        for name, phase in boots[0].phases_us():
+            print('%-20s %12s' % (name, us_str(phase)))
+        return 0
+
+    a, b = boots[-2], boots[-1]
+    print('A: fw %d   B: fw %d' % (a.fw_version, b.fw_version))
+    print('%-20s %12s %12s %12s %8s' % ('milestone', 'A_us', 'B_us', 'delta_us', 'delta%'))
+    a_phases = dict(a.phases_us())
+    b_phases = dict(b.phases_us())
+    names = [n for n, _ in a.phases_us()] + [n for n, _ in b.phases_us() if n not in a_phases]
+    for name in names:
+        pa, pb = a_phases.get(name), b_phases.get(name)
+        if pa is None or pb is None:
+            print('%-20s %12s %12s %12s %8s' % (name, us_str(pa), us_str(pb), '-', '-'))
+            continue
+        pct = (pb - pa) * 100.0 / pa if pa else 0.0
+        if abs(pct) < args.threshold:
+            continue
+        print('%-20s %12.0f %12.0f %+12.0f %+7.1f%%' % (name, pa, pb, pb - pa, pct))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
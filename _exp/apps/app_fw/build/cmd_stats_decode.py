@@ -0,0 +1,116 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder for the per-command statistics returned by the
+#                 EXP_FW_LOG_OP_READ_CMD_STATS operands of EXP_FW_LOG or the
+#                 EXP_FW_READ_CMD_STATS TWI command
+#
+# NOTES        :  Image layout (little endian, see ech_stats.h):
+#                   0  magic          'ECST'
+#                   4  version
+#                   5  rec_size
+#                   6  num_buckets
+#                   7  bucket_shift
+#                   8  ticks_per_ms   CP0 Count ticks per millisecond
+#                   12 num_records
+#                   14 reserved
+#                   16 records        table, cmd_id, reserved, count,
+#                                     min, max, total (lo, hi), buckets
+#
+#                 Bucket 0 counts handler times below 2^bucket_shift ticks,
+#                 bucket n those below 2^(bucket_shift + n) ticks and the
+#                 last bucket all longer times.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+ECH_STATS_MAGIC = 0x54534345
+ECH_STATS_VERSION = 1
+ECH_STATS_HDR_FMT = '<IBBBBIHH'
+ECH_STATS_REC_FMT = '<BBHIIIII'
+
+ECH_STATS_TABLE = {0: 'OC', 1: 'TWI', 2: 'TWI_DEF'}
+
+
+def stats_parse(data):
+    """Return (ticks_per_ms, bucket_shift, [record dict]) from a statistics image."""
+    hdr_size = struct.calcsize(ECH_STATS_HDR_FMT)
+    (magic, version, rec_size, num_buckets, bucket_shift,
+     ticks_per_ms, num_records, _) = struct.unpack_from(ECH_STATS_HDR_FMT, data, 0)
+    if magic != ECH_STATS_MAGIC:
+        raise ValueError('bad magic 0x%08x' % magic)
+    if version != ECH_STATS_VERSION:
+        raise ValueError('unsupported version %d' % version)
+    if rec_size < struct.calcsize(ECH_STATS_REC_FMT) + 2 * num_buckets:
+        raise ValueError('record size %d too small' % rec_size)
+
+    records = []
+    offset = hdr_size
+    for _ in range(num_records):
+        if offset + rec_size > len(data):
+            raise ValueError('image truncated')
+        (table, cmd_id, _, count, min_cycles, max_cycles,
+         total_lo, total_hi) = struct.unpack_from(ECH_STATS_REC_FMT, data, offset)
+        buckets = struct.unpack_from('<%dH' % num_buckets, data, offset + struct.calcsize(ECH_STATS_REC_FMT))
+        offset += rec_size
+        records.append({'table': table, 'cmd_id': cmd_id, 'count': count,
+                        'min': min_cycles, 'max': max_cycles,
+                        'total': (total_hi << 32) | total_lo, 'buckets': buckets})
+    return ticks_per_ms, bucket_shift, records
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the per-command statistics')
+    parser.add_argument('-i', dest='infile', required=True, help='binary statistics image')
+    parser.add_argument('-t', dest='ticks', action='store_true', help='report times in CP0 Count ticks instead of us')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as f:
+        try:
+            ticks_per_ms, bucket_shift, records = stats_parse(f.read())
+        except (ValueError, struct.error) as e:
+            print('%s: %s' % (args.infile, e))
+            return 1
+
+    if args.ticks or 0 == ticks_per_ms:
+        scale, unit = 1.0, 'ticks'
+    else:
+        scale, unit = 1000.0 / ticks_per_ms, 'us'
+
+    print('%-7s %4s %8s %12s %12s %12s   (%s)' % ('table', 'cmd', 'count', 'min', 'avg', 'max', unit))
+    for r in records:
+        print('%-7s 0x%02x %8d %12.1f %12.1f %12.1f' %
+              (ECH_STATS_TABLE.get(r['table'], str(r['table'])), r['cmd_id'], r['count'],
+               r['min'] * scale, r['total'] * scale / max(r['count'], 1), r['max'] * scale))
+        for n, hits in enumerate(r['buckets']):
+            if 0 == hits:
+                continue
+            limit = (1 << (bucket_shift + n)) * scale
+            if n == len(r['buckets']) - 1:
+                label = '>= %.1f' % ((1 << (bucket_shift + n - 1)) * scale)
+            else:
+                label = '<  %.1f' % limit
+            print('%26s %-16s %8d' % ('', label, hits))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder for the per-command trace returned by the
+#                 EXP_FW_LOG_OP_READ_CMD_TRACE operand of EXP_FW_LOG or the
+#                 EXP_FW_READ_CMD_TRACE TWI command
+#
+# NOTES        :  Image layout (little endian, see ech_trace.h):
+#                   0  magic          'ETRC'
+#                   4  version
+#                   5  entry_size
+#                   6  num_rings
+#                   7  reserved
+#                   8  ticks_per_ms   CP0 Count ticks per millisecond
+#                   12 num_entries    UINT16 per ring
+#                   .. entries        per ring, oldest first
+#
+#                 Each entry holds the request identifier of an OC
+#                 command, so it can be matched with the host's log.
+#
+#                 Phases reported per command, in microseconds:
+#                   queue     received to handler called
+#                   handler   handler called to handler returned
+#                   response  received to response doorbell (OC) or final
+#                             status set (TWI)
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+ECH_TRACE_MAGIC = 0x43525445
+ECH_TRACE_VERSION = 2
+ECH_TRACE_HDR_FMT = '<IBBBBI'
+ECH_TRACE_ENTRY_FMT = '<IBBHB3xIIIIII'
+
+ECH_TRACE_SRC = {0: 'OC', 1: 'TWI'}
+ECH_TRACE_FLAG_DEFERRED = 0x01
+ECH_TRACE_FLAG_HELD = 0x02
+ECH_TRACE_FLAG_LOST = 0x80
+
+
+def trace_parse(data):
+    """Return (ticks_per_ms, [entry dict]) from a trace image."""
+    hdr_size = struct.calcsize(ECH_TRACE_HDR_FMT)
+    magic, version, entry_size, num_rings, _, ticks_per_ms = struct.unpack_from(ECH_TRACE_HDR_FMT, data, 0)
+    if magic != ECH_TRACE_MAGIC:
+        raise ValueError('bad magic 0x%08x' % magic)
+    if version != ECH_TRACE_VERSION:
+        raise ValueError('unsupported version %d' % version)
+    if entry_size < struct.calcsize(ECH_TRACE_ENTRY_FMT):
+        raise ValueError('entry size %d too small' % entry_size)
+    num_entries = struct.unpack_from('<%dH' % num_rings, data, hdr_size)
+    offset = hdr_size + 2 * num_rings
+
+    entries = []
+    for ring in range(num_rings):
+        for _ in range(num_entries[ring]):
+            if offset + entry_size > len(data):
+                raise ValueError('image truncated at ring %d' % ring)
+            (seq, src, cmd_id, req_id, flags, ext_len, rc,
+             t_rx, t_dispatch, t_return, t_doorbell) = struct.unpack_from(ECH_TRACE_ENTRY_FMT, data, offset)
+            offset += entry_size
+            entries.append({'ring': ring, 'seq': seq, 'src': src, 'cmd_id': cmd_id, 'req_id': req_id,
+                            'flags': flags, 'ext_len': ext_len, 'rc': rc,
+                            't_rx': t_rx, 't_dispatch': t_dispatch,
+                            't_return': t_return, 't_doorbell': t_doorbell})
+    return ticks_per_ms, entries
+
+
+def delta_us(start, end, ticks_per_ms):
+    """Return the time between two Count values in us, None if a phase was not reached."""
+    if 0 == start or 0 == end or 0 == ticks_per_ms:
+        return None
+    return ((end - start) & 0xFFFFFFFF) * 1000.0 / ticks_per_ms
+
+
+def us_str(us):
+    return '-' if us is None else '%.1f' % us
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the per-command trace')
+    parser.add_argument('-i', dest='infile', required=True, help='binary trace image')
+    parser.add_argument('-s', dest='summary', action='store_true', help='print only the per-command summary')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as f:
+        try:
+            ticks_per_ms, entries = trace_parse(f.read())
+        except (ValueError, struct.error) as e:
+            print('%s: %s' % (args.infile, e))
+            return 1
+
+    stats = {}
+    if not args.summary:
+        print('%4s %8s %-4s %4s %6s %10s %8s %10s %10s %10s %s' %
+              ('ring', 'seq', 'src', 'cmd', 'req', 'rc', 'ext_len', 'queue_us', 'handler_us', 'resp_us', 'flags'))
+    for e in entries:
+        queue = delta_us(e['t_rx'], e['t_dispatch'], ticks_per_ms)
+        handler = delta_us(e['t_dispatch'], e['t_return'], ticks_per_ms)
+        resp = delta_us(e['t_rx'], e['t_doorbell'], ticks_per_ms)
+        src = ECH_TRACE_SRC.get(e['src'], str(e['src']))
+        flags = []
+        if e['flags'] & ECH_TRACE_FLAG_DEFERRED:
+            flags.append('DEFERRED')
+        if e['flags'] & ECH_TRACE_FLAG_HELD:
+            flags.append('HELD')
+        if e['flags'] & ECH_TRACE_FLAG_LOST:
+            flags.append('LOST')
+        if not args.summary:
+            req = '0x%04x' % e['req_id'] if e['src'] == 0 else '-'
+            print('%4d %8d %-4s 0x%02x %6s 0x%08x %8d %10s %10s %10s %s' %
+                  (e['ring'], e['seq'], src, e['cmd_id'], req, e['rc'], e['ext_len'],
+                   us_str(queue), us_str(handler), us_str(resp), ','.join(flags)))
+        if e['flags'] & ECH_TRACE_FLAG_LOST or resp is None:
+            continue
+        s = stats.setdefault((src, e['cmd_id']), [0, 0.0, 0.0])
+        s[0] += 1
+        s[1] += resp
+        s[2] = max(s[2], resp)
+
+    print('')
+    print('%-4s %4s %6s %10s %10s' % ('src', 'cmd', 'count', 'avg_us', 'max_us'))
+    for (src, cmd_id), (count, total, worst) in sorted(stats.items()):
+        print('%-4s 0x%02x %6d %10.1f %10.1f' % (src, cmd_id, count, total / count, worst))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
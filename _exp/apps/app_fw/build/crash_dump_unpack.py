@@ -0,0 +1,251 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder for crash dump partitions read from SPI flash
+#
+# NOTES        :  The partition starts with a 1 KB header section of
+#                 crash_dump_header entries, followed by the data section.
+#                 With EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE the data
+#                 section holds compressed frames (see crash_dump_plat.h),
+#                 which are expanded back into the raw data section the
+#                 header entries refer to. Uncompressed dumps are accepted
+#                 as well.
+#
+#                 A compressed partition holds a series of crash dumps,
+#                 each starting on a subsector boundary. They are listed
+#                 oldest first and the newest is decoded unless -n selects
+#                 another one.
+#
+#                 The compression ratio is reported per section and per
+#                 section type. A block shared by several sections is
+#                 accounted to them in proportion to their raw bytes.
+#
+#*******************************************************************************/
+import os
+import sys
+import struct
+import argparse
+
+import fw_image_pack
+
+HEADER_SECTION_SIZE = 1024
+HEADER_KEY = 0xC7544EAD
+HEADER_FMT = '<I32sIII16s'
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+
+FRAME_MAGIC = 0x315A4443
+FRAME_FMT = '<IIII'
+FRAME_SIZE = struct.calcsize(FRAME_FMT)
+BLOCK_SIZE = 4096
+BLOCK_STORED = 0x80000000
+WINDOW_LOG2 = 12
+PAGE_SIZE = 256
+SUBSECTOR_SIZE = 4096
+
+TYPE_NAMES = {0: 'ASCII', 1: 'RAW'}
+
+# Must match crash_dump_lz_dict in crash_dump_plat.c
+CRASH_DUMP_DICT = (b'] = 0x00000000\n'
+                   b'[0] 0x00000000 0x00000000 0x00000000 0x00000000\n'
+                   b'FFFFFFFF ERROR FAILED PASSED _REG _CFG _STAT lane tx_ rx_ = 0x00\n')
+
+
+def headers_get(part):
+    """Return the header entries as (name, type, start_offset, size)."""
+    entries = []
+    for off in range(0, HEADER_SECTION_SIZE - HEADER_SIZE + 1, HEADER_SIZE):
+        key, name, typ, start, size, _ = struct.unpack(HEADER_FMT, part[off:off + HEADER_SIZE])
+        if key != HEADER_KEY:
+            break
+        entries.append((name.split(b'\0')[0].decode('ascii', 'replace'), typ, start, size))
+    return entries
+
+
+def frame_parse(data, off):
+    """Parse the compressed frame at an offset of the data section.
+
+    Returns (raw_offset, blocks, frame_len) with blocks a list of
+    (raw_len, stored, payload), or None if there is no valid frame.
+    """
+    if off + FRAME_SIZE > len(data):
+        return None
+    magic, raw_offset, raw_size, _ = struct.unpack(FRAME_FMT, data[off:off + FRAME_SIZE])
+    if magic != FRAME_MAGIC:
+        return None
+    pos = off + FRAME_SIZE
+    blocks = []
+    done = 0
+    while done < raw_size:
+        raw_len = min(raw_size - done, BLOCK_SIZE)
+        if pos + 4 > len(data):
+            return None
+        word, = struct.unpack('<I', data[pos:pos + 4])
+        pos += 4
+        payload_len = word & ~BLOCK_STORED
+        stored = bool(word & BLOCK_STORED)
+        if payload_len > len(data) - pos:
+            return None
+        if stored and payload_len != raw_len:
+            return None
+        if not stored and (payload_len == 0 or payload_len >= raw_len):
+            return None
+        blocks.append((raw_len, stored, data[pos:pos + payload_len]))
+        pos += payload_len
+        done += raw_len
+    return raw_offset, blocks, (pos - off + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)
+
+
+def frames_expand(data):
+    """Rebuild the raw data section from compressed frames.
+
+    Returns the raw data, a list of (raw_start, raw_len, stored_len) per
+    block and the length of the frames, or None if the data section is
+    not compressed.
+    """
+    raw = bytearray()
+    blocks = []
+    off = 0
+    while True:
+        frame = frame_parse(data, off)
+        if frame is None:
+            break
+        raw_offset, frame_blocks, frame_len = frame
+        start = raw_offset
+        for raw_len, stored, payload in frame_blocks:
+            if stored:
+                block = payload
+            else:
+                block = fw_image_pack.decompress(payload, raw_len, WINDOW_LOG2, CRASH_DUMP_DICT)
+            if len(raw) < start + raw_len:
+                raw += bytearray(start + raw_len - len(raw))
+            raw[start:start + raw_len] = block
+            blocks.append((start, raw_len, 4 + len(payload)))
+            start += raw_len
+        off += frame_len
+
+    if off == 0:
+        return None, None, 0
+    return bytes(raw), blocks, off
+
+
+def dumps_find(part):
+    """Return the offsets of the crash dumps in a compressed partition.
+
+    Each crash dump starts on a subsector boundary with its header
+    section, and a crash dump cut short by a reset has frames but no
+    header. The list is oldest first and empty if no frames are found.
+    """
+    dumps = []
+    off = 0
+    while off + HEADER_SECTION_SIZE <= len(part):
+        frames_len = 0
+        while True:
+            frame = frame_parse(part, off + HEADER_SECTION_SIZE + frames_len)
+            if frame is None:
+                break
+            frames_len += frame[2]
+        if headers_get(part[off:off + HEADER_SECTION_SIZE]):
+            dumps.append(off)
+        elif frames_len == 0:
+            off += SUBSECTOR_SIZE
+            continue
+        off = (off + HEADER_SECTION_SIZE + frames_len + SUBSECTOR_SIZE - 1) & ~(SUBSECTOR_SIZE - 1)
+    return dumps
+
+
+def stored_bytes(blocks, start, size):
+    """Flash bytes accounted to a raw range."""
+    total = 0.0
+    for b_start, b_len, b_stored in blocks:
+        overlap = min(b_start + b_len, start + size) - max(b_start, start)
+        if overlap > 0:
+            total += float(b_stored) * overlap / b_len
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a crash dump partition read from SPI flash')
+    parser.add_argument('-i', dest='infile', required=True, help='crash dump partition image')
+    parser.add_argument('-o', dest='outdir', help='directory to write one file per section to')
+    parser.add_argument('-r', dest='rawfile', help='file to write the raw data section to')
+    parser.add_argument('-n', dest='index', type=int, default=-1,
+                        help='crash dump to decode, 0 for the oldest (default: newest)')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as f:
+        part = f.read()
+
+    dumps = dumps_find(part)
+    if len(dumps) > 1:
+        for i, off in enumerate(dumps):
+            print('crash dump %d at 0x%06x' % (i, off))
+        print('')
+    if not dumps:
+        dumps = [0]
+    try:
+        part = part[dumps[args.index]:]
+    except IndexError:
+        print('%s: no crash dump %d' % (args.infile, args.index))
+        return 1
+
+    entries = headers_get(part)
+    if not entries:
+        print('%s: no crash dump' % args.infile)
+        return 1
+
+    raw, blocks, frames_len = frames_expand(part[HEADER_SECTION_SIZE:])
+    compressed = raw is not None
+    if not compressed:
+        raw = part[HEADER_SECTION_SIZE:]
+
+    if args.rawfile:
+        with open(args.rawfile, 'wb') as f:
+            f.write(raw)
+
+    print('%-32s %-6s %8s %8s %8s' % ('section', 'type', 'offset', 'size', 'ratio'))
+    per_type = {}
+    for name, typ, start, size in entries:
+        type_name = TYPE_NAMES.get(typ, str(typ))
+        stored = stored_bytes(blocks, start, size) if compressed else float(size)
+        raw_total, stored_total = per_type.get(type_name, (0, 0.0))
+        per_type[type_name] = (raw_total + size, stored_total + stored)
+        print('%-32s %-6s %8d %8d %7.1f%%' % (name, type_name, start, size, 100.0 * stored / max(size, 1)))
+
+        if args.outdir:
+            if not os.path.isdir(args.outdir):
+                os.makedirs(args.outdir)
+            ext = '.txt' if typ == 0 else '.bin'
+            with open(os.path.join(args.outdir, name + ext), 'wb') as f:
+                f.write(raw[start:start + size])
+
+    print('')
+    for type_name in sorted(per_type):
+        raw_total, stored_total = per_type[type_name]
+        print('%-6s %8d -> %8d bytes (%.1f%%)' % (type_name, raw_total, stored_total,
+                                                  100.0 * stored_total / max(raw_total, 1)))
+    if compressed:
+        used = sum(b[2] for b in blocks)
+        print('data section %d -> %d bytes in %d bytes of frames' % (len(raw), used, frames_len))
+    else:
+        print('data section is not compressed')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,253 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder for the compressed 2D eye captures returned by the
+#                 EXP_FW_PHY_INIT_READ_EYE_COMPRESSED and
+#                 EXP_FW_PHY_INIT_WRITE_EYE_COMPRESSED modes of
+#                 EXP_FW_DDR_PHY_INIT, renders the eye diagrams
+#
+# NOTES        :  A capture that does not fit in one response is read with
+#                 EXP_FW_PHY_INIT_EYE_READ at increasing offsets, pass the
+#                 chunks in order to reassemble it.
+#
+#                 Stream layout (little endian, see ddr_phy_eye.h):
+#                   0  magic          'EYEC'
+#                   4  version
+#                   5  type           0 read, 1 write
+#                   6  flags          1 bitmaps only, 2 some eyes reduced
+#                   7  num_steps      delay steps per eye
+#                   8  num_ranks, num_dbytes, num_bits, reserved
+#                   12 train_rc       return code of the capture training
+#                   16 msg_version    PHY training message block version
+#                   20 centers_len
+#                   22 num_eyes
+#                   24 stream_len
+#                   28 centers        as in train_2d_read/write_eye_msdg_t
+#                   .. eye records    [rank][dbyte][bit] order
+#
+#                 Eye rows are drawn from the highest Vref down, delay
+#                 offsets from -15 to +15 steps around the 1D center. A
+#                 passing point is '+', a failing one '.'. Eyes that are
+#                 only a pass/fail bitmap are drawn as one row.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+DDR_PHY_EYE_MAGIC = 0x43455945
+DDR_PHY_EYE_VERSION = 1
+DDR_PHY_EYE_HDR_FMT = '<IBBBBBBBBIIHHI'
+
+DDR_PHY_EYE_TYPE = {0: 'read', 1: 'write'}
+DDR_PHY_EYE_FLAG_BITMAP = 0x01
+DDR_PHY_EYE_FLAG_REDUCED = 0x02
+
+DDR_PHY_EYE_FMT_EMPTY = 0
+DDR_PHY_EYE_FMT_BITMAP = 1
+DDR_PHY_EYE_FMT_DELTA = 2
+DDR_PHY_EYE_FMT_RAW = 3
+
+DDR_PHY_EYE_TOKEN_REPEAT = 0x80
+DDR_PHY_EYE_TOKEN_ABS = 0xC0
+
+# size of the raw train_2d_eye_min_max_msdg_t, for the compression ratio
+DDR_PHY_EYE_RAW_SIZE = 124
+
+
+def row_decode(data, offset, num_steps):
+    """Decode one delta encoded row, return (values, offset)."""
+    (value,) = struct.unpack_from('<H', data, offset)
+    offset += 2
+    row = [value]
+    last = 0
+    while len(row) < num_steps:
+        token = data[offset]
+        offset += 1
+        if token < DDR_PHY_EYE_TOKEN_REPEAT:
+            last = token - 0x80 if token & 0x40 else token
+            row.append((row[-1] + last) & 0xFFFF)
+        elif token < DDR_PHY_EYE_TOKEN_ABS:
+            for _ in range((token & 0x3F) + 1):
+                row.append((row[-1] + last) & 0xFFFF)
+        elif token == DDR_PHY_EYE_TOKEN_ABS:
+            (value,) = struct.unpack_from('<H', data, offset)
+            offset += 2
+            row.append(value)
+            last = 0
+        else:
+            raise ValueError('bad token 0x%02x at offset %d' % (token, offset - 1))
+    if len(row) != num_steps:
+        raise ValueError('row overrun at offset %d' % offset)
+    return row, offset
+
+
+def stream_parse(data):
+    """Return (header dict, centers bytes, [eye dict]) from an eye stream."""
+    hdr_size = struct.calcsize(DDR_PHY_EYE_HDR_FMT)
+    (magic, version, typ, flags, num_steps, num_ranks, num_dbytes, num_bits, _,
+     train_rc, msg_version, centers_len, num_eyes, stream_len) = struct.unpack_from(DDR_PHY_EYE_HDR_FMT, data, 0)
+    if magic != DDR_PHY_EYE_MAGIC:
+        raise ValueError('bad magic 0x%08x' % magic)
+    if version != DDR_PHY_EYE_VERSION:
+        raise ValueError('unsupported version %d' % version)
+    if len(data) < stream_len:
+        raise ValueError('stream truncated, %d of %d bytes' % (len(data), stream_len))
+    if num_eyes != num_ranks * num_dbytes * num_bits:
+        raise ValueError('%d eyes for %dx%dx%d' % (num_eyes, num_ranks, num_dbytes, num_bits))
+    hdr = {'type': typ, 'flags': flags, 'num_steps': num_steps, 'num_ranks': num_ranks,
+           'num_dbytes': num_dbytes, 'num_bits': num_bits, 'train_rc': train_rc,
+           'msg_version': msg_version, 'stream_len': stream_len}
+
+    offset = hdr_size
+    centers = data[offset:offset + centers_len]
+    offset += centers_len
+
+    eyes = []
+    for i in range(num_eyes):
+        fmt = data[offset]
+        offset += 1
+        eye = {'rank': i // (num_dbytes * num_bits), 'dbyte': (i // num_bits) % num_dbytes,
+               'bit': i % num_bits, 'fmt': fmt, 'min': None, 'max': None, 'bitmap': None}
+        if fmt == DDR_PHY_EYE_FMT_EMPTY:
+            pass
+        elif fmt == DDR_PHY_EYE_FMT_BITMAP:
+            (eye['bitmap'],) = struct.unpack_from('<I', data, offset)
+            offset += 4
+        elif fmt == DDR_PHY_EYE_FMT_DELTA:
+            eye['min'], offset = row_decode(data, offset, num_steps)
+            eye['max'], offset = row_decode(data, offset, num_steps)
+        elif fmt == DDR_PHY_EYE_FMT_RAW:
+            eye['min'] = list(struct.unpack_from('<%dH' % num_steps, data, offset))
+            offset += 2 * num_steps
+            eye['max'] = list(struct.unpack_from('<%dH' % num_steps, data, offset))
+            offset += 2 * num_steps
+        else:
+            raise ValueError('bad format %d of eye %d' % (fmt, i))
+        eyes.append(eye)
+    if offset != stream_len:
+        raise ValueError('stream length %d, records end at %d' % (stream_len, offset))
+    return hdr, centers, eyes
+
+
+def centers_get(hdr, centers, eye):
+    """Return (vref_center, delay_center) of an eye, None if not available."""
+    nibbles = 2 * hdr['num_dbytes']
+    nibble = 2 * eye['dbyte'] + eye['bit'] // 4
+    per_bit = hdr['num_dbytes'] * hdr['num_bits']
+    bit = eye['dbyte'] * hdr['num_bits'] + eye['bit']
+    vals = struct.unpack('<%dH' % (len(centers) // 2), centers)
+    if hdr['type'] == 0:
+        # VrefDAC0_Center[DBYTEn][BITn], RxClkDly_Center[RANKi][NIBBLEn]
+        if len(vals) < per_bit + hdr['num_ranks'] * nibbles:
+            return None, None
+        return vals[bit], vals[per_bit + eye['rank'] * nibbles + nibble]
+    # VrefDQ_Center[RANKi][NIBBLEn], TxDqDly_Center[RANKi][DBYTEn][BITn]
+    base = hdr['num_ranks'] * nibbles
+    if len(vals) < base + hdr['num_ranks'] * per_bit:
+        return None, None
+    return vals[eye['rank'] * nibbles + nibble], vals[base + eye['rank'] * per_bit + bit]
+
+
+def step_pass(lo, hi):
+    return hi != 0 and hi >= lo
+
+
+def eye_render(eye, num_steps, vref_step):
+    """Return the lines of an eye diagram."""
+    mid = num_steps // 2
+    axis = ''.join('|' if s == mid else '-' for s in range(num_steps))
+    if eye['bitmap'] is not None:
+        row = ''.join('+' if eye['bitmap'] & (1 << s) else '.' for s in range(num_steps))
+        return ['   pass %s' % row, '        %s' % axis]
+    steps = [s for s in range(num_steps) if step_pass(eye['min'][s], eye['max'][s])]
+    if not steps:
+        return ['   no passing point']
+    top = max(eye['max'][s] for s in steps)
+    bottom = min(eye['min'][s] for s in steps)
+    lines = []
+    vref = top
+    while vref >= bottom:
+        row = ''
+        for s in range(num_steps):
+            lo, hi = eye['min'][s], eye['max'][s]
+            row += '+' if step_pass(lo, hi) and lo <= vref <= hi else '.'
+        lines.append('%7d %s' % (vref, row))
+        vref -= vref_step
+    lines.append('        %s' % axis)
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode and render a compressed 2D eye capture')
+    parser.add_argument('infiles', nargs='+', help='binary eye stream, or its chunks in order')
+    parser.add_argument('-r', dest='rank', type=int, help='render only this rank')
+    parser.add_argument('-d', dest='dbyte', type=int, help='render only this DBYTE')
+    parser.add_argument('-b', dest='bit', type=int, help='render only this bit')
+    parser.add_argument('-v', dest='vref_step', type=int, default=1, help='Vref codes per diagram row')
+    parser.add_argument('-s', dest='summary', action='store_true', help='print only the capture summary')
+    args = parser.parse_args()
+
+    data = b''
+    for name in args.infiles:
+        with open(name, 'rb') as f:
+            data += f.read()
+    try:
+        hdr, centers, eyes = stream_parse(data)
+    except (ValueError, IndexError, struct.error) as e:
+        print('%s: %s' % (args.infiles[0], e))
+        return 1
+
+    counts = {}
+    for eye in eyes:
+        counts[eye['fmt']] = counts.get(eye['fmt'], 0) + 1
+    raw_size = len(eyes) * DDR_PHY_EYE_RAW_SIZE + len(centers)
+    flags = []
+    if hdr['flags'] & DDR_PHY_EYE_FLAG_BITMAP:
+        flags.append('BITMAP')
+    if hdr['flags'] & DDR_PHY_EYE_FLAG_REDUCED:
+        flags.append('REDUCED')
+    print('%s eye, train rc 0x%08x, message block version 0x%08x, flags %s' %
+          (DDR_PHY_EYE_TYPE.get(hdr['type'], str(hdr['type'])), hdr['train_rc'],
+           hdr['msg_version'], ','.join(flags) or '-'))
+    print('%d eyes: %d empty, %d bitmap, %d delta, %d raw; %d bytes for %d raw (%.1fx)' %
+          (len(eyes), counts.get(DDR_PHY_EYE_FMT_EMPTY, 0), counts.get(DDR_PHY_EYE_FMT_BITMAP, 0),
+           counts.get(DDR_PHY_EYE_FMT_DELTA, 0), counts.get(DDR_PHY_EYE_FMT_RAW, 0),
+           hdr['stream_len'], raw_size, float(raw_size) / hdr['stream_len']))
+    if args.summary:
+        return 0
+
+    for eye in eyes:
+        if eye['fmt'] == DDR_PHY_EYE_FMT_EMPTY:
+            continue
+        if ((args.rank is not None and eye['rank'] != args.rank) or
+                (args.dbyte is not None and eye['dbyte'] != args.dbyte) or
+                (args.bit is not None and eye['bit'] != args.bit)):
+            continue
+        vref_center, delay_center = centers_get(hdr, centers, eye)
+        print('')
+        print('rank %d dbyte %d bit %d: vref center %s, delay center %s' %
+              (eye['rank'], eye['dbyte'], eye['bit'], vref_center, delay_center))
+        for line in eye_render(eye, hdr['num_steps'], max(1, args.vref_step)):
+            print(line)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,363 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Host model of the DDR PHY CSR space for checking warm boot
+#                 calibration restore without hardware
+#
+# NOTES        :  PHY CSRs are 16 bit and sit at PHY_APB_BASE + 4 * <csr>
+#                 on the Explorer APB.
+#
+#                 Scope: the model is a standalone tool, it is not linked
+#                 behind the firmware's CSR accessors in a host build. The
+#                 calibration restore (ddr_phy_init() with the saved data)
+#                 and the training are in release_lib/lib/libddr_phy.a, a
+#                 Green Hills build of MIPS objects that cannot be linked
+#                 into a host program. io_write16() and io_read16() are
+#                 global functions of its ddr_phy.o, also called directly
+#                 by firmware such as ddr_phy_train.c, so a host build
+#                 could replace them, but there is no host build of the
+#                 library code that calls them. The model does not execute
+#                 the restore: it checks its result from register dumps,
+#                 and the restore time it reports is modelled from access
+#                 counts, not measured. It works on what can be taken off a
+#                 board or written by hand:
+#
+#                 compare  PHY register dumps, the DDRPHY_REGS_SETx sections
+#                          of a crash dump written out by crash_dump_unpack.py
+#                          (fatal_dump_reg() lines "<addr>: <word> ..."). The
+#                          dump of a warm boot restore is checked against the
+#                          dump of a cold training, the golden run. CSRs that
+#                          hold status rather than trained state are skipped.
+#                          Exits with 1 on a mismatch.
+#
+#                 replay   a CSR access trace through the model, one access
+#                          per line, '#' starts a comment:
+#                            W <csr> <data>          write
+#                            R <csr> [<data>]        read, optionally checked
+#                            P <csr> <mask> <value>  poll until read & mask
+#                                                    equals value
+#                          The PMU mailbox registers answer from a script of
+#                          messages (-m), one per line:
+#                            major <id>
+#                            stream <coded> [<arg> ...]
+#                          and the host side of the mailbox handshake is
+#                          checked. The CSR state left by the trace can be
+#                          compared against a golden dump (-g), and the
+#                          access counts give the modelled restore time at
+#                          -c ns per APB access. The accesses are recorded in
+#                          trace format with -o.
+#
+#*******************************************************************************/
+import re
+import sys
+import argparse
+from collections import deque, OrderedDict
+
+PHY_APB_BASE = 0xA4000000
+PHY_APB_SIZE = 0x00400000
+
+# PMU mailbox, APBONLY block
+UCT_SHADOW_REGS = 0xD0004           # bit 0 UctWriteProtShadow, 0 when a message is waiting
+DCT_WRITE_PROT = 0xD0031            # 0 acknowledges a message, 1 releases the PMU
+UCT_WRITE_ONLY_SHADOW = 0xD0032     # message, low 16 bits
+UCT_DAT_WRITE_ONLY_SHADOW = 0xD0034 # message, high 16 bits
+STREAM_MSG = 0x08
+
+# (first csr, last csr, name), n is replaced by the instance
+BLOCKS = (
+    (0x00000, 0x0BFFF, 'ANIB%d'),
+    (0x10000, 0x19FFF, 'DBYTE%d'),
+    (0x20000, 0x20FFF, 'MASTER'),
+    (0x40000, 0x40FFF, 'ACSM'),
+    (0x50000, 0x53FFF, 'IMEM'),
+    (0x54000, 0x57FFF, 'DMEM'),
+    (0x70000, 0x70FFF, 'PPG'),
+    (0x90000, 0x9FFFF, 'INITENG'),
+    (0xC0000, 0xC0FFF, 'DRTUB'),
+    (0xD0000, 0xD0FFF, 'APBONLY'),
+)
+
+# Blocks holding status, counters and the PMU memories rather than trained state
+VOLATILE_BLOCKS = ('IMEM', 'DMEM', 'DRTUB', 'APBONLY')
+
+DEFAULT_ACCESS_NS = 100
+
+DUMP_LINE_RE = re.compile(r'^\s*([0-9a-fA-F]{8}):((?:\s+[0-9a-fA-F]{8})+)\s*$')
+
+
+def block_name(csr):
+    for first, last, name in BLOCKS:
+        if first <= csr <= last:
+            return name % ((csr >> 12) & 0xF) if '%' in name else name
+    return 'CSR'
+
+
+def csr_name(key):
+    if isinstance(key, str):
+        return key
+    return '%s 0x%05x' % (block_name(key), key)
+
+
+def dump_load(paths):
+    """Return {csr: value} from register dumps. Words outside the PHY are keyed by address string."""
+    regs = OrderedDict()
+    for path in paths:
+        with open(path, 'r', encoding='latin-1') as f:
+            for line in f:
+                m = DUMP_LINE_RE.match(line)
+                if not m:
+                    continue
+                addr = int(m.group(1), 16)
+                for i, word in enumerate(m.group(2).split()):
+                    a = addr + 4 * i
+                    if PHY_APB_BASE <= a < PHY_APB_BASE + PHY_APB_SIZE:
+                        regs[(a - PHY_APB_BASE) >> 2] = int(word, 16) & 0xFFFF
+                    else:
+                        regs['0x%08x' % a] = int(word, 16)
+    return regs
+
+
+def excluded(key, exclude):
+    if isinstance(key, str):
+        return False
+    if block_name(key) in VOLATILE_BLOCKS:
+        return True
+    return any(first <= key <= last for first, last in exclude)
+
+
+def regs_compare(golden, restored, exclude, only_restored=False):
+    """Return [(key, golden, restored)] of the differing registers, None for a missing one."""
+    diffs = []
+    for key, value in golden.items():
+        if excluded(key, exclude):
+            continue
+        if key not in restored:
+            if not only_restored:
+                diffs.append((key, value, None))
+        elif restored[key] != value:
+            diffs.append((key, value, restored[key]))
+    return diffs
+
+
+def diffs_report(diffs, checked, verbose):
+    by_block = OrderedDict()
+    for key, g, r in diffs:
+        by_block.setdefault(csr_name(key).split()[0], []).append((key, g, r))
+    for block, entries in by_block.items():
+        missing = sum(1 for e in entries if e[2] is None)
+        print('%-8s %4d differ%s' % (block, len(entries) - missing,
+                                      ', %d missing' % missing if missing else ''))
+        if verbose:
+            for key, g, r in entries:
+                print('    %-16s golden 0x%04x restored %s' %
+                      (csr_name(key), g, 'missing' if r is None else '0x%04x' % r))
+    print('%d registers checked, %d differ' % (checked, len(diffs)))
+
+
+class Mailbox(object):
+    """PMU side of the mailbox, answering from a script of 32 bit messages."""
+
+    def __init__(self, messages):
+        self.queue = deque(messages)
+        self.current = None
+        self.acked = False
+        self.errors = []
+        self._next()
+
+    def _next(self):
+        self.current = self.queue.popleft() if self.queue else None
+        self.acked = False
+
+    def read(self, csr):
+        if csr == UCT_SHADOW_REGS:
+            return 0 if (self.current is not None and not self.acked) else 1
+        if self.current is None:
+            self.errors.append('message read with no message waiting')
+            return 0
+        if csr == UCT_WRITE_ONLY_SHADOW:
+            return self.current & 0xFFFF
+        return self.current >> 16
+
+    def write(self, data):
+        if data == 0:
+            if self.current is None or self.acked:
+                self.errors.append('acknowledge with no message waiting')
+            self.acked = True
+        elif self.acked:
+            self._next()
+
+    def pending(self):
+        return len(self.queue) + (1 if self.current is not None and not self.acked else 0)
+
+
+def script_load(path):
+    """Return the 32 bit messages of a mailbox script."""
+    messages = []
+    with open(path, 'r') as f:
+        for n, line in enumerate(f, 1):
+            fields = line.split('#')[0].split()
+            if not fields:
+                continue
+            if fields[0] == 'major' and len(fields) == 2:
+                messages.append(int(fields[1], 0) & 0xFFFF)
+            elif fields[0] == 'stream' and len(fields) >= 2:
+                messages.append(STREAM_MSG)
+                messages += [int(v, 0) & 0xFFFFFFFF for v in fields[1:]]
+            else:
+                raise ValueError('%s:%d: bad mailbox script line' % (path, n))
+    return messages
+
+
+class PhyModel(object):
+    """CSR space with the PMU mailbox, recording every access."""
+
+    MAILBOX_CSRS = (UCT_SHADOW_REGS, UCT_WRITE_ONLY_SHADOW, UCT_DAT_WRITE_ONLY_SHADOW)
+
+    def __init__(self, mailbox):
+        self.regs = OrderedDict()
+        self.mailbox = mailbox
+        self.trace = []
+        self.counts = {'W': 0, 'R': 0}
+
+    def write(self, csr, data):
+        self.counts['W'] += 1
+        self.trace.append('W 0x%05x 0x%04x' % (csr, data))
+        self.regs[csr] = data & 0xFFFF
+        if csr == DCT_WRITE_PROT:
+            self.mailbox.write(data)
+
+    def read(self, csr):
+        self.counts['R'] += 1
+        if csr in self.MAILBOX_CSRS:
+            data = self.mailbox.read(csr)
+        else:
+            data = self.regs.get(csr, 0)
+        self.trace.append('R 0x%05x 0x%04x' % (csr, data))
+        return data
+
+
+def replay(model, path, max_polls):
+    """Replay a trace, return the list of errors."""
+    errors = []
+    with open(path, 'r') as f:
+        for n, line in enumerate(f, 1):
+            fields = line.split('#')[0].split()
+            if not fields:
+                continue
+            try:
+                op = fields[0].upper()
+                values = [int(v, 0) for v in fields[1:]]
+                if op == 'W' and len(values) == 2:
+                    model.write(values[0], values[1])
+                elif op == 'R' and len(values) in (1, 2):
+                    data = model.read(values[0])
+                    if len(values) == 2 and data != values[1]:
+                        errors.append('%s:%d: %s read 0x%04x, expected 0x%04x' %
+                                      (path, n, csr_name(values[0]), data, values[1]))
+                elif op == 'P' and len(values) == 3:
+                    for _ in range(max_polls):
+                        if (model.read(values[0]) & values[1]) == values[2]:
+                            break
+                    else:
+                        errors.append('%s:%d: %s poll timed out' % (path, n, csr_name(values[0])))
+                else:
+                    raise ValueError
+            except ValueError:
+                errors.append('%s:%d: bad trace line' % (path, n))
+    return errors
+
+
+def cmd_compare(args):
+    golden = dump_load(args.golden)
+    restored = dump_load(args.restored)
+    if not golden:
+        print('no register dump lines in %s' % ' '.join(args.golden))
+        return 1
+    diffs = regs_compare(golden, restored, args.exclude)
+    checked = sum(1 for key in golden if not excluded(key, args.exclude))
+    diffs_report(diffs, checked, args.verbose)
+    return 1 if diffs else 0
+
+
+def cmd_replay(args):
+    mailbox = Mailbox(script_load(args.script) if args.script else [])
+    model = PhyModel(mailbox)
+    errors = replay(model, args.trace, args.max_polls)
+    errors += ['mailbox: %s' % e for e in mailbox.errors]
+    if mailbox.pending():
+        errors.append('mailbox: %d messages not read' % mailbox.pending())
+
+    if args.outfile:
+        with open(args.outfile, 'w') as f:
+            f.write('\n'.join(model.trace) + '\n')
+
+    accesses = model.counts['W'] + model.counts['R']
+    print('%d writes, %d reads, modelled time %.3f ms at %d ns per access' %
+          (model.counts['W'], model.counts['R'], accesses * args.access_ns / 1e6, args.access_ns))
+
+    if args.golden:
+        golden = dump_load(args.golden)
+        diffs = regs_compare(golden, model.regs, args.exclude, only_restored=True)
+        checked = sum(1 for key in golden if key in model.regs and not excluded(key, args.exclude))
+        diffs_report(diffs, checked, args.verbose)
+        if diffs:
+            errors.append('%d restored registers differ from the golden run' % len(diffs))
+
+    for e in errors:
+        print(e)
+    return 1 if errors else 0
+
+
+def csr_range(text):
+    first, _, last = text.partition('-')
+    return int(first, 0), int(last or first, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Host model of the DDR PHY CSR space')
+    common = argparse.ArgumentParser(add_help=False)
+    common.add_argument('-x', dest='exclude', type=csr_range, action='append', default=[],
+                        help='CSR or CSR range (first-last) to leave out of comparisons, repeatable')
+    common.add_argument('-v', dest='verbose', action='store_true', help='list every differing register')
+    sub = parser.add_subparsers(dest='cmd')
+
+    p = sub.add_parser('compare', parents=[common], help='compare the register dumps of a restore against a golden run')
+    p.add_argument('-g', dest='golden', nargs='+', required=True, help='register dumps of the golden run')
+    p.add_argument('-r', dest='restored', nargs='+', required=True, help='register dumps of the restore')
+
+    p = sub.add_parser('replay', parents=[common], help='replay a CSR access trace')
+    p.add_argument('trace', help='access trace')
+    p.add_argument('-m', dest='script', help='PMU mailbox script')
+    p.add_argument('-g', dest='golden', nargs='+', help='register dumps of the golden run to check the state against')
+    p.add_argument('-o', dest='outfile', help='file to record the accesses to')
+    p.add_argument('-c', dest='access_ns', type=int, default=DEFAULT_ACCESS_NS,
+                   help='ns per APB access (default %d)' % DEFAULT_ACCESS_NS)
+    p.add_argument('-p', dest='max_polls', type=int, default=1000, help='reads before a poll times out')
+
+    args = parser.parse_args()
+    if args.cmd == 'compare':
+        return cmd_compare(args)
+    if args.cmd == 'replay':
+        return cmd_replay(args)
+    parser.print_help()
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
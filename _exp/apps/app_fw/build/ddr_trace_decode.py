@@ -0,0 +1,226 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Resolver for the DDR PHY training trace printed by the PHY
+#                 library as string indexes
+#
+# NOTES        :  The library prints two kinds of indexed messages:
+#                   [0x<index>] <args>
+#                       a trace point of trace_print(), <index> is a
+#                       trace_entry_enum value and <args> are printed with
+#                       the firmware format of the entry. The message format
+#                       is taken from ddrphy_trace_strings.h.
+#                   "[PMU_TRN_STR] 0x<a> 0x<b> " <args>
+#                       a PMU mailbox message of verbose training (HdtCtrl).
+#                       The PMU message formats are not part of this tree,
+#                       pass the .strings files delivered with the PMU
+#                       training images ("<id> <format>" per line) with -p.
+#
+#                 The tables are loaded once into dictionaries keyed by
+#                 index, so each message resolves in constant time. Lines
+#                 that are not indexed messages, or whose index is unknown,
+#                 are passed through. Input is a UART capture or the text of
+#                 a log read-out, for example the output of
+#                 log_chan_decode.py.
+#
+#*******************************************************************************/
+import os
+import re
+import sys
+import argparse
+
+TRACE_STRINGS_H = 'ddrphy_trace_strings.h'
+
+ENUM_END_RE = re.compile(r'^\}\s*trace_entry_enum\s*;')
+ENUM_ENTRY_RE = re.compile(r'^\s*(\w+)\s*,')
+DEFINE_RE = re.compile(r'^#define\s+\w+\s+(\w+),\s*("(?:[^"\\]|\\.)*")\s*,\s*("(?:[^"\\]|\\.)*")\s*$')
+TRACE_LINE_RE = re.compile(r'\[0x([0-9a-fA-F]{8})\] ?(.*)$')
+PMU_LINE_RE = re.compile(r'"\[PMU_TRN_STR\] 0x([0-9a-fA-F]{8}) 0x([0-9a-fA-F]{8}) *"(.*)$')
+C_SPEC_RE = re.compile(r'%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diouxXcsp%])')
+
+
+def c_unquote(s):
+    """Return the text of a C string literal."""
+    body = s[1:-1]
+    return body.encode('latin-1').decode('unicode_escape')
+
+
+def trace_table_load(path):
+    """Return {index: (fw_format, msg_format)} from ddrphy_trace_strings.h."""
+    values = {}
+    table = {}
+    in_enum = False
+    with open(path, 'r', encoding='latin-1') as f:
+        for line in f:
+            if not values and not in_enum and line.startswith('typedef enum'):
+                in_enum = True
+                continue
+            if in_enum:
+                if ENUM_END_RE.match(line):
+                    in_enum = False
+                    continue
+                m = ENUM_ENTRY_RE.match(line)
+                if m:
+                    values[m.group(1)] = len(values)
+                continue
+            m = DEFINE_RE.match(line)
+            if m and m.group(1) in values:
+                table[values[m.group(1)]] = (c_unquote(m.group(2)), c_unquote(m.group(3)))
+    return table
+
+
+def pmu_table_load(paths):
+    """Return {id: format} from PMU .strings files."""
+    table = {}
+    for path in paths:
+        with open(path, 'r', encoding='latin-1') as f:
+            for line in f:
+                parts = line.rstrip('\r\n').split(None, 1)
+                if not parts:
+                    continue
+                try:
+                    ident = int(parts[0], 16)
+                except ValueError:
+                    continue
+                table[ident] = parts[1] if len(parts) > 1 else ''
+    return table
+
+
+def c_format(fmt, args):
+    """Apply a printf format to a list of integer or string arguments."""
+    out = []
+    pos = 0
+    for m in C_SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group(1)
+        if conv == '%':
+            out.append('%')
+            continue
+        spec = re.sub(r'(hh|h|ll|l|z)', '', m.group(0)[:-1])
+        if spec == '%0':
+            spec = '%'
+        arg = args.pop(0) if args else 0
+        try:
+            if conv in 'ucp':
+                out.append((spec + ('x' if conv == 'p' else 'd')) % (arg & 0xFFFFFFFF))
+            elif conv == 's':
+                out.append((spec + 's') % arg)
+            else:
+                out.append((spec + conv) % arg)
+        except TypeError:
+            out.append(str(arg))
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def args_parse(fw_format, text):
+    """Parse the arguments printed with a firmware format, None if they do not match."""
+    pattern = ''
+    pos = 0
+    convs = []
+    for m in C_SPEC_RE.finditer(fw_format):
+        pattern += re.escape(fw_format[pos:m.start()])
+        pos = m.end()
+        conv = m.group(1)
+        if conv == '%':
+            pattern += '%'
+            continue
+        convs.append(conv)
+        if conv in 'xXp':
+            pattern += r'\s*([0-9a-fA-F]+)'
+        elif conv == 'o':
+            pattern += r'\s*([0-7]+)'
+        elif conv == 's':
+            pattern += r'(.*?)'
+        else:
+            pattern += r'\s*(-?\d+)'
+    pattern += re.escape(fw_format[pos:])
+    m = re.match(pattern.replace(r'\ ', r'\s+') + r'\s*$', text)
+    if not m:
+        return None
+    args = []
+    for conv, val in zip(convs, m.groups()):
+        if conv in 'xXp':
+            args.append(int(val, 16))
+        elif conv == 'o':
+            args.append(int(val, 8))
+        elif conv == 's':
+            args.append(val)
+        else:
+            args.append(int(val))
+    return args
+
+
+def line_resolve(line, trace_table, pmu_table):
+    """Return the resolved line, or the line unchanged."""
+    m = TRACE_LINE_RE.search(line)
+    if m:
+        entry = trace_table.get(int(m.group(1), 16))
+        if entry is not None:
+            args = args_parse(entry[0], m.group(2))
+            if args is not None:
+                return line[:m.start()] + c_format(entry[1], args).rstrip('\n')
+        return line
+
+    m = PMU_LINE_RE.search(line)
+    if m:
+        fmt = pmu_table.get(int(m.group(2), 16))
+        if fmt is None:
+            fmt = pmu_table.get(int(m.group(1), 16))
+        if fmt is not None:
+            args = [int(a, 0) for a in m.group(3).split()]
+            return line[:m.start()] + c_format(fmt, args).rstrip('\n')
+    return line
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Resolve the indexed DDR PHY training trace')
+    parser.add_argument('-i', dest='infile', help='trace text, default stdin')
+    parser.add_argument('-t', dest='trace_strings', default=None,
+                        help='%s, default the one of release_lib/inc' % TRACE_STRINGS_H)
+    parser.add_argument('-p', dest='pmu_strings', action='append', default=[],
+                        help='PMU training .strings file, may be repeated')
+    parser.add_argument('-u', dest='unresolved', action='store_true',
+                        help='print only the indexed lines that could not be resolved')
+    args = parser.parse_args()
+
+    trace_strings = args.trace_strings
+    if trace_strings is None:
+        trace_strings = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                     '..', '..', '..', 'release_lib', 'inc', TRACE_STRINGS_H)
+    trace_table = trace_table_load(trace_strings)
+    pmu_table = pmu_table_load(args.pmu_strings)
+
+    f = open(args.infile, 'r', encoding='latin-1') if args.infile else sys.stdin
+    for line in f:
+        line = line.rstrip('\r\n')
+        out = line_resolve(line, trace_table, pmu_table)
+        if args.unresolved:
+            if out == line and (TRACE_LINE_RE.search(line) or PMU_LINE_RE.search(line)):
+                print(line)
+        else:
+            print(out)
+    if args.infile:
+        f.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,165 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Host simulation of the DDR PHY delay line update policy
+#                 (ddr_phy_dl_update.c) against a DIMM temperature trace
+#
+# NOTES        :  The trace has one reading per line, "<seconds> <degrees C>",
+#                 separated by white space or a comma, '#' starts a comment.
+#                 Readings are quantized to the 1/16 degree C of the JEDEC
+#                 temperature sensor and run through a model of the policy
+#                 of the firmware: the first reading sets the references, a delay
+#                 line update is due when the temperature moved by the delay
+#                 line threshold since the last one, a ZQ calibration (run
+#                 with a delay line update) when it moved by the ZQ threshold
+#                 since the last calibration, and updates due within the
+#                 minimum interval of the previous one are deferred.
+#                 test/host/test_dl_update_sim.py checks the model against
+#                 ddr_phy_dl_update.c built for the host.
+#
+#                 Without a trace file a synthetic trace is used: a DIMM
+#                 heating up under load, idle periods and a slow ambient
+#                 cycle, read every 5 seconds for 4 hours.
+#
+#                 Several thresholds or intervals can be given as comma
+#                 separated lists, one line is printed per combination with
+#                 the update rate and the largest temperature error the delay
+#                 lines were left running with.
+#
+#*******************************************************************************/
+import sys
+import math
+import argparse
+import itertools
+
+# pmc_profile.h defaults
+DEFAULT_DL_DELTA_C = 4
+DEFAULT_ZQ_DELTA_C = 8
+DEFAULT_MIN_INTERVAL_S = 10
+
+TEMP_LSB_PER_C = 16
+
+
+def trace_load(path):
+    """Return [(seconds, temp)] with temp in 1/16 degree C."""
+    trace = []
+    with open(path, 'r') as f:
+        for n, line in enumerate(f, 1):
+            fields = line.split('#')[0].replace(',', ' ').split()
+            if not fields:
+                continue
+            if len(fields) != 2:
+                raise ValueError('%s:%d: expected "<seconds> <degrees C>"' % (path, n))
+            trace.append((int(float(fields[0])), int(round(float(fields[1]) * TEMP_LSB_PER_C))))
+    return trace
+
+
+def trace_synthetic():
+    """Return a synthetic trace, [(seconds, temp)] with temp in 1/16 degree C."""
+    trace = []
+    temp = 40.0
+    for t in range(0, 4 * 3600, 5):
+        ambient = 35.0 + 3.0 * math.sin(2 * math.pi * t / 7200.0)
+        loaded = (t // 900) % 3 != 2          # 30 min of load, 15 min idle
+        target = ambient + (30.0 if loaded else 8.0)
+        temp += (target - temp) * 5.0 / 300.0  # 5 minute thermal time constant
+        trace.append((t, int(round(temp * TEMP_LSB_PER_C))))
+    return trace
+
+
+def simulate(trace, dl_delta, zq_delta, min_interval, verbose=False):
+    """Run the policy over a trace, return the counters and the [(seconds, zq)] updates."""
+    c = {'readings': 0, 'dl': 0, 'zq': 0, 'deferred': 0, 'max_error': 0, 'updates': []}
+    ref_valid = False
+    dl_ref = zq_ref = last = 0
+
+    for now, temp in trace:
+        c['readings'] += 1
+        if not ref_valid:
+            dl_ref = zq_ref = temp
+            last = now
+            ref_valid = True
+            continue
+
+        c['max_error'] = max(c['max_error'], abs(temp - dl_ref))
+        dl_due = abs(temp - dl_ref) >= dl_delta
+        zq_due = abs(temp - zq_ref) >= zq_delta
+        if not dl_due and not zq_due:
+            continue
+        if now - last < min_interval:
+            c['deferred'] += 1
+            continue
+
+        if verbose:
+            print('%8d s %7.2f C  delay line%s, %+.2f C' %
+                  (now, temp / float(TEMP_LSB_PER_C), ' + ZQ' if zq_due else '',
+                   (temp - dl_ref) / float(TEMP_LSB_PER_C)))
+        c['dl'] += 1
+        c['updates'].append((now, zq_due))
+        dl_ref = temp
+        if zq_due:
+            c['zq'] += 1
+            zq_ref = temp
+        last = now
+
+    return c
+
+
+def values(text, cast):
+    return [cast(v) for v in text.split(',')]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Simulate the DDR PHY delay line update policy')
+    parser.add_argument('-t', dest='trace', help='temperature trace, synthetic if not given')
+    parser.add_argument('-d', dest='dl_delta', default=str(DEFAULT_DL_DELTA_C),
+                        help='delay line threshold(s), degrees C (default %d)' % DEFAULT_DL_DELTA_C)
+    parser.add_argument('-z', dest='zq_delta', default=str(DEFAULT_ZQ_DELTA_C),
+                        help='ZQ threshold(s), degrees C (default %d)' % DEFAULT_ZQ_DELTA_C)
+    parser.add_argument('-i', dest='min_interval', default=str(DEFAULT_MIN_INTERVAL_S),
+                        help='minimum interval(s), seconds (default %d)' % DEFAULT_MIN_INTERVAL_S)
+    parser.add_argument('-v', dest='verbose', action='store_true', help='list every update')
+    args = parser.parse_args()
+
+    trace = trace_load(args.trace) if args.trace else trace_synthetic()
+    if not trace:
+        print('empty trace')
+        return 1
+
+    hours = max(trace[-1][0] - trace[0][0], 1) / 3600.0
+    temps = [temp for _, temp in trace]
+    print('%d readings over %.2f h, %.2f C to %.2f C' %
+          (len(trace), hours, min(temps) / float(TEMP_LSB_PER_C), max(temps) / float(TEMP_LSB_PER_C)))
+    print('%6s %6s %6s  %8s %6s %8s %10s %9s' %
+          ('dl C', 'zq C', 'min s', 'dl upd', 'zq', 'deferred', 'upd/hour', 'max err C'))
+
+    for dl_c, zq_c, interval in itertools.product(values(args.dl_delta, float),
+                                                  values(args.zq_delta, float),
+                                                  values(args.min_interval, int)):
+        c = simulate(trace, int(round(dl_c * TEMP_LSB_PER_C)), int(round(zq_c * TEMP_LSB_PER_C)),
+                     interval, args.verbose)
+        print('%6.2f %6.2f %6d  %8d %6d %8d %10.2f %9.2f' %
+              (dl_c, zq_c, interval, c['dl'], c['zq'], c['deferred'], c['dl'] / hours,
+               c['max_error'] / float(TEMP_LSB_PER_C)))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,244 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Packer for compressed firmware upgrade images
+#
+# NOTES        :  The output is a 16 byte header followed by an LZ4-style
+#                 sequence stream whose match offsets never exceed the
+#                 window size. The flashloader decodes it with a window of
+#                 the same size (see lz_decomp.h) and writes the plain image
+#                 into the upgrade staging area, where it is authenticated
+#                 as usual. The signed image must be packed, never the
+#                 other way around.
+#
+#                 Header layout (little endian):
+#                   0  magic        'EXPZ'
+#                   4  version      1
+#                   5  window_log2  log2 of the window size in bytes
+#                   6  reserved     0
+#                   8  raw_len      length of the decoded image
+#                   12 comp_len     length of the sequence stream
+#
+#*******************************************************************************/
+import sys
+import time
+import struct
+import argparse
+
+PACK_MAGIC = b'EXPZ'
+PACK_VERSION = 1
+PACK_HDR_FMT = '<4sBBHII'
+PACK_HDR_SIZE = struct.calcsize(PACK_HDR_FMT)
+
+# Must match FLASH_LOADER_DECOMP_WINDOW_LOG2 in flashloader_plat.h
+DEFAULT_WINDOW_LOG2 = 12
+
+MIN_MATCH = 4
+LEN_EXT = 15
+MAX_CHAIN = 64
+
+
+def _len_ext(n):
+    """Encode the part of a length that does not fit in a token nibble."""
+    out = bytearray()
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+    return out
+
+
+def _sequence(out, literals, match_len, offset):
+    lit_len = len(literals)
+    lit_nib = min(lit_len, LEN_EXT)
+    if match_len:
+        m = match_len - MIN_MATCH
+        match_nib = min(m, LEN_EXT)
+    else:
+        match_nib = 0
+    out.append((lit_nib << 4) | match_nib)
+    if lit_nib == LEN_EXT:
+        out += _len_ext(lit_len - LEN_EXT)
+    out += literals
+    if match_len:
+        out += struct.pack('<H', offset)
+        if match_nib == LEN_EXT:
+            out += _len_ext(m - LEN_EXT)
+
+
+def compress(data, window_log2=DEFAULT_WINDOW_LOG2, dictionary=b''):
+    """Greedy hash chain LZ compressor limited to a 2^window_log2 window.
+
+    Matches may reach back into a preset dictionary, as if it had been
+    decoded just before the data (see decompress()).
+    """
+    # offsets are 16 bit
+    window = min(1 << window_log2, 0xFFFF)
+    data = bytearray(dictionary) + bytearray(data)
+    n = len(data)
+    head = {}
+    prev = [-1] * n
+    out = bytearray()
+
+    def insert(pos):
+        if pos + MIN_MATCH <= n:
+            key = bytes(data[pos:pos + MIN_MATCH])
+            prev[pos] = head.get(key, -1)
+            head[key] = pos
+
+    for pos in range(len(dictionary)):
+        insert(pos)
+    anchor = len(dictionary)
+    i = anchor
+
+    while i + MIN_MATCH <= n:
+        key = bytes(data[i:i + MIN_MATCH])
+        cand = head.get(key, -1)
+        best_len = 0
+        best_off = 0
+        chain = 0
+        while cand >= 0 and i - cand <= window and chain < MAX_CHAIN:
+            l = MIN_MATCH
+            while i + l < n and data[cand + l] == data[i + l]:
+                l += 1
+            if l > best_len:
+                best_len = l
+                best_off = i - cand
+            cand = prev[cand]
+            chain += 1
+        if best_len >= MIN_MATCH:
+            _sequence(out, data[anchor:i], best_len, best_off)
+            # Long runs dominate zero filled tables, index only the start of
+            # them to keep packing time reasonable.
+            stop = i + best_len
+            step = 1 if best_len < 64 else 16
+            for p in range(i, stop, step):
+                insert(p)
+            i = stop
+            anchor = i
+        else:
+            insert(i)
+            i += 1
+
+    _sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def decompress(stream, raw_len, window_log2=DEFAULT_WINDOW_LOG2, dictionary=b''):
+    """Reference decoder, mirrors lz_decomp_run() for verification.
+
+    A preset dictionary is decoded as if it preceded the stream, like
+    lz_decomp_dict_set().
+    """
+    window = 1 << window_log2
+    stream = bytearray(stream)
+    out = bytearray(dictionary)
+    raw_len += len(dictionary)
+    i = 0
+    while len(out) < raw_len:
+        token = stream[i]
+        i += 1
+        lit_len = token >> 4
+        if lit_len == LEN_EXT:
+            while True:
+                b = stream[i]
+                i += 1
+                lit_len += b
+                if b != 255:
+                    break
+        out += stream[i:i + lit_len]
+        i += lit_len
+        if len(out) >= raw_len:
+            break
+        offset = stream[i] | (stream[i + 1] << 8)
+        i += 2
+        if offset == 0 or offset > window or offset > len(out):
+            raise ValueError('invalid offset %d at output %d' % (offset, len(out)))
+        match_len = (token & 0xF) + MIN_MATCH
+        if (token & 0xF) == LEN_EXT:
+            while True:
+                b = stream[i]
+                i += 1
+                match_len += b
+                if b != 255:
+                    break
+        for _ in range(match_len):
+            out.append(out[-offset])
+    if len(out) != raw_len:
+        raise ValueError('decoded %d bytes, expected %d' % (len(out) - len(dictionary), raw_len - len(dictionary)))
+    return bytes(out[len(dictionary):])
+
+
+def pack(data, window_log2=DEFAULT_WINDOW_LOG2):
+    stream = compress(data, window_log2)
+    hdr = struct.pack(PACK_HDR_FMT, PACK_MAGIC, PACK_VERSION, window_log2, 0, len(data), len(stream))
+    return hdr + stream
+
+
+def unpack(packed):
+    magic, version, window_log2, _, raw_len, comp_len = struct.unpack(PACK_HDR_FMT, packed[:PACK_HDR_SIZE])
+    if magic != PACK_MAGIC or version != PACK_VERSION:
+        raise ValueError('not a packed firmware image')
+    return decompress(packed[PACK_HDR_SIZE:PACK_HDR_SIZE + comp_len], raw_len, window_log2)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack a signed firmware image for compressed upgrade')
+    parser.add_argument('-i', dest='infile', required=True, help='input image')
+    parser.add_argument('-o', dest='outfile', help='packed output image')
+    parser.add_argument('-w', dest='window_log2', type=int, default=DEFAULT_WINDOW_LOG2,
+                        help='log2 of the window size (default %d)' % DEFAULT_WINDOW_LOG2)
+    parser.add_argument('-d', dest='unpack', action='store_true', help='unpack infile instead')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as f:
+        data = f.read()
+
+    if args.unpack:
+        raw = unpack(data)
+        if args.outfile:
+            with open(args.outfile, 'wb') as f:
+                f.write(raw)
+        print('%s: %d -> %d bytes' % (args.infile, len(data), len(raw)))
+        return 0
+
+    start = time.time()
+    packed = pack(data, args.window_log2)
+    pack_time = time.time() - start
+
+    # Always prove the output decodes back to the input before shipping it
+    start = time.time()
+    if unpack(packed) != data:
+        print('**** ERROR: packed image does not decode to the input ****')
+        return 1
+    unpack_time = time.time() - start
+
+    if args.outfile:
+        with open(args.outfile, 'wb') as f:
+            f.write(packed)
+
+    print('%s: %d -> %d bytes (%.1f%%), window %d bytes, pack %.2fs, verify %.2fs (%.1f MB/s)' %
+          (args.infile, len(data), len(packed), 100.0 * len(packed) / max(len(data), 1),
+           1 << args.window_log2, pack_time, unpack_time,
+           len(data) / max(unpack_time, 1e-6) / 1e6))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
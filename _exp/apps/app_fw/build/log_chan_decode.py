@@ -0,0 +1,126 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder of the log channels kept in a saved log
+#
+# NOTES        :  log_spi_flash_chan_store() appends the new records of each
+#                 log channel to the saved log read with
+#                 EXP_FW_LOG_OP_READ_SAVED_JOURNAL, as log_app_entry_struct
+#                 entries (see log_chan.h):
+#                   ts_u      record sequence number, common to all channels
+#                   ts_l      index of the entry within the record
+#                   log_code  (module LOG_APP << 16) | 0xC000 | channel
+#                   log_word0..4  20 bytes of the record text, NUL padded
+#
+#                 The records are printed merged in sequence order, each
+#                 line prefixed with its channel, as returned live by the
+#                 EXP_FW_LOG_OP_READ_CHANNEL_LOG operand. Sequence numbers
+#                 restart at 0 on each boot, so a record whose number is not
+#                 above the previous one of its channel starts a new boot.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+LOG_ENTRY_FMT = '<IIIIIIII'
+LOG_CODE_MID_LOG_APP = 0x000F
+LOG_CODE_LOG_CHAN = 0xC000
+LOG_CHAN_ENTRY_TEXT_SIZE = 20
+
+# log_chan_enum order
+CHANNELS = ['fatal', 'boot', 'flash', 'ddr', 'serdes', 'ech']
+
+
+def saved_log_parse(data):
+    """Return [{(seq, chan): text}] from a saved log, one dict per boot."""
+    size = struct.calcsize(LOG_ENTRY_FMT)
+    boots = [{}]
+    last_seq = {}
+    for off in range(0, len(data) - size + 1, size):
+        seq, idx, code = struct.unpack_from('<III', data, off)
+        if (code >> 16) != LOG_CODE_MID_LOG_APP or (code & 0xF000) != LOG_CODE_LOG_CHAN:
+            continue
+        chan = code & 0x0FFF
+        text = data[off + 12:off + 12 + LOG_CHAN_ENTRY_TEXT_SIZE].rstrip(b'\0')
+        if 0 == idx:
+            if chan in last_seq and seq <= last_seq[chan]:
+                boots.append({})
+                last_seq = {}
+            last_seq[chan] = seq
+            boots[-1][(seq, chan)] = b''
+        if (seq, chan) in boots[-1]:
+            boots[-1][(seq, chan)] += text
+    return [b for b in boots if b]
+
+
+def merge(records, channels):
+    """Return the text of records {(seq, chan): text} in sequence order."""
+    out = []
+    line_start = True
+    last_chan = None
+    for seq, chan in sorted(records):
+        name = CHANNELS[chan] if chan < len(CHANNELS) else 'chan_%d' % chan
+        if channels and name not in channels:
+            continue
+        if not line_start and chan != last_chan:
+            out.append('\n')
+            line_start = True
+        last_chan = chan
+        for c in records[(seq, chan)].decode('latin-1'):
+            if line_start:
+                out.append('[%s] ' % name)
+            out.append(c)
+            line_start = ('\n' == c)
+    if not line_start:
+        out.append('\n')
+    return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Print the log channels of a saved log')
+    parser.add_argument('file', help='saved log read with EXP_FW_LOG_OP_READ_SAVED_JOURNAL')
+    parser.add_argument('-c', dest='channels', action='append', choices=CHANNELS,
+                        help='only print this channel, may be repeated')
+    parser.add_argument('-b', dest='boot', type=int, default=None,
+                        help='only print this boot, 0 the oldest, -1 the newest')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        boots = saved_log_parse(f.read())
+    if not boots:
+        print('%s: no log channel records found' % args.file)
+        return 1
+
+    if args.boot is not None:
+        try:
+            boots = [boots[args.boot]]
+        except IndexError:
+            print('%s: %d boots found' % (args.file, len(boots)))
+            return 1
+
+    for i, records in enumerate(boots):
+        if len(boots) > 1:
+            print('=== boot %d' % i)
+        sys.stdout.write(merge(records, args.channels))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
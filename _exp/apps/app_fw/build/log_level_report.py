@@ -0,0 +1,108 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Report of the leveled log call sites (see bc_log.h) and of
+#                 the format strings compiled out at a log level
+#
+# NOTES        :  Scans C sources for BC_LOG_ERR/WARN/INFO/DEBUG() and
+#                 BC_LOG_RL() call sites. For the level given (default
+#                 EXPLORER_LOG_LEVEL from pmc_profile.h) it reports per
+#                 level the call sites and format string bytes kept in or
+#                 removed from the image. Bytes written to the log at run
+#                 time depend on the arguments and are not estimated here,
+#                 the "log_rl" command reports those dropped by the rate
+#                 limiter.
+#
+#*******************************************************************************/
+import os
+import re
+import sys
+import argparse
+
+LEVELS = ['NONE', 'ERR', 'WARN', 'INFO', 'DEBUG']
+
+CALL_RE = re.compile(r'BC_LOG_(ERR|WARN|INFO|DEBUG)\s*\(\s*"((?:[^"\\]|\\.)*)"|'
+                     r'BC_LOG_RL\s*\(\s*BC_LOG_LEVEL_(\w+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*"((?:[^"\\]|\\.)*)"')
+PROFILE_RE = re.compile(r'#define\s+EXPLORER_LOG_LEVEL\s+(\d+)')
+
+
+def string_size(literal):
+    """Size in the image of a C string literal, NUL included."""
+    return len(literal.encode('latin-1').decode('unicode_escape')) + 1
+
+
+def sites_get(paths):
+    """Return [(file, line, level, size, rate)] for the call sites found."""
+    sites = []
+    for path in paths:
+        with open(path, 'r', encoding='latin-1') as f:
+            text = f.read()
+        for m in CALL_RE.finditer(text):
+            line = text.count('\n', 0, m.start()) + 1
+            if m.group(1):
+                sites.append((path, line, m.group(1), string_size(m.group(2)), None))
+            else:
+                sites.append((path, line, m.group(3), string_size(m.group(6)),
+                              '%s/%ss' % (m.group(4), m.group(5))))
+    return sites
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the leveled log call sites')
+    parser.add_argument('-p', dest='profile', help='pmc_profile.h giving EXPLORER_LOG_LEVEL')
+    parser.add_argument('-l', dest='level', type=int, help='log level, overrides the profile')
+    parser.add_argument('-v', dest='verbose', action='store_true', help='list the call sites')
+    parser.add_argument('sources', nargs='+', help='C source files or directories')
+    args = parser.parse_args()
+
+    level = args.level
+    if level is None and args.profile:
+        with open(args.profile, 'r', encoding='latin-1') as f:
+            m = PROFILE_RE.search(f.read())
+        if m:
+            level = int(m.group(1))
+    if level is None:
+        print('no log level: give -l or -p')
+        return 1
+
+    paths = []
+    for src in args.sources:
+        if os.path.isdir(src):
+            for root, _, files in os.walk(src):
+                paths += [os.path.join(root, n) for n in sorted(files) if n.endswith('.c')]
+        else:
+            paths.append(src)
+
+    sites = sites_get(paths)
+    print('log level %d (%s)' % (level, LEVELS[level] if level < len(LEVELS) else '?'))
+    print('%-6s %6s %8s %10s %10s' % ('level', 'sites', 'limited', 'kept', 'removed'))
+    for num, name in enumerate(LEVELS[1:], 1):
+        at = [s for s in sites if s[2] == name]
+        size = sum(s[3] for s in at)
+        limited = len([s for s in at if s[4]])
+        kept = size if num <= level else 0
+        print('%-6s %6d %8d %10d %10d' % (name, len(at), limited, kept, size - kept))
+        if args.verbose:
+            for path, line, _, size, rate in at:
+                print('    %s:%d %d bytes%s' % (path, line, size, (' limited %s' % rate) if rate else ''))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
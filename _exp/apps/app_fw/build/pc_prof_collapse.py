@@ -0,0 +1,206 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Converts a PC-sampling profile to collapsed stacks for flame
+#                 graph tools
+#
+# NOTES        :  The profile is the extended data returned by EXP_FW_LOG with
+#                 the EXP_FW_LOG_OP_READ_PC_PROFILE operand, from a firmware
+#                 built with EXPLORER_PC_PROFILER_ENABLE (see
+#                 app_fw_pc_prof.h). It is an app_fw_pc_prof_hdr_struct
+#                 followed by either the sampled PCs (ring mode) or a sample
+#                 count per address bucket (histogram mode).
+#
+#                 Samples are mapped to functions with the symbols of the
+#                 linked ELF the firmware was built from. Only the
+#                 interrupted PC is sampled, so each stack is the code
+#                 section and the function: "section;function count".
+#                 A histogram bucket that covers several functions is split
+#                 between them in proportion to the bytes of each in it.
+#
+#                 The output can be fed to flamegraph.pl or speedscope; the
+#                 sampling overhead is printed to stderr.
+#
+#*******************************************************************************/
+import sys
+import struct
+import bisect
+import argparse
+
+import sym_table_gen
+
+PC_PROF_MAGIC = 0x52504350
+PC_PROF_VERSION = 1
+PC_PROF_HDR_FMT = '<IBBBBIIIIIIIIIII'
+PC_PROF_HDR_SIZE = struct.calcsize(PC_PROF_HDR_FMT)
+PC_PROF_MODE_RING = 0
+PC_PROF_MODE_HIST = 1
+PC_PROF_FLAG_RUNNING = 0x01
+PC_PROF_FLAG_WRAPPED = 0x02
+
+SHF_EXECINSTR = 0x4
+UNKNOWN = '[unknown]'
+
+
+class CodeMap(object):
+    """Maps physical addresses to code sections and functions of an ELF."""
+
+    def __init__(self, elf):
+        self.funcs = sym_table_gen.functions_get(elf)
+        self.addrs = [f[0] for f in self.funcs]
+        self.sections = []
+        for sec in elf.sections:
+            if (sec[2] & SHF_EXECINSTR) and sec[5]:
+                addr = sec[3] & sym_table_gen.PHY_MASK
+                self.sections.append((addr, addr + sec[5], elf._str(elf.names, sec[0]).lstrip('.')))
+
+    def section_get(self, addr):
+        for start, end, name in self.sections:
+            if start <= addr < end:
+                return name
+        return UNKNOWN
+
+    def function_get(self, addr):
+        """Return (start, end, name) of the function holding addr, None if none."""
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        start, size, name = self.funcs[i]
+        end = start + size if size else (self.addrs[i + 1] if i + 1 < len(self.addrs) else start)
+        if addr >= end:
+            return None
+        return start, end, name
+
+    def stack_get(self, addr):
+        func = self.function_get(addr)
+        return '%s;%s' % (self.section_get(addr), func[2] if func else UNKNOWN)
+
+    def range_split(self, start, end):
+        """Return [(stack, bytes)] of the code in [start, end)."""
+        out = []
+        addr = start
+        while addr < end:
+            func = self.function_get(addr)
+            if func is None:
+                # up to the next function or the end of the range
+                i = bisect.bisect_right(self.addrs, addr)
+                nxt = min(self.addrs[i], end) if i < len(self.addrs) else end
+                out.append(('%s;%s' % (self.section_get(addr), UNKNOWN), nxt - addr))
+                addr = nxt
+            else:
+                nxt = min(func[1], end)
+                out.append(('%s;%s' % (self.section_get(addr), func[2]), nxt - addr))
+                addr = nxt
+        return out
+
+
+def profile_parse(data):
+    """Return (header dict, entries) of a profile image."""
+    if len(data) < PC_PROF_HDR_SIZE:
+        raise ValueError('profile too short')
+    fields = struct.unpack_from(PC_PROF_HDR_FMT, data, 0)
+    names = ('magic', 'version', 'mode', 'bucket_shift', 'flags', 'period_us', 'ticks_per_ms',
+             'num_samples', 'num_entries', 'range_start', 'range_end', 'outside',
+             'isr_ticks_max', 'isr_ticks_avg', 'latency_ticks_max', 'overhead_ppm')
+    hdr = dict(zip(names, fields))
+    if hdr['magic'] != PC_PROF_MAGIC:
+        raise ValueError('bad magic 0x%08x' % hdr['magic'])
+    if hdr['version'] != PC_PROF_VERSION:
+        raise ValueError('unsupported version %d' % hdr['version'])
+    num = min(hdr['num_entries'], (len(data) - PC_PROF_HDR_SIZE) // 4)
+    entries = struct.unpack_from('<%dI' % num, data, PC_PROF_HDR_SIZE)
+    return hdr, entries
+
+
+def ring_collapse(code, entries):
+    counts = {}
+    for pc in entries:
+        stack = code.stack_get(pc & sym_table_gen.PHY_MASK)
+        counts[stack] = counts.get(stack, 0) + 1
+    return counts
+
+
+def hist_collapse(code, hdr, entries):
+    counts = {}
+    size = 1 << hdr['bucket_shift']
+    for i, count in enumerate(entries):
+        if not count:
+            continue
+        start = hdr['range_start'] + i * size
+        parts = code.range_split(start, min(start + size, hdr['range_end']))
+        total = sum(p[1] for p in parts)
+        # largest remainder, so the bucket count is kept exactly
+        shares = [(count * nbytes // total, count * nbytes % total, stack) for stack, nbytes in parts]
+        left = count - sum(s[0] for s in shares)
+        for j, (share, _, stack) in enumerate(sorted(shares, key=lambda s: -s[1])):
+            share += 1 if j < left else 0
+            if share:
+                counts[stack] = counts.get(stack, 0) + share
+    if hdr['outside']:
+        counts['[outside];%s' % UNKNOWN] = hdr['outside']
+    return counts
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a PC-sampling profile to collapsed stacks')
+    parser.add_argument('-e', dest='elffile', required=True, help='linked ELF file of the firmware')
+    parser.add_argument('-p', dest='profile', required=True, help='profile read with EXP_FW_LOG_OP_READ_PC_PROFILE')
+    parser.add_argument('-o', dest='outfile', help='collapsed stacks output, stdout if not given')
+    args = parser.parse_args()
+
+    with open(args.elffile, 'rb') as f:
+        code = CodeMap(sym_table_gen.Elf32(f.read()))
+    with open(args.profile, 'rb') as f:
+        try:
+            hdr, entries = profile_parse(f.read())
+        except ValueError as e:
+            print('%s: %s' % (args.profile, e), file=sys.stderr)
+            return 1
+
+    if hdr['mode'] == PC_PROF_MODE_RING:
+        counts = ring_collapse(code, entries)
+    elif hdr['mode'] == PC_PROF_MODE_HIST:
+        counts = hist_collapse(code, hdr, entries)
+    else:
+        print('%s: unknown mode %d' % (args.profile, hdr['mode']), file=sys.stderr)
+        return 1
+
+    lines = ['%s %d' % (stack, n) for stack, n in sorted(counts.items(), key=lambda c: -c[1])]
+    if args.outfile:
+        with open(args.outfile, 'w') as f:
+            f.write('\n'.join(lines) + '\n')
+    else:
+        print('\n'.join(lines))
+
+    ticks_per_us = hdr['ticks_per_ms'] / 1000.0 if hdr['ticks_per_ms'] else 1.0
+    print('%s, %s mode, period %d us, %d samples, %d in this profile%s' %
+          ('running' if hdr['flags'] & PC_PROF_FLAG_RUNNING else 'stopped',
+           'ring' if hdr['mode'] == PC_PROF_MODE_RING else 'histogram',
+           hdr['period_us'], hdr['num_samples'], sum(counts.values()),
+           ', older samples overwritten' if hdr['flags'] & PC_PROF_FLAG_WRAPPED else ''),
+          file=sys.stderr)
+    print('sample handler avg %.2f us max %.2f us, latency max %.2f us, overhead %.3f%%' %
+          (hdr['isr_ticks_avg'] / ticks_per_us, hdr['isr_ticks_max'] / ticks_per_us,
+           hdr['latency_ticks_max'] / ticks_per_us, hdr['overhead_ppm'] / 10000.0),
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
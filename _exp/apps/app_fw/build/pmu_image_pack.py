@@ -0,0 +1,192 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Build step packing the DDR PHY PMU training firmware images
+#                 into one compressed blob
+#
+# NOTES        :  The IMEM and DMEM images of all PHY training firmware
+#                 variants are packed into ddr_phy_pmu_images.bin, which is
+#                 linked into the image by app_fw.ld. The firmware decodes the
+#                 image that training asks for into a RAM buffer (see
+#                 ddr_phy_pmu_image.h).
+#
+#                 Code shared between variants is stored once: the IMEM
+#                 images of the reference variants are stored uncompressed
+#                 in a pool, and each image is an LZ4-style sequence stream
+#                 (see fw_image_pack.py) that may reach back into one slice
+#                 of the pool as a preset dictionary. The slice chosen for an
+#                 image is the one giving the smallest stream.
+#
+#                 Layout (little endian):
+#                   0  magic        'PMUZ'
+#                   4  version      1
+#                   5  num_images   number of directory entries
+#                   6  reserved     0
+#                   8  pool_len     length of the pool
+#                   12 max_raw_len  length of the largest decoded image
+#                   16 directory    per image, in variant order with IMEM
+#                                   first: raw_len, dict_offset (in the pool),
+#                                   dict_len, stream_offset (from the start
+#                                   of the blob), stream_len
+#                   .. pool
+#                   .. streams
+#
+#*******************************************************************************/
+import os
+import sys
+import time
+import struct
+import argparse
+
+import fw_image_pack
+
+PMU_PACK_MAGIC = b'PMUZ'
+PMU_PACK_VERSION = 1
+PMU_PACK_HDR_FMT = '<4sBBHII'
+PMU_PACK_HDR_SIZE = struct.calcsize(PMU_PACK_HDR_FMT)
+PMU_PACK_ENTRY_FMT = '<IIIII'
+PMU_PACK_ENTRY_SIZE = struct.calcsize(PMU_PACK_ENTRY_FMT)
+
+# Directory order, must match ddr_phy_pmu_image_enum in ddr_phy_pmu_image.h
+VARIANTS = ('ddr4', 'ddr4_2d', 'ddr4_rdimm', 'ddr4_rdimm2d', 'ddr4_lrdimm', 'ddr4_lrdimm2d')
+MEMS = ('imem', 'dmem')
+
+# IMEM images stored uncompressed in the pool, the other variants share most of their code
+REFERENCES = ('ddr4', 'ddr4_2d')
+
+# Must match EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE in pmc_profile.h
+DEFAULT_BUF_SIZE = 28 * 1024
+
+# Offsets are 16 bit, a dictionary and the image it is used for must be in reach
+WINDOW_LOG2 = 16
+WINDOW_MAX = 0xFFFF
+
+
+def images_load(fw_dir):
+    """Return [(name, data)] in directory order."""
+    images = []
+    for variant in VARIANTS:
+        for mem in MEMS:
+            name = '%s_pmu_train_%s' % (variant, mem)
+            with open(os.path.join(fw_dir, variant, name + '.bin'), 'rb') as f:
+                images.append((name, f.read()))
+    return images
+
+
+def pool_build(images):
+    """Return the pool and the (offset, length) slice of each reference image."""
+    pool = bytearray()
+    slices = []
+    for variant in REFERENCES:
+        data = dict(images)['%s_pmu_train_imem' % variant]
+        slices.append((len(pool), len(data)))
+        pool += data
+    return bytes(pool), slices
+
+
+def stream_build(data, pool, slices):
+    """Return (dict_offset, dict_len, stream), the smallest over all dictionaries."""
+    best = (0, 0, fw_image_pack.compress(data, WINDOW_LOG2))
+    for offset, length in slices:
+        if length + len(data) > WINDOW_MAX:
+            continue
+        stream = fw_image_pack.compress(data, WINDOW_LOG2, pool[offset:offset + length])
+        if len(stream) < len(best[2]):
+            best = (offset, length, stream)
+    return best
+
+
+def pack(images):
+    """Return the packed blob, the pool length and [(name, raw_len, dict_len, stream_len)]."""
+    pool, slices = pool_build(images)
+    streams = [stream_build(data, pool, slices) for _, data in images]
+
+    offset = PMU_PACK_HDR_SIZE + len(images) * PMU_PACK_ENTRY_SIZE + len(pool)
+    out = bytearray(struct.pack(PMU_PACK_HDR_FMT, PMU_PACK_MAGIC, PMU_PACK_VERSION, len(images), 0,
+                                len(pool), max(len(data) for _, data in images)))
+    report = []
+    for (name, data), (dict_offset, dict_len, stream) in zip(images, streams):
+        out += struct.pack(PMU_PACK_ENTRY_FMT, len(data), dict_offset, dict_len, offset, len(stream))
+        offset += len(stream)
+        report.append((name, len(data), dict_len, len(stream)))
+    out += pool
+    for _, _, stream in streams:
+        out += stream
+    return bytes(out), len(pool), report
+
+
+def unpack(blob):
+    """Return the decoded images in directory order."""
+    magic, version, num_images, _, pool_len, _ = struct.unpack_from(PMU_PACK_HDR_FMT, blob, 0)
+    if magic != PMU_PACK_MAGIC or version != PMU_PACK_VERSION:
+        raise ValueError('not a packed PMU image blob')
+    pool_offset = PMU_PACK_HDR_SIZE + num_images * PMU_PACK_ENTRY_SIZE
+    pool = blob[pool_offset:pool_offset + pool_len]
+    images = []
+    for i in range(num_images):
+        raw_len, dict_offset, dict_len, stream_offset, stream_len = \
+            struct.unpack_from(PMU_PACK_ENTRY_FMT, blob, PMU_PACK_HDR_SIZE + i * PMU_PACK_ENTRY_SIZE)
+        images.append(fw_image_pack.decompress(blob[stream_offset:stream_offset + stream_len], raw_len,
+                                               WINDOW_LOG2, pool[dict_offset:dict_offset + dict_len]))
+    return images
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack the DDR PHY PMU training firmware images')
+    parser.add_argument('-f', dest='fw_dir', required=True, help='PHY firmware directory, one subdirectory per variant')
+    parser.add_argument('-o', dest='outfile', required=True, help='packed output blob')
+    parser.add_argument('-b', dest='buf_size', type=int, default=DEFAULT_BUF_SIZE,
+                        help='size of the firmware decode buffer (default %d)' % DEFAULT_BUF_SIZE)
+    parser.add_argument('-v', dest='verbose', action='store_true', help='report the size of each image')
+    args = parser.parse_args()
+
+    images = images_load(args.fw_dir)
+    for name, data in images:
+        if len(data) > args.buf_size:
+            print('%s is %d bytes, the decode buffer is %d bytes: increase EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE' %
+                  (name, len(data), args.buf_size))
+            return 1
+
+    start = time.time()
+    blob, pool_len, report = pack(images)
+    pack_time = time.time() - start
+
+    # Always prove the blob decodes back to the images before linking it
+    start = time.time()
+    if unpack(blob) != [data for _, data in images]:
+        print('**** ERROR: packed PMU images do not decode to the input ****')
+        return 1
+    unpack_time = time.time() - start
+
+    with open(args.outfile, 'wb') as f:
+        f.write(blob)
+
+    if args.verbose:
+        for name, raw_len, dict_len, stream_len in report:
+            print('  %-28s %6d -> %6d bytes, dictionary %d bytes' % (name, raw_len, stream_len, dict_len))
+
+    raw_total = sum(len(data) for _, data in images)
+    print('%s: %d images, %d -> %d bytes (%.1f%%), pool %d bytes, pack %.2fs, verify %.2fs' %
+          (args.outfile, len(images), raw_total, len(blob), 100.0 * len(blob) / raw_total,
+           pool_len, pack_time, unpack_time))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
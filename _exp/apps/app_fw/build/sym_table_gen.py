@@ -0,0 +1,199 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Post-link generator for the function symbol table used by
+#                 stack_trace_get_function_name()
+#
+# NOTES        :  The function symbols of the linked ELF are written into the
+#                 .sym_table section reserved by app_fw.ld, directly in the
+#                 .mem image produced by the linker, so the table is part of
+#                 the image that is signed and programmed. The section comes
+#                 after all code, so its contents do not move any function.
+#
+#                 Table layout (little endian, see stack_trace_plat.h):
+#                   0  magic        'SYMT'
+#                   4  num_entries  number of entries
+#                   8  pool_offset  offset of the string pool from the table
+#                   12 pool_size    size of the string pool
+#                   16 rom_start    physical link address of the ROM image
+#                   20 rom_end      physical link address following it
+#                   24 entries      (physical start address, name offset)
+#                                   sorted by address
+#                   .. string pool  NUL terminated names, a name that is the
+#                                   tail of another shares its bytes
+#
+#                 An entry whose name offset is 0xFFFFFFFF marks the end of
+#                 a function that is not directly followed by another one,
+#                 so addresses in gaps do not resolve to a name.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+SYM_TABLE_MAGIC = 0x544D5953
+SYM_TABLE_HDR_FMT = '<IIIIII'
+SYM_TABLE_HDR_SIZE = struct.calcsize(SYM_TABLE_HDR_FMT)
+SYM_TABLE_ENTRY_FMT = '<II'
+SYM_TABLE_NO_NAME = 0xFFFFFFFF
+
+SYM_TABLE_SECTION = '.sym_table'
+ROM_START_SYMBOL = '__ghs_romstart'
+PHY_MASK = 0x1FFFFFFF
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+STB_LOCAL = 0
+SHN_UNDEF = 0
+
+
+class Elf32(object):
+    """Minimal little endian ELF32 reader for section headers and symbols."""
+
+    def __init__(self, data):
+        if data[:4] != b'\x7fELF' or data[4:5] != b'\x01' or data[5:6] != b'\x01':
+            raise ValueError('not a little endian ELF32 file')
+        self.data = data
+        (shoff,) = struct.unpack_from('<I', data, 32)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 46)
+        self.sections = []
+        for i in range(shnum):
+            self.sections.append(struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize))
+        names = self.sections[shstrndx]
+        self.names = data[names[4]:names[4] + names[5]]
+
+    def _str(self, table, off):
+        end = table.index(b'\0', off)
+        return table[off:end].decode('ascii', 'replace')
+
+    def section_get(self, name):
+        """Return (addr, size) of a section, None if not present."""
+        for sec in self.sections:
+            if self._str(self.names, sec[0]) == name:
+                return sec[3], sec[5]
+        return None
+
+    def symbols(self):
+        """Yield (name, value, size, type, bind, shndx) for each symbol."""
+        for sec in self.sections:
+            if sec[1] != SHT_SYMTAB:
+                continue
+            strsec = self.sections[sec[6]]
+            strtab = self.data[strsec[4]:strsec[4] + strsec[5]]
+            for off in range(sec[4], sec[4] + sec[5], sec[9]):
+                st_name, value, size, info, _, shndx = struct.unpack_from('<IIIBBH', self.data, off)
+                yield self._str(strtab, st_name), value, size, info & 0xF, info >> 4, shndx
+
+
+def functions_get(elf):
+    """Return [(phys_addr, size, name)] sorted by address, one per address."""
+    by_addr = {}
+    for name, value, size, typ, bind, shndx in elf.symbols():
+        if typ != STT_FUNC or shndx == SHN_UNDEF or not name:
+            continue
+        addr = value & PHY_MASK
+        prev = by_addr.get(addr)
+        # prefer a global name and the larger size for aliases
+        if prev is None or (prev[3] == STB_LOCAL and bind != STB_LOCAL):
+            by_addr[addr] = (addr, max(size, prev[1] if prev else 0), name, bind)
+    return [f[:3] for f in sorted(by_addr.values())]
+
+
+def pool_build(names):
+    """Build the string pool, sharing the tail of longer names."""
+    offsets = {}
+    pool = bytearray()
+    # longest first among names with the same reversed prefix
+    for name in sorted(set(names), key=lambda n: n[::-1], reverse=True):
+        enc = name.encode('ascii', 'replace') + b'\0'
+        idx = pool.find(enc)
+        if idx < 0:
+            idx = len(pool)
+            pool += enc
+        offsets[name] = idx
+    return bytes(pool), offsets
+
+
+def table_build(funcs, rom_start, rom_end):
+    """Return the table image for a list of (addr, size, name)."""
+    pool, offsets = pool_build([f[2] for f in funcs])
+    entries = []
+    for i, (addr, size, name) in enumerate(funcs):
+        entries.append((addr, offsets[name]))
+        end = addr + size
+        if size and (i + 1 == len(funcs) or funcs[i + 1][0] > end):
+            entries.append((end, SYM_TABLE_NO_NAME))
+
+    pool_offset = SYM_TABLE_HDR_SIZE + len(entries) * struct.calcsize(SYM_TABLE_ENTRY_FMT)
+    out = bytearray(struct.pack(SYM_TABLE_HDR_FMT, SYM_TABLE_MAGIC, len(entries),
+                                pool_offset, len(pool), rom_start, rom_end))
+    for addr, name_off in entries:
+        out += struct.pack(SYM_TABLE_ENTRY_FMT, addr, name_off)
+    out += pool
+    return bytes(out), len(entries)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Write the function symbol table into a linked image')
+    parser.add_argument('-e', dest='elffile', required=True, help='linked ELF file')
+    parser.add_argument('-m', dest='memfile', required=True, help='.mem image produced by the linker, patched in place')
+    args = parser.parse_args()
+
+    with open(args.elffile, 'rb') as f:
+        elf = Elf32(f.read())
+
+    section = elf.section_get(SYM_TABLE_SECTION)
+    if section is None:
+        print('%s: no %s section, table not generated' % (args.elffile, SYM_TABLE_SECTION))
+        return 0
+    sec_addr, sec_size = section
+
+    rom_start = None
+    for name, value, _, _, _, _ in elf.symbols():
+        if name == ROM_START_SYMBOL:
+            rom_start = value & PHY_MASK
+            break
+    if rom_start is None:
+        print('%s: symbol %s not found' % (args.elffile, ROM_START_SYMBOL))
+        return 1
+
+    funcs = functions_get(elf)
+    table, num_entries = table_build(funcs, rom_start, sec_addr & PHY_MASK)
+    if len(table) > sec_size:
+        print('symbol table needs %d bytes, %s is %d bytes: increase sym_table_reserve in app_fw.ld' %
+              (len(table), SYM_TABLE_SECTION, sec_size))
+        return 1
+
+    with open(args.memfile, 'r+b') as f:
+        mem = bytearray(f.read())
+        offset = (sec_addr & PHY_MASK) - rom_start
+        if offset < 0 or offset + sec_size > len(mem):
+            print('%s: %s is outside the image' % (args.memfile, SYM_TABLE_SECTION))
+            return 1
+        mem[offset:offset + len(table)] = table
+        f.seek(0)
+        f.write(mem)
+
+    print('symbol table: %d functions, %d entries, %d bytes of %d' %
+          (len(funcs), num_entries, len(table), sec_size))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
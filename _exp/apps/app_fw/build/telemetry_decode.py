@@ -0,0 +1,187 @@
+#*******************************************************************************
+#  Copyright 2021 Microchip Technology Inc. and its subsidiaries.
+#  Subject to your compliance with these terms, you may use Microchip
+#  software and any derivatives exclusively with Microchip products. It is
+#  your responsibility to comply with third party license terms applicable to
+#  your use of third party software (including open source software) that may
+#  accompany Microchip software.
+#  THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+#  EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+#  IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+#  PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+#  SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR
+#  EXPENSE OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED,
+#  EVEN IF MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+#  FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+#  LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT
+#  EXCEED THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO
+#  MICROCHIP FOR THIS SOFTWARE.
+# -----------------------------------------------------------------------------
+# DESCRIPTION  :  Decoder for the telemetry snapshot returned by the
+#                 EXP_FW_TELEMETRY_SNAPSHOT_GET OpenCAPI command or the
+#                 EXP_FW_READ_TELEMETRY TWI command
+#
+# NOTES        :  Image layout (little endian, see ech_telemetry.h):
+#                   0  magic          'ETLM'
+#                   4  version
+#                   5  num_tlvs
+#                   6  size           UINT16, header included
+#                   8  ticks_per_ms   CP0 Count ticks per millisecond
+#                   12 build_ticks    time taken to build the snapshot
+#                   16 TLV records    type (UINT8), reserved (UINT8),
+#                                     len (UINT16), value padded to 4 bytes
+#
+#                 Records of unknown type are reported as raw bytes, values
+#                 longer than known are decoded up to the known fields.
+#
+#*******************************************************************************/
+import sys
+import struct
+import argparse
+
+ECH_TELEMETRY_MAGIC = 0x4D4C5445
+ECH_TELEMETRY_VERSION = 1
+ECH_TELEMETRY_HDR_FMT = '<IBBHII'
+ECH_TELEMETRY_TLV_FMT = '<BBH'
+
+ECH_STATS_TABLE = {0: 'OC', 1: 'TWI', 2: 'TWI_DEF'}
+TEMP_SENSOR = ['dimm0', 'dimm1', 'onchip']
+TEMP_FLAGS = [(0x01, 'valid'), (0x02, 'present'), (0x04, 'error')]
+DDR_TRAIN_PHASE = ['idle', 'start', 'load_1d', 'train_1d', 'load_2d', 'train_2d', 'results', 'cal_save', 'done']
+DDR_TRAIN_MAJOR_NONE = 0xFF00
+
+
+def flags_str(value, names):
+    return ','.join(name for bit, name in names if value & bit) or '-'
+
+
+def fw_decode(value):
+    major, minor, patch, build_num, build_date, uptime = struct.unpack_from('<6I', value)
+    return ['version %d.%d.%d build %d date %08x' % (major, minor, patch, build_num, build_date),
+            'uptime %d s' % uptime]
+
+
+def boot_mode_decode(value):
+    raw, tl, dl, host, mfg, freq, lane, oc_lb, serdes_lb = struct.unpack_from('<I8B', value)
+    return ['boot_cfg 0x%08x tl_mode %d dl_boot_mode %d host_boot %d mfg %d' % (raw, tl, dl, host, mfg),
+            'serdes_freq %d lane_cfg %d ocapi_loopback %d serdes_loopback %d' % (freq, lane, oc_lb, serdes_lb)]
+
+
+def temperature_decode(value):
+    lines = []
+    for i in range(len(value) // 8):
+        temp, flags, _, seconds = struct.unpack_from('<HBBI', value, i * 8)
+        name = TEMP_SENSOR[i] if i < len(TEMP_SENSOR) else str(i)
+        lines.append('%-6s raw 0x%04x %-20s at %d s' % (name, temp, flags_str(flags, TEMP_FLAGS), seconds))
+    return lines
+
+
+def serdes_cal_decode(value):
+    enabled, initialized, lanes, _, runs, fails, last_rc, seconds = struct.unpack_from('<4B4I', value)
+    return ['enabled %d initialized %d runs %d failed %d' % (enabled, initialized, runs, fails),
+            'last rc 0x%08x lanes 0x%02x at %d s' % (last_rc, lanes, seconds)]
+
+
+def error_decode(value):
+    return ['ext_err_code 0x%02x' % value[0]]
+
+
+def cmd_counts_decode(value):
+    table, num_cmds, _ = struct.unpack_from('<BBH', value)
+    counts = struct.unpack_from('<%dI' % num_cmds, value, 4)
+    called = ['0x%02x:%d' % (cmd, count) for cmd, count in enumerate(counts) if count]
+    return ['%-7s %s' % (ECH_STATS_TABLE.get(table, str(table)), ' '.join(called) or '-')]
+
+
+def flash_decode(value):
+    (partition,) = struct.unpack_from('<B', value)
+    lines = ['boot partition %s' % chr(partition)]
+    for i, name in enumerate(['active', 'redundant']):
+        major, minor, patch, build_num, build_date = struct.unpack_from('<5I', value, 4 + i * 20)
+        lines.append('%-9s version %d.%d.%d build %d date %08x' % (name, major, minor, patch, build_num, build_date))
+    return lines
+
+
+def ddr_dl_update_decode(value):
+    (enabled, ref_valid, temp, dl_ref, zq_ref, evals, dl, zq, deferred, forced, fails,
+     last_rc, seconds) = struct.unpack_from('<BBhhh8I', value)
+    return ['enabled %d temp %.2f C, delay line at %.2f C, ZQ at %.2f C%s' %
+            (enabled, temp / 16.0, dl_ref / 16.0, zq_ref / 16.0, '' if ref_valid else ' (not set)'),
+            'readings %d delay line %d ZQ %d deferred %d forced %d failed %d' % (evals, dl, zq, deferred, forced, fails),
+            'last rc 0x%08x at %d s' % (last_rc, seconds)]
+
+
+def ddr_train_decode(value):
+    (phase, _, last_major, runs, rc, majors, yields, max_hold_us,
+     elapsed) = struct.unpack_from('<BBH5IQ', value)
+    phase_name = DDR_TRAIN_PHASE[phase] if phase < len(DDR_TRAIN_PHASE) else str(phase)
+    major = '-' if last_major == DDR_TRAIN_MAJOR_NONE else '0x%02x' % last_major
+    return ['phase %s run %d rc 0x%08x elapsed %d ticks' % (phase_name, runs, rc, elapsed),
+            'PMU major messages %d last %s' % (majors, major),
+            'yields %d main loop held off %d us at most' % (yields, max_hold_us)]
+
+
+ECH_TELEMETRY_TYPE = {
+    1: ('fw', fw_decode),
+    2: ('boot_mode', boot_mode_decode),
+    3: ('temperature', temperature_decode),
+    4: ('serdes_cal', serdes_cal_decode),
+    5: ('error', error_decode),
+    6: ('cmd_counts', cmd_counts_decode),
+    7: ('flash', flash_decode),
+    8: ('ddr_dl_update', ddr_dl_update_decode),
+    9: ('ddr_train', ddr_train_decode),
+}
+
+
+def snapshot_parse(data):
+    """Return (ticks_per_ms, build_ticks, [(type, value)]) from a snapshot image."""
+    hdr_size = struct.calcsize(ECH_TELEMETRY_HDR_FMT)
+    tlv_size = struct.calcsize(ECH_TELEMETRY_TLV_FMT)
+    magic, version, num_tlvs, size, ticks_per_ms, build_ticks = struct.unpack_from(ECH_TELEMETRY_HDR_FMT, data, 0)
+    if magic != ECH_TELEMETRY_MAGIC:
+        raise ValueError('bad magic 0x%08x' % magic)
+    if version != ECH_TELEMETRY_VERSION:
+        raise ValueError('unsupported version %d' % version)
+    if size > len(data):
+        raise ValueError('image truncated, %d of %d bytes' % (len(data), size))
+
+    records = []
+    offset = hdr_size
+    for _ in range(num_tlvs):
+        typ, _, length = struct.unpack_from(ECH_TELEMETRY_TLV_FMT, data, offset)
+        offset += tlv_size
+        if offset + length > size:
+            raise ValueError('record type %d overruns the image' % typ)
+        records.append((typ, data[offset:offset + length]))
+        offset += (length + 3) & ~3
+    return ticks_per_ms, build_ticks, records
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the telemetry snapshot')
+    parser.add_argument('-i', dest='infile', required=True, help='binary snapshot image')
+    args = parser.parse_args()
+
+    with open(args.infile, 'rb') as f:
+        try:
+            ticks_per_ms, build_ticks, records = snapshot_parse(f.read())
+        except (ValueError, struct.error) as e:
+            print('%s: %s' % (args.infile, e))
+            return 1
+
+    if ticks_per_ms:
+        print('built in %.1f us' % (build_ticks * 1000.0 / ticks_per_ms))
+    for typ, value in records:
+        name, decode = ECH_TELEMETRY_TYPE.get(typ, ('type %d' % typ, None))
+        try:
+            lines = decode(value) if decode else [value.hex()]
+        except struct.error:
+            lines = ['short value: %s' % value.hex()]
+        for line in lines:
+            print('%-12s %s' % (name, line))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,134 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup APP_FW_BOOT_PROF
+* @{
+* @file
+* @brief
+*    Boot phase profiler.
+*
+* @note
+*    Boot is split into named milestones, each recorded once per boot with
+*    the CP0 Count and the timer0 system seconds when it is reached. A
+*    phase is the time from the previous milestone reached to a milestone,
+*    the first phase the time from reset to the VPE0 main.
+*    The seconds disambiguate Count wraps for phases that wait on the host,
+*    such as the BOOT_CONFIG and DDR PHY init commands.
+*
+*    The profile is read over TWI with EXP_FW_READ_BOOT_PROFILE, so it is
+*    available before the OpenCAPI link is up. When the last milestone is
+*    reached the profile is appended to the saved log journal of the active
+*    image as one log_app_entry_struct per milestone, so consecutive boots
+*    can be compared. boot_prof_diff.py decodes and compares profiles.
+*/
+
+#ifndef _APP_FW_BOOT_PROF_H
+#define _APP_FW_BOOT_PROF_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   Boot milestones, in the order they are normally reached. Only add
+*   milestones at the end, host tools rely on the values.
+*/
+typedef enum
+{
+    APP_FW_BOOT_MS_MAIN = 0,            /**< VPE0 main entered */
+    APP_FW_BOOT_MS_MEM_INIT,            /**< Memory and system timer initialized */
+    APP_FW_BOOT_MS_CONSOLE_INIT,        /**< Console, command server and crash dump initialized */
+    APP_FW_BOOT_MS_LOG_INIT,            /**< Application log and reset module initialized */
+    APP_FW_BOOT_MS_GIC_INIT,            /**< Fatal handlers and interrupt controller initialized */
+    APP_FW_BOOT_MS_SPI_FLASH_INIT,      /**< SPI flash and FAM initialized */
+    APP_FW_BOOT_MS_RED_FW_IMAGE_UPDATE, /**< Redundant firmware image checked */
+    APP_FW_BOOT_MS_ECH_INIT,            /**< Command handler, log platform and shell initialized */
+    APP_FW_BOOT_MS_MODULES_INIT,        /**< SEEPROM, DDR PHY, fatal, flashloader and watchdogs initialized */
+    APP_FW_BOOT_MS_TWI_INIT,            /**< TWI slave up, VPE1 started */
+    APP_FW_BOOT_MS_TEMP_SENSOR_INIT,    /**< Temperature sensor initialized */
+    APP_FW_BOOT_MS_MAIN_LOOP,           /**< Main loop entered, g_boot_timestamp */
+    APP_FW_BOOT_MS_SERDES_INIT,         /**< BOOT_CONFIG step 0 SerDes low level init done */
+    APP_FW_BOOT_MS_BOOT_CFG_0,          /**< BOOT_CONFIG step 0 done */
+    APP_FW_BOOT_MS_BOOT_CFG_1,          /**< BOOT_CONFIG step 1 done, OMI link up */
+    APP_FW_BOOT_MS_DDR_TRAIN,           /**< First DDR PHY training done */
+    APP_FW_BOOT_MS_DDR_CAL_SAVE,        /**< DDR calibration saved, last milestone */
+    APP_FW_BOOT_MS_NUM
+} app_fw_boot_ms_enum;
+
+/*
+** Constants
+*/
+
+/* Boot profile image header */
+#define APP_FW_BOOT_PROF_MAGIC          0x46525042  /* 'BPRF' */
+#define APP_FW_BOOT_PROF_VERSION        1
+
+/* Milestone log entries, log_code = module ID | APP_FW_BOOT_PROF_LOG_CODE | milestone */
+#define APP_FW_BOOT_PROF_LOG_CODE       0xB000
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Time a milestone was reached.
+*/
+typedef struct
+{
+    UINT32 count;                               /**< CP0 Count */
+    UINT32 seconds;                             /**< Timer0 system seconds */
+} app_fw_boot_ms_struct;
+
+/**
+* @brief
+*   Boot profile image returned over TWI.
+*/
+typedef struct
+{
+    UINT32 magic;                               /**< APP_FW_BOOT_PROF_MAGIC */
+    UINT8  version;                             /**< APP_FW_BOOT_PROF_VERSION */
+    UINT8  num_ms;                              /**< APP_FW_BOOT_MS_NUM */
+    UINT16 reserved;
+    UINT32 ticks_per_ms;                        /**< CP0 Count ticks per millisecond */
+    UINT32 fw_version;                          /**< FW_VERSION_CL_NUMBER */
+    UINT32 reached_mask;                        /**< Bit per milestone reached */
+    app_fw_boot_ms_struct ms[APP_FW_BOOT_MS_NUM];   /**< Milestones, 0 if not reached */
+} app_fw_boot_prof_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID app_fw_boot_prof_mark(app_fw_boot_ms_enum ms);
+EXTERN UINT32 app_fw_boot_prof_get(app_fw_boot_prof_struct *prof_ptr);
+EXTERN VOID app_fw_boot_prof_save(VOID);
+EXTERN VOID app_fw_boot_prof_print(VOID);
+EXTERN VOID app_fw_boot_prof_cmdsvr_register(VOID);
+
+#endif /* _APP_FW_BOOT_PROF_H */
+
+/** @} end addtogroup */
+
@@ -48,6 +48,19 @@
 ** Enumerated Types
 */
 
+/**
+* @brief
+*   Groups of DDR PHY training inputs, by the training steps they affect.
+*/
+typedef enum
+{
+    APP_FW_DDR_TRAIN_INPUT_RANK = 0,    /**< DIMM and rank organization, all steps */
+    APP_FW_DDR_TRAIN_INPUT_FREQ,        /**< Frequency and latencies, all steps */
+    APP_FW_DDR_TRAIN_INPUT_DRIVE,       /**< ODT, drive strength and equalization, 2D steps */
+    APP_FW_DDR_TRAIN_INPUT_VREF,        /**< Initial Vref settings, 2D steps */
+    APP_FW_DDR_TRAIN_INPUT_NUM
+} app_fw_ddr_train_input_enum;
+
 /*
 ** Constants
 */
@@ -60,6 +73,8 @@
 #define APP_FW_DDR_ERR_TRAINING_ERASE_TIMEOUT   APP_FW_DDR_ERR_CODE_CREATE(0x004)  /* Error: Training data erase timed out */
 #define APP_FW_DDR_ERR_TRAINING_WRITE           APP_FW_DDR_ERR_CODE_CREATE(0x005)  /* Error: Training data write failed */
 #define APP_FW_DDR_ERR_TRAINING_WRITE_TIMEOUT   APP_FW_DDR_ERR_CODE_CREATE(0x006)  /* Error: Training data write timed out */
+#define APP_FW_DDR_ERR_TRAINING_VERIFY          APP_FW_DDR_ERR_CODE_CREATE(0x007)  /* Error: Restored training failed the DFI BIST */
+#define APP_FW_DDR_ERR_CALIBRATION_SIZE         APP_FW_DDR_ERR_CODE_CREATE(0x008)  /* Error: Calibration data does not fit a slot */
 
 
 /*
@@ -78,6 +93,7 @@ typedef struct
     UINT32              header;      /* 32-bit header to identify the section */
     ddr_timing_data_t   timing_data; /* Structure containing the saved timing data */
     ddr_vref_data_t     vref_data;   /* Structure containing the saved vref data */
+    UINT32              input_sig[APP_FW_DDR_TRAIN_INPUT_NUM]; /* Signatures of the training inputs the data was trained with */
     UINT32              crc;         /* The saved CRC value calculated for the structure */
 } app_fw_ddr_calibration_data_struct;
 
@@ -0,0 +1,148 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup APP_FW_PC_PROF
+* @{
+* @file
+* @brief
+*    Statistical PC-sampling profiler for VPE0.
+*
+* @note
+*    The CP0 Count/Compare interrupt of VPE0, unused otherwise
+*    (CPUHAL_CP0_TIMER_ENABLED is 0), fires every sampling period while
+*    the profiler runs. Its handler records the interrupted EPC either in
+*    a raw ring of the most recent samples or in a histogram of address
+*    buckets over a range of the image, by default all of it.
+*
+*    Code that runs with interrupts disabled is seen at the point where
+*    interrupts are enabled again, and handlers of a priority level at or
+*    above EXP_GIC_PRIO_TIMER are not sampled. Only the sampled PC is
+*    recorded, so the host sees leaf functions, not call stacks.
+*
+*    The cost of each sample is measured: the handler time and the latency
+*    from the Compare match to the handler, both in CP0 Count ticks. The
+*    overhead is the handler time over the sampling period; the period is
+*    set when the profiler is started.
+*
+*    The profiler is controlled with the pc_prof command server command and
+*    the profile read by the host with the EXP_FW_LOG_OP_READ_PC_PROFILE
+*    operand of EXP_FW_LOG. pc_prof_collapse.py maps the samples against
+*    the linked ELF and emits collapsed stacks for flame graph tools.
+*    The image returned is an app_fw_pc_prof_hdr_struct followed by
+*    num_entries UINT32: PCs oldest first, or bucket counts.
+*/
+
+#ifndef _APP_FW_PC_PROF_H
+#define _APP_FW_PC_PROF_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_mid.h"
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   Sample storage.
+*/
+typedef enum
+{
+    APP_FW_PC_PROF_MODE_RING = 0,       /**< Raw ring of the most recent PCs */
+    APP_FW_PC_PROF_MODE_HIST,           /**< Sample count per address bucket */
+    APP_FW_PC_PROF_MODE_MAX
+} app_fw_pc_prof_mode_enum;
+
+/*
+** Constants
+*/
+
+/* Ring entries or histogram buckets, must be a power of 2 */
+#define APP_FW_PC_PROF_NUM_ENTRIES      1024
+
+/* Sampling period limits, microseconds */
+#define APP_FW_PC_PROF_PERIOD_US_DEFAULT    1000
+#define APP_FW_PC_PROF_PERIOD_US_MIN        50
+
+/* Smallest histogram bucket, 16 bytes (4 instructions) */
+#define APP_FW_PC_PROF_BUCKET_SHIFT_MIN     4
+
+/* Profile image header */
+#define APP_FW_PC_PROF_MAGIC            0x52504350  /* 'PCPR' */
+#define APP_FW_PC_PROF_VERSION          1
+
+/* Header flags */
+#define APP_FW_PC_PROF_FLAG_RUNNING     0x01    /* sampling when the image was read */
+#define APP_FW_PC_PROF_FLAG_WRAPPED     0x02    /* ring overwrote older samples */
+
+/* Error codes */
+#define APP_FW_PC_PROF_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_APPFW) | 0x200 | (err_suffix))
+#define APP_FW_PC_PROF_ERR_BAD_PARAM                APP_FW_PC_PROF_ERR_CODE_CREATE(0x001)
+#define APP_FW_PC_PROF_ERR_RUNNING                  APP_FW_PC_PROF_ERR_CODE_CREATE(0x002)
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Header of the profile image returned to the host.
+*/
+typedef struct
+{
+    UINT32 magic;               /**< APP_FW_PC_PROF_MAGIC */
+    UINT8  version;             /**< APP_FW_PC_PROF_VERSION */
+    UINT8  mode;                /**< app_fw_pc_prof_mode_enum */
+    UINT8  bucket_shift;        /**< Histogram: log2 of the bucket size in bytes */
+    UINT8  flags;               /**< APP_FW_PC_PROF_FLAG_xxx */
+    UINT32 period_us;           /**< Sampling period */
+    UINT32 ticks_per_ms;        /**< CP0 Count ticks per millisecond */
+    UINT32 num_samples;         /**< Samples taken since the profiler was started */
+    UINT32 num_entries;         /**< UINT32 entries following the header */
+    UINT32 range_start;         /**< Histogram: address of bucket 0 */
+    UINT32 range_end;           /**< Histogram: end of the range, exclusive */
+    UINT32 outside;             /**< Histogram: samples outside the range */
+    UINT32 isr_ticks_max;       /**< Longest sample handler */
+    UINT32 isr_ticks_avg;       /**< Average sample handler */
+    UINT32 latency_ticks_max;   /**< Longest Compare match to handler */
+    UINT32 overhead_ppm;        /**< Average handler time over the period, parts per million */
+} app_fw_pc_prof_hdr_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID app_fw_pc_prof_init(VOID);
+EXTERN PMCFW_ERROR app_fw_pc_prof_start(app_fw_pc_prof_mode_enum mode,
+                                        UINT32 period_us,
+                                        UINT32 range_start,
+                                        UINT32 range_end);
+EXTERN VOID app_fw_pc_prof_stop(VOID);
+EXTERN UINT32 app_fw_pc_prof_read(UINT8 *buf_ptr, UINT32 len);
+EXTERN VOID app_fw_pc_prof_print(VOID);
+EXTERN VOID app_fw_pc_prof_cmdsvr_register(VOID);
+
+#endif /* _APP_FW_PC_PROF_H */
+
+/** @} end addtogroup */
+
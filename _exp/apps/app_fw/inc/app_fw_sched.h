@@ -0,0 +1,126 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup APP_FW_SCHED
+* @{
+* @file
+* @brief
+*    Cooperative scheduler for the VPE0 main loop.
+*
+* @note
+*    Tasks run to completion in priority order, one task per call to
+*    app_fw_sched_run(), so a ready task of higher priority never waits for
+*    more than the task currently running. A long task may call
+*    app_fw_sched_yield() at points where it is safe to be interrupted to let
+*    higher priority tasks, such as host commands, run before it continues.
+*
+*    A task becomes ready when it is signalled with app_fw_sched_task_ready()
+*    (safe from ISRs and from VPE1), when its poll function returns TRUE or
+*    when its period has elapsed. A task that is not ready costs one check
+*    per pass.
+*
+*    A task held with app_fw_sched_task_hold() does not run, from the main
+*    loop or from a yield point, until it is released. Signals it gets
+*    meanwhile are kept.
+*/
+
+#ifndef _APP_FW_SCHED_H
+#define _APP_FW_SCHED_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_mid.h"
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   VPE0 main loop tasks.
+*/
+typedef enum
+{
+    APP_FW_SCHED_TASK_HOST_CMD = 0,     /**< OpenCAPI host command handler */
+    APP_FW_SCHED_TASK_TWI_DEFERRED,     /**< I2C deferred command handler */
+    APP_FW_SCHED_TASK_TEMP_SENSOR,      /**< Temperature sensor update */
+    APP_FW_SCHED_TASK_UART_SHELL,       /**< UART shell */
+    APP_FW_SCHED_TASK_SERDES_CAL,       /**< Periodic serdes calibration */
+    APP_FW_SCHED_TASK_BOOT_PROF,        /**< Boot profile save */
+    APP_FW_SCHED_TASK_DDR_DL_UPDATE,    /**< DDR PHY delay line update policy */
+    APP_FW_SCHED_TASK_DDR_TRAIN,        /**< DDR PHY training of EXP_FW_DDR_PHY_INIT */
+    APP_FW_SCHED_TASK_MAX
+} app_fw_sched_task_enum;
+
+/*
+** Constants
+*/
+
+/* Task priorities, lower values run first */
+#define APP_FW_SCHED_PRIO_HOST          0
+#define APP_FW_SCHED_PRIO_DEFERRED      1
+#define APP_FW_SCHED_PRIO_HOUSEKEEPING  2
+#define APP_FW_SCHED_PRIO_BACKGROUND    3
+
+/* Error codes */
+#define APP_FW_SCHED_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_APPFW) | 0x100 | (err_suffix))
+#define APP_FW_SCHED_ERR_BAD_PARAM                APP_FW_SCHED_ERR_CODE_CREATE(0x001)
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Task body, runs to completion.
+*/
+typedef VOID (*app_fw_sched_task_fn_ptr_type)(VOID);
+
+/**
+* @brief
+*   Task poll function, returns TRUE if the task has work. Used for events
+*   that are raised where the task can not be signalled. Must be cheap.
+*/
+typedef BOOL (*app_fw_sched_poll_fn_ptr_type)(VOID);
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID app_fw_sched_init(VOID);
+EXTERN VOID app_fw_sched_task_register(app_fw_sched_task_enum task_id,
+                                       CHAR *name,
+                                       app_fw_sched_task_fn_ptr_type task_fn_ptr,
+                                       app_fw_sched_poll_fn_ptr_type poll_fn_ptr,
+                                       UINT32 priority,
+                                       UINT32 period_us,
+                                       UINT32 budget_us);
+EXTERN VOID app_fw_sched_task_ready(app_fw_sched_task_enum task_id);
+EXTERN VOID app_fw_sched_task_hold(app_fw_sched_task_enum task_id, BOOL hold);
+EXTERN BOOL app_fw_sched_run(VOID);
+EXTERN VOID app_fw_sched_yield(VOID);
+EXTERN VOID app_fw_sched_stats_print(VOID);
+
+#endif /* _APP_FW_SCHED_H */
+
+/** @} end addtogroup */
+
+
@@ -35,6 +35,12 @@
 ** Constants
 */
 
+/* Function symbol table written into .sym_table by sym_table_gen.py */
+#define STACK_TRACE_SYM_TABLE_MAGIC     0x544D5953  /* 'SYMT' */
+
+/* Name offset of an entry marking the end of a function */
+#define STACK_TRACE_SYM_NO_NAME         0xFFFFFFFF
+
 /*
 ** Macro Definitions
 */
@@ -43,6 +49,30 @@
 ** Structures and Unions
 */
 
+/*
+** Header of the function symbol table. It is followed by num_entries
+** entries sorted by address and the string pool at pool_offset.
+*/
+typedef struct
+{
+    UINT32 magic;           /* STACK_TRACE_SYM_TABLE_MAGIC */
+    UINT32 num_entries;     /* Number of stack_trace_sym_entry_struct entries */
+    UINT32 pool_offset;     /* Offset of the string pool from the header */
+    UINT32 pool_size;       /* Size of the string pool */
+    UINT32 rom_start;       /* Physical link address of the ROM image */
+    UINT32 rom_end;         /* Physical link address following the ROM code */
+} stack_trace_sym_table_hdr_struct;
+
+/*
+** Function symbol table entry. The function extends up to the address of
+** the next entry.
+*/
+typedef struct
+{
+    UINT32 addr;            /* Physical link address of the function */
+    UINT32 name_offset;     /* Offset in the string pool, STACK_TRACE_SYM_NO_NAME if none */
+} stack_trace_sym_entry_struct;
+
 /*
 ** Global Variables
 */
@@ -0,0 +1,338 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup APP_FW_BOOT_PROF
+* @{
+* @file
+* @brief
+*   Boot phase profiler implementation.
+*
+* @note
+*   Milestones are written once, before their bit is set in the reached
+*   mask, so VPE1 reads a consistent profile for the TWI command.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "pmcfw_mid.h"
+#include "cpuhal.h"
+#include "bc_printf.h"
+#include "sys_timer_api.h"
+#include "opsw_timer.h"
+#include "log_app_api.h"
+#include "log_plat.h"
+#include "fw_version_info.h"
+#include "cmdsvr_plat_cfg.h"
+#include "app_fw_sched.h"
+#include "app_fw_boot_prof.h"
+
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_func_api.h"
+#endif
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Constants
+*/
+
+#define PMC_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Local Variables
+*/
+
+PRIVATE app_fw_boot_ms_struct app_fw_boot_ms[APP_FW_BOOT_MS_NUM];
+PRIVATE volatile UINT32 app_fw_boot_reached_mask;
+
+/* Profile appended to the saved log */
+PRIVATE BOOL app_fw_boot_prof_saved;
+
+/* Milestone names, in app_fw_boot_ms_enum order */
+PRIVATE const CHAR *app_fw_boot_ms_name[APP_FW_BOOT_MS_NUM] =
+{
+    "main",
+    "mem_init",
+    "console_init",
+    "log_init",
+    "gic_init",
+    "spi_flash_init",
+    "red_fw_image_update",
+    "ech_init",
+    "modules_init",
+    "twi_init",
+    "temp_sensor_init",
+    "main_loop",
+    "serdes_init",
+    "boot_cfg_0",
+    "boot_cfg_1",
+    "ddr_train",
+    "ddr_cal_save"
+};
+
+/*
+* Forward References
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR app_fw_boot_prof_cmd_show(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the boot profiler */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct app_fw_boot_prof_cmd_set[] = {
+    {
+        "boot_prof",
+        "Show the boot phase profile",
+        app_fw_boot_prof_cmd_show,
+        "Cmd Usage: boot_prof\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/*
+* Private Functions
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/**
+* @brief
+*   Command server handler to show the boot profile.
+*
+* @param[in] args     - command arguments
+* @param[in] num_args - number of arguments
+*
+* @return
+*   PMC_SUCCESS
+*/
+PRIVATE PMCFW_ERROR app_fw_boot_prof_cmd_show(CHAR **args, UINT8 num_args)
+{
+    app_fw_boot_prof_print();
+
+    return PMC_SUCCESS;
+}
+#endif
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Record that a boot milestone has been reached. Only the first call per
+*   milestone is recorded. Safe before any module is initialized.
+*
+* @param[in] ms - milestone
+*
+* @return
+*   None
+*
+* @note
+*   Reaching the last milestone schedules the profile to be appended to
+*   the saved log.
+*/
+PUBLIC VOID app_fw_boot_prof_mark(app_fw_boot_ms_enum ms)
+{
+    if ((ms >= APP_FW_BOOT_MS_NUM) ||
+        (0 != (app_fw_boot_reached_mask & (1 << ms))))
+    {
+        return;
+    }
+
+    app_fw_boot_ms[ms].count = hal_cp0_counter_get();
+    app_fw_boot_ms[ms].seconds = opsw_timer0_read();
+    hal_mem_sync_wmb();
+    app_fw_boot_reached_mask |= (1 << ms);
+
+    if ((APP_FW_BOOT_MS_NUM - 1) == ms)
+    {
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_BOOT_PROF);
+    }
+}
+
+/**
+* @brief
+*   Get the boot profile. Safe from either VPE once the system timer is
+*   initialized.
+*
+* @param[out] prof_ptr - profile
+*
+* @return
+*   Size of the profile in bytes
+*/
+PUBLIC UINT32 app_fw_boot_prof_get(app_fw_boot_prof_struct *prof_ptr)
+{
+    memset(prof_ptr, 0, sizeof(*prof_ptr));
+    prof_ptr->magic = APP_FW_BOOT_PROF_MAGIC;
+    prof_ptr->version = APP_FW_BOOT_PROF_VERSION;
+    prof_ptr->num_ms = APP_FW_BOOT_MS_NUM;
+    prof_ptr->ticks_per_ms = sys_timer_us_to_count(1000);
+    prof_ptr->fw_version = FW_VERSION_CL_NUMBER;
+
+    prof_ptr->reached_mask = app_fw_boot_reached_mask;
+    hal_mem_sync_rmb();
+    memcpy(prof_ptr->ms, app_fw_boot_ms, sizeof(prof_ptr->ms));
+
+    return (sizeof(*prof_ptr));
+}
+
+/**
+* @brief
+*   Append the boot profile to the saved log journal, once per boot. Runs
+*   as a background task of the VPE0 main loop.
+*
+* @return
+*   None
+*
+* @note
+*   Each milestone reached is one log_app_entry_struct: ts_u and ts_l hold
+*   the seconds and Count, log_code the milestone, log_word0 the ticks per
+*   millisecond, log_word1 FW_VERSION_CL_NUMBER and log_word2 the reached
+*   mask. The entries of a boot start with APP_FW_BOOT_MS_MAIN.
+*
+*   The boot log channel is saved with the profile, see log_chan.h.
+*/
+PUBLIC VOID app_fw_boot_prof_save(VOID)
+{
+    log_app_entry_struct entry[APP_FW_BOOT_MS_NUM];
+    UINT32 reached_mask = app_fw_boot_reached_mask;
+    UINT32 ticks_per_ms = sys_timer_us_to_count(1000);
+    UINT32 num_entries = 0;
+    UINT32 ms;
+    PMCFW_ERROR rc;
+
+    if (TRUE == app_fw_boot_prof_saved)
+    {
+        return;
+    }
+    app_fw_boot_prof_saved = TRUE;
+
+    hal_mem_sync_rmb();
+    for (ms = 0; ms < APP_FW_BOOT_MS_NUM; ms++)
+    {
+        if (0 == (reached_mask & (1 << ms)))
+        {
+            continue;
+        }
+
+        entry[num_entries].ts_u = app_fw_boot_ms[ms].seconds;
+        entry[num_entries].ts_l = app_fw_boot_ms[ms].count;
+        entry[num_entries].log_code = (PMCFW_MID_APPFW << 16) | APP_FW_BOOT_PROF_LOG_CODE | ms;
+        entry[num_entries].log_word0 = ticks_per_ms;
+        entry[num_entries].log_word1 = FW_VERSION_CL_NUMBER;
+        entry[num_entries].log_word2 = reached_mask;
+        entry[num_entries].log_word3 = 0;
+        entry[num_entries].log_word4 = 0;
+        num_entries++;
+    }
+
+    rc = log_spi_flash_entries_append(entry, num_entries);
+    if (PMC_SUCCESS != rc)
+    {
+        bc_printf("boot profile not saved rc = 0x%08x\n", rc);
+    }
+
+    rc = log_spi_flash_chan_store();
+    if (PMC_SUCCESS != rc)
+    {
+        bc_printf("log channels not saved rc = 0x%08x\n", rc);
+    }
+}
+
+/**
+* @brief
+*   Print the boot profile.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_boot_prof_print(VOID)
+{
+    app_fw_boot_prof_struct prof;
+    UINT32 prev = APP_FW_BOOT_MS_NUM;
+    UINT32 ms;
+    UINT32 phase_us;
+
+    (VOID)app_fw_boot_prof_get(&prof);
+
+    bc_printf("     count    seconds   phase_us  milestone\n");
+    for (ms = 0; ms < APP_FW_BOOT_MS_NUM; ms++)
+    {
+        if (0 == (prof.reached_mask & (1 << ms)))
+        {
+            continue;
+        }
+
+        if (APP_FW_BOOT_MS_NUM == prev)
+        {
+            /* CP0 Count starts at reset */
+            phase_us = sys_timer_count_to_us(prof.ms[ms].count);
+        }
+        else
+        {
+            /* Count wraps within seconds, trust it for short phases only */
+            if ((prof.ms[ms].seconds - prof.ms[prev].seconds) < 2)
+            {
+                phase_us = sys_timer_count_to_us(prof.ms[ms].count - prof.ms[prev].count);
+            }
+            else
+            {
+                phase_us = (prof.ms[ms].seconds - prof.ms[prev].seconds) * 1000000;
+            }
+        }
+        prev = ms;
+
+        bc_printf("%10d %10d %10d  %s\n",
+                  prof.ms[ms].count,
+                  prof.ms[ms].seconds,
+                  phase_us,
+                  app_fw_boot_ms_name[ms]);
+    }
+}
+
+/**
+* @brief
+*   Register the boot profiler command server commands.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_boot_prof_cmdsvr_register(VOID)
+{
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+
+    rv = cmdsvr_func_list_register(app_fw_boot_prof_cmd_set, PMC_ARRAY_SIZE(app_fw_boot_prof_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
+}
+
+/* End of File */
+
+/** @} end addtogroup */
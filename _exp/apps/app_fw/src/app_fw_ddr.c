@@ -20,6 +20,7 @@
 ** Include Files
 */
 #include <string.h>
+#include <stddef.h>
 #include "pmcfw_types.h"
 #include "pmcfw_err.h"
 #include "target_platform.h"
@@ -30,6 +31,10 @@
 #include "exp_ddr_ctrlr_plat.h"
 #include "ocmb_plat.h"
 #include "ddr_api.h"
+#include "ddr_phy.h"
+#include "ddrphy_dfibist.h"
+#include "cpuhal.h"
+#include "sys_timer_api.h"
 #include "app_fw.h"
 #include "app_fw_ddr.h"
 #include "ddr_exp_cmdsvr.h"
@@ -47,12 +52,134 @@
 ** Local Constants
 */
 
-#define APP_FW_DDR_SAVED_DATA_HEADER 0xDD20DD20
+#define APP_FW_DDR_SAVED_DATA_HEADER 0xDD21DD21
+
+/*
+** Saved calibration slots. Each is a subsector holding a commit page
+** followed by the calibration data.
+*/
+#define APP_FW_DDR_CAL_NUM_SLOTS        2
+#define APP_FW_DDR_CAL_SLOT_SIZE        (4 * 1024)
+#define APP_FW_DDR_CAL_PAGE_SIZE        256
+#define APP_FW_DDR_CAL_DATA_OFFSET      APP_FW_DDR_CAL_PAGE_SIZE
+#define APP_FW_DDR_CAL_SLOT_NONE        0xFF
+#define APP_FW_DDR_CAL_COMMIT_MAGIC     0x4C414344  /* 'DCAL' */
+
+/* DFI BIST run on restored training, in ddrRunBistSequence() timeout units */
+#define APP_FW_DDR_VERIFY_BIST_TIMEOUT  1000
+
+/* DDR4 x4 and x8 bank groups, checked in each rank */
+#define APP_FW_DDR_VERIFY_NUM_BG        4
+
+/* Chip selects that can hold a rank */
+#define APP_FW_DDR_VERIFY_NUM_CS        4
 
 /*
 * Structures
 */
 
+/**
+* @brief
+*   Range of user input MSDG fields that belong to a training input group.
+*/
+typedef struct
+{
+    UINT8  input;       /* app_fw_ddr_train_input_enum */
+    UINT16 start;       /* Offset of the first field */
+    UINT16 end;         /* Offset following the last field */
+} app_fw_ddr_train_input_range_struct;
+
+/**
+* @brief
+*   Address checked by the DFI BIST on restored training, in each bank group.
+*/
+typedef struct
+{
+    UINT8  bank;        /* Bank in the bank group */
+    UINT16 row;         /* Row address */
+    UINT16 col;         /* Start column address, burst aligned */
+} app_fw_ddr_verify_point_struct;
+
+/**
+* @brief
+*   Commit record of a calibration slot, alone in the first page of the
+*   slot and programmed after the data, so a slot only becomes valid once
+*   its data is complete.
+*/
+typedef struct
+{
+    UINT32 magic;       /* APP_FW_DDR_CAL_COMMIT_MAGIC */
+    UINT32 generation;  /* Incremented on every save, the newest valid slot is loaded */
+    UINT32 data_len;    /* sizeof(app_fw_ddr_calibration_data_struct) */
+    UINT32 data_crc;    /* crc of the calibration data */
+    UINT32 crc;         /* CRC of the fields above */
+} app_fw_ddr_cal_commit_struct;
+
+/*
+** Local Variables
+*/
+
+/* Page staging buffer for the slot commit page and the tail of the data */
+PRIVATE UINT8 app_fw_ddr_cal_page_buf[APP_FW_DDR_CAL_PAGE_SIZE];
+
+/* Newest valid slot, APP_FW_DDR_CAL_SLOT_NONE until the slots are checked */
+PRIVATE UINT32 app_fw_ddr_cal_slot = APP_FW_DDR_CAL_SLOT_NONE;
+
+#if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0) && (EXPLORER_DDR_RESTORE_BIST == 1)
+/*
+** Addresses checked in each bank group. One per bank, with the row and
+** column address lines toggled both ways between them. Rows are kept
+** below 16K, which every DDR4 density has.
+*/
+PRIVATE const app_fw_ddr_verify_point_struct app_fw_ddr_verify_points[] =
+{
+    { 0, 0x0000, 0x000 },
+    { 1, 0x3FFF, 0x3F8 },
+    { 2, 0x2AAA, 0x150 },
+    { 3, 0x1555, 0x2A8 },
+};
+
+#define APP_FW_DDR_VERIFY_NUM_POINTS    (sizeof(app_fw_ddr_verify_points) / sizeof(app_fw_ddr_verify_points[0]))
+
+/* Keep checking until a run fails or the time budget runs out */
+#define APP_FW_DDR_VERIFY_CONTINUE(rc, elapsed_us) \
+    ((0 == (rc)) && ((elapsed_us) < EXPLORER_DDR_RESTORE_BIST_BUDGET_US))
+#endif
+
+/*
+** The user input MSDG fields that select the training results. Write
+** leveling, read gate and the 1D steps depend on the organization, the
+** frequency and the latencies; the 2D steps center the eyes in time and
+** voltage and also depend on the termination, drive and initial Vref.
+*/
+#define APP_FW_DDR_MSDG_RANGE(input, first, last) \
+    { (input), offsetof(user_input_msdg_t, first), offsetof(user_input_msdg_t, last) }
+
+PRIVATE const app_fw_ddr_train_input_range_struct app_fw_ddr_train_input_ranges[] =
+{
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_RANK,  DimmType,          SpdCLSupported),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_FREQ,  SpdCLSupported,    Rank4Mode),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_RANK,  Rank4Mode,         NumPStates),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_FREQ,  NumPStates,        PhyOdtImpedance),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_DRIVE, PhyOdtImpedance,   DramWritePreamble),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_FREQ,  DramWritePreamble, PhyEqualization),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_DRIVE, PhyEqualization,   InitVrefDQ),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_VREF,  InitVrefDQ,        OdtWrMapCs),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_DRIVE, OdtWrMapCs,        Geardown),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_FREQ,  Geardown,          RcdDic),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_DRIVE, RcdDic,            DFIMRL_DDRCLK),
+    APP_FW_DDR_MSDG_RANGE(APP_FW_DDR_TRAIN_INPUT_FREQ,  DFIMRL_DDRCLK,     ATxDly_A),
+    { APP_FW_DDR_TRAIN_INPUT_DRIVE, offsetof(user_input_msdg_t, ATxDly_A), sizeof(user_input_msdg_t) }
+};
+
+#if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
+/* Names of the training input groups */
+PRIVATE const CHAR * const app_fw_ddr_train_input_name[APP_FW_DDR_TRAIN_INPUT_NUM] =
+{
+    "rank", "frequency", "drive", "vref"
+};
+#endif
+
 /*
 ** External References
 */
@@ -68,6 +195,152 @@ PUBLIC app_fw_ddr_calibration_data_struct app_fw_ddr_saved_data;
 ** Private Functions
 */
 
+/**
+* @brief
+*   Calculate the signature of each group of training inputs.
+*
+* @param[in]  msdg_ptr      - User input MSDG the PHY is trained with
+* @param[out] input_sig_ptr - APP_FW_DDR_TRAIN_INPUT_NUM signatures
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID app_fw_ddr_train_input_sig_get(const user_input_msdg_t *msdg_ptr, UINT32 *input_sig_ptr)
+{
+    const app_fw_ddr_train_input_range_struct *range_ptr;
+    BOOL init[APP_FW_DDR_TRAIN_INPUT_NUM];
+    UINT32 i;
+
+    for (i = 0; i < APP_FW_DDR_TRAIN_INPUT_NUM; i++)
+    {
+        input_sig_ptr[i] = 0;
+        init[i] = TRUE;
+    }
+
+    for (i = 0; i < (sizeof(app_fw_ddr_train_input_ranges) / sizeof(app_fw_ddr_train_input_ranges[0])); i++)
+    {
+        range_ptr = &app_fw_ddr_train_input_ranges[i];
+        input_sig_ptr[range_ptr->input] = pmc_crc32((const UINT8*)msdg_ptr + range_ptr->start,
+                                                    range_ptr->end - range_ptr->start,
+                                                    input_sig_ptr[range_ptr->input],
+                                                    init[range_ptr->input],
+                                                    TRUE);
+        init[range_ptr->input] = FALSE;
+    }
+}
+
+#if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
+/**
+* @brief
+*   Check restored training with DFI BIST runs at sparse addresses of each
+*   rank and bank group.
+*
+* @param[in] msdg_ptr - User input MSDG the PHY is trained with
+*
+* @return
+*   PMC_SUCCESS if every run passed or the check is disabled,
+*   APP_FW_DDR_ERR_TRAINING_VERIFY otherwise.
+*
+* @note
+*   The runs are ordered address first, then bank group, then rank, so when
+*   EXPLORER_DDR_RESTORE_BIST_BUDGET_US runs out the addresses checked are
+*   spread over all ranks and bank groups. Addresses not reached are not
+*   counted as failures. The time taken and the addresses checked are
+*   printed so the budget can be tuned.
+*/
+PRIVATE PMCFW_ERROR app_fw_ddr_train_verify(const user_input_msdg_t *msdg_ptr)
+{
+#if (EXPLORER_DDR_RESTORE_BIST == 1)
+    const app_fw_ddr_verify_point_struct *point_ptr;
+    ddr_bist_setup_t setup;
+    ddr_bist_result_t result;
+    UINT32 cs_mask = msdg_ptr->CsPresent & ((1 << APP_FW_DDR_VERIFY_NUM_CS) - 1);
+    UINT32 num_ranks = 0;
+    UINT32 num_runs = 0;
+    UINT32 start_count;
+    UINT32 elapsed_us = 0;
+    UINT32 point;
+    UINT32 bg;
+    UINT32 cs;
+    UINT32 rc = 0;
+
+    for (cs = 0; cs < APP_FW_DDR_VERIFY_NUM_CS; cs++)
+    {
+        num_ranks += (cs_mask >> cs) & 1;
+    }
+
+    if (0 != ddrBistInit(0, &setup))
+    {
+        bc_printf("Restored DDR PHY training check: DFI BIST init failed\n");
+        return APP_FW_DDR_ERR_TRAINING_VERIFY;
+    }
+
+    start_count = hal_cp0_counter_get();
+
+    for (point = 0; (point < APP_FW_DDR_VERIFY_NUM_POINTS) && APP_FW_DDR_VERIFY_CONTINUE(rc, elapsed_us); point++)
+    {
+        point_ptr = &app_fw_ddr_verify_points[point];
+
+        for (bg = 0; (bg < APP_FW_DDR_VERIFY_NUM_BG) && APP_FW_DDR_VERIFY_CONTINUE(rc, elapsed_us); bg++)
+        {
+            for (cs = 0; (cs < APP_FW_DDR_VERIFY_NUM_CS) && APP_FW_DDR_VERIFY_CONTINUE(rc, elapsed_us); cs++)
+            {
+                if (0 == (cs_mask & (1 << cs)))
+                {
+                    continue;
+                }
+
+                setup.rankIndex    = cs;
+                setup.bg           = bg;
+                setup.bank         = point_ptr->bank;
+                setup.rowAddr      = point_ptr->row;
+                setup.startColAddr = point_ptr->col;
+                ddrBistSetup(&setup);
+
+                memset(&result, 0, sizeof(result));
+                rc = ddrRunBistSequence(DDR_BIST_2D_LFSR, APP_FW_DDR_VERIFY_BIST_TIMEOUT, &result);
+                if ((0 == rc) && (0 != result.numWordErrors))
+                {
+                    rc = PMCFW_ERR_FAIL;
+                }
+                num_runs++;
+
+                if (0 != rc)
+                {
+                    bc_printf("Restored DDR PHY training failed DFI BIST rc = 0x%x at rank %u bg %u ba %u row 0x%x col 0x%x, %u word errors\n",
+                              rc,
+                              cs,
+                              bg,
+                              point_ptr->bank,
+                              point_ptr->row,
+                              point_ptr->col,
+                              result.numWordErrors);
+                }
+
+                elapsed_us = sys_timer_count_to_us(hal_cp0_counter_get() - start_count);
+            }
+        }
+    }
+
+    ddrCleanupBist();
+
+    bc_printf("Restored DDR PHY training check: %u of %u addresses (ranks 0x%x, %u bank groups) in %u us\n",
+              num_runs,
+              num_ranks * APP_FW_DDR_VERIFY_NUM_BG * APP_FW_DDR_VERIFY_NUM_POINTS,
+              cs_mask,
+              APP_FW_DDR_VERIFY_NUM_BG,
+              elapsed_us);
+
+    if (0 != rc)
+    {
+        return APP_FW_DDR_ERR_TRAINING_VERIFY;
+    }
+#endif
+
+    return PMC_SUCCESS;
+}
+#endif
+
 /**
 * @brief
 *   Get the address in SPI flash where the DDR PHY training
@@ -109,40 +382,99 @@ PRIVATE UINT32 app_fw_ddr_training_data_addr_get(void)
 * @return
 *   PMC_SUCCESS if successful.
 *
+* @note
+*   The saved calibration records the training inputs it was trained with.
+*   When none changed the saved results are restored; when only the
+*   inputs of the 2D steps changed, the 1D timing is restored and training
+*   is rerun from it. Restored results are checked with short DFI BIST runs and
+*   the PHY is fully trained if the check fails or if the organization,
+*   frequency or latencies changed.
 */
 PRIVATE PMCFW_ERROR app_fw_ddr_phy_bringup_init(void)
 {
-    PMCFW_ERROR rc;
+    PMCFW_ERROR rc = PMCFW_ERR_FAIL;
+    UINT32 data_rate;
+    const exp_ddr_ctrlr_spd_struct *spd_info_ptr = exp_ddr_ctrlr_spd_info_get(&data_rate);
+    UINT32 input_sig[APP_FW_DDR_TRAIN_INPUT_NUM];
+    BOOL save = TRUE;
+#if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
+    UINT32 changed = (1 << APP_FW_DDR_TRAIN_INPUT_NUM) - 1;
+    UINT32 i;
+#endif
     
     ddr_api_fw_phy_reset();
 
+    if (NULL != spd_info_ptr)
+    {
+        /* DIMM fields from the SPD the controller configuration was calculated from */
+        exp_ddr_ctrlr_spd_phy_config(spd_info_ptr,
+                                     data_rate,
+                                     &user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG]);
+    }
+
     ddr_api_init(&user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG]);
+    app_fw_ddr_train_input_sig_get(&user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG], input_sig);
 
 #if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
     /* Try loading saved calibration data */
     if (PMC_SUCCESS == app_fw_ddr_calibration_load(&app_fw_ddr_saved_data))
+    {
+        /* find the training inputs that changed since it was saved */
+        changed = 0;
+        for (i = 0; i < APP_FW_DDR_TRAIN_INPUT_NUM; i++)
+        {
+            if (input_sig[i] != app_fw_ddr_saved_data.input_sig[i])
+            {
+                bc_printf("DDR PHY training inputs changed: %s\n", app_fw_ddr_train_input_name[i]);
+                changed |= (1 << i);
+            }
+        }
+    }
+
+    if (0 == changed)
     {
         bc_printf("Restoring saved DDR PHY training results\n");
         /* Restore calibration settings */
         rc = ddr_api_saved_margin_results_load(&app_fw_ddr_saved_data.timing_data,
                                                &app_fw_ddr_saved_data.vref_data);
+        save = FALSE;
+    }
+    else if (0 == (changed & ((1 << APP_FW_DDR_TRAIN_INPUT_RANK) | (1 << APP_FW_DDR_TRAIN_INPUT_FREQ))))
+    {
+        bc_printf("Restoring saved DDR PHY timing and rerunning 2D training\n");
+        /* restore the timing, the saved Vref was trained for other inputs */
+        ddrTimingData = app_fw_ddr_saved_data.timing_data;
+        rc = ddr_phy_init(TRUE, TRUE, TRUE, FALSE, TRUE);
+    }
+
+    if (PMC_SUCCESS == rc)
+    {
+        rc = app_fw_ddr_train_verify(&user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG]);
+        save = save || (PMC_SUCCESS != rc);
     }
-    else
 #endif
+
+    if (PMC_SUCCESS != rc)
     {
         bc_printf("Performing full DDR PHY training\n");
 
         /* Since restoring calibration settings failed perform full training */
+        ddr_api_fw_phy_reset();
+        ddr_api_init(&user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG]);
         rc = ddr_api_fw_train();
 
         if (rc != PMC_SUCCESS)
         {
             bc_printf("app_fw_ddr_phy_bringup_init(): ddr_api_fw_train() failed rc = 0x%x\n", rc);
         }
+    }
 
+    if (save)
+    {
         /* whether training passed or failed, save calibration results */
         ddr_api_cal_results_get(&app_fw_ddr_saved_data.timing_data,
                                 &app_fw_ddr_saved_data.vref_data);
+        memcpy(app_fw_ddr_saved_data.input_sig, input_sig, sizeof(input_sig));
 
         /* save calibration results */
         if (PMC_SUCCESS != app_fw_ddr_calibration_save(&app_fw_ddr_saved_data))
@@ -154,6 +486,120 @@ PRIVATE PMCFW_ERROR app_fw_ddr_phy_bringup_init(void)
     return rc;
 }
 
+/**
+* @brief
+*   Check a calibration slot.
+*
+* @param[in]  slot           - slot index
+* @param[out] generation_ptr - generation of the slot if it is valid
+*
+* @return
+*   TRUE if the slot holds a committed calibration with good CRCs.
+*
+* @note
+*   The slot is read with ECC errors masked since it may be erased or only
+*   partially programmed.
+*/
+PRIVATE BOOL app_fw_ddr_cal_slot_check(UINT32 slot, UINT32 *generation_ptr)
+{
+    app_fw_ddr_cal_commit_struct commit;
+    UINT32 addr = app_fw_ddr_training_data_addr_get() + (slot * APP_FW_DDR_CAL_SLOT_SIZE);
+    UINT32 remaining;
+    UINT32 count;
+    UINT32 crc;
+
+    if (FALSE == spi_flash_plat_checked_read((UINT8*)&commit, (UINT8*)addr, sizeof(commit)))
+    {
+        return FALSE;
+    }
+
+    crc = pmc_crc32((UINT8*)&commit, sizeof(commit) - sizeof(UINT32), 0, TRUE, TRUE);
+    if ((APP_FW_DDR_CAL_COMMIT_MAGIC != commit.magic) ||
+        (sizeof(app_fw_ddr_calibration_data_struct) != commit.data_len) ||
+        (crc != commit.crc))
+    {
+        return FALSE;
+    }
+
+    /* check the data, including its own CRC, one page buffer at a time */
+    addr += APP_FW_DDR_CAL_DATA_OFFSET;
+    remaining = commit.data_len;
+    crc = 0;
+    while (remaining > 0)
+    {
+        count = (remaining > APP_FW_DDR_CAL_PAGE_SIZE) ? APP_FW_DDR_CAL_PAGE_SIZE : remaining;
+
+        if (FALSE == spi_flash_plat_checked_read(app_fw_ddr_cal_page_buf, (UINT8*)addr, count))
+        {
+            return FALSE;
+        }
+
+        crc = pmc_crc32(app_fw_ddr_cal_page_buf, count, crc, (remaining == commit.data_len), (count == remaining));
+        remaining -= count;
+        addr += count;
+    }
+
+    if (crc != commit.data_crc)
+    {
+        return FALSE;
+    }
+
+    *generation_ptr = commit.generation;
+
+    return TRUE;
+}
+
+/**
+* @brief
+*   Find the newest valid calibration slot.
+*
+* @param[out] generation_ptr - generation of the slot found
+*
+* @return
+*   Slot index, APP_FW_DDR_CAL_SLOT_NONE if no slot is valid.
+*/
+PRIVATE UINT32 app_fw_ddr_cal_slot_newest(UINT32 *generation_ptr)
+{
+    UINT32 newest = APP_FW_DDR_CAL_SLOT_NONE;
+    UINT32 generation;
+    UINT32 slot;
+
+    for (slot = 0; slot < APP_FW_DDR_CAL_NUM_SLOTS; slot++)
+    {
+        if (app_fw_ddr_cal_slot_check(slot, &generation) &&
+            ((APP_FW_DDR_CAL_SLOT_NONE == newest) || ((INT32)(generation - *generation_ptr) > 0)))
+        {
+            newest = slot;
+            *generation_ptr = generation;
+        }
+    }
+
+    return newest;
+}
+
+#if (EXPLORER_DDR_TRAIN_PARMS_SAVE_DISABLE == 0)
+/**
+* @brief
+*   Program a page staged in app_fw_ddr_cal_page_buf.
+*
+* @param[in] addr     - SPI flash address of the page
+* @param[in] dev_info - SPI flash device information
+*
+* @return
+*   PMC_SUCCESS if successful.
+*/
+PRIVATE PMCFW_ERROR app_fw_ddr_cal_page_program(UINT32 addr, spi_flash_dev_info_struct *dev_info)
+{
+    return spi_flash_write_pages(SPI_FLASH_PORT,
+                                 SPI_FLASH_CS,
+                                 app_fw_ddr_cal_page_buf,
+                                 (UINT8*)(addr & GPBC_FLASH_PHYS_ADDR_MASK),
+                                 APP_FW_DDR_CAL_PAGE_SIZE,
+                                 dev_info->page_size,
+                                 dev_info->max_time_page_prog);
+}
+#endif
+
 /*
 ** Public Functions
 */
@@ -168,23 +614,53 @@ PRIVATE PMCFW_ERROR app_fw_ddr_phy_bringup_init(void)
 * @return
 *   PMC_SUCCESS if successful.
 *
+* @note
+*   The calibration is written to the slot that does not hold the newest
+*   valid calibration: the slot is erased, the data programmed and the
+*   commit page, with a generation one above the newest, programmed last.
+*   A reset at any point leaves the newest valid calibration in place.
 */
 PUBLIC PMCFW_ERROR app_fw_ddr_calibration_save(app_fw_ddr_calibration_data_struct *ddr_training_data)
 {
     PMCFW_ERROR rc             = PMC_SUCCESS;
 #if (EXPLORER_DDR_TRAIN_PARMS_SAVE_DISABLE == 0)
-    UINT32      spi_flash_addr = app_fw_ddr_training_data_addr_get();
+    app_fw_ddr_cal_commit_struct commit;
+    UINT32      spi_flash_addr;
+    UINT32      generation     = 0;
+    UINT32      newest;
+    UINT32      slot;
+    UINT32      full_len;
+    UINT32      tail_len;
     spi_flash_dev_info_struct dev_info;
     spi_flash_dev_enum        dev;
     UINT8*                    subsector_base;
     UINT32                    subsector_len;
     top_plat_lock_struct lock_struct;
 
+    PMCFW_ASSERT(sizeof(app_fw_ddr_calibration_data_struct) <= (APP_FW_DDR_CAL_SLOT_SIZE - APP_FW_DDR_CAL_DATA_OFFSET),
+                 APP_FW_DDR_ERR_CALIBRATION_SIZE);
+
+    /* write over the older slot, the newest stays valid until the commit */
+    newest = app_fw_ddr_cal_slot_newest(&generation);
+    app_fw_ddr_cal_slot = newest;
+    slot = (APP_FW_DDR_CAL_SLOT_NONE == newest) ? 0 : ((newest + 1) % APP_FW_DDR_CAL_NUM_SLOTS);
+    spi_flash_addr = app_fw_ddr_training_data_addr_get() + (slot * APP_FW_DDR_CAL_SLOT_SIZE);
+
     /* Add header and CRC to training data structure */
     ddr_training_data->header = APP_FW_DDR_SAVED_DATA_HEADER;
-    ddr_training_data->crc = pmc_crc32((UINT8*)&ddr_training_data,
+    ddr_training_data->crc = pmc_crc32((UINT8*)ddr_training_data,
                                        sizeof(app_fw_ddr_calibration_data_struct) - sizeof(UINT32),
                                        0, TRUE, TRUE);
+
+    commit.magic = APP_FW_DDR_CAL_COMMIT_MAGIC;
+    commit.generation = generation + 1;
+    commit.data_len = sizeof(app_fw_ddr_calibration_data_struct);
+    commit.data_crc = pmc_crc32((UINT8*)ddr_training_data, commit.data_len, 0, TRUE, TRUE);
+    commit.crc = pmc_crc32((UINT8*)&commit, sizeof(commit) - sizeof(UINT32), 0, TRUE, TRUE);
+
+    /* the data is programmed in whole pages, flash ECC does not allow reprogramming */
+    tail_len = commit.data_len % APP_FW_DDR_CAL_PAGE_SIZE;
+    full_len = commit.data_len - tail_len;
     
     /* get SPI flash device info */
     rc = spi_flash_dev_info_get(SPI_FLASH_PORT,
@@ -223,14 +699,32 @@ PUBLIC PMCFW_ERROR app_fw_ddr_calibration_save(app_fw_ddr_calibration_data_struc
     else
     {
         /* save DDR data in SPI flash */
-        rc = spi_flash_write_pages(SPI_FLASH_PORT,
-                                   SPI_FLASH_CS,
-                                   (UINT8*)ddr_training_data,
-                                   (UINT8*)(spi_flash_addr & GPBC_FLASH_PHYS_ADDR_MASK),
-                                   sizeof(app_fw_ddr_calibration_data_struct),
-                                   dev_info.page_size,
-                                   dev_info.max_time_page_prog);
-    
+        if (0 != full_len)
+        {
+            rc = spi_flash_write_pages(SPI_FLASH_PORT,
+                                       SPI_FLASH_CS,
+                                       (UINT8*)ddr_training_data,
+                                       (UINT8*)((spi_flash_addr + APP_FW_DDR_CAL_DATA_OFFSET) & GPBC_FLASH_PHYS_ADDR_MASK),
+                                       full_len,
+                                       dev_info.page_size,
+                                       dev_info.max_time_page_prog);
+        }
+
+        if ((PMC_SUCCESS == rc) && (0 != tail_len))
+        {
+            memset(app_fw_ddr_cal_page_buf, 0xFF, sizeof(app_fw_ddr_cal_page_buf));
+            memcpy(app_fw_ddr_cal_page_buf, (UINT8*)ddr_training_data + full_len, tail_len);
+            rc = app_fw_ddr_cal_page_program(spi_flash_addr + APP_FW_DDR_CAL_DATA_OFFSET + full_len, &dev_info);
+        }
+
+        /* commit the slot */
+        if (PMC_SUCCESS == rc)
+        {
+            memset(app_fw_ddr_cal_page_buf, 0xFF, sizeof(app_fw_ddr_cal_page_buf));
+            memcpy(app_fw_ddr_cal_page_buf, &commit, sizeof(commit));
+            rc = app_fw_ddr_cal_page_program(spi_flash_addr, &dev_info);
+        }
+
         if (PMC_SUCCESS != rc)
         {
             rc = APP_FW_DDR_ERR_TRAINING_WRITE;
@@ -239,6 +733,12 @@ PUBLIC PMCFW_ERROR app_fw_ddr_calibration_save(app_fw_ddr_calibration_data_struc
     
     /* restore interrupts and enable multi-VPE operation */
     top_plat_critical_region_exit(lock_struct);
+
+    if (PMC_SUCCESS == rc)
+    {
+        app_fw_ddr_cal_slot = slot;
+        bc_printf("Saved DDR PHY calibration to slot %u, generation %u\n", slot, commit.generation);
+    }
 #endif
     
     return rc;
@@ -253,16 +753,31 @@ PUBLIC PMCFW_ERROR app_fw_ddr_calibration_save(app_fw_ddr_calibration_data_struc
 * @return
 *   PMC_SUCCESS if successful.
 *
+* @note
+*   The calibration of the newest valid slot is loaded.
 */
 PUBLIC PMCFW_ERROR app_fw_ddr_calibration_load(app_fw_ddr_calibration_data_struct *ddr_training_data)
 {
     PMCFW_ERROR rc             = PMC_SUCCESS;
+#if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
     UINT32      spi_flash_addr = app_fw_ddr_training_data_addr_get();
+    UINT32      generation     = 0;
+#endif
 
     memset(ddr_training_data, 0, sizeof(app_fw_ddr_calibration_data_struct));
 
 #if (APP_FW_DISABLE_DDR_SPI_RELOAD == 0)
 
+    app_fw_ddr_cal_slot = app_fw_ddr_cal_slot_newest(&generation);
+    if (APP_FW_DDR_CAL_SLOT_NONE == app_fw_ddr_cal_slot)
+    {
+        bc_printf("No valid calibration slot in SPI flash\n");
+        return APP_FW_DDR_ERR_CALIBRATION_CRC;
+    }
+
+    bc_printf("Loading DDR PHY calibration from slot %u, generation %u\n", app_fw_ddr_cal_slot, generation);
+    spi_flash_addr += (app_fw_ddr_cal_slot * APP_FW_DDR_CAL_SLOT_SIZE) + APP_FW_DDR_CAL_DATA_OFFSET;
+
     /* disable interrupts and disable multi-VPE operation */
     top_plat_lock_struct lock_struct;
     top_plat_critical_region_enter(&lock_struct);
@@ -287,8 +802,8 @@ PUBLIC PMCFW_ERROR app_fw_ddr_calibration_load(app_fw_ddr_calibration_data_struc
                            sizeof(app_fw_ddr_calibration_data_struct) - sizeof(UINT32),
                            0, TRUE, TRUE);
 
-    if ((ddr_training_data->crc == crc) &&
-        (ddr_training_data->header == APP_FW_DDR_SAVED_DATA_HEADER))
+    if ((ddr_training_data->crc != crc) ||
+        (ddr_training_data->header != APP_FW_DDR_SAVED_DATA_HEADER))
     {
         bc_printf("Calibration data CRC check failed\n");
         return APP_FW_DDR_ERR_CALIBRATION_CRC;
@@ -320,10 +835,22 @@ PUBLIC PMCFW_ERROR app_fw_ddr_calibration_read(UINT32 offset, UINT32 size, VOID
 {
 
     UINT32 rc;
+    UINT32 generation = 0;
 
     UINT32 struct_size = sizeof(app_fw_ddr_calibration_data_struct);
     
     UINT32 spi_flash_addr = app_fw_ddr_training_data_addr_get();    
+
+    /* read from the newest valid slot, slot 0 if none is valid */
+    if (APP_FW_DDR_CAL_SLOT_NONE == app_fw_ddr_cal_slot)
+    {
+        app_fw_ddr_cal_slot = app_fw_ddr_cal_slot_newest(&generation);
+    }
+    if (APP_FW_DDR_CAL_SLOT_NONE != app_fw_ddr_cal_slot)
+    {
+        spi_flash_addr += app_fw_ddr_cal_slot * APP_FW_DDR_CAL_SLOT_SIZE;
+    }
+    spi_flash_addr += APP_FW_DDR_CAL_DATA_OFFSET;
         
     /* Calculate the size of data that can be read */
     if (offset + size > struct_size) 
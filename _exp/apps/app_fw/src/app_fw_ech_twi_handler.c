@@ -103,7 +103,7 @@
 *
 * @note
 */
-PUBLIC VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT8 rx_index)
+PUBLIC VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT32 rx_index)
 {
     switch (rx_buf_ptr[rx_index])
     {
@@ -283,6 +283,30 @@ PUBLIC VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT8 rx_
         }
         break;
 
+        case EXP_FW_READ_CMD_TRACE:
+        {
+            ech_twi_read_cmd_trace(rx_buf_ptr, rx_index, port_id);
+        }
+        break;
+
+        case EXP_FW_READ_CMD_STATS:
+        {
+            ech_twi_read_cmd_stats(rx_buf_ptr, rx_index, port_id);
+        }
+        break;
+
+        case EXP_FW_READ_BOOT_PROFILE:
+        {
+            ech_twi_read_boot_profile(rx_buf_ptr, rx_index, port_id);
+        }
+        break;
+
+        case EXP_FW_READ_TELEMETRY:
+        {
+            ech_twi_read_telemetry(rx_buf_ptr, rx_index, port_id);
+        }
+        break;
+
         case EXP_FW_TWI_FFE_SETTINGS:
         {
             /* 
@@ -312,12 +336,12 @@ PUBLIC VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT8 rx_
 
 
             /* extract the pre and post cursor and record the values */
-            UINT32 precursor = (rx_buf_ptr[rx_index + 2] << 24) |
+            UINT32 precursor = ((UINT32)rx_buf_ptr[rx_index + 2] << 24) |
                                (rx_buf_ptr[rx_index + 3] << 16) |
                                (rx_buf_ptr[rx_index + 4] << 8)  |
                                (rx_buf_ptr[rx_index + 5] << 0);
 
-            UINT32 postcursor = (rx_buf_ptr[rx_index + 6] << 24) |
+            UINT32 postcursor = ((UINT32)rx_buf_ptr[rx_index + 6] << 24) |
                                 (rx_buf_ptr[rx_index + 7] << 16) |
                                 (rx_buf_ptr[rx_index + 8] << 8)  |
                                 (rx_buf_ptr[rx_index + 9] << 0);
@@ -34,6 +34,7 @@
 #include <stdarg.h>
 #include "pmcfw_common.h"
 #include "bc_printf.h"
+#include "bc_log.h"
 #include "crash_dump.h"
 #include "pmc_profile.h"
 #include "cicint.h"
@@ -93,6 +94,15 @@
 #include "ocmb_erep.h"
 #include "wdt.h"
 #include "pvt.h"
+#include "app_fw_sched.h"
+#include "ech_trace.h"
+#include "app_fw_boot_prof.h"
+#include "log_chan.h"
+#include "ddr_phy_dl_update.h"
+#include "ddr_phy_train.h"
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+#include "app_fw_pc_prof.h"
+#endif
 
 #if (EXPLORER_BRINGUP == 1)
 EXTERN void expl_fca_bringup(void);
@@ -103,15 +113,21 @@ EXTERN void expl_fca_bringup(void);
 */
 
 /* Command Server config */
-#define APP_FW_CMDSVR_CMD_LISTS_MAX             10
+#define APP_FW_CMDSVR_CMD_LISTS_MAX             13
 
 /* Circular Character Buffer Count for the system */
-#define APP_FW_CCB_BUFFER_COUNT                 CHAR_IO_NUM_CHANNELS
+#define APP_FW_CCB_BUFFER_COUNT                 (CHAR_IO_NUM_CHANNELS + LOG_CHAN_NUM)
 
 /* Circular buffer sizes for both runtime logging and crash logging. */
 #define APP_FW_CHAR_IO_RUNTIME_CCB_SIZE         APP_FW_LOG_SIZE
 #define APP_FW_CHAR_IO_CRASH_CCB_SIZE           (1*1024)
 
+/* VPE0 main loop task periods and budgets in microseconds, 0 if none */
+#define APP_FW_SCHED_TEMP_SENSOR_BUDGET_US      5000
+#define APP_FW_SCHED_UART_SHELL_PERIOD_US       1000
+#define APP_FW_SCHED_UART_SHELL_BUDGET_US       1000
+#define APP_FW_SCHED_SERDES_CAL_PERIOD_US       (100 * 1000)
+
 /*
 ** Global Variables
 */
@@ -191,6 +207,158 @@ PRIVATE VOID app_fw_ram_code_ptr_adjust(VOID)
 }
 
 
+/**
+* @brief
+*   Check for an OpenCAPI host command. The doorbell is handled by the
+*   OCMB API, so the command received flag is polled. Host commands wait
+*   while EXP_FW_DDR_PHY_INIT trains, its response is still to be sent.
+*
+* @return
+*   TRUE if a host command is waiting
+*
+*/
+PRIVATE BOOL app_fw_host_cmd_poll(VOID)
+{
+    return ((TRUE == app_fw_oc_ready) &&
+            (TRUE == ech_cmd_rxd_flag_get()) &&
+            (FALSE == ddr_phy_train_busy_get()));
+}
+
+/**
+* @brief
+*   OpenCAPI host command task.
+*
+* @return
+*
+*/
+PRIVATE VOID app_fw_host_cmd_task(VOID)
+{
+    (VOID)ech_oc_cmd_proc();
+}
+
+/**
+* @brief
+*   I2C deferred command task, signalled when VPE1 defers a command.
+*
+* @return
+*
+*/
+PRIVATE VOID app_fw_twi_deferred_task(VOID)
+{
+    if (ech_def_handler.deferred_cmd_flag &&
+        (ech_def_handler.cmd_buf != NULL) &&
+        (ech_def_handler.deferred_cmd_handler != NULL) &&
+        (ech_def_handler.callback_handler != NULL))
+    {
+        UINT8 prev_chan = log_chan_enter(log_chan_twi_cmd_chan_get((UINT8)ech_def_handler.command_id));
+
+        ech_trace_deferred_rx((UINT8)ech_def_handler.command_id);
+        ech_trace_dispatch(ECH_TRACE_SRC_TWI);
+        ech_def_handler.callback_handler((*ech_def_handler.deferred_cmd_handler)(ech_def_handler.cmd_buf, ech_def_handler.cmd_buf_idx));
+        ech_trace_return(ECH_TRACE_SRC_TWI);
+        log_chan_exit(prev_chan);
+        ech_def_handler.cmd_buf = NULL;
+        ech_def_handler.deferred_cmd_handler = NULL;
+        ech_def_handler.callback_handler = NULL;
+        ech_def_handler.deferred_cmd_flag = FALSE;
+    }
+}
+
+/**
+* @brief
+*   UART shell task.
+*
+* @return
+*
+*/
+PRIVATE VOID app_fw_uart_shell_task(VOID)
+{
+    tsh_main_loop(APP_FW_TSH_SHELL_IDX, FALSE);
+}
+
+/**
+* @brief
+*   Register the VPE0 main loop tasks. Host commands run first; the
+*   housekeeping tasks only run when nothing of higher priority is ready.
+*
+* @return
+*
+*/
+PRIVATE VOID app_fw_sched_tasks_register(VOID)
+{
+    app_fw_sched_init();
+
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_HOST_CMD,
+                               "host_cmd",
+                               app_fw_host_cmd_task,
+                               app_fw_host_cmd_poll,
+                               APP_FW_SCHED_PRIO_HOST,
+                               0,
+                               0);
+
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_TWI_DEFERRED,
+                               "twi_deferred",
+                               app_fw_twi_deferred_task,
+                               NULL,
+                               APP_FW_SCHED_PRIO_DEFERRED,
+                               0,
+                               0);
+
+    /* signalled by the temperature update timer interrupt */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_TEMP_SENSOR,
+                               "temp_sensor",
+                               temp_sensor_plat_update,
+                               NULL,
+                               APP_FW_SCHED_PRIO_HOUSEKEEPING,
+                               0,
+                               APP_FW_SCHED_TEMP_SENSOR_BUDGET_US);
+
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_UART_SHELL,
+                               "uart_shell",
+                               app_fw_uart_shell_task,
+                               NULL,
+                               APP_FW_SCHED_PRIO_HOUSEKEEPING,
+                               APP_FW_SCHED_UART_SHELL_PERIOD_US,
+                               APP_FW_SCHED_UART_SHELL_BUDGET_US);
+
+    /* serdes_plat_cal_update() keeps its own calibration interval */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_SERDES_CAL,
+                               "serdes_cal",
+                               serdes_plat_cal_update,
+                               NULL,
+                               APP_FW_SCHED_PRIO_BACKGROUND,
+                               APP_FW_SCHED_SERDES_CAL_PERIOD_US,
+                               0);
+
+    /* signalled when the last boot milestone is reached */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_BOOT_PROF,
+                               "boot_prof",
+                               app_fw_boot_prof_save,
+                               NULL,
+                               APP_FW_SCHED_PRIO_BACKGROUND,
+                               0,
+                               0);
+
+    /* signalled after each temperature sensor update */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_DDR_DL_UPDATE,
+                               "ddr_dl_update",
+                               ddr_phy_dl_update_task,
+                               NULL,
+                               APP_FW_SCHED_PRIO_HOUSEKEEPING,
+                               0,
+                               0);
+
+    /* signalled by EXP_FW_DDR_PHY_INIT, runs until the response is sent */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_DDR_TRAIN,
+                               "ddr_train",
+                               ddr_phy_train_task,
+                               NULL,
+                               APP_FW_SCHED_PRIO_BACKGROUND,
+                               0,
+                               0);
+}
+
+
 /*
 ** Public Functions
 */
@@ -236,6 +404,8 @@ void _34K_VPE0_main(void)
     UINT32 app_log_size = 0;
     PMCFW_ERROR rc;
     top_plat_lock_struct lock_struct;
+
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_MAIN);
     
     uart_init(APP_FW_UART_ID,
               APP_FW_UART_BASE_ADDRESS,
@@ -261,9 +431,12 @@ void _34K_VPE0_main(void)
     hal_cp0_timer_init(dcsu_cpu_clk_freq_get);
     hal_cp0_timer_register();
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_MEM_INIT);
+
     /* Initialize circular buffer for string buffers. */
     ccb_init(APP_FW_CCB_BUFFER_COUNT);
     char_io_init(APP_FW_CHAR_IO_RUNTIME_CCB_SIZE, APP_FW_CHAR_IO_CRASH_CCB_SIZE);
+    log_chan_init();
 
     /* initialize bc_printf */
     bc_printf_init(APP_FW_UART_ID);
@@ -280,6 +453,8 @@ void _34K_VPE0_main(void)
     /* initialize crash dump */
     crash_dump_init();
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_CONSOLE_INIT);
+
     bc_printf("Booting APP_FW %s ....\n",
               ((flash_partition_boot_partition_id_get() == 'A') ? "Image A" : "Image B"));
 
@@ -304,6 +479,8 @@ void _34K_VPE0_main(void)
     /* initialize the reset module */
     app_fw_reset_init();
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_LOG_INIT);
+
     /* Initialize the OPSW block - including fatal and non-fatal interrupt enablement. */
     opsw_fatal_init();
 
@@ -311,6 +488,8 @@ void _34K_VPE0_main(void)
     /* The function exp_gic_init() also enables interrupts on the PCSe */
     exp_gic_init();
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_GIC_INIT);
+
     /* halt other core so SPI Flash driver can be initialized */
     top_plat_critical_region_enter(&lock_struct);
 
@@ -328,6 +507,8 @@ void _34K_VPE0_main(void)
     /*Initialize FAM module*/
     fam_plat_init();    
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_SPI_FLASH_INIT);
+
     /* 
     ** check redundant firmware image against active image
     ** and update redundant if it is older than active
@@ -344,6 +525,8 @@ void _34K_VPE0_main(void)
     /* restore interrupts and enable multi-VPE operation */
     top_plat_critical_region_exit(lock_struct);
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_RED_FW_IMAGE_UPDATE);
+
 #if (EXPLORER_BRINGUP == 1)
     expl_fca_bringup();
 #endif
@@ -364,6 +547,9 @@ void _34K_VPE0_main(void)
     */
     log_plat_init();
 
+    /* register the log rate limiter commands */
+    bc_log_init();
+
     /* Tiny Shell */
     tsh_parms_ptr = tsh_parms_get(APP_FW_TSH_SHELL_IDX);
     tsh_parms_ptr->uart_port = APP_FW_UART_ID;
@@ -378,6 +564,17 @@ void _34K_VPE0_main(void)
     /* register DDR CMDSVR commands */
     app_fw_ddr_cmdsvr_init();
 
+    /* register boot profiler CMDSVR commands */
+    app_fw_boot_prof_cmdsvr_register();
+
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+    /* stopped until started with the pc_prof command */
+    app_fw_pc_prof_init();
+    app_fw_pc_prof_cmdsvr_register();
+#endif
+
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_ECH_INIT);
+
     /* initialize the SEEPROM */
     seeprom_init();
     
@@ -404,6 +601,11 @@ void _34K_VPE0_main(void)
     wdt_interval_tmr_init(EXP_INTERVAL_WDT_TIMEOUT_10_SEC);
 #endif
 
+    /* register the main loop tasks before any of them can be signalled */
+    app_fw_sched_tasks_register();
+
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_MODULES_INIT);
+
     /* 
     ** TWI is enabled after all modules but temperature sensor 
     ** module is initialized, which require I2C module to be 
@@ -422,9 +624,13 @@ void _34K_VPE0_main(void)
     */
     start_second_vpe = TRUE;
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_TWI_INIT);
+
     /* Initialize temperature sensor module */
     temp_sensor_plat_init();
 
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_TEMP_SENSOR_INIT);
+
     /* Register TWIM command server */
     twim_cmdsvr_register();
 
@@ -438,6 +644,8 @@ void _34K_VPE0_main(void)
     ** BOOT TIME means: Power-on to first I2C command.
     */
     g_boot_timestamp = hal_cp0_counter_get();
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_MAIN_LOOP);
+    log_chan_boot_done();
 
     bc_printf("[Firmware version] %d_%d_%d_%d \n",FW_VERSION_MAJOR_RELEASE_NUMBER,FW_VERSION_MINOR_RELEASE_NUMBER,FW_VERSION_CL_NUMBER,FW_VERSION_PATCH_RELEASE_NUMBER);
     bc_printf("[Firmware build date] %x \n",FW_VERSION_BUILD_DATE);
@@ -452,33 +660,12 @@ void _34K_VPE0_main(void)
             app_fw_plat_di_enable_set(TRUE);
         }
 
-        /* OpenCapi Command Handler*/
-        if(TRUE == app_fw_oc_ready)
-        {
-            ech_oc_cmd_proc();
-        }
-
-        /* I2C Deferred Command Handler*/
-        if (ech_def_handler.deferred_cmd_flag &&
-            (ech_def_handler.cmd_buf != NULL) &&
-            (ech_def_handler.deferred_cmd_handler != NULL) &&
-            (ech_def_handler.callback_handler != NULL))
-        {
-            ech_def_handler.callback_handler((*ech_def_handler.deferred_cmd_handler)(ech_def_handler.cmd_buf, ech_def_handler.cmd_buf_idx));
-            ech_def_handler.cmd_buf = NULL;
-            ech_def_handler.deferred_cmd_handler = NULL;
-            ech_def_handler.callback_handler = NULL;
-            ech_def_handler.deferred_cmd_flag = FALSE;
-        }
-
-        /* Update temperature sensors */
-        temp_sensor_plat_update();
-
-        /* process the UART interface */
-        tsh_main_loop(APP_FW_TSH_SHELL_IDX, FALSE);
-
-        /* Run periodic serdes calibration if necessary */
-        serdes_plat_cal_update();
+        /*
+        ** Run the highest priority task with work: host commands, I2C
+        ** deferred commands, temperature update, UART shell and periodic
+        ** serdes calibration.
+        */
+        (VOID)app_fw_sched_run();
 
 #if (EXPLORER_WDT_DISABLE == 0)
         /* kick VPE0 watchdog timer */
@@ -0,0 +1,585 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup APP_FW_PC_PROF
+* @{
+* @file
+* @brief
+*   Statistical PC-sampling profiler implementation.
+*
+* @note
+*   The samples and the statistics are only written by the sample handler
+*   on VPE0 and read by VPE0 tasks with interrupts disabled, so they take
+*   no lock.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include "pmc_profile.h"
+
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+
+#include "pmcfw_common.h"
+#include "cpuhal.h"
+#include "cpuhal_api.h"
+#include "cicint_api.h"
+#include "bc_printf.h"
+#include "sys_timer_api.h"
+#include "cmdsvr_plat_cfg.h"
+#include "app_fw_pc_prof.h"
+
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_func_api.h"
+#endif
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Constants
+*/
+
+#define PMC_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/* CP0 Exception Program Counter */
+#define APP_FW_PC_PROF_CP0_EPC          14
+
+/* Physical address of a KSEG0 or KSEG1 address */
+#define APP_FW_PC_PROF_PHY_MASK         0x1FFFFFFF
+
+/* Number of hottest buckets printed by pc_prof show */
+#define APP_FW_PC_PROF_SHOW_TOP         10
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Local Variables
+*/
+
+/* Default histogram range, the code executed from the SPI flash */
+EXTERN UINT8 __ghsbegin_text[];
+EXTERN UINT8 __ghsend_text_fastmem[];
+
+/* Ring of PCs or histogram buckets */
+PRIVATE UINT32 app_fw_pc_prof_buf[APP_FW_PC_PROF_NUM_ENTRIES];
+
+/* Configuration, fixed while sampling */
+PRIVATE volatile BOOL app_fw_pc_prof_running;
+PRIVATE app_fw_pc_prof_mode_enum app_fw_pc_prof_mode;
+PRIVATE UINT32 app_fw_pc_prof_period_us;
+PRIVATE UINT32 app_fw_pc_prof_period_ticks;
+PRIVATE UINT32 app_fw_pc_prof_range_start;
+PRIVATE UINT32 app_fw_pc_prof_range_end;
+PRIVATE UINT32 app_fw_pc_prof_bucket_shift;
+
+/* Next Compare match */
+PRIVATE UINT32 app_fw_pc_prof_compare;
+
+/* Statistics, CP0 Count ticks */
+PRIVATE UINT32 app_fw_pc_prof_num_samples;
+PRIVATE UINT32 app_fw_pc_prof_outside;
+PRIVATE UINT32 app_fw_pc_prof_isr_ticks_max;
+PRIVATE UINT64 app_fw_pc_prof_isr_ticks_total;
+PRIVATE UINT32 app_fw_pc_prof_latency_ticks_max;
+
+/*
+* Forward References
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR app_fw_pc_prof_cmd(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the PC profiler */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct app_fw_pc_prof_cmd_set[] = {
+    {
+        "pc_prof",
+        "Start, stop or show the PC-sampling profiler",
+        app_fw_pc_prof_cmd,
+        "Cmd Usage: pc_prof start [ring|hist] [period_us] [start_addr end_addr]\n"
+        "           pc_prof stop\n"
+        "           pc_prof show\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   CP0 Count/Compare handler. Records the interrupted PC and sets the next
+*   Compare match, which clears the interrupt.
+*
+* @param[in] cback_arg - unused
+*
+* @return
+*   None
+*
+* @note
+*   If the handler ran more than a period late the missed samples are
+*   dropped rather than taken back to back, so the overhead stays bounded.
+*/
+PRIVATE void app_fw_pc_prof_isr(void *cback_arg)
+{
+    UINT32 start = hal_cp0_counter_get();
+    UINT32 epc = hal_coprocessor_read(APP_FW_PC_PROF_CP0_EPC, 0);
+    UINT32 latency = start - app_fw_pc_prof_compare;
+    UINT32 offset;
+    UINT32 ticks;
+
+    app_fw_pc_prof_compare += app_fw_pc_prof_period_ticks;
+    if ((app_fw_pc_prof_compare - start) > app_fw_pc_prof_period_ticks)
+    {
+        app_fw_pc_prof_compare = start + app_fw_pc_prof_period_ticks;
+    }
+    hal_cp0_compare_set(app_fw_pc_prof_compare);
+
+    if (FALSE == app_fw_pc_prof_running)
+    {
+        return;
+    }
+
+    if (APP_FW_PC_PROF_MODE_RING == app_fw_pc_prof_mode)
+    {
+        app_fw_pc_prof_buf[app_fw_pc_prof_num_samples & (APP_FW_PC_PROF_NUM_ENTRIES - 1)] = epc;
+    }
+    else
+    {
+        offset = (epc & APP_FW_PC_PROF_PHY_MASK) - app_fw_pc_prof_range_start;
+        if (offset < (app_fw_pc_prof_range_end - app_fw_pc_prof_range_start))
+        {
+            app_fw_pc_prof_buf[offset >> app_fw_pc_prof_bucket_shift]++;
+        }
+        else
+        {
+            app_fw_pc_prof_outside++;
+        }
+    }
+    app_fw_pc_prof_num_samples++;
+
+    if (latency > app_fw_pc_prof_latency_ticks_max)
+    {
+        app_fw_pc_prof_latency_ticks_max = latency;
+    }
+
+    ticks = hal_cp0_counter_get() - start;
+    app_fw_pc_prof_isr_ticks_total += ticks;
+    if (ticks > app_fw_pc_prof_isr_ticks_max)
+    {
+        app_fw_pc_prof_isr_ticks_max = ticks;
+    }
+}
+
+/**
+* @brief
+*   Fill the profile header. Called with interrupts disabled.
+*
+* @param[out] hdr_ptr - header
+*
+* @return
+*   None
+*/
+PRIVATE VOID app_fw_pc_prof_hdr_get(app_fw_pc_prof_hdr_struct *hdr_ptr)
+{
+    memset(hdr_ptr, 0, sizeof(*hdr_ptr));
+    hdr_ptr->magic = APP_FW_PC_PROF_MAGIC;
+    hdr_ptr->version = APP_FW_PC_PROF_VERSION;
+    hdr_ptr->mode = (UINT8)app_fw_pc_prof_mode;
+    hdr_ptr->bucket_shift = (UINT8)app_fw_pc_prof_bucket_shift;
+    hdr_ptr->period_us = app_fw_pc_prof_period_us;
+    hdr_ptr->ticks_per_ms = sys_timer_us_to_count(1000);
+    hdr_ptr->num_samples = app_fw_pc_prof_num_samples;
+    hdr_ptr->range_start = app_fw_pc_prof_range_start;
+    hdr_ptr->range_end = app_fw_pc_prof_range_end;
+    hdr_ptr->outside = app_fw_pc_prof_outside;
+    hdr_ptr->isr_ticks_max = app_fw_pc_prof_isr_ticks_max;
+    hdr_ptr->latency_ticks_max = app_fw_pc_prof_latency_ticks_max;
+
+    if (TRUE == app_fw_pc_prof_running)
+    {
+        hdr_ptr->flags |= APP_FW_PC_PROF_FLAG_RUNNING;
+    }
+
+    if (APP_FW_PC_PROF_MODE_RING == app_fw_pc_prof_mode)
+    {
+        hdr_ptr->num_entries = app_fw_pc_prof_num_samples;
+        if (app_fw_pc_prof_num_samples > APP_FW_PC_PROF_NUM_ENTRIES)
+        {
+            hdr_ptr->num_entries = APP_FW_PC_PROF_NUM_ENTRIES;
+            hdr_ptr->flags |= APP_FW_PC_PROF_FLAG_WRAPPED;
+        }
+    }
+    else
+    {
+        hdr_ptr->num_entries = ((app_fw_pc_prof_range_end - app_fw_pc_prof_range_start) +
+                                (1 << app_fw_pc_prof_bucket_shift) - 1) >> app_fw_pc_prof_bucket_shift;
+    }
+
+    if (0 != app_fw_pc_prof_num_samples)
+    {
+        hdr_ptr->isr_ticks_avg = (UINT32)(app_fw_pc_prof_isr_ticks_total / app_fw_pc_prof_num_samples);
+    }
+    if (0 != app_fw_pc_prof_period_ticks)
+    {
+        hdr_ptr->overhead_ppm = (UINT32)(((UINT64)hdr_ptr->isr_ticks_avg * 1000000) / app_fw_pc_prof_period_ticks);
+    }
+}
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/**
+* @brief
+*   Command server handler to control the profiler.
+*
+* @param[in] args     - command arguments
+* @param[in] num_args - number of arguments
+*
+* @return
+*   PMC_SUCCESS or an error code
+*/
+PRIVATE PMCFW_ERROR app_fw_pc_prof_cmd(CHAR **args, UINT8 num_args)
+{
+    app_fw_pc_prof_mode_enum mode = APP_FW_PC_PROF_MODE_RING;
+    UINT32 period_us = APP_FW_PC_PROF_PERIOD_US_DEFAULT;
+    UINT32 range_start = 0;
+    UINT32 range_end = 0;
+    PMCFW_ERROR rc;
+
+    if (num_args < 2)
+    {
+        return PMCFW_ERR_INVALID_PARAMETERS;
+    }
+
+    if (0 == strcmp(args[1], "start"))
+    {
+        if ((num_args > 2) && (0 == strcmp(args[2], "hist")))
+        {
+            mode = APP_FW_PC_PROF_MODE_HIST;
+        }
+        if (num_args > 3)
+        {
+            period_us = (UINT32)strtoul(args[3], NULL, 0);
+        }
+        if (num_args > 5)
+        {
+            range_start = (UINT32)strtoul(args[4], NULL, 0);
+            range_end = (UINT32)strtoul(args[5], NULL, 0);
+        }
+
+        rc = app_fw_pc_prof_start(mode, period_us, range_start, range_end);
+        if (PMC_SUCCESS != rc)
+        {
+            bc_printf("pc_prof start failed rc = 0x%08x\n", rc);
+        }
+        return rc;
+    }
+    else if (0 == strcmp(args[1], "stop"))
+    {
+        app_fw_pc_prof_stop();
+    }
+    else if (0 == strcmp(args[1], "show"))
+    {
+        app_fw_pc_prof_print();
+    }
+    else
+    {
+        return PMCFW_ERR_INVALID_PARAMETERS;
+    }
+
+    return PMC_SUCCESS;
+}
+#endif
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize the profiler. Must be called after the interrupt controller
+*   is initialized. The profiler is stopped.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_pc_prof_init(VOID)
+{
+    app_fw_pc_prof_running = FALSE;
+    app_fw_pc_prof_mode = APP_FW_PC_PROF_MODE_RING;
+
+    cicint_local_int_disable(HAL_GIC_INT_DEST_VPE_0, HAL_GIC_LOCAL_INT_CMP);
+    cicint_local_int_register(HAL_GIC_INT_DEST_VPE_0, HAL_GIC_LOCAL_INT_CMP, app_fw_pc_prof_isr, NULL);
+}
+
+/**
+* @brief
+*   Clear the profile and start sampling.
+*
+* @param[in] mode        - ring of PCs or histogram
+* @param[in] period_us   - sampling period, at least APP_FW_PC_PROF_PERIOD_US_MIN
+* @param[in] range_start - histogram: first address, 0 for the default range
+* @param[in] range_end   - histogram: end address, exclusive
+*
+* @return
+*   PMC_SUCCESS, APP_FW_PC_PROF_ERR_RUNNING or APP_FW_PC_PROF_ERR_BAD_PARAM
+*
+* @note
+*   The histogram buckets are the smallest power of 2, at least
+*   1 << APP_FW_PC_PROF_BUCKET_SHIFT_MIN bytes, that covers the range with
+*   APP_FW_PC_PROF_NUM_ENTRIES buckets. KSEG0 and KSEG1 addresses of the
+*   same code fall in the same bucket.
+*/
+PUBLIC PMCFW_ERROR app_fw_pc_prof_start(app_fw_pc_prof_mode_enum mode,
+                                        UINT32 period_us,
+                                        UINT32 range_start,
+                                        UINT32 range_end)
+{
+    UINT32 shift = APP_FW_PC_PROF_BUCKET_SHIFT_MIN;
+    UINT32 ie;
+
+    if (TRUE == app_fw_pc_prof_running)
+    {
+        return APP_FW_PC_PROF_ERR_RUNNING;
+    }
+
+    if (0 == range_start)
+    {
+        range_start = (UINT32)__ghsbegin_text;
+        range_end = (UINT32)__ghsend_text_fastmem;
+    }
+    range_start &= APP_FW_PC_PROF_PHY_MASK;
+    range_end &= APP_FW_PC_PROF_PHY_MASK;
+
+    if ((mode >= APP_FW_PC_PROF_MODE_MAX) ||
+        (period_us < APP_FW_PC_PROF_PERIOD_US_MIN) ||
+        (range_end <= range_start))
+    {
+        return APP_FW_PC_PROF_ERR_BAD_PARAM;
+    }
+
+    while (((range_end - range_start - 1) >> shift) >= APP_FW_PC_PROF_NUM_ENTRIES)
+    {
+        shift++;
+    }
+
+    memset(app_fw_pc_prof_buf, 0, sizeof(app_fw_pc_prof_buf));
+    app_fw_pc_prof_mode = mode;
+    app_fw_pc_prof_period_us = period_us;
+    app_fw_pc_prof_period_ticks = sys_timer_us_to_count(period_us);
+    app_fw_pc_prof_range_start = range_start;
+    app_fw_pc_prof_range_end = range_end;
+    app_fw_pc_prof_bucket_shift = shift;
+    app_fw_pc_prof_num_samples = 0;
+    app_fw_pc_prof_outside = 0;
+    app_fw_pc_prof_isr_ticks_max = 0;
+    app_fw_pc_prof_isr_ticks_total = 0;
+    app_fw_pc_prof_latency_ticks_max = 0;
+
+    /* writing Compare clears a match left pending by the last run */
+    ie = hal_int_global_disable();
+    app_fw_pc_prof_compare = hal_cp0_counter_get() + app_fw_pc_prof_period_ticks;
+    hal_cp0_compare_set(app_fw_pc_prof_compare);
+    app_fw_pc_prof_running = TRUE;
+    cicint_local_int_enable(HAL_GIC_INT_DEST_VPE_0, HAL_GIC_LOCAL_INT_CMP);
+    hal_int_global_restore(ie);
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Stop sampling. The profile is kept until the profiler is started again.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_pc_prof_stop(VOID)
+{
+    UINT32 ie;
+
+    ie = hal_int_global_disable();
+    cicint_local_int_disable(HAL_GIC_INT_DEST_VPE_0, HAL_GIC_LOCAL_INT_CMP);
+    app_fw_pc_prof_running = FALSE;
+    hal_int_global_restore(ie);
+}
+
+/**
+* @brief
+*   Read the profile image: an app_fw_pc_prof_hdr_struct followed by the
+*   PCs, oldest first, or the bucket counts. Must be called on VPE0.
+*
+* @param[out] buf_ptr - buffer
+* @param[in]  len     - buffer size in bytes
+*
+* @return
+*   Number of bytes written, 0 if the buffer can not hold the header
+*
+* @note
+*   The image is copied with interrupts disabled so it is consistent while
+*   sampling; at most APP_FW_PC_PROF_NUM_ENTRIES words are copied.
+*/
+PUBLIC UINT32 app_fw_pc_prof_read(UINT8 *buf_ptr, UINT32 len)
+{
+    app_fw_pc_prof_hdr_struct *hdr_ptr = (app_fw_pc_prof_hdr_struct *)buf_ptr;
+    UINT32 *entry_ptr = (UINT32 *)(buf_ptr + sizeof(*hdr_ptr));
+    UINT32 first;
+    UINT32 num;
+    UINT32 i;
+    UINT32 ie;
+
+    if (len < sizeof(*hdr_ptr))
+    {
+        return 0;
+    }
+
+    ie = hal_int_global_disable();
+    app_fw_pc_prof_hdr_get(hdr_ptr);
+
+    num = hdr_ptr->num_entries;
+    if (num > ((len - sizeof(*hdr_ptr)) / sizeof(UINT32)))
+    {
+        num = (len - sizeof(*hdr_ptr)) / sizeof(UINT32);
+        hdr_ptr->num_entries = num;
+    }
+
+    if (APP_FW_PC_PROF_MODE_RING == app_fw_pc_prof_mode)
+    {
+        /* newest entries, oldest first */
+        first = app_fw_pc_prof_num_samples - num;
+        for (i = 0; i < num; i++)
+        {
+            entry_ptr[i] = app_fw_pc_prof_buf[(first + i) & (APP_FW_PC_PROF_NUM_ENTRIES - 1)];
+        }
+    }
+    else
+    {
+        memcpy(entry_ptr, app_fw_pc_prof_buf, num * sizeof(UINT32));
+    }
+    hal_int_global_restore(ie);
+
+    return (sizeof(*hdr_ptr) + (num * sizeof(UINT32)));
+}
+
+/**
+* @brief
+*   Print the profiler state, the sampling overhead and, for a histogram,
+*   the hottest buckets.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_pc_prof_print(VOID)
+{
+    app_fw_pc_prof_hdr_struct hdr;
+    UINT32 printed[APP_FW_PC_PROF_SHOW_TOP];
+    UINT32 num_printed;
+    UINT32 best;
+    UINT32 i;
+    UINT32 j;
+    UINT32 ie;
+
+    ie = hal_int_global_disable();
+    app_fw_pc_prof_hdr_get(&hdr);
+    hal_int_global_restore(ie);
+
+    bc_printf("pc_prof: %s, mode %s, period %d us, %d samples\n",
+              (0 != (hdr.flags & APP_FW_PC_PROF_FLAG_RUNNING)) ? "running" : "stopped",
+              (APP_FW_PC_PROF_MODE_RING == hdr.mode) ? "ring" : "hist",
+              hdr.period_us,
+              hdr.num_samples);
+    bc_printf("isr ticks avg %d max %d, latency ticks max %d, overhead %d ppm\n",
+              hdr.isr_ticks_avg,
+              hdr.isr_ticks_max,
+              hdr.latency_ticks_max,
+              hdr.overhead_ppm);
+
+    if (APP_FW_PC_PROF_MODE_HIST != hdr.mode)
+    {
+        return;
+    }
+
+    bc_printf("range 0x%08x-0x%08x, bucket %d bytes, %d outside\n",
+              hdr.range_start,
+              hdr.range_end,
+              1 << hdr.bucket_shift,
+              hdr.outside);
+
+    /* the buckets only grow, a bucket incremented during the scan is still ordered reasonably */
+    for (num_printed = 0; num_printed < APP_FW_PC_PROF_SHOW_TOP; num_printed++)
+    {
+        best = hdr.num_entries;
+        for (i = 0; i < hdr.num_entries; i++)
+        {
+            for (j = 0; j < num_printed; j++)
+            {
+                if (printed[j] == i)
+                {
+                    break;
+                }
+            }
+            if ((j == num_printed) &&
+                ((hdr.num_entries == best) || (app_fw_pc_prof_buf[i] > app_fw_pc_prof_buf[best])))
+            {
+                best = i;
+            }
+        }
+        if ((hdr.num_entries == best) || (0 == app_fw_pc_prof_buf[best]))
+        {
+            break;
+        }
+        printed[num_printed] = best;
+        bc_printf("  0x%08x %10d\n",
+                  hdr.range_start + (best << hdr.bucket_shift),
+                  app_fw_pc_prof_buf[best]);
+    }
+}
+
+/**
+* @brief
+*   Register the PC profiler command server commands.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_pc_prof_cmdsvr_register(VOID)
+{
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+
+    rv = cmdsvr_func_list_register(app_fw_pc_prof_cmd_set, PMC_ARRAY_SIZE(app_fw_pc_prof_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
+}
+
+#endif /* EXPLORER_PC_PROFILER_ENABLE */
+
+/* End of File */
+
+/** @} end addtogroup */
+
@@ -44,6 +44,7 @@
 #include "ccb_plat.h"
 #include "ocmb_erep.h"
 #include "top_plat.h"
+#include "log_chan.h"
 
 /*
 * Local Constants
@@ -81,6 +82,9 @@ PRIVATE void app_fw_assert_cb(void* error_code)
 {
     ocmb_erep_ext_err_struct ocmb_assert_info;
 
+    /* keep the assert report in the fatal log channel */
+    (VOID)log_chan_enter(LOG_CHAN_FATAL);
+
     /*
     ** Fill in the extended error information.
     */
@@ -293,6 +297,7 @@ PUBLIC void app_fw_reset_init()
     reset_assertion_cback_register(app_fw_assert_cb);
 
     crash_dump_register(CRASH_DUMP_SET_0, "RESET_INFO", &reset_info_print, CRASH_DUMP_ASCII, APP_FW_RESET_INFO_CRASH_SIZE);
+    log_chan_crash_dump_register();
     crash_dump_register(CRASH_DUMP_SET_0, "CCB", &ccb_plat_runtime_crash_dump, CRASH_DUMP_ASCII, APP_FW_RUNTIME_CCB_CRASH_SIZE);
 }
 
@@ -0,0 +1,447 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup APP_FW_SCHED
+* @{
+* @file
+* @brief
+*   Cooperative scheduler for the VPE0 main loop.
+*
+* @note
+*   Run times are measured with the system timer, which counts CP0 Count
+*   ticks. Time a task spends in higher priority tasks run from its yield
+*   points is not charged to its budget.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "bc_printf.h"
+#include "sys_timer_api.h"
+#include "cmdsvr_plat_cfg.h"
+#include "app_fw_sched.h"
+
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_func_api.h"
+#endif
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Constants
+*/
+
+/* Priority of the main loop, below all tasks */
+#define APP_FW_SCHED_PRIO_IDLE      0xFFFFFFFF
+
+/*
+* Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Task control block.
+*/
+typedef struct
+{
+    CHAR *name;                                 /**< Task name, NULL if not registered */
+    app_fw_sched_task_fn_ptr_type task_fn_ptr;  /**< Task body */
+    app_fw_sched_poll_fn_ptr_type poll_fn_ptr;  /**< Poll function, NULL if none */
+    UINT32 priority;                            /**< Lower values run first */
+    UINT_TIME period;                           /**< Period in timer ticks, 0 if not periodic */
+    UINT_TIME budget;                           /**< Budget in timer ticks, 0 if none */
+    volatile BOOL ready;                        /**< Signalled, cleared before the task runs */
+    BOOL running;                               /**< Task is running or preempted */
+    BOOL held;                                  /**< Task is not to run until released */
+    UINT_TIME last_start;                       /**< Time of the last run */
+    UINT32 run_count;                           /**< Number of runs */
+    UINT32 overrun_count;                       /**< Runs that exceeded the budget */
+    UINT_TIME max_ticks;                        /**< Longest run */
+} app_fw_sched_tcb_struct;
+
+/*
+* Local Variables
+*/
+
+PRIVATE app_fw_sched_tcb_struct app_fw_sched_tcb[APP_FW_SCHED_TASK_MAX];
+
+/* Registered tasks in priority order */
+PRIVATE UINT8 app_fw_sched_order[APP_FW_SCHED_TASK_MAX];
+PRIVATE UINT32 app_fw_sched_num_tasks;
+
+/* Priority of the task running, APP_FW_SCHED_PRIO_IDLE if none */
+PRIVATE UINT32 app_fw_sched_cur_priority = APP_FW_SCHED_PRIO_IDLE;
+
+/* Ticks spent in tasks run from yield points of the running task */
+PRIVATE UINT_TIME app_fw_sched_preempt_ticks;
+
+/*
+* Forward References
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR app_fw_sched_cmd_stat(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the scheduler */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct app_fw_sched_cmd_set[] = {
+    {
+        "sched_stat",
+        "Show VPE0 main loop task statistics",
+        app_fw_sched_cmd_stat,
+        "Cmd Usage: sched_stat\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Check if a task has work and claim it.
+*
+* @param[in] tcb_ptr - task control block
+* @param[in] now     - current time
+*
+* @return
+*   TRUE if the task should run
+*/
+PRIVATE BOOL app_fw_sched_task_claim(app_fw_sched_tcb_struct *tcb_ptr, UINT_TIME now)
+{
+    if (TRUE == tcb_ptr->running)
+    {
+        /* preempted further down the call stack */
+        return (FALSE);
+    }
+
+    if (TRUE == tcb_ptr->held)
+    {
+        /* the signal is kept for when the task is released */
+        return (FALSE);
+    }
+
+    if (TRUE == tcb_ptr->ready)
+    {
+        /* clear before running so a signal raised while running is kept */
+        tcb_ptr->ready = FALSE;
+        return (TRUE);
+    }
+
+    if ((NULL != tcb_ptr->poll_fn_ptr) && (TRUE == tcb_ptr->poll_fn_ptr()))
+    {
+        return (TRUE);
+    }
+
+    if ((0 != tcb_ptr->period) && (sys_timer_diff(tcb_ptr->last_start, now) >= tcb_ptr->period))
+    {
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+/**
+* @brief
+*   Run a task and account for its run time.
+*
+* @param[in] tcb_ptr - task control block
+* @param[in] start   - time the task is started
+*
+* @return
+*   None
+*/
+PRIVATE VOID app_fw_sched_task_exec(app_fw_sched_tcb_struct *tcb_ptr, UINT_TIME start)
+{
+    UINT32 saved_priority = app_fw_sched_cur_priority;
+    UINT_TIME saved_preempt = app_fw_sched_preempt_ticks;
+    UINT_TIME elapsed;
+    UINT_TIME own;
+
+    tcb_ptr->running = TRUE;
+    tcb_ptr->last_start = start;
+    app_fw_sched_cur_priority = tcb_ptr->priority;
+    app_fw_sched_preempt_ticks = 0;
+
+    tcb_ptr->task_fn_ptr();
+
+    elapsed = sys_timer_diff(start, sys_timer_read());
+    own = elapsed - app_fw_sched_preempt_ticks;
+
+    tcb_ptr->running = FALSE;
+    tcb_ptr->run_count++;
+    if (own > tcb_ptr->max_ticks)
+    {
+        tcb_ptr->max_ticks = own;
+    }
+    if ((0 != tcb_ptr->budget) && (own > tcb_ptr->budget))
+    {
+        tcb_ptr->overrun_count++;
+    }
+
+    /* the whole run is preemption time for the task below */
+    app_fw_sched_cur_priority = saved_priority;
+    app_fw_sched_preempt_ticks = saved_preempt + elapsed;
+}
+
+/**
+* @brief
+*   Run the first ready task with a priority above a limit.
+*
+* @param[in] priority - tasks must have a lower priority value to run
+*
+* @return
+*   TRUE if a task was run
+*/
+PRIVATE BOOL app_fw_sched_dispatch(UINT32 priority)
+{
+    app_fw_sched_tcb_struct *tcb_ptr;
+    UINT_TIME now = sys_timer_read();
+    UINT32 i;
+
+    for (i = 0; i < app_fw_sched_num_tasks; i++)
+    {
+        tcb_ptr = &app_fw_sched_tcb[app_fw_sched_order[i]];
+
+        if (tcb_ptr->priority >= priority)
+        {
+            break;
+        }
+
+        if (TRUE == app_fw_sched_task_claim(tcb_ptr, now))
+        {
+            app_fw_sched_task_exec(tcb_ptr, now);
+            return (TRUE);
+        }
+    }
+
+    return (FALSE);
+}
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/**
+* @brief
+*   Show the task statistics.
+*
+* @return
+*   PMC_SUCCESS
+*/
+PRIVATE PMCFW_ERROR app_fw_sched_cmd_stat(CHAR **args, UINT8 num_args)
+{
+    app_fw_sched_stats_print();
+
+    return PMC_SUCCESS;
+}
+#endif
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize the scheduler. Tasks are registered afterwards.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_sched_init(VOID)
+{
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+#endif
+
+    memset(app_fw_sched_tcb, 0, sizeof(app_fw_sched_tcb));
+    app_fw_sched_num_tasks = 0;
+    app_fw_sched_cur_priority = APP_FW_SCHED_PRIO_IDLE;
+    app_fw_sched_preempt_ticks = 0;
+
+#if (CMDSVR_REG_COMMANDS == 1)
+    rv = cmdsvr_func_list_register(app_fw_sched_cmd_set, PMC_ARRAY_SIZE(app_fw_sched_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
+}
+
+/**
+* @brief
+*   Register a task.
+*
+* @param[in] task_id     - task
+* @param[in] name        - task name
+* @param[in] task_fn_ptr - task body
+* @param[in] poll_fn_ptr - poll function, NULL if the task is only
+*                          signalled or periodic
+* @param[in] priority    - lower values run first, tasks of equal priority
+*                          run in registration order
+* @param[in] period_us   - period, 0 if the task is not periodic
+* @param[in] budget_us   - expected longest run, 0 if none. Runs exceeding
+*                          it are counted as overruns.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_sched_task_register(app_fw_sched_task_enum task_id,
+                                       CHAR *name,
+                                       app_fw_sched_task_fn_ptr_type task_fn_ptr,
+                                       app_fw_sched_poll_fn_ptr_type poll_fn_ptr,
+                                       UINT32 priority,
+                                       UINT32 period_us,
+                                       UINT32 budget_us)
+{
+    app_fw_sched_tcb_struct *tcb_ptr;
+    UINT32 i;
+
+    PMCFW_ASSERT((task_id < APP_FW_SCHED_TASK_MAX) &&
+                 (NULL != task_fn_ptr) &&
+                 (priority < APP_FW_SCHED_PRIO_IDLE),
+                 APP_FW_SCHED_ERR_BAD_PARAM);
+
+    tcb_ptr = &app_fw_sched_tcb[task_id];
+    PMCFW_ASSERT(NULL == tcb_ptr->name, APP_FW_SCHED_ERR_BAD_PARAM);
+
+    tcb_ptr->name = name;
+    tcb_ptr->task_fn_ptr = task_fn_ptr;
+    tcb_ptr->poll_fn_ptr = poll_fn_ptr;
+    tcb_ptr->priority = priority;
+    tcb_ptr->period = (0 == period_us) ? 0 : sys_timer_us_to_count(period_us);
+    tcb_ptr->budget = (0 == budget_us) ? 0 : sys_timer_us_to_count(budget_us);
+    tcb_ptr->last_start = sys_timer_read();
+
+    /* insert behind the tasks of the same or higher priority */
+    i = app_fw_sched_num_tasks;
+    while ((i > 0) && (app_fw_sched_tcb[app_fw_sched_order[i - 1]].priority > priority))
+    {
+        app_fw_sched_order[i] = app_fw_sched_order[i - 1];
+        i--;
+    }
+    app_fw_sched_order[i] = (UINT8)task_id;
+    app_fw_sched_num_tasks++;
+}
+
+/**
+* @brief
+*   Mark a task ready to run. May be called from an ISR or from another VPE.
+*
+* @param[in] task_id - task
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_sched_task_ready(app_fw_sched_task_enum task_id)
+{
+    if (task_id < APP_FW_SCHED_TASK_MAX)
+    {
+        app_fw_sched_tcb[task_id].ready = TRUE;
+    }
+}
+
+/**
+* @brief
+*   Hold a task, or release it. A held task does not run until it is
+*   released, its signals are kept.
+*
+* @param[in] task_id - task
+* @param[in] hold    - TRUE to hold the task, FALSE to release it
+*
+* @return
+*   None
+*
+* @note
+*   VPE0 only. Holding the task that is running does not stop it.
+*/
+PUBLIC VOID app_fw_sched_task_hold(app_fw_sched_task_enum task_id, BOOL hold)
+{
+    if (task_id < APP_FW_SCHED_TASK_MAX)
+    {
+        app_fw_sched_tcb[task_id].held = hold;
+    }
+}
+
+/**
+* @brief
+*   Run the highest priority task that has work. Called from the VPE0 main
+*   loop.
+*
+* @return
+*   TRUE if a task was run
+*/
+PUBLIC BOOL app_fw_sched_run(VOID)
+{
+    return (app_fw_sched_dispatch(APP_FW_SCHED_PRIO_IDLE));
+}
+
+/**
+* @brief
+*   Yield point for a long running task. Runs the tasks of higher priority
+*   than the calling task that have work, then returns to the caller.
+*
+* @return
+*   None
+*
+* @note
+*   Only call where the calling task can tolerate the higher priority tasks
+*   running, e.g. between two TWI transactions.
+*/
+PUBLIC VOID app_fw_sched_yield(VOID)
+{
+    while (TRUE == app_fw_sched_dispatch(app_fw_sched_cur_priority))
+    {
+        /* run until no higher priority task has work */
+    }
+}
+
+/**
+* @brief
+*   Print the task statistics. Times are in microseconds.
+*
+* @return
+*   None
+*/
+PUBLIC VOID app_fw_sched_stats_print(VOID)
+{
+    app_fw_sched_tcb_struct *tcb_ptr;
+    UINT32 i;
+
+    bc_printf("%-16s %4s %10s %10s %10s %10s\n", "task", "prio", "runs", "max_us", "budget_us", "overruns");
+
+    for (i = 0; i < app_fw_sched_num_tasks; i++)
+    {
+        tcb_ptr = &app_fw_sched_tcb[app_fw_sched_order[i]];
+        bc_printf("%-16s %4d %10d %10d %10d %10d\n",
+                  tcb_ptr->name,
+                  tcb_ptr->priority,
+                  tcb_ptr->run_count,
+                  sys_timer_count_to_us(tcb_ptr->max_ticks),
+                  sys_timer_count_to_us(tcb_ptr->budget),
+                  tcb_ptr->overrun_count);
+    }
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
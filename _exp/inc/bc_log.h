@@ -0,0 +1,148 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup BC_LOG
+* @{
+* @file
+* @brief
+*    Leveled and rate limited bc_printf() logging.
+*
+* @note
+*    Messages logged with BC_LOG_ERR/WARN/INFO/DEBUG() below BC_LOG_LEVEL
+*    are compiled out: their format string is not in the image and their
+*    arguments are not evaluated. BC_LOG_LEVEL defaults to
+*    EXPLORER_LOG_LEVEL and may be defined by a file before including this
+*    header.
+*
+*    BC_LOG_RL() limits one call site to burst messages, refilled at burst
+*    messages per period_s seconds, with a token bucket held in static
+*    state at the call site. The messages dropped are counted and reported
+*    in a "(N messages suppressed)" line before the next message of the
+*    call site is logged. Call sites are meant for one VPE, a call site
+*    shared by both VPEs may be off by a message.
+*
+*    The rate limiter counts the messages and estimates the log bytes
+*    dropped since boot, from the length of the last message logged by
+*    each call site. They are shown by the "log_rl" command.
+*/
+
+#ifndef _BC_LOG_H
+#define _BC_LOG_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmc_profile.h"
+#include "bc_printf.h"
+
+/*
+** Constants
+*/
+
+/* Log levels */
+#define BC_LOG_LEVEL_NONE       0
+#define BC_LOG_LEVEL_ERR        1
+#define BC_LOG_LEVEL_WARN       2
+#define BC_LOG_LEVEL_INFO       3
+#define BC_LOG_LEVEL_DEBUG      4
+
+#ifndef BC_LOG_LEVEL
+#define BC_LOG_LEVEL            EXPLORER_LOG_LEVEL
+#endif
+
+/*
+** Macro Definitions
+*/
+
+#if (BC_LOG_LEVEL >= BC_LOG_LEVEL_ERR)
+#define BC_LOG_ERR(...)         ((VOID)bc_printf(__VA_ARGS__))
+#else
+#define BC_LOG_ERR(...)         ((VOID)0)
+#endif
+
+#if (BC_LOG_LEVEL >= BC_LOG_LEVEL_WARN)
+#define BC_LOG_WARN(...)        ((VOID)bc_printf(__VA_ARGS__))
+#else
+#define BC_LOG_WARN(...)        ((VOID)0)
+#endif
+
+#if (BC_LOG_LEVEL >= BC_LOG_LEVEL_INFO)
+#define BC_LOG_INFO(...)        ((VOID)bc_printf(__VA_ARGS__))
+#else
+#define BC_LOG_INFO(...)        ((VOID)0)
+#endif
+
+#if (BC_LOG_LEVEL >= BC_LOG_LEVEL_DEBUG)
+#define BC_LOG_DEBUG(...)       ((VOID)bc_printf(__VA_ARGS__))
+#else
+#define BC_LOG_DEBUG(...)       ((VOID)0)
+#endif
+
+/* Initial state of a call site, the bucket starts full */
+#define BC_LOG_RL_INIT(burst, period_s)     { (burst), (period_s), (burst), 0, 0, 0 }
+
+/*
+** Log a message at level, at most burst messages back to back and burst
+** messages per period_s seconds on average. Compiled out below
+** BC_LOG_LEVEL like the other macros.
+*/
+#define BC_LOG_RL(level, burst, period_s, ...)                                       \
+    do                                                                               \
+    {                                                                                \
+        if (BC_LOG_LEVEL >= (level))                                                 \
+        {                                                                            \
+            PRIVATE bc_log_rl_struct bc_log_rl = BC_LOG_RL_INIT(burst, period_s);    \
+            if (TRUE == bc_log_rl_check(&bc_log_rl))                                 \
+            {                                                                        \
+                bc_log_rl.last_len = (UINT16)bc_printf(__VA_ARGS__);                 \
+            }                                                                        \
+        }                                                                            \
+    } while (0)
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Rate limiter state of one call site.
+*/
+typedef struct
+{
+    UINT16 burst;           /**< Bucket size, in messages */
+    UINT16 period_s;        /**< Seconds to refill the bucket */
+    UINT16 tokens;          /**< Messages that can be logged now */
+    UINT16 last_len;        /**< Length of the last message logged */
+    UINT32 suppressed;      /**< Messages dropped since the last one logged */
+    UINT32 refill_s;        /**< Timer0 system seconds of the last refill */
+} bc_log_rl_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN BOOL bc_log_rl_check(bc_log_rl_struct *rl_ptr);
+EXTERN VOID bc_log_init(VOID);
+
+#endif /* _BC_LOG_H */
+
+/** @} end addtogroup */
+
@@ -37,6 +37,28 @@
 ** Constants
 */
 
+/*
+** Compressed crash dump data, see EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE.
+** Every data flush is written as a frame: a crash_dump_plat_frame_header
+** followed, for each CRASH_DUMP_PLAT_LZ_BLOCK_SIZE bytes of raw data, by a
+** UINT32 block word and the block payload. The block word holds the
+** payload length, with CRASH_DUMP_PLAT_LZ_BLOCK_STORED set if the payload
+** is the raw data. Otherwise the payload is an lz_decomp sequence stream
+** compressed against the crash dump dictionary. Frames follow each other
+** from the start of the data section and are zero padded to a page.
+** Header entries keep referring to offsets in the raw data, which
+** crash_dump_unpack.py rebuilds on the host.
+**
+** The partition holds a series of crash dumps, each a header section and
+** its frames starting on a subsector boundary, oldest first. The header
+** section is written last, so a crash dump cut short has none and is
+** skipped.
+*/
+#define CRASH_DUMP_PLAT_FRAME_MAGIC             0x315A4443  /* 'CDZ1' */
+#define CRASH_DUMP_PLAT_LZ_BLOCK_SIZE           4096
+#define CRASH_DUMP_PLAT_LZ_BLOCK_STORED         0x80000000
+#define CRASH_DUMP_PLAT_LZ_WINDOW_LOG2          12
+
 /*
 ** Macro Definitions
 */
@@ -45,6 +67,17 @@
 ** Structures and Unions
 */
 
+/**
+* @brief Header of a compressed crash dump data frame
+*/
+typedef struct crash_dump_plat_frame_header
+{
+    UINT32 magic;           /**< CRASH_DUMP_PLAT_FRAME_MAGIC */
+    UINT32 raw_offset;      /**< Offset of the raw data in the data section */
+    UINT32 raw_size;        /**< Number of raw data bytes in the frame */
+    UINT32 reserved;        /**< 0 */
+} crash_dump_plat_frame_header;
+
 /*
 ** Global variables
 */
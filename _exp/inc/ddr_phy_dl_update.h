@@ -0,0 +1,90 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Temperature driven DDR PHY delay line and ZQ update policy.
+*
+* @note
+*   The PHY delay lines and the DRAM output drivers drift with temperature.
+*   After each temperature sensor update the hottest valid DIMM reading is
+*   compared against the temperature of the last delay line update and of
+*   the last ZQ calibration, and an update is run when it moved by more
+*   than EXPLORER_DDR_DL_UPDATE_TEMP_DELTA or EXPLORER_DDR_ZQ_UPDATE_TEMP_DELTA.
+*   Updates stall memory traffic, so one is never run less than
+*   EXPLORER_DDR_DL_UPDATE_MIN_INTERVAL_S after the previous one; an update
+*   due within the interval is deferred to the first reading after it.
+*
+*   Temperatures are in the JEDEC temperature sensor format, 1/16 degree C.
+*   test/host/test_ddr_phy_dl_update.c replays temperature traces through
+*   this policy on the host and checks the model of dl_update_sim.py with it.
+*/
+
+#ifndef _DDR_PHY_DL_UPDATE_H
+#define _DDR_PHY_DL_UPDATE_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+** Constants
+*/
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   State and counters of the delay line update policy.
+*/
+typedef struct
+{
+    UINT8  enabled;             /**< Policy running, the PHY is trained */
+    UINT8  ref_valid;           /**< Reference temperatures set */
+    INT16  temp;                /**< Last DIMM temperature evaluated */
+    INT16  dl_ref_temp;         /**< Temperature of the last delay line update */
+    INT16  zq_ref_temp;         /**< Temperature of the last ZQ calibration */
+    UINT32 eval_count;          /**< Temperature readings evaluated */
+    UINT32 dl_count;            /**< Delay line updates run by the policy */
+    UINT32 zq_count;            /**< ZQ calibrations run by the policy */
+    UINT32 deferred_count;      /**< Readings with an update due within the minimum interval */
+    UINT32 forced_count;        /**< Delay line updates forced by the host */
+    UINT32 fail_count;          /**< Updates failed */
+    UINT32 last_rc;             /**< Result of the last update */
+    UINT32 last_seconds;        /**< Timer0 system seconds of the last update */
+} ddr_phy_dl_update_status_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID ddr_phy_dl_update_task(VOID);
+EXTERN UINT32 ddr_phy_dl_update_force(VOID);
+EXTERN VOID ddr_phy_dl_update_status_get(ddr_phy_dl_update_status_struct *status_ptr);
+
+#endif /* _DDR_PHY_DL_UPDATE_H */
+
+/** @} end addtogroup */
+
@@ -0,0 +1,152 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Compact encoding of the 2D read and write eyes captured by DDR PHY
+*   training.
+*
+* @note
+*   A compressed eye capture encodes the eyes of all ranks, DBYTEs and bits
+*   into a session buffer that the host reads in chunks with the
+*   EXP_FW_PHY_INIT_EYE_READ mode of EXP_FW_DDR_PHY_INIT. The session stays
+*   valid until the next compressed capture.
+*
+*   The stream is a ddr_phy_eye_hdr_struct, the centered delay and Vref
+*   values of the capture (the fields following the eye array in
+*   train_2d_read_eye_msdg_t or train_2d_write_eye_msdg_t, unchanged), then
+*   one record per eye in [rank][DBYTE][bit] order. A record is a format
+*   byte followed by:
+*     - DDR_PHY_EYE_FMT_EMPTY:  nothing, all values are 0
+*     - DDR_PHY_EYE_FMT_BITMAP: UINT32, bit n set if delay step n passes
+*     - DDR_PHY_EYE_FMT_DELTA:  eye_min then eye_max, each a UINT16 first
+*                               value followed by tokens for the other steps
+*     - DDR_PHY_EYE_FMT_RAW:    eye_min then eye_max as UINT16 values
+*
+*   Delta tokens:
+*     - 0x00 to 0x7F: next value is the previous one plus the signed 7 bit
+*                     delta, which becomes the current delta
+*     - 0x80 to 0xBF: the current delta repeats (token & 0x3F) + 1 times
+*     - 0xC0:         next value follows as a UINT16, the current delta
+*                     becomes 0
+*
+*   A step passes if its eye_max is not 0 and not below its eye_min. Eyes
+*   are encoded in full unless the bitmap is requested, or unless what is
+*   left of the buffer is only enough for the remaining eyes as bitmaps, so
+*   a capture is never truncated. Multi-byte values are little endian.
+*   ddr_eye_decode.py renders the stream.
+*/
+
+#ifndef _DDR_PHY_EYE_H
+#define _DDR_PHY_EYE_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_err.h"
+#include "pmcfw_mid.h"
+
+/*
+** Constants
+*/
+
+/* Stream header */
+#define DDR_PHY_EYE_MAGIC               0x43455945  /* 'EYEC' */
+#define DDR_PHY_EYE_VERSION             1
+
+/* Eye dimensions of the captures */
+#define DDR_PHY_EYE_NUM_RANKS           4
+#define DDR_PHY_EYE_NUM_DBYTES          10
+#define DDR_PHY_EYE_NUM_BITS            8
+#define DDR_PHY_EYE_NUM_STEPS           31
+#define DDR_PHY_EYE_NUM_EYES            (DDR_PHY_EYE_NUM_RANKS * DDR_PHY_EYE_NUM_DBYTES * DDR_PHY_EYE_NUM_BITS)
+
+/* Capture types */
+#define DDR_PHY_EYE_TYPE_READ           0
+#define DDR_PHY_EYE_TYPE_WRITE          1
+
+/* Header flags, DDR_PHY_EYE_FLAG_BITMAP is also the request flag */
+#define DDR_PHY_EYE_FLAG_BITMAP         0x01    /* all eyes encoded as bitmaps */
+#define DDR_PHY_EYE_FLAG_REDUCED        0x02    /* some eyes encoded as bitmaps to fit the buffer */
+
+/* Record formats */
+#define DDR_PHY_EYE_FMT_EMPTY           0
+#define DDR_PHY_EYE_FMT_BITMAP          1
+#define DDR_PHY_EYE_FMT_DELTA           2
+#define DDR_PHY_EYE_FMT_RAW             3
+
+/* Delta tokens */
+#define DDR_PHY_EYE_TOKEN_REPEAT        0x80
+#define DDR_PHY_EYE_TOKEN_REPEAT_MAX    64
+#define DDR_PHY_EYE_TOKEN_ABS           0xC0
+
+/* Error codes */
+#define DDR_PHY_EYE_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_APPFW_DDR) | 0x100 | (err_suffix))
+#define DDR_PHY_EYE_ERR_NO_SESSION               DDR_PHY_EYE_ERR_CODE_CREATE(0x001)
+#define DDR_PHY_EYE_ERR_OFFSET                   DDR_PHY_EYE_ERR_CODE_CREATE(0x002)
+#define DDR_PHY_EYE_ERR_BUF_SIZE                 DDR_PHY_EYE_ERR_CODE_CREATE(0x003)
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Header of the eye stream.
+*/
+typedef __packed struct
+{
+    UINT32 magic;           /**< DDR_PHY_EYE_MAGIC */
+    UINT8  version;         /**< DDR_PHY_EYE_VERSION */
+    UINT8  type;            /**< DDR_PHY_EYE_TYPE_xxx */
+    UINT8  flags;           /**< DDR_PHY_EYE_FLAG_xxx */
+    UINT8  num_steps;       /**< Delay steps per eye */
+    UINT8  num_ranks;       /**< Ranks */
+    UINT8  num_dbytes;      /**< DBYTEs per rank */
+    UINT8  num_bits;        /**< Bits per DBYTE */
+    UINT8  reserved;
+    UINT32 train_rc;        /**< Return code of the capture training */
+    UINT32 msg_version;     /**< PHY training message block version */
+    UINT16 centers_len;     /**< Bytes of center values following the header */
+    UINT16 num_eyes;        /**< Eye records following the center values */
+    UINT32 stream_len;      /**< Bytes in the stream, including this header */
+} ddr_phy_eye_hdr_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN UINT32 ddr_phy_eye_session_encode(UINT8 type,
+                                         UINT8 flags,
+                                         UINT32 train_rc,
+                                         UINT8 *capture_ptr);
+EXTERN PMCFW_ERROR ddr_phy_eye_session_read(UINT32 offset,
+                                            UINT8 *buf_ptr,
+                                            UINT32 len,
+                                            UINT32 *num_bytes_ptr);
+
+#endif /* _DDR_PHY_EYE_H */
+
+/** @} end addtogroup */
+
+
@@ -60,6 +60,7 @@
 EXTERN VOID ddr_phy_plat_init(VOID);
 EXTERN VOID ddr_phy_plat_initialized_set(BOOL is_initialized);
 EXTERN BOOL ddr_phy_plat_initialized_get(VOID);
+EXTERN VOID ddr_phy_plat_init_rsp_send(UINT32 ext_error_code);
 EXTERN VOID ddr_phy_fatal_init(void);
 EXTERN VOID ddr_phy_non_fatal_init(void);
 
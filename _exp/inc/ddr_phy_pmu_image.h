@@ -0,0 +1,143 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Packed DDR PHY PMU training firmware images.
+*
+* @note
+*   The IMEM and DMEM images of all PHY training firmware variants are
+*   packed at build time by pmu_image_pack.py into one blob linked into the
+*   image. The IMEM images of the reference variants are stored uncompressed
+*   in a pool and every image is an LZ sequence stream (see lz_decomp.h)
+*   compressed against a slice of the pool, so the code the variants share
+*   is stored once.
+*
+*   The PHY library loads the PMU memories from the image returned by
+*   platform_dram_binary_get(), which is provided here in place of the
+*   library's own. The requested image is decoded into a RAM buffer that
+*   the library then writes to the PHY. Multi-byte values are little
+*   endian.
+*/
+
+#ifndef _DDR_PHY_PMU_IMAGE_H
+#define _DDR_PHY_PMU_IMAGE_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_err.h"
+#include "pmcfw_mid.h"
+
+/*
+** Constants
+*/
+
+/* Blob header */
+#define DDR_PHY_PMU_IMAGE_MAGIC         0x5A554D50  /* 'PMUZ' */
+#define DDR_PHY_PMU_IMAGE_VERSION       1
+
+/* userInputBasic.DimmType values of the PHY library */
+#define DDR_PHY_PMU_IMAGE_DIMM_UDIMM    0
+#define DDR_PHY_PMU_IMAGE_DIMM_RDIMM    2
+#define DDR_PHY_PMU_IMAGE_DIMM_LRDIMM   3
+
+/* Error codes */
+#define DDR_PHY_PMU_IMAGE_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_APPFW_DDR) | 0x200 | (err_suffix))
+#define DDR_PHY_PMU_IMAGE_ERR_BAD_PARAM                DDR_PHY_PMU_IMAGE_ERR_CODE_CREATE(0x001)
+#define DDR_PHY_PMU_IMAGE_ERR_BLOB                     DDR_PHY_PMU_IMAGE_ERR_CODE_CREATE(0x002)
+#define DDR_PHY_PMU_IMAGE_ERR_DECODE                   DDR_PHY_PMU_IMAGE_ERR_CODE_CREATE(0x003)
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   Images of the blob directory, in the order of VARIANTS and MEMS in
+*   pmu_image_pack.py.
+*/
+typedef enum
+{
+    DDR_PHY_PMU_IMAGE_DDR4_IMEM = 0,
+    DDR_PHY_PMU_IMAGE_DDR4_DMEM,
+    DDR_PHY_PMU_IMAGE_DDR4_2D_IMEM,
+    DDR_PHY_PMU_IMAGE_DDR4_2D_DMEM,
+    DDR_PHY_PMU_IMAGE_RDIMM_IMEM,
+    DDR_PHY_PMU_IMAGE_RDIMM_DMEM,
+    DDR_PHY_PMU_IMAGE_RDIMM_2D_IMEM,
+    DDR_PHY_PMU_IMAGE_RDIMM_2D_DMEM,
+    DDR_PHY_PMU_IMAGE_LRDIMM_IMEM,
+    DDR_PHY_PMU_IMAGE_LRDIMM_DMEM,
+    DDR_PHY_PMU_IMAGE_LRDIMM_2D_IMEM,
+    DDR_PHY_PMU_IMAGE_LRDIMM_2D_DMEM,
+    DDR_PHY_PMU_IMAGE_MAX
+} ddr_phy_pmu_image_enum;
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Header of the blob, followed by the directory, the pool and the streams.
+*/
+typedef __packed struct
+{
+    UINT32 magic;           /**< DDR_PHY_PMU_IMAGE_MAGIC */
+    UINT8  version;         /**< DDR_PHY_PMU_IMAGE_VERSION */
+    UINT8  num_images;      /**< Directory entries */
+    UINT16 reserved;
+    UINT32 pool_len;        /**< Length of the pool following the directory */
+    UINT32 max_raw_len;     /**< Length of the largest decoded image */
+} ddr_phy_pmu_image_hdr_struct;
+
+/**
+* @brief
+*   Directory entry of an image.
+*/
+typedef __packed struct
+{
+    UINT32 raw_len;         /**< Length of the decoded image */
+    UINT32 dict_offset;     /**< Offset of the dictionary in the pool */
+    UINT32 dict_len;        /**< Length of the dictionary, 0 if none */
+    UINT32 stream_offset;   /**< Offset of the stream from the start of the blob */
+    UINT32 stream_len;      /**< Length of the stream */
+} ddr_phy_pmu_image_entry_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID platform_dram_binary_get(UINT32 dimm_type,
+                                     UINT32 train_2d,
+                                     UINT8 **imem_pptr,
+                                     UINT32 *imem_size_ptr,
+                                     UINT8 **dmem_pptr,
+                                     UINT32 *dmem_size_ptr);
+
+#endif /* _DDR_PHY_PMU_IMAGE_H */
+
+/** @} end addtogroup */
+
+
@@ -0,0 +1,125 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   DDR PHY training of EXP_FW_DDR_PHY_INIT run from the VPE0 main loop.
+*
+* @note
+*   The command handler accepts the training and returns, the training is
+*   run in phases by the DDR training task and the response is sent by its
+*   last phase. Host commands are held off until then, as the host waits for
+*   the response anyway.
+*
+*   The PHY library trains in one call. While it runs, its busy waits, made
+*   between the reads of the PMU mailbox, are routed through a hook that
+*   runs the main loop tasks of higher priority and kicks the watchdog at
+*   most every EXPLORER_DDR_TRAIN_YIELD_INTERVAL_US. The hook also follows
+*   the training progress from the PMU firmware loads and the major messages
+*   posted in the PMU mailbox.
+*
+*   The main loop tasks that may access the PHY or the MSDG, the I2C
+*   deferred commands, the UART shell and its DDR commands, the delay line
+*   update and the serdes calibration, are held from the start of the
+*   training until the response is sent. Only the temperature sensor
+*   update runs from the waits.
+*
+*   The status is read with the DDR training telemetry record, also over
+*   TWI while the command is running.
+*/
+
+#ifndef _DDR_PHY_TRAIN_H
+#define _DDR_PHY_TRAIN_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_err.h"
+#include "pmcfw_mid.h"
+
+/*
+** Constants
+*/
+
+/* Last major message before the PMU posted one */
+#define DDR_PHY_TRAIN_MAJOR_NONE        0xFF00
+
+/* Error codes */
+#define DDR_PHY_TRAIN_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_APPFW_DDR) | 0x300 | (err_suffix))
+#define DDR_PHY_TRAIN_ERR_BUSY                     DDR_PHY_TRAIN_ERR_CODE_CREATE(0x001)
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   Training phases, in order.
+*/
+typedef enum
+{
+    DDR_PHY_TRAIN_PHASE_IDLE = 0,    /**< No training since boot */
+    DDR_PHY_TRAIN_PHASE_START,       /**< Accepted, waiting for the main loop */
+    DDR_PHY_TRAIN_PHASE_LOAD_1D,     /**< PHY initialized, 1D PMU firmware loading */
+    DDR_PHY_TRAIN_PHASE_TRAIN_1D,    /**< 1D training running on the PMU */
+    DDR_PHY_TRAIN_PHASE_LOAD_2D,     /**< 2D PMU firmware loading */
+    DDR_PHY_TRAIN_PHASE_TRAIN_2D,    /**< 2D training running on the PMU */
+    DDR_PHY_TRAIN_PHASE_RESULTS,     /**< Error reporting set up, results copied */
+    DDR_PHY_TRAIN_PHASE_CAL_SAVE,    /**< Calibration being saved to flash */
+    DDR_PHY_TRAIN_PHASE_DONE         /**< Response sent */
+} ddr_phy_train_phase_enum;
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   Progress and result of the last training.
+*/
+typedef struct
+{
+    UINT8  phase;               /**< ddr_phy_train_phase_enum */
+    UINT8  reserved;
+    UINT16 last_major;          /**< Last PMU major message, DDR_PHY_TRAIN_MAJOR_NONE if none */
+    UINT32 run_count;           /**< Trainings started */
+    UINT32 rc;                  /**< Result of the PHY library, valid from DDR_PHY_TRAIN_PHASE_RESULTS */
+    UINT32 major_count;         /**< PMU major messages seen */
+    UINT32 yield_count;         /**< Main loop passes run from the PHY library waits */
+    UINT32 max_hold_us;         /**< Longest time the main loop was held off */
+    UINT64 elapsed_cycles;      /**< CP0 Count ticks since the training was accepted */
+} ddr_phy_train_status_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID ddr_phy_train_start(VOID);
+EXTERN VOID ddr_phy_train_task(VOID);
+EXTERN BOOL ddr_phy_train_busy_get(VOID);
+EXTERN VOID ddr_phy_train_pmu_load(UINT32 train_2d, BOOL dmem);
+EXTERN VOID ddr_phy_train_status_get(ddr_phy_train_status_struct *status_ptr);
+
+#endif /* _DDR_PHY_TRAIN_H */
+
+/** @} end addtogroup */
+
@@ -0,0 +1,163 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Per-command handler latency statistics of the OpenCAPI and TWI command
+*   handlers.
+*
+* @note
+*   For each command ID the number of calls, the minimum, maximum and total
+*   handler time and a log2 histogram of the handler time are kept, in CP0
+*   Count ticks. They are updated when the handler returns, from the times
+*   recorded by the command trace (ech_trace.h), and complement the raw
+*   call counters such as g_count_exp_fw_twi_cmd_status. Commands rejected
+*   before their handler is called are not counted.
+*
+*   There are three tables, each only written by one VPE so updates take
+*   no lock: OpenCAPI commands (VPE0), TWI commands (VPE1) and TWI commands
+*   deferred to VPE0. A deferred TWI command is counted in the TWI table
+*   for its hand-over and in the deferred table for its execution.
+*
+*   Memory: ECH_STATS_NUM_RECORDS records of sizeof(ech_stats_cmd_struct)
+*   (52 bytes), about 5 KB with the current command sets or 2% of the
+*   256 KB RAM. The tables are sized by the command enums only, so they
+*   grow by 52 bytes per OpenCAPI command and 104 bytes per TWI command.
+*
+*   The statistics are read by the host with the EXP_FW_LOG_OP_READ_CMD_STATS
+*   and EXP_FW_LOG_OP_READ_CLR_CMD_STATS operands of EXP_FW_LOG or the
+*   EXP_FW_READ_CMD_STATS TWI command, and decoded with cmd_stats_decode.py.
+*   The image returned is an ech_stats_hdr_struct followed by one
+*   ech_stats_rec_struct per command that was called.
+*/
+
+#ifndef _ECH_STATS_H
+#define _ECH_STATS_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "exp_api.h"
+
+/*
+** Constants
+*/
+
+/* Tables */
+#define ECH_STATS_TABLE_OC              0
+#define ECH_STATS_TABLE_TWI             1
+#define ECH_STATS_TABLE_TWI_DEFERRED    2
+#define ECH_STATS_NUM_TABLES            3
+
+#define ECH_STATS_NUM_RECORDS           (EXP_FW_MAX_CMD + (2 * EXP_FW_TWI_CMD_MAX))
+
+/*
+** Histogram buckets. Bucket 0 counts handler times below
+** 2^ECH_STATS_BUCKET_SHIFT ticks, bucket n (n > 0) those from
+** 2^(ECH_STATS_BUCKET_SHIFT + n - 1) up to 2^(ECH_STATS_BUCKET_SHIFT + n)
+** ticks and the last bucket all longer times. Buckets saturate at 0xFFFF.
+*/
+#define ECH_STATS_NUM_BUCKETS           16
+#define ECH_STATS_BUCKET_SHIFT          10
+
+/* Statistics image header */
+#define ECH_STATS_MAGIC                 0x54534345  /* 'ECST' */
+#define ECH_STATS_VERSION               1
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   Statistics of one command, times in CP0 Count ticks.
+*/
+typedef struct
+{
+    UINT32 count;                               /**< Handler calls */
+    UINT32 min_cycles;                          /**< Shortest handler time */
+    UINT32 max_cycles;                          /**< Longest handler time */
+    UINT32 total_cycles_lo;                     /**< Total handler time, low word */
+    UINT32 total_cycles_hi;                     /**< Total handler time, high word */
+    UINT16 bucket[ECH_STATS_NUM_BUCKETS];       /**< Handler time histogram */
+} ech_stats_cmd_struct;
+
+/**
+* @brief
+*   Record of one command in the statistics image.
+*/
+typedef struct
+{
+    UINT8                table;                 /**< ECH_STATS_TABLE_xxx */
+    UINT8                cmd_id;                /**< exp_cmd_enum or exp_twi_cmd_enum */
+    UINT16               reserved;
+    ech_stats_cmd_struct stats;                 /**< Statistics */
+} ech_stats_rec_struct;
+
+/**
+* @brief
+*   Header of the statistics image returned to the host.
+*/
+typedef struct
+{
+    UINT32 magic;                               /**< ECH_STATS_MAGIC */
+    UINT8  version;                             /**< ECH_STATS_VERSION */
+    UINT8  rec_size;                            /**< sizeof(ech_stats_rec_struct) */
+    UINT8  num_buckets;                         /**< ECH_STATS_NUM_BUCKETS */
+    UINT8  bucket_shift;                        /**< ECH_STATS_BUCKET_SHIFT */
+    UINT32 ticks_per_ms;                        /**< CP0 Count ticks per millisecond */
+    UINT16 num_records;                         /**< Records following */
+    UINT16 reserved;
+} ech_stats_hdr_struct;
+
+/**
+* @brief
+*   Read cursor. Fixes the commands returned when a read starts, so an
+*   image can be read in pieces while commands are handled.
+*/
+typedef struct
+{
+    ech_stats_hdr_struct hdr;                                       /**< Header of the image */
+    UINT32               rec_map[(ECH_STATS_NUM_RECORDS + 31) / 32];  /**< Commands returned */
+    UINT32               rec_idx;                                   /**< Image index of the record below */
+    ech_stats_rec_struct rec;                                       /**< Last record read, a record read in pieces is consistent */
+} ech_stats_cursor_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID ech_stats_init(VOID);
+EXTERN VOID ech_stats_update(UINT32 table, UINT8 cmd_id, UINT32 cycles);
+EXTERN VOID ech_stats_clear(VOID);
+EXTERN UINT32 ech_stats_read_start(ech_stats_cursor_struct *cursor_ptr);
+EXTERN UINT32 ech_stats_read(ech_stats_cursor_struct *cursor_ptr,
+                             UINT32 offset,
+                             UINT8 *buf_ptr,
+                             UINT32 len);
+EXTERN UINT32 ech_stats_counts_get(UINT32 table, UINT32 *count_ptr, UINT32 max);
+EXTERN VOID ech_stats_print(VOID);
+
+#endif /* _ECH_STATS_H */
+
+/** @} end addtogroup */
+
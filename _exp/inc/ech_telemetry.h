@@ -0,0 +1,201 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Single-shot telemetry snapshot of the runtime state.
+*
+* @note
+*   The snapshot gathers in one image the state that otherwise takes one
+*   command per item: temperatures, periodic SerDes calibration, command
+*   counts, extended error code, boot mode and flash partitions. It is
+*   built from values already held in RAM, no sensor, SerDes or flash
+*   access is made, so building it takes a bounded time on either VPE. The
+*   flash partition information is read once at boot, a firmware upgrade
+*   is reported after the next boot.
+*
+*   The snapshot is read by the host with the EXP_FW_TELEMETRY_SNAPSHOT_GET
+*   OpenCAPI command or the EXP_FW_READ_TELEMETRY TWI command, and decoded
+*   with telemetry_decode.py. The image is an ech_telemetry_hdr_struct
+*   followed by TLV records, each an ech_telemetry_tlv_struct followed by
+*   its value padded to 4 bytes. Decoders skip the types they do not know,
+*   types are only added and values only grow at the end.
+*/
+
+#ifndef _ECH_TELEMETRY_H
+#define _ECH_TELEMETRY_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "exp_api.h"
+#include "fw_version_info.h"
+#include "temp_sensor_plat.h"
+#include "serdes_plat.h"
+#include "ddr_phy_dl_update.h"
+#include "ddr_phy_train.h"
+#include "ech_stats.h"
+
+/*
+** Constants
+*/
+
+/* Snapshot image header */
+#define ECH_TELEMETRY_MAGIC             0x4D4C5445  /* 'ETLM' */
+#define ECH_TELEMETRY_VERSION           1
+
+/* TLV types */
+#define ECH_TELEMETRY_TYPE_FW           1   /* ech_telemetry_fw_struct */
+#define ECH_TELEMETRY_TYPE_BOOT_MODE    2   /* ech_telemetry_boot_mode_struct */
+#define ECH_TELEMETRY_TYPE_TEMPERATURE  3   /* temp_sensor_plat_reading_struct per sensor */
+#define ECH_TELEMETRY_TYPE_SERDES_CAL   4   /* serdes_plat_cal_status_struct */
+#define ECH_TELEMETRY_TYPE_ERROR        5   /* ech_telemetry_error_struct */
+#define ECH_TELEMETRY_TYPE_CMD_COUNTS   6   /* ech_telemetry_cmd_counts_struct, one per statistics table */
+#define ECH_TELEMETRY_TYPE_FLASH        7   /* ech_telemetry_flash_struct */
+#define ECH_TELEMETRY_TYPE_DDR_DL_UPDATE 8  /* ddr_phy_dl_update_status_struct */
+#define ECH_TELEMETRY_TYPE_DDR_TRAIN    9   /* ddr_phy_train_status_struct */
+
+/* Largest command set of the statistics tables */
+#define ECH_TELEMETRY_CMDS_MAX          (((UINT32)EXP_FW_MAX_CMD > (UINT32)EXP_FW_TWI_CMD_MAX) ? \
+                                         (UINT32)EXP_FW_MAX_CMD : (UINT32)EXP_FW_TWI_CMD_MAX)
+
+/* Size of a TLV record with its padding */
+#define ECH_TELEMETRY_TLV_SIZE(value_size)  (sizeof(ech_telemetry_tlv_struct) + (((value_size) + 3) & ~3))
+
+/* Largest snapshot image */
+#define ECH_TELEMETRY_SIZE_MAX  (sizeof(ech_telemetry_hdr_struct) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ech_telemetry_fw_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ech_telemetry_boot_mode_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(TEMP_SENSOR_PLAT_NUM * sizeof(temp_sensor_plat_reading_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(serdes_plat_cal_status_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ech_telemetry_error_struct)) + \
+                                 (ECH_STATS_NUM_TABLES * ECH_TELEMETRY_TLV_SIZE(sizeof(ech_telemetry_cmd_counts_struct))) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ech_telemetry_flash_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ddr_phy_dl_update_status_struct)) + \
+                                 ECH_TELEMETRY_TLV_SIZE(sizeof(ddr_phy_train_status_struct)))
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   Header of the snapshot image.
+*/
+typedef struct
+{
+    UINT32 magic;           /**< ECH_TELEMETRY_MAGIC */
+    UINT8  version;         /**< ECH_TELEMETRY_VERSION */
+    UINT8  num_tlvs;        /**< TLV records following */
+    UINT16 size;            /**< Size of the image, header included */
+    UINT32 ticks_per_ms;    /**< CP0 Count ticks per millisecond */
+    UINT32 build_ticks;     /**< Time taken to build the snapshot in CP0 Count ticks */
+} ech_telemetry_hdr_struct;
+
+/**
+* @brief
+*   TLV record header, the value follows padded to 4 bytes.
+*/
+typedef struct
+{
+    UINT8  type;            /**< ECH_TELEMETRY_TYPE_xxx */
+    UINT8  reserved;
+    UINT16 len;             /**< Value length in bytes, without padding */
+} ech_telemetry_tlv_struct;
+
+/**
+* @brief
+*   ECH_TELEMETRY_TYPE_FW value.
+*/
+typedef struct
+{
+    UINT32 major;           /**< FW_VERSION_MAJOR_RELEASE_NUMBER */
+    UINT32 minor;           /**< FW_VERSION_MINOR_RELEASE_NUMBER */
+    UINT32 patch;           /**< FW_VERSION_PATCH_RELEASE_NUMBER */
+    UINT32 build_num;       /**< FW_VERSION_CL_NUMBER */
+    UINT32 build_date;      /**< FW_VERSION_BUILD_DATE */
+    UINT32 uptime_seconds;  /**< Timer0 system seconds */
+} ech_telemetry_fw_struct;
+
+/**
+* @brief
+*   ECH_TELEMETRY_TYPE_BOOT_MODE value, from the boot configuration.
+*/
+typedef struct
+{
+    UINT32 raw_boot_cfg;    /**< Raw EXP_FW_BOOT_CONFIG value */
+    UINT8  tl_mode;         /**< Transport layer mode */
+    UINT8  dl_boot_mode;    /**< Data link layer boot mode */
+    UINT8  host_boot_mode;  /**< Host step-by-step boot */
+    UINT8  mfg_mode;        /**< Manufacturing mode */
+    UINT8  serdes_freq;     /**< SerDes frequency */
+    UINT8  lane_cfg;        /**< Lane configuration */
+    UINT8  ocapi_loopback;  /**< OpenCAPI loopback */
+    UINT8  serdes_loopback; /**< SerDes loopback */
+} ech_telemetry_boot_mode_struct;
+
+/**
+* @brief
+*   ECH_TELEMETRY_TYPE_ERROR value.
+*/
+typedef struct
+{
+    UINT8  ext_err_code;    /**< Extended error code */
+    UINT8  reserved[3];
+} ech_telemetry_error_struct;
+
+/**
+* @brief
+*   ECH_TELEMETRY_TYPE_CMD_COUNTS value, handler calls per command ID.
+*/
+typedef struct
+{
+    UINT8  table;                           /**< ECH_STATS_TABLE_xxx */
+    UINT8  num_cmds;                        /**< Counts following */
+    UINT16 reserved;
+    UINT32 count[ECH_TELEMETRY_CMDS_MAX];   /**< Only num_cmds counts are returned */
+} ech_telemetry_cmd_counts_struct;
+
+/**
+* @brief
+*   ECH_TELEMETRY_TYPE_FLASH value, read at boot.
+*/
+typedef struct
+{
+    UINT8                  boot_partition;  /**< 'A' or 'B' */
+    UINT8                  reserved[3];
+    fw_version_info_struct active;          /**< Version of the active image */
+    fw_version_info_struct redundant;       /**< Version of the redundant image */
+} ech_telemetry_flash_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID ech_telemetry_init(VOID);
+EXTERN UINT32 ech_telemetry_snapshot_build(UINT8 *buf_ptr, UINT32 len);
+
+#endif /* _ECH_TELEMETRY_H */
+
+/** @} end addtogroup */
+
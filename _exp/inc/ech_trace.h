@@ -0,0 +1,146 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Per-command trace of the OpenCAPI and TWI command handlers.
+*
+* @note
+*   Each VPE records the commands it handles in its own ring, so recording
+*   takes no lock. OpenCAPI commands and deferred TWI commands are recorded
+*   on VPE0, TWI commands on VPE1. A record is built while the command is
+*   handled and committed to the ring when the handler returns, or when the
+*   response is sent for a handler that holds it (ech_trace_hold()). There is
+*   one record per source, so a TWI command deferred to VPE0 can be handled
+*   while an OpenCAPI handler yields.
+*
+*   The trace is read by the host with the EXP_FW_LOG_OP_READ_CMD_TRACE
+*   operand of EXP_FW_LOG or the EXP_FW_READ_CMD_TRACE TWI command, and
+*   decoded with cmd_trace_decode.py. The image returned is an
+*   ech_trace_hdr_struct followed by the entries of each ring, oldest first.
+*/
+
+#ifndef _ECH_TRACE_H
+#define _ECH_TRACE_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+** Constants
+*/
+
+/* Number of entries per ring, must be a power of 2 */
+#define ECH_TRACE_RING_ENTRIES          32
+#define ECH_TRACE_NUM_RINGS             2
+
+/* Trace image header */
+#define ECH_TRACE_MAGIC                 0x43525445  /* 'ETRC' */
+#define ECH_TRACE_VERSION               2
+
+/* Command sources */
+#define ECH_TRACE_SRC_OC                0
+#define ECH_TRACE_SRC_TWI               1
+#define ECH_TRACE_NUM_SRC               2
+
+/* Entry flags */
+#define ECH_TRACE_FLAG_DEFERRED         0x01    /* TWI command handed to VPE0 */
+#define ECH_TRACE_FLAG_HELD             0x02    /* OC response sent after the handler returned */
+#define ECH_TRACE_FLAG_LOST             0x80    /* overwritten while it was read */
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   One command. Timestamps are CP0 Count values, 0 if the phase was not
+*   reached (for example a command rejected before it was dispatched).
+*/
+typedef struct
+{
+    UINT32 seq;             /**< Sequence number in the ring */
+    UINT8  src;             /**< ECH_TRACE_SRC_xxx */
+    UINT8  cmd_id;          /**< exp_cmd_enum or exp_twi_cmd_enum */
+    UINT16 req_id;          /**< OC: request identifier of the command, TWI: 0 */
+    UINT8  flags;           /**< ECH_TRACE_FLAG_xxx */
+    UINT8  reserved[3];
+    UINT32 ext_data_len;    /**< Response extended data length */
+    UINT32 rc;              /**< OC: first word of the response parameters, TWI: status byte */
+    UINT32 t_rx;            /**< Command received */
+    UINT32 t_dispatch;      /**< Handler called */
+    UINT32 t_return;        /**< Handler returned */
+    UINT32 t_doorbell;      /**< OC: response doorbell rung, TWI: final status set */
+} ech_trace_entry_struct;
+
+/**
+* @brief
+*   Header of the trace image returned to the host.
+*/
+typedef struct
+{
+    UINT32 magic;                               /**< ECH_TRACE_MAGIC */
+    UINT8  version;                             /**< ECH_TRACE_VERSION */
+    UINT8  entry_size;                          /**< sizeof(ech_trace_entry_struct) */
+    UINT8  num_rings;                           /**< ECH_TRACE_NUM_RINGS */
+    UINT8  reserved;
+    UINT32 ticks_per_ms;                        /**< CP0 Count ticks per millisecond */
+    UINT16 num_entries[ECH_TRACE_NUM_RINGS];    /**< Entries following, per ring */
+} ech_trace_hdr_struct;
+
+/**
+* @brief
+*   Read cursor. Fixes the entries returned when a read starts, so an image
+*   can be read in pieces while new commands are recorded.
+*/
+typedef struct
+{
+    ech_trace_hdr_struct   hdr;                             /**< Header of the image */
+    UINT32                 first_seq[ECH_TRACE_NUM_RINGS];  /**< Oldest entry returned, per ring */
+    UINT32                 entry_idx;                       /**< Image index of the entry below */
+    ech_trace_entry_struct entry;                           /**< Last entry read, an entry read in pieces is consistent */
+} ech_trace_cursor_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID ech_trace_init(VOID);
+EXTERN VOID ech_trace_rx(UINT8 src, UINT8 cmd_id, UINT16 req_id, UINT32 t_rx);
+EXTERN VOID ech_trace_defer(VOID);
+EXTERN VOID ech_trace_deferred_rx(UINT8 cmd_id);
+EXTERN VOID ech_trace_dispatch(UINT8 src);
+EXTERN VOID ech_trace_done(UINT8 src, UINT32 ext_data_len, UINT32 rc);
+EXTERN VOID ech_trace_return(UINT8 src);
+EXTERN VOID ech_trace_hold(UINT8 src);
+EXTERN VOID ech_trace_release(UINT8 src);
+EXTERN UINT32 ech_trace_read_start(ech_trace_cursor_struct *cursor_ptr);
+EXTERN UINT32 ech_trace_read(ech_trace_cursor_struct *cursor_ptr,
+                             UINT32 offset,
+                             UINT8 *buf_ptr,
+                             UINT32 len);
+
+#endif /* _ECH_TRACE_H */
+
+/** @} end addtogroup */
+
@@ -126,6 +126,10 @@ EXTERN VOID ech_twi_continuous_serdes_cal_disable(UINT8* rx_buf_ptr, UINT32 rx_i
 EXTERN VOID ech_twi_prbs_cal_status(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
 EXTERN VOID ech_twi_read_active_logs(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
 EXTERN VOID ech_twi_read_saved_ddr_params(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
+EXTERN VOID ech_twi_read_cmd_trace(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
+EXTERN VOID ech_twi_read_cmd_stats(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
+EXTERN VOID ech_twi_read_boot_profile(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
+EXTERN VOID ech_twi_read_telemetry(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id);
 EXTERN UINT32 ech_twi_boot_config_proc(UINT8* rx_buf, UINT32 rx_index);
 
 EXTERN VOID ech_twi_deferred_cmd_processing_struct_set(exp_twi_cmd_enum cmd_id, 
@@ -230,6 +230,33 @@
 #define EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_RSP_DATA_LEN         (254)
 #define EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_RSP_LEN              (EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_RSP_DATA_LEN + 2)
 
+/* TWI Read command trace command length */
+#define EXP_TWI_EXP_FW_READ_CMD_TRACE_CMD_DATA_LEN                1
+#define EXP_TWI_EXP_FW_READ_CMD_TRACE_CMD_LEN                     (EXP_TWI_EXP_FW_READ_CMD_TRACE_CMD_DATA_LEN + 2)
+#define EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_DATA_LEN                (254)
+#define EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_LEN                     (EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_DATA_LEN + 2)
+
+/* TWI Read command statistics command length */
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_CMD_DATA_LEN                1
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_CMD_LEN                     (EXP_TWI_EXP_FW_READ_CMD_STATS_CMD_DATA_LEN + 2)
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_DATA_LEN                (254)
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_LEN                     (EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_DATA_LEN + 2)
+
+/* TWI Read boot profile command length */
+#define EXP_TWI_EXP_FW_READ_BOOT_PROFILE_CMD_LEN                  1
+#define EXP_TWI_EXP_FW_READ_BOOT_PROFILE_RSP_DATA_LEN             (254)
+#define EXP_TWI_EXP_FW_READ_BOOT_PROFILE_RSP_LEN                  (EXP_TWI_EXP_FW_READ_BOOT_PROFILE_RSP_DATA_LEN + 1)
+
+/* TWI Read telemetry snapshot command length */
+#define EXP_TWI_EXP_FW_READ_TELEMETRY_CMD_DATA_LEN                1
+#define EXP_TWI_EXP_FW_READ_TELEMETRY_CMD_LEN                     (EXP_TWI_EXP_FW_READ_TELEMETRY_CMD_DATA_LEN + 2)
+#define EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_DATA_LEN                (254)
+#define EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_LEN                     (EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_DATA_LEN + 2)
+
+/* TWI Read command statistics command data */
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_START                       0x01    /* start a new read */
+#define EXP_TWI_EXP_FW_READ_CMD_STATS_CLEAR                       0x02    /* with START, clear once read */
+
 /*
 ** TWI PQM command/response lengths
 ** For commands containing command ID and length, '2' is added to
@@ -298,6 +325,7 @@
 #define EXP_FW_API_CMD_ERR              1
 #define EXP_FW_API_CMD_CRC_ERR          2
 #define EXP_FW_API_CMD_DATA_CRC_ERR     3
+#define EXP_FW_API_CMD_DATA_LEN_ERR     4
 
 /* API command flags */
 #define EXP_FW_NO_EXTENDED_DATA         0
@@ -489,6 +517,10 @@ typedef enum
     EXP_FW_CONT_SERDES_CAL_DISABLE,                 /**< Command to disable / re-enable SerDes continuous calibration */
     EXP_FW_READ_ACTIVE_LOGS,                        /**< Command to read logs over the TWI interface */
     EXP_FW_READ_SAVED_DDR_PARAMS,                   /**< Command to read DDR parameters that are saved in flash over the TWI interface */
+    EXP_FW_READ_CMD_TRACE,                          /**< Command to read the per-command trace over the TWI interface */
+    EXP_FW_READ_CMD_STATS,                          /**< Command to read and optionally clear the per-command statistics over the TWI interface */
+    EXP_FW_READ_BOOT_PROFILE,                       /**< Command to read the boot phase profile over the TWI interface */
+    EXP_FW_READ_TELEMETRY,                          /**< Command to read the telemetry snapshot over the TWI interface */
     EXP_FW_TWI_CMD_MAX
 
 } exp_twi_cmd_enum;
@@ -510,6 +542,7 @@ typedef enum
     EXP_FW_BINARY_UPGRADE,                  /**< Firmware upgrade with binary image */
     EXP_FW_FLASH_LOADER_VERSION_INFO,       /**< Get flash loader version information */
     EXP_FW_LOG,                             /**< Access and manage firmware logs */
+    EXP_FW_TELEMETRY_SNAPSHOT_GET,          /**< Get a snapshot of the runtime state */
     EXP_FW_MAX_CMD
 
 } exp_cmd_enum;
@@ -524,7 +557,13 @@ typedef enum
     EXP_FW_LOG_OP_READ_ACTIVE_LOG,          /**< Read from active firmware logfile */
     EXP_FW_LOG_OP_READ_SAVED_LOG,           /**< Read from saved firmware logfile */
     EXP_FW_LOG_OP_ACTIVE_CLR,               /**< Clear active logfile */
-    EXP_FW_LOG_OP_SAVED_CLR                 /**< Clear saved logfile */
+    EXP_FW_LOG_OP_SAVED_CLR,                /**< Clear saved logfile */
+    EXP_FW_LOG_OP_READ_CMD_TRACE,           /**< Read the per-command trace */
+    EXP_FW_LOG_OP_READ_CMD_STATS,           /**< Read the per-command statistics */
+    EXP_FW_LOG_OP_READ_CLR_CMD_STATS,       /**< Read and clear the per-command statistics */
+    EXP_FW_LOG_OP_READ_PC_PROFILE,          /**< Read the PC-sampling profile, if built in */
+    EXP_FW_LOG_OP_READ_CHANNEL_LOG,         /**< Read the log channels merged in time order */
+    EXP_FW_LOG_OP_READ_SAVED_JOURNAL        /**< Read the saved log journal */
 } exp_fw_log_cmd_ops;
 
 /**
@@ -533,12 +572,18 @@ typedef enum
 */
 typedef enum
 {
-    EXP_FW_PHY_INIT_DEFAULT_TRAIN   = 0,   /**< Standard PHY training with response */
-    EXP_FW_PHY_INIT_READ_EYE_TRAIN  = 1,   /**< Train and return 2D read eye */
-    EXP_FW_PHY_INIT_WRITE_EYE_TRAIN = 2,   /**< Train and return 2D write eye */
-    EXP_FW_PHY_INIT_RESET           = 3    /**< Place PHY in reset, apply power, and take PHY out of reset */
+    EXP_FW_PHY_INIT_DEFAULT_TRAIN        = 0,  /**< Standard PHY training with response */
+    EXP_FW_PHY_INIT_READ_EYE_TRAIN       = 1,  /**< Train and return 2D read eye */
+    EXP_FW_PHY_INIT_WRITE_EYE_TRAIN      = 2,  /**< Train and return 2D write eye */
+    EXP_FW_PHY_INIT_RESET                = 3,  /**< Place PHY in reset, apply power, and take PHY out of reset */
+    EXP_FW_PHY_INIT_READ_EYE_COMPRESSED  = 4,  /**< Train and return the first chunk of the compressed 2D read eye */
+    EXP_FW_PHY_INIT_WRITE_EYE_COMPRESSED = 5,  /**< Train and return the first chunk of the compressed 2D write eye */
+    EXP_FW_PHY_INIT_EYE_READ             = 6   /**< Return a chunk of the last compressed 2D eye */
 } exp_phy_init_cmd_ops;
 
+/* Compressed 2D eye capture flags */
+#define EXP_FW_PHY_INIT_EYE_FLAG_BITMAP     0x01    /**< Return pass/fail bitmaps only */
+
 
 /*
 ** **************************************************************
@@ -754,7 +799,8 @@ typedef enum
     DDR_PHY_INIT_INPUT_MSDG_NO_EXT_DATA     = 0x03,
     DDR_PHY_INIT_INPUT_MSDG_ERROR           = 0x04,
     DDR_PHY_INIT_TRAIN_ERROR                = 0x05,
-    /* 0x06 to 0xFF reserved for future use */
+    DDR_PHY_INIT_EYE_READ_ERROR             = 0x06,
+    /* 0x07 to 0xFF reserved for future use */
 } exp_omi_ddr_phy_init_err_code_enum;
 
 
@@ -860,6 +906,18 @@ typedef __packed struct
 
 } exp_fw_log_rsp_parms_struct;
 
+/**
+*  @brief
+*   Explorer telemetry snapshot response operands
+*/
+typedef __packed struct
+{
+    UINT8  status;             /**< 0: Success / 1: Failure */
+    UINT8  version;            /**< Snapshot version, see ech_telemetry.h */
+    UINT32 num_bytes_returned; /**< Number of bytes returned */
+
+} exp_fw_telemetry_rsp_parms_struct;
+
 /**
 *  @brief
 *   Explorer phy init response operands
@@ -881,6 +939,18 @@ typedef __packed struct
     UINT8  reserved[EXP_TWI_PHY_INIT_PARMS_RESERVED_LEN];  /**< Reserved for future use */
 } exp_fw_phy_init_cmd_parms_struct;
 
+/**
+*  @brief
+*   Explorer phy init cmd operands of the compressed 2D eye modes
+*/
+typedef __packed struct
+{
+    UINT8  phy_init_mode;      /**< EXP_FW_PHY_INIT_xxx_EYE_COMPRESSED or EXP_FW_PHY_INIT_EYE_READ */
+    UINT8  eye_flags;          /**< EXP_FW_PHY_INIT_EYE_FLAG_xxx, used only for the compressed captures */
+    UINT32 offset;             /**< Eye stream byte offset, used only for EXP_FW_PHY_INIT_EYE_READ */
+    UINT32 num_bytes;          /**< Number of bytes to read, 0 for as many as fit, used only for EXP_FW_PHY_INIT_EYE_READ */
+} exp_fw_phy_init_eye_cmd_parms_struct;
+
 /**
 *  @brief
 *   Explorer pass-through temperature read response operands
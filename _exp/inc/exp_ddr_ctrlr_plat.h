@@ -34,6 +34,7 @@
 #include "pmcfw_types.h"
 #include "pmcfw_err.h"
 #include "exp_ddr_ctrlr.h"
+#include "exp_ddr_ctrlr_spd.h"
 
 /*
 ** Enumerated Types
@@ -45,6 +46,7 @@
 
 EXTERN VOID exp_ddr_ctrlr_sample_spd_config_init(exp_ddr_ctrlr_spd_config_struct *ocmb_config);
 EXTERN void exp_ddr_ctrlr_init(VOID);
+EXTERN const exp_ddr_ctrlr_spd_struct *exp_ddr_ctrlr_spd_info_get(UINT32 *data_rate_ptr);
 
 
 #endif /* _EXP_DDR_CTRLR_PLAT_H */
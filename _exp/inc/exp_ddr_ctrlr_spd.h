@@ -0,0 +1,157 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup exp_ddr_ctrlr
+* @{
+* @file
+* @brief
+*   JEDEC DDR4 SPD parser and DDR timing calculator.
+*
+* @note
+*   exp_ddr_ctrlr_spd_parse() decodes the base configuration section of a
+*   DDR4 SPD (bytes 0 to 127) into exp_ddr_ctrlr_spd_struct, with the
+*   timings in picoseconds after the fine timebase corrections.
+*   exp_ddr_ctrlr_spd_timing_calc() turns it into the controller
+*   configuration for a target data rate and exp_ddr_ctrlr_spd_phy_config()
+*   sets the DIMM fields of the PHY user input. Settings that the SPD does
+*   not describe, such as ODT and DFI read latency, are left to the caller.
+*
+*   Clock counts use the JEDEC rounding algorithm: a time is divided by tCK
+*   and rounded up after a 2.5% guard band, so SPD values that are an exact
+*   number of clocks with the picosecond truncation of tCK do not round up
+*   to one clock more.
+*/
+
+#ifndef _EXP_DDR_CTRLR_SPD_H
+#define _EXP_DDR_CTRLR_SPD_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_err.h"
+#include "pmcfw_mid.h"
+#include "exp_ddr_ctrlr.h"
+#include "ddrphy_toolbox.h"
+
+/*
+** Constants
+*/
+
+/* Size of the DDR4 SPD base configuration section, including its CRC */
+#define EXP_DDR_CTRLR_SPD_BASE_SIZE         128
+
+/* Error codes */
+#define EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(err_suffix)  ((PMCFW_ERR_BASE_EXP_DDR_CTRLR) | 0x100 | (err_suffix))
+#define EXP_DDR_CTRLR_SPD_ERR_LEN                      EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x001)
+#define EXP_DDR_CTRLR_SPD_ERR_CRC                      EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x002)
+#define EXP_DDR_CTRLR_SPD_ERR_DRAM_TYPE                EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x003)
+#define EXP_DDR_CTRLR_SPD_ERR_TIMEBASE                 EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x004)
+#define EXP_DDR_CTRLR_SPD_ERR_ORGANIZATION             EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x005)
+#define EXP_DDR_CTRLR_SPD_ERR_DATA_RATE                EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x006)
+#define EXP_DDR_CTRLR_SPD_ERR_CAS_LATENCY              EXP_DDR_CTRLR_SPD_ERR_CODE_CREATE(0x007)
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   DDR4 SPD base configuration. Times are in picoseconds.
+*/
+typedef struct
+{
+    UINT8  module_type;         /**< Byte 3 key byte, module type */
+    UINT8  density_gb;          /**< SDRAM density in Gb, 0 if not a whole number */
+    UINT8  dram_width;          /**< SDRAM device width, 4, 8 or 16 */
+    UINT8  ranks;               /**< Package ranks per DIMM */
+    UINT8  bus_width;           /**< Primary bus width plus ECC in bits */
+    UINT8  row_bits;            /**< Row address bits */
+    UINT8  col_bits;            /**< Column address bits */
+    UINT8  height_3ds;          /**< Dies per 3DS stack, 0 if not 3DS */
+    UINT32 cl_mask;             /**< Supported CAS latencies, bit 0 is cl_base */
+    UINT8  cl_base;             /**< CAS latency of bit 0 of cl_mask */
+    UINT32 tCKmin;
+    UINT32 tCKmax;
+    UINT32 tAA;
+    UINT32 tRCD;
+    UINT32 tRP;
+    UINT32 tRAS;
+    UINT32 tRC;
+    UINT32 tRFC1;
+    UINT32 tRFC2;
+    UINT32 tRFC4;
+    UINT32 tFAW;
+    UINT32 tRRD_S;
+    UINT32 tRRD_L;
+    UINT32 tCCD_L;
+    UINT32 tWR;
+    UINT32 tWTR_S;
+    UINT32 tWTR_L;
+} exp_ddr_ctrlr_spd_struct;
+
+/**
+* @brief
+*   Timings of a configuration in clocks, for display and checks.
+*/
+typedef struct
+{
+    UINT32 tCK;                 /**< Clock period in ps */
+    UINT16 cl;
+    UINT16 cwl;
+    UINT16 tRCD;
+    UINT16 tRP;
+    UINT16 tRAS;
+    UINT16 tRC;
+    UINT16 tRFC1;
+    UINT16 tRFC2;
+    UINT16 tRFC4;
+    UINT16 tFAW;
+    UINT16 tRRD_S;
+    UINT16 tRRD_L;
+    UINT16 tCCD_L;
+    UINT16 tWR;
+    UINT16 tWTR_S;
+    UINT16 tWTR_L;
+} exp_ddr_ctrlr_spd_clk_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN PMCFW_ERROR exp_ddr_ctrlr_spd_parse(const UINT8 *spd_ptr,
+                                           UINT32 len,
+                                           exp_ddr_ctrlr_spd_struct *spd_info_ptr);
+EXTERN UINT32 exp_ddr_ctrlr_spd_ps_to_clk(UINT32 time_ps, UINT32 tck_ps);
+EXTERN PMCFW_ERROR exp_ddr_ctrlr_spd_timing_calc(const exp_ddr_ctrlr_spd_struct *spd_info_ptr,
+                                                 UINT32 data_rate,
+                                                 exp_ddr_ctrlr_spd_config_struct *config_ptr,
+                                                 exp_ddr_ctrlr_spd_clk_struct *clk_ptr);
+EXTERN PMCFW_ERROR exp_ddr_ctrlr_spd_phy_config(const exp_ddr_ctrlr_spd_struct *spd_info_ptr,
+                                                UINT32 data_rate,
+                                                user_input_msdg_t *msdg_ptr);
+EXTERN UINT32 exp_ddr_ctrlr_spd_config_compare(const exp_ddr_ctrlr_spd_config_struct *calc_ptr,
+                                               const exp_ddr_ctrlr_spd_config_struct *ref_ptr);
+
+#endif /* _EXP_DDR_CTRLR_SPD_H */
+
+/** @} end addtogroup */
+
+
@@ -32,6 +32,8 @@
 ** Include Files
 */
 #include "pmcfw_types.h"
+#include "cpuhal.h"
+#include "cicint_api.h"
 
 /*
 ** Constants
@@ -104,6 +106,24 @@
 
 #define EXP_NUM_INTERRUPTS                   64
 
+/*
+** GIC vector priorities, HAL_GIC_VEC_PRIO_5 is the highest. Fatal errors
+** use the highest level in use, their handlers are registered with
+** cicint_int_register() and are not nested.
+*/
+#define EXP_GIC_PRIO_FATAL                   HAL_GIC_VEC_PRIO_4
+#define EXP_GIC_PRIO_TWI_SLAVE               HAL_GIC_VEC_PRIO_3
+#define EXP_GIC_PRIO_UART                    HAL_GIC_VEC_PRIO_3
+#define EXP_GIC_PRIO_TIMER                   HAL_GIC_VEC_PRIO_2
+#define EXP_GIC_PRIO_DEFAULT                 HAL_GIC_VEC_PRIO_1
+
+/*
+** Latency probes. The reserved pins are software triggered edge interrupts,
+** one per priority level in use on VPE0, from the highest to the lowest.
+*/
+#define EXP_GIC_PROBE_INT_FIRST              EXP_INT_RESERVED_0
+#define EXP_GIC_PROBE_NUM                    4
+
 /*
 ** Macro Definitions
 */
@@ -139,10 +159,25 @@ __asmleaf VOID exp_init_yq_mask(void)
 ** Structures and Unions
 */
 
+/*
+** Per interrupt statistics kept by the exp_gic_int_register() dispatcher
+*/
+typedef struct
+{
+    UINT32 count;           /* number of calls */
+    UINT32 nested_count;    /* calls that preempted another handler */
+    UINT32 max_cycles;      /* longest handler run, CP0 Count ticks */
+    UINT32 total_cycles;    /* sum of handler runs, CP0 Count ticks */
+} exp_gic_int_stats_struct;
+
 /*
 ** Function Prototypes
 */
 EXTERN void exp_gic_init(void);
+EXTERN void exp_gic_int_register(UINT32 int_num, cicint_cback_fcn_ptr cback_ptr, void *cback_arg);
+EXTERN void exp_gic_int_stats_get(UINT32 int_num, exp_gic_int_stats_struct *stats_ptr);
+EXTERN BOOL exp_gic_latency_probe(UINT32 num_samples);
+EXTERN void exp_gic_stats_print(void);
 
 #endif /* _EXP_GIC_H */
 
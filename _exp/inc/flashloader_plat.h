@@ -54,16 +54,112 @@
 
 #define FLASH_LOADER_PLAT_PUB_KEY_LENGTH_BYTES     512
 
+/*
+** Compressed upgrade images start with this magic ('EXPZ') followed by the
+** header described in fw_image_pack.py. The decompression window is a static
+** buffer, its size must match the packer's window.
+*/
+#define FLASH_LOADER_PACK_MAGIC                     0x5A505845
+#define FLASH_LOADER_PACK_VERSION                   1
+#define FLASH_LOADER_PACK_HDR_SIZE                  16
+#define FLASH_LOADER_DECOMP_WINDOW_LOG2             12
+#define FLASH_LOADER_DECOMP_WINDOW_SIZE             (1 << FLASH_LOADER_DECOMP_WINDOW_LOG2)
+
+/*
+** Resume record kept in SPI_FLASH_FW_FW_UPGRADE_RECORD. The record is a
+** sequence of one page checkpoints written alternately into its two
+** subsectors. Flash ECC does not allow a written page to be updated, so
+** a checkpoint is written each time a staging subsector is complete and
+** carries one bit per staging subsector. Chunks of incomplete subsectors
+** are tracked in RAM only and must be resent after a reset.
+**
+** A download is identified by the image size and a CRC32 of the whole
+** image which the HOST passes in the write command. A record is only
+** resumed by a write carrying the same size and digest, and the staged
+** image must match the digest before it is committed. A download without
+** a digest is refused. The digest of a compressed image is that of the
+** plain image.
+*/
+#define FLASH_LOADER_RECORD_MAGIC                   0x52505845
+#define FLASH_LOADER_RECORD_VERSION                 2
+#define FLASH_LOADER_SUBSECTOR_CHUNKS               (4096 / FLASH_LOADER_PAGE_BUF_SIZE)
+#define FLASH_LOADER_RECORD_MAX_CHUNKS              (SPI_FLASH_FW_FW_UPGRADE_SIZE / FLASH_LOADER_PAGE_BUF_SIZE)
+#define FLASH_LOADER_RECORD_MAX_SUBSECTORS          (FLASH_LOADER_RECORD_MAX_CHUNKS / FLASH_LOADER_SUBSECTOR_CHUNKS)
+#define FLASH_LOADER_RECORD_SLOTS                   (SPI_FLASH_FW_FW_UPGRADE_RECORD_SIZE / FLASH_LOADER_PAGE_BUF_SIZE)
+#define FLASH_LOADER_RECORD_BITMAP_SIZE             (FLASH_LOADER_RECORD_MAX_CHUNKS / 8)
+
 
 /*
 * Enumerated Types
 */
 
+/** 
+*  @brief 
+*   Platform specific flashloader error codes, numbered after
+*   flashloader_error_code_enum.
+*/
+typedef enum
+{
+    FLASHLOADER_PLAT_ERR_PACK_HEADER = FLASHLOADER_ERR_AUTHENTICATION_ERROR + 1, /**< Invalid compressed image header */
+    FLASHLOADER_PLAT_ERR_PACK_SEQUENCE,                                          /**< Compressed image packet out of order */
+    FLASHLOADER_PLAT_ERR_PACK_CORRUPT,                                           /**< Compressed stream failed to decode */
+    FLASHLOADER_PLAT_ERR_PACK_INCOMPLETE,                                        /**< Commit before the whole image was decoded */
+    FLASHLOADER_PLAT_ERR_RECORD_WRITE,                                           /**< Resume record could not be updated */
+    FLASHLOADER_PLAT_ERR_CHUNK_VERIFY,                                           /**< Chunk read back differs from the data sent */
+    FLASHLOADER_PLAT_ERR_CHUNKS_MISSING,                                         /**< Commit before every chunk was received */
+    FLASHLOADER_PLAT_ERR_DIGEST_MISMATCH,                                        /**< Staged image does not match the image digest */
+    FLASHLOADER_PLAT_ERR_PACK_ABORTED,                                           /**< Packet of a compressed image that already failed */
+    FLASHLOADER_PLAT_ERR_DIGEST_MISSING,                                         /**< Download without an image digest */
+} flashloader_plat_error_code_enum;
+
+/**
+*  @brief
+*   Platform specific flashloader commands, carried in the same parms[0]
+*   byte as flashloader_cmd_enum.
+*/
+typedef enum
+{
+    FLASHLOADER_PLAT_CMD_CHUNK_STATUS_GET = 0x80,   /**< Return the resume record and missing chunk bitmap */
+} flashloader_plat_cmd_enum;
+
 
 /*
 * Structures and Unions
 */
 
+/**
+*  @brief
+*   Resume record checkpoint, one per FLASH_LOADER_PAGE_BUF_SIZE slot in
+*   SPI_FLASH_FW_FW_UPGRADE_RECORD. The valid checkpoint with the highest
+*   sequence number is the current one. A chunk_count of 0 means there is
+*   no download to resume.
+*/
+typedef struct
+{
+    UINT32 magic;           /**< FLASH_LOADER_RECORD_MAGIC */
+    UINT32 version;         /**< FLASH_LOADER_RECORD_VERSION */
+    UINT32 seq;             /**< Checkpoint sequence number */
+    UINT32 image_size;      /**< Image size from the write command */
+    UINT32 chunk_count;     /**< Number of FLASH_LOADER_PAGE_BUF_SIZE chunks in the image */
+    UINT32 digest;          /**< CRC32 of the whole image from the write command, 0xFFFFFFFF if none */
+    UINT8  subsector_map[FLASH_LOADER_RECORD_MAX_SUBSECTORS / 8];  /**< Set bit: staging subsector complete */
+    UINT32 crc;             /**< CRC32 of the fields above */
+} flashloader_plat_record_struct;
+
+/**
+*  @brief
+*   FLASHLOADER_PLAT_CMD_CHUNK_STATUS_GET response, followed by
+*   FLASH_LOADER_RECORD_BITMAP_SIZE bytes of chunk bitmap in which a set
+*   bit marks a chunk the HOST still has to send.
+*/
+typedef struct
+{
+    UINT32 image_size;      /**< Image size of the download, 0 if there is none */
+    UINT32 chunk_count;     /**< Number of chunks in the image */
+    UINT32 digest;          /**< CRC32 of the whole image, 0xFFFFFFFF if none was supplied */
+    UINT32 missing_count;   /**< Number of chunks still missing */
+} flashloader_plat_chunk_status_struct;
+
 /*
 * Global Variables
 */
@@ -0,0 +1,158 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup LOG_CHAN
+* @{
+* @file
+* @brief
+*    Per-subsystem log channels.
+*
+* @note
+*    Each bc_printf() message is also written to the CCB of the channel of
+*    the subsystem that printed it, so a burst of messages from one
+*    subsystem only evicts its own history. The legacy runtime CCB is not
+*    changed.
+*
+*    The channel of a message is the one entered last on the VPE that
+*    prints it with log_chan_enter(). Messages printed outside any channel
+*    go to the boot channel until log_chan_boot_done() is called and are
+*    not kept in a channel afterwards. Messages printed on the crash
+*    channel of bc_printf go to the fatal channel.
+*
+*    Each message is stored as a record: LOG_CHAN_REC_MARK, the 8 hex
+*    digits of a sequence number common to all channels and the message
+*    text. The channels are merged in sequence order by log_chan_read() for
+*    the EXP_FW_LOG_OP_READ_CHANNEL_LOG operand of EXP_FW_LOG.
+*
+*    log_spi_flash_chan_store() appends the new records to the saved log,
+*    highest priority channel first, as log_app_entry_struct entries:
+*    log_code is (PMCFW_MID_LOG_APP << 16) | LOG_CHAN_LOG_CODE | channel,
+*    ts_u the record sequence number, ts_l the index of the entry within
+*    the record and log_word0..4 20 bytes of text, NUL padded. Decode with
+*    log_chan_decode.py.
+*/
+
+#ifndef _LOG_CHAN_H
+#define _LOG_CHAN_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmc_profile.h"
+
+/*
+** Enumerated Types
+*/
+
+/**
+* @brief
+*   Log channels, in decreasing priority of the saved log.
+*/
+typedef enum
+{
+    LOG_CHAN_FATAL = 0,     /**< Fatal error and assert handling */
+    LOG_CHAN_BOOT,          /**< Boot until the main loop */
+    LOG_CHAN_FLASH,         /**< Firmware upgrade and flash access */
+    LOG_CHAN_DDR,           /**< DDR PHY training */
+    LOG_CHAN_SERDES,        /**< SerDes initialization and calibration */
+    LOG_CHAN_ECH,           /**< Other host commands */
+    LOG_CHAN_NUM
+} log_chan_enum;
+
+/*
+** Constants
+*/
+
+/* No channel, the message is only kept in the runtime CCB */
+#define LOG_CHAN_NONE               0xFF
+
+/* Record header: mark and 8 hex digits of sequence number */
+#define LOG_CHAN_REC_MARK           '\x1e'
+#define LOG_CHAN_REC_HDR_SIZE       9
+
+/* Saved log entries, log_code = module ID | LOG_CHAN_LOG_CODE | channel */
+#define LOG_CHAN_LOG_CODE           0xC000
+#define LOG_CHAN_ENTRY_TEXT_SIZE    20
+
+/* Channel sizes, 0 if the channel is not built */
+#define LOG_CHAN_TOTAL_SIZE         (EXPLORER_LOG_CHAN_FATAL_SIZE + \
+                                     EXPLORER_LOG_CHAN_BOOT_SIZE + \
+                                     EXPLORER_LOG_CHAN_FLASH_SIZE + \
+                                     EXPLORER_LOG_CHAN_DDR_SIZE + \
+                                     EXPLORER_LOG_CHAN_SERDES_SIZE + \
+                                     EXPLORER_LOG_CHAN_ECH_SIZE)
+
+#define LOG_CHAN_MAX(a, b)          (((a) > (b)) ? (a) : (b))
+#define LOG_CHAN_SIZE_MAX           LOG_CHAN_MAX(LOG_CHAN_MAX(LOG_CHAN_MAX(EXPLORER_LOG_CHAN_FATAL_SIZE, \
+                                                                       EXPLORER_LOG_CHAN_BOOT_SIZE), \
+                                                          LOG_CHAN_MAX(EXPLORER_LOG_CHAN_FLASH_SIZE, \
+                                                                       EXPLORER_LOG_CHAN_DDR_SIZE)), \
+                                             LOG_CHAN_MAX(EXPLORER_LOG_CHAN_SERDES_SIZE, \
+                                                          EXPLORER_LOG_CHAN_ECH_SIZE))
+
+/* Channels, and the channel copy and entries of log_spi_flash_chan_store() */
+#if ((LOG_CHAN_TOTAL_SIZE + LOG_CHAN_SIZE_MAX + EXPLORER_LOG_CHAN_SAVE_SIZE) > EXPLORER_LOG_CHAN_RAM_BUDGET)
+#error "The log channels do not fit in EXPLORER_LOG_CHAN_RAM_BUDGET."
+#endif
+
+/*
+** Structures and Unions
+*/
+
+/**
+* @brief
+*   One record of a channel, as parsed by log_chan_rec_next().
+*/
+typedef struct
+{
+    UINT32      seq;        /**< Sequence number */
+    const CHAR *text_ptr;   /**< Message text, not NUL terminated */
+    UINT32      text_len;   /**< Length of the text */
+} log_chan_rec_struct;
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID log_chan_init(VOID);
+EXTERN VOID log_chan_boot_done(VOID);
+EXTERN UINT8 log_chan_enter(UINT8 chan);
+EXTERN VOID log_chan_exit(UINT8 prev_chan);
+EXTERN UINT8 log_chan_oc_cmd_chan_get(UINT8 cmd_id);
+EXTERN UINT8 log_chan_twi_cmd_chan_get(UINT8 cmd_id);
+EXTERN VOID log_chan_put(const CHAR *buf_ptr, UINT32 len, BOOL crash);
+EXTERN BOOL log_chan_uart_get(VOID);
+EXTERN UINT32 log_chan_size_get(UINT8 chan);
+EXTERN UINT32 log_chan_get(UINT8 chan, CHAR *dst_ptr, UINT32 len);
+EXTERN BOOL log_chan_rec_next(const CHAR *buf_ptr,
+                              UINT32 len,
+                              UINT32 *offset_ptr,
+                              log_chan_rec_struct *rec_ptr);
+EXTERN UINT32 log_chan_read(CHAR *dst_ptr,
+                            UINT32 len,
+                            CHAR *scratch_ptr,
+                            UINT32 scratch_len);
+EXTERN VOID log_chan_crash_dump_register(VOID);
+
+#endif /* _LOG_CHAN_H */
+
+/** @} end addtogroup */
+
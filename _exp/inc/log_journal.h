@@ -0,0 +1,135 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LOG_JOURNAL
+* @{
+* @file
+* @brief
+*    Append-only log journal kept in a range of SPI flash subsectors.
+*
+* @note
+*    Records are appended to one subsector at a time and the subsectors are
+*    used in rotation, so the oldest subsector is only erased when the
+*    journal needs room. Each record carries a sequence number and a CRC;
+*    on mount the journal is rebuilt from the valid records and the logical
+*    byte stream is the record payloads in sequence order.
+*
+*    SPI flash ECC does not allow a page to be programmed twice and reading
+*    an erased or partially programmed page raises an uncorrectable ECC
+*    error. Records therefore always start on a page boundary, the pages
+*    of a record are programmed once and padded, and flash that may not be
+*    written is only probed with spi_flash_plat_checked_read(). Since a
+*    torn page can not be told from an erased one, the first append after
+*    a mount starts in a freshly erased subsector.
+*/
+
+#ifndef _LOG_JOURNAL_H
+#define _LOG_JOURNAL_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_mid.h"
+
+/*
+* Constants
+*/
+
+#define LOG_JOURNAL_MAGIC               0x4A474F4C  /* 'LOGJ' */
+#define LOG_JOURNAL_PAGE_SIZE           256
+#define LOG_JOURNAL_SUBSECTOR_SIZE      (4 * 1024)
+#define LOG_JOURNAL_MAX_SUBSECTORS      16
+
+/* Largest payload of a single record, a record never spans subsectors */
+#define LOG_JOURNAL_MAX_PAYLOAD         (LOG_JOURNAL_SUBSECTOR_SIZE - sizeof(log_journal_hdr_struct))
+
+/* Error codes */
+#define LOG_JOURNAL_ERR_CODE_CREATE(err_suffix)   ((PMCFW_ERR_BASE_LOG_APP) | 0x800 | (err_suffix))
+#define LOG_JOURNAL_ERR_BAD_PARAM                 LOG_JOURNAL_ERR_CODE_CREATE(0x001)
+#define LOG_JOURNAL_ERR_EMPTY                     LOG_JOURNAL_ERR_CODE_CREATE(0x002)
+#define LOG_JOURNAL_ERR_RANGE                     LOG_JOURNAL_ERR_CODE_CREATE(0x003)
+#define LOG_JOURNAL_ERR_READ                      LOG_JOURNAL_ERR_CODE_CREATE(0x004)
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   Header at the start of each record, followed by len bytes of payload.
+*   The record is padded with 0xFF to a whole number of pages.
+*/
+typedef struct
+{
+    UINT32 magic;   /**< LOG_JOURNAL_MAGIC */
+    UINT32 seq;     /**< Record sequence number, starts at 1 */
+    UINT32 len;     /**< Payload length in bytes */
+    UINT32 crc;     /**< CRC32 of seq, len and the payload */
+} log_journal_hdr_struct;
+
+/**
+* @brief
+*   Subsector erase function, must be executable while SPI flash is busy.
+*/
+typedef PMCFW_ERROR (*log_journal_erase_fn_ptr_type)(UINT8* spi_flash_addr, UINT32 num_bytes);
+
+/**
+* @brief
+*   Journal context. Only base_addr, num_subsectors and erase_fn_ptr are
+*   set by log_journal_init(), the rest is rebuilt from flash on first use.
+*/
+typedef struct
+{
+    UINT32 base_addr;                                   /**< Virtual SPI flash address of the first subsector */
+    UINT32 num_subsectors;                              /**< Number of subsectors in the journal */
+    log_journal_erase_fn_ptr_type erase_fn_ptr;         /**< Subsector erase function */
+    BOOL   mounted;                                     /**< Subsector state below is valid */
+    UINT32 head;                                        /**< Subsector being appended to */
+    UINT32 wr_offset;                                   /**< Offset of the next record in the head subsector */
+    UINT32 next_seq;                                    /**< Sequence number of the next record */
+    UINT32 first_seq[LOG_JOURNAL_MAX_SUBSECTORS];       /**< Sequence number of the first record, 0 if none */
+    UINT32 last_seq[LOG_JOURNAL_MAX_SUBSECTORS];        /**< Sequence number of the last record, 0 if none */
+    UINT32 end_offset[LOG_JOURNAL_MAX_SUBSECTORS];      /**< Offset following the last valid record */
+    UINT32 payload_size[LOG_JOURNAL_MAX_SUBSECTORS];    /**< Payload bytes held by the subsector */
+} log_journal_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID log_journal_init(log_journal_struct *journal_ptr,
+                             UINT32 base_addr,
+                             UINT32 size,
+                             log_journal_erase_fn_ptr_type erase_fn_ptr);
+EXTERN PMCFW_ERROR log_journal_append(log_journal_struct *journal_ptr,
+                                      UINT8 *src_ptr,
+                                      UINT32 len);
+EXTERN UINT32 log_journal_size_get(log_journal_struct *journal_ptr);
+EXTERN PMCFW_ERROR log_journal_read(log_journal_struct *journal_ptr,
+                                    UINT8 *dst_ptr,
+                                    UINT32 offset,
+                                    UINT32 len);
+EXTERN PMCFW_ERROR log_journal_erase(log_journal_struct *journal_ptr);
+
+#endif /* _LOG_JOURNAL_H */
+
+/** @} end addtogroup */
+
+
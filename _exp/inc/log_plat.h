@@ -24,6 +24,7 @@
 #include "pmcfw_types.h"
 #include "pmcfw_err.h"
 #include "log_plat_cfg.h"
+#include "log_app_api.h"
 
 /*
 ** Enumerated Types
@@ -192,6 +193,9 @@ EXTERN void log_mem_clear(UINT32 log_mem_size,
                           void  *log_mem_addr);
 EXTERN VOID log_plat_init(VOID);
 EXTERN PMCFW_ERROR log_spi_flash_store(VOID);
+EXTERN PMCFW_ERROR log_spi_flash_entries_append(log_app_entry_struct* entry_ptr,
+                                                UINT32 num_entries);
+EXTERN PMCFW_ERROR log_spi_flash_chan_store(VOID);
 EXTERN VOID log_plat_ram_code_ptr_adjust(UINT32 offset);
 
 #endif /* _LOG_PLAT_H */
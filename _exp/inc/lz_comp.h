@@ -0,0 +1,90 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LZ_COMP
+* @{
+* @file
+* @brief
+*    Block compressor producing the sequence stream read by lz_decomp.
+*
+* @note
+*    Each block is compressed on its own with a single probe hash table,
+*    optionally against a small preset dictionary that is treated as if it
+*    preceded the block. The decoder must be given the same dictionary
+*    with lz_decomp_dict_set(). Compression trades ratio for a bounded
+*    and small RAM footprint so it can run in exception context.
+*/
+
+#ifndef _LZ_COMP_H
+#define _LZ_COMP_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "lz_decomp.h"
+
+/*
+* Constants
+*/
+
+/* Largest dictionary plus block length, positions are kept as UINT16 */
+#define LZ_COMP_MAX_SPAN                0xFFFF
+
+/* Hash table slot holding no position */
+#define LZ_COMP_HASH_EMPTY              0xFFFF
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   Compressor context.
+*/
+typedef struct
+{
+    const UINT8 *dict_ptr;              /**< Preset dictionary, NULL if none */
+    UINT32 dict_len;                    /**< Dictionary length */
+    UINT16 *hash_ptr;                   /**< Hash table, 2^hash_log2 entries */
+    UINT32 hash_log2;                   /**< log2 of the number of hash table entries */
+    UINT32 window_size;                 /**< Largest match offset, the decoder window size */
+} lz_comp_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID lz_comp_init(lz_comp_struct *ctx_ptr,
+                         const UINT8 *dict_ptr,
+                         UINT32 dict_len,
+                         UINT16 *hash_ptr,
+                         UINT32 hash_log2,
+                         UINT32 window_size);
+EXTERN UINT32 lz_comp_block(lz_comp_struct *ctx_ptr,
+                            const UINT8 *src_ptr,
+                            UINT32 src_len,
+                            UINT8 *dst_ptr,
+                            UINT32 dst_size);
+
+#endif /* _LZ_COMP_H */
+
+/** @} end addtogroup */
+
+
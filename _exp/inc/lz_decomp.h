@@ -0,0 +1,142 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LZ_DECOMP
+* @{
+* @file
+* @brief
+*    Streaming decompressor for LZ4-style sequence streams with a bounded
+*    history window.
+*
+* @note
+*    The stream is a series of LZ4 block sequences (token, literal length
+*    extension, literals, 16-bit little endian offset, match length
+*    extension). Offsets are limited to the window size chosen by the
+*    packer so that decoding only needs a small caller supplied history
+*    buffer rather than the whole output image. Input and output may be
+*    supplied in arbitrary sized pieces; decoding state is kept in
+*    lz_decomp_struct between calls.
+*
+*    lz_decomp_buf() decodes a whole stream in one call into an output
+*    buffer that holds the complete image, which then serves as the history
+*    window, against a dictionary that stays where it is (e.g. in flash).
+*/
+
+#ifndef _LZ_DECOMP_H
+#define _LZ_DECOMP_H
+
+/*
+* Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+* Constants
+*/
+
+/* Minimum match length encoded by a token */
+#define LZ_DECOMP_MIN_MATCH             4
+
+/* Token nibble value indicating that extension bytes follow */
+#define LZ_DECOMP_LEN_EXT               15
+
+/*
+* Enumerated Types
+*/
+
+/**
+* @brief
+*   Decoder state machine states.
+*/
+typedef enum
+{
+    LZ_DECOMP_STATE_TOKEN = 0,          /**< Expecting a sequence token */
+    LZ_DECOMP_STATE_LITERAL_LEN,        /**< Expecting literal length extension bytes */
+    LZ_DECOMP_STATE_LITERALS,           /**< Copying literal bytes */
+    LZ_DECOMP_STATE_OFFSET_LO,          /**< Expecting low byte of the match offset */
+    LZ_DECOMP_STATE_OFFSET_HI,          /**< Expecting high byte of the match offset */
+    LZ_DECOMP_STATE_MATCH_LEN,          /**< Expecting match length extension bytes */
+    LZ_DECOMP_STATE_MATCH_COPY,         /**< Copying match bytes out of the window */
+    LZ_DECOMP_STATE_DONE,               /**< All expected output has been produced */
+} lz_decomp_state_enum;
+
+/**
+* @brief
+*   Decoder return status.
+*/
+typedef enum
+{
+    LZ_DECOMP_STATUS_NEED_INPUT = 0,    /**< Input exhausted, call again with more input */
+    LZ_DECOMP_STATUS_OUTPUT_FULL,       /**< Output buffer full, call again with more output space */
+    LZ_DECOMP_STATUS_DONE,              /**< Expected output length reached */
+    LZ_DECOMP_STATUS_ERR_OFFSET,        /**< Match offset is zero or outside the window */
+    LZ_DECOMP_STATUS_ERR_OVERRUN,       /**< Stream decodes to more than the expected length */
+} lz_decomp_status_enum;
+
+/*
+* Structures and Unions
+*/
+
+/**
+* @brief
+*   Streaming decoder context.
+*/
+typedef struct
+{
+    UINT8  *window_ptr;                 /**< History buffer, size is a power of 2 */
+    UINT32 window_mask;                 /**< Window size - 1 */
+    UINT32 dict_len;                    /**< Preset dictionary bytes at the start of the window */
+    UINT32 out_total;                   /**< Number of bytes decoded so far */
+    UINT32 out_expected;                /**< Total number of bytes the stream decodes to */
+    UINT32 literal_len;                 /**< Remaining literal bytes in the current sequence */
+    UINT32 match_len;                   /**< Remaining match bytes in the current sequence */
+    UINT32 match_offset;                /**< Offset of the current match */
+    BOOL   match_len_ext;               /**< Match length extension bytes follow the offset */
+    lz_decomp_state_enum state;         /**< Current decoder state */
+} lz_decomp_struct;
+
+/*
+* Function Prototypes
+*/
+
+EXTERN VOID lz_decomp_init(lz_decomp_struct *ctx_ptr,
+                           UINT8 *window_ptr,
+                           UINT32 window_size,
+                           UINT32 out_expected);
+EXTERN VOID lz_decomp_dict_set(lz_decomp_struct *ctx_ptr,
+                               const UINT8 *dict_ptr,
+                               UINT32 dict_len);
+EXTERN lz_decomp_status_enum lz_decomp_run(lz_decomp_struct *ctx_ptr,
+                                           const UINT8 **in_pptr,
+                                           UINT32 *in_len_ptr,
+                                           UINT8 *out_ptr,
+                                           UINT32 out_size,
+                                           UINT32 *out_len_ptr);
+EXTERN lz_decomp_status_enum lz_decomp_buf(const UINT8 *in_ptr,
+                                           UINT32 in_len,
+                                           const UINT8 *dict_ptr,
+                                           UINT32 dict_len,
+                                           UINT8 *out_ptr,
+                                           UINT32 out_len);
+
+#endif /* _LZ_DECOMP_H */
+
+/** @} end addtogroup */
+
+
@@ -154,6 +154,74 @@
 */
 #define EXPLORER_BRINGUP     0
 
+/*
+** Use for Explorer bringup to calculate the DDR controller and PHY configuration
+** from the DIMM SPD, read from 7-bit address EXPLORER_DDR_SPD_TWI_ADDR on the TWI
+** master port, at the data rate of the hard-coded configuration. The calculated
+** configuration is compared against the hard-coded one, which is still used if
+** the SPD can not be read or decoded.
+*/
+#define EXPLORER_DDR_SPD_CALC        0
+#define EXPLORER_DDR_SPD_TWI_ADDR    0x50
+
+/*
+** Use for Explorer DDR PHY 2D eye capture. Size of the buffer holding the
+** compressed eyes of the last EXP_FW_DDR_PHY_INIT compressed eye capture. Eyes
+** that do not fit in full are reduced to pass/fail bitmaps, so the buffer must
+** hold at least the center values and a 5 byte bitmap record for each of the
+** 320 eyes of a capture.
+*/
+#define EXPLORER_DDR_PHY_EYE_BUF_SIZE    (12*1024)
+
+/*
+** Use for Explorer DDR PHY training trace. The PHY library prints its trace
+** points and the PMU mailbox messages of verbose training (HdtCtrl) as string
+** indexes, resolved on the host with ddr_trace_decode.py. Set to 0 to keep the
+** messages printed in the DDR log channel out of the UART, so verbose training
+** is not slowed down to the UART rate. They are still kept in the logs.
+*/
+#define EXPLORER_DDR_PHY_TRACE_UART    1
+
+/*
+** Use for Explorer DDR PHY training. Size of the buffer the PMU training
+** firmware images packed by pmu_image_pack.py are decoded into before the
+** PHY library writes them to the PHY. Must hold the largest IMEM image and
+** match DEFAULT_BUF_SIZE in pmu_image_pack.py.
+*/
+#define EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE    (28*1024)
+
+/*
+** Use for Explorer DDR PHY calibration restore. Restored training is checked
+** with short DFI BIST runs at a few sparse addresses in each bank group of
+** each rank, spread so that a run stopped by the time budget (in us) still
+** covers every rank and bank group it can. The PHY is fully trained if a run
+** fails. Set to 0 to trust restored training without a check.
+*/
+#define EXPLORER_DDR_RESTORE_BIST              1
+#define EXPLORER_DDR_RESTORE_BIST_BUDGET_US    5000
+
+/*
+** Use for Explorer DDR PHY delay line updates. After each temperature sensor
+** update a delay line update is run when the hottest DIMM moved by
+** EXPLORER_DDR_DL_UPDATE_TEMP_DELTA since the last one, with a ZQ short
+** calibration when it moved by EXPLORER_DDR_ZQ_UPDATE_TEMP_DELTA since the last
+** calibration, in 1/16 degree C. Updates stall memory traffic and are at least
+** EXPLORER_DDR_DL_UPDATE_MIN_INTERVAL_S seconds apart. Tune with
+** dl_update_sim.py. Set to 0 to only update when the host forces it.
+*/
+#define EXPLORER_DDR_DL_UPDATE                  1
+#define EXPLORER_DDR_DL_UPDATE_TEMP_DELTA       (4*16)
+#define EXPLORER_DDR_ZQ_UPDATE_TEMP_DELTA       (8*16)
+#define EXPLORER_DDR_DL_UPDATE_MIN_INTERVAL_S   10
+
+/*
+** Use for Explorer DDR PHY training. EXP_FW_DDR_PHY_INIT training runs as a
+** main loop task, and the main loop is run from the PHY library waits on the
+** PMU mailbox at most every EXPLORER_DDR_TRAIN_YIELD_INTERVAL_US, so the
+** temperature update and the watchdog keep running during 2D training.
+*/
+#define EXPLORER_DDR_TRAIN_YIELD_INTERVAL_US    1000
+
 /*
 ** Use for Explorer SerDes testing allowing host to set timing phase offset preload.
 ** Field PH_OFS_T_PRELOAD field in OBJECT_PRELOAD_VAL_5 register.
@@ -190,6 +258,61 @@
 */
 #define EXPLORER_ON_CHIP_TEMP_TWI_ACCESS_DISABLE    1
 
+/*
+** Use for Explorer to accept compressed firmware upgrade images (see
+** fw_image_pack.py). Set to 0 to only accept raw images and reclaim the
+** decompression window RAM.
+*/
+#define EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE      1
+
+/*
+** Use for Explorer to track raw firmware upgrade chunks in a flash record
+** so an interrupted download can be resumed by resending only the missing
+** chunks.
+*/
+#define EXPLORER_FW_UPGRADE_RESUME_ENABLE           1
+
+/*
+** Use for Explorer to compress crash dump data as it is written to SPI flash
+** (see crash_dump_plat.h). Decode saved crash dumps with crash_dump_unpack.py.
+*/
+#define EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE      1
+
+/*
+** Use for Explorer to let higher priority interrupts preempt the handlers
+** registered with exp_gic_int_register() (see exp_gic.c).
+*/
+#define EXPLORER_GIC_INT_NESTING_ENABLE             1
+
+/*
+** Use for Explorer to build the VPE0 PC-sampling profiler (see
+** app_fw_pc_prof.h). Decode profiles with pc_prof_collapse.py.
+*/
+#define EXPLORER_PC_PROFILER_ENABLE                 0
+
+/*
+** Use for Explorer to select the messages built into the image (see
+** bc_log.h): 0 none, 1 errors, 2 warnings, 3 information, 4 debug. Messages
+** above the level are compiled out.
+*/
+#define EXPLORER_LOG_LEVEL                          3
+
+/*
+** Use for Explorer to size the per-subsystem log channels in bytes (see
+** log_chan.h). A channel of size 0 is not built. EXPLORER_LOG_CHAN_SAVE_SIZE
+** bounds the saved log entries appended by one log_spi_flash_chan_store().
+** The channels and the buffers of the save must fit in
+** EXPLORER_LOG_CHAN_RAM_BUDGET.
+*/
+#define EXPLORER_LOG_CHAN_FATAL_SIZE                (1*1024)
+#define EXPLORER_LOG_CHAN_BOOT_SIZE                 (2*1024)
+#define EXPLORER_LOG_CHAN_FLASH_SIZE                (1*1024)
+#define EXPLORER_LOG_CHAN_DDR_SIZE                  (2*1024)
+#define EXPLORER_LOG_CHAN_SERDES_SIZE               (1*1024)
+#define EXPLORER_LOG_CHAN_ECH_SIZE                  (1*1024)
+#define EXPLORER_LOG_CHAN_RAM_BUDGET                (12*1024)
+#define EXPLORER_LOG_CHAN_SAVE_SIZE                 (2*1024)
+
 /*
 ** Compile assert if PE BUILD is enabled EXPLORER_BRINGUP flag must also be set.
 */
@@ -111,6 +111,22 @@
 ** Structures and Unions
 */
 
+/**
+* @brief
+*   State and results of the periodic serdes calibration
+*/
+typedef struct
+{
+    UINT8  enabled;             /**< Periodic calibration running */
+    UINT8  initialized;         /**< SerDes initialized */
+    UINT8  last_lane_bitmask;   /**< Lanes of the last calibration */
+    UINT8  reserved;
+    UINT32 run_count;           /**< Calibrations run */
+    UINT32 fail_count;          /**< Calibrations failed */
+    UINT32 last_rc;             /**< Result of the last calibration */
+    UINT32 last_seconds;        /**< Timer0 system seconds of the last calibration */
+} serdes_plat_cal_status_struct;
+
 /*
 ** Global variables
 */
@@ -136,6 +152,7 @@ EXTERN UINT8 serdes_plat_loopback_test(UINT8 lane_bitmask);
 EXTERN VOID serdes_plat_crash_dump_register(VOID);
 EXTERN VOID serdes_plat_initialized_set(BOOL is_initialized);
 EXTERN BOOL serdes_plat_initialized_get(VOID);
+EXTERN VOID serdes_plat_cal_status_get(serdes_plat_cal_status_struct *status_ptr);
 EXTERN UINT32  serdes_plat_lane_inversion_config(UINT8 lane_bitmask, UINT8 * lane_pattern_bitmask);
 EXTERN VOID serdes_plat_ffe_precursor_set(UINT32 precursor);
 EXTERN VOID serdes_plat_ffe_postcursor_set(UINT32 postcursor);
@@ -62,11 +62,13 @@
 #define SPI_FLASH_FW_IMG_A_CFG_LOG_APP_FW_ADDR     SPI_FLASH_FW_IMG_A_CFG_LOG_ADDR
 #define SPI_FLASH_FW_IMG_A_CFG_LOG_APP_FW_SIZE     (16 * 1024)
 #define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED0_ADDR  (SPI_FLASH_FW_IMG_A_CFG_LOG_APP_FW_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_APP_FW_SIZE)
-#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED0_SIZE  (16 * 1024)
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED0_SIZE  (12 * 1024)
 #define SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_ADDR   (SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED0_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED0_SIZE)
-#define SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_SIZE   (4 * 1024)
-#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED1_ADDR  (SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_SIZE)
-#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED1_SIZE  (92 * 1024)
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_SIZE   (8 * 1024)      /* two 4K calibration slots */
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_ADDR    (SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_TRAINING_SIZE)
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_SIZE    (64 * 1024)
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED1_ADDR  (SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_SIZE)
+#define SPI_FLASH_FW_IMG_A_CFG_LOG_RESERVED1_SIZE  (28 * 1024)
 
 #define SPI_FLASH_FW_RESERVED_ADDR                 (SPI_FLASH_FW_IMG_A_CFG_LOG_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_SIZE)
 #define SPI_FLASH_FW_RESERVED_SIZE                 (2 * 1024)
@@ -81,11 +83,13 @@
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_APP_FW_ADDR     SPI_FLASH_FW_IMG_B_CFG_LOG_ADDR
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_APP_FW_SIZE     (16 * 1024)
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED0_ADDR  (SPI_FLASH_FW_IMG_B_CFG_LOG_APP_FW_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_APP_FW_SIZE)
-#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED0_SIZE  (16 * 1024)
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED0_SIZE  (12 * 1024)
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_ADDR   (SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED0_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED0_SIZE)
-#define SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_SIZE   (4 * 1024)
-#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED1_ADDR  (SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_SIZE)
-#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED1_SIZE  (92 * 1024)
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_SIZE   (8 * 1024)      /* two 4K calibration slots */
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_ADDR    (SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_TRAINING_SIZE)
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_SIZE    (64 * 1024)
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED1_ADDR  (SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_SIZE)
+#define SPI_FLASH_FW_IMG_B_CFG_LOG_RESERVED1_SIZE  (28 * 1024)
 
 #define SPI_FLASH_FW_FW_UPGRADE_ADDR               (SPI_FLASH_FW_IMG_B_CFG_LOG_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_SIZE)
 #define SPI_FLASH_FW_FW_UPGRADE_SIZE               (1024 * 1024)
@@ -93,8 +97,10 @@
 #define SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_SIZE (256 * 1024)
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_ADDR (SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_ADDR + SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_SIZE)
 #define SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_SIZE (256 * 1024)
-#define SPI_FLASH_UNUSED_ADDR                      (SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_SIZE)
-#define SPI_FLASH_UNUSED_SIZE                      (504 * 1024)
+#define SPI_FLASH_FW_FW_UPGRADE_RECORD_ADDR        (SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_ADDR + SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_SIZE)
+#define SPI_FLASH_FW_FW_UPGRADE_RECORD_SIZE        (8 * 1024)
+#define SPI_FLASH_UNUSED_ADDR                      (SPI_FLASH_FW_FW_UPGRADE_RECORD_ADDR + SPI_FLASH_FW_FW_UPGRADE_RECORD_SIZE)
+#define SPI_FLASH_UNUSED_SIZE                      (496 * 1024)
 #define SPI_FLASH_FW_END_ADDR                      (SPI_FLASH_UNUSED_ADDR + SPI_FLASH_UNUSED_SIZE)
 
 /*
@@ -152,6 +158,7 @@ typedef struct
 EXTERN VOID spi_flash_plat_red_fw_image_update(VOID);
 EXTERN PMCFW_ERROR spi_flash_plat_erase(UINT8* spi_flash_addr_ptr, UINT32 num_bytes);
 EXTERN VOID spi_flash_plat_image_info_get(spi_flash_plat_auth_info_struct * spi_flash_plat_auth_info);
+EXTERN BOOL spi_flash_plat_checked_read(UINT8* dst_ptr, UINT8* spi_flash_addr_ptr, UINT32 num_bytes);
 
 #endif /* _SPI_FLASH_PLAT_H */
 
@@ -34,6 +34,18 @@
 ** Enumerated Types 
 */
 
+/**
+* @brief
+*   Temperature sensors reported in the OCMB thermal registers
+*/
+typedef enum
+{
+    TEMP_SENSOR_PLAT_DIMM0 = 0,     /**< On board sensor of DIMM0 */
+    TEMP_SENSOR_PLAT_DIMM1,         /**< On board sensor of DIMM1 */
+    TEMP_SENSOR_PLAT_ONCHIP,        /**< On chip sensor */
+    TEMP_SENSOR_PLAT_NUM
+} temp_sensor_plat_sensor_enum;
+
 
 /*
 ** Constants 
@@ -63,6 +75,11 @@
 #define TEMP_ERR_CODE_CREATE(err_suffix)            ((PMCFW_ERR_BASE_TEMP) | (err_suffix))
 #define TEMP_ERR_SWITCH_CHANNEL_ID_INVALID          TEMP_ERR_CODE_CREATE(0x001)
 
+/* Reading flags, as reported in the OCMB thermal registers */
+#define TEMP_SENSOR_PLAT_FLAG_VALID                 0x01
+#define TEMP_SENSOR_PLAT_FLAG_PRESENT               0x02
+#define TEMP_SENSOR_PLAT_FLAG_ERROR                 0x04
+
 /*
 ** Macro Definitions
 */
@@ -71,6 +88,18 @@
 ** Structures and Unions
 */
 
+/**
+* @brief
+*   Last reading of a sensor
+*/
+typedef struct
+{
+    UINT16 temp;        /**< Temperature as written to the OCMB thermal register */
+    UINT8  flags;       /**< TEMP_SENSOR_PLAT_FLAG_xxx */
+    UINT8  reserved;
+    UINT32 seconds;     /**< Timer0 system seconds of the update */
+} temp_sensor_plat_reading_struct;
+
 /*
 ** Global variables
 */
@@ -82,6 +111,8 @@
 
 EXTERN PMCFW_ERROR temp_sensor_plat_init(VOID);
 EXTERN VOID temp_sensor_plat_update(VOID);
+EXTERN VOID temp_sensor_plat_reading_get(temp_sensor_plat_sensor_enum sensor,
+                                         temp_sensor_plat_reading_struct *reading_ptr);
 
 
 #endif /* _TEMP_SENSOR_PLAT_H */
@@ -28,6 +28,7 @@
 /*
 ** Include Files
 */
+#include <string.h>
 #include "exp_gic.h"
 
 #include "pmcfw_types.h"
@@ -36,82 +37,368 @@
 #include "app_fw.h"
 
 #include "bc_printf.h"
+#include "pmcfw_common.h"
+#include "pmc_profile.h"
+#include "cmdsvr_plat_cfg.h"
+
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_func_api.h"
+#endif
 
 #define PMC_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
+/*
+** Constants
+*/
+
+/* CP0 registers and Status bits used by the nesting dispatcher */
+#define EXP_GIC_CP0_STATUS              12
+#define EXP_GIC_CP0_EPC                 14
+#define EXP_GIC_CP0_STATUS_IE           0x00000001
+#define EXP_GIC_CP0_STATUS_EXL          0x00000002
+
+/*
+** GIC vector priority N is signalled on CPU hardware interrupt N, which is
+** Status.IM[2 + N]. Mask of the given priority level and all levels below.
+*/
+#define EXP_GIC_CP0_STATUS_IM_SHIFT     10
+#define EXP_GIC_CP0_STATUS_IM_MASK(prio) \
+    ((((UINT32)1 << ((prio) + 1)) - 1) << EXP_GIC_CP0_STATUS_IM_SHIFT)
+
+/* Number of CP0 Count ticks to wait for a latency probe to be taken */
+#define EXP_GIC_PROBE_TIMEOUT           0x100000
+
+/* Number of samples per probe taken by the gic_lat command */
+#define EXP_GIC_PROBE_CMD_SAMPLES       16
+
 /*
 ** Global variables
 */
 PRIVATE const cicint_config_struct exp_cicint_cfg[] =
-{  /*   INT Signal                           Destination Type      Destination VPE     Priority(1 = lowest)  Trigger Type*/
-    CICINT_CFG(FOXHOUND_LANE_0,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 0  */
-    CICINT_CFG(FOXHOUND_LANE_1,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 1  */
-    CICINT_CFG(FOXHOUND_LANE_2,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 2  */
-    CICINT_CFG(FOXHOUND_LANE_3,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 3  */
-    CICINT_CFG(FOXHOUND_LANE_4,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 4  */
-    CICINT_CFG(FOXHOUND_LANE_5,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 5  */
-    CICINT_CFG(FOXHOUND_LANE_6,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 6  */
-    CICINT_CFG(FOXHOUND_LANE_7,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 7  */
-    CICINT_CFG(FOXHOUND_NON_FATAL,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 8  */
-    CICINT_CFG(FOXHOUND_FATAL,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 9  */
-    CICINT_CFG(DDR4_PHY,             HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 10 */
-    CICINT_CFG(DDR4_PHY_NON_FATAL,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 11 */
-    CICINT_CFG(DDR4_PHY_FATAL,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 12 */
-    CICINT_CFG(TOP_DIGITAL_IO,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 13 */
-    CICINT_CFG(OCMB_IP_INT_0,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 14 */
-    CICINT_CFG(OCMB_IP_INT_1,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 15 */
-    CICINT_CFG(OCMB_IP_INT_2,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 16 */
-    CICINT_CFG(OCMB_IP_INT_3,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 17 */
-    CICINT_CFG(OCMB_IP_INT_4,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 18 */
-    CICINT_CFG(OCMB_IP_INT_5,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 19 */
-    CICINT_CFG(OCMB_IP_INT_6,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 20 */
-    CICINT_CFG(OCMB_IP_INT_7,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 21 */
-    CICINT_CFG(TWI_0_M,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 22 */
-    CICINT_CFG(TWI_0_S,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 23 */
-    CICINT_CFG(TWI_1_M,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 24 */
-    CICINT_CFG(TWI_1_S,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 25 */
-    CICINT_CFG(GPIO_INT_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 26 */
-    CICINT_CFG(GPIO_INT_1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 27 */
-    CICINT_CFG(GPIO_INT_2,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 28 */
-    CICINT_CFG(GPIO_INT_3,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 29 */
-    CICINT_CFG(UART_INT_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 30 */
-    CICINT_CFG(SPI_INT_0,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 31 */
-    CICINT_CFG(WDT_INT,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 32 */
-    CICINT_CFG(GPBC_FATAL_ERROR,     HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 33 */
-    CICINT_CFG(GPBC_NON_FATAL_ERROR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 34 */
-    CICINT_CFG(GPBC_DEBUG,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 35 */
-    CICINT_CFG(SYS_DCSU_INT,         HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 36 */
-    CICINT_CFG(TOP_FATAL,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 37 */
-    CICINT_CFG(TOP_NON_FATAL,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 38 */
-    CICINT_CFG(FAIL_N,               HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 39 */
-    CICINT_CFG(EFUSE_IRQ,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 40 */
-    CICINT_CFG(EFUSE_ECC_SINGLE_ERR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 41 */
-    CICINT_CFG(EFUSE_ECC_DOUBLE_ERR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 42 */
-    CICINT_CFG(SPCS_TS_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 43 */
-    CICINT_CFG(SPCS_VM_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 44 */
-    CICINT_CFG(SPCS_PD_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 45 */
-    CICINT_CFG(SAVE_N,               HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 46 */
-    CICINT_CFG(PCSE_IRQ_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 47 */
-    CICINT_CFG(PCSE_IRQ_1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 48 */
-    CICINT_CFG(MIPS_DOORBELL_XCBI,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 49 */
-    CICINT_CFG(OCMB_IP_INT_8,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 50 */
-    CICINT_CFG(OCMB_IP_INT_9,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 51 */
-    CICINT_CFG(OCMB_IP_INT_10,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 52 */
-    CICINT_CFG(OCMB_IP_INT_11,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 53 */
-    CICINT_CFG(OPSW_CR_I,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 54 */
-    CICINT_CFG(OPSW_CR_I1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 55 */
-    CICINT_CFG(TIMER_0_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 56 */
-    CICINT_CFG(TIMER_1_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 57 */
-    CICINT_CFG(TIMER_2_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 58 */
-    CICINT_CFG(TIMER_3_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_1, HAL_GIC_INT_TRIGGER_EDGE ), /* External Pin 59 */
-    CICINT_CFG(EXP_INT_RESERVED_0,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_0,  HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 60 */
-    CICINT_CFG(EXP_INT_RESERVED_1,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_0,  HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 61 */
-    CICINT_CFG(EXP_INT_RESERVED_2,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_0,  HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 62 */
-    CICINT_CFG(EXP_INT_RESERVED_3,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, HAL_GIC_VEC_PRIO_0,  HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 63 */
+{  /*   INT Signal                           Destination Type      Destination VPE     Priority(5 = highest) Trigger Type*/
+    CICINT_CFG(FOXHOUND_LANE_0,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 0  */
+    CICINT_CFG(FOXHOUND_LANE_1,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 1  */
+    CICINT_CFG(FOXHOUND_LANE_2,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 2  */
+    CICINT_CFG(FOXHOUND_LANE_3,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 3  */
+    CICINT_CFG(FOXHOUND_LANE_4,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 4  */
+    CICINT_CFG(FOXHOUND_LANE_5,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 5  */
+    CICINT_CFG(FOXHOUND_LANE_6,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 6  */
+    CICINT_CFG(FOXHOUND_LANE_7,      HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 7  */
+    CICINT_CFG(FOXHOUND_NON_FATAL,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 8  */
+    CICINT_CFG(FOXHOUND_FATAL,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 9  */
+    CICINT_CFG(DDR4_PHY,             HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 10 */
+    CICINT_CFG(DDR4_PHY_NON_FATAL,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 11 */
+    CICINT_CFG(DDR4_PHY_FATAL,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 12 */
+    CICINT_CFG(TOP_DIGITAL_IO,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 13 */
+    CICINT_CFG(OCMB_IP_INT_0,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 14 */
+    CICINT_CFG(OCMB_IP_INT_1,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 15 */
+    CICINT_CFG(OCMB_IP_INT_2,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 16 */
+    CICINT_CFG(OCMB_IP_INT_3,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 17 */
+    CICINT_CFG(OCMB_IP_INT_4,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 18 */
+    CICINT_CFG(OCMB_IP_INT_5,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 19 */
+    CICINT_CFG(OCMB_IP_INT_6,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 20 */
+    CICINT_CFG(OCMB_IP_INT_7,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 21 */
+    CICINT_CFG(TWI_0_M,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 22 */
+    CICINT_CFG(TWI_0_S,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 23 */
+    CICINT_CFG(TWI_1_M,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 24 */
+    CICINT_CFG(TWI_1_S,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_1, EXP_GIC_PRIO_TWI_SLAVE,  HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 25 */
+    CICINT_CFG(GPIO_INT_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 26 */
+    CICINT_CFG(GPIO_INT_1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 27 */
+    CICINT_CFG(GPIO_INT_2,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 28 */
+    CICINT_CFG(GPIO_INT_3,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 29 */
+    CICINT_CFG(UART_INT_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_UART,       HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 30 */
+    CICINT_CFG(SPI_INT_0,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 31 */
+    CICINT_CFG(WDT_INT,              HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 32 */
+    CICINT_CFG(GPBC_FATAL_ERROR,     HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 33 */
+    CICINT_CFG(GPBC_NON_FATAL_ERROR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 34 */
+    CICINT_CFG(GPBC_DEBUG,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 35 */
+    CICINT_CFG(SYS_DCSU_INT,         HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 36 */
+    CICINT_CFG(TOP_FATAL,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 37 */
+    CICINT_CFG(TOP_NON_FATAL,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 38 */
+    CICINT_CFG(FAIL_N,               HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 39 */
+    CICINT_CFG(EFUSE_IRQ,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 40 */
+    CICINT_CFG(EFUSE_ECC_SINGLE_ERR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 41 */
+    CICINT_CFG(EFUSE_ECC_DOUBLE_ERR, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 42 */
+    CICINT_CFG(SPCS_TS_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 43 */
+    CICINT_CFG(SPCS_VM_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 44 */
+    CICINT_CFG(SPCS_PD_IRQ,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 45 */
+    CICINT_CFG(SAVE_N,               HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 46 */
+    CICINT_CFG(PCSE_IRQ_0,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 47 */
+    CICINT_CFG(PCSE_IRQ_1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 48 */
+    CICINT_CFG(MIPS_DOORBELL_XCBI,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 49 */
+    CICINT_CFG(OCMB_IP_INT_8,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 50 */
+    CICINT_CFG(OCMB_IP_INT_9,        HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 51 */
+    CICINT_CFG(OCMB_IP_INT_10,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 52 */
+    CICINT_CFG(OCMB_IP_INT_11,       HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_LEVEL ), /* External Pin 53 */
+    CICINT_CFG(OPSW_CR_I,            HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 54 */
+    CICINT_CFG(OPSW_CR_I1,           HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 55 */
+    CICINT_CFG(TIMER_0_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_TIMER,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 56 */
+    CICINT_CFG(TIMER_1_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_TIMER,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 57 */
+    CICINT_CFG(TIMER_2_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 58 */
+    CICINT_CFG(TIMER_3_INT,          HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_TIMER,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 59 */
+    CICINT_CFG(EXP_INT_RESERVED_0,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_FATAL,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 60 */
+    CICINT_CFG(EXP_INT_RESERVED_1,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_UART,       HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 61 */
+    CICINT_CFG(EXP_INT_RESERVED_2,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_TIMER,      HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 62 */
+    CICINT_CFG(EXP_INT_RESERVED_3,   HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_DEFAULT,    HAL_GIC_INT_TRIGGER_EDGE  ), /* External Pin 63 */
 };
 
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+/* CP0 Count/Compare of VPE0, the PC-sampling profiler timer (app_fw_pc_prof.c) */
+PRIVATE const cicint_config_local_struct exp_cicint_local_cfg[] =
+{  /*   Local INT                 Destination Type          Destination VPE         Priority */
+    CICINT_LOCAL_CFG(HAL_GIC_LOCAL_INT_CMP, HAL_GIC_INT_DEST_VPE_PIN, HAL_GIC_INT_DEST_VPE_0, EXP_GIC_PRIO_TIMER)
+};
+#endif
+
 EXTERN UINT32 __ghsbegin_image_vec_tlb_ref[];
 
+/*
+** Local Structures and Unions
+*/
+
+/* Handler registered through exp_gic_int_register() */
+typedef struct
+{
+    cicint_cback_fcn_ptr     cback_ptr;
+    void                    *cback_arg;
+    exp_gic_int_stats_struct stats;
+} exp_gic_handler_struct;
+
+/* Assert to handler latency of one probe, CP0 Count ticks */
+typedef struct
+{
+    UINT32 count;
+    UINT32 min_cycles;
+    UINT32 max_cycles;
+    UINT32 total_cycles;
+} exp_gic_latency_stats_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE exp_gic_handler_struct exp_gic_handler[EXP_NUM_INTERRUPTS];
+
+/* Handler depth on VPE0 and ticks spent in preempting handlers */
+PRIVATE volatile UINT32 exp_gic_nest_depth;
+PRIVATE volatile UINT32 exp_gic_nested_cycles;
+
+/* Latency probe state */
+PRIVATE exp_gic_latency_stats_struct exp_gic_latency[EXP_GIC_PROBE_NUM];
+PRIVATE volatile UINT32 exp_gic_probe_trigger_time;
+PRIVATE volatile BOOL exp_gic_probe_taken;
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR exp_gic_cmd_stat(CHAR **args, UINT8 num_args);
+PRIVATE PMCFW_ERROR exp_gic_cmd_lat(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the GIC module */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct exp_gic_cmd_set[] = {
+    {
+        "gic_stat",
+        "Show interrupt handler and latency statistics",
+        exp_gic_cmd_stat,
+        "Cmd Usage: gic_stat\n",
+        FALSE
+    },
+    {
+        "gic_lat",
+        "Measure interrupt latency per priority level",
+        exp_gic_cmd_lat,
+        "Cmd Usage: gic_lat\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_isr
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Dispatcher for handlers registered with exp_gic_int_register(). Counts
+*   and times the handler. With EXPLORER_GIC_INT_NESTING_ENABLE the handler
+*   runs with interrupts enabled for the priority levels above its own, so
+*   a higher priority source is serviced without waiting for it.
+*
+* INPUTS:
+*   cback_arg - interrupt number.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   The CP0 Status and EPC of the interrupted context are saved before
+*   interrupts are enabled and restored with interrupts disabled, since a
+*   nested exception overwrites them. The source itself stays masked until
+*   the handler has cleared it. Time spent in handlers that preempted this
+*   one is not accounted to it.
+*
+*****************************************************************************/
+PRIVATE void exp_gic_isr(void *cback_arg)
+{
+    UINT32 int_num = (UINT32)cback_arg;
+    exp_gic_handler_struct *handler_ptr = &exp_gic_handler[int_num];
+    UINT32 nested_start = exp_gic_nested_cycles;
+    UINT32 inner_cycles;
+    UINT32 start;
+    UINT32 cycles;
+#if (EXPLORER_GIC_INT_NESTING_ENABLE == 1)
+    UINT32 status = hal_coprocessor_read(EXP_GIC_CP0_STATUS, 0);
+    UINT32 epc = hal_coprocessor_read(EXP_GIC_CP0_EPC, 0);
+#endif
+
+    if (0 != exp_gic_nest_depth)
+    {
+        handler_ptr->stats.nested_count++;
+    }
+    exp_gic_nest_depth++;
+
+#if (EXPLORER_GIC_INT_NESTING_ENABLE == 1)
+    hal_coprocessor_write(EXP_GIC_CP0_STATUS,
+                          0,
+                          (status & ~(EXP_GIC_CP0_STATUS_IM_MASK(exp_cicint_cfg[int_num].prio) | EXP_GIC_CP0_STATUS_EXL)) |
+                          EXP_GIC_CP0_STATUS_IE);
+#endif
+
+    start = hal_cp0_counter_get();
+    handler_ptr->cback_ptr(handler_ptr->cback_arg);
+    cycles = hal_cp0_counter_get() - start;
+
+#if (EXPLORER_GIC_INT_NESTING_ENABLE == 1)
+    /* EXL is set again before EPC is restored */
+    hal_coprocessor_write(EXP_GIC_CP0_STATUS, 0, status);
+    hal_coprocessor_write(EXP_GIC_CP0_EPC, 0, epc);
+#endif
+
+    exp_gic_nest_depth--;
+    inner_cycles = exp_gic_nested_cycles - nested_start;
+    exp_gic_nested_cycles = nested_start + cycles;
+    cycles -= inner_cycles;
+
+    handler_ptr->stats.count++;
+    handler_ptr->stats.total_cycles += cycles;
+    if (cycles > handler_ptr->stats.max_cycles)
+    {
+        handler_ptr->stats.max_cycles = cycles;
+    }
+} /* End: exp_gic_isr() */
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_probe_isr
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Handler of the latency probe interrupts. Records the time from the
+*   software trigger to the handler.
+*
+* INPUTS:
+*   cback_arg - probe index.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   Registered with exp_gic_int_register(), so the latency includes the
+*   dispatcher entry seen by every other registered handler.
+*
+*****************************************************************************/
+PRIVATE void exp_gic_probe_isr(void *cback_arg)
+{
+    UINT32 probe = (UINT32)cback_arg;
+    UINT32 cycles = hal_cp0_counter_get() - exp_gic_probe_trigger_time;
+    exp_gic_latency_stats_struct *lat_ptr = &exp_gic_latency[probe];
+
+    hal_gic_edge_int_trigger_clear(EXP_GIC_PROBE_INT_FIRST + probe);
+
+    if ((0 == lat_ptr->count) || (cycles < lat_ptr->min_cycles))
+    {
+        lat_ptr->min_cycles = cycles;
+    }
+    if (cycles > lat_ptr->max_cycles)
+    {
+        lat_ptr->max_cycles = cycles;
+    }
+    lat_ptr->total_cycles += cycles;
+    lat_ptr->count++;
+
+    exp_gic_probe_taken = TRUE;
+} /* End: exp_gic_probe_isr() */
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/****************************************************************************
+*
+* FUNCTION: exp_gic_cmd_stat
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Command server handler to show the interrupt statistics.
+*
+* INPUTS:
+*   args     - command arguments.
+*   num_args - number of arguments.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   PMC_SUCCESS.
+*
+* NOTES:
+*   None.
+*
+*****************************************************************************/
+PRIVATE PMCFW_ERROR exp_gic_cmd_stat(CHAR **args, UINT8 num_args)
+{
+    exp_gic_stats_print();
+
+    return PMC_SUCCESS;
+} /* End: exp_gic_cmd_stat() */
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_cmd_lat
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Command server handler to measure the latency of each priority level.
+*
+* INPUTS:
+*   args     - command arguments.
+*   num_args - number of arguments.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   PMC_SUCCESS.
+*
+* NOTES:
+*   None.
+*
+*****************************************************************************/
+PRIVATE PMCFW_ERROR exp_gic_cmd_lat(CHAR **args, UINT8 num_args)
+{
+    if (FALSE == exp_gic_latency_probe(EXP_GIC_PROBE_CMD_SAMPLES))
+    {
+        bc_printf("gic_lat: probe interrupt not taken\n");
+    }
+    exp_gic_stats_print();
+
+    return PMC_SUCCESS;
+} /* End: exp_gic_cmd_lat() */
+#endif
+
 /****************************************************************************
 *
 * FUNCTION: exp_gic_init
@@ -135,7 +422,32 @@ EXTERN UINT32 __ghsbegin_image_vec_tlb_ref[];
 *****************************************************************************/
 PUBLIC void exp_gic_init(void)
 {
+    UINT32 probe;
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+#endif
+
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+    cicint_init(exp_cicint_cfg, PMC_ARRAY_SIZE(exp_cicint_cfg), exp_cicint_local_cfg, PMC_ARRAY_SIZE(exp_cicint_local_cfg));
+#else
     cicint_init(exp_cicint_cfg, PMC_ARRAY_SIZE(exp_cicint_cfg), NULL, 0);
+#endif
+
+    memset(exp_gic_handler, 0, sizeof(exp_gic_handler));
+    memset(exp_gic_latency, 0, sizeof(exp_gic_latency));
+    exp_gic_nest_depth = 0;
+    exp_gic_nested_cycles = 0;
+
+    for (probe = 0; probe < EXP_GIC_PROBE_NUM; probe++)
+    {
+        exp_gic_int_register(EXP_GIC_PROBE_INT_FIRST + probe, exp_gic_probe_isr, (void *)probe);
+        cicint_int_enable(EXP_GIC_PROBE_INT_FIRST + probe);
+    }
+
+#if (CMDSVR_REG_COMMANDS == 1)
+    rv = cmdsvr_func_list_register(exp_gic_cmd_set, PMC_ARRAY_SIZE(exp_gic_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
 
     /* Register this core as core 0 */
     cicint_set_core(0);
@@ -150,4 +462,197 @@ PUBLIC void exp_gic_init(void)
     hal_int_global_enable();
 } /* End: exp_gic_init() */
 
+/****************************************************************************
+*
+* FUNCTION: exp_gic_int_register
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Registers an interrupt handler through the timing dispatcher, and with
+*   EXPLORER_GIC_INT_NESTING_ENABLE lets higher priority sources preempt it.
+*   Used in place of cicint_int_register() for VPE0 sources.
+*
+* INPUTS:
+*   int_num   - interrupt number.
+*   cback_ptr - handler.
+*   cback_arg - handler argument.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   The handler must clear its source before it returns. With nesting it
+*   runs with EXL cleared and interrupts enabled, so handlers that record
+*   the interrupted EPC and Status, such as the fatal error handlers, are
+*   registered with cicint_int_register() instead. The statistics
+*   cover the handler run only: the GIC keeps no time at which a hardware
+*   source became pending, so entry latency is measured per priority level
+*   with exp_gic_latency_probe() rather than per source.
+*
+*****************************************************************************/
+PUBLIC void exp_gic_int_register(UINT32 int_num, cicint_cback_fcn_ptr cback_ptr, void *cback_arg)
+{
+    PMCFW_ASSERT((int_num < EXP_NUM_INTERRUPTS) && (NULL != cback_ptr), PMCFW_ERR_INVALID_PARAMETERS);
+
+    exp_gic_handler[int_num].cback_ptr = cback_ptr;
+    exp_gic_handler[int_num].cback_arg = cback_arg;
+    memset(&exp_gic_handler[int_num].stats, 0, sizeof(exp_gic_handler[int_num].stats));
+
+    cicint_int_register(int_num, exp_gic_isr, (void *)int_num);
+} /* End: exp_gic_int_register() */
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_int_stats_get
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Returns the statistics of a handler registered with
+*   exp_gic_int_register().
+*
+* INPUTS:
+*   int_num   - interrupt number.
+*
+* OUTPUTS:
+*   stats_ptr - statistics, all 0 for a source without such a handler.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   None.
+*
+*****************************************************************************/
+PUBLIC void exp_gic_int_stats_get(UINT32 int_num, exp_gic_int_stats_struct *stats_ptr)
+{
+    UINT32 ie;
+
+    PMCFW_ASSERT(int_num < EXP_NUM_INTERRUPTS, PMCFW_ERR_INVALID_PARAMETERS);
+
+    ie = hal_int_global_disable();
+    *stats_ptr = exp_gic_handler[int_num].stats;
+    hal_int_global_restore(ie);
+} /* End: exp_gic_int_stats_get() */
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_latency_probe
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Measures the assert to handler latency of each priority level in use on
+*   VPE0 by triggering the probe interrupts from software.
+*
+* INPUTS:
+*   num_samples - number of triggers per probe.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   TRUE if every probe was taken, FALSE if one timed out.
+*
+* NOTES:
+*   Must be called on VPE0 with interrupts enabled. The previous results are
+*   discarded. Interrupts of the same or a higher priority that are taken
+*   while a probe is pending are part of the measured latency.
+*
+*****************************************************************************/
+PUBLIC BOOL exp_gic_latency_probe(UINT32 num_samples)
+{
+    UINT32 probe;
+    UINT32 sample;
+
+    memset(exp_gic_latency, 0, sizeof(exp_gic_latency));
+
+    for (probe = 0; probe < EXP_GIC_PROBE_NUM; probe++)
+    {
+        for (sample = 0; sample < num_samples; sample++)
+        {
+            exp_gic_probe_taken = FALSE;
+            exp_gic_probe_trigger_time = hal_cp0_counter_get();
+            hal_gic_edge_int_trigger_set(EXP_GIC_PROBE_INT_FIRST + probe);
+
+            while (FALSE == exp_gic_probe_taken)
+            {
+                if ((hal_cp0_counter_get() - exp_gic_probe_trigger_time) > EXP_GIC_PROBE_TIMEOUT)
+                {
+                    hal_gic_edge_int_trigger_clear(EXP_GIC_PROBE_INT_FIRST + probe);
+                    return (FALSE);
+                }
+            }
+        }
+    }
+
+    return (TRUE);
+} /* End: exp_gic_latency_probe() */
+
+/****************************************************************************
+*
+* FUNCTION: exp_gic_stats_print
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Prints the statistics of the handlers registered with
+*   exp_gic_int_register() and the results of the last latency probe.
+*   Times are in CP0 Count ticks.
+*
+* INPUTS:
+*   None.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   None.
+*
+*****************************************************************************/
+PUBLIC void exp_gic_stats_print(void)
+{
+    UINT32 int_num;
+    UINT32 probe;
+    exp_gic_int_stats_struct stats;
+    exp_gic_latency_stats_struct *lat_ptr;
+
+    bc_printf("int vpe prio      count     nested        max        avg\n");
+    for (int_num = 0; int_num < EXP_NUM_INTERRUPTS; int_num++)
+    {
+        exp_gic_int_stats_get(int_num, &stats);
+        if (0 == stats.count)
+        {
+            continue;
+        }
+        bc_printf("%3d %3d %4d %10d %10d %10d %10d\n",
+                  int_num,
+                  exp_cicint_cfg[int_num].dest_id,
+                  exp_cicint_cfg[int_num].prio,
+                  stats.count,
+                  stats.nested_count,
+                  stats.max_cycles,
+                  stats.total_cycles / stats.count);
+    }
+
+    bc_printf("latency prio      count        min        max        avg\n");
+    for (probe = 0; probe < EXP_GIC_PROBE_NUM; probe++)
+    {
+        lat_ptr = &exp_gic_latency[probe];
+        if (0 == lat_ptr->count)
+        {
+            continue;
+        }
+        bc_printf("        %4d %10d %10d %10d %10d\n",
+                  exp_cicint_cfg[EXP_GIC_PROBE_INT_FIRST + probe].prio,
+                  lat_ptr->count,
+                  lat_ptr->min_cycles,
+                  lat_ptr->max_cycles,
+                  lat_ptr->total_cycles / lat_ptr->count);
+    }
+} /* End: exp_gic_stats_print() */
+
 
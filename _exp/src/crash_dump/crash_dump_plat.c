@@ -35,6 +35,12 @@
 *   crash dump module will handle writing to SPI memory in 4K chunks by using 4K
 *   RAM buffers to temporarily hold the data. Until a 4K block of crash dump
 *   data is collected.
+*
+*   With EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE the partition holds a series
+*   of crash dumps, each a header section followed by its compressed data
+*   frames and starting on a subsector boundary. A new dump is written
+*   after the earlier ones while there is room for it, and the whole
+*   partition is only erased when there is not.
 */
 
 /*
@@ -55,6 +61,9 @@
 #include "bc_printf.h"
 #include "char_io.h"
 #include "top_plat.h"
+#include "pmc_profile.h"
+#include "crash_dump_plat.h"
+#include "lz_comp.h"
 
 /*
 * Local Constants
@@ -76,6 +85,19 @@
 */
 #define CRASH_DUMP_MAX_WRITE_SIZE       (64 * 1024)
 
+/*
+** Compressed data frames are programmed one page at a time. The work
+** buffer holds the compressor hash table (2^CRASH_DUMP_LZ_HASH_LOG2 UINT16
+** entries) or the decompression window.
+*/
+#define CRASH_DUMP_LZ_PAGE_SIZE         256
+#define CRASH_DUMP_LZ_SUBSECTOR_SIZE    (4 * 1024)
+#define CRASH_DUMP_LZ_HASH_LOG2         11
+#define CRASH_DUMP_LZ_WORK_SIZE         (1 << CRASH_DUMP_PLAT_LZ_WINDOW_LOG2)
+
+/* No crash dump found in the partition */
+#define CRASH_DUMP_LZ_REC_NONE          0xFFFFFFFF
+
 /*
 * Local Macro Definitions
 */
@@ -135,6 +157,29 @@ PRIVATE crash_dump_spi_section_access_handler spi_write_handler;
 PRIVATE crash_dump_ram_buffer data_buffer;
 PRIVATE crash_dump_ram_buffer header_buffer;
 
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+/*
+** Preset dictionary for the crash dump compressor, text that is common in
+** register dumps and logs. Must match CRASH_DUMP_DICT in crash_dump_unpack.py.
+*/
+PRIVATE const UINT8 crash_dump_lz_dict[] =
+    "] = 0x00000000\n"
+    "[0] 0x00000000 0x00000000 0x00000000 0x00000000\n"
+    "FFFFFFFF ERROR FAILED PASSED _REG _CFG _STAT lane tx_ rx_ = 0x00\n";
+
+/* Compressor buffers, allocated on init so a crash does not need to */
+PRIVATE UINT8 *crash_dump_lz_work_ptr;
+PRIVATE UINT8 *crash_dump_lz_block_ptr;
+PRIVATE UINT8 *crash_dump_lz_page_ptr;
+PRIVATE UINT32 crash_dump_lz_page_fill;
+
+/* Offset in the data section of the next compressed data frame */
+PRIVATE UINT32 crash_dump_lz_wr_offset;
+
+/* Offset in the partition of the crash dump being written or read */
+PRIVATE UINT32 crash_dump_lz_rec_offset;
+#endif
+
 /*
 ** Forward Reference Function Prototypes and Pointers to Functions in RAM
 **
@@ -470,6 +515,450 @@ PRIVATE PMCFW_ERROR crash_dump_erase(UINT32 cd_partition_addr, UINT32 cd_partiti
     return(spi_flash_plat_erase((UINT8*)cd_partition_addr, cd_partition_size));
 }
 
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+/**
+ * @brief
+ *   Program the compressed data page buffer, zero padded, at the end of
+ *   the compressed data written so far.
+ *
+ * @return
+ *   PMC_SUCCESS or error.
+ */
+PRIVATE PMCFW_ERROR crash_dump_lz_page_write(void)
+{
+    PMCFW_ERROR rc;
+
+    if ((crash_dump_lz_wr_offset + CRASH_DUMP_LZ_PAGE_SIZE) > (crash_dump_plat_active_crash_dump_spi_size_get() - crash_dump_lz_rec_offset - CRASH_DUMP_HEADER_SECTION_SIZE))
+    {
+        return CRASH_DUMP_ERR_SPI_FULL;
+    }
+
+    memset(&crash_dump_lz_page_ptr[crash_dump_lz_page_fill], 0, CRASH_DUMP_LZ_PAGE_SIZE - crash_dump_lz_page_fill);
+
+    /* disable interrupts and disable multi-VPE operation */
+    top_plat_lock_struct lock_struct;
+    top_plat_critical_region_enter(&lock_struct);
+
+    rc = crash_dump_write(crash_dump_lz_page_ptr,
+                          CRASH_DUMP_LZ_PAGE_SIZE,
+                          spi_flash_header_address + CRASH_DUMP_HEADER_SECTION_SIZE + crash_dump_lz_wr_offset);
+
+    /* restore interrupts and enable multi-VPE operation */
+    top_plat_critical_region_exit(lock_struct);
+
+    crash_dump_lz_wr_offset += CRASH_DUMP_LZ_PAGE_SIZE;
+    crash_dump_lz_page_fill = 0;
+
+    return rc;
+}
+
+/**
+ * @brief
+ *   Append bytes to the compressed data frame being written. Whole pages
+ *   are programmed as they fill.
+ *
+ * @param[in] src_ptr - Pointer to the bytes to append
+ * @param[in] len - Number of bytes
+ *
+ * @return
+ *   PMC_SUCCESS or error.
+ */
+PRIVATE PMCFW_ERROR crash_dump_lz_out(const UINT8 *src_ptr, UINT32 len)
+{
+    PMCFW_ERROR rc = PMC_SUCCESS;
+    UINT32 count;
+
+    while ((PMC_SUCCESS == rc) && (len > 0))
+    {
+        count = min(len, CRASH_DUMP_LZ_PAGE_SIZE - crash_dump_lz_page_fill);
+        memcpy(&crash_dump_lz_page_ptr[crash_dump_lz_page_fill], src_ptr, count);
+        crash_dump_lz_page_fill += count;
+        src_ptr += count;
+        len -= count;
+
+        if (CRASH_DUMP_LZ_PAGE_SIZE == crash_dump_lz_page_fill)
+        {
+            rc = crash_dump_lz_page_write();
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief
+ *   Write a data buffer to SPI flash as a compressed data frame
+ *
+ * @param[in] data_size - The amount of data, in bytes, to write
+ * @param[in] flash_offset - Offset of the raw data in the data section
+ *
+ * @return
+ *   PMC_SUCCESS if successful. Otherwise return error.
+ *
+ * @note
+ *   The frame is written at the end of the previous frame of the crash
+ *   dump rather than at flash_offset.
+ */
+PRIVATE PMCFW_ERROR crash_dump_lz_data_flush(UINT32 data_size, UINT32 flash_offset)
+{
+    PMCFW_ERROR rc;
+    crash_dump_plat_frame_header frame;
+    lz_comp_struct lz_ctx;
+    UINT32 done;
+    UINT32 raw_len;
+    UINT32 comp_len;
+    UINT32 block_word;
+    UINT8 *payload_ptr;
+
+    crash_dump_lz_page_fill = 0;
+
+    lz_comp_init(&lz_ctx,
+                 crash_dump_lz_dict,
+                 sizeof(crash_dump_lz_dict) - 1,
+                 (UINT16*)crash_dump_lz_work_ptr,
+                 CRASH_DUMP_LZ_HASH_LOG2,
+                 (1 << CRASH_DUMP_PLAT_LZ_WINDOW_LOG2));
+
+    frame.magic = CRASH_DUMP_PLAT_FRAME_MAGIC;
+    frame.raw_offset = flash_offset;
+    frame.raw_size = data_size;
+    frame.reserved = 0;
+    rc = crash_dump_lz_out((UINT8*)&frame, sizeof(frame));
+
+    for (done = 0; (PMC_SUCCESS == rc) && (done < data_size); done += raw_len)
+    {
+        raw_len = min(data_size - done, CRASH_DUMP_PLAT_LZ_BLOCK_SIZE);
+
+        /* keep the block only if it got smaller */
+        comp_len = lz_comp_block(&lz_ctx,
+                                 data_buffer.start_ptr + done,
+                                 raw_len,
+                                 crash_dump_lz_block_ptr,
+                                 raw_len - 1);
+
+        if (0 == comp_len)
+        {
+            block_word = raw_len | CRASH_DUMP_PLAT_LZ_BLOCK_STORED;
+            payload_ptr = data_buffer.start_ptr + done;
+            comp_len = raw_len;
+        }
+        else
+        {
+            block_word = comp_len;
+            payload_ptr = crash_dump_lz_block_ptr;
+        }
+
+        rc = crash_dump_lz_out((UINT8*)&block_word, sizeof(block_word));
+
+        if (PMC_SUCCESS == rc)
+        {
+            rc = crash_dump_lz_out(payload_ptr, comp_len);
+        }
+    }
+
+    /* the last page is zero padded, the next frame starts on a fresh page */
+    if ((PMC_SUCCESS == rc) && (0 != crash_dump_lz_page_fill))
+    {
+        rc = crash_dump_lz_page_write();
+    }
+
+    return rc;
+}
+
+/**
+ * @brief
+ *   Decompress one block of a compressed data frame into the block buffer.
+ *   The payload is read from flash a page at a time.
+ *
+ * @param[in] flash_ptr - Flash address of the block payload
+ * @param[in] payload_len - Length of the block payload
+ * @param[in] raw_len - Length of the raw block
+ *
+ * @return
+ *   TRUE if the payload was read and decoded to raw_len bytes.
+ */
+PRIVATE BOOL crash_dump_lz_block_read(UINT8 *flash_ptr, UINT32 payload_len, UINT32 raw_len)
+{
+    lz_decomp_struct lz_ctx;
+    lz_decomp_status_enum status = LZ_DECOMP_STATUS_NEED_INPUT;
+    const UINT8 *in_ptr;
+    UINT32 in_len;
+    UINT32 out_total = 0;
+    UINT32 out_len;
+    UINT32 done;
+    UINT32 count;
+
+    lz_decomp_init(&lz_ctx, crash_dump_lz_work_ptr, (1 << CRASH_DUMP_PLAT_LZ_WINDOW_LOG2), raw_len);
+    lz_decomp_dict_set(&lz_ctx, crash_dump_lz_dict, sizeof(crash_dump_lz_dict) - 1);
+
+    for (done = 0; (LZ_DECOMP_STATUS_NEED_INPUT == status) && (done < payload_len); done += count)
+    {
+        count = min(payload_len - done, CRASH_DUMP_LZ_PAGE_SIZE);
+
+        if (FALSE == spi_flash_plat_checked_read(crash_dump_lz_page_ptr, flash_ptr + done, count))
+        {
+            return FALSE;
+        }
+
+        in_ptr = crash_dump_lz_page_ptr;
+        in_len = count;
+        status = lz_decomp_run(&lz_ctx,
+                               &in_ptr,
+                               &in_len,
+                               crash_dump_lz_block_ptr + out_total,
+                               raw_len - out_total,
+                               &out_len);
+        out_total += out_len;
+    }
+
+    return (LZ_DECOMP_STATUS_DONE == status);
+}
+
+/**
+ * @brief
+ *   Check a compressed data frame and copy the part of a raw data range
+ *   that it holds. Every length read from flash is bounded by the space
+ *   left in the partition, so a torn or corrupt frame ends the walk.
+ *
+ * @param[in] flash_ptr - Flash address of the frame
+ * @param[in] space - Bytes from the frame to the end of the partition
+ * @param[out] raw_end_ptr - End of the raw data held by the frame
+ * @param[out] dest_buffer - Destination of the range, NULL to only check the frame
+ * @param[in] raw_offset - Offset of the range in the raw data section
+ * @param[in] size - Size of the range
+ *
+ * @return
+ *   Page aligned length of the frame, 0 if there is no valid frame.
+ */
+PRIVATE UINT32 crash_dump_lz_frame_walk(UINT8 *flash_ptr,
+                                        UINT32 space,
+                                        UINT32 *raw_end_ptr,
+                                        UINT8 *dest_buffer,
+                                        UINT32 raw_offset,
+                                        UINT32 size)
+{
+    crash_dump_plat_frame_header frame;
+    UINT32 raw_section_size = crash_dump_plat_active_crash_dump_spi_size_get() - CRASH_DUMP_HEADER_SECTION_SIZE;
+    UINT32 block_offset;
+    UINT32 block_word;
+    UINT32 block_start;
+    UINT32 raw_len;
+    UINT32 payload_len;
+    BOOL stored;
+    UINT32 first;
+    UINT32 last;
+
+    /* past the last frame the partition may still be erased */
+    if ((space < sizeof(frame)) ||
+        (FALSE == spi_flash_plat_checked_read((UINT8*)&frame, flash_ptr, sizeof(frame))) ||
+        (CRASH_DUMP_PLAT_FRAME_MAGIC != frame.magic) ||
+        (frame.raw_size > raw_section_size) ||
+        (frame.raw_offset > (raw_section_size - frame.raw_size)))
+    {
+        return 0;
+    }
+
+    block_offset = sizeof(frame);
+    for (block_start = 0; block_start < frame.raw_size; block_start += raw_len)
+    {
+        raw_len = min(frame.raw_size - block_start, CRASH_DUMP_PLAT_LZ_BLOCK_SIZE);
+
+        if (((space - block_offset) < sizeof(block_word)) ||
+            (FALSE == spi_flash_plat_checked_read((UINT8*)&block_word, flash_ptr + block_offset, sizeof(block_word))))
+        {
+            return 0;
+        }
+        block_offset += sizeof(block_word);
+
+        /* a stored block is the raw data, a compressed one is smaller */
+        stored = (0 != (block_word & CRASH_DUMP_PLAT_LZ_BLOCK_STORED));
+        payload_len = block_word & ~CRASH_DUMP_PLAT_LZ_BLOCK_STORED;
+
+        if ((payload_len > (space - block_offset)) ||
+            ((TRUE == stored) && (payload_len != raw_len)) ||
+            ((FALSE == stored) && ((0 == payload_len) || (payload_len >= raw_len))))
+        {
+            return 0;
+        }
+
+        /* overlap of the block with the requested range */
+        first = max(frame.raw_offset + block_start, raw_offset);
+        last = min(frame.raw_offset + block_start + raw_len, raw_offset + size);
+
+        if ((NULL != dest_buffer) && (first < last))
+        {
+            if (TRUE == stored)
+            {
+                if (FALSE == spi_flash_plat_checked_read(dest_buffer + (first - raw_offset),
+                                                         flash_ptr + block_offset + (first - frame.raw_offset - block_start),
+                                                         last - first))
+                {
+                    memset(dest_buffer + (first - raw_offset), 0, last - first);
+                    return 0;
+                }
+            }
+            else
+            {
+                if (FALSE == crash_dump_lz_block_read(flash_ptr + block_offset, payload_len, raw_len))
+                {
+                    return 0;
+                }
+
+                memcpy(dest_buffer + (first - raw_offset),
+                       crash_dump_lz_block_ptr + (first - frame.raw_offset - block_start),
+                       last - first);
+            }
+        }
+
+        block_offset += payload_len;
+    }
+
+    *raw_end_ptr = frame.raw_offset + frame.raw_size;
+
+    /* frames start on a page boundary */
+    return (block_offset + CRASH_DUMP_LZ_PAGE_SIZE - 1) & ~(CRASH_DUMP_LZ_PAGE_SIZE - 1);
+}
+
+/**
+ * @brief
+ *   Read a range of raw crash dump data from the compressed data frames
+ *   of the current crash dump
+ *
+ * @param[in] dest_buffer - Destination buffer
+ * @param[in] raw_offset - Offset of the range in the raw data section
+ * @param[in] size - Size of the range
+ *
+ * @return
+ *   None. Parts of the range not found in any valid frame are zero.
+ */
+PRIVATE void crash_dump_lz_data_read(UINT8 *dest_buffer, UINT32 raw_offset, UINT32 size)
+{
+    UINT32 data_section_size = crash_dump_plat_active_crash_dump_spi_size_get() - crash_dump_lz_rec_offset - CRASH_DUMP_HEADER_SECTION_SIZE;
+    UINT32 raw_section_size = crash_dump_plat_active_crash_dump_spi_size_get() - CRASH_DUMP_HEADER_SECTION_SIZE;
+    UINT32 frame_offset = 0;
+    UINT32 frame_len;
+    UINT32 raw_end;
+
+    memset(dest_buffer, 0, size);
+
+    /* the range comes from a header entry read from flash */
+    if ((raw_offset > raw_section_size) || (size > (raw_section_size - raw_offset)))
+    {
+        return;
+    }
+
+    do
+    {
+        frame_len = crash_dump_lz_frame_walk((UINT8*)(spi_flash_header_address + CRASH_DUMP_HEADER_SECTION_SIZE + frame_offset),
+                                             data_section_size - frame_offset,
+                                             &raw_end,
+                                             dest_buffer,
+                                             raw_offset,
+                                             size);
+        frame_offset += frame_len;
+    } while (0 != frame_len);
+}
+
+/**
+ * @brief
+ *   Find the crash dumps in the active partition.
+ *
+ * @param[out] last_rec_ptr - Offset of the newest crash dump with a
+ *       header, CRASH_DUMP_LZ_REC_NONE if there is none
+ * @param[out] raw_max_ptr - Largest raw data size of the crash dumps
+ *
+ * @return
+ *   Offset following the data of the last crash dump, 0 if there is none.
+ *
+ * @note
+ *   Crash dumps start on a subsector boundary. The header section is
+ *   written after the data, so a crash dump cut short by a reset has data
+ *   frames but no header, or nothing that can be read at all.
+ */
+PRIVATE UINT32 crash_dump_lz_rec_scan(UINT32 *last_rec_ptr, UINT32 *raw_max_ptr)
+{
+    UINT32 part_addr = crash_dump_plat_active_crash_dump_spi_addr_get();
+    UINT32 part_size = crash_dump_plat_active_crash_dump_spi_size_get();
+    UINT32 rec_offset = 0;
+    UINT32 end_offset = 0;
+    UINT32 frame_offset;
+    UINT32 frame_len;
+    UINT32 raw_end;
+    UINT32 raw_size;
+    UINT32 key;
+    BOOL found;
+
+    *last_rec_ptr = CRASH_DUMP_LZ_REC_NONE;
+    *raw_max_ptr = 0;
+
+    while ((rec_offset + CRASH_DUMP_HEADER_SECTION_SIZE) <= part_size)
+    {
+        frame_offset = rec_offset + CRASH_DUMP_HEADER_SECTION_SIZE;
+        raw_size = 0;
+
+        do
+        {
+            frame_len = crash_dump_lz_frame_walk((UINT8*)(part_addr + frame_offset),
+                                                 part_size - frame_offset,
+                                                 &raw_end,
+                                                 NULL,
+                                                 0,
+                                                 0);
+            if (0 != frame_len)
+            {
+                frame_offset += frame_len;
+                raw_size = max(raw_size, raw_end);
+            }
+        } while (0 != frame_len);
+
+        found = ((rec_offset + CRASH_DUMP_HEADER_SECTION_SIZE) != frame_offset);
+
+        if ((TRUE == spi_flash_plat_checked_read((UINT8*)&key, (UINT8*)(part_addr + rec_offset), sizeof(key))) &&
+            (CRASH_DUMP_HEADER_KEY == key))
+        {
+            *last_rec_ptr = rec_offset;
+            found = TRUE;
+        }
+
+        if (FALSE == found)
+        {
+            rec_offset += CRASH_DUMP_LZ_SUBSECTOR_SIZE;
+            continue;
+        }
+
+        *raw_max_ptr = max(*raw_max_ptr, raw_size);
+        end_offset = frame_offset;
+        rec_offset = (frame_offset + CRASH_DUMP_LZ_SUBSECTOR_SIZE - 1) & ~(CRASH_DUMP_LZ_SUBSECTOR_SIZE - 1);
+    }
+
+    return end_offset;
+}
+
+/**
+ * @brief
+ *   Get the flash space a crash dump needs in the worst case, with every
+ *   block stored uncompressed.
+ *
+ * @param[in] raw_size - Raw data size of the crash dump
+ *
+ * @return
+ *   Size in bytes, including the header section.
+ *
+ * @note
+ *   Each data flush is a frame, at most one per crash dump set plus one
+ *   per holding buffer, each with its header and a part page of padding.
+ */
+PRIVATE UINT32 crash_dump_lz_rec_size_max(UINT32 raw_size)
+{
+    UINT32 frames = CRASH_DUMP_SET_ID_MAX + (raw_size / (UINT32)(data_buffer.end_ptr - data_buffer.start_ptr));
+
+    return (CRASH_DUMP_HEADER_SECTION_SIZE +
+            raw_size +
+            (((raw_size / CRASH_DUMP_PLAT_LZ_BLOCK_SIZE) + frames) * sizeof(UINT32)) +
+            (frames * (sizeof(crash_dump_plat_frame_header) + CRASH_DUMP_LZ_PAGE_SIZE)));
+}
+#endif
+
 /*
 * Public Functions
 */
@@ -483,6 +972,11 @@ PRIVATE PMCFW_ERROR crash_dump_erase(UINT32 cd_partition_addr, UINT32 cd_partiti
  */
 PUBLIC void crash_dump_plat_init(void)
 {
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    UINT32 last_rec;
+    UINT32 raw_max;
+#endif
+
     /* Set the crash dump header address to be before the first SPI section */
     spi_flash_header_address = crash_dump_plat_active_crash_dump_spi_addr_get();
 
@@ -500,6 +994,19 @@ PUBLIC void crash_dump_plat_init(void)
     /* Setup the RAM buffers for the crash dump header and data */
     crash_dump_header_buffer_set((UINT32) ech_ext_data_ptr_get(), CRASH_DUMP_HEADER_SECTION_SIZE);
     crash_dump_data_buffer_set((UINT32) ech_ext_data_ptr_get() + CRASH_DUMP_HEADER_SECTION_SIZE, ech_ext_data_size_get() - CRASH_DUMP_HEADER_SECTION_SIZE);
+
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    /* compressor buffers */
+    crash_dump_lz_work_ptr = MEM_ALLOC(MEM_TYPE_FREE, CRASH_DUMP_LZ_WORK_SIZE, 0);
+    crash_dump_lz_block_ptr = MEM_ALLOC(MEM_TYPE_FREE, CRASH_DUMP_PLAT_LZ_BLOCK_SIZE, 0);
+    crash_dump_lz_page_ptr = MEM_ALLOC(MEM_TYPE_FREE, CRASH_DUMP_LZ_PAGE_SIZE, 0);
+    crash_dump_lz_wr_offset = 0;
+
+    /* read back the newest crash dump */
+    (void)crash_dump_lz_rec_scan(&last_rec, &raw_max);
+    crash_dump_lz_rec_offset = (CRASH_DUMP_LZ_REC_NONE == last_rec) ? 0 : last_rec;
+    spi_flash_header_address += crash_dump_lz_rec_offset;
+#endif
 }
 
 
@@ -653,7 +1160,8 @@ PUBLIC PMCFW_ERROR crash_dump_plat_header_flush(void)
 
 /**
  * @brief
- *   Send all the contents in the data RAM buffer to SPI flash
+ *   Send all the contents in the data RAM buffer to SPI flash,
+ *   compressed if EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE is set.
  *  
  * @param[in] data_size - The amount of data, in bytes, to flush 
  *       to flash.
@@ -668,6 +1176,9 @@ PUBLIC PMCFW_ERROR crash_dump_plat_data_flush(UINT32 data_size, UINT32 flash_off
 {
     PMCFW_ERROR rc = PMC_SUCCESS;
 
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    rc = crash_dump_lz_data_flush(data_size, flash_offset);
+#else
     /* disable interrupts and disable multi-VPE operation */
     top_plat_lock_struct lock_struct;
     top_plat_critical_region_enter(&lock_struct);
@@ -682,6 +1193,7 @@ PUBLIC PMCFW_ERROR crash_dump_plat_data_flush(UINT32 data_size, UINT32 flash_off
 
     /* restore interrupts and enable multi-VPE operation */
     top_plat_critical_region_exit(lock_struct);
+#endif
 
     return rc;
 }
@@ -703,8 +1215,18 @@ PUBLIC PMCFW_ERROR crash_dump_plat_header_entry_get(UINT32 header_index, crash_d
 
     memset(crash_dump_header_ptr, 0, sizeof(crash_dump_header));
 
-    /* Read the header page from SPI flash into the buffer */
-    memcpy(crash_dump_header_ptr, &header_flash_ptr[header_index], sizeof(crash_dump_header));
+    if (header_index >= (CRASH_DUMP_HEADER_SECTION_SIZE / sizeof(crash_dump_header)))
+    {
+        return CRASH_DUMP_INVALID_HEADER_IDX;
+    }
+
+    /* Read the header entry from SPI flash, it may not have been written */
+    if (FALSE == spi_flash_plat_checked_read((UINT8*)crash_dump_header_ptr,
+                                             (UINT8*)&header_flash_ptr[header_index],
+                                             sizeof(crash_dump_header)))
+    {
+        return CRASH_DUMP_INVALID_HEADER_IDX;
+    }
 
     if (crash_dump_header_ptr->header_key != CRASH_DUMP_HEADER_KEY)
     {
@@ -765,15 +1287,22 @@ PUBLIC PMCFW_ERROR crash_dump_plat_data_section_get(crash_dump_header *crash_dum
                                                     UINT8 *dest_buffer, 
                                                     UINT32 dest_buffer_size)
 {
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 0)
     UINT8   *flash_rd_ptr;
     UINT32  cd_data_section_flash_base_addr;
+#endif
 
     PMCFW_ASSERT(crash_dump_header_ptr->size < dest_buffer_size, CRASH_DUMP_ERR_GET_SPI_OVERFLOW)
 
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    /* the section is spread over compressed blocks */
+    crash_dump_lz_data_read(dest_buffer, crash_dump_header_ptr->start_offset, crash_dump_header_ptr->size);
+#else
     cd_data_section_flash_base_addr = spi_flash_header_address + CRASH_DUMP_HEADER_SECTION_SIZE;
 
     flash_rd_ptr = (UINT8 *)(cd_data_section_flash_base_addr + crash_dump_header_ptr->start_offset);
     memcpy(dest_buffer, flash_rd_ptr, crash_dump_header_ptr->size);
+#endif
     return PMC_SUCCESS;
 }
 
@@ -860,9 +1389,42 @@ PUBLIC VOID crash_dump_plat_ram_code_ptr_adjust(UINT32 offset)
 *
 * @return
 *   PMC_SUCCESS or Error code.
+*
+* @note
+*   With EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE the earlier crash
+*   dumps are kept, and the new one is written from the next subsector
+*   after them, when the partition has room for a crash dump as large as
+*   the largest of them. Only the space after the earlier crash dumps is
+*   erased then.
 */
 PUBLIC PMCFW_ERROR crash_dump_plat_active_partition_erase(void)
 {
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    UINT32 part_size = crash_dump_plat_active_crash_dump_spi_size_get();
+    UINT32 free_offset;
+    UINT32 last_rec;
+    UINT32 raw_max;
+
+    free_offset = crash_dump_lz_rec_scan(&last_rec, &raw_max);
+    free_offset = (free_offset + CRASH_DUMP_LZ_SUBSECTOR_SIZE - 1) & ~(CRASH_DUMP_LZ_SUBSECTOR_SIZE - 1);
+
+    crash_dump_lz_wr_offset = 0;
+
+    if ((CRASH_DUMP_LZ_REC_NONE != last_rec) &&
+        (free_offset < part_size) &&
+        (crash_dump_lz_rec_size_max(raw_max) <= (part_size - free_offset)))
+    {
+        crash_dump_lz_rec_offset = free_offset;
+        spi_flash_header_address = crash_dump_plat_active_crash_dump_spi_addr_get() + free_offset;
+
+        /* a crash dump cut short may have left torn pages after its data */
+        return(crash_dump_erase(spi_flash_header_address, part_size - free_offset));
+    }
+
+    crash_dump_lz_rec_offset = 0;
+    spi_flash_header_address = crash_dump_plat_active_crash_dump_spi_addr_get();
+#endif
+
     return(crash_dump_erase(crash_dump_plat_active_crash_dump_spi_addr_get(), crash_dump_plat_active_crash_dump_spi_size_get()));
 }
 
@@ -924,10 +1486,16 @@ PUBLIC PMCFW_ERROR crash_dump_plat_partition_zero_fill(UINT32 cd_spi_addr)
 *
 * @return
 *   PMC_SUCCESS or Error code.
+*
+* @note
+*   With EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE nothing is padded.
+*   The rest of the partition is left erased for the next crash dump
+*   and is only read with checked reads.
 */
 PUBLIC PMCFW_ERROR crash_dump_plat_partition_pad_fill(UINT32 flash_offset)
 {
     PMCFW_ERROR rc = PMC_SUCCESS;
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 0)
     UINT8       *tmp_buf_ptr = ech_ext_data_ptr_get();
     UINT32      bytes_to_fill = crash_dump_plat_active_crash_dump_spi_size_get() - CRASH_DUMP_HEADER_SECTION_SIZE;
     UINT32      fill_bytes_num;
@@ -966,6 +1534,7 @@ PUBLIC PMCFW_ERROR crash_dump_plat_partition_pad_fill(UINT32 flash_offset)
             break;
         }
     }
+#endif
 
     return(rc);
 }
@@ -1013,10 +1582,18 @@ PUBLIC void crash_dump_plat_ram_buf_wr_ptr_update(UINT32 update_size)
 *
 * @return
 *   None
+*
+* @note
+*   With EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE the space after the
+*   last crash dump is erased, it reads as 0xFF.
 */
 PUBLIC void crash_dump_plat_full_read(UINT8 *dst_ptr, UINT32 spi_src_addr, UINT32 len)
 {
+#if (EXPLORER_CRASH_DUMP_COMPRESSION_ENABLE == 1)
+    (void)spi_flash_plat_checked_read(dst_ptr, (UINT8*)spi_src_addr, len);
+#else
     crash_dump_spi_read(dst_ptr, len, spi_src_addr);
+#endif
 }
 
 
@@ -0,0 +1,294 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Temperature driven DDR PHY delay line and ZQ update policy.
+*
+*/
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_common.h"
+#include "bc_printf.h"
+#include "app_fw.h"
+#include "opsw_timer.h"
+#include "ddr_api.h"
+#include "ddr_phy.h"
+#include "ddrphy_dfibist.h"
+#include "temp_sensor_plat.h"
+#include "ddr_phy_plat.h"
+#include "ddr_phy_dl_update.h"
+#include "ddr_phy_train.h"
+
+/*
+** Local Constants
+*/
+
+/* Chip selects that can hold a rank */
+#define DDR_PHY_DL_UPDATE_NUM_CS        4
+
+/* JEDEC temperature sensor register, temperature field and its sign */
+#define DDR_PHY_DL_UPDATE_TEMP_MASK     0x1FFF
+#define DDR_PHY_DL_UPDATE_TEMP_SIGN     0x1000
+
+/*
+** Local Macro Definitions
+*/
+
+/* Distance between two temperatures */
+#define DDR_PHY_DL_UPDATE_DELTA(a, b)   (((a) > (b)) ? ((a) - (b)) : ((b) - (a)))
+
+/*
+** Private Data
+*/
+
+PRIVATE ddr_phy_dl_update_status_struct ddr_phy_dl_update_status;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Get the temperature of the hottest DIMM with a valid reading.
+*
+* @param[out] temp_ptr - temperature, 1/16 degree C
+*
+* @return
+*   TRUE if a DIMM has a valid reading.
+*
+* @note
+*   The readings are the JEDEC temperature sensor register with the most
+*   significant byte, received first, in the low byte.
+*/
+PRIVATE BOOL ddr_phy_dl_update_temp_get(INT16 *temp_ptr)
+{
+    temp_sensor_plat_reading_struct reading;
+    UINT32 sensor;
+    UINT16 raw;
+    INT16 temp;
+    BOOL valid = FALSE;
+
+    for (sensor = TEMP_SENSOR_PLAT_DIMM0; sensor <= TEMP_SENSOR_PLAT_DIMM1; sensor++)
+    {
+        temp_sensor_plat_reading_get(sensor, &reading);
+
+        if (0 == (reading.flags & TEMP_SENSOR_PLAT_FLAG_VALID))
+        {
+            continue;
+        }
+
+        raw = ((reading.temp << 8) | (reading.temp >> 8)) & DDR_PHY_DL_UPDATE_TEMP_MASK;
+        temp = (INT16)raw;
+        if (raw & DDR_PHY_DL_UPDATE_TEMP_SIGN)
+        {
+            temp = (INT16)(raw - (DDR_PHY_DL_UPDATE_TEMP_MASK + 1));
+        }
+
+        if (!valid || (temp > *temp_ptr))
+        {
+            *temp_ptr = temp;
+        }
+        valid = TRUE;
+    }
+
+    return valid;
+}
+
+/**
+* @brief
+*   Run a delay line update and optionally a ZQ short calibration of every
+*   rank, through the DFI BIST command interface.
+*
+* @param[in] zq - also run a ZQ short calibration
+*
+* @return
+*   PMC_SUCCESS or the error of the PHY library.
+*/
+PRIVATE UINT32 ddr_phy_dl_update_run(BOOL zq)
+{
+    ddr_bist_setup_t bist_setup;
+    UINT32 cs_present = user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG].CsPresent;
+    UINT32 status;
+    UINT32 cs;
+
+    status = ddrBistInit(0, &bist_setup);
+    if (PMC_SUCCESS == status)
+    {
+        ddrBistSetup(&bist_setup);
+        ddrEnterPubMode();
+        status = ddrphy_force_dl_update();
+
+        for (cs = 0; zq && (PMC_SUCCESS == status) && (cs < DDR_PHY_DL_UPDATE_NUM_CS); cs++)
+        {
+            if (cs_present & (1 << cs))
+            {
+                status = ddrBistZQCS(cs);
+            }
+        }
+
+        /* Set BIST_ENABLE = 0 and exit pub mode */
+        ddrExitBistCmd();
+    }
+
+    ddr_phy_dl_update_status.last_rc = status;
+    ddr_phy_dl_update_status.last_seconds = opsw_timer0_read();
+    if (PMC_SUCCESS != status)
+    {
+        ddr_phy_dl_update_status.fail_count++;
+    }
+
+    return status;
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Evaluate the last DIMM temperature reading and run the delay line and
+*   ZQ updates that are due. Signalled after each temperature sensor update.
+*
+* @return
+*   Nothing
+*
+* @note
+*   The references are set from the first reading after training, which
+*   the training is assumed to have been run at.
+*/
+PUBLIC VOID ddr_phy_dl_update_task(VOID)
+{
+#if (EXPLORER_DDR_DL_UPDATE == 1)
+    ddr_phy_dl_update_status_struct *status_ptr = &ddr_phy_dl_update_status;
+    UINT32 now = opsw_timer0_read();
+    BOOL dl_due;
+    BOOL zq_due;
+    INT16 temp;
+
+    /* the PHY is left to EXP_FW_DDR_PHY_INIT while it trains */
+    status_ptr->enabled = ddr_phy_plat_initialized_get() && !ddr_phy_train_busy_get();
+    if (!status_ptr->enabled || !ddr_phy_dl_update_temp_get(&temp))
+    {
+        return;
+    }
+
+    status_ptr->eval_count++;
+    status_ptr->temp = temp;
+
+    if (!status_ptr->ref_valid)
+    {
+        status_ptr->dl_ref_temp = temp;
+        status_ptr->zq_ref_temp = temp;
+        status_ptr->last_seconds = now;
+        status_ptr->ref_valid = TRUE;
+        return;
+    }
+
+    dl_due = (DDR_PHY_DL_UPDATE_DELTA(temp, status_ptr->dl_ref_temp) >= EXPLORER_DDR_DL_UPDATE_TEMP_DELTA);
+    zq_due = (DDR_PHY_DL_UPDATE_DELTA(temp, status_ptr->zq_ref_temp) >= EXPLORER_DDR_ZQ_UPDATE_TEMP_DELTA);
+    if (!dl_due && !zq_due)
+    {
+        return;
+    }
+
+    if ((now - status_ptr->last_seconds) < EXPLORER_DDR_DL_UPDATE_MIN_INTERVAL_S)
+    {
+        status_ptr->deferred_count++;
+        return;
+    }
+
+    /* the ZQ calibration is run with a delay line update */
+    if (PMC_SUCCESS == ddr_phy_dl_update_run(zq_due))
+    {
+        status_ptr->dl_count++;
+        status_ptr->dl_ref_temp = temp;
+        if (zq_due)
+        {
+            status_ptr->zq_count++;
+            status_ptr->zq_ref_temp = temp;
+        }
+    }
+#endif
+}
+
+/**
+* @brief
+*   Run a delay line update requested by the host.
+*
+* @return
+*   PMC_SUCCESS, DDR_PHY_TRAIN_ERR_BUSY while EXP_FW_DDR_PHY_INIT trains or
+*   the error of the PHY library.
+*
+* @note
+*   Moves the delay line reference to the current temperature and restarts
+*   the minimum interval.
+*/
+PUBLIC UINT32 ddr_phy_dl_update_force(VOID)
+{
+    UINT32 status;
+    INT16 temp;
+
+    if (ddr_phy_train_busy_get())
+    {
+        return DDR_PHY_TRAIN_ERR_BUSY;
+    }
+
+    status = ddr_phy_dl_update_run(FALSE);
+
+    ddr_phy_dl_update_status.forced_count++;
+
+    if ((PMC_SUCCESS == status) &&
+        ddr_phy_dl_update_status.ref_valid &&
+        ddr_phy_dl_update_temp_get(&temp))
+    {
+        ddr_phy_dl_update_status.dl_ref_temp = temp;
+    }
+
+    return status;
+}
+
+/**
+* @brief
+*   Get the state and the counters of the delay line update policy,
+*   without accessing the PHY.
+*
+* @param[out] status_ptr - policy status
+*
+* @return
+*   Nothing
+*
+* @note
+*   Safe from either VPE, the counters may be one update apart.
+*/
+PUBLIC VOID ddr_phy_dl_update_status_get(ddr_phy_dl_update_status_struct *status_ptr)
+{
+    *status_ptr = ddr_phy_dl_update_status;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
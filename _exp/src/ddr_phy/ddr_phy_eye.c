@@ -0,0 +1,363 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Compact encoding of the DDR PHY 2D eye captures, see ddr_phy_eye.h for
+*   the stream format.
+*
+* @note
+*   Neighbouring delay steps of an eye have close Vref limits and the flat
+*   or linear parts of an eye edge have a constant step to step delta, so
+*   each row is encoded as its first value followed by deltas, with runs of
+*   the same delta collapsed into one byte. Disabled ranks and DBYTEs, which
+*   the capture leaves at 0, take one byte per eye.
+*/
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_common.h"
+#include <string.h>
+#include "ddr_api.h"
+#include "ddr_phy_eye.h"
+
+/*
+** Constants
+*/
+
+/* Size of an eye in raw form */
+#define DDR_PHY_EYE_RAW_SIZE            (2 * DDR_PHY_EYE_NUM_STEPS * sizeof(UINT16))
+
+/* Largest delta encoding of an eye: first values, then 3 bytes per step */
+#define DDR_PHY_EYE_DELTA_MAX_SIZE      (2 * (sizeof(UINT16) + 3 * (DDR_PHY_EYE_NUM_STEPS - 1)))
+
+/* Size of a bitmap record, including its format byte */
+#define DDR_PHY_EYE_BITMAP_REC_SIZE     (1 + sizeof(UINT32))
+
+/* Range of a literal delta token */
+#define DDR_PHY_EYE_DELTA_MIN           (-64)
+#define DDR_PHY_EYE_DELTA_MAX           63
+#define DDR_PHY_EYE_DELTA_MASK          0x7F
+
+/*
+** Private Data
+*/
+
+/* Stream of the last compressed capture, 0 length if there is none */
+PRIVATE UINT8  ddr_phy_eye_buf[EXPLORER_DDR_PHY_EYE_BUF_SIZE];
+PRIVATE UINT32 ddr_phy_eye_len = 0;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Write a little endian UINT16.
+*
+* @param[out] out_ptr - destination
+* @param[in]  val     - value
+*
+* @return
+*   Number of bytes written.
+*/
+PRIVATE UINT32 ddr_phy_eye_u16_put(UINT8 *out_ptr, UINT16 val)
+{
+    out_ptr[0] = (UINT8)(val & 0xFF);
+    out_ptr[1] = (UINT8)(val >> 8);
+
+    return sizeof(UINT16);
+}
+
+/**
+* @brief
+*   Delta encode one row of an eye.
+*
+* @param[in]  row_ptr - DDR_PHY_EYE_NUM_STEPS values
+* @param[out] out_ptr - encoded row, up to half of
+*                       DDR_PHY_EYE_DELTA_MAX_SIZE bytes
+*
+* @return
+*   Number of bytes written.
+*/
+PRIVATE UINT32 ddr_phy_eye_row_encode(const UINT16 *row_ptr, UINT8 *out_ptr)
+{
+    UINT32 len;
+    UINT32 i;
+    UINT32 run;
+    INT32  delta;
+    INT32  last = 0;
+
+    len = ddr_phy_eye_u16_put(out_ptr, row_ptr[0]);
+
+    i = 1;
+    while (i < DDR_PHY_EYE_NUM_STEPS)
+    {
+        delta = (INT32)row_ptr[i] - (INT32)row_ptr[i - 1];
+
+        if (last == delta)
+        {
+            /* collapse the steps that continue the current delta */
+            run = 0;
+            while ((i < DDR_PHY_EYE_NUM_STEPS) &&
+                   (run < DDR_PHY_EYE_TOKEN_REPEAT_MAX) &&
+                   (last == ((INT32)row_ptr[i] - (INT32)row_ptr[i - 1])))
+            {
+                run++;
+                i++;
+            }
+            out_ptr[len++] = (UINT8)(DDR_PHY_EYE_TOKEN_REPEAT | (run - 1));
+        }
+        else if ((delta >= DDR_PHY_EYE_DELTA_MIN) && (delta <= DDR_PHY_EYE_DELTA_MAX))
+        {
+            out_ptr[len++] = (UINT8)(delta & DDR_PHY_EYE_DELTA_MASK);
+            last = delta;
+            i++;
+        }
+        else
+        {
+            out_ptr[len++] = DDR_PHY_EYE_TOKEN_ABS;
+            len += ddr_phy_eye_u16_put(&out_ptr[len], row_ptr[i]);
+            last = 0;
+            i++;
+        }
+    }
+
+    return len;
+}
+
+/**
+* @brief
+*   Pass/fail bitmap of an eye.
+*
+* @param[in] min_ptr - eye_min row
+* @param[in] max_ptr - eye_max row
+*
+* @return
+*   Bit n set if delay step n passes.
+*/
+PRIVATE UINT32 ddr_phy_eye_bitmap_get(const UINT16 *min_ptr, const UINT16 *max_ptr)
+{
+    UINT32 bitmap = 0;
+    UINT32 i;
+
+    for (i = 0; i < DDR_PHY_EYE_NUM_STEPS; i++)
+    {
+        if ((0 != max_ptr[i]) && (max_ptr[i] >= min_ptr[i]))
+        {
+            bitmap |= (1UL << i);
+        }
+    }
+
+    return bitmap;
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Encode a 2D eye capture into the session buffer, replacing the previous
+*   session.
+*
+* @param[in] type        - DDR_PHY_EYE_TYPE_READ for a
+*                          train_2d_read_eye_msdg_t capture,
+*                          DDR_PHY_EYE_TYPE_WRITE for a
+*                          train_2d_write_eye_msdg_t capture
+* @param[in] flags       - DDR_PHY_EYE_FLAG_BITMAP to encode pass/fail
+*                          bitmaps only
+* @param[in] train_rc    - return code of the capture training
+* @param[in] capture_ptr - capture filled in by the PHY training
+*
+* @return
+*   Length of the stream.
+*
+* @note
+*   The capture is only read, so it may be in the extended data buffer the
+*   stream is returned through.
+*/
+PUBLIC UINT32 ddr_phy_eye_session_encode(UINT8 type,
+                                         UINT8 flags,
+                                         UINT32 train_rc,
+                                         UINT8 *capture_ptr)
+{
+    const train_2d_eye_min_max_msdg_t *eye_ptr = (const train_2d_eye_min_max_msdg_t *)capture_ptr;
+    ddr_phy_eye_hdr_struct hdr;
+    UINT8  delta_buf[DDR_PHY_EYE_DELTA_MAX_SIZE];
+    UINT16 min_row[DDR_PHY_EYE_NUM_STEPS];
+    UINT16 max_row[DDR_PHY_EYE_NUM_STEPS];
+    UINT32 eyes_size = DDR_PHY_EYE_NUM_EYES * sizeof(train_2d_eye_min_max_msdg_t);
+    UINT32 centers_len;
+    UINT32 reserve;
+    UINT32 delta_len;
+    UINT32 bitmap;
+    UINT32 len;
+    UINT32 i;
+    UINT32 j;
+
+    if (DDR_PHY_EYE_TYPE_READ == type)
+    {
+        centers_len = sizeof(train_2d_read_eye_msdg_t) - eyes_size;
+    }
+    else
+    {
+        centers_len = sizeof(train_2d_write_eye_msdg_t) - eyes_size;
+    }
+
+    /* the buffer must hold every eye at least as a bitmap */
+    reserve = DDR_PHY_EYE_NUM_EYES * DDR_PHY_EYE_BITMAP_REC_SIZE;
+    PMCFW_ASSERT((sizeof(hdr) + centers_len + reserve) <= sizeof(ddr_phy_eye_buf),
+                 DDR_PHY_EYE_ERR_BUF_SIZE);
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic       = DDR_PHY_EYE_MAGIC;
+    hdr.version     = DDR_PHY_EYE_VERSION;
+    hdr.type        = type;
+    hdr.flags       = flags & DDR_PHY_EYE_FLAG_BITMAP;
+    hdr.num_steps   = DDR_PHY_EYE_NUM_STEPS;
+    hdr.num_ranks   = DDR_PHY_EYE_NUM_RANKS;
+    hdr.num_dbytes  = DDR_PHY_EYE_NUM_DBYTES;
+    hdr.num_bits    = DDR_PHY_EYE_NUM_BITS;
+    hdr.train_rc    = train_rc;
+    hdr.msg_version = ddrphy_training_results_get()->version_number;
+    hdr.centers_len = (UINT16)centers_len;
+    hdr.num_eyes    = DDR_PHY_EYE_NUM_EYES;
+
+    /* the center values follow the eye array in both captures */
+    len = sizeof(hdr);
+    memcpy(&ddr_phy_eye_buf[len], &capture_ptr[eyes_size], centers_len);
+    len += centers_len;
+
+    for (i = 0; i < DDR_PHY_EYE_NUM_EYES; i++)
+    {
+        memcpy(min_row, (const VOID *)eye_ptr[i].eye_min, sizeof(min_row));
+        memcpy(max_row, (const VOID *)eye_ptr[i].eye_max, sizeof(max_row));
+
+        /* room kept for the eyes after this one */
+        reserve -= DDR_PHY_EYE_BITMAP_REC_SIZE;
+
+        bitmap = 0;
+        for (j = 0; j < DDR_PHY_EYE_NUM_STEPS; j++)
+        {
+            bitmap |= min_row[j] | max_row[j];
+        }
+
+        if (0 == bitmap)
+        {
+            ddr_phy_eye_buf[len++] = DDR_PHY_EYE_FMT_EMPTY;
+            continue;
+        }
+
+        if (0 == (hdr.flags & DDR_PHY_EYE_FLAG_BITMAP))
+        {
+            delta_len = ddr_phy_eye_row_encode(min_row, delta_buf);
+            delta_len += ddr_phy_eye_row_encode(max_row, &delta_buf[delta_len]);
+
+            if (delta_len < DDR_PHY_EYE_RAW_SIZE)
+            {
+                if ((len + 1 + delta_len + reserve) <= sizeof(ddr_phy_eye_buf))
+                {
+                    ddr_phy_eye_buf[len++] = DDR_PHY_EYE_FMT_DELTA;
+                    memcpy(&ddr_phy_eye_buf[len], delta_buf, delta_len);
+                    len += delta_len;
+                    continue;
+                }
+            }
+            else if ((len + 1 + DDR_PHY_EYE_RAW_SIZE + reserve) <= sizeof(ddr_phy_eye_buf))
+            {
+                ddr_phy_eye_buf[len++] = DDR_PHY_EYE_FMT_RAW;
+                for (j = 0; j < DDR_PHY_EYE_NUM_STEPS; j++)
+                {
+                    len += ddr_phy_eye_u16_put(&ddr_phy_eye_buf[len], min_row[j]);
+                }
+                for (j = 0; j < DDR_PHY_EYE_NUM_STEPS; j++)
+                {
+                    len += ddr_phy_eye_u16_put(&ddr_phy_eye_buf[len], max_row[j]);
+                }
+                continue;
+            }
+
+            hdr.flags |= DDR_PHY_EYE_FLAG_REDUCED;
+        }
+
+        bitmap = ddr_phy_eye_bitmap_get(min_row, max_row);
+        ddr_phy_eye_buf[len++] = DDR_PHY_EYE_FMT_BITMAP;
+        len += ddr_phy_eye_u16_put(&ddr_phy_eye_buf[len], (UINT16)(bitmap & 0xFFFF));
+        len += ddr_phy_eye_u16_put(&ddr_phy_eye_buf[len], (UINT16)(bitmap >> 16));
+    }
+
+    hdr.stream_len = len;
+    memcpy(ddr_phy_eye_buf, &hdr, sizeof(hdr));
+    ddr_phy_eye_len = len;
+
+    return len;
+}
+
+/**
+* @brief
+*   Read a chunk of the session stream.
+*
+* @param[in]  offset        - byte offset in the stream
+* @param[out] buf_ptr       - destination
+* @param[in]  len           - size of the destination
+* @param[out] num_bytes_ptr - number of bytes read, 0 at the end of the
+*                             stream
+*
+* @return
+*   PMC_SUCCESS, DDR_PHY_EYE_ERR_NO_SESSION if no capture was encoded or
+*   DDR_PHY_EYE_ERR_OFFSET if the offset is past the end of the stream.
+*/
+PUBLIC PMCFW_ERROR ddr_phy_eye_session_read(UINT32 offset,
+                                            UINT8 *buf_ptr,
+                                            UINT32 len,
+                                            UINT32 *num_bytes_ptr)
+{
+    *num_bytes_ptr = 0;
+
+    if (0 == ddr_phy_eye_len)
+    {
+        return DDR_PHY_EYE_ERR_NO_SESSION;
+    }
+
+    if (offset > ddr_phy_eye_len)
+    {
+        return DDR_PHY_EYE_ERR_OFFSET;
+    }
+
+    if (len > (ddr_phy_eye_len - offset))
+    {
+        len = ddr_phy_eye_len - offset;
+    }
+
+    memcpy(buf_ptr, &ddr_phy_eye_buf[offset], len);
+    *num_bytes_ptr = len;
+
+    return PMC_SUCCESS;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
@@ -45,6 +45,8 @@
 #include "ddr_phy_dump.h"
 #include "app_fw_ddr.h"
 #include "ddr_phy_plat.h"
+#include "ddr_phy_eye.h"
+#include "ddr_phy_train.h"
 
 
 /*
@@ -99,13 +101,10 @@ PRIVATE VOID ddr_phy_step_by_step_init_command_handler(VOID)
 */
 PRIVATE VOID ddr_phy_init_command_handler(VOID)
 {
-    UINT8 error_status = PMC_SUCCESS;
     UINT32 ext_error_code = PMC_SUCCESS;
-    UINT8  error_code = DDR_PHY_INIT_RESP_SUCCESS;
     exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
     exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
     exp_fw_phy_init_cmd_parms_struct* cmd_parms_ptr = (exp_fw_phy_init_cmd_parms_struct*)&cmd_ptr->parms;
-    exp_fw_phy_init_rsp_parms_struct* rsp_parms_ptr = (exp_fw_phy_init_rsp_parms_struct*)&rsp_ptr->parms;
     UINT8* ext_data_ptr = ech_ext_data_ptr_get();
     UINT32 ext_data_size = ech_ext_data_size_get();
 
@@ -125,6 +124,28 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
         rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
 
     }
+    else if (cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_EYE_READ)
+    {
+        exp_fw_phy_init_eye_cmd_parms_struct* eye_parms_ptr = (exp_fw_phy_init_eye_cmd_parms_struct*)&cmd_ptr->parms;
+        UINT32 num_bytes = eye_parms_ptr->num_bytes;
+
+        if ((0 == num_bytes) || (num_bytes > ext_data_size))
+        {
+            num_bytes = ext_data_size;
+        }
+
+        /* return the next chunk of the last compressed eye capture */
+        ext_error_code = ddr_phy_eye_session_read(eye_parms_ptr->offset,
+                                                  ext_data_ptr,
+                                                  num_bytes,
+                                                  &num_bytes);
+
+        /* set the extended data response length */
+        rsp_ptr->ext_data_len = num_bytes;
+
+        /* set the extended data flag */
+        rsp_ptr->flags = (0 != num_bytes) ? EXP_FW_EXTENDED_DATA : EXP_FW_NO_EXTENDED_DATA;
+    }
     else if ((cmd_ptr->flags & EXP_FW_EXTENDED_DATA_BITMSK) == EXP_FW_EXTENDED_DATA)
     {
         if (cmd_ptr->ext_data_len != sizeof(user_input_msdg_t))
@@ -148,44 +169,13 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
 
             if (cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_DEFAULT_TRAIN)
             {
-                /* initialize the DDR interface */
-                ext_error_code = ddr_api_fw_train();
-
                 /*
-                ** After DDR has been trained and initialize, initialize the DDR
-                ** fatal and non-fatal reporting interface.
+                ** Train from the main loop, the DDR training task sends the
+                ** response when it is done.
                 */
-                ddr_phy_fatal_init();
-                ddr_phy_non_fatal_init();
-
-                /* copy the training results into the extended data buffer */
-                memcpy(ext_data_ptr,
-                       ddrphy_training_results_get(),
-                       sizeof(user_response_msdg_t));
-
-                /* set the extended data response length */
-                rsp_ptr->ext_data_len = sizeof(user_response_msdg_t);
-
-                /* set the extended data flag */
-                rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
-
-                /* if training failed print error code */
-                if (PMC_SUCCESS != ext_error_code)
-                {
-                    bc_printf("ddr_phy_init_command_handler(): ddr_api_fw_train() failed rc = 0x%08X\n", ext_error_code);
-                }
-
-                /* whether training passed or failed, save the calibration results */
-                ddr_api_cal_results_get(&app_fw_ddr_saved_data.timing_data,
-                                        &app_fw_ddr_saved_data.vref_data);
-
-                /* save calibration results */
-                PMCFW_ERROR rc = app_fw_ddr_calibration_save(&app_fw_ddr_saved_data);
+                ddr_phy_train_start();
 
-                if (PMC_SUCCESS != rc)
-                {
-                    bc_printf("ddr_phy_init_command_handler(): app_fw_ddr_calibration_save() failed rc = 0x%08X\n", rc);
-                }
+                return;
             }
             else if (cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_READ_EYE_TRAIN)
             {
@@ -262,6 +252,42 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
                 /* set the extended data flag */
                 rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
             }
+            else if ((cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_READ_EYE_COMPRESSED) ||
+                     (cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_WRITE_EYE_COMPRESSED))
+            {
+                exp_fw_phy_init_eye_cmd_parms_struct* eye_parms_ptr = (exp_fw_phy_init_eye_cmd_parms_struct*)&cmd_ptr->parms;
+                UINT8 eye_type;
+                UINT32 num_bytes;
+
+                /* capture into the extended data buffer */
+                if (cmd_parms_ptr->phy_init_mode == EXP_FW_PHY_INIT_READ_EYE_COMPRESSED)
+                {
+                    ext_error_code = ddr_api_fw_read_eye_capture_train(ext_data_ptr);
+                    eye_type = DDR_PHY_EYE_TYPE_READ;
+                }
+                else
+                {
+                    ext_error_code = ddr_api_fw_write_eye_capture_train(ext_data_ptr);
+                    eye_type = DDR_PHY_EYE_TYPE_WRITE;
+                }
+
+                /*
+                ** Encode the eyes of all ranks and nibbles and return the
+                ** first chunk, the host reads the rest of the stream with
+                ** EXP_FW_PHY_INIT_EYE_READ.
+                */
+                (VOID)ddr_phy_eye_session_encode(eye_type,
+                                                 eye_parms_ptr->eye_flags,
+                                                 ext_error_code,
+                                                 ext_data_ptr);
+                (VOID)ddr_phy_eye_session_read(0, ext_data_ptr, ext_data_size, &num_bytes);
+
+                /* set the extended data response length */
+                rsp_ptr->ext_data_len = num_bytes;
+
+                /* set the extended data flag */
+                rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+            }
             else
             {
                 ext_error_code = DDR_FW_ERR_UNSUPPORTED_PHY_INIT_MODE;
@@ -285,6 +311,46 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
         rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
     }
 
+    ddr_phy_plat_init_rsp_send(ext_error_code);
+
+} /* ddr_phy_init_command_handler */
+
+/**
+* @brief
+*   Send userInputMsdg structure to the crash dump
+*
+* @param
+*   None
+* @return
+*   None.
+*
+*/
+PRIVATE void ddr_phy_plat_user_input_msdg_crash_dump(void)
+{
+    crash_dump_put(sizeof(user_input_msdg_t), (void*) ddr_api_userInputMsdg_get());
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Fill the status of the EXP_FW_DDR_PHY_INIT response and send it. The
+*   extended data must already be set.
+*
+* @param[in] ext_error_code - extended error code of the command
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID ddr_phy_plat_init_rsp_send(UINT32 ext_error_code)
+{
+    UINT8 error_status = PMC_SUCCESS;
+    UINT8 error_code = DDR_PHY_INIT_RESP_SUCCESS;
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_phy_init_rsp_parms_struct* rsp_parms_ptr = (exp_fw_phy_init_rsp_parms_struct*)&rsp_ptr->parms;
+
     if (ext_error_code != DDR_SUCCESS)
     {
         error_status = PMCFW_ERR_FAIL;
@@ -304,6 +370,11 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
                 error_code = DDR_PHY_INIT_INPUT_MSDG_NO_EXT_DATA;
                 bc_printf("[DDR_PHY_INIT_INPUT_MSDG_NO_EXT_DATA] ext_error_code: 0x%08x\n", ext_error_code);
                 break;
+            case DDR_PHY_EYE_ERR_NO_SESSION:
+            case DDR_PHY_EYE_ERR_OFFSET:
+                error_code = DDR_PHY_INIT_EYE_READ_ERROR;
+                bc_printf("[DDR_PHY_INIT_EYE_READ_ERROR] ext_error_code: 0x%08x\n", ext_error_code);
+                break;
             case DDR_ERR_INVALID_DIMMTYPE:
             case DDR_ERR_INVALID_CSPRESENT:
             case DDR_ERR_INVALID_DRAMDATAWIDTH:
@@ -372,26 +443,7 @@ PRIVATE VOID ddr_phy_init_command_handler(VOID)
     /* send the response */
     ech_oc_rsp_proc();
 
-} /* ddr_phy_init_command_handler */
-
-/**
-* @brief
-*   Send userInputMsdg structure to the crash dump
-*
-* @param
-*   None
-* @return
-*   None.
-*
-*/
-PRIVATE void ddr_phy_plat_user_input_msdg_crash_dump(void)
-{
-    crash_dump_put(sizeof(user_input_msdg_t), (void*) ddr_api_userInputMsdg_get());
-}
-
-/*
-** Public Functions
-*/
+} /* ddr_phy_plat_init_rsp_send */
 
 /**
 * @brief
@@ -0,0 +1,211 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   Decoding of the packed DDR PHY PMU training firmware images, see
+*   ddr_phy_pmu_image.h for the blob format.
+*
+* @note
+*   platform_dram_binary_get() is also defined by the PHY library, alone in
+*   its own object. Defining it here keeps that object, and the per
+*   variant image sections it refers to, out of the link.
+*/
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_common.h"
+#include "bc_printf.h"
+#include "cpuhal.h"
+#include "app_fw.h"
+#include "sys_timer_api.h"
+#include "lz_decomp.h"
+#include "ddr_phy_pmu_image.h"
+#include "ddr_phy_train.h"
+
+/*
+** Private Data
+*/
+
+/*
+** Decoded image handed to the PHY library. One buffer is enough, the
+** library writes the IMEM image out to the PHY before it asks for the DMEM
+** image.
+*/
+PRIVATE UINT8 ddr_phy_pmu_image_buf[EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE];
+
+/* Linked by app_fw.ld from ddr_phy_pmu_images.bin */
+EXTERN UINT8 __ghsbegin_ddr_phy_pmu_images[];
+EXTERN UINT8 __ghsend_ddr_phy_pmu_images[];
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Decode an image of the blob into the image buffer.
+*
+* @param[in]  image    - image to decode
+* @param[out] size_ptr - length of the decoded image
+*
+* @return
+*   Decoded image.
+*
+* @note
+*   Asserts if the blob is corrupt, training can not continue without the
+*   PMU firmware.
+*/
+PRIVATE UINT8* ddr_phy_pmu_image_decode(ddr_phy_pmu_image_enum image, UINT32 *size_ptr)
+{
+    UINT32 blob_size = (UINT32)__ghsend_ddr_phy_pmu_images - (UINT32)__ghsbegin_ddr_phy_pmu_images;
+    const UINT8* blob_ptr;
+    const ddr_phy_pmu_image_hdr_struct* hdr_ptr;
+    const ddr_phy_pmu_image_entry_struct* entry_ptr;
+    UINT32 pool_offset;
+    UINT32 start_count;
+    lz_decomp_status_enum status;
+
+    /* the image is position independent, the blob moves with it */
+    blob_ptr = (const UINT8*)((UINT32)__ghsbegin_ddr_phy_pmu_images + exp_plat_get_pic_offset());
+    hdr_ptr = (const ddr_phy_pmu_image_hdr_struct*)blob_ptr;
+    pool_offset = sizeof(ddr_phy_pmu_image_hdr_struct) + (DDR_PHY_PMU_IMAGE_MAX * sizeof(ddr_phy_pmu_image_entry_struct));
+
+    PMCFW_ASSERT((blob_size >= pool_offset) &&
+                 (DDR_PHY_PMU_IMAGE_MAGIC == hdr_ptr->magic) &&
+                 (DDR_PHY_PMU_IMAGE_VERSION == hdr_ptr->version) &&
+                 (DDR_PHY_PMU_IMAGE_MAX == hdr_ptr->num_images) &&
+                 (hdr_ptr->pool_len <= (blob_size - pool_offset)),
+                 DDR_PHY_PMU_IMAGE_ERR_BLOB);
+
+    entry_ptr = (const ddr_phy_pmu_image_entry_struct*)(blob_ptr + sizeof(ddr_phy_pmu_image_hdr_struct)) + image;
+
+    PMCFW_ASSERT((entry_ptr->raw_len <= sizeof(ddr_phy_pmu_image_buf)) &&
+                 (entry_ptr->dict_offset <= hdr_ptr->pool_len) &&
+                 (entry_ptr->dict_len <= (hdr_ptr->pool_len - entry_ptr->dict_offset)) &&
+                 (entry_ptr->stream_offset <= blob_size) &&
+                 (entry_ptr->stream_len <= (blob_size - entry_ptr->stream_offset)),
+                 DDR_PHY_PMU_IMAGE_ERR_BLOB);
+
+    start_count = hal_cp0_counter_get();
+
+    status = lz_decomp_buf(blob_ptr + entry_ptr->stream_offset,
+                           entry_ptr->stream_len,
+                           blob_ptr + pool_offset + entry_ptr->dict_offset,
+                           entry_ptr->dict_len,
+                           ddr_phy_pmu_image_buf,
+                           entry_ptr->raw_len);
+
+    PMCFW_ASSERT(LZ_DECOMP_STATUS_DONE == status, DDR_PHY_PMU_IMAGE_ERR_DECODE);
+
+    bc_printf("ddr_phy_pmu_image_decode(): image %u, %u -> %u bytes in %u us\n",
+              image,
+              entry_ptr->stream_len,
+              entry_ptr->raw_len,
+              sys_timer_count_to_us(hal_cp0_counter_get() - start_count));
+
+    *size_ptr = entry_ptr->raw_len;
+
+    return ddr_phy_pmu_image_buf;
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Return the IMEM or the DMEM image of the PMU training firmware for a
+*   DIMM type and training phase. Called by the PHY library when it loads the
+*   PMU memories.
+*
+* @param[in]  dimm_type     - userInputBasic.DimmType,
+*                             DDR_PHY_PMU_IMAGE_DIMM_xxx
+* @param[in]  train_2d      - 1 for the 2D training firmware, 0 for 1D
+* @param[out] imem_pptr     - IMEM image, NULL to request the DMEM image
+* @param[out] imem_size_ptr - IMEM image length
+* @param[out] dmem_pptr     - DMEM image, NULL to request the IMEM image
+* @param[out] dmem_size_ptr - DMEM image length
+*
+* @return
+*   None
+*
+* @note
+*   The image stays valid until the next call.
+*/
+PUBLIC VOID platform_dram_binary_get(UINT32 dimm_type,
+                                     UINT32 train_2d,
+                                     UINT8 **imem_pptr,
+                                     UINT32 *imem_size_ptr,
+                                     UINT8 **dmem_pptr,
+                                     UINT32 *dmem_size_ptr)
+{
+    UINT32 image;
+
+    /* one image per call */
+    PMCFW_ASSERT((NULL == imem_pptr) != (NULL == dmem_pptr), DDR_PHY_PMU_IMAGE_ERR_BAD_PARAM);
+
+    switch (dimm_type)
+    {
+        case DDR_PHY_PMU_IMAGE_DIMM_UDIMM:
+            image = DDR_PHY_PMU_IMAGE_DDR4_IMEM;
+            break;
+
+        case DDR_PHY_PMU_IMAGE_DIMM_RDIMM:
+            image = DDR_PHY_PMU_IMAGE_RDIMM_IMEM;
+            break;
+
+        case DDR_PHY_PMU_IMAGE_DIMM_LRDIMM:
+            image = DDR_PHY_PMU_IMAGE_LRDIMM_IMEM;
+            break;
+
+        default:
+            PMCFW_ASSERT(FALSE, DDR_PHY_PMU_IMAGE_ERR_BAD_PARAM);
+            return;
+    }
+
+    /* the 2D variant follows the 1D one, the DMEM image follows the IMEM image */
+    if (0 != train_2d)
+    {
+        image += DDR_PHY_PMU_IMAGE_DDR4_2D_IMEM - DDR_PHY_PMU_IMAGE_DDR4_IMEM;
+    }
+
+    /* the progress of EXP_FW_DDR_PHY_INIT follows the images loaded */
+    ddr_phy_train_pmu_load(train_2d, (NULL != dmem_pptr));
+
+    if (NULL != imem_pptr)
+    {
+        *imem_pptr = ddr_phy_pmu_image_decode((ddr_phy_pmu_image_enum)image, imem_size_ptr);
+    }
+    else
+    {
+        image += DDR_PHY_PMU_IMAGE_DDR4_DMEM - DDR_PHY_PMU_IMAGE_DDR4_IMEM;
+        *dmem_pptr = ddr_phy_pmu_image_decode((ddr_phy_pmu_image_enum)image, dmem_size_ptr);
+    }
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
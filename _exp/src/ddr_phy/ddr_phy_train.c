@@ -0,0 +1,512 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup DDR_PHY_PLAT
+* @{
+* @file
+* @brief
+*   DDR PHY training of EXP_FW_DDR_PHY_INIT run from the VPE0 main loop.
+*
+* @note
+*   Each phase runs in one pass of the main loop and signals the task for
+*   the next one. The PHY library phase yields from its waits.
+*/
+
+/*
+** Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "bc_printf.h"
+#include "cpuhal.h"
+#include "sys_timer_api.h"
+#include "wdt.h"
+#include "app_fw.h"
+#include "app_fw_sched.h"
+#include "app_fw_boot_prof.h"
+#include "app_fw_ddr.h"
+#include "exp_api.h"
+#include "ech.h"
+#include "ech_trace.h"
+#include "log_chan.h"
+#include "ddr_api.h"
+#include "ddr_phy.h"
+#include "ddr_phy_plat.h"
+#include "ddr_phy_train.h"
+
+/*
+** Local Constants
+*/
+
+/* PMU mailbox CSRs, UctShadowRegs bit 0 is low while a mail is pending */
+#define DDR_PHY_TRAIN_CSR_UCT_SHADOW_REGS           0xD0004
+#define DDR_PHY_TRAIN_CSR_UCT_WRITE_ONLY_SHADOW     0xD0032
+#define DDR_PHY_TRAIN_UCT_WRITE_PROT_SHADOW         0x0001
+
+/* Major message announcing a streaming message */
+#define DDR_PHY_TRAIN_MAJOR_STREAM                  0x08
+
+/*
+** Local Macro Definitions
+*/
+
+/* Major message codes of the DDR4 PMU firmware */
+#define DDR_PHY_TRAIN_MAJOR_VALID(mail)     (((mail) <= 0x0D) || (((mail) >= 0xFD) && ((mail) <= 0xFF)))
+
+/*
+** Private Data
+*/
+
+PRIVATE ddr_phy_train_status_struct ddr_phy_train_status =
+{
+    DDR_PHY_TRAIN_PHASE_IDLE,
+    0,
+    DDR_PHY_TRAIN_MAJOR_NONE,
+    0,
+    PMC_SUCCESS,
+    0,
+    0,
+    0,
+    0
+};
+
+/* Main loop tasks held while training, they may access the PHY or the MSDG */
+PRIVATE const app_fw_sched_task_enum ddr_phy_train_held_tasks[] =
+{
+    APP_FW_SCHED_TASK_TWI_DEFERRED,
+    APP_FW_SCHED_TASK_UART_SHELL,
+    APP_FW_SCHED_TASK_SERDES_CAL,
+    APP_FW_SCHED_TASK_DDR_DL_UPDATE
+};
+
+/* Busy wait of the system timer, called by the yield hook */
+PRIVATE sys_timer_busy_wait_us_fn_ptr_type ddr_phy_train_busy_wait_us_fn_ptr;
+
+/* CP0 Count of the last elapsed time update */
+PRIVATE UINT32 ddr_phy_train_last_count;
+
+/* CP0 Count when the main loop was last left */
+PRIVATE UINT32 ddr_phy_train_hold_start;
+
+/* Main loop tasks are running from the yield hook */
+PRIVATE BOOL ddr_phy_train_in_yield = FALSE;
+
+/* The pending mail has been read */
+PRIVATE BOOL ddr_phy_train_mail_seen = FALSE;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Add the time since the last update to the elapsed time of the training.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_elapsed_update(VOID)
+{
+    UINT32 now = hal_cp0_counter_get();
+
+    ddr_phy_train_status.elapsed_cycles += (UINT32)(now - ddr_phy_train_last_count);
+    ddr_phy_train_last_count = now;
+}
+
+/**
+* @brief
+*   Account the time the main loop was held off, up to now.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_hold_end(VOID)
+{
+    UINT32 hold_us = sys_timer_count_to_us(hal_cp0_counter_get() - ddr_phy_train_hold_start);
+
+    if (hold_us > ddr_phy_train_status.max_hold_us)
+    {
+        ddr_phy_train_status.max_hold_us = hold_us;
+    }
+}
+
+/**
+* @brief
+*   Hold or release the main loop tasks that must not run while training.
+*
+* @param[in] hold - TRUE to hold the tasks, FALSE to release them
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_tasks_hold(BOOL hold)
+{
+    UINT32 i;
+
+    for (i = 0; i < PMC_ARRAY_SIZE(ddr_phy_train_held_tasks); i++)
+    {
+        app_fw_sched_task_hold(ddr_phy_train_held_tasks[i], hold);
+    }
+}
+
+/**
+* @brief
+*   Record the mail pending in the PMU mailbox if it is a major message.
+*   The mail is left for the PHY library to read and acknowledge.
+*
+* @return
+*   Nothing
+*
+* @note
+*   A mail the library reads between two waits is not seen. With verbose
+*   training (HdtCtrl below 0xC9) a word of a streaming message can pass
+*   for a major message.
+*/
+PRIVATE VOID ddr_phy_train_mail_peek(VOID)
+{
+    UINT16 mail;
+
+    /* the mailbox is only up while the PMU runs */
+    if ((DDR_PHY_TRAIN_PHASE_TRAIN_1D != ddr_phy_train_status.phase) &&
+        (DDR_PHY_TRAIN_PHASE_TRAIN_2D != ddr_phy_train_status.phase))
+    {
+        return;
+    }
+
+    if (0 != (io_read16(DDR_PHY_TRAIN_CSR_UCT_SHADOW_REGS) & DDR_PHY_TRAIN_UCT_WRITE_PROT_SHADOW))
+    {
+        /* no mail pending */
+        ddr_phy_train_mail_seen = FALSE;
+        return;
+    }
+
+    if (TRUE == ddr_phy_train_mail_seen)
+    {
+        /* not read by the library yet */
+        return;
+    }
+    ddr_phy_train_mail_seen = TRUE;
+
+    mail = io_read16(DDR_PHY_TRAIN_CSR_UCT_WRITE_ONLY_SHADOW);
+    if ((DDR_PHY_TRAIN_MAJOR_STREAM != mail) && DDR_PHY_TRAIN_MAJOR_VALID(mail))
+    {
+        ddr_phy_train_status.last_major = mail;
+        ddr_phy_train_status.major_count++;
+    }
+}
+
+/**
+* @brief
+*   Run the main loop tasks of higher priority than the training and kick
+*   the watchdog. The tasks of ddr_phy_train_held_tasks[] are held.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_yield(VOID)
+{
+    ddr_phy_train_hold_end();
+
+    ddr_phy_train_in_yield = TRUE;
+    app_fw_sched_yield();
+#if (EXPLORER_WDT_DISABLE == 0)
+    wdt_hardware_tmr_kick();
+#endif
+    ddr_phy_train_in_yield = FALSE;
+
+    ddr_phy_train_status.yield_count++;
+    ddr_phy_train_hold_start = hal_cp0_counter_get();
+}
+
+/**
+* @brief
+*   Busy wait of the PHY library while it trains. Polls the PMU mailbox and
+*   yields to the main loop once the yield interval has passed.
+*
+* @param[in] wait_time_us - time to wait
+*
+* @return
+*   Nothing
+*
+* @note
+*   The waits of VPE1 and of the tasks run from the yield are passed
+*   through.
+*/
+PRIVATE VOID ddr_phy_train_busy_wait_us(UINT32 wait_time_us)
+{
+    ddr_phy_train_busy_wait_us_fn_ptr(wait_time_us);
+
+    if ((0 != hal_sys_cpu_id_get()) || (TRUE == ddr_phy_train_in_yield))
+    {
+        return;
+    }
+
+    ddr_phy_train_elapsed_update();
+    ddr_phy_train_mail_peek();
+
+    if (sys_timer_count_to_us(hal_cp0_counter_get() - ddr_phy_train_hold_start) >= EXPLORER_DDR_TRAIN_YIELD_INTERVAL_US)
+    {
+        ddr_phy_train_yield();
+    }
+}
+
+/**
+* @brief
+*   Training phase: train with the PHY library, yielding from its waits.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_run(VOID)
+{
+    ddr_phy_train_status.phase = DDR_PHY_TRAIN_PHASE_LOAD_1D;
+    ddr_phy_train_mail_seen = FALSE;
+
+    /* route the PHY library waits through the yield hook */
+    ddr_phy_train_busy_wait_us_fn_ptr = sys_timer_busy_wait_us_fn_ptr;
+    sys_timer_busy_wait_us_fn_ptr = ddr_phy_train_busy_wait_us;
+
+    ddr_phy_train_status.rc = ddr_api_fw_train();
+
+    sys_timer_busy_wait_us_fn_ptr = ddr_phy_train_busy_wait_us_fn_ptr;
+
+    /* if training failed print error code */
+    if (PMC_SUCCESS != ddr_phy_train_status.rc)
+    {
+        bc_printf("ddr_phy_train_task(): ddr_api_fw_train() failed rc = 0x%08X\n", ddr_phy_train_status.rc);
+    }
+
+    ddr_phy_train_elapsed_update();
+    bc_printf("ddr_phy_train_task(): training took %u ms, %u yields, main loop held off %u us at most\n",
+              (UINT32)(ddr_phy_train_status.elapsed_cycles / sys_timer_us_to_count(1000)),
+              ddr_phy_train_status.yield_count,
+              ddr_phy_train_status.max_hold_us);
+
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_DDR_TRAIN);
+
+    ddr_phy_train_status.phase = DDR_PHY_TRAIN_PHASE_RESULTS;
+}
+
+/**
+* @brief
+*   Training phase: set up the error reporting and return the training
+*   results in the extended data of the response.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_results(VOID)
+{
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+
+    /*
+    ** After DDR has been trained and initialize, initialize the DDR
+    ** fatal and non-fatal reporting interface.
+    */
+    ddr_phy_fatal_init();
+    ddr_phy_non_fatal_init();
+
+    /* copy the training results into the extended data buffer */
+    memcpy(ech_ext_data_ptr_get(),
+           ddrphy_training_results_get(),
+           sizeof(user_response_msdg_t));
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = sizeof(user_response_msdg_t);
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* whether training passed or failed, save the calibration results */
+    ddr_api_cal_results_get(&app_fw_ddr_saved_data.timing_data,
+                            &app_fw_ddr_saved_data.vref_data);
+
+    ddr_phy_train_status.phase = DDR_PHY_TRAIN_PHASE_CAL_SAVE;
+}
+
+/**
+* @brief
+*   Training phase: save the calibration results and send the response.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ddr_phy_train_cal_save(VOID)
+{
+    PMCFW_ERROR rc = app_fw_ddr_calibration_save(&app_fw_ddr_saved_data);
+
+    if (PMC_SUCCESS != rc)
+    {
+        bc_printf("ddr_phy_train_task(): app_fw_ddr_calibration_save() failed rc = 0x%08X\n", rc);
+    }
+
+    app_fw_boot_prof_mark(APP_FW_BOOT_MS_DDR_CAL_SAVE);
+
+    ddr_phy_plat_init_rsp_send(ddr_phy_train_status.rc);
+    ech_trace_release(ECH_TRACE_SRC_OC);
+
+    ddr_phy_train_elapsed_update();
+    ddr_phy_train_status.phase = DDR_PHY_TRAIN_PHASE_DONE;
+    ddr_phy_train_tasks_hold(FALSE);
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Accept the training of an EXP_FW_DDR_PHY_INIT command, the PHY
+*   configuration having been set with ddr_api_init(). The response is held
+*   until the DDR training task is done.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID ddr_phy_train_start(VOID)
+{
+    ddr_phy_train_status.phase = DDR_PHY_TRAIN_PHASE_START;
+    ddr_phy_train_status.last_major = DDR_PHY_TRAIN_MAJOR_NONE;
+    ddr_phy_train_status.run_count++;
+    ddr_phy_train_status.rc = PMC_SUCCESS;
+    ddr_phy_train_status.major_count = 0;
+    ddr_phy_train_status.yield_count = 0;
+    ddr_phy_train_status.max_hold_us = 0;
+    ddr_phy_train_status.elapsed_cycles = 0;
+    ddr_phy_train_last_count = hal_cp0_counter_get();
+
+    ech_trace_hold(ECH_TRACE_SRC_OC);
+    ddr_phy_train_tasks_hold(TRUE);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_DDR_TRAIN);
+}
+
+/**
+* @brief
+*   DDR training task, runs the next phase of the training accepted by
+*   ddr_phy_train_start().
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID ddr_phy_train_task(VOID)
+{
+    UINT8 prev_chan;
+
+    if (FALSE == ddr_phy_train_busy_get())
+    {
+        return;
+    }
+
+    prev_chan = log_chan_enter(LOG_CHAN_DDR);
+    ddr_phy_train_elapsed_update();
+    ddr_phy_train_hold_start = hal_cp0_counter_get();
+
+    switch (ddr_phy_train_status.phase)
+    {
+        case DDR_PHY_TRAIN_PHASE_START:
+            ddr_phy_train_run();
+            break;
+
+        case DDR_PHY_TRAIN_PHASE_RESULTS:
+            ddr_phy_train_results();
+            break;
+
+        default:
+            ddr_phy_train_cal_save();
+            break;
+    }
+
+    ddr_phy_train_hold_end();
+    log_chan_exit(prev_chan);
+
+    if (TRUE == ddr_phy_train_busy_get())
+    {
+        /* next phase in the next pass of the main loop */
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_DDR_TRAIN);
+    }
+}
+
+/**
+* @brief
+*   Check if a training has been accepted and its response not sent yet.
+*
+* @return
+*   TRUE while training.
+*/
+PUBLIC BOOL ddr_phy_train_busy_get(VOID)
+{
+    return ((DDR_PHY_TRAIN_PHASE_IDLE != ddr_phy_train_status.phase) &&
+            (DDR_PHY_TRAIN_PHASE_DONE != ddr_phy_train_status.phase));
+}
+
+/**
+* @brief
+*   Follow the training phases from the PMU firmware loads. Called when the
+*   PHY library requests a PMU image.
+*
+* @param[in] train_2d - 1 for the 2D training firmware, 0 for 1D
+* @param[in] dmem     - TRUE for the DMEM image, loaded last before the
+*                       PMU is started
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID ddr_phy_train_pmu_load(UINT32 train_2d, BOOL dmem)
+{
+    if (FALSE == ddr_phy_train_busy_get())
+    {
+        /* boot time training or eye capture */
+        return;
+    }
+
+    if (0 == train_2d)
+    {
+        ddr_phy_train_status.phase = dmem ? DDR_PHY_TRAIN_PHASE_TRAIN_1D : DDR_PHY_TRAIN_PHASE_LOAD_1D;
+    }
+    else
+    {
+        ddr_phy_train_status.phase = dmem ? DDR_PHY_TRAIN_PHASE_TRAIN_2D : DDR_PHY_TRAIN_PHASE_LOAD_2D;
+    }
+
+    ddr_phy_train_mail_seen = FALSE;
+}
+
+/**
+* @brief
+*   Get the progress and the result of the last training, without
+*   accessing the PHY.
+*
+* @param[out] status_ptr - training status
+*
+* @return
+*   Nothing
+*
+* @note
+*   Safe from either VPE. The elapsed time is updated at each wait of the
+*   PHY library and at each phase.
+*/
+PUBLIC VOID ddr_phy_train_status_get(ddr_phy_train_status_struct *status_ptr)
+{
+    *status_ptr = ddr_phy_train_status;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
@@ -48,6 +48,9 @@
 #include "opsw_api.h"
 #include "serdes_plat.h"
 #include "top_plat.h"
+#include "ech_trace.h"
+#include "ech_stats.h"
+#include "ech_telemetry.h"
 
 
 /*
@@ -202,6 +205,15 @@ PRIVATE void ech_rsp_buffer_crash_dump(VOID)
 */
 PUBLIC VOID ech_init(VOID)
 {
+    /* initialize the command trace */
+    ech_trace_init();
+
+    /* initialize the command statistics */
+    ech_stats_init();
+
+    /* initialize the telemetry snapshot */
+    ech_telemetry_init();
+
     /* initialize the OpenCAPI interface handler */
     ech_oc_init();
 
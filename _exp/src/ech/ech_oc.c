@@ -46,6 +46,8 @@
 #include "cpuhal_asm.h"
 #include "exp_api.h"
 #include "ddr_api.h"
+#include "ech_trace.h"
+#include "log_chan.h"
 
 
 
@@ -87,6 +89,38 @@
 * Private Functions
 */
 
+/**
+* @brief
+*   Send the error response of a command that is not dispatched.
+*
+* @param[in] err_code - EXP_FW_API_CMD_xxx error condition
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ech_oc_cmd_err_rsp(UINT32 err_code)
+{
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+
+    /* prepare error response */
+    rsp_ptr->parms[0] = EXP_FW_API_FAILURE;
+    rsp_ptr->parms[1] = err_code;
+
+    /* no extended data flag */
+    rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
+    rsp_ptr->ext_data_len = 0;
+
+    /* set the response id, same as the command id */
+    rsp_ptr->id = cmd_ptr->id;
+
+    /* set the response request id, same as the command request id */
+    rsp_ptr->req_id = cmd_ptr->req_id;
+
+    /* prepare the response */
+    ech_oc_rsp_proc();
+    ech_trace_return(ECH_TRACE_SRC_OC);
+}
 
 /**
 * Public Functions
@@ -171,6 +205,7 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
     exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
     exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
     UINT32 crc;
+    UINT8 prev_chan;
 
     if (FALSE == ech_cmd_rxd_flag_get())
     {
@@ -181,27 +216,14 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
     /* clear received message flag */
     ech_cmd_rxd_clr();
 
+    ech_trace_rx(ECH_TRACE_SRC_OC, (UINT8)cmd_ptr->id, cmd_ptr->req_id, hal_cp0_counter_get());
+
     if ((TRUE == !(EXP_FW_NULL_CMD < cmd_ptr->id)) ||
-        (TRUE == !(EXP_FW_MAX_CMD > cmd_ptr->id)))
+        (TRUE == !(EXP_FW_MAX_CMD > cmd_ptr->id)) ||
+        (NULL == ctrl_ptr[cmd_ptr->id].api_fn_ptr))
     {
-        /* unsupported command */
-
-        /* prepare error response */
-        rsp_ptr->parms[0] = EXP_FW_API_FAILURE;
-        rsp_ptr->parms[1] = EXP_FW_API_CMD_ERR;
-
-        /* no extended data flag */
-        rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
-        rsp_ptr->ext_data_len = 0;
-
-        /* set the response id, same as the command id */
-        rsp_ptr->id = cmd_ptr->id;
-
-        /* set the response request id, same as the command request id */
-        rsp_ptr->req_id = cmd_ptr->req_id;
-
-        /* prepare the response */
-        ech_oc_rsp_proc();
+        /* unsupported command, or no handler registered for it in this image */
+        ech_oc_cmd_err_rsp(EXP_FW_API_CMD_ERR);
 
         /* command processed */
         return (TRUE);
@@ -217,23 +239,7 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
     if (crc != cmd_ptr->crc)
     {
         /* invalid command header */
-
-        /* prepare error response */
-        rsp_ptr->parms[0] = EXP_FW_API_FAILURE;
-        rsp_ptr->parms[1] = EXP_FW_API_CMD_CRC_ERR;
-
-        /* no extended data flag */
-        rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
-        rsp_ptr->ext_data_len = 0;
-
-        /* set the response id, same as the command id */
-        rsp_ptr->id = cmd_ptr->id;
-
-        /* set the response request id, same as the command request id */
-        rsp_ptr->req_id = cmd_ptr->req_id;
-
-        /* prepare the response */
-        ech_oc_rsp_proc();
+        ech_oc_cmd_err_rsp(EXP_FW_API_CMD_CRC_ERR);
 
         /* command processed */
         return (TRUE);
@@ -242,6 +248,15 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
     /* validate additional data, if present */
     if (EXP_FW_EXTENDED_DATA_BITMSK == (cmd_ptr->flags & EXP_FW_EXTENDED_DATA_BITMSK))
     {
+        if (cmd_ptr->ext_data_len > ech_ext_data_size_get())
+        {
+            /* the length is not checked by the CRC of the header alone */
+            ech_oc_cmd_err_rsp(EXP_FW_API_CMD_DATA_LEN_ERR);
+
+            /* command processed */
+            return (TRUE);
+        }
+
         crc = pmc_crc32(ech_ext_data_ptr_get(),
                         cmd_ptr->ext_data_len,
                         0,
@@ -251,35 +266,13 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
         if (cmd_ptr->ext_data_crc != crc)
         {
             /* invalid extended data */
-
-            /* prepare error response */
-            rsp_ptr->parms[0] = EXP_FW_API_FAILURE;
-            rsp_ptr->parms[1] = EXP_FW_API_CMD_DATA_CRC_ERR;
-
-            /* no extended data flag */
-            rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
-            rsp_ptr->ext_data_len = 0;
-
-            /* set the response id, same as the command id */
-            rsp_ptr->id = cmd_ptr->id;
-
-            /* set the response request id, same as the command request id */
-            rsp_ptr->req_id = cmd_ptr->req_id;
-
-            /* prepare the response */
-            ech_oc_rsp_proc();
+            ech_oc_cmd_err_rsp(EXP_FW_API_CMD_DATA_CRC_ERR);
 
             /* command processed */
             return (TRUE);
         }
     }
 
-    if (NULL == ctrl_ptr[cmd_ptr->id].api_fn_ptr)
-    {
-        /* no handler function registered for the command */
-        PMCFW_ASSERT(FALSE, EXP_INVALID_FUNC_PTR_ERR);
-    }
-
     /* Clear the response buffer */
     memset(rsp_ptr, 0, ech_rsp_size_get());
 
@@ -288,8 +281,12 @@ PUBLIC BOOL ech_oc_cmd_proc(VOID)
     rsp_ptr->req_id = cmd_ptr->req_id;
     rsp_ptr->host_spad_area = cmd_ptr->host_spad_area;
 
-    /* process the command */
+    /* process the command, its messages go to the log channel of the command */
+    prev_chan = log_chan_enter(log_chan_oc_cmd_chan_get((UINT8)cmd_ptr->id));
+    ech_trace_dispatch(ECH_TRACE_SRC_OC);
     ctrl_ptr[cmd_ptr->id].api_fn_ptr();
+    ech_trace_return(ECH_TRACE_SRC_OC);
+    log_chan_exit(prev_chan);
 
     /* command received and processed */
     return (TRUE);
@@ -326,6 +323,14 @@ PUBLIC VOID ech_oc_rsp_proc(VOID)
                              TRUE,
                              TRUE);
 
+    /* record the response, the first parameter word holds the status of most commands */
+    ech_trace_done(ECH_TRACE_SRC_OC,
+                   (EXP_FW_EXTENDED_DATA_BITMSK == (rsp_ptr->flags & EXP_FW_EXTENDED_DATA_BITMSK)) ? rsp_ptr->ext_data_len : 0,
+                   ((UINT32)rsp_ptr->parms[0]) |
+                   ((UINT32)rsp_ptr->parms[1] << 8) |
+                   ((UINT32)rsp_ptr->parms[2] << 16) |
+                   ((UINT32)rsp_ptr->parms[3] << 24));
+
     /* send the interrupt to HOST */
     ech_cmd_txd_flag_set();
 
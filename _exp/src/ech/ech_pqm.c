@@ -41,11 +41,13 @@
 #include <string.h>
 #include "serdes_plat.h"
 #include "ddr_phy.h"
+#include "ddr_phy_dl_update.h"
 #include "ocmb_config_guide.h"
 #include "ocmb_config_guide_mchp.h"
 #include "app_fw.h"
 #include "top_plat.h"
 #include "opsw_timer.h"
+#include "bc_log.h"
 
 /*
 * Local Enumerated Types
@@ -136,7 +138,7 @@ PRIVATE VOID ech_pqm_lane_set(UINT8* rx_buf_ptr, UINT32 rx_index)
     if (rx_buf_ptr[rx_index + ECH_PQM_LANE_SET_DATA_OFFSET] > EXP_SERDES_8_LANE)
     {
         /* lane configuration is out of range */
-        bc_printf("ERROR: PQM lane_set lane configuration is out of range\n");
+        BC_LOG_ERR("ERROR: PQM lane_set lane configuration is out of range\n");
         ech_twi_status_byte_set(EXP_SERDES_LANE_OOR);
     }
     else if ((rx_buf_ptr[rx_index + ECH_PQM_LANE_SET_DATA_OFFSET] != EXP_SERDES_1_LANE) &&
@@ -144,7 +146,7 @@ PRIVATE VOID ech_pqm_lane_set(UINT8* rx_buf_ptr, UINT32 rx_index)
              (rx_buf_ptr[rx_index + ECH_PQM_LANE_SET_DATA_OFFSET] != EXP_SERDES_8_LANE))
     {
         /* unsupported lane configuration */
-        bc_printf("ERROR: PQM lane_set unsupported lane configuration %d\n",
+        BC_LOG_ERR("ERROR: PQM lane_set unsupported lane configuration %d\n",
             rx_buf_ptr[rx_index + ECH_PQM_LANE_SET_DATA_OFFSET]);
 
         /* set status byte */
@@ -167,7 +169,7 @@ PRIVATE VOID ech_pqm_lane_set(UINT8* rx_buf_ptr, UINT32 rx_index)
             ech_pqm_cfg.lane_rx_pattern_bitmask = EXP_SERDES_4_LANE_PAT_BITMASK;
         }
 
-        bc_printf("INFO: PQM lane_set lane = %d\n", ech_pqm_cfg.lanes);
+        BC_LOG_INFO("INFO: PQM lane_set lane = %d\n", ech_pqm_cfg.lanes);
 
         /* set status byte */
         ech_twi_status_byte_set(EXP_TWI_SUCCESS);
@@ -230,7 +232,7 @@ PRIVATE VOID ech_pqm_freq_set(UINT8* rx_buf_ptr, UINT32 rx_index)
         (rx_buf_ptr[rx_index + ECH_PQM_FREQ_SET_DATA_OFFSET] != EXP_SERDES_25_60_GBPS))
     {
         /* unsupported frequency configuration */
-        bc_printf("ERROR: PQM freq set unsupported frequency configuration %d\n",
+        BC_LOG_ERR("ERROR: PQM freq set unsupported frequency configuration %d\n",
         rx_buf_ptr[rx_index + ECH_PQM_FREQ_SET_DATA_OFFSET]);
 
         /* set status byte */
@@ -240,7 +242,7 @@ PRIVATE VOID ech_pqm_freq_set(UINT8* rx_buf_ptr, UINT32 rx_index)
     {
         /* record the lane configuration */
         ech_pqm_cfg.freq = rx_buf_ptr[rx_index + ECH_PQM_LANE_SET_DATA_OFFSET];
-        bc_printf("INFO: PQM freq set freq = %d\n", ech_pqm_cfg.freq);
+        BC_LOG_INFO("INFO: PQM freq set freq = %d\n", ech_pqm_cfg.freq);
 
         /* set status byte */
         ech_twi_status_byte_set(EXP_TWI_SUCCESS);
@@ -304,25 +306,25 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
         (ech_pqm_cfg.lanes != EXP_SERDES_4_LANE) &&
         (ech_pqm_cfg.lanes != EXP_SERDES_8_LANE))
     {
-        bc_printf("INFO: PQM lane training unsupported lane configuration %d\n", ech_pqm_cfg.lanes);
+        BC_LOG_INFO("INFO: PQM lane training unsupported lane configuration %d\n", ech_pqm_cfg.lanes);
         return EXP_SERDES_LANE_UNSUPPORTED;
     }
     else
     {
         UINT8 step = rx_buf_ptr[EXP_TWI_CMD_DATA_OFFSET + 1];
 
-        bc_printf("INFO: PQM lane training starts step %d...\n", step);
+        BC_LOG_INFO("INFO: PQM lane training starts step %d...\n", step);
 
         if (step == 0)
         {
             UINT32 enable_dfe = (UINT32)rx_buf_ptr[EXP_TWI_CMD_DATA_OFFSET];
             ech_dfe_state_set(enable_dfe);
-            bc_printf("INFO: PQM lane training set DFE state to %s\n",
+            BC_LOG_INFO("INFO: PQM lane training set DFE state to %s\n",
                 enable_dfe ? "enable" : "disable");
 
             /* Initialize SerDes*/
             rc = serdes_plat_low_level_init(ech_pqm_cfg.lane_bitmask, ech_pqm_cfg.freq, ech_dfe_state_get());
-            bc_printf("INFO: PQM lane training initialized SerDes lanes=%d freq=%d with return status=%d\n",
+            BC_LOG_INFO("INFO: PQM lane training initialized SerDes lanes=%d freq=%d with return status=%d\n",
                 ech_pqm_cfg.lanes,
                 ech_pqm_cfg.freq,
                 rc);
@@ -330,7 +332,7 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
             if (rc != PMC_SUCCESS)
             {
                 ech_extended_error_code_set(rc);
-                bc_printf("ERROR: PQM lane training SerDes INIT failed\n");
+                BC_LOG_ERR("ERROR: PQM lane training SerDes INIT failed\n");
                 return EXP_SERDES_LANE_SERDES_INIT_ERR;
             }
 
@@ -344,18 +346,18 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
 
             if ( !ocmb_cfg_RxPatAorB(OCMB_REGS_BASE_ADDR, &active_lane_bitmask))
             {                        
-                bc_printf("[ERROR] Cannot find pattern A or B\n");  
+                BC_LOG_ERR("[ERROR] Cannot find pattern A or B\n");  
                 ech_extended_error_code_set(EXP_TWI_BOOT_CFG_DLX_CONFIG_PATTERN_A_B_FAILED);
                 return EXP_TWI_BOOT_CFG_DLX_PAT_A_B_FAIL_BITMASK;
             }
 
-            bc_printf("TWI_BOOT_CONFIG: Found Rx Pattern A or B on lanes = 0x%02X\n", active_lane_bitmask);
+            BC_LOG_INFO("TWI_BOOT_CONFIG: Found Rx Pattern A or B on lanes = 0x%02X\n", active_lane_bitmask);
 
             /* Call following function to support lane inversion */
             rc =  serdes_plat_lane_inversion_config(ech_lane_cfg_bitmask_get(), &active_lane_bitmask);
             if (rc != PMC_SUCCESS)
             {        
-                bc_printf("TWI_BOOT_CONFIG:  serdes_plat_lane_inversion_config: ERR!!! rc=0x%x\n",rc);            
+                BC_LOG_ERR("TWI_BOOT_CONFIG:  serdes_plat_lane_inversion_config: ERR!!! rc=0x%x\n",rc);            
                 ech_extended_error_code_set(rc);
                 return EXP_TWI_BOOT_CFG_SERDES_LANE_INVERSION_CONFIG_FAIL_BITMSK;        
             }
@@ -370,7 +372,7 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
             
             if (rc != PMC_SUCCESS)
             {            
-                bc_printf("TWI_BOOT_CONFIG: Serdes_plat_adapt_step1: ERR!!! rc=0x%x\n",rc);            
+                BC_LOG_ERR("TWI_BOOT_CONFIG: Serdes_plat_adapt_step1: ERR!!! rc=0x%x\n",rc);            
                 ech_extended_error_code_set(rc);
                 return EXP_TWI_BOOT_CFG_SERDES_INIT_FAIL_BITMASK;        
             }
@@ -384,7 +386,7 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
             {
                 /* DLx Config FW failed */
                 ech_extended_error_code_set(EXP_TWI_BOOT_CFG_DLX_CONFIG_FW_FAILED);
-                bc_printf("[ERROR] OCMB DLx_config_FW FAILED\n");
+                BC_LOG_ERR("[ERROR] OCMB DLx_config_FW FAILED\n");
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -399,13 +401,13 @@ PRIVATE UINT32 ech_pqm_lane_training(UINT8* rx_buf_ptr, UINT32 rx_index)
             rc = serdes_plat_adapt_step2(ech_dfe_state_get(), ech_adaptation_state_get(), ech_lane_cfg_bitmask_get());
             if (rc != PMC_SUCCESS)
             {            
-                bc_printf("TWI_BOOT_CONFIG: serdes_plat_adapt_step2: ERR!!! rc=0x%x\n",rc);            
+                BC_LOG_ERR("TWI_BOOT_CONFIG: serdes_plat_adapt_step2: ERR!!! rc=0x%x\n",rc);            
                 ech_extended_error_code_set(rc);
                 return EXP_TWI_BOOT_CFG_SERDES_INIT_FAIL_BITMASK;        
             }
         }
 
-        bc_printf("INFO: PQM lane training step %d is done\n", step);        
+        BC_LOG_INFO("INFO: PQM lane training step %d is done\n", step);        
         return EXP_TWI_SUCCESS;
     }
 }
@@ -430,7 +432,7 @@ PRIVATE VOID ech_pqm_training_reset(UINT8* rx_buf_ptr, UINT32 rx_index)
 
     top_exp_cfg_assert_serdes_reset(TOP_XCBI_BASE_ADDR);
 
-    bc_printf("INFO: PQM reset lane training\n");
+    BC_LOG_INFO("INFO: PQM reset lane training\n");
 
     /* set status byte */
     ech_twi_status_byte_set(EXP_TWI_SUCCESS);
@@ -461,18 +463,18 @@ PRIVATE UINT32 ech_pqm_rx_adapatation_obj_start(UINT8* rx_buf_ptr, UINT32 rx_ind
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: ech_pqm_rx_adapatation_obj_start for Lane ID = %d\n", lane_id);
+    BC_LOG_DEBUG("INFO: ech_pqm_rx_adapatation_obj_start for Lane ID = %d\n", lane_id);
 
     if (FALSE == SERDES_FH_read_adapt(SERDES_ADSP_PCBI_BASE_ADDR+lane_offset,
                                       SERDES_MTSB_CTRL_PCBI_BASE_ADDR+lane_offset,
                                       &ech_pqm_data.rx_adapt))
     {
         /* hardware error */
-        bc_printf("ERROR: PQM rx_adapatation_obj_start HW error\n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: PQM rx_adapatation_obj_start HW error\n");
         return EXP_SERDES_READ_ADAPT_OBJ_ERROR;
     }
 
-    bc_printf("INFO: PQM rx_adapatation_obj_start command executed\n");
+    BC_LOG_DEBUG("INFO: PQM rx_adapatation_obj_start command executed\n");
     return EXP_TWI_SUCCESS;
 }
 
@@ -501,7 +503,7 @@ PRIVATE VOID ech_pqm_rx_adapatation_obj_read(UINT8* rx_buf_ptr, UINT32 rx_index)
            (VOID*)&ech_pqm_data.rx_adapt, 
            EXP_TWI_PQM_RX_ADAPT_OBJ_READ_RSP_DATA_LEN);
 
-    bc_printf("INFO: PQM rx_adapatation_obj_read sending %d Bytes to HOST\n",
+    BC_LOG_DEBUG("INFO: PQM rx_adapatation_obj_read sending %d Bytes to HOST\n",
         tx_buf_ptr[EXP_TWI_RSP_LEN_OFFSET]);
 
     /* send the response */
@@ -538,17 +540,17 @@ PRIVATE UINT32 ech_pqm_rx_calibration_value_start(UINT8* rx_buf_ptr, UINT32 rx_i
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: ech_pqm_rx_calibration_value_start for Lane ID = %d\n", lane_id);
+    BC_LOG_DEBUG("INFO: ech_pqm_rx_calibration_value_start for Lane ID = %d\n", lane_id);
 
     if (FALSE == SERDES_FH_read_calib(SERDES_MTSB_CTRL_PCBI_BASE_ADDR+lane_offset,
                                       &ech_pqm_data.rx_calib))
     {
         /* hardware error */
-        bc_printf("ERROR: PQM rx_calibration_value_start HW error\n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: PQM rx_calibration_value_start HW error\n");
         return EXP_SERDES_RX_CALIB_ERROR;
     }
 
-    bc_printf("INFO: PQM rx_calibration_value_start command executed\n");
+    BC_LOG_DEBUG("INFO: PQM rx_calibration_value_start command executed\n");
     return EXP_TWI_SUCCESS;
 }
 
@@ -577,7 +579,7 @@ PRIVATE VOID ech_pqm_rx_calibration_value_read(UINT8* rx_buf_ptr, UINT32 rx_inde
             (VOID*)&ech_pqm_data.rx_calib, 
             sizeof(exp_pqm_rx_adapt_obj_struct));
 
-    bc_printf("INFO: PQM rx_calibration_value_read sending %d Bytes to HOST\n",
+    BC_LOG_DEBUG("INFO: PQM rx_calibration_value_read sending %d Bytes to HOST\n",
         tx_buf_ptr[EXP_TWI_RSP_LEN_OFFSET]);
 
     /* send the response */
@@ -614,17 +616,17 @@ PRIVATE UINT32 ech_pqm_csu_calibration_value_status_start(UINT8* rx_buf_ptr, UIN
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: ech_pqm_csu_calibration_value_status_start for Lane ID = %d\n", lane_id);
+    BC_LOG_DEBUG("INFO: ech_pqm_csu_calibration_value_status_start for Lane ID = %d\n", lane_id);
 
     if (FALSE == SERDES_FH_read_CSU_status(SERDES_CSU_PCBI_BASE_ADDR + lane_offset,
                                            &ech_pqm_data.csu_calib))
     {
         /* hardware error */
-        bc_printf("ERROR: PQM csu_calibration_value_status_start HW error\n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: PQM csu_calibration_value_status_start HW error\n");
         return EXP_SERDES_CSU_CALIB_ERROR;
     }
 
-    bc_printf("INFO: PQM csu_calibration_value_status_start command executed\n");
+    BC_LOG_DEBUG("INFO: PQM csu_calibration_value_status_start command executed\n");
     return EXP_TWI_SUCCESS;
 }
 
@@ -653,7 +655,7 @@ PRIVATE VOID ech_pqm_csu_calibration_value_status_read(UINT8* rx_buf_ptr, UINT32
             (VOID*)&ech_pqm_data.csu_calib, 
             sizeof(exp_pqm_csu_calib_value_status_struct));
 
-    bc_printf("INFO: PQM csu_calibration_value_status_read sending %d Bytes to HOST\n",
+    BC_LOG_DEBUG("INFO: PQM csu_calibration_value_status_read sending %d Bytes to HOST\n",
         tx_buf_ptr[EXP_TWI_RSP_LEN_OFFSET]);
 
     /* send the response */
@@ -702,7 +704,7 @@ PRIVATE VOID ech_pqm_prbs_pattern_mode_set(UINT8* rx_buf_ptr, UINT32 rx_index)
             /* record the PRBS pattern mode */
             ech_pqm_prbs.mode = rx_buf_ptr[rx_index + ECH_PQM_PRBS_PATTERN_SET_DATA_OFFSET];
 
-            bc_printf("INFO: PRBS pattern mode is set to %d\n", mode);
+            BC_LOG_INFO("INFO: PRBS pattern mode is set to %d\n", mode);
 
             /* set status byte */
             ech_twi_status_byte_set(EXP_TWI_SUCCESS);
@@ -711,7 +713,7 @@ PRIVATE VOID ech_pqm_prbs_pattern_mode_set(UINT8* rx_buf_ptr, UINT32 rx_index)
 
         default:
         {
-            bc_printf("INFO: Unsupported PRBS pattern mode\n");
+            BC_LOG_INFO("INFO: Unsupported PRBS pattern mode\n");
 
             /* unsupported configuration, set the status byte  */
             ech_twi_status_byte_set(EXP_PRBS_PATTERN_NA);
@@ -745,7 +747,7 @@ PRIVATE UINT32 ech_pqm_prbs_user_defined_pattern_set(UINT8* rx_buf_ptr, UINT32 r
                                     rx_buf_ptr[rx_index + EXP_TWI_CMD_DATA_OFFSET + (i*4) + 1] << 16 |
                                     rx_buf_ptr[rx_index + EXP_TWI_CMD_DATA_OFFSET + (i*4) + 2] << 8  |
                                     rx_buf_ptr[rx_index + EXP_TWI_CMD_DATA_OFFSET + (i*4) + 3] << 0 ;
-        bc_printf("INFO: PRBS user defined pattern[%d] = 0x%02x\n", i, ech_pqm_user_prbs.patt[i]);
+        BC_LOG_DEBUG("INFO: PRBS user defined pattern[%d] = 0x%02x\n", i, ech_pqm_user_prbs.patt[i]);
     }
     
    return EXP_TWI_SUCCESS;
@@ -775,7 +777,7 @@ PRIVATE VOID ech_pqm_prbs_monitor_control(UINT8* rx_buf_ptr, UINT32 rx_index)
         (ech_pqm_cfg.lanes != EXP_SERDES_8_LANE))
     {
         /* unsupported lane configuration */
-        bc_printf("ERROR: PRBS monitor control invalid lane configuration %d\n", ech_pqm_cfg.lanes);
+        BC_LOG_ERR("ERROR: PRBS monitor control invalid lane configuration %d\n", ech_pqm_cfg.lanes);
 
         ech_twi_status_byte_set(EXP_SERDES_LANE_UNSUPPORTED);
     }
@@ -795,7 +797,7 @@ PRIVATE VOID ech_pqm_prbs_monitor_control(UINT8* rx_buf_ptr, UINT32 rx_index)
             }
         }
 
-        bc_printf("INFO: Enabled PRBS monitoring control from lane 0 to lane %d\n",
+        BC_LOG_INFO("INFO: Enabled PRBS monitoring control from lane 0 to lane %d\n",
             ech_pqm_cfg.lanes - 1);
     }
     else
@@ -812,7 +814,7 @@ PRIVATE VOID ech_pqm_prbs_monitor_control(UINT8* rx_buf_ptr, UINT32 rx_index)
             }
         }
 
-        bc_printf("INFO: Disabled PRBS monitoring control from lane 0 to lane %d\n",
+        BC_LOG_INFO("INFO: Disabled PRBS monitoring control from lane 0 to lane %d\n",
             ech_pqm_cfg.lanes - 1);
     }
 
@@ -847,7 +849,7 @@ PRIVATE VOID ech_pqm_prbs_generator_control(UINT8* rx_buf_ptr, UINT32 rx_index)
         (ech_pqm_cfg.lanes != EXP_SERDES_8_LANE))
     {
         /* invalid lane configuration */
-        bc_printf("ERROR: PRBS generator control invalid lane configuration %d\n", ech_pqm_cfg.lanes);
+        BC_LOG_ERR("ERROR: PRBS generator control invalid lane configuration %d\n", ech_pqm_cfg.lanes);
 
         /* set status byte */
         ech_twi_status_byte_set(EXP_SERDES_LANE_UNSUPPORTED);
@@ -868,7 +870,7 @@ PRIVATE VOID ech_pqm_prbs_generator_control(UINT8* rx_buf_ptr, UINT32 rx_index)
             }
         }
 
-        bc_printf("INFO: Enabled PRBS generator control from lane 0 to lane %d\n",
+        BC_LOG_INFO("INFO: Enabled PRBS generator control from lane 0 to lane %d\n",
             ech_pqm_cfg.lanes - 1);
     }
     else
@@ -885,7 +887,7 @@ PRIVATE VOID ech_pqm_prbs_generator_control(UINT8* rx_buf_ptr, UINT32 rx_index)
             }
         }
 
-        bc_printf("INFO: Disabled PRBS generator control from lane 0 to lane %d\n",
+        BC_LOG_INFO("INFO: Disabled PRBS generator control from lane 0 to lane %d\n",
             ech_pqm_cfg.lanes - 1);
     }
 
@@ -972,16 +974,9 @@ PRIVATE UINT32 ech_pqm_prbs_err_count_start(UINT8* rx_buf_ptr, UINT32 rx_index)
     prbs_err_count_last_reset = sys_timer_read();
     prbs_err_count_last_reset_s = opsw_timer0_read();
 
-    bc_printf("INFO: Read PRBS error count for lanes: ");
-    for (UINT32 i = 0; i < ech_pqm_cfg.lanes; i++)
-    {
-        if (ech_pqm_cfg.lane_bitmask & (1 << i))
-        {
-            bc_printf("%d ", i);
-        }
-    }
-    bc_printf("\n");
-    bc_printf("Measurement time: %lu ms\n", ech_pqm_err.time_diff_ms);
+    BC_LOG_DEBUG("INFO: Read PRBS error count for lanes 0x%02x, measurement time: %lu ms\n",
+                 ech_pqm_cfg.lane_bitmask,
+                 ech_pqm_err.time_diff_ms);
 
     return EXP_TWI_SUCCESS;
 }
@@ -1016,7 +1011,7 @@ PRIVATE VOID ech_pqm_prbs_err_count_read(UINT8* rx_buf_ptr, UINT32 rx_index)
             (VOID*)&ech_pqm_err.count[0], 
             tx_buf_ptr[EXP_TWI_RSP_LEN_OFFSET]);
 
-    bc_printf("INFO: PRBS error count sending %d Bytes to HOST, %d out of %d Bytes in the package contains useful information\n",
+    BC_LOG_DEBUG("INFO: PRBS error count sending %d Bytes to HOST, %d out of %d Bytes in the package contains useful information\n",
         EXP_TWI_PQM_PRBS_ERR_COUNT_READ_RSP_LEN,
         tx_buf_ptr[EXP_TWI_RSP_LEN_OFFSET],
         EXP_TWI_PQM_PRBS_ERR_COUNT_READ_RSP_LEN);
@@ -1063,7 +1058,7 @@ PRIVATE UINT32 ech_pqm_horizontal_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: HZ Bathtub capture: Lane ID = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
+    BC_LOG_DEBUG("INFO: HZ Bathtub capture: Lane ID = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
                                             lane_id, 
                                             fast_acq_enable,
                                             time_limit_high,
@@ -1093,7 +1088,7 @@ PRIVATE UINT32 ech_pqm_horizontal_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx
                                     &horz_bt))
     {
         /* hardware error */
-        bc_printf("ERROR: HZ Bathtub capture returned HW error \n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: HZ Bathtub capture returned HW error \n");
         return EXP_HORZ_BATHTUB_FAILURE;
     }
 
@@ -1125,7 +1120,7 @@ PRIVATE VOID ech_pqm_horizontal_bathtub_get_read(UINT8* rx_buf_ptr, UINT32 rx_in
             (VOID*)&horz_bt, 
             EXP_TWI_PQM_HORZ_BATHTUB_GET_RSP_DATA_LEN);
 
-    bc_printf("INFO: HZ capture sending %d Bytes to HOST \n", EXP_TWI_PQM_HORZ_BATHTUB_GET_RSP_LEN);
+    BC_LOG_DEBUG("INFO: HZ capture sending %d Bytes to HOST \n", EXP_TWI_PQM_HORZ_BATHTUB_GET_RSP_LEN);
 
     /* send the response */
     twi_slv_data_put(EXP_TWI_SLAVE_PORT,
@@ -1170,7 +1165,7 @@ PRIVATE UINT32 ech_pqm_vertical_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx_i
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: VT Bathtub capture: Lane ID = %d Outer EYE = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
+    BC_LOG_DEBUG("INFO: VT Bathtub capture: Lane ID = %d Outer EYE = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
                                          lane_id, 
                                          outer_eye_enable,
                                          fast_acq_enable,
@@ -1194,7 +1189,7 @@ PRIVATE UINT32 ech_pqm_vertical_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx_i
                                     &vert_bt))
     {
         /* hardware failure */
-        bc_printf("ERROR: VT Bathtub capture returned HW error \n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: VT Bathtub capture returned HW error \n");
         return EXP_VERT_BATHTUB_FAILURE;
     }
 
@@ -1227,7 +1222,7 @@ PRIVATE VOID ech_pqm_vertical_bathtub_get_read(UINT8* rx_buf_ptr, UINT32 rx_inde
             (VOID*)&vert_bt, 
             EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_DATA_LEN);
 
-    bc_printf("INFO: VT Bathtub capture sending %d Bytes to HOST \n", EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_LEN);
+    BC_LOG_DEBUG("INFO: VT Bathtub capture sending %d Bytes to HOST \n", EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_LEN);
 
     /* send the response */
     twi_slv_data_put(EXP_TWI_SLAVE_PORT, tx_buf_ptr, EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_LEN);
@@ -1271,7 +1266,7 @@ PRIVATE UINT32 ech_pqm_2d_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx_index)
     /* calculate the offset for the lane being analyzed */
     UINT32 lane_offset = lane_id * SERDES_LANE_REG_OFFSET;
 
-    bc_printf("INFO: 2D Bathtub capture: Lane ID = %d Phase = %d Outer EYE = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
+    BC_LOG_DEBUG("INFO: 2D Bathtub capture: Lane ID = %d Phase = %d Outer EYE = %d fast_acq_end = %d time_limit_high = %d time_limit_low = %d event_limit = %d lane_offset = %d SERDES_MTSB_CTRL_PCBI_BASE_ADDR = 0x%x SERDES_DIAG_PCBI_BASE_ADDR = 0x%x \n",                                         
                                          lane_id, 
                                          phase,
                                          outer_eye_enable,
@@ -1296,7 +1291,7 @@ PRIVATE UINT32 ech_pqm_2d_bathtub_get_start(UINT8* rx_buf_ptr, UINT32 rx_index)
                                     &vert_bt))
     {
         /* hardware error */
-        bc_printf("ERROR: 2D Bathtub capture returned HW error \n");
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 4, 60, "ERROR: 2D Bathtub capture returned HW error \n");
         return EXP_2D_BATHTUB_FAILURE;
     }
 
@@ -1329,7 +1324,7 @@ PRIVATE VOID ech_pqm_2d_bathtub_get_read(UINT8* rx_buf_ptr, UINT32 rx_index)
             (VOID*)&vert_bt, 
             EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_DATA_LEN);
 
-    bc_printf("INFO: 2D Bathtub capture sending %d Bytes to HOST \n", EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_LEN);
+    BC_LOG_DEBUG("INFO: 2D Bathtub capture sending %d Bytes to HOST \n", EXP_TWI_PQM_VERT_BATHTUB_GET_RSP_LEN);
 
     /* send the response */
     twi_slv_data_put(EXP_TWI_SLAVE_PORT,
@@ -1394,37 +1389,18 @@ PUBLIC VOID ech_twi_pqm_set(BOOL setting)
 */
 PUBLIC UINT32 ech_pqm_force_delay_line_update(UINT8* rx_buf_ptr, UINT32 rx_index)
 {
-    ddr_bist_setup_t bistSetup;
-    UINT32 status = ddrBistInit(0, &bistSetup);
-
-    if(status != PMC_SUCCESS)
-    {
-        bc_printf("INFO: PQM cannot initialize BIST mode, status = 0x%08x\n", status);
-
-        /* Set the extended error code*/
-        ech_extended_error_code_set(status);
-
-        /* return value */
-        return EXP_TWI_ERROR;
-    }
-
-    ddrBistSetup(&bistSetup);
-    ddrEnterPubMode();
-    status = ddrphy_force_dl_update();
-
-    /* Set BIST_ENABLE = 0 and exit pub mode */    
-    ddrExitBistCmd();
+    /* Call DDR PHY Toolbox to update the delay line register, counted by the update policy */
+    UINT32 status = ddr_phy_dl_update_force();
 
-    /* Call DDR PHY Toolbox to update the delay line register*/
     if(status != PMC_SUCCESS)
     {   
-        bc_printf("INFO: PQM cannot force delay line update, status = 0x%08x\n", status);
+        BC_LOG_INFO("INFO: PQM cannot force delay line update, status = 0x%08x\n", status);
         /* Set the extended error code*/
         ech_extended_error_code_set(status);
         return EXP_TWI_ERROR;
     }
 
-    bc_printf("INFO: PQM forced delay line update\n");
+    BC_LOG_INFO("INFO: PQM forced delay line update\n");
 
     /* 
     ** Do not increment the receive buffer index as
@@ -1808,6 +1784,6 @@ PUBLIC VOID ech_pqm_cmd_rx_index_increment(UINT8* rx_buf_ptr, UINT32 rx_index)
         break;
 
         default:
-            bc_printf("Unsupported PQM Command ID \n");
+            BC_LOG_INFO("Unsupported PQM Command ID \n");
     }
 } /* ech_pqm_cmd_proc() */
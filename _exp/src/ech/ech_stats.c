@@ -0,0 +1,555 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Per-command handler latency statistics implementation.
+*
+* @note
+*   A table is cleared by the VPE that writes it, on its next update after
+*   a clear was requested. Until then readers return the table as empty.
+*   Each table has a sequence number that is odd while it is updated, so a
+*   reader on the other VPE retries a record that was copied during an
+*   update.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "cpuhal.h"
+#include "sys_timer_api.h"
+#include "bc_printf.h"
+#include "ech_stats.h"
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_plat_cfg.h"
+#include "cmdsvr_func_api.h"
+#endif
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+/* Cursor record index of no record */
+#define ECH_STATS_REC_NONE          0xFFFFFFFF
+
+/* Attempts to copy a record that is being updated */
+#define ECH_STATS_READ_TRIES        4
+
+#define ECH_STATS_BUCKET_MAX        0xFFFF
+
+#define PMC_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Table of one command set, only written by one VPE.
+*/
+typedef struct
+{
+    UINT32          first;                      /**< Index of the first record */
+    UINT32          num_cmds;                   /**< Number of records */
+    volatile UINT32 seq;                        /**< Odd while the table is updated */
+    volatile UINT32 clear_req;                  /**< Clears requested */
+    volatile UINT32 clear_ack;                  /**< Clears done */
+} ech_stats_table_struct;
+
+/*
+* Private Data
+*/
+
+PRIVATE ech_stats_cmd_struct ech_stats_cmd[ECH_STATS_NUM_RECORDS];
+PRIVATE ech_stats_table_struct ech_stats_table[ECH_STATS_NUM_TABLES];
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR ech_stats_cmd_show(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the statistics module */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct ech_stats_cmd_set[] = {
+    {
+        "cmd_stat",
+        "Show host command handler latency statistics",
+        ech_stats_cmd_show,
+        "Cmd Usage: cmd_stat\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Histogram bucket of a handler time.
+*
+* @param[in] cycles - handler time in CP0 Count ticks
+*
+* @return
+*   bucket
+*/
+PRIVATE UINT32 ech_stats_bucket_get(UINT32 cycles)
+{
+    UINT32 bucket = 0;
+
+    cycles >>= ECH_STATS_BUCKET_SHIFT;
+    while ((0 != cycles) && (bucket < (ECH_STATS_NUM_BUCKETS - 1)))
+    {
+        cycles >>= 1;
+        bucket++;
+    }
+
+    return (bucket);
+}
+
+/**
+* @brief
+*   Table and command of a record.
+*
+* @param[in]  rec_idx    - record index
+* @param[out] cmd_id_ptr - command ID
+*
+* @return
+*   ECH_STATS_TABLE_xxx
+*/
+PRIVATE UINT32 ech_stats_table_find(UINT32 rec_idx, UINT8 *cmd_id_ptr)
+{
+    UINT32 table;
+
+    for (table = 0; table < (ECH_STATS_NUM_TABLES - 1); table++)
+    {
+        if (rec_idx < (ech_stats_table[table].first + ech_stats_table[table].num_cmds))
+        {
+            break;
+        }
+    }
+    *cmd_id_ptr = (UINT8)(rec_idx - ech_stats_table[table].first);
+
+    return (table);
+}
+
+/**
+* @brief
+*   Copy a record, consistent with the updates of the other VPE.
+*
+* @param[in]  rec_idx - record index
+* @param[out] rec_ptr - record
+*
+* @return
+*   None
+*
+* @note
+*   A table with a clear pending is returned as empty. A record still being
+*   updated after ECH_STATS_READ_TRIES attempts is returned as copied.
+*/
+PRIVATE VOID ech_stats_rec_get(UINT32 rec_idx, ech_stats_rec_struct *rec_ptr)
+{
+    ech_stats_table_struct *table_ptr;
+    UINT32 table;
+    UINT32 seq;
+    UINT32 tries;
+    BOOL cleared = FALSE;
+    UINT8 cmd_id;
+
+    table = ech_stats_table_find(rec_idx, &cmd_id);
+    table_ptr = &ech_stats_table[table];
+
+    memset(rec_ptr, 0, sizeof(*rec_ptr));
+    rec_ptr->table = (UINT8)table;
+    rec_ptr->cmd_id = cmd_id;
+
+    for (tries = 0; tries < ECH_STATS_READ_TRIES; tries++)
+    {
+        seq = table_ptr->seq;
+        hal_mem_sync_rmb();
+
+        cleared = (table_ptr->clear_req != table_ptr->clear_ack);
+        memcpy(&rec_ptr->stats, &ech_stats_cmd[rec_idx], sizeof(rec_ptr->stats));
+        hal_mem_sync_rmb();
+
+        if ((0 == (seq & 1)) && (seq == table_ptr->seq))
+        {
+            break;
+        }
+    }
+
+    if (TRUE == cleared)
+    {
+        memset(&rec_ptr->stats, 0, sizeof(rec_ptr->stats));
+    }
+}
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/**
+* @brief
+*   Command server handler to show the command statistics.
+*
+* @param[in] args     - command arguments
+* @param[in] num_args - number of arguments
+*
+* @return
+*   PMC_SUCCESS
+*/
+PRIVATE PMCFW_ERROR ech_stats_cmd_show(CHAR **args, UINT8 num_args)
+{
+    ech_stats_print();
+
+    return PMC_SUCCESS;
+}
+#endif
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize the command statistics.
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_stats_init(VOID)
+{
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+#endif
+
+    memset(ech_stats_cmd, 0, sizeof(ech_stats_cmd));
+    memset(ech_stats_table, 0, sizeof(ech_stats_table));
+
+    ech_stats_table[ECH_STATS_TABLE_OC].first = 0;
+    ech_stats_table[ECH_STATS_TABLE_OC].num_cmds = EXP_FW_MAX_CMD;
+    ech_stats_table[ECH_STATS_TABLE_TWI].first = EXP_FW_MAX_CMD;
+    ech_stats_table[ECH_STATS_TABLE_TWI].num_cmds = EXP_FW_TWI_CMD_MAX;
+    ech_stats_table[ECH_STATS_TABLE_TWI_DEFERRED].first = EXP_FW_MAX_CMD + EXP_FW_TWI_CMD_MAX;
+    ech_stats_table[ECH_STATS_TABLE_TWI_DEFERRED].num_cmds = EXP_FW_TWI_CMD_MAX;
+
+#if (CMDSVR_REG_COMMANDS == 1)
+    rv = cmdsvr_func_list_register(ech_stats_cmd_set, PMC_ARRAY_SIZE(ech_stats_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
+}
+
+/**
+* @brief
+*   Account a handler call. Must only be called by the VPE that owns the
+*   table.
+*
+* @param[in] table  - ECH_STATS_TABLE_xxx
+* @param[in] cmd_id - command ID
+* @param[in] cycles - handler time in CP0 Count ticks
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_stats_update(UINT32 table, UINT8 cmd_id, UINT32 cycles)
+{
+    ech_stats_table_struct *table_ptr = &ech_stats_table[table];
+    ech_stats_cmd_struct *cmd_stats_ptr;
+    UINT32 bucket;
+    UINT32 total_lo;
+
+    if (cmd_id >= table_ptr->num_cmds)
+    {
+        return;
+    }
+    cmd_stats_ptr = &ech_stats_cmd[table_ptr->first + cmd_id];
+
+    table_ptr->seq++;
+    hal_mem_sync_wmb();
+
+    /* clear requested by a reader */
+    if (table_ptr->clear_req != table_ptr->clear_ack)
+    {
+        memset(&ech_stats_cmd[table_ptr->first], 0, table_ptr->num_cmds * sizeof(ech_stats_cmd_struct));
+        table_ptr->clear_ack = table_ptr->clear_req;
+    }
+
+    if ((0 == cmd_stats_ptr->count) || (cycles < cmd_stats_ptr->min_cycles))
+    {
+        cmd_stats_ptr->min_cycles = cycles;
+    }
+    if (cycles > cmd_stats_ptr->max_cycles)
+    {
+        cmd_stats_ptr->max_cycles = cycles;
+    }
+    cmd_stats_ptr->count++;
+
+    total_lo = cmd_stats_ptr->total_cycles_lo + cycles;
+    if (total_lo < cycles)
+    {
+        cmd_stats_ptr->total_cycles_hi++;
+    }
+    cmd_stats_ptr->total_cycles_lo = total_lo;
+
+    bucket = ech_stats_bucket_get(cycles);
+    if (cmd_stats_ptr->bucket[bucket] < ECH_STATS_BUCKET_MAX)
+    {
+        cmd_stats_ptr->bucket[bucket]++;
+    }
+
+    hal_mem_sync_wmb();
+    table_ptr->seq++;
+}
+
+/**
+* @brief
+*   Clear the statistics. Safe from either VPE.
+*
+* @return
+*   None
+*
+* @note
+*   Calls accounted between the last read and the clear are lost.
+*/
+PUBLIC VOID ech_stats_clear(VOID)
+{
+    UINT32 table;
+
+    for (table = 0; table < ECH_STATS_NUM_TABLES; table++)
+    {
+        ech_stats_table[table].clear_req = ech_stats_table[table].clear_ack + 1;
+    }
+    hal_mem_sync_wmb();
+}
+
+/**
+* @brief
+*   Start reading the statistics. The commands called at this point are
+*   returned by the following reads.
+*
+* @param[out] cursor_ptr - read cursor
+*
+* @return
+*   Size of the statistics image in bytes
+*/
+PUBLIC UINT32 ech_stats_read_start(ech_stats_cursor_struct *cursor_ptr)
+{
+    UINT32 rec_idx;
+    UINT32 num_records = 0;
+
+    memset(cursor_ptr, 0, sizeof(*cursor_ptr));
+    cursor_ptr->hdr.magic = ECH_STATS_MAGIC;
+    cursor_ptr->hdr.version = ECH_STATS_VERSION;
+    cursor_ptr->hdr.rec_size = sizeof(ech_stats_rec_struct);
+    cursor_ptr->hdr.num_buckets = ECH_STATS_NUM_BUCKETS;
+    cursor_ptr->hdr.bucket_shift = ECH_STATS_BUCKET_SHIFT;
+    cursor_ptr->hdr.ticks_per_ms = sys_timer_us_to_count(1000);
+    cursor_ptr->rec_idx = ECH_STATS_REC_NONE;
+
+    for (rec_idx = 0; rec_idx < ECH_STATS_NUM_RECORDS; rec_idx++)
+    {
+        ech_stats_rec_get(rec_idx, &cursor_ptr->rec);
+        if (0 != cursor_ptr->rec.stats.count)
+        {
+            cursor_ptr->rec_map[rec_idx / 32] |= (1 << (rec_idx % 32));
+            num_records++;
+        }
+    }
+    cursor_ptr->hdr.num_records = (UINT16)num_records;
+
+    return (sizeof(ech_stats_hdr_struct) + (num_records * sizeof(ech_stats_rec_struct)));
+}
+
+/**
+* @brief
+*   Read part of the statistics image.
+*
+* @param[in,out] cursor_ptr - read cursor from ech_stats_read_start()
+* @param[in]     offset     - offset in the statistics image
+* @param[out]    buf_ptr    - buffer
+* @param[in]     len        - number of bytes to read
+*
+* @return
+*   Number of bytes read, less than len at the end of the image
+*
+* @note
+*   Each record holds the statistics at the time it is read, a record read
+*   in pieces is copied once.
+*/
+PUBLIC UINT32 ech_stats_read(ech_stats_cursor_struct *cursor_ptr,
+                             UINT32 offset,
+                             UINT8 *buf_ptr,
+                             UINT32 len)
+{
+    UINT32 hdr_size = sizeof(ech_stats_hdr_struct);
+    UINT32 rec_size = sizeof(ech_stats_rec_struct);
+    UINT32 img_idx;
+    UINT32 rec_idx;
+    UINT32 pos;
+    UINT32 chunk;
+    UINT32 done = 0;
+    UINT8 *src_ptr;
+
+    while (done < len)
+    {
+        pos = offset + done;
+
+        if (pos < hdr_size)
+        {
+            src_ptr = (UINT8 *)&cursor_ptr->hdr + pos;
+            chunk = hdr_size - pos;
+        }
+        else
+        {
+            img_idx = (pos - hdr_size) / rec_size;
+            if (img_idx >= cursor_ptr->hdr.num_records)
+            {
+                break;
+            }
+
+            if (img_idx != cursor_ptr->rec_idx)
+            {
+                /* find the img_idx-th command of the map */
+                UINT32 n = img_idx;
+
+                for (rec_idx = 0; rec_idx < ECH_STATS_NUM_RECORDS; rec_idx++)
+                {
+                    if (0 != (cursor_ptr->rec_map[rec_idx / 32] & (1 << (rec_idx % 32))))
+                    {
+                        if (0 == n)
+                        {
+                            break;
+                        }
+                        n--;
+                    }
+                }
+
+                ech_stats_rec_get(rec_idx, &cursor_ptr->rec);
+                cursor_ptr->rec_idx = img_idx;
+            }
+
+            src_ptr = (UINT8 *)&cursor_ptr->rec + ((pos - hdr_size) % rec_size);
+            chunk = rec_size - ((pos - hdr_size) % rec_size);
+        }
+
+        if (chunk > (len - done))
+        {
+            chunk = len - done;
+        }
+        memcpy(&buf_ptr[done], src_ptr, chunk);
+        done += chunk;
+    }
+
+    return (done);
+}
+
+/**
+* @brief
+*   Get the call counts of the commands of a table.
+*
+* @param[in]  table     - ECH_STATS_TABLE_xxx
+* @param[out] count_ptr - call count per command ID
+* @param[in]  max       - size of count_ptr in entries
+*
+* @return
+*   Number of counts returned
+*
+* @note
+*   Each count is consistent with the updates of the other VPE, the counts
+*   of different commands may be one call apart.
+*/
+PUBLIC UINT32 ech_stats_counts_get(UINT32 table, UINT32 *count_ptr, UINT32 max)
+{
+    ech_stats_rec_struct rec;
+    UINT32 num_cmds;
+    UINT32 i;
+
+    if (table >= ECH_STATS_NUM_TABLES)
+    {
+        return (0);
+    }
+
+    num_cmds = ech_stats_table[table].num_cmds;
+    if (num_cmds > max)
+    {
+        num_cmds = max;
+    }
+
+    for (i = 0; i < num_cmds; i++)
+    {
+        ech_stats_rec_get(ech_stats_table[table].first + i, &rec);
+        count_ptr[i] = rec.stats.count;
+    }
+
+    return (num_cmds);
+}
+
+/**
+* @brief
+*   Print the statistics of the commands that were called. Times are in
+*   CP0 Count ticks.
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_stats_print(VOID)
+{
+    ech_stats_rec_struct rec;
+    UINT32 rec_idx;
+    UINT32 bucket;
+    UINT64 total;
+
+    bc_printf("tbl cmd      count        min        max        avg  histogram\n");
+    for (rec_idx = 0; rec_idx < ECH_STATS_NUM_RECORDS; rec_idx++)
+    {
+        ech_stats_rec_get(rec_idx, &rec);
+        if (0 == rec.stats.count)
+        {
+            continue;
+        }
+
+        total = ((UINT64)rec.stats.total_cycles_hi << 32) | rec.stats.total_cycles_lo;
+
+        bc_printf("%3d %3d %10d %10d %10d %10d ",
+                  rec.table,
+                  rec.cmd_id,
+                  rec.stats.count,
+                  rec.stats.min_cycles,
+                  rec.stats.max_cycles,
+                  (UINT32)(total / rec.stats.count));
+        for (bucket = 0; bucket < ECH_STATS_NUM_BUCKETS; bucket++)
+        {
+            bc_printf(" %d", rec.stats.bucket[bucket]);
+        }
+        bc_printf("\n");
+    }
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,282 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Telemetry snapshot implementation.
+*
+* @note
+*   Each item is read through the getter of the module that owns it, which
+*   returns the value it last cached. Items updated by the other VPE are
+*   copied consistently by their getter, different items may be a few
+*   microseconds apart.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "cpuhal.h"
+#include "sys_timer_api.h"
+#include "opsw_timer.h"
+#include "ech.h"
+#include "flash_partition_info.h"
+#include "ech_telemetry.h"
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Private Data
+*/
+
+/* Flash partition information, read at boot */
+PRIVATE ech_telemetry_flash_struct ech_telemetry_flash;
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Append a TLV record to the snapshot.
+*
+* @param[out]    buf_ptr   - snapshot buffer
+* @param[in]     len       - size of the buffer
+* @param[in,out] pos_ptr   - offset of the record, updated to the next one
+* @param[in]     type      - ECH_TELEMETRY_TYPE_xxx
+* @param[in]     value_ptr - value
+* @param[in]     value_len - value length in bytes
+*
+* @return
+*   TRUE if the record was appended, FALSE if the buffer is full
+*/
+PRIVATE BOOL ech_telemetry_tlv_add(UINT8 *buf_ptr,
+                                   UINT32 len,
+                                   UINT32 *pos_ptr,
+                                   UINT8 type,
+                                   VOID *value_ptr,
+                                   UINT32 value_len)
+{
+    ech_telemetry_tlv_struct tlv;
+    UINT32 pos = *pos_ptr;
+    UINT32 tlv_size = ECH_TELEMETRY_TLV_SIZE(value_len);
+
+    if ((pos + tlv_size) > len)
+    {
+        return (FALSE);
+    }
+
+    tlv.type = type;
+    tlv.reserved = 0;
+    tlv.len = (UINT16)value_len;
+
+    memset(&buf_ptr[pos], 0, tlv_size);
+    memcpy(&buf_ptr[pos], &tlv, sizeof(tlv));
+    memcpy(&buf_ptr[pos + sizeof(tlv)], value_ptr, value_len);
+    *pos_ptr = pos + tlv_size;
+
+    return (TRUE);
+}
+
+/**
+* @brief
+*   EXP_FW_TELEMETRY_SNAPSHOT_GET command handler. Returns the snapshot in
+*   the extended data buffer.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID ech_telemetry_cmd_process(VOID)
+{
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_telemetry_rsp_parms_struct* rsp_parms_ptr = (exp_fw_telemetry_rsp_parms_struct*)&rsp_ptr->parms;
+    UINT32 size;
+
+    size = ech_telemetry_snapshot_build(ech_ext_data_ptr_get(), ech_ext_data_size_get());
+
+    /* set response parameters */
+    rsp_parms_ptr->status = (0 != size) ? EXP_FW_API_SUCCESS : EXP_FW_API_FAILURE;
+    rsp_parms_ptr->version = ECH_TELEMETRY_VERSION;
+    rsp_parms_ptr->num_bytes_returned = size;
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = size;
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* send the response */
+    ech_oc_rsp_proc();
+
+} /* ech_telemetry_cmd_process */
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize the telemetry snapshot: read the flash partition information
+*   and register the EXP_FW_TELEMETRY_SNAPSHOT_GET command.
+*
+* @return
+*   None
+*
+* @note
+*   Must be called after the SPI flash is accessible.
+*/
+PUBLIC VOID ech_telemetry_init(VOID)
+{
+    memset(&ech_telemetry_flash, 0, sizeof(ech_telemetry_flash));
+    ech_telemetry_flash.boot_partition = (UINT8)flash_partition_boot_partition_id_get();
+    flash_partition_fw_version_get(FLASH_ACTIVE_IMAGE_INDEX, &ech_telemetry_flash.active);
+    flash_partition_fw_version_get(FLASH_REDUNDANT_IMAGE_INDEX, &ech_telemetry_flash.redundant);
+
+    ech_api_func_register(EXP_FW_TELEMETRY_SNAPSHOT_GET, ech_telemetry_cmd_process);
+}
+
+/**
+* @brief
+*   Build the telemetry snapshot. Safe from either VPE.
+*
+* @param[out] buf_ptr - snapshot buffer
+* @param[in]  len     - size of the buffer, ECH_TELEMETRY_SIZE_MAX holds
+*                       the complete snapshot
+*
+* @return
+*   Size of the snapshot in bytes, 0 if the buffer can not hold the header
+*
+* @note
+*   Records that do not fit in the buffer are left out, the header gives
+*   the number returned.
+*/
+PUBLIC UINT32 ech_telemetry_snapshot_build(UINT8 *buf_ptr, UINT32 len)
+{
+    ech_telemetry_hdr_struct hdr;
+    ech_telemetry_fw_struct fw;
+    ech_telemetry_boot_mode_struct boot_mode;
+    temp_sensor_plat_reading_struct temp[TEMP_SENSOR_PLAT_NUM];
+    serdes_plat_cal_status_struct serdes_cal;
+    ddr_phy_dl_update_status_struct ddr_dl_update;
+    ddr_phy_train_status_struct ddr_train;
+    ech_telemetry_error_struct error;
+    ech_telemetry_cmd_counts_struct cmd_counts;
+    UINT32 t_start = hal_cp0_counter_get();
+    UINT32 pos = sizeof(hdr);
+    UINT32 num_tlvs = 0;
+    UINT32 sensor;
+    UINT32 table;
+    UINT32 value_len;
+
+    if (len < sizeof(hdr))
+    {
+        return (0);
+    }
+
+    /* firmware version and uptime */
+    fw.major = FW_VERSION_MAJOR_RELEASE_NUMBER;
+    fw.minor = FW_VERSION_MINOR_RELEASE_NUMBER;
+    fw.patch = FW_VERSION_PATCH_RELEASE_NUMBER;
+    fw.build_num = FW_VERSION_CL_NUMBER;
+    fw.build_date = FW_VERSION_BUILD_DATE;
+    fw.uptime_seconds = opsw_timer0_read();
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_FW, &fw, sizeof(fw));
+
+    /* boot mode */
+    boot_mode.raw_boot_cfg = ech_raw_boot_cfg_get();
+    boot_mode.tl_mode = (UINT8)ech_tl_mode_get();
+    boot_mode.dl_boot_mode = (UINT8)ech_dl_boot_mode_get();
+    boot_mode.host_boot_mode = (UINT8)ech_host_boot_mode_get();
+    boot_mode.mfg_mode = (UINT8)ech_mfg_mode_get();
+    boot_mode.serdes_freq = (UINT8)ech_serdes_freq_get();
+    boot_mode.lane_cfg = (UINT8)ech_lane_cfg_get();
+    boot_mode.ocapi_loopback = (UINT8)ech_ocapi_loopback_get();
+    boot_mode.serdes_loopback = (UINT8)ech_serdes_loopback_get();
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_BOOT_MODE, &boot_mode, sizeof(boot_mode));
+
+    /* last temperature readings */
+    for (sensor = 0; sensor < TEMP_SENSOR_PLAT_NUM; sensor++)
+    {
+        temp_sensor_plat_reading_get(sensor, &temp[sensor]);
+    }
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_TEMPERATURE, temp, sizeof(temp));
+
+    /* periodic serdes calibration */
+    serdes_plat_cal_status_get(&serdes_cal);
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_SERDES_CAL, &serdes_cal, sizeof(serdes_cal));
+
+    /* extended error code */
+    memset(&error, 0, sizeof(error));
+    error.ext_err_code = ech_extended_error_code_get();
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_ERROR, &error, sizeof(error));
+
+    /* command counts, one record per statistics table */
+    for (table = 0; table < ECH_STATS_NUM_TABLES; table++)
+    {
+        cmd_counts.table = (UINT8)table;
+        cmd_counts.reserved = 0;
+        cmd_counts.num_cmds = (UINT8)ech_stats_counts_get(table, cmd_counts.count, ECH_TELEMETRY_CMDS_MAX);
+        value_len = sizeof(cmd_counts) - sizeof(cmd_counts.count) + (cmd_counts.num_cmds * sizeof(UINT32));
+        num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_CMD_COUNTS, &cmd_counts, value_len);
+    }
+
+    /* flash partitions */
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_FLASH, &ech_telemetry_flash, sizeof(ech_telemetry_flash));
+
+    /* DDR PHY delay line update policy */
+    ddr_phy_dl_update_status_get(&ddr_dl_update);
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_DDR_DL_UPDATE, &ddr_dl_update, sizeof(ddr_dl_update));
+
+    /* DDR PHY training, readable over TWI while EXP_FW_DDR_PHY_INIT runs */
+    ddr_phy_train_status_get(&ddr_train);
+    num_tlvs += ech_telemetry_tlv_add(buf_ptr, len, &pos, ECH_TELEMETRY_TYPE_DDR_TRAIN, &ddr_train, sizeof(ddr_train));
+
+    hdr.magic = ECH_TELEMETRY_MAGIC;
+    hdr.version = ECH_TELEMETRY_VERSION;
+    hdr.num_tlvs = (UINT8)num_tlvs;
+    hdr.size = (UINT16)pos;
+    hdr.ticks_per_ms = sys_timer_us_to_count(1000);
+    hdr.build_ticks = hal_cp0_counter_get() - t_start;
+    memcpy(buf_ptr, &hdr, sizeof(hdr));
+
+    return (pos);
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
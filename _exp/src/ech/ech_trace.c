@@ -0,0 +1,489 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup ECH
+* @{
+* @file
+* @brief
+*   Per-command trace implementation.
+*
+* @note
+*   An entry is committed with its sequence number invalidated first and
+*   written last, so a reader on the other VPE detects an entry that was
+*   rewritten while it was copied.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "cpuhal.h"
+#include "sys_timer_api.h"
+#include "ech_trace.h"
+#include "ech_stats.h"
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+#define ECH_TRACE_RING_MASK         (ECH_TRACE_RING_ENTRIES - 1)
+
+/* Sequence number of an entry being written */
+#define ECH_TRACE_SEQ_INVALID       0xFFFFFFFF
+
+/* Cursor entry index of no entry */
+#define ECH_TRACE_ENTRY_NONE        0xFFFFFFFF
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Ring of one VPE, only written by that VPE.
+*/
+typedef struct
+{
+    ech_trace_entry_struct entry[ECH_TRACE_RING_ENTRIES];   /**< Committed entries */
+    volatile UINT32        next_seq;                        /**< Sequence number of the next entry */
+    ech_trace_entry_struct open[ECH_TRACE_NUM_SRC];         /**< Records being built, per source */
+    BOOL                   open_valid[ECH_TRACE_NUM_SRC];   /**< Record is being built */
+    BOOL                   open_held[ECH_TRACE_NUM_SRC];    /**< Record kept open after the handler returned */
+} ech_trace_ring_struct;
+
+/*
+* Private Data
+*/
+
+PRIVATE ech_trace_ring_struct ech_trace_ring[ECH_TRACE_NUM_RINGS];
+
+/* Receipt time of the TWI command last deferred to VPE0 */
+PRIVATE volatile UINT32 ech_trace_defer_t_rx;
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Ring of the calling VPE.
+*
+* @return
+*   ring
+*/
+PRIVATE ech_trace_ring_struct* ech_trace_ring_get(VOID)
+{
+    UINT32 vpe = hal_sys_cpu_id_get();
+
+    return (&ech_trace_ring[(vpe < ECH_TRACE_NUM_RINGS) ? vpe : (ECH_TRACE_NUM_RINGS - 1)]);
+}
+
+/**
+* @brief
+*   Copy an entry from a ring.
+*
+* @param[in]  ring_idx  - ring
+* @param[in]  seq       - sequence number of the entry
+* @param[out] entry_ptr - entry, flagged ECH_TRACE_FLAG_LOST if it has been
+*                         overwritten
+*
+* @return
+*   None
+*/
+PRIVATE VOID ech_trace_entry_get(UINT32 ring_idx, UINT32 seq, ech_trace_entry_struct *entry_ptr)
+{
+    ech_trace_ring_struct *ring_ptr = &ech_trace_ring[ring_idx];
+    volatile ech_trace_entry_struct *slot_ptr = &ring_ptr->entry[seq & ECH_TRACE_RING_MASK];
+
+    memcpy(entry_ptr, (VOID *)slot_ptr, sizeof(*entry_ptr));
+    hal_mem_sync_rmb();
+
+    if ((entry_ptr->seq != seq) || (slot_ptr->seq != seq))
+    {
+        memset(entry_ptr, 0, sizeof(*entry_ptr));
+        entry_ptr->seq = seq;
+        entry_ptr->flags = ECH_TRACE_FLAG_LOST;
+    }
+}
+
+/**
+* @brief
+*   Commit the record of a source to the ring of the calling VPE.
+*
+* @param[in] ring_ptr - ring of the calling VPE
+* @param[in] src      - ECH_TRACE_SRC_xxx
+*
+* @return
+*   None
+*/
+PRIVATE VOID ech_trace_commit(ech_trace_ring_struct *ring_ptr, UINT8 src)
+{
+    ech_trace_entry_struct *rec_ptr = &ring_ptr->open[src];
+    volatile ech_trace_entry_struct *slot_ptr;
+    UINT32 seq;
+
+    ring_ptr->open_valid[src] = FALSE;
+    ring_ptr->open_held[src] = FALSE;
+
+    seq = ring_ptr->next_seq;
+    slot_ptr = &ring_ptr->entry[seq & ECH_TRACE_RING_MASK];
+
+    slot_ptr->seq = ECH_TRACE_SEQ_INVALID;
+    hal_mem_sync_wmb();
+    rec_ptr->seq = ECH_TRACE_SEQ_INVALID;
+    memcpy((VOID *)slot_ptr, rec_ptr, sizeof(*rec_ptr));
+    hal_mem_sync_wmb();
+    slot_ptr->seq = seq;
+    ring_ptr->next_seq = seq + 1;
+}
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize the command trace.
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_init(VOID)
+{
+    memset(ech_trace_ring, 0, sizeof(ech_trace_ring));
+    ech_trace_defer_t_rx = 0;
+}
+
+/**
+* @brief
+*   Start the record of a command received by the calling VPE.
+*
+* @param[in] src    - ECH_TRACE_SRC_xxx
+* @param[in] cmd_id - command ID
+* @param[in] req_id - request identifier of an OC command, 0 for TWI
+* @param[in] t_rx   - CP0 Count when the command was received
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_rx(UINT8 src, UINT8 cmd_id, UINT16 req_id, UINT32 t_rx)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+    ech_trace_entry_struct *rec_ptr = &ring_ptr->open[src];
+
+    memset(rec_ptr, 0, sizeof(*rec_ptr));
+    rec_ptr->src = src;
+    rec_ptr->cmd_id = cmd_id;
+    rec_ptr->req_id = req_id;
+    rec_ptr->t_rx = t_rx;
+    ring_ptr->open_valid[src] = TRUE;
+    ring_ptr->open_held[src] = FALSE;
+}
+
+/**
+* @brief
+*   Mark the TWI command being handled on VPE1 as deferred to VPE0. Called
+*   before the deferred command is handed over.
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_defer(VOID)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+
+    if (TRUE == ring_ptr->open_valid[ECH_TRACE_SRC_TWI])
+    {
+        ring_ptr->open[ECH_TRACE_SRC_TWI].flags |= ECH_TRACE_FLAG_DEFERRED;
+        ech_trace_defer_t_rx = ring_ptr->open[ECH_TRACE_SRC_TWI].t_rx;
+    }
+}
+
+/**
+* @brief
+*   Start the record of a deferred TWI command on VPE0. Its receipt time is
+*   the one recorded by VPE1.
+*
+* @param[in] cmd_id - command ID
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_deferred_rx(UINT8 cmd_id)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+
+    ech_trace_rx(ECH_TRACE_SRC_TWI, cmd_id, 0, ech_trace_defer_t_rx);
+    ring_ptr->open[ECH_TRACE_SRC_TWI].flags |= ECH_TRACE_FLAG_DEFERRED;
+}
+
+/**
+* @brief
+*   Record that the command handler is called.
+*
+* @param[in] src - ECH_TRACE_SRC_xxx
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_dispatch(UINT8 src)
+{
+    ech_trace_ring_get()->open[src].t_dispatch = hal_cp0_counter_get();
+}
+
+/**
+* @brief
+*   Record the response of the command being handled. The last call before
+*   the handler returns is kept.
+*
+* @param[in] src          - ECH_TRACE_SRC_xxx
+* @param[in] ext_data_len - response extended data length
+* @param[in] rc           - return code
+*
+* @return
+*   None
+*
+* @note
+*   Ignored if no command from src is being handled by the calling VPE.
+*/
+PUBLIC VOID ech_trace_done(UINT8 src, UINT32 ext_data_len, UINT32 rc)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+    ech_trace_entry_struct *rec_ptr = &ring_ptr->open[src];
+
+    if (TRUE == ring_ptr->open_valid[src])
+    {
+        rec_ptr->ext_data_len = ext_data_len;
+        rec_ptr->rc = rc;
+        rec_ptr->t_doorbell = hal_cp0_counter_get();
+    }
+}
+
+/**
+* @brief
+*   Keep the record of the command being handled open after its handler
+*   returns, for a handler that sends its response later from a main loop
+*   task. The record is committed by ech_trace_release().
+*
+* @param[in] src - ECH_TRACE_SRC_xxx
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_hold(UINT8 src)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+
+    if (TRUE == ring_ptr->open_valid[src])
+    {
+        ring_ptr->open[src].flags |= ECH_TRACE_FLAG_HELD;
+        ring_ptr->open_held[src] = TRUE;
+    }
+}
+
+/**
+* @brief
+*   Commit a record kept open by ech_trace_hold(), once the response has
+*   been sent.
+*
+* @param[in] src - ECH_TRACE_SRC_xxx
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_release(UINT8 src)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+
+    if ((TRUE == ring_ptr->open_valid[src]) && (TRUE == ring_ptr->open_held[src]))
+    {
+        ech_trace_commit(ring_ptr, src);
+    }
+}
+
+/**
+* @brief
+*   Record that the command handler returned and commit the record to the
+*   ring of the calling VPE, unless it is held.
+*
+* @param[in] src - ECH_TRACE_SRC_xxx
+*
+* @return
+*   None
+*/
+PUBLIC VOID ech_trace_return(UINT8 src)
+{
+    ech_trace_ring_struct *ring_ptr = ech_trace_ring_get();
+    ech_trace_entry_struct *rec_ptr = &ring_ptr->open[src];
+
+    if (FALSE == ring_ptr->open_valid[src])
+    {
+        return;
+    }
+
+    rec_ptr->t_return = hal_cp0_counter_get();
+
+    /* account the handler time, TWI commands on VPE0 were deferred */
+    if (0 != rec_ptr->t_dispatch)
+    {
+        ech_stats_update((ECH_TRACE_SRC_OC == src) ? ECH_STATS_TABLE_OC :
+                         (0 == hal_sys_cpu_id_get()) ? ECH_STATS_TABLE_TWI_DEFERRED : ECH_STATS_TABLE_TWI,
+                         rec_ptr->cmd_id,
+                         rec_ptr->t_return - rec_ptr->t_dispatch);
+    }
+
+    if (FALSE == ring_ptr->open_held[src])
+    {
+        ech_trace_commit(ring_ptr, src);
+    }
+}
+
+/**
+* @brief
+*   Start reading the trace. The entries in the rings at this point are
+*   returned by the following reads.
+*
+* @param[out] cursor_ptr - read cursor
+*
+* @return
+*   Size of the trace image in bytes
+*/
+PUBLIC UINT32 ech_trace_read_start(ech_trace_cursor_struct *cursor_ptr)
+{
+    UINT32 ring_idx;
+    UINT32 next_seq;
+    UINT32 count;
+    UINT32 total = 0;
+
+    memset(cursor_ptr, 0, sizeof(*cursor_ptr));
+    cursor_ptr->hdr.magic = ECH_TRACE_MAGIC;
+    cursor_ptr->hdr.version = ECH_TRACE_VERSION;
+    cursor_ptr->hdr.entry_size = sizeof(ech_trace_entry_struct);
+    cursor_ptr->hdr.num_rings = ECH_TRACE_NUM_RINGS;
+    cursor_ptr->hdr.ticks_per_ms = sys_timer_us_to_count(1000);
+    cursor_ptr->entry_idx = ECH_TRACE_ENTRY_NONE;
+
+    for (ring_idx = 0; ring_idx < ECH_TRACE_NUM_RINGS; ring_idx++)
+    {
+        next_seq = ech_trace_ring[ring_idx].next_seq;
+        count = (next_seq < ECH_TRACE_RING_ENTRIES) ? next_seq : ECH_TRACE_RING_ENTRIES;
+
+        cursor_ptr->first_seq[ring_idx] = next_seq - count;
+        cursor_ptr->hdr.num_entries[ring_idx] = (UINT16)count;
+        total += count;
+    }
+
+    return (sizeof(ech_trace_hdr_struct) + (total * sizeof(ech_trace_entry_struct)));
+}
+
+/**
+* @brief
+*   Read part of the trace image.
+*
+* @param[in,out] cursor_ptr - read cursor from ech_trace_read_start()
+* @param[in]     offset     - offset in the trace image
+* @param[out]    buf_ptr    - buffer
+* @param[in]     len        - number of bytes to read
+*
+* @return
+*   Number of bytes read, less than len at the end of the image
+*
+* @note
+*   An entry overwritten since the read started is returned with only its
+*   sequence number and ECH_TRACE_FLAG_LOST set.
+*/
+PUBLIC UINT32 ech_trace_read(ech_trace_cursor_struct *cursor_ptr,
+                             UINT32 offset,
+                             UINT8 *buf_ptr,
+                             UINT32 len)
+{
+    UINT32 hdr_size = sizeof(ech_trace_hdr_struct);
+    UINT32 entry_size = sizeof(ech_trace_entry_struct);
+    UINT32 num_entries = 0;
+    UINT32 ring_idx;
+    UINT32 entry_idx;
+    UINT32 pos;
+    UINT32 chunk;
+    UINT32 done = 0;
+    UINT8 *src_ptr;
+
+    for (ring_idx = 0; ring_idx < ECH_TRACE_NUM_RINGS; ring_idx++)
+    {
+        num_entries += cursor_ptr->hdr.num_entries[ring_idx];
+    }
+
+    while (done < len)
+    {
+        pos = offset + done;
+
+        if (pos < hdr_size)
+        {
+            src_ptr = (UINT8 *)&cursor_ptr->hdr + pos;
+            chunk = hdr_size - pos;
+        }
+        else
+        {
+            entry_idx = (pos - hdr_size) / entry_size;
+            if (entry_idx >= num_entries)
+            {
+                break;
+            }
+
+            if (entry_idx != cursor_ptr->entry_idx)
+            {
+                /* find the ring of the entry */
+                UINT32 idx = entry_idx;
+
+                for (ring_idx = 0; idx >= cursor_ptr->hdr.num_entries[ring_idx]; ring_idx++)
+                {
+                    idx -= cursor_ptr->hdr.num_entries[ring_idx];
+                }
+
+                ech_trace_entry_get(ring_idx, cursor_ptr->first_seq[ring_idx] + idx, &cursor_ptr->entry);
+                cursor_ptr->entry_idx = entry_idx;
+            }
+
+            src_ptr = (UINT8 *)&cursor_ptr->entry + ((pos - hdr_size) % entry_size);
+            chunk = entry_size - ((pos - hdr_size) % entry_size);
+        }
+
+        if (chunk > (len - done))
+        {
+            chunk = len - done;
+        }
+        memcpy(&buf_ptr[done], src_ptr, chunk);
+        done += chunk;
+    }
+
+    return (done);
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
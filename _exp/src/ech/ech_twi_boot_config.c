@@ -53,6 +53,7 @@
 #include "serdes_config_guide.h"
 #include "serdes_cg_supplement.h"
 #include "serdes_api.h"
+#include "app_fw_boot_prof.h"
 
 /*
 * Local Enumerated Types
@@ -398,6 +399,8 @@ PUBLIC UINT32 ech_twi_boot_config_proc(UINT8* rx_buf, UINT32 rx_index)
             return EXP_TWI_BOOT_CFG_SERDES_INIT_FAIL_BITMASK;
         }
 
+        app_fw_boot_prof_mark(APP_FW_BOOT_MS_SERDES_INIT);
+
         /*
         ** Run the PRBS calibration sequence
         */
@@ -742,6 +745,8 @@ PUBLIC UINT32 ech_twi_boot_config_proc(UINT8* rx_buf, UINT32 rx_index)
 
         }
 
+        app_fw_boot_prof_mark(APP_FW_BOOT_MS_BOOT_CFG_0);
+
         return EXP_TWI_SUCCESS;
     }
 
@@ -943,6 +948,8 @@ PUBLIC UINT32 ech_twi_boot_config_proc(UINT8* rx_buf, UINT32 rx_index)
         */
         serdes_plat_periodic_cal_init(ech_serdes_prbs_cal_state_get());
 
+        app_fw_boot_prof_mark(APP_FW_BOOT_MS_BOOT_CFG_1);
+
         return EXP_TWI_SUCCESS;
     }
     /* unsupported boot stage, command failed */
@@ -56,6 +56,12 @@
 #include "ccb_api.h"
 #include "char_io.h"
 #include "app_fw_ddr.h"
+#include "app_fw_sched.h"
+#include "ech_trace.h"
+#include "ech_stats.h"
+#include "app_fw_boot_prof.h"
+#include "ech_telemetry.h"
+#include "log_chan.h"
 
 
 /*
@@ -79,7 +85,7 @@
 /*
 ** Forward declarations
 */
-EXTERN VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT8 rx_index);
+EXTERN VOID ech_twi_plat_slave_proc(UINT32 port_id, UINT8 *rx_buf_ptr, UINT32 rx_index);
 
 
 /*
@@ -126,6 +132,20 @@ PRIVATE BOOL ech_twi_poll_abort_flag = TRUE;
 PRIVATE UINT32 read_ddr_params_offset = 0;
 #endif
 
+/* Read cursor and position of ech_twi_read_cmd_trace */
+PRIVATE ech_trace_cursor_struct ech_twi_cmd_trace_cursor;
+PRIVATE UINT32 ech_twi_cmd_trace_offset = 0;
+
+/* Read cursor, position and clear request of ech_twi_read_cmd_stats */
+PRIVATE ech_stats_cursor_struct ech_twi_cmd_stats_cursor;
+PRIVATE UINT32 ech_twi_cmd_stats_offset = 0;
+PRIVATE BOOL ech_twi_cmd_stats_clear = FALSE;
+
+/* Snapshot, size and position of ech_twi_read_telemetry */
+PRIVATE UINT8 ech_twi_telemetry_buf[ECH_TELEMETRY_SIZE_MAX];
+PRIVATE UINT32 ech_twi_telemetry_size = 0;
+PRIVATE UINT32 ech_twi_telemetry_offset = 0;
+
 /*
 ** see EBCF-10490
 ** when TWI writes are into 64-bit OCMB memory space, the first 32-bit
@@ -186,7 +206,11 @@ PRIVATE UINT32 ech_twi_cmd_len[EXP_FW_TWI_CMD_MAX] =
     EXP_TWI_EXP_FW_PRBS_CAL_STATUS_READ_CMD_LEN,         /**< Report further information about the PRBS cal that was performed */
     EXP_TWI_EXP_FW_CONT_SERDES_CAL_DISABLE_CMD_LEN,      /**< Disable / re-enable SerDes continuous calibration */
     EXP_TWI_EXP_FW_READ_ACTIVE_LOGS_CMD_LEN,             /**< Read active logs over TWI interface */
-    EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_CMD_LEN         /**< Read DDR parameters that are saved in flash over the TWI interface */
+    EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_CMD_LEN,        /**< Read DDR parameters that are saved in flash over the TWI interface */
+    EXP_TWI_EXP_FW_READ_CMD_TRACE_CMD_LEN,               /**< Read the per-command trace over the TWI interface */
+    EXP_TWI_EXP_FW_READ_CMD_STATS_CMD_LEN,               /**< Read the per-command statistics over the TWI interface */
+    EXP_TWI_EXP_FW_READ_BOOT_PROFILE_CMD_LEN,            /**< Read the boot phase profile over the TWI interface */
+    EXP_TWI_EXP_FW_READ_TELEMETRY_CMD_LEN                /**< Read the telemetry snapshot over the TWI interface */
 };
 
 
@@ -282,6 +306,11 @@ PUBLIC UINT8 ech_twi_status_byte_get(VOID)
 PUBLIC VOID ech_twi_status_byte_set(UINT8 status_byte)
 {
     ech_twi_status_byte = status_byte;
+
+    if (EXP_TWI_BUSY != status_byte)
+    {
+        ech_trace_done(ECH_TRACE_SRC_TWI, 0, status_byte);
+    }
 }
 
 /**
@@ -311,8 +340,12 @@ PUBLIC VOID ech_twi_deferred_cmd_processing_struct_set(exp_twi_cmd_enum cmd_id,
     ech_def_handler.cmd_buf_idx = rx_index;
     ech_def_handler.callback_handler = callback_func_ptr;
     ech_def_handler.deferred_cmd_handler = func_ptr;
+    ech_trace_defer();
     ech_def_handler.deferred_cmd_flag = TRUE;
 
+    /* wake up the VPE0 task that runs it */
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_TWI_DEFERRED);
+
     /*
     ** Since this command will be handled by VPE0,
     ** increase rx index to allow the processing
@@ -387,6 +420,16 @@ PUBLIC PMCFW_ERROR ech_twi_slv_cmd_rx(UINT32 port_id,
             return (rc);
         }
 
+        if (data_len > (EXP_TWI_MAX_BUF_SIZE - *rx_len_ptr))
+        {
+            /*
+            ** the bytes held for an incomplete command and the new data do
+            ** not fit, the held bytes can not start a valid command
+            */
+            *rx_len_ptr = 0;
+            ech_twi_rx_index = 0;
+        }
+
         /* get the data */
         rc = twi_slv_data_get(port_id, &rx_buf_ptr[*rx_len_ptr], data_len);
         if (rc != PMC_SUCCESS)
@@ -496,7 +539,7 @@ PUBLIC VOID ech_twi_status_proc(UINT32 port_id)
 PUBLIC VOID ech_twi_reg_addr_latch_proc(UINT8* rx_buf)
 {
     /* record the register address */
-    UINT32 reg_addr = (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 0] << 24) |
+    UINT32 reg_addr = ((UINT32)rx_buf[EXP_TWI_CMD_DATA_OFFSET + 0] << 24) |
                       (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 1] << 16) |
                       (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 2] << 8) |
                       (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 3]);
@@ -596,6 +639,28 @@ PUBLIC VOID ech_twi_reg_read_proc(UINT32 port_id, UINT8* rx_buf)
 
     /* get the latched address */
     UINT32 latched_reg_addr = ech_latched_reg_addr_get();
+    BOOL addr_valid;
+
+    /*
+    ** check the address again, the extended error code is also set by
+    ** other commands and the latch is invalidated by each read
+    */
+    if (OCMB_REGS_BASE_ADDR == (latched_reg_addr & ECH_REG_64_BIT_MASK))
+    {
+        addr_valid = (TRUE == ocmb_reg_addr_valid(latched_reg_addr)) &&
+                     (FALSE == ocmb_reg_addr_write_only(latched_reg_addr));
+    }
+    else
+    {
+        addr_valid = ech_reg_addr_validate(latched_reg_addr);
+    }
+
+    if ((EXP_TWI_SUCCESS == err_code) && (FALSE == addr_valid))
+    {
+        /* no address latched since the last read */
+        err_code = EXP_TWI_REG_RW_ADDR_OUT_OF_RANGE;
+        ech_extended_error_code_set(err_code);
+    }
 
     if (EXP_TWI_SUCCESS != err_code)
     {
@@ -654,13 +719,13 @@ PUBLIC VOID ech_twi_reg_write_proc(UINT8* rx_buf)
     UINT32 reg_data;
 
     /* prepare the register address */
-    reg_addr = (rx_buf[EXP_TWI_CMD_DATA_OFFSET]     << 24) |
+    reg_addr = ((UINT32)rx_buf[EXP_TWI_CMD_DATA_OFFSET]     << 24) |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 1] << 16) |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 2] << 8)  |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 3]);
 
     /* prepare the register data */
-    reg_data = (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 4] << 24) |
+    reg_data = ((UINT32)rx_buf[EXP_TWI_CMD_DATA_OFFSET + 4] << 24) |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 5] << 16) |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 6] << 8)  |
                (rx_buf[EXP_TWI_CMD_DATA_OFFSET + 7]);
@@ -1222,6 +1287,222 @@ PUBLIC VOID ech_twi_read_saved_ddr_params(UINT8* rx_buf_ptr, UINT32 rx_index, UI
     ech_twi_rx_index_inc(EXP_TWI_EXP_FW_READ_SAVED_DDR_PARAMS_CMD_LEN);
 }
 
+/**
+* @brief
+*   Process the EXP_FW_READ_CMD_TRACE command
+*   Passes the per-command trace (see ech_trace.h) over the TWI
+*   interface in pieces. Indicates to the host through the
+*   data_continues variable if there is more data to be read.
+*   The entries returned are fixed by the read with the start
+*   flag set, later commands are returned by the next start.
+* @param [in] rx_buf_ptr  - received data to process
+* @param [in] rx_index - index in buffer of start of received
+*                command
+* @param [in] port_id - TWI port ID
+* @return
+*   nothing
+*
+* @note
+*/
+PUBLIC VOID ech_twi_read_cmd_trace(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id)
+{
+    UINT32 bytes_copied;
+    UINT8 data_continues;
+    UINT8 start_read = rx_buf_ptr[rx_index + 2];
+
+    /* Fix the entries to return on the first read */
+    if (start_read)
+    {
+        (VOID)ech_trace_read_start(&ech_twi_cmd_trace_cursor);
+        ech_twi_cmd_trace_offset = 0;
+    }
+
+    /* Copy a section of the trace to the rsp buffer */
+    bytes_copied = ech_trace_read(&ech_twi_cmd_trace_cursor,
+                                  ech_twi_cmd_trace_offset,
+                                  &ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET + 1],
+                                  EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_DATA_LEN);
+
+    (bytes_copied < EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_DATA_LEN) ? (data_continues = 0) : (data_continues = 1);
+
+    ech_twi_cmd_trace_offset += bytes_copied;
+
+    ech_twi_status_byte_set(EXP_TWI_SUCCESS);
+
+    ech_twi_tx_buf[EXP_TWI_RSP_LEN_OFFSET] = bytes_copied + 1;
+    ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET] = data_continues;
+
+    /* send the response */
+    twi_slv_data_put(port_id,
+                     ech_twi_tx_buf,
+                     EXP_TWI_EXP_FW_READ_CMD_TRACE_RSP_LEN);
+
+    /* increment receive buffer index */
+    ech_twi_rx_index_inc(EXP_TWI_EXP_FW_READ_CMD_TRACE_CMD_LEN);
+}
+
+/**
+* @brief
+*   Process the EXP_FW_READ_CMD_STATS command
+*   Passes the per-command statistics (see ech_stats.h) over the
+*   TWI interface in pieces. Indicates to the host through the
+*   data_continues variable if there is more data to be read.
+*   The commands returned are fixed by the read with the start
+*   flag set. If the clear flag is set with it, the statistics
+*   are cleared once the last piece has been returned.
+* @param [in] rx_buf_ptr  - received data to process
+* @param [in] rx_index - index in buffer of start of received
+*                command
+* @param [in] port_id - TWI port ID
+* @return
+*   nothing
+*
+* @note
+*/
+PUBLIC VOID ech_twi_read_cmd_stats(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id)
+{
+    UINT32 bytes_copied;
+    UINT8 data_continues;
+    UINT8 read_flags = rx_buf_ptr[rx_index + 2];
+
+    /* Fix the commands to return on the first read */
+    if (read_flags & EXP_TWI_EXP_FW_READ_CMD_STATS_START)
+    {
+        (VOID)ech_stats_read_start(&ech_twi_cmd_stats_cursor);
+        ech_twi_cmd_stats_offset = 0;
+        ech_twi_cmd_stats_clear = (0 != (read_flags & EXP_TWI_EXP_FW_READ_CMD_STATS_CLEAR));
+    }
+
+    /* Copy a section of the statistics to the rsp buffer */
+    bytes_copied = ech_stats_read(&ech_twi_cmd_stats_cursor,
+                                  ech_twi_cmd_stats_offset,
+                                  &ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET + 1],
+                                  EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_DATA_LEN);
+
+    (bytes_copied < EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_DATA_LEN) ? (data_continues = 0) : (data_continues = 1);
+
+    ech_twi_cmd_stats_offset += bytes_copied;
+
+    /* Clear once everything has been read */
+    if ((0 == data_continues) && (TRUE == ech_twi_cmd_stats_clear))
+    {
+        ech_stats_clear();
+        ech_twi_cmd_stats_clear = FALSE;
+    }
+
+    ech_twi_status_byte_set(EXP_TWI_SUCCESS);
+
+    ech_twi_tx_buf[EXP_TWI_RSP_LEN_OFFSET] = bytes_copied + 1;
+    ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET] = data_continues;
+
+    /* send the response */
+    twi_slv_data_put(port_id,
+                     ech_twi_tx_buf,
+                     EXP_TWI_EXP_FW_READ_CMD_STATS_RSP_LEN);
+
+    /* increment receive buffer index */
+    ech_twi_rx_index_inc(EXP_TWI_EXP_FW_READ_CMD_STATS_CMD_LEN);
+}
+
+/**
+* @brief
+*   Process the EXP_FW_READ_BOOT_PROFILE command
+*   Returns the boot phase profile (app_fw_boot_prof_struct, see
+*   app_fw_boot_prof.h) in a single response. Available as soon
+*   as the TWI slave is up.
+* @param [in] rx_buf_ptr  - received data to process
+* @param [in] rx_index - index in buffer of start of received
+*                command
+* @param [in] port_id - TWI port ID
+* @return
+*   nothing
+*
+* @note
+*/
+PUBLIC VOID ech_twi_read_boot_profile(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id)
+{
+    app_fw_boot_prof_struct prof;
+    UINT32 size;
+
+    size = app_fw_boot_prof_get(&prof);
+    PMCFW_ASSERT(size <= EXP_TWI_EXP_FW_READ_BOOT_PROFILE_RSP_DATA_LEN, PMCFW_ERR_NUMBER_OUT_OF_RANGE);
+
+    memcpy(&ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET], &prof, size);
+
+    ech_twi_status_byte_set(EXP_TWI_SUCCESS);
+
+    ech_twi_tx_buf[EXP_TWI_RSP_LEN_OFFSET] = size;
+
+    /* send the response */
+    twi_slv_data_put(port_id,
+                     ech_twi_tx_buf,
+                     EXP_TWI_EXP_FW_READ_BOOT_PROFILE_RSP_LEN);
+
+    /* increment receive buffer index */
+    ech_twi_rx_index_inc(EXP_TWI_EXP_FW_READ_BOOT_PROFILE_CMD_LEN);
+}
+
+/**
+* @brief
+*   Process the EXP_FW_READ_TELEMETRY command
+*   Passes the telemetry snapshot (see ech_telemetry.h) over the
+*   TWI interface in pieces. Indicates to the host through the
+*   data_continues variable if there is more data to be read.
+*   The snapshot is taken by the read with the start flag set,
+*   the following reads return the rest of the same snapshot.
+* @param [in] rx_buf_ptr  - received data to process
+* @param [in] rx_index - index in buffer of start of received
+*                command
+* @param [in] port_id - TWI port ID
+* @return
+*   nothing
+*
+* @note
+*/
+PUBLIC VOID ech_twi_read_telemetry(UINT8* rx_buf_ptr, UINT32 rx_index, UINT32 port_id)
+{
+    UINT32 bytes_copied = 0;
+    UINT8 data_continues;
+    UINT8 start_read = rx_buf_ptr[rx_index + 2];
+
+    /* Take the snapshot on the first read */
+    if (start_read)
+    {
+        ech_twi_telemetry_size = ech_telemetry_snapshot_build(ech_twi_telemetry_buf, sizeof(ech_twi_telemetry_buf));
+        ech_twi_telemetry_offset = 0;
+    }
+
+    /* Copy a section of the snapshot to the rsp buffer */
+    if (ech_twi_telemetry_offset < ech_twi_telemetry_size)
+    {
+        bytes_copied = ech_twi_telemetry_size - ech_twi_telemetry_offset;
+        if (bytes_copied > EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_DATA_LEN)
+        {
+            bytes_copied = EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_DATA_LEN;
+        }
+        memcpy(&ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET + 1],
+               &ech_twi_telemetry_buf[ech_twi_telemetry_offset],
+               bytes_copied);
+    }
+
+    (bytes_copied < EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_DATA_LEN) ? (data_continues = 0) : (data_continues = 1);
+
+    ech_twi_telemetry_offset += bytes_copied;
+
+    ech_twi_status_byte_set(EXP_TWI_SUCCESS);
+
+    ech_twi_tx_buf[EXP_TWI_RSP_LEN_OFFSET] = bytes_copied + 1;
+    ech_twi_tx_buf[EXP_TWI_RSP_DATA_OFFSET] = data_continues;
+
+    /* send the response */
+    twi_slv_data_put(port_id,
+                     ech_twi_tx_buf,
+                     EXP_TWI_EXP_FW_READ_TELEMETRY_RSP_LEN);
+
+    /* increment receive buffer index */
+    ech_twi_rx_index_inc(EXP_TWI_EXP_FW_READ_TELEMETRY_CMD_LEN);
+}
+
 /**
 * @brief
 *   Return a pointer to the TWI transmit buffer
@@ -1267,6 +1548,10 @@ PUBLIC VOID ech_twi_slave_proc(UINT32 port_id)
 
 {
     static BOOL dummy_data_send_flag = TRUE;
+    UINT32 t_rx;
+    UINT32 rx_index;
+    UINT8 prev_chan;
+
     /* check TWI interface for any activity */
     if (PMC_SUCCESS != ech_twi_slv_cmd_rx(port_id, ech_twi_rx_buf, &ech_twi_rx_len, &twi_activity))
     {
@@ -1294,6 +1579,9 @@ PUBLIC VOID ech_twi_slave_proc(UINT32 port_id)
         return;
     }
 
+    /* commands in the receive buffer were received now */
+    t_rx = hal_cp0_counter_get();
+
     while(ech_twi_rx_len > ech_twi_rx_index)
     {
         /*
@@ -1322,11 +1610,27 @@ PUBLIC VOID ech_twi_slave_proc(UINT32 port_id)
         */
         dummy_data_send_flag = FALSE;
 
+        rx_index = ech_twi_rx_index;
+        prev_chan = log_chan_enter(log_chan_twi_cmd_chan_get(ech_twi_rx_buf[ech_twi_rx_index]));
+        ech_trace_rx(ECH_TRACE_SRC_TWI, ech_twi_rx_buf[ech_twi_rx_index], 0, t_rx);
+        ech_trace_dispatch(ECH_TRACE_SRC_TWI);
         ech_twi_plat_slave_proc(port_id, ech_twi_rx_buf , ech_twi_rx_index);
+        ech_trace_return(ECH_TRACE_SRC_TWI);
+        log_chan_exit(prev_chan);
+
+        if (ech_twi_rx_index == rx_index)
+        {
+            /*
+            ** the command was not consumed, such as an unsupported command
+            ** whose length is unknown: the rest of the buffer can not be
+            ** parsed, drop it rather than handle the same byte forever
+            */
+            ech_twi_rx_index = ech_twi_rx_len;
+        }
 
         if ((ech_twi_rx_index != 0) &&
             (ech_twi_rx_len != 0) &&
-            (ech_twi_rx_index == ech_twi_rx_len))
+            (ech_twi_rx_index >= ech_twi_rx_len))
         {
             /*
             ** all data in receive buffer has been processed
@@ -30,7 +30,13 @@
 #include "target_platform.h"
 #include "pmc_hw_base.h"
 #include "exp_ddr_ctrlr.h"
+#include "exp_ddr_ctrlr_plat.h"
+#include "exp_ddr_ctrlr_spd.h"
 #include "ddr_phy.h"
+#include "bc_printf.h"
+#include "twi_api.h"
+#include "twi_plat.h"
+#include "exp_api.h"
 
 
 /*
@@ -43,350 +49,23 @@
 
 exp_ddr_ctrlr_spd_config_struct ocmb_config;
 
-/**
-* @brief
-*   This enumeration specifies the supported SPD configurations.
-*/
-typedef enum
-{
-    OCMB_PALLADIUM_SPD_CONFIG,          /**< SPD Configuration used for emulation */
-    OCMB_UDIMM_SPD_CONFIG_x8_1R_2666,   /**< SPD Configuration for x8-1R-UDIMM-2666 */
-    OCMB_UDIMM_SPD_CONFIG_x8_2R_3200,	/**< SPD Configuration for x8-2R-UDIMM-3200 */
-    OCMB_RDIMM_SPD_CONFIG_x4_2R_3200,	/**< SPD Configuration for x4-2R-RDIMM-3200 */
-    OCMB_UDIMM_SPD_CONFIG_x16_1R_2666,  /**< SPD Configuration for x16-1R-UDIMM-2666 */
-    OCMB_UDIMM_SPD_CONFIG_x8_1R_3200,	/**< SPD Configuration for x8-1R-UDIMM-3200 */
-    OCMB_NUM_SPD_CONFIG                 /**< Number of SPD configurations */
-} ocmb_spd_config_index_enum;
-
-PRIVATE const exp_ddr_ctrlr_spd_config_struct ocmb_spd_config_array[OCMB_NUM_SPD_CONFIG] = {
-    [OCMB_PALLADIUM_SPD_CONFIG] = {
-        .dram_size          = 8,
-        .dram_width         = 8, // or 4
-        .ranks              = 1,
-        .rdimm              = 0,
-        .rdimm_buffer_delay = 0, // probably do not care?
-        .dfimrl_clk         = 0x9,
-        .clk_freq           = 1600,      //1600MHz aka DDR3200
-        .topo_type          = SINGLE_CHANNEL,
-        .package_type       = SDP,
-        .die_count          = 10, // 20 for x4
-        .v3ds_height        = 0,
-        .cl                 = 20,
-        .cwl                = 16,
-
-        /* The following config settings are all in ps */ // Check with Riad check that is also running at 3200 MHz
-        .tRCD               = 12500,
-        .tRP                = 12500,
-        .tRAS               = 32000,
-        .tRC                = 45750,
-        .tRFC1              = 550000,
-        .tRFC2              = 350000,
-        .tRFC4              = 260000,
-        .tFAW               = 21000,
-        .tRRD_S             = 3000,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tRRD_L             = 4900,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tCCD_L             = 5000,
-        .tWR                = 15000,
-        .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-        .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-
-        .rcd_par_retry      = 0,
-        .v2t_mode           = 0,
-
-        .enterprise_mode    = 0,
-        .half_dimm_mode     = 0,
-
-        .rd_odt.rank0       = 0x7,
-        .rd_odt.rank1       = 0x7,
-        .rd_odt.rank2       = 0x7,
-        .rd_odt.rank3       = 0x7,
-        .rd_odt.rank4       = 0x7,
-        .rd_odt.rank5       = 0x7,
-        .rd_odt.rank6       = 0x7,
-        .rd_odt.rank7       = 0x7,
-
-        .wr_odt.rank0       = 0x7,
-        .wr_odt.rank1       = 0x7,
-        .wr_odt.rank2       = 0x7,
-        .wr_odt.rank3       = 0x7,
-        .wr_odt.rank4       = 0x7,
-        .wr_odt.rank5       = 0x7,
-        .wr_odt.rank6       = 0x7,
-        .wr_odt.rank7       = 0x7
-    },
-    [OCMB_UDIMM_SPD_CONFIG_x8_1R_2666] = {
-        .dram_size          = 8,
-        .dram_width         = 8,
-        .ranks              = 1,
-        .rdimm              = 0,
-        .rdimm_buffer_delay = 0, // probably do not care?
-        .dfimrl_clk         = 0xA,
-        .clk_freq           = 1333,      //1600MHz aka DDR3200
-        .topo_type          = SINGLE_CHANNEL,
-        .package_type       = SDP,
-        .die_count          = 9, // 20 for x4
-        .v3ds_height        = 1,
-        .cl                 = 19,
-        .cwl                = 14,
-        /* The following config settings are all in ps */ // Check with Riad check that is also running at 3200 MHz
-        .tRCD               = 13750,
-        .tRP                = 13750,
-        .tRAS               = 32000,
-        .tRC                = 45750,
-        .tRFC1              = 350000,
-        .tRFC2              = 260000,
-        .tRFC4              = 160000,
-        .tFAW               = 21000,
-        .tRRD_S             = 3000,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tRRD_L             = 4900,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tCCD_L             = 5000,
-        .tWR                = 15000,
-        .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-        .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-        .rcd_par_retry      = 0,
-        .v2t_mode           = 0,
-        .enterprise_mode    = 0,
-        .half_dimm_mode     = 0,
-        .rd_odt.rank0       = 0x40,
-        .rd_odt.rank1       = 0x80,
-        .rd_odt.rank2       = 0x40,
-        .rd_odt.rank3       = 0x80,
-        .rd_odt.rank4       = 0x04,
-        .rd_odt.rank5       = 0x08,
-        .rd_odt.rank6       = 0x04,
-        .rd_odt.rank7       = 0x08,
-        .wr_odt.rank0       = 0xAA,
-        .wr_odt.rank1       = 0x40,
-        .wr_odt.rank2       = 0x80,
-        .wr_odt.rank3       = 0x40,
-        .wr_odt.rank4       = 0x08,
-        .wr_odt.rank5       = 0x04,
-        .wr_odt.rank6       = 0x08,
-        .wr_odt.rank7       = 0x04
-    },
-    [OCMB_UDIMM_SPD_CONFIG_x8_2R_3200] = {
-       .dram_size          = 8,
-       .dram_width         = 8,
-       .ranks              = 2,
-       .rdimm              = 0,
-       .rdimm_buffer_delay = 0, // probably do not care?
-       //.dfimrl_clk         = 0x9, // default and working
-       .dfimrl_clk         = 0xA, //As per PREP "509638"
-       .clk_freq           = 1600,      //1600MHz aka DDR3200
-       .topo_type          = SINGLE_CHANNEL,
-       .package_type       = SDP,
-       .die_count          = 16,
-       .v3ds_height        = 0,
-       .cl					= 22,
-       .cwl                = 16,
-       // The following config settings are all in ps // Check with Riad check that is also running at 3200 MHz
-       .tRCD               = 13750,
-       .tRP                = 13750,
-       .tRAS               = 32000,
-       .tRC                = 45750,
-       .tRFC1              = 350000,
-       .tRFC2              = 260000,
-       .tRFC4              = 160000,
-       .tFAW               = 21000,
-       .tRRD_S             = 2500,  //AE Note: JEDEC spec has min of 4 CLKs
-       .tRRD_L             = 4900,  //AE Note: JEDEC spec has min of 4 CLKs
-       .tCCD_L             = 5000,
-       .tWR                = 15000,
-       .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-       .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-       .rcd_par_retry      = 0,
-       .v2t_mode           = 0,
-       .enterprise_mode    = 0,
-       .half_dimm_mode     = 0,
-
-       .rd_odt.rank0       = 0x44, //working one
-       .rd_odt.rank1       = 0x88, //working one
-       //.rd_odt.rank0       = 0x88, //Alex new suggestion not working for this config
-       //.rd_odt.rank1       = 0x44, //Alex new suggestion not working for this config
-       .rd_odt.rank2       = 0x00,
-       .rd_odt.rank3       = 0x00,
-       .rd_odt.rank4       = 0x00,
-       .rd_odt.rank5       = 0x00,
-       .rd_odt.rank6       = 0x00,
-       .rd_odt.rank7       = 0x00,
-
-       .wr_odt.rank0       = 0x44,
-       .wr_odt.rank1       = 0x88,
-       .wr_odt.rank2       = 0x00,
-       .wr_odt.rank3       = 0x00,
-       .wr_odt.rank4       = 0x00,
-       .wr_odt.rank5       = 0x00,
-       .wr_odt.rank6       = 0x00,
-       .wr_odt.rank7       = 0x00
-    },
-    [OCMB_RDIMM_SPD_CONFIG_x4_2R_3200] = {
-        .dram_size          = 8,
-        .dram_width         = 4,
-        .ranks              = 2,
-        .rdimm              = 1,
-        .rdimm_buffer_delay = 0, // probably do not care?
-
-        //.dfimrl_clk         = 0x9, //As per ALex Phy config
-        .dfimrl_clk         = 0xA, //As per PREP "509638"
-        .clk_freq           = 1600,      //1600MHz aka DDR3200
-
-        .topo_type          = SINGLE_CHANNEL,
-        .package_type       = SDP,
-        .die_count          = 18,
-        .v3ds_height        = 0,
-        .cl                 = 22,
-        .cwl                = 16,
-        /* The following config settings are all in ps */ // Check with Riad check that is also running at 3200 MHz
-        .tRCD               = 13750,
-        .tRP                = 13750,
-        .tRAS               = 32500,        // Matching as per Kevin
-        .tRC                = 45750,
-        .tRFC1              = 350000,
-        .tRFC2              = 260000,
-        .tRFC4              = 160000,
-        .tFAW               = 10000,
-        .tRRD_S             = 2500,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tRRD_L             = 4900,     //AE Note: JEDEC spec has min of 4 CLKs
-        .tCCD_L             = 5000,
-        .tWR                = 15000,
-        .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-        .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-        .rcd_par_retry      = 0,
-        .v2t_mode           = 0,
-        .enterprise_mode    = 0,
-        .half_dimm_mode     = 0,
-
-        .rd_odt.rank0       = 0x44, //Working
-        .rd_odt.rank1       = 0x88, //Working
-        //.rd_odt.rank0       = 0x88, //Alex suggestion working only for x4
-        //.rd_odt.rank1       = 0x44, //Alex suggestion
-        .rd_odt.rank2       = 0x00,
-        .rd_odt.rank3       = 0x00,
-        .rd_odt.rank4       = 0x00,
-        .rd_odt.rank5       = 0x00,
-        .rd_odt.rank6       = 0x00,
-        .rd_odt.rank7       = 0x00,
-
-        .wr_odt.rank0       = 0x44, //Kevin-Working
-        .wr_odt.rank1		= 0x88, //Kevin-Working
-        .wr_odt.rank2		= 0x00,
-        .wr_odt.rank3		= 0x00,
-        .wr_odt.rank4		= 0x00,
-        .wr_odt.rank5		= 0x00,
-        .wr_odt.rank6		= 0x00,
-        .wr_odt.rank7		= 0x00
-    },
-    [OCMB_UDIMM_SPD_CONFIG_x16_1R_2666] = {
-       //.dram_size          = 4,
-       .dram_size          = 8,
-       .dram_width         = 16,
-       .ranks              = 1,
-       .rdimm              = 0,
-       .rdimm_buffer_delay = 0, // probably do not care?
-       //.dfimrl_clk         = 0x9, // Added by pchandr1
-       .dfimrl_clk         = 0xA, //As per PREP "509638"
-       .clk_freq           = 1333,      //1600MHz aka DDR3200
-       .topo_type          = SINGLE_CHANNEL,
-       .package_type       = SDP,
-       .die_count          = 4, // 20 for x4
-       .v3ds_height        = 0,
-       .cl                 = 19,
-       .cwl                = 14,
-       /* The following config settings are all in ps */ // Check with Riad check that is also running at 3200 MHz
-       .tRCD               = 13750,
-       .tRP                = 13750,
-       .tRAS               = 32000,
-       .tRC                = 47000, //Original
-       //.tRC                = 45750,
-       .tRFC1              = 350000,
-       .tRFC2              = 260000,
-       .tRFC4              = 160000,
-       .tFAW               = 30000,
-       .tRRD_S             = 5300,     //AE Note: JEDEC spec has min of 4 CLKs
-       .tRRD_L             = 6400,     //AE Note: JEDEC spec has min of 4 CLKs
-       .tCCD_L             = 5000,
-       .tWR                = 15000,
-       .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-       .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-       .rcd_par_retry      = 0,
-       .v2t_mode           = 0,
-       .enterprise_mode    = 0,
-       .half_dimm_mode     = 0,
-
-       .rd_odt.rank0       = 0x40,
-       .rd_odt.rank1       = 0x80,
-       .rd_odt.rank2       = 0x40,
-       .rd_odt.rank3       = 0x80,
-       .rd_odt.rank4       = 0x04,
-       .rd_odt.rank5       = 0x08,
-       .rd_odt.rank6       = 0x04,
-       .rd_odt.rank7       = 0x08,
-
-       .wr_odt.rank0       = 0xAA,
-       .wr_odt.rank1       = 0xFF,
-       .wr_odt.rank2       = 0xFF,
-       .wr_odt.rank3       = 0xFF,
-       .wr_odt.rank4       = 0xFF,
-       .wr_odt.rank5       = 0xFF,
-       .wr_odt.rank6       = 0xFF,
-       .wr_odt.rank7       = 0xFF
-    },
-    [OCMB_UDIMM_SPD_CONFIG_x8_1R_3200] = {
-        .dram_size          = 8,
-        .dram_width         = 8,
-        .ranks              = 1,
-        .rdimm              = 0,
-        .rdimm_buffer_delay = 0, // probably do not care?
-        //.dfimrl_clk         = 0x9, 
-        .dfimrl_clk         = 0xA, //As per PREP "509638"
-        .clk_freq           = 1600,      //1600MHz aka DDR3200
-        .topo_type          = SINGLE_CHANNEL,
-        .package_type       = SDP,
-        .die_count          = 9,  
-        //.v3ds_height        = 1, //original
-        .v3ds_height        = 0,
-        .cl					= 22, 
-        .cwl                = 16, 
-        /* The following config settings are all in ps */ // Check with Riad check that is also running at 3200 MHz
-        .tRCD               = 13750,
-        .tRP                = 13750,
-        .tRAS               = 32000,
-        .tRC                = 45750,
-        .tRFC1              = 350000,
-        .tRFC2              = 260000,
-        .tRFC4              = 160000,
-        .tFAW               = 21000,
-        .tRRD_S             = 2500,  //AE Note: JEDEC spec has min of 4 CLKs
-        .tRRD_L             = 4900,  //AE Note: JEDEC spec has min of 4 CLKs
-        .tCCD_L             = 5000,
-        .tWR                = 15000,
-        .tWTR_S             = 2500,      //AE Note: JEDEC spec has min of 2 CLKs
-        .tWTR_L             = 7500,      //AE Note: JEDEC spec has min of 4 CLKs
-        .rcd_par_retry      = 0,
-        .v2t_mode           = 0,
-        .enterprise_mode    = 0,
-        .half_dimm_mode     = 0,
-        
-		.rd_odt.rank0       = 0x00,
-        .rd_odt.rank1       = 0x00,
-        .rd_odt.rank2       = 0x00,
-        .rd_odt.rank3       = 0x00,
-        .rd_odt.rank4       = 0x00,
-        .rd_odt.rank5       = 0x00,
-        .rd_odt.rank6       = 0x00,
-        .rd_odt.rank7       = 0x00,
-            
-		.wr_odt.rank0       = 0xFF,
-        .wr_odt.rank1       = 0x00,
-        .wr_odt.rank2       = 0x00,
-        .wr_odt.rank3       = 0x00,
-        .wr_odt.rank4       = 0x00,
-        .wr_odt.rank5       = 0x00,	
-        .wr_odt.rank6       = 0x00,
-        .wr_odt.rank7       = 0x00
-    }
+#include "exp_ddr_ctrlr_spd_table.h"
+
+#if (EXPLORER_DDR_SPD_CALC == 1)
+/* DIMM SPD */
+PRIVATE twi_slave_struct exp_ddr_ctrlr_spd_twi = {
+    .port_id = EXP_TWI_MASTER_PORT,
+    .addr = EXPLORER_DDR_SPD_TWI_ADDR,
+    .addr_size = TWI_ADDR_SIZE_7BIT,
+    .stretch_timeout_ms = EXP_TWI_STRETCH_TIMEOUT_MS,
+    .stretch_timeout_ms_offset = 0,
+    .offset_size = TWI_OFFSET_SIZE_8BIT
 };
 
+PRIVATE exp_ddr_ctrlr_spd_struct exp_ddr_ctrlr_spd_info;
+PRIVATE BOOL exp_ddr_ctrlr_spd_valid = FALSE;
+#endif
+
 /*
 ** Global Variables
 */
@@ -395,6 +74,68 @@ PRIVATE const exp_ddr_ctrlr_spd_config_struct ocmb_spd_config_array[OCMB_NUM_SPD
 ** Local Functions
 */
 
+#if (EXPLORER_DDR_SPD_CALC == 1)
+/****************************************************************************
+*
+* FUNCTION: exp_ddr_ctrlr_spd_config_init
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Replaces the hard-coded SPD values with the ones calculated from the SPD
+*   of the DIMM, reporting where they differ.
+*
+* INPUTS:
+*   ocmb_spd_config - hard-coded values, the data rate of which is used.
+*
+* OUTPUTS:
+*   ocmb_spd_config - calculated values if the SPD is read and decoded.
+*
+* RETURNS:
+*   None.
+*
+* NOTES:
+*   The SPD base configuration is in the first page of the SPD EEPROM,
+*   which is the page selected at power on.
+*
+*****************************************************************************/
+PRIVATE VOID exp_ddr_ctrlr_spd_config_init(exp_ddr_ctrlr_spd_config_struct *ocmb_spd_config)
+{
+    UINT8 spd[EXP_DDR_CTRLR_SPD_BASE_SIZE];
+    exp_ddr_ctrlr_spd_config_struct calc;
+    exp_ddr_ctrlr_spd_clk_struct clk;
+    PMCFW_ERROR rc;
+
+    rc = twi_mst_rx_offset(&exp_ddr_ctrlr_spd_twi, 0, spd, sizeof(spd));
+    if (PMC_SUCCESS == rc)
+    {
+        rc = exp_ddr_ctrlr_spd_parse(spd, sizeof(spd), &exp_ddr_ctrlr_spd_info);
+    }
+    if (PMC_SUCCESS == rc)
+    {
+        /* settings the SPD does not describe are kept */
+        calc = *ocmb_spd_config;
+        rc = exp_ddr_ctrlr_spd_timing_calc(&exp_ddr_ctrlr_spd_info,
+                                           ocmb_spd_config->clk_freq * 2,
+                                           &calc,
+                                           &clk);
+    }
+    if (PMC_SUCCESS != rc)
+    {
+        bc_printf("SPD: not used, rc = 0x%x\n", rc);
+        return;
+    }
+
+    bc_printf("SPD: DDR4-%u CL%u CWL%u tRCD %u tRP %u tRAS %u tRC %u tRFC1 %u tFAW %u\n",
+              calc.clk_freq * 2, clk.cl, clk.cwl, clk.tRCD, clk.tRP, clk.tRAS,
+              clk.tRC, clk.tRFC1, clk.tFAW);
+    bc_printf("SPD: %u fields differ from the hard-coded configuration\n",
+              exp_ddr_ctrlr_spd_config_compare(&calc, ocmb_spd_config));
+
+    *ocmb_spd_config = calc;
+    exp_ddr_ctrlr_spd_valid = TRUE;
+}
+#endif
+
 /*
 ** Public Functions
 */
@@ -457,9 +198,49 @@ PUBLIC void exp_ddr_ctrlr_init(VOID)
     /* Load hard coded SPD input values. */
     exp_ddr_ctrlr_sample_spd_config_init(&ocmb_config);
 
+#if (EXPLORER_DDR_SPD_CALC == 1)
+    /* Use the configuration of the DIMM fitted if its SPD can be read */
+    exp_ddr_ctrlr_spd_config_init(&ocmb_config);
+#endif
+
     /* Apply SPD values. */
     exp_ddr_ctrlr_spd_config(OCMB_REGS_BASE_ADDR, ocmb_config);
 #endif
 }
 
+/****************************************************************************
+*
+* FUNCTION: exp_ddr_ctrlr_spd_info_get
+* __________________________________________________________________________
+*
+* DESCRIPTION:
+*   Returns the decoded SPD of the DIMM, when the bringup configuration was
+*   calculated from it.
+*
+* INPUTS:
+*   None.
+*
+* OUTPUTS:
+*   data_rate_ptr - data rate in MT/s the configuration was calculated for.
+*
+* RETURNS:
+*   Decoded SPD, NULL if the hard-coded SPD values are used.
+*
+* NOTES:
+*   Only valid after exp_ddr_ctrlr_init().
+*
+*****************************************************************************/
+PUBLIC const exp_ddr_ctrlr_spd_struct *exp_ddr_ctrlr_spd_info_get(UINT32 *data_rate_ptr)
+{
+#if (EXPLORER_DDR_SPD_CALC == 1)
+    if (exp_ddr_ctrlr_spd_valid)
+    {
+        *data_rate_ptr = ocmb_config.clk_freq * 2;
+        return (&exp_ddr_ctrlr_spd_info);
+    }
+#endif
+
+    return (NULL);
+}
+
 
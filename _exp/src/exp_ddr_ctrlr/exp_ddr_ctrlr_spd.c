@@ -0,0 +1,663 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup exp_ddr_ctrlr
+* @{
+* @file
+* @brief
+*   JEDEC DDR4 SPD parser and DDR timing calculator.
+*
+* @note
+*   Byte offsets and encodings are those of the DDR4 SPD base configuration
+*   section (JEDEC Standard No. 21-C, Annex L). Only the medium timebase of
+*   125ps and the fine timebase of 1ps are defined by the standard, an SPD
+*   with any other timebase is rejected.
+*/
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "bc_printf.h"
+#include "exp_ddr_ctrlr_spd.h"
+
+/*
+** Constants
+*/
+
+/* SPD byte offsets */
+#define SPD_DRAM_TYPE           2
+#define SPD_MODULE_TYPE         3
+#define SPD_DENSITY             4
+#define SPD_ADDRESSING          5
+#define SPD_PACKAGE             6
+#define SPD_ORGANIZATION        12
+#define SPD_BUS_WIDTH           13
+#define SPD_TIMEBASES           17
+#define SPD_TCK_MIN             18
+#define SPD_TCK_MAX             19
+#define SPD_CL_FIRST            20
+#define SPD_TAA_MIN             24
+#define SPD_TRCD_MIN            25
+#define SPD_TRP_MIN             26
+#define SPD_TRAS_TRC_MSN        27
+#define SPD_TRAS_MIN            28
+#define SPD_TRC_MIN             29
+#define SPD_TRFC1_MIN           30
+#define SPD_TRFC2_MIN           32
+#define SPD_TRFC4_MIN           34
+#define SPD_TFAW_MSN            36
+#define SPD_TFAW_MIN            37
+#define SPD_TRRD_S_MIN          38
+#define SPD_TRRD_L_MIN          39
+#define SPD_TCCD_L_MIN          40
+#define SPD_TWR_MSN             41
+#define SPD_TWR_MIN             42
+#define SPD_TWTR_MSN            43
+#define SPD_TWTR_S_MIN          44
+#define SPD_TWTR_L_MIN          45
+#define SPD_TCCD_L_FINE         117
+#define SPD_TRRD_L_FINE         118
+#define SPD_TRRD_S_FINE         119
+#define SPD_TRC_FINE            120
+#define SPD_TRP_FINE            121
+#define SPD_TRCD_FINE           122
+#define SPD_TAA_FINE            123
+#define SPD_TCK_MAX_FINE        124
+#define SPD_TCK_MIN_FINE        125
+#define SPD_CRC                 126
+
+/* SPD field values */
+#define SPD_DRAM_TYPE_DDR4      0x0C
+#define SPD_MODULE_RDIMM        0x01
+#define SPD_MODULE_LRDIMM       0x04
+#define SPD_MODULE_MINI_RDIMM   0x05
+#define SPD_MODULE_SO_RDIMM     0x08
+#define SPD_LOADING_3DS         0x02
+#define SPD_CL_HIGH_RANGE       0x80
+#define SPD_MTB_PS              125
+
+/* CAS latencies of the four CL bytes, one per bit */
+#define SPD_CL_COUNT            30
+
+/*
+** Write times of SPD revision 1.0, which does not define bytes 41 to 45,
+** the DDR4 values for every speed bin
+*/
+#define SPD_TWR_DEFAULT         15000
+#define SPD_TWTR_S_DEFAULT      2500
+#define SPD_TWTR_L_DEFAULT      7500
+
+/* JEDEC rounding guard band, in thousandths of a clock */
+#define SPD_ROUND_GUARD         974
+
+/* JEDEC minimum clock counts of the DDR4 timings that have one */
+#define SPD_TRRD_NCK_MIN        4
+#define SPD_TCCD_L_NCK_MIN      5
+#define SPD_TWTR_S_NCK_MIN      2
+#define SPD_TWTR_L_NCK_MIN      4
+
+/* PHY user input DIMM types */
+#define SPD_PHY_UDIMM           0
+#define SPD_PHY_RDIMM           1
+#define SPD_PHY_LRDIMM          2
+#define SPD_PHY_MAX_RANKS       4
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   DDR4 speed bin.
+*/
+typedef struct
+{
+    UINT16 data_rate;   /**< MT/s */
+    UINT16 tck;         /**< tCKAVGmin of the speed bin in ps */
+    UINT16 cwl;         /**< CAS write latency, 1tCK write preamble */
+} spd_speed_bin_struct;
+
+/*
+** Local Variables
+*/
+
+PRIVATE const spd_speed_bin_struct spd_speed_bin[] =
+{
+    { 1600, 1250,  9 },
+    { 1866, 1071, 10 },
+    { 2133,  937, 11 },
+    { 2400,  833, 12 },
+    { 2666,  750, 14 },
+    { 2933,  682, 16 },
+    { 3200,  625, 16 },
+};
+
+/* SDRAM density in Gb, indexed by byte 4 bits 3:0, 0 below 1Gb */
+PRIVATE const UINT8 spd_density_gb[] = { 0, 0, 1, 2, 4, 8, 16, 32, 12, 24 };
+
+/*
+** Local Functions
+*/
+
+/**
+* @brief
+*   CRC of the SPD base configuration section, CRC-16 with polynomial
+*   0x1021 and initial value 0 as given by the SPD standard.
+*
+* @param[in] data_ptr - Data
+* @param[in] len      - Length in bytes
+*
+* @return
+*   CRC
+*/
+PRIVATE UINT16 spd_crc(const UINT8 *data_ptr, UINT32 len)
+{
+    UINT32 crc = 0;
+    UINT32 i;
+    UINT32 bit;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= (UINT32)data_ptr[i] << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x8000)
+            {
+                crc = (crc << 1) ^ 0x1021;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return (UINT16)crc;
+}
+
+/**
+* @brief
+*   Time from a medium timebase count and a signed fine correction.
+*
+* @param[in] mtb - Medium timebase count
+* @param[in] ftb - Fine timebase correction byte, 0 if none
+*
+* @return
+*   Time in ps
+*/
+PRIVATE UINT32 spd_time(UINT32 mtb, UINT8 ftb)
+{
+    return (UINT32)((INT32)(mtb * SPD_MTB_PS) + (INT8)ftb);
+}
+
+/**
+* @brief
+*   Raise a time to a minimum number of clocks.
+*
+* @param[in] time_ps - Time in ps
+* @param[in] nck_min - Minimum number of clocks
+* @param[in] tck_ps  - Clock period in ps
+*
+* @return
+*   Time in ps
+*/
+PRIVATE UINT32 spd_nck_floor(UINT32 time_ps, UINT32 nck_min, UINT32 tck_ps)
+{
+    if (time_ps < (nck_min * tck_ps))
+    {
+        return (nck_min * tck_ps);
+    }
+
+    return (time_ps);
+}
+
+/**
+* @brief
+*   Speed bin of a data rate.
+*
+* @param[in] data_rate - Data rate in MT/s
+*
+* @return
+*   Speed bin, NULL if the data rate is not a DDR4 speed bin
+*/
+PRIVATE const spd_speed_bin_struct *spd_speed_bin_get(UINT32 data_rate)
+{
+    UINT32 i;
+
+    for (i = 0; i < (sizeof(spd_speed_bin) / sizeof(spd_speed_bin[0])); i++)
+    {
+        if (data_rate == spd_speed_bin[i].data_rate)
+        {
+            return (&spd_speed_bin[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+* @brief
+*   Report a field that differs between two configurations.
+*
+* @param[in] name - Field name
+* @param[in] calc - Calculated value
+* @param[in] ref  - Reference value
+*
+* @return
+*   1 if the values differ, 0 otherwise
+*/
+PRIVATE UINT32 spd_field_compare(const CHAR *name, UINT32 calc, UINT32 ref)
+{
+    if (calc == ref)
+    {
+        return (0);
+    }
+
+    bc_printf("SPD: %s calculated %u, reference %u\n", name, calc, ref);
+    return (1);
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Decode the base configuration section of a DDR4 SPD.
+*
+* @param[in]  spd_ptr      - SPD bytes, starting at byte 0
+* @param[in]  len          - Number of bytes at spd_ptr
+* @param[out] spd_info_ptr - Decoded SPD
+*
+* @return
+*   PMC_SUCCESS, or EXP_DDR_CTRLR_SPD_ERR_xxx if the SPD is short, fails its
+*   CRC, is not a DDR4 SPD or describes an organization that is not
+*   supported.
+*/
+PUBLIC PMCFW_ERROR exp_ddr_ctrlr_spd_parse(const UINT8 *spd_ptr,
+                                           UINT32 len,
+                                           exp_ddr_ctrlr_spd_struct *spd_info_ptr)
+{
+    UINT16 crc;
+    UINT8 density;
+
+    if (len < EXP_DDR_CTRLR_SPD_BASE_SIZE)
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_LEN);
+    }
+
+    crc = (UINT16)(spd_ptr[SPD_CRC] | (spd_ptr[SPD_CRC + 1] << 8));
+    if (crc != spd_crc(spd_ptr, SPD_CRC))
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_CRC);
+    }
+
+    if (SPD_DRAM_TYPE_DDR4 != spd_ptr[SPD_DRAM_TYPE])
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_DRAM_TYPE);
+    }
+
+    /* MTB 125ps and FTB 1ps are the only timebases defined */
+    if (0 != spd_ptr[SPD_TIMEBASES])
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_TIMEBASE);
+    }
+
+    /* organization */
+    density = spd_ptr[SPD_DENSITY] & 0x0F;
+    if ((density >= sizeof(spd_density_gb)) ||
+        ((spd_ptr[SPD_ORGANIZATION] & 0x07) > 2) ||
+        ((spd_ptr[SPD_BUS_WIDTH] & 0x07) > 3))
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_ORGANIZATION);
+    }
+
+    spd_info_ptr->module_type = spd_ptr[SPD_MODULE_TYPE] & 0x0F;
+    spd_info_ptr->density_gb  = spd_density_gb[density];
+    spd_info_ptr->dram_width  = 4 << (spd_ptr[SPD_ORGANIZATION] & 0x07);
+    spd_info_ptr->ranks       = ((spd_ptr[SPD_ORGANIZATION] >> 3) & 0x07) + 1;
+    spd_info_ptr->bus_width   = 8 << (spd_ptr[SPD_BUS_WIDTH] & 0x07);
+    if (0 != (spd_ptr[SPD_BUS_WIDTH] & 0x18))
+    {
+        /* 8 bit ECC extension */
+        spd_info_ptr->bus_width += 8;
+    }
+    spd_info_ptr->col_bits = (spd_ptr[SPD_ADDRESSING] & 0x07) + 9;
+    spd_info_ptr->row_bits = ((spd_ptr[SPD_ADDRESSING] >> 3) & 0x07) + 12;
+
+    if (SPD_LOADING_3DS == (spd_ptr[SPD_PACKAGE] & 0x03))
+    {
+        spd_info_ptr->height_3ds = ((spd_ptr[SPD_PACKAGE] >> 4) & 0x07) + 1;
+    }
+    else
+    {
+        spd_info_ptr->height_3ds = 0;
+    }
+
+    /* CAS latencies, bit 7 of the last byte selects CL23 to CL52 */
+    spd_info_ptr->cl_mask = spd_ptr[SPD_CL_FIRST] |
+                            (spd_ptr[SPD_CL_FIRST + 1] << 8) |
+                            (spd_ptr[SPD_CL_FIRST + 2] << 16) |
+                            ((UINT32)(spd_ptr[SPD_CL_FIRST + 3] & 0x3F) << 24);
+    spd_info_ptr->cl_base = (spd_ptr[SPD_CL_FIRST + 3] & SPD_CL_HIGH_RANGE) ? 23 : 7;
+
+    /* timings */
+    spd_info_ptr->tCKmin = spd_time(spd_ptr[SPD_TCK_MIN], spd_ptr[SPD_TCK_MIN_FINE]);
+    spd_info_ptr->tCKmax = spd_time(spd_ptr[SPD_TCK_MAX], spd_ptr[SPD_TCK_MAX_FINE]);
+    spd_info_ptr->tAA    = spd_time(spd_ptr[SPD_TAA_MIN], spd_ptr[SPD_TAA_FINE]);
+    spd_info_ptr->tRCD   = spd_time(spd_ptr[SPD_TRCD_MIN], spd_ptr[SPD_TRCD_FINE]);
+    spd_info_ptr->tRP    = spd_time(spd_ptr[SPD_TRP_MIN], spd_ptr[SPD_TRP_FINE]);
+    spd_info_ptr->tRAS   = spd_time(((spd_ptr[SPD_TRAS_TRC_MSN] & 0x0F) << 8) | spd_ptr[SPD_TRAS_MIN], 0);
+    spd_info_ptr->tRC    = spd_time(((spd_ptr[SPD_TRAS_TRC_MSN] & 0xF0) << 4) | spd_ptr[SPD_TRC_MIN],
+                                    spd_ptr[SPD_TRC_FINE]);
+    spd_info_ptr->tRFC1  = spd_time((spd_ptr[SPD_TRFC1_MIN + 1] << 8) | spd_ptr[SPD_TRFC1_MIN], 0);
+    spd_info_ptr->tRFC2  = spd_time((spd_ptr[SPD_TRFC2_MIN + 1] << 8) | spd_ptr[SPD_TRFC2_MIN], 0);
+    spd_info_ptr->tRFC4  = spd_time((spd_ptr[SPD_TRFC4_MIN + 1] << 8) | spd_ptr[SPD_TRFC4_MIN], 0);
+    spd_info_ptr->tFAW   = spd_time(((spd_ptr[SPD_TFAW_MSN] & 0x0F) << 8) | spd_ptr[SPD_TFAW_MIN], 0);
+    spd_info_ptr->tRRD_S = spd_time(spd_ptr[SPD_TRRD_S_MIN], spd_ptr[SPD_TRRD_S_FINE]);
+    spd_info_ptr->tRRD_L = spd_time(spd_ptr[SPD_TRRD_L_MIN], spd_ptr[SPD_TRRD_L_FINE]);
+    spd_info_ptr->tCCD_L = spd_time(spd_ptr[SPD_TCCD_L_MIN], spd_ptr[SPD_TCCD_L_FINE]);
+    spd_info_ptr->tWR    = spd_time(((spd_ptr[SPD_TWR_MSN] & 0x0F) << 8) | spd_ptr[SPD_TWR_MIN], 0);
+    spd_info_ptr->tWTR_S = spd_time(((spd_ptr[SPD_TWTR_MSN] & 0x0F) << 8) | spd_ptr[SPD_TWTR_S_MIN], 0);
+    spd_info_ptr->tWTR_L = spd_time(((spd_ptr[SPD_TWTR_MSN] & 0xF0) << 4) | spd_ptr[SPD_TWTR_L_MIN], 0);
+
+    /* SPD revision 1.0 leaves the write times to the DDR4 defaults */
+    if (0 == spd_info_ptr->tWR)
+    {
+        spd_info_ptr->tWR = SPD_TWR_DEFAULT;
+    }
+    if (0 == spd_info_ptr->tWTR_S)
+    {
+        spd_info_ptr->tWTR_S = SPD_TWTR_S_DEFAULT;
+    }
+    if (0 == spd_info_ptr->tWTR_L)
+    {
+        spd_info_ptr->tWTR_L = SPD_TWTR_L_DEFAULT;
+    }
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Number of clocks covering a time, with the JEDEC rounding algorithm.
+*
+* @param[in] time_ps - Time in ps
+* @param[in] tck_ps  - Clock period in ps
+*
+* @return
+*   Number of clocks
+*
+* @note
+*   The time is divided by the clock period in thousandths of a clock and
+*   rounded up from 0.026 clocks above a whole number, so a time given for
+*   the exact clock period of a speed bin is not rounded up by the
+*   truncation of that period to whole picoseconds.
+*/
+PUBLIC UINT32 exp_ddr_ctrlr_spd_ps_to_clk(UINT32 time_ps, UINT32 tck_ps)
+{
+    return ((UINT32)((((UINT64)time_ps * 1000) / tck_ps + SPD_ROUND_GUARD) / 1000));
+}
+
+/**
+* @brief
+*   Calculate the controller configuration of a DIMM at a data rate.
+*
+* @param[in]     spd_info_ptr - Decoded SPD
+* @param[in]     data_rate    - Target data rate in MT/s, a DDR4 speed bin
+* @param[in,out] config_ptr   - Controller configuration. The fields the SPD
+*                               describes are set, the others are left as
+*                               the caller set them.
+* @param[out]    clk_ptr      - Timings in clocks, may be NULL
+*
+* @return
+*   PMC_SUCCESS, EXP_DDR_CTRLR_SPD_ERR_DATA_RATE if the data rate is not a
+*   speed bin or is outside the tCK range of the DIMM, or
+*   EXP_DDR_CTRLR_SPD_ERR_CAS_LATENCY if the DIMM supports no CAS latency
+*   meeting tAA at the data rate.
+*
+* @note
+*   Times are given to the controller in ps, raised to the JEDEC minimum
+*   clock count of the timings that have one.
+*/
+PUBLIC PMCFW_ERROR exp_ddr_ctrlr_spd_timing_calc(const exp_ddr_ctrlr_spd_struct *spd_info_ptr,
+                                                 UINT32 data_rate,
+                                                 exp_ddr_ctrlr_spd_config_struct *config_ptr,
+                                                 exp_ddr_ctrlr_spd_clk_struct *clk_ptr)
+{
+    const spd_speed_bin_struct *bin_ptr;
+    UINT32 tck;
+    UINT32 cl;
+    UINT32 cl_min;
+    UINT32 cl_end;
+
+    bin_ptr = spd_speed_bin_get(data_rate);
+    if (NULL == bin_ptr)
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_DATA_RATE);
+    }
+
+    tck = bin_ptr->tck;
+    if ((tck < spd_info_ptr->tCKmin) ||
+        ((0 != spd_info_ptr->tCKmax) && (tck > spd_info_ptr->tCKmax)))
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_DATA_RATE);
+    }
+
+    /* lowest supported CAS latency meeting tAA */
+    cl_min = exp_ddr_ctrlr_spd_ps_to_clk(spd_info_ptr->tAA, tck);
+    cl_end = spd_info_ptr->cl_base + SPD_CL_COUNT;
+    for (cl = spd_info_ptr->cl_base; cl < cl_end; cl++)
+    {
+        if ((cl >= cl_min) &&
+            (spd_info_ptr->cl_mask & (1 << (cl - spd_info_ptr->cl_base))))
+        {
+            break;
+        }
+    }
+    if (cl == cl_end)
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_CAS_LATENCY);
+    }
+
+    /* organization */
+    config_ptr->dram_size   = spd_info_ptr->density_gb;
+    config_ptr->dram_width  = spd_info_ptr->dram_width;
+    config_ptr->ranks       = spd_info_ptr->ranks;
+    config_ptr->die_count   = spd_info_ptr->bus_width / spd_info_ptr->dram_width;
+    config_ptr->v3ds_height = spd_info_ptr->height_3ds;
+    switch (spd_info_ptr->module_type)
+    {
+        case SPD_MODULE_RDIMM:
+        case SPD_MODULE_MINI_RDIMM:
+        case SPD_MODULE_SO_RDIMM:
+            config_ptr->rdimm = 1;
+            break;
+
+        case SPD_MODULE_LRDIMM:
+            config_ptr->rdimm = 3;
+            break;
+
+        default:
+            config_ptr->rdimm = 0;
+            break;
+    }
+
+    /* clock and latencies */
+    config_ptr->clk_freq = data_rate / 2;
+    config_ptr->cl       = cl;
+    config_ptr->cwl      = bin_ptr->cwl;
+
+    /* timings */
+    config_ptr->tRCD   = spd_info_ptr->tRCD;
+    config_ptr->tRP    = spd_info_ptr->tRP;
+    config_ptr->tRAS   = spd_info_ptr->tRAS;
+    config_ptr->tRC    = spd_info_ptr->tRC;
+    config_ptr->tRFC1  = spd_info_ptr->tRFC1;
+    config_ptr->tRFC2  = spd_info_ptr->tRFC2;
+    config_ptr->tRFC4  = spd_info_ptr->tRFC4;
+    config_ptr->tFAW   = spd_info_ptr->tFAW;
+    config_ptr->tRRD_S = spd_nck_floor(spd_info_ptr->tRRD_S, SPD_TRRD_NCK_MIN, tck);
+    config_ptr->tRRD_L = spd_nck_floor(spd_info_ptr->tRRD_L, SPD_TRRD_NCK_MIN, tck);
+    config_ptr->tCCD_L = spd_nck_floor(spd_info_ptr->tCCD_L, SPD_TCCD_L_NCK_MIN, tck);
+    config_ptr->tWR    = spd_info_ptr->tWR;
+    config_ptr->tWTR_S = spd_nck_floor(spd_info_ptr->tWTR_S, SPD_TWTR_S_NCK_MIN, tck);
+    config_ptr->tWTR_L = spd_nck_floor(spd_info_ptr->tWTR_L, SPD_TWTR_L_NCK_MIN, tck);
+
+    if (NULL != clk_ptr)
+    {
+        clk_ptr->tCK    = tck;
+        clk_ptr->cl     = cl;
+        clk_ptr->cwl    = bin_ptr->cwl;
+        clk_ptr->tRCD   = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRCD, tck);
+        clk_ptr->tRP    = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRP, tck);
+        clk_ptr->tRAS   = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRAS, tck);
+        clk_ptr->tRC    = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRC, tck);
+        clk_ptr->tRFC1  = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRFC1, tck);
+        clk_ptr->tRFC2  = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRFC2, tck);
+        clk_ptr->tRFC4  = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRFC4, tck);
+        clk_ptr->tFAW   = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tFAW, tck);
+        clk_ptr->tRRD_S = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRRD_S, tck);
+        clk_ptr->tRRD_L = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tRRD_L, tck);
+        clk_ptr->tCCD_L = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tCCD_L, tck);
+        clk_ptr->tWR    = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tWR, tck);
+        clk_ptr->tWTR_S = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tWTR_S, tck);
+        clk_ptr->tWTR_L = exp_ddr_ctrlr_spd_ps_to_clk(config_ptr->tWTR_L, tck);
+    }
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Set the DIMM fields of the PHY user input from the SPD.
+*
+* @param[in]     spd_info_ptr - Decoded SPD
+* @param[in]     data_rate    - Target data rate in MT/s, a DDR4 speed bin
+* @param[in,out] msdg_ptr     - PHY user input. The DIMM type, organization,
+*                               CAS latencies, tAA and the frequency of the
+*                               first P-state are set, the others are left
+*                               as the caller set them.
+*
+* @return
+*   PMC_SUCCESS, EXP_DDR_CTRLR_SPD_ERR_DATA_RATE if the data rate is not a
+*   speed bin, or EXP_DDR_CTRLR_SPD_ERR_ORGANIZATION if the DIMM has more
+*   ranks than the PHY drives.
+*/
+PUBLIC PMCFW_ERROR exp_ddr_ctrlr_spd_phy_config(const exp_ddr_ctrlr_spd_struct *spd_info_ptr,
+                                                UINT32 data_rate,
+                                                user_input_msdg_t *msdg_ptr)
+{
+    const spd_speed_bin_struct *bin_ptr;
+
+    bin_ptr = spd_speed_bin_get(data_rate);
+    if (NULL == bin_ptr)
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_DATA_RATE);
+    }
+
+    if (spd_info_ptr->ranks > SPD_PHY_MAX_RANKS)
+    {
+        return (EXP_DDR_CTRLR_SPD_ERR_ORGANIZATION);
+    }
+
+    switch (spd_info_ptr->module_type)
+    {
+        case SPD_MODULE_RDIMM:
+        case SPD_MODULE_MINI_RDIMM:
+        case SPD_MODULE_SO_RDIMM:
+            msdg_ptr->DimmType = SPD_PHY_RDIMM;
+            break;
+
+        case SPD_MODULE_LRDIMM:
+            msdg_ptr->DimmType = SPD_PHY_LRDIMM;
+            break;
+
+        default:
+            msdg_ptr->DimmType = SPD_PHY_UDIMM;
+            break;
+    }
+
+    msdg_ptr->CsPresent       = (1 << spd_info_ptr->ranks) - 1;
+    msdg_ptr->Rank4Mode       = (spd_info_ptr->ranks > 2) ? 1 : 0;
+    msdg_ptr->DramDataWidth   = spd_info_ptr->dram_width;
+    msdg_ptr->Height3DS       = spd_info_ptr->height_3ds;
+    msdg_ptr->ColumnAddrWidth = spd_info_ptr->col_bits;
+    msdg_ptr->RowAddrWidth    = spd_info_ptr->row_bits;
+    msdg_ptr->SpdtAAmin       = spd_info_ptr->tAA;
+
+    /* the PHY bit 0 is CL7, it has no bits above CL36 */
+    msdg_ptr->SpdCLSupported  = (spd_info_ptr->cl_mask << (spd_info_ptr->cl_base - 7)) & 0x3FFFFFFF;
+
+    /* memory clock in MHz, rounded up */
+    msdg_ptr->Frequency[0]    = (1000000 + bin_ptr->tck - 1) / bin_ptr->tck;
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Compare the SPD described fields of a calculated configuration with a
+*   reference configuration, reporting each field that differs.
+*
+* @param[in] calc_ptr - Calculated configuration
+* @param[in] ref_ptr  - Reference configuration
+*
+* @return
+*   Number of fields that differ
+*/
+PUBLIC UINT32 exp_ddr_ctrlr_spd_config_compare(const exp_ddr_ctrlr_spd_config_struct *calc_ptr,
+                                               const exp_ddr_ctrlr_spd_config_struct *ref_ptr)
+{
+    UINT32 diffs = 0;
+
+    diffs += spd_field_compare("dram_size", calc_ptr->dram_size, ref_ptr->dram_size);
+    diffs += spd_field_compare("dram_width", calc_ptr->dram_width, ref_ptr->dram_width);
+    diffs += spd_field_compare("ranks", calc_ptr->ranks, ref_ptr->ranks);
+    diffs += spd_field_compare("rdimm", calc_ptr->rdimm, ref_ptr->rdimm);
+    diffs += spd_field_compare("die_count", calc_ptr->die_count, ref_ptr->die_count);
+    diffs += spd_field_compare("v3ds_height", calc_ptr->v3ds_height, ref_ptr->v3ds_height);
+    diffs += spd_field_compare("clk_freq", calc_ptr->clk_freq, ref_ptr->clk_freq);
+    diffs += spd_field_compare("cl", calc_ptr->cl, ref_ptr->cl);
+    diffs += spd_field_compare("cwl", calc_ptr->cwl, ref_ptr->cwl);
+    diffs += spd_field_compare("tRCD", calc_ptr->tRCD, ref_ptr->tRCD);
+    diffs += spd_field_compare("tRP", calc_ptr->tRP, ref_ptr->tRP);
+    diffs += spd_field_compare("tRAS", calc_ptr->tRAS, ref_ptr->tRAS);
+    diffs += spd_field_compare("tRC", calc_ptr->tRC, ref_ptr->tRC);
+    diffs += spd_field_compare("tRFC1", calc_ptr->tRFC1, ref_ptr->tRFC1);
+    diffs += spd_field_compare("tRFC2", calc_ptr->tRFC2, ref_ptr->tRFC2);
+    diffs += spd_field_compare("tRFC4", calc_ptr->tRFC4, ref_ptr->tRFC4);
+    diffs += spd_field_compare("tFAW", calc_ptr->tFAW, ref_ptr->tFAW);
+    diffs += spd_field_compare("tRRD_S", calc_ptr->tRRD_S, ref_ptr->tRRD_S);
+    diffs += spd_field_compare("tRRD_L", calc_ptr->tRRD_L, ref_ptr->tRRD_L);
+    diffs += spd_field_compare("tCCD_L", calc_ptr->tCCD_L, ref_ptr->tCCD_L);
+    diffs += spd_field_compare("tWR", calc_ptr->tWR, ref_ptr->tWR);
+    diffs += spd_field_compare("tWTR_S", calc_ptr->tWTR_S, ref_ptr->tWTR_S);
+    diffs += spd_field_compare("tWTR_L", calc_ptr->tWTR_L, ref_ptr->tWTR_L);
+
+    return (diffs);
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
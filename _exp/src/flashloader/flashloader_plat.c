@@ -58,6 +58,8 @@
 #include "pmc_plat.h"
 #include "wdt.h"
 #include "top_plat.h"
+#include "lz_decomp.h"
+#include "crc32_api.h"
 
 /*
 ** Macro Constants
@@ -72,9 +74,13 @@
 /* Flash Write Command offset*/
 #define FLASH_LOADER_FLASH_WRITE_IMAGE_SIZE_OFFSET         1
 #define FLASH_LOADER_FLASH_WRITE_PACKET_SEQUENCE_OFFSET     4
+#define FLASH_LOADER_FLASH_WRITE_IMAGE_DIGEST_OFFSET        8
 
 #define FLASH_LOADER_SUBSECTOR_SIZE                         (4*1024)
 
+/* Write command without an image digest */
+#define FLASH_LOADER_DIGEST_NONE                            0xFFFFFFFF
+
 
 
 fam_image_desc_struct img_list[SPI_FLASH_PARTITION_NUMBER];
@@ -83,6 +89,48 @@ PRIVATE UCHAR FW_VERSION_INFO[FLASH_PLAT_VERSION_LENGTH] = "MICROCHIP Explorer F
 /* SPI flash device info */
 PRIVATE spi_flash_dev_info_struct flashloader_plat_spi_dev_info;
 
+#if (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1)
+/*
+** Compressed upgrade state. The packets of a compressed image are decoded
+** in order into a page buffer which is written to the staging area once
+** full, so the staging area receives the same plain image a raw upgrade
+** would have produced. Static footprint is the window plus one page.
+*/
+PRIVATE BOOL flashloader_plat_pack_active = FALSE;
+PRIVATE BOOL flashloader_plat_pack_done = FALSE;
+/* the compressed image failed, its packets are refused until a new packet 0 */
+PRIVATE BOOL flashloader_plat_pack_failed = FALSE;
+PRIVATE UINT32 flashloader_plat_pack_next_index;
+PRIVATE UINT32 flashloader_plat_pack_page_index;
+PRIVATE UINT32 flashloader_plat_pack_page_len;
+PRIVATE UINT32 flashloader_plat_pack_raw_len;
+PRIVATE UINT32 flashloader_plat_pack_digest;
+PRIVATE lz_decomp_struct flashloader_plat_pack_decomp;
+PRIVATE UINT8 flashloader_plat_pack_page[FLASH_LOADER_PAGE_BUF_SIZE];
+PRIVATE UINT8 flashloader_plat_pack_window[FLASH_LOADER_DECOMP_WINDOW_SIZE];
+#endif
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+/*
+** Resume state. The current checkpoint is kept in RAM together with a
+** chunk map covering chunks written this session, the record in flash
+** only advances when a staging subsector is complete.
+*/
+#define FLASH_LOADER_MAP_TEST(map, idx)                     (0 != ((map)[(idx) >> 3] & (1 << ((idx) & 7))))
+#define FLASH_LOADER_MAP_SET(map, idx)                      ((map)[(idx) >> 3] |= (UINT8)(1 << ((idx) & 7)))
+
+PRIVATE BOOL flashloader_plat_record_mounted = FALSE;
+PRIVATE UINT32 flashloader_plat_record_slot;
+PRIVATE flashloader_plat_record_struct flashloader_plat_record;
+PRIVATE UINT8 flashloader_plat_chunk_map[FLASH_LOADER_RECORD_BITMAP_SIZE];
+PRIVATE UINT8 flashloader_plat_subsector_open[FLASH_LOADER_RECORD_MAX_SUBSECTORS / 8];
+PRIVATE UINT8 flashloader_plat_record_page[FLASH_LOADER_PAGE_BUF_SIZE];
+PRIVATE UINT8 flashloader_plat_status_buf[sizeof(flashloader_plat_chunk_status_struct) + FLASH_LOADER_RECORD_BITMAP_SIZE];
+PRIVATE VOID (*flashloader_plat_upgrade_handler_ptr)(VOID);
+
+PRIVATE VOID flashloader_plat_fw_image_upgrade_handler(VOID);
+#endif
+
 /** Global variables
 */
 /* Public keys were supplied by the Smart Array team. */
@@ -284,7 +332,12 @@ PUBLIC void flashloader_plat_init(flashloader_handler_struct *fl)
     PMCFW_ERROR rc;
 
     /* Register the Flashloader handlers with ECH module*/
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+    flashloader_plat_upgrade_handler_ptr = fl->flashloader_fw_image_upgrade_handler;
+    ech_api_func_register(EXP_FW_BINARY_UPGRADE, flashloader_plat_fw_image_upgrade_handler);
+#else
     ech_api_func_register(EXP_FW_BINARY_UPGRADE, fl->flashloader_fw_image_upgrade_handler);
+#endif
     ech_api_func_register(EXP_FW_FLASH_LOADER_VERSION_INFO,fl->flashloader_version_info_handler);
     /*Initialize the plaform image list structure*/
     flash_partition_image_list_get(&img_list[0]);
@@ -674,6 +727,71 @@ PUBLIC UINT32 flashloader_plat_flash_image_packet_sequence_get(void)
     return flash_image_sequence;
 }
 
+#if ((EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1) || (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1))
+/**
+* @brief
+*   Get the image digest, a CRC32 of the whole plain image computed by the
+*   HOST with the same polynomial and reflection as pmc_crc32(). For a
+*   compressed image it is the digest of the image before packing. Older
+*   HOSTs leave the field zero, their downloads are refused.
+* @param None
+* 
+* @return
+*   image digest, FLASH_LOADER_DIGEST_NONE if none was supplied
+*
+*/
+PRIVATE UINT32 flashloader_plat_flash_image_digest_get(VOID)
+{
+    UINT32 digest;
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    digest = cmd_ptr->parms[FLASH_LOADER_FLASH_WRITE_IMAGE_DIGEST_OFFSET] |
+             cmd_ptr->parms[FLASH_LOADER_FLASH_WRITE_IMAGE_DIGEST_OFFSET+1] << 8 |
+             cmd_ptr->parms[FLASH_LOADER_FLASH_WRITE_IMAGE_DIGEST_OFFSET+2] << 16 |
+             cmd_ptr->parms[FLASH_LOADER_FLASH_WRITE_IMAGE_DIGEST_OFFSET+3] << 24;
+
+    if (0 == digest)
+    {
+        return FLASH_LOADER_DIGEST_NONE;
+    }
+    return digest;
+}
+
+/**
+* @brief
+*   Check the image staged in the temp buffer within the flash against
+*   the image digest.
+* 
+* @param [in]  image_size - plain image size
+* @param [in]  digest     - image digest from the write command
+* @param [out] err_code   - flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_digest_check(UINT32 image_size, UINT32 digest, UINT32 *err_code)
+{
+    UINT32 staged;
+
+    if (FLASH_LOADER_DIGEST_NONE == digest)
+    {
+        bc_printf("Flashloader: no image digest, commit refused\n");
+        *err_code = FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+        return FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+    }
+
+    staged = pmc_crc32((UINT8*)SPI_FLASH_FW_FW_UPGRADE_ADDR, image_size, 0, TRUE, TRUE);
+    if (staged != digest)
+    {
+        bc_printf("Flashloader: staged image digest 0x%08x, expected 0x%08x\n", staged, digest);
+        *err_code = FLASHLOADER_PLAT_ERR_DIGEST_MISMATCH;
+        return FLASHLOADER_PLAT_ERR_DIGEST_MISMATCH;
+    }
+
+    return PMC_SUCCESS;
+}
+#endif
+
 /**
 * @brief
 *   Get the data buffer offset
@@ -690,20 +808,19 @@ PUBLIC void * flashloader_plat_flash_image_data_buf_address_get(void)
 
 /**
 * @brief
-*   Write the data into temp buffer within the flash
-*   Data authentication will happen during FLASH COMMIT command
+*   Write one page into the temp buffer within the flash
 * 
 * @param [in]  flash_write_index     -  Actual address of flash is flash_write_index * 256B   
-* @param [in]  flash_image_data_buf -  Data buffer 
+* @param [in]  flash_image_data_buf -  Data buffer of FLASH_LOADER_PAGE_BUF_SIZE bytes
 * @param [out] err_code             -  flash error codes
 * 
 * @return
-*   packet sequence
+*   Success or Failure code
 *
 */
-PUBLIC UINT32 flashloader_plat_flash_buffer_write(UINT32 flash_write_index, 
-                                                  UINT8 *flash_image_data_buf, 
-                                                  UINT32 *err_code)
+PRIVATE UINT32 flashloader_plat_staging_page_write(UINT32 flash_write_index, 
+                                                   UINT8 *flash_image_data_buf, 
+                                                   UINT32 *err_code)
 {
     PMCFW_ERROR rc;
     spi_flash_dev_enum dev;
@@ -721,7 +838,7 @@ PUBLIC UINT32 flashloader_plat_flash_buffer_write(UINT32 flash_write_index,
         
     if (rc != PMC_SUCCESS)
     {
-        bc_printf("Flashloader: flashloader_plat_flash_buffer_write dev_info failed\n");            
+        bc_printf("Flashloader: flashloader_plat_staging_page_write dev_info failed\n");            
         *err_code = FLASHLOADER_ERR_DEVINFO_GET;
         return FLASHLOADER_ERR_DEVINFO_GET;
     }
@@ -749,7 +866,7 @@ PUBLIC UINT32 flashloader_plat_flash_buffer_write(UINT32 flash_write_index,
 
         if (PMC_SUCCESS != rc)
         {
-            bc_printf("\nFlashloader: flashloader_plat_flash_buffer_write subsector erase failed, rc = 0x%x\n", rc);
+            bc_printf("\nFlashloader: flashloader_plat_staging_page_write subsector erase failed, rc = 0x%x\n", rc);
             *err_code = FLASHLOADER_ERR_SUBSECTOR_ERASE;
             return FLASHLOADER_ERR_SUBSECTOR_ERASE;
         }
@@ -773,12 +890,768 @@ PUBLIC UINT32 flashloader_plat_flash_buffer_write(UINT32 flash_write_index,
 
     if (rc != PMC_SUCCESS)
     {
-        bc_printf("Flashloader: flashloader_plat_flash_buffer_write write error %08lx\n", rc);
+        bc_printf("Flashloader: flashloader_plat_staging_page_write write error %08lx\n", rc);
+        *err_code = FLASHLOADER_ERR_FLASH_WRITE_FAIL;
+        return FLASHLOADER_ERR_FLASH_WRITE_FAIL;
+    }
+
+    return PMC_SUCCESS;
+}
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+/**
+* @brief
+*   Program erased SPI flash with whole pages of data.
+* 
+* @param [in] flash_addr  - SPI flash address
+* @param [in] src_ptr     - data to program
+* @param [in] len         - number of bytes
+* 
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR flashloader_plat_page_program(UINT32 flash_addr, UINT8 *src_ptr, UINT32 len)
+{
+    PMCFW_ERROR rc;
+    top_plat_lock_struct lock_struct;
+
+    /* disable interrupts and disable multi-VPE operation */
+    top_plat_critical_region_enter(&lock_struct);
+
+    rc = spi_flash_write_pages(SPI_FLASH_PORT,
+                               SPI_FLASH_CS,
+                               src_ptr,
+                               (UINT8*)(flash_addr & GPBC_FLASH_PHYS_ADDR_MASK),
+                               len,
+                               flashloader_plat_spi_dev_info.page_size,
+                               flashloader_plat_spi_dev_info.max_time_page_prog);
+
+    /* restore interrupts and enable multi-VPE operation */
+    top_plat_critical_region_exit(lock_struct);
+
+    return rc;
+}
+
+/**
+* @brief
+*   Calculate the CRC of a resume record checkpoint.
+* 
+* @param [in] record_ptr - checkpoint
+* 
+* @return
+*   CRC32 of every field but the crc itself
+*
+*/
+PRIVATE UINT32 flashloader_plat_record_crc(flashloader_plat_record_struct *record_ptr)
+{
+    return pmc_crc32((UINT8*)record_ptr, sizeof(flashloader_plat_record_struct) - sizeof(UINT32), 0, TRUE, TRUE);
+}
+
+/**
+* @brief
+*   Write the RAM copy of the resume record as the next checkpoint. The
+*   record subsector is erased when the first slot in it is used.
+* 
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR flashloader_plat_record_write(VOID)
+{
+    UINT32 slot_addr = SPI_FLASH_FW_FW_UPGRADE_RECORD_ADDR + (flashloader_plat_record_slot * FLASH_LOADER_PAGE_BUF_SIZE);
+    PMCFW_ERROR rc;
+
+    flashloader_plat_record.seq++;
+    flashloader_plat_record.crc = flashloader_plat_record_crc(&flashloader_plat_record);
+
+    /* pad the page, every byte of a page must be written for a valid ECC */
+    memset(flashloader_plat_record_page, 0xFF, FLASH_LOADER_PAGE_BUF_SIZE);
+    memcpy(flashloader_plat_record_page, &flashloader_plat_record, sizeof(flashloader_plat_record_struct));
+
+    if (0 == (flashloader_plat_record_slot % FLASH_LOADER_SUBSECTOR_CHUNKS))
+    {
+        rc = spi_flash_plat_erase((UINT8*)(slot_addr & GPBC_FLASH_PHYS_ADDR_MASK), FLASH_LOADER_SUBSECTOR_SIZE);
+        if (PMC_SUCCESS != rc)
+        {
+            return rc;
+        }
+    }
+
+    flashloader_plat_record_slot = (flashloader_plat_record_slot + 1) % FLASH_LOADER_RECORD_SLOTS;
+
+    return flashloader_plat_page_program(slot_addr, flashloader_plat_record_page, FLASH_LOADER_PAGE_BUF_SIZE);
+}
+
+/**
+* @brief
+*   Count the chunks of the recorded image that are still missing.
+* 
+* @return
+*   Number of missing chunks
+*
+*/
+PRIVATE UINT32 flashloader_plat_chunk_missing_count(VOID)
+{
+    UINT32 missing = 0;
+    UINT32 i;
+
+    for (i = 0; i < flashloader_plat_record.chunk_count; i++)
+    {
+        if (!FLASH_LOADER_MAP_TEST(flashloader_plat_chunk_map, i))
+        {
+            missing++;
+        }
+    }
+
+    return missing;
+}
+
+/**
+* @brief
+*   Load the latest resume record checkpoint and rebuild the chunk map
+*   from it. Done once, on the first upgrade command after reset.
+* 
+* @return
+*   None
+*
+* @note
+*   Slots that were never written or were torn by a reset fail the ECC
+*   check. Since a torn slot cannot be told apart from an erased one,
+*   new checkpoints always go to the record subsector not holding the
+*   latest checkpoint.
+*/
+PRIVATE VOID flashloader_plat_record_mount(VOID)
+{
+    flashloader_plat_record_struct *slot_ptr = (flashloader_plat_record_struct *)flashloader_plat_record_page;
+    BOOL found = FALSE;
+    UINT32 latest_slot = 0;
+    UINT32 slot;
+    UINT32 i;
+
+    if (TRUE == flashloader_plat_record_mounted)
+    {
+        return;
+    }
+
+    memset(&flashloader_plat_record, 0, sizeof(flashloader_plat_record));
+
+    for (slot = 0; slot < FLASH_LOADER_RECORD_SLOTS; slot++)
+    {
+        if ((TRUE == spi_flash_plat_checked_read((UINT8*)slot_ptr,
+                                                 (UINT8*)(SPI_FLASH_FW_FW_UPGRADE_RECORD_ADDR + (slot * FLASH_LOADER_PAGE_BUF_SIZE)),
+                                                 sizeof(flashloader_plat_record_struct))) &&
+            (FLASH_LOADER_RECORD_MAGIC == slot_ptr->magic) &&
+            (FLASH_LOADER_RECORD_VERSION == slot_ptr->version) &&
+            (slot_ptr->chunk_count <= FLASH_LOADER_RECORD_MAX_CHUNKS) &&
+            (flashloader_plat_record_crc(slot_ptr) == slot_ptr->crc) &&
+            ((FALSE == found) || (slot_ptr->seq > flashloader_plat_record.seq)))
+        {
+            memcpy(&flashloader_plat_record, slot_ptr, sizeof(flashloader_plat_record));
+            latest_slot = slot;
+            found = TRUE;
+        }
+    }
+
+    if (TRUE == found)
+    {
+        flashloader_plat_record_slot = ((latest_slot / FLASH_LOADER_SUBSECTOR_CHUNKS) ^ 1) * FLASH_LOADER_SUBSECTOR_CHUNKS;
+    }
+    else
+    {
+        flashloader_plat_record.magic = FLASH_LOADER_RECORD_MAGIC;
+        flashloader_plat_record.version = FLASH_LOADER_RECORD_VERSION;
+        flashloader_plat_record_slot = 0;
+    }
+
+    /* every chunk of a complete subsector is present */
+    memset(flashloader_plat_chunk_map, 0, sizeof(flashloader_plat_chunk_map));
+    memset(flashloader_plat_subsector_open, 0, sizeof(flashloader_plat_subsector_open));
+    for (i = 0; i < flashloader_plat_record.chunk_count; i++)
+    {
+        if (FLASH_LOADER_MAP_TEST(flashloader_plat_record.subsector_map, i / FLASH_LOADER_SUBSECTOR_CHUNKS))
+        {
+            FLASH_LOADER_MAP_SET(flashloader_plat_chunk_map, i);
+        }
+    }
+
+    if (0 != flashloader_plat_record.chunk_count)
+    {
+        bc_printf("Flashloader: upgrade record, %d bytes, %d of %d chunks present\n",
+                  flashloader_plat_record.image_size,
+                  flashloader_plat_record.chunk_count - flashloader_plat_chunk_missing_count(),
+                  flashloader_plat_record.chunk_count);
+    }
+
+    flashloader_plat_record_mounted = TRUE;
+}
+
+/**
+* @brief
+*   Start a new resume record for an image, discarding the previous one.
+* 
+* @param [in] image_size - image size from the write command, 0 to only
+*                          discard the previous record
+* @param [in] digest     - image digest from the write command
+* 
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR flashloader_plat_record_start(UINT32 image_size, UINT32 digest)
+{
+    flashloader_plat_record.image_size  = image_size;
+    flashloader_plat_record.chunk_count = (image_size + FLASH_LOADER_PAGE_BUF_SIZE - 1) / FLASH_LOADER_PAGE_BUF_SIZE;
+    flashloader_plat_record.digest      = digest;
+    memset(flashloader_plat_record.subsector_map, 0, sizeof(flashloader_plat_record.subsector_map));
+    memset(flashloader_plat_chunk_map, 0, sizeof(flashloader_plat_chunk_map));
+    memset(flashloader_plat_subsector_open, 0, sizeof(flashloader_plat_subsector_open));
+
+    return flashloader_plat_record_write();
+}
+
+/**
+* @brief
+*   Discard the resume record once the download is committed, aborted or
+*   replaced by a compressed image.
+* 
+* @return
+*   None
+*
+*/
+PRIVATE VOID flashloader_plat_record_discard(VOID)
+{
+    flashloader_plat_record_mount();
+
+    if (0 != flashloader_plat_record.chunk_count)
+    {
+        (VOID)flashloader_plat_record_start(0, FLASH_LOADER_DIGEST_NONE);
+    }
+}
+
+/**
+* @brief
+*   Check whether every chunk of a staging subsector is present.
+* 
+* @param [in] subsector - staging subsector index
+* 
+* @return
+*   TRUE if the subsector is complete
+*
+*/
+PRIVATE BOOL flashloader_plat_subsector_complete(UINT32 subsector)
+{
+    UINT32 i = subsector * FLASH_LOADER_SUBSECTOR_CHUNKS;
+    UINT32 end = i + FLASH_LOADER_SUBSECTOR_CHUNKS;
+
+    for ( ; (i < end) && (i < flashloader_plat_record.chunk_count); i++)
+    {
+        if (!FLASH_LOADER_MAP_TEST(flashloader_plat_chunk_map, i))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+* @brief
+*   Write one chunk of a raw image into the temp buffer within the flash
+*   and track it for resume. Chunks may arrive in any order and chunks
+*   already present are skipped, so an interrupted download is completed
+*   by resending only the missing chunks.
+* 
+* @param [in]  flash_write_index     -  Chunk index, flash address is flash_write_index * 256B   
+* @param [in]  flash_image_data_buf -  Data buffer of FLASH_LOADER_PAGE_BUF_SIZE bytes
+* @param [out] err_code             -  flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_resume_buffer_write(UINT32 flash_write_index, 
+                                                    UINT8 *flash_image_data_buf, 
+                                                    UINT32 *err_code)
+{
+    UINT32 image_size = flashloader_plat_flash_image_size_get();
+    UINT32 flash_write_buffer_addr = (flash_write_index * FLASH_LOADER_PAGE_BUF_SIZE) + SPI_FLASH_FW_FW_UPGRADE_ADDR;
+    UINT32 subsector = flash_write_index / FLASH_LOADER_SUBSECTOR_CHUNKS;
+    UINT32 digest = flashloader_plat_flash_image_digest_get();
+    BOOL resume;
+    PMCFW_ERROR rc;
+
+    flashloader_plat_record_mount();
+
+    if ((0 == image_size) ||
+        (image_size > SPI_FLASH_FW_FW_UPGRADE_SIZE) ||
+        (flash_write_index >= ((image_size + FLASH_LOADER_PAGE_BUF_SIZE - 1) / FLASH_LOADER_PAGE_BUF_SIZE)))
+    {
+        bc_printf("Flashloader: chunk %d of %d byte image out of range\n", flash_write_index, image_size);
+        *err_code = FLASHLOADER_ERR_ADDRESS_OUT_OF_RANGE;
+        return FLASHLOADER_ERR_ADDRESS_OUT_OF_RANGE;
+    }
+
+    /* a download without a digest could neither be resumed nor committed */
+    if (FLASH_LOADER_DIGEST_NONE == digest)
+    {
+        bc_printf("Flashloader: chunk %d without an image digest refused\n", flash_write_index);
+        *err_code = FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+        return FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+    }
+
+    /* the record belongs to this download if the size and the digest match */
+    resume = ((0 != flashloader_plat_record.chunk_count) &&
+              (image_size == flashloader_plat_record.image_size) &&
+              (digest == flashloader_plat_record.digest));
+
+    if (FALSE == resume)
+    {
+        bc_printf("Flashloader: new upgrade record, %d bytes\n", image_size);
+
+        rc = flashloader_plat_record_start(image_size, digest);
+        if (PMC_SUCCESS != rc)
+        {
+            bc_printf("Flashloader: upgrade record write failed, rc = 0x%x\n", rc);
+            *err_code = FLASHLOADER_PLAT_ERR_RECORD_WRITE;
+            return FLASHLOADER_PLAT_ERR_RECORD_WRITE;
+        }
+    }
+
+    /* already in the staging area */
+    if (FLASH_LOADER_MAP_TEST(flashloader_plat_chunk_map, flash_write_index))
+    {
+        return PMC_SUCCESS;
+    }
+
+    /*
+    ** a staging subsector is erased on the first write to it after reset,
+    ** chunks of an incomplete subsector from before the reset are resent
+    */
+    if (!FLASH_LOADER_MAP_TEST(flashloader_plat_subsector_open, subsector))
+    {
+        bc_printf("Erasing Firmware Download Subsector @ 0x%08X ... ", flash_write_buffer_addr);
+        rc = spi_flash_plat_erase((UINT8*)((SPI_FLASH_FW_FW_UPGRADE_ADDR + (subsector * FLASH_LOADER_SUBSECTOR_SIZE)) & GPBC_FLASH_PHYS_ADDR_MASK),
+                                  FLASH_LOADER_SUBSECTOR_SIZE);
+        if (PMC_SUCCESS != rc)
+        {
+            bc_printf("\nFlashloader: flashloader_plat_resume_buffer_write subsector erase failed, rc = 0x%x\n", rc);
+            *err_code = FLASHLOADER_ERR_SUBSECTOR_ERASE;
+            return FLASHLOADER_ERR_SUBSECTOR_ERASE;
+        }
+        bc_printf("done\n");
+
+        FLASH_LOADER_MAP_SET(flashloader_plat_subsector_open, subsector);
+    }
+
+    rc = flashloader_plat_page_program(flash_write_buffer_addr,
+                                       flash_image_data_buf,
+                                       FLASH_LOADER_PAGE_BUF_SIZE);
+    if (PMC_SUCCESS != rc)
+    {
+        bc_printf("Flashloader: flashloader_plat_resume_buffer_write write error %08lx\n", rc);
         *err_code = FLASHLOADER_ERR_FLASH_WRITE_FAIL;
         return FLASHLOADER_ERR_FLASH_WRITE_FAIL;
     }
 
+    /* a chunk only counts once it reads back correctly */
+    if (0 != memcmp((VOID*)flash_write_buffer_addr, flash_image_data_buf, FLASH_LOADER_PAGE_BUF_SIZE))
+    {
+        bc_printf("Flashloader: chunk %d verify failed\n", flash_write_index);
+        *err_code = FLASHLOADER_PLAT_ERR_CHUNK_VERIFY;
+        return FLASHLOADER_PLAT_ERR_CHUNK_VERIFY;
+    }
+
+    FLASH_LOADER_MAP_SET(flashloader_plat_chunk_map, flash_write_index);
+
+    /* checkpoint each completed subsector */
+    if (TRUE == flashloader_plat_subsector_complete(subsector))
+    {
+        FLASH_LOADER_MAP_SET(flashloader_plat_record.subsector_map, subsector);
+
+        rc = flashloader_plat_record_write();
+        if (PMC_SUCCESS != rc)
+        {
+            bc_printf("Flashloader: upgrade record write failed, rc = 0x%x\n", rc);
+            *err_code = FLASHLOADER_PLAT_ERR_RECORD_WRITE;
+            return FLASHLOADER_PLAT_ERR_RECORD_WRITE;
+        }
+    }
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Check that the staging area holds every chunk of the recorded image
+*   and that the staged image matches the image digest.
+* 
+* @param [out] err_code - flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_record_check(UINT32 *err_code)
+{
+    UINT32 missing;
+
+    flashloader_plat_record_mount();
+
+    missing = flashloader_plat_chunk_missing_count();
+    if ((0 == flashloader_plat_record.chunk_count) || (0 != missing))
+    {
+        bc_printf("Flashloader: %d of %d chunks missing\n", missing, flashloader_plat_record.chunk_count);
+        *err_code = FLASHLOADER_PLAT_ERR_CHUNKS_MISSING;
+        return FLASHLOADER_PLAT_ERR_CHUNKS_MISSING;
+    }
+
+    return flashloader_plat_digest_check(flashloader_plat_record.image_size, flashloader_plat_record.digest, err_code);
+}
+
+/**
+* @brief
+*   Report the download being tracked and the chunks the HOST still has
+*   to send.
+* 
+* @return
+*   None
+*
+*/
+PRIVATE VOID flashloader_plat_chunk_status_get(VOID)
+{
+    flashloader_plat_chunk_status_struct *status_ptr = (flashloader_plat_chunk_status_struct *)flashloader_plat_status_buf;
+    UINT8 *missing_map_ptr = &flashloader_plat_status_buf[sizeof(flashloader_plat_chunk_status_struct)];
+    UINT32 i;
+
+    flashloader_plat_record_mount();
+
+    status_ptr->image_size    = flashloader_plat_record.image_size;
+    status_ptr->chunk_count   = flashloader_plat_record.chunk_count;
+    status_ptr->digest        = flashloader_plat_record.digest;
+    status_ptr->missing_count = flashloader_plat_chunk_missing_count();
+
+    memset(missing_map_ptr, 0, FLASH_LOADER_RECORD_BITMAP_SIZE);
+    for (i = 0; i < flashloader_plat_record.chunk_count; i++)
+    {
+        if (!FLASH_LOADER_MAP_TEST(flashloader_plat_chunk_map, i))
+        {
+            FLASH_LOADER_MAP_SET(missing_map_ptr, i);
+        }
+    }
+
+    flashloader_plat_send_respnse(EXP_FW_API_SUCCESS,
+                                  0,
+                                  sizeof(flashloader_plat_status_buf),
+                                  flashloader_plat_status_buf);
+}
+
+/**
+* @brief
+*   Binary upgrade command handler. Serves the platform commands and
+*   passes the flashloader commands on to the library handler.
+* 
+* @return
+*   None
+*
+*/
+PRIVATE VOID flashloader_plat_fw_image_upgrade_handler(VOID)
+{
+    UINT32 cmd = flashloader_plat_flash_command_get();
+
+    if (FLASHLOADER_PLAT_CMD_CHUNK_STATUS_GET == cmd)
+    {
+        flashloader_plat_chunk_status_get();
+        return;
+    }
+
+    /* an explicit abort discards the partial download */
+    if (FLASHLOADER_CMD_WRITE_ABORT == cmd)
+    {
+        flashloader_plat_record_discard();
+    }
+
+    flashloader_plat_upgrade_handler_ptr();
+}
+#endif
+
+#if (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1)
+/**
+* @brief
+*   Check whether the first packet of an upgrade is a compressed image
+*   and if so start decoding it.
+* 
+* @param [in]  flash_image_data_buf -  First packet of the image
+* @param [out] err_code             -  flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_pack_start(UINT8 *flash_image_data_buf, UINT32 *err_code)
+{
+    UINT32 magic;
+    UINT32 raw_len;
+
+    flashloader_plat_pack_active = FALSE;
+    flashloader_plat_pack_done = FALSE;
+    flashloader_plat_pack_failed = FALSE;
+
+    magic = flash_image_data_buf[0]       |
+            flash_image_data_buf[1] << 8  |
+            flash_image_data_buf[2] << 16 |
+            flash_image_data_buf[3] << 24;
+
+    if (FLASH_LOADER_PACK_MAGIC != magic)
+    {
+        /* plain image */
+        return PMC_SUCCESS;
+    }
+
+    raw_len = flash_image_data_buf[8]        |
+              flash_image_data_buf[9]  << 8  |
+              flash_image_data_buf[10] << 16 |
+              flash_image_data_buf[11] << 24;
+
+    /* the packer's window must fit into ours and the image into the staging area */
+    if ((FLASH_LOADER_PACK_VERSION != flash_image_data_buf[4]) ||
+        (flash_image_data_buf[5] > FLASH_LOADER_DECOMP_WINDOW_LOG2) ||
+        (0 == raw_len) ||
+        (raw_len > SPI_FLASH_FW_FW_UPGRADE_SIZE))
+    {
+        bc_printf("Flashloader: invalid compressed image header\n");
+        flashloader_plat_pack_failed = TRUE;
+        *err_code = FLASHLOADER_PLAT_ERR_PACK_HEADER;
+        return FLASHLOADER_PLAT_ERR_PACK_HEADER;
+    }
+
+    /* the decoded image is checked against the digest before it is committed */
+    flashloader_plat_pack_digest = flashloader_plat_flash_image_digest_get();
+    if (FLASH_LOADER_DIGEST_NONE == flashloader_plat_pack_digest)
+    {
+        bc_printf("Flashloader: compressed image without an image digest refused\n");
+        flashloader_plat_pack_failed = TRUE;
+        *err_code = FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+        return FLASHLOADER_PLAT_ERR_DIGEST_MISSING;
+    }
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+    /* the staging area is about to be overwritten by a stream that cannot be resumed */
+    flashloader_plat_record_discard();
+#endif
+
+    lz_decomp_init(&flashloader_plat_pack_decomp,
+                   flashloader_plat_pack_window,
+                   FLASH_LOADER_DECOMP_WINDOW_SIZE,
+                   raw_len);
+
+    flashloader_plat_pack_active = TRUE;
+    flashloader_plat_pack_raw_len = raw_len;
+    flashloader_plat_pack_next_index = 0;
+    flashloader_plat_pack_page_index = 0;
+    flashloader_plat_pack_page_len = 0;
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Decode one packet of a compressed image into the temp buffer within
+*   the flash. Full pages are written as they are produced; the final
+*   partial page is padded with 0xFF.
+* 
+* @param [in]  flash_write_index     -  Packet index, packets must arrive in order
+* @param [in]  flash_image_data_buf -  Packet data 
+* @param [out] err_code             -  flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_pack_buffer_write(UINT32 flash_write_index, 
+                                                  UINT8 *flash_image_data_buf, 
+                                                  UINT32 *err_code)
+{
+    const UINT8 *in_ptr = flash_image_data_buf;
+    UINT32 in_len = FLASH_LOADER_PAGE_BUF_SIZE;
+    UINT32 out_len;
+    lz_decomp_status_enum status;
+    UINT32 rc;
+
+    /* the decoder is a stream, a retried or skipped packet cannot be applied */
+    if (flash_write_index != flashloader_plat_pack_next_index)
+    {
+        bc_printf("Flashloader: compressed packet %d out of order, expected %d\n",
+                  flash_write_index, flashloader_plat_pack_next_index);
+        flashloader_plat_pack_active = FALSE;
+        flashloader_plat_pack_failed = TRUE;
+        *err_code = FLASHLOADER_PLAT_ERR_PACK_SEQUENCE;
+        return FLASHLOADER_PLAT_ERR_PACK_SEQUENCE;
+    }
+    flashloader_plat_pack_next_index++;
+
+    /* trailing padding of the last packet */
+    if (TRUE == flashloader_plat_pack_done)
+    {
+        return PMC_SUCCESS;
+    }
+
+    if (0 == flash_write_index)
+    {
+        in_ptr += FLASH_LOADER_PACK_HDR_SIZE;
+        in_len -= FLASH_LOADER_PACK_HDR_SIZE;
+    }
+
+    do
+    {
+        status = lz_decomp_run(&flashloader_plat_pack_decomp,
+                               &in_ptr,
+                               &in_len,
+                               &flashloader_plat_pack_page[flashloader_plat_pack_page_len],
+                               FLASH_LOADER_PAGE_BUF_SIZE - flashloader_plat_pack_page_len,
+                               &out_len);
+
+        flashloader_plat_pack_page_len += out_len;
+
+        if (status > LZ_DECOMP_STATUS_DONE)
+        {
+            bc_printf("Flashloader: compressed packet %d decode error %d\n", flash_write_index, status);
+            flashloader_plat_pack_active = FALSE;
+            flashloader_plat_pack_failed = TRUE;
+            *err_code = FLASHLOADER_PLAT_ERR_PACK_CORRUPT;
+            return FLASHLOADER_PLAT_ERR_PACK_CORRUPT;
+        }
+
+        if (LZ_DECOMP_STATUS_DONE == status)
+        {
+            memset(&flashloader_plat_pack_page[flashloader_plat_pack_page_len],
+                   0xFF,
+                   FLASH_LOADER_PAGE_BUF_SIZE - flashloader_plat_pack_page_len);
+            flashloader_plat_pack_page_len = FLASH_LOADER_PAGE_BUF_SIZE;
+            flashloader_plat_pack_done = TRUE;
+        }
+
+        if (FLASH_LOADER_PAGE_BUF_SIZE == flashloader_plat_pack_page_len)
+        {
+            rc = flashloader_plat_staging_page_write(flashloader_plat_pack_page_index,
+                                                     flashloader_plat_pack_page,
+                                                     err_code);
+            if (PMC_SUCCESS != rc)
+            {
+                flashloader_plat_pack_active = FALSE;
+                flashloader_plat_pack_failed = TRUE;
+                return rc;
+            }
+
+            flashloader_plat_pack_page_index++;
+            flashloader_plat_pack_page_len = 0;
+        }
+
+    } while (LZ_DECOMP_STATUS_OUTPUT_FULL == status);
+
+    return PMC_SUCCESS;
+}
+#endif
+
+#if ((EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1) || (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1))
+/**
+* @brief
+*   Check that the staging area holds the whole image of the download
+*   and that it matches the image digest, before it is authenticated or
+*   committed.
+* 
+* @param [out] err_code - flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PRIVATE UINT32 flashloader_plat_image_check(UINT32 *err_code)
+{
+#if (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1)
+    if (TRUE == flashloader_plat_pack_failed)
+    {
+        *err_code = FLASHLOADER_PLAT_ERR_PACK_ABORTED;
+        return FLASHLOADER_PLAT_ERR_PACK_ABORTED;
+    }
+
+    if (TRUE == flashloader_plat_pack_active)
+    {
+        if (FALSE == flashloader_plat_pack_done)
+        {
+            bc_printf("Flashloader: compressed image incomplete\n");
+            *err_code = FLASHLOADER_PLAT_ERR_PACK_INCOMPLETE;
+            return FLASHLOADER_PLAT_ERR_PACK_INCOMPLETE;
+        }
+
+        return flashloader_plat_digest_check(flashloader_plat_pack_raw_len, flashloader_plat_pack_digest, err_code);
+    }
+#endif
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+    return flashloader_plat_record_check(err_code);
+#else
     return PMC_SUCCESS;
+#endif
+}
+#endif
+
+/**
+* @brief
+*   Write the data into temp buffer within the flash
+*   Data authentication will happen during FLASH COMMIT command
+*
+*   When compressed upgrades are enabled, an image whose first packet
+*   carries the pack header is decoded on the fly and the plain image is
+*   written to the temp buffer instead. Once a compressed image fails, its
+*   packets are refused until the HOST restarts from packet 0.
+*
+*   When resumable upgrades are enabled, raw image chunks are tracked in
+*   the upgrade record and may be sent in any order.
+* 
+* @param [in]  flash_write_index     -  Actual address of flash is flash_write_index * 256B   
+* @param [in]  flash_image_data_buf -  Data buffer 
+* @param [out] err_code             -  flash error codes
+* 
+* @return
+*   Success or Failure code
+*
+*/
+PUBLIC UINT32 flashloader_plat_flash_buffer_write(UINT32 flash_write_index, 
+                                                  UINT8 *flash_image_data_buf, 
+                                                  UINT32 *err_code)
+{
+#if (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1)
+    UINT32 rc;
+
+    if (0 == flash_write_index)
+    {
+        rc = flashloader_plat_pack_start(flash_image_data_buf, err_code);
+        if (PMC_SUCCESS != rc)
+        {
+            return rc;
+        }
+    }
+
+    /* the rest of a failed compressed image must not land in the staging area raw */
+    if (TRUE == flashloader_plat_pack_failed)
+    {
+        bc_printf("Flashloader: packet %d of a failed compressed image refused\n", flash_write_index);
+        *err_code = FLASHLOADER_PLAT_ERR_PACK_ABORTED;
+        return FLASHLOADER_PLAT_ERR_PACK_ABORTED;
+    }
+
+    if (TRUE == flashloader_plat_pack_active)
+    {
+        return flashloader_plat_pack_buffer_write(flash_write_index, flash_image_data_buf, err_code);
+    }
+#endif
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+    return flashloader_plat_resume_buffer_write(flash_write_index, flash_image_data_buf, err_code);
+#else
+    return flashloader_plat_staging_page_write(flash_write_index, flash_image_data_buf, err_code);
+#endif
 }
 
 /**
@@ -797,6 +1670,14 @@ PUBLIC UINT32 flashloader_plat_flash_image_validate(UINT32 *err_code)
     fam_image_desc_struct image_list;
     UINT32 pkey_array[FLASH_LOADER_PLAT_NUM_PUBLIC_KEYS];
 
+#if ((EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1) || (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1))
+    /* the whole image must be staged and match its digest before it is authenticated */
+    if (PMC_SUCCESS != flashloader_plat_image_check(err_code))
+    {
+        return PMCFW_ERR_FAIL;
+    }
+#endif
+
     /* Point the image location to temporary partition in flash*/
     image_list.image_addr = (UINT8*)SPI_FLASH_FW_FW_UPGRADE_ADDR;
     /* To indicate this is temporary partition*/
@@ -856,6 +1737,15 @@ PUBLIC UINT32 flashloader_plat_flash_image_finalize(INT8 flash_partition_id, UIN
     top_plat_lock_struct lock_struct;
 
     bc_printf("flashloader_plat_flash_image_finalize, moving code to partition %c\n", flash_partition_id);
+
+#if ((EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1) || (EXPLORER_FW_UPGRADE_COMPRESSION_ENABLE == 1))
+    rc = flashloader_plat_image_check(err_code);
+    if (PMC_SUCCESS != rc)
+    {
+        return rc;
+    }
+#endif
+
     /* Point the image location to temporary partition in flash*/
     image_list.image_addr = (UINT8*)SPI_FLASH_FW_FW_UPGRADE_ADDR;
     image_length =fam_image_length_get(&image_list, image_id) + SPI_FLASH_FW_IMG_A_HDR_SIZE;
@@ -1002,6 +1892,12 @@ PUBLIC UINT32 flashloader_plat_flash_image_finalize(INT8 flash_partition_id, UIN
     }
     
     bc_printf("...Done\n");
+
+#if (EXPLORER_FW_UPGRADE_RESUME_ENABLE == 1)
+    /* the download is complete, a new write starts from scratch */
+    flashloader_plat_record_discard();
+#endif
+
     return PMC_SUCCESS;    
 
 }
@@ -0,0 +1,184 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup BC_LOG
+* @{
+* @file
+* @brief
+*    Rate limiter of the leveled bc_printf() logging.
+*
+* @note
+*    The bucket is refilled from the Timer0 system seconds, so a call site
+*    is limited to whole seconds and starts full at boot.
+*/
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_common.h"
+#include "opsw_timer.h"
+#include "cmdsvr_plat_cfg.h"
+#include "bc_log.h"
+
+#if (CMDSVR_REG_COMMANDS == 1)
+#include "cmdsvr_func_api.h"
+#endif
+
+/*
+** Local Constants
+*/
+
+#define PMC_ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/*
+** Local Variables
+*/
+
+/* Messages dropped by all call sites since boot and estimate of their size */
+PRIVATE UINT32 bc_log_rl_suppressed_msgs;
+PRIVATE UINT32 bc_log_rl_suppressed_bytes;
+
+/*
+** Forward References
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+PRIVATE PMCFW_ERROR bc_log_cmd_rl_show(CHAR **args, UINT8 num_args);
+
+/* list of command server commands registered by the logging module */
+#pragma ghs startdata
+PRIVATE cmdsvr_cmd_def_struct bc_log_cmd_set[] = {
+    {
+        "log_rl",
+        "Show the log messages dropped by the rate limiter",
+        bc_log_cmd_rl_show,
+        "Cmd Usage: log_rl\n",
+        FALSE
+    }
+};
+#pragma ghs enddata
+#endif
+
+/*
+** Private Functions
+*/
+
+#if (CMDSVR_REG_COMMANDS == 1)
+/**
+* @brief
+*   Command server handler to show the rate limiter counters.
+*
+* @param[in] args     - command arguments
+* @param[in] num_args - number of arguments
+*
+* @return
+*   PMC_SUCCESS
+*/
+PRIVATE PMCFW_ERROR bc_log_cmd_rl_show(CHAR **args, UINT8 num_args)
+{
+    bc_printf("log_rl: %d messages suppressed, about %d bytes\n",
+              bc_log_rl_suppressed_msgs,
+              bc_log_rl_suppressed_bytes);
+
+    return PMC_SUCCESS;
+}
+#endif
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Take a token from the bucket of a call site, see BC_LOG_RL().
+*
+* @param[in,out] rl_ptr - rate limiter state of the call site
+*
+* @return
+*   TRUE if the message is to be logged, FALSE if it is dropped
+*
+* @note
+*   Logs the number of messages dropped before returning TRUE.
+*/
+PUBLIC BOOL bc_log_rl_check(bc_log_rl_struct *rl_ptr)
+{
+    UINT32 now_s = opsw_timer0_read();
+    UINT32 elapsed_s = now_s - rl_ptr->refill_s;
+    UINT32 refill;
+
+    /* refill burst tokens per period, keeping the part of a token accrued */
+    refill = rl_ptr->burst;
+    if (elapsed_s < rl_ptr->period_s)
+    {
+        refill = (elapsed_s * rl_ptr->burst) / rl_ptr->period_s;
+    }
+    if (0 != refill)
+    {
+        if ((rl_ptr->tokens + refill) >= rl_ptr->burst)
+        {
+            rl_ptr->tokens = rl_ptr->burst;
+            rl_ptr->refill_s = now_s;
+        }
+        else
+        {
+            rl_ptr->tokens += (UINT16)refill;
+            rl_ptr->refill_s += (refill * rl_ptr->period_s) / rl_ptr->burst;
+        }
+    }
+
+    if (0 == rl_ptr->tokens)
+    {
+        rl_ptr->suppressed++;
+        bc_log_rl_suppressed_msgs++;
+        bc_log_rl_suppressed_bytes += rl_ptr->last_len;
+        return (FALSE);
+    }
+    rl_ptr->tokens--;
+
+    if (0 != rl_ptr->suppressed)
+    {
+        bc_printf("(%d messages suppressed)\n", rl_ptr->suppressed);
+        rl_ptr->suppressed = 0;
+    }
+
+    return (TRUE);
+}
+
+/**
+* @brief
+*   Register the logging commands with the command server.
+*
+* @return
+*   None
+*/
+PUBLIC VOID bc_log_init(VOID)
+{
+#if (CMDSVR_REG_COMMANDS == 1)
+    PMCFW_ERROR rv;
+
+    rv = cmdsvr_func_list_register(bc_log_cmd_set, PMC_ARRAY_SIZE(bc_log_cmd_set));
+    PMCFW_ASSERT(rv == PMC_SUCCESS, rv);
+#endif
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
@@ -0,0 +1,667 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+
+/**
+* @addtogroup LOG_CHAN
+* @{
+* @file
+* @brief
+*    Per-subsystem log channel implementation.
+*
+* @note
+*    The sequence number is taken and the record written to the CCB in one
+*    critical region, so the records of all channels are in sequence order
+*    and a record is never interleaved with a message printed by the other
+*    VPE. A channel CCB that wrapped starts with the tail of a record,
+*    which is skipped when the channel is parsed.
+*/
+
+/*
+** Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "cpuhal.h"
+#include "ccb_api.h"
+#include "crash_dump.h"
+#include "crash_dump_plat.h"
+#include "top_plat.h"
+#include "exp_api.h"
+#include "log_chan.h"
+
+/*
+** Local Constants
+*/
+
+/* VPEs with a current channel */
+#define LOG_CHAN_NUM_VPE            2
+
+/*
+** Local Variables
+*/
+
+/* Channel sizes and names, in log_chan_enum order */
+PRIVATE const UINT32 log_chan_size[LOG_CHAN_NUM] =
+{
+    EXPLORER_LOG_CHAN_FATAL_SIZE,
+    EXPLORER_LOG_CHAN_BOOT_SIZE,
+    EXPLORER_LOG_CHAN_FLASH_SIZE,
+    EXPLORER_LOG_CHAN_DDR_SIZE,
+    EXPLORER_LOG_CHAN_SERDES_SIZE,
+    EXPLORER_LOG_CHAN_ECH_SIZE
+};
+
+PRIVATE const CHAR *log_chan_name[LOG_CHAN_NUM] =
+{
+    "fatal",
+    "boot",
+    "flash",
+    "ddr",
+    "serdes",
+    "ech"
+};
+
+/* CCB of each channel, NULL if the channel is not built */
+PRIVATE VOID *log_chan_ccb_ctrl[LOG_CHAN_NUM];
+
+/* Channel entered last on each VPE, LOG_CHAN_NONE outside any channel */
+PRIVATE volatile UINT8 log_chan_cur[LOG_CHAN_NUM_VPE] = { LOG_CHAN_NONE, LOG_CHAN_NONE };
+
+/* Channel of the messages printed outside any channel */
+PRIVATE volatile UINT8 log_chan_default = LOG_CHAN_BOOT;
+
+/* Sequence number of the next record */
+PRIVATE UINT32 log_chan_next_seq;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Current channel slot of the calling VPE.
+*
+* @return
+*   slot
+*/
+PRIVATE volatile UINT8* log_chan_cur_ptr_get(VOID)
+{
+    UINT32 vpe = hal_sys_cpu_id_get();
+
+    return (&log_chan_cur[(vpe < LOG_CHAN_NUM_VPE) ? vpe : (LOG_CHAN_NUM_VPE - 1)]);
+}
+
+/**
+* @brief
+*   Value of a hex digit.
+*
+* @param[in] c - character
+*
+* @return
+*   0 to 15, 0xFF if c is not a hex digit
+*/
+PRIVATE UINT8 log_chan_hex_val(CHAR c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return ((UINT8)(c - '0'));
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return ((UINT8)(c - 'a' + 10));
+    }
+
+    return (0xFF);
+}
+
+/**
+* @brief
+*   Copy the contents of a channel to the crash dump.
+*
+* @param[in] chan - channel
+*
+* @return
+*   None
+*/
+PRIVATE VOID log_chan_crash_dump(UINT8 chan)
+{
+    UINT32 size = 0;
+    UINT8 *cd_ram_ptr;
+    VOID *addr_ptr;
+
+    cd_ram_ptr = crash_dump_plat_ram_buf_wr_ptr_get();
+
+    if (NULL != log_chan_ccb_ctrl[chan])
+    {
+        size = ccb_info_get(log_chan_ccb_ctrl[chan], &addr_ptr);
+        ccb_get(log_chan_ccb_ctrl[chan], (CHAR *)cd_ram_ptr, size);
+    }
+
+    crash_dump_plat_ram_buf_wr_ptr_update(size);
+}
+
+/**
+* @brief
+*   Crash dump function of the fatal channel.
+*
+* @return
+*   None
+*/
+PRIVATE VOID log_chan_fatal_crash_dump(VOID)
+{
+    log_chan_crash_dump(LOG_CHAN_FATAL);
+}
+
+/**
+* @brief
+*   Crash dump function of the boot channel.
+*
+* @return
+*   None
+*/
+PRIVATE VOID log_chan_boot_crash_dump(VOID)
+{
+    log_chan_crash_dump(LOG_CHAN_BOOT);
+}
+
+/**
+* @brief
+*   Append text to the merged read-out.
+*
+* @param[in]     dst_ptr - read-out
+* @param[in]     len     - size of the read-out
+* @param[in,out] pos_ptr - bytes written
+* @param[in]     src_ptr - text
+* @param[in]     n       - length of the text
+*
+* @return
+*   TRUE if the text fit
+*/
+PRIVATE BOOL log_chan_out(CHAR *dst_ptr, UINT32 len, UINT32 *pos_ptr, const CHAR *src_ptr, UINT32 n)
+{
+    if ((len - *pos_ptr) < n)
+    {
+        return (FALSE);
+    }
+
+    memcpy(&dst_ptr[*pos_ptr], src_ptr, n);
+    *pos_ptr += n;
+
+    return (TRUE);
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Allocate the CCB of each channel.
+*
+* @return
+*   None
+*
+* @note
+*   Must be called after ccb_init(), with room for LOG_CHAN_NUM buffers,
+*   and before the first bc_printf() to be kept in the boot channel.
+*/
+PUBLIC VOID log_chan_init(VOID)
+{
+    UINT32 chan;
+
+    for (chan = 0; chan < LOG_CHAN_NUM; chan++)
+    {
+        if (0 != log_chan_size[chan])
+        {
+            log_chan_ccb_ctrl[chan] = ccb_buffer_init(log_chan_size[chan]);
+        }
+    }
+}
+
+/**
+* @brief
+*   End of boot, messages printed outside any channel are no longer kept in
+*   the boot channel.
+*
+* @return
+*   None
+*/
+PUBLIC VOID log_chan_boot_done(VOID)
+{
+    log_chan_default = LOG_CHAN_NONE;
+}
+
+/**
+* @brief
+*   Enter a channel on the calling VPE.
+*
+* @param[in] chan - log_chan_enum or LOG_CHAN_NONE
+*
+* @return
+*   Channel to pass to log_chan_exit()
+*
+* @note
+*   Channels nest, an interrupt handler or a task run while a command
+*   yields restores the channel it entered before it returns.
+*/
+PUBLIC UINT8 log_chan_enter(UINT8 chan)
+{
+    volatile UINT8 *cur_ptr = log_chan_cur_ptr_get();
+    UINT8 prev_chan = *cur_ptr;
+
+    *cur_ptr = chan;
+
+    return (prev_chan);
+}
+
+/**
+* @brief
+*   Leave the channel entered last on the calling VPE.
+*
+* @param[in] prev_chan - value returned by log_chan_enter()
+*
+* @return
+*   None
+*/
+PUBLIC VOID log_chan_exit(UINT8 prev_chan)
+{
+    *log_chan_cur_ptr_get() = prev_chan;
+}
+
+/**
+* @brief
+*   Channel of an OpenCAPI command.
+*
+* @param[in] cmd_id - exp_cmd_enum
+*
+* @return
+*   log_chan_enum
+*/
+PUBLIC UINT8 log_chan_oc_cmd_chan_get(UINT8 cmd_id)
+{
+    switch (cmd_id)
+    {
+        case EXP_FW_DDR_PHY_INIT:
+        case EXP_FW_PHY_STEP_BY_STEP_INIT:
+            return (LOG_CHAN_DDR);
+
+        case EXP_FW_BINARY_UPGRADE:
+        case EXP_FW_FLASH_LOADER_VERSION_INFO:
+            return (LOG_CHAN_FLASH);
+
+        default:
+            return (LOG_CHAN_ECH);
+    }
+}
+
+/**
+* @brief
+*   Channel of a TWI command.
+*
+* @param[in] cmd_id - exp_twi_cmd_enum
+*
+* @return
+*   log_chan_enum
+*/
+PUBLIC UINT8 log_chan_twi_cmd_chan_get(UINT8 cmd_id)
+{
+    if ((cmd_id >= EXP_FW_PQM_LANE_SET) && (cmd_id <= EXP_FW_PQM_2D_BATHTUB_GET_READ))
+    {
+        return (LOG_CHAN_SERDES);
+    }
+
+    switch (cmd_id)
+    {
+        case EXP_FW_TWI_CMD_BOOT_CONFIG:
+        case EXP_FW_TWI_FFE_SETTINGS:
+        case EXP_FW_CDR_OFFSET_FROM_CAL_SET:
+        case EXP_FW_CDR_BANDWIDTH_SET:
+        case EXP_FW_PRBS_CAL_STATUS_READ:
+        case EXP_FW_CONT_SERDES_CAL_DISABLE:
+            return (LOG_CHAN_SERDES);
+
+        case EXP_FW_PQM_FORCE_DELAY_LINE_UPDATE:
+            return (LOG_CHAN_DDR);
+
+        case EXP_FW_TWI_CMD_FW_DOWNLOAD:
+            return (LOG_CHAN_FLASH);
+
+        default:
+            return (LOG_CHAN_ECH);
+    }
+}
+
+/**
+* @brief
+*   Write a message to the channel of the calling VPE, called by
+*   bc_printf().
+*
+* @param[in] buf_ptr - message
+* @param[in] len     - length of the message
+* @param[in] crash   - the message is printed on the crash channel
+*
+* @return
+*   None
+*/
+PUBLIC VOID log_chan_put(const CHAR *buf_ptr, UINT32 len, BOOL crash)
+{
+    CHAR hdr[LOG_CHAN_REC_HDR_SIZE];
+    top_plat_lock_struct lock_struct;
+    UINT32 chan = LOG_CHAN_FATAL;
+    UINT32 seq;
+    UINT32 i;
+
+    if (FALSE == crash)
+    {
+        chan = *log_chan_cur_ptr_get();
+        if (LOG_CHAN_NONE == chan)
+        {
+            chan = log_chan_default;
+        }
+    }
+
+    if ((chan >= LOG_CHAN_NUM) || (NULL == log_chan_ccb_ctrl[chan]) || (0 == len))
+    {
+        return;
+    }
+
+    top_plat_critical_region_enter(&lock_struct);
+
+    seq = log_chan_next_seq++;
+    hdr[0] = LOG_CHAN_REC_MARK;
+    for (i = 0; i < (LOG_CHAN_REC_HDR_SIZE - 1); i++)
+    {
+        hdr[LOG_CHAN_REC_HDR_SIZE - 1 - i] = "0123456789abcdef"[(seq >> (i * 4)) & 0xF];
+    }
+
+    ccb_put(log_chan_ccb_ctrl[chan], hdr, LOG_CHAN_REC_HDR_SIZE);
+    ccb_put(log_chan_ccb_ctrl[chan], buf_ptr, len);
+
+    top_plat_critical_region_exit(lock_struct);
+}
+
+/**
+* @brief
+*   Whether a message of the calling VPE is printed to the UART, called by
+*   bc_printf().
+*
+* @return
+*   FALSE for the DDR channel if EXPLORER_DDR_PHY_TRACE_UART is 0, TRUE
+*   otherwise
+*/
+PUBLIC BOOL log_chan_uart_get(VOID)
+{
+#if (EXPLORER_DDR_PHY_TRACE_UART == 0)
+    if (LOG_CHAN_DDR == *log_chan_cur_ptr_get())
+    {
+        return (FALSE);
+    }
+#endif
+
+    return (TRUE);
+}
+
+/**
+* @brief
+*   Size of a channel.
+*
+* @param[in] chan - log_chan_enum
+*
+* @return
+*   Size in bytes, 0 if the channel is not built
+*/
+PUBLIC UINT32 log_chan_size_get(UINT8 chan)
+{
+    VOID *addr_ptr;
+
+    if ((chan >= LOG_CHAN_NUM) || (NULL == log_chan_ccb_ctrl[chan]))
+    {
+        return (0);
+    }
+
+    return (ccb_info_get(log_chan_ccb_ctrl[chan], &addr_ptr));
+}
+
+/**
+* @brief
+*   Copy the contents of a channel, oldest first.
+*
+* @param[in]  chan    - log_chan_enum
+* @param[out] dst_ptr - contents
+* @param[in]  len     - size of dst_ptr, at least log_chan_size_get(chan)
+*
+* @return
+*   Bytes copied, 0 if the channel is not built or dst_ptr is too small
+*/
+PUBLIC UINT32 log_chan_get(UINT8 chan, CHAR *dst_ptr, UINT32 len)
+{
+    UINT32 size = log_chan_size_get(chan);
+
+    if ((0 == size) || (len < size))
+    {
+        return (0);
+    }
+
+    ccb_get(log_chan_ccb_ctrl[chan], dst_ptr, size);
+
+    return (size);
+}
+
+/**
+* @brief
+*   Parse the next record of the contents of a channel.
+*
+* @param[in]     buf_ptr    - contents from log_chan_get()
+* @param[in]     len        - length of the contents
+* @param[in,out] offset_ptr - parse position, 0 for the first record
+* @param[out]    rec_ptr    - record
+*
+* @return
+*   TRUE if a record was found
+*
+* @note
+*   Bytes that do not follow a valid record header, such as the tail of
+*   a record that was overwritten, are skipped. A record ends at the next
+*   mark, at a NUL or at the end of the contents.
+*/
+PUBLIC BOOL log_chan_rec_next(const CHAR *buf_ptr,
+                              UINT32 len,
+                              UINT32 *offset_ptr,
+                              log_chan_rec_struct *rec_ptr)
+{
+    UINT32 off = *offset_ptr;
+    UINT32 end;
+    UINT32 i;
+    UINT8 val;
+
+    while ((off + LOG_CHAN_REC_HDR_SIZE) <= len)
+    {
+        if (LOG_CHAN_REC_MARK != buf_ptr[off])
+        {
+            off++;
+            continue;
+        }
+
+        rec_ptr->seq = 0;
+        for (i = 1; i < LOG_CHAN_REC_HDR_SIZE; i++)
+        {
+            val = log_chan_hex_val(buf_ptr[off + i]);
+            if (0xFF == val)
+            {
+                break;
+            }
+            rec_ptr->seq = (rec_ptr->seq << 4) | val;
+        }
+        if (i < LOG_CHAN_REC_HDR_SIZE)
+        {
+            off++;
+            continue;
+        }
+
+        end = off + LOG_CHAN_REC_HDR_SIZE;
+        while ((end < len) && (LOG_CHAN_REC_MARK != buf_ptr[end]) && ('\0' != buf_ptr[end]))
+        {
+            end++;
+        }
+
+        rec_ptr->text_ptr = &buf_ptr[off + LOG_CHAN_REC_HDR_SIZE];
+        rec_ptr->text_len = end - (off + LOG_CHAN_REC_HDR_SIZE);
+        *offset_ptr = end;
+
+        return (TRUE);
+    }
+
+    *offset_ptr = len;
+
+    return (FALSE);
+}
+
+/**
+* @brief
+*   Merge the channels into one text log in sequence order.
+*
+* @param[out] dst_ptr     - merged log
+* @param[in]  len         - size of dst_ptr
+* @param[in]  scratch_ptr - room for the contents of the channels, must not
+*                           overlap dst_ptr
+* @param[in]  scratch_len - size of scratch_ptr, LOG_CHAN_TOTAL_SIZE
+*                           holds all channels
+*
+* @return
+*   Bytes written to dst_ptr
+*
+* @note
+*   Each line starts with the name of its channel in brackets. The log is
+*   cut at the newest end if dst_ptr is too small, and a channel that does
+*   not fit in scratch_ptr is left out.
+*/
+PUBLIC UINT32 log_chan_read(CHAR *dst_ptr,
+                            UINT32 len,
+                            CHAR *scratch_ptr,
+                            UINT32 scratch_len)
+{
+    const CHAR *buf_ptr[LOG_CHAN_NUM];
+    UINT32 buf_len[LOG_CHAN_NUM];
+    UINT32 offset[LOG_CHAN_NUM];
+    log_chan_rec_struct rec[LOG_CHAN_NUM];
+    BOOL rec_valid[LOG_CHAN_NUM];
+    CHAR prefix[16];
+    UINT32 prefix_len;
+    UINT32 used = 0;
+    UINT32 pos = 0;
+    UINT32 last_chan = LOG_CHAN_NUM;
+    BOOL line_start = TRUE;
+    UINT32 chan;
+    UINT32 next;
+    UINT32 i;
+
+    /* copy each channel, oldest record first */
+    for (chan = 0; chan < LOG_CHAN_NUM; chan++)
+    {
+        buf_ptr[chan] = &scratch_ptr[used];
+        buf_len[chan] = log_chan_get((UINT8)chan, &scratch_ptr[used], scratch_len - used);
+        used += buf_len[chan];
+        offset[chan] = 0;
+        rec_valid[chan] = log_chan_rec_next(buf_ptr[chan], buf_len[chan], &offset[chan], &rec[chan]);
+    }
+
+    PMC_LOOP_FOREVER
+    {
+        /* oldest record of all channels */
+        next = LOG_CHAN_NUM;
+        for (chan = 0; chan < LOG_CHAN_NUM; chan++)
+        {
+            if ((TRUE == rec_valid[chan]) &&
+                ((LOG_CHAN_NUM == next) || ((INT32)(rec[chan].seq - rec[next].seq) < 0)))
+            {
+                next = chan;
+            }
+        }
+        if (LOG_CHAN_NUM == next)
+        {
+            break;
+        }
+
+        /* a message printed in pieces continues on the same line */
+        if ((FALSE == line_start) && (next != last_chan))
+        {
+            if (FALSE == log_chan_out(dst_ptr, len, &pos, "\n", 1))
+            {
+                break;
+            }
+            line_start = TRUE;
+        }
+        last_chan = next;
+
+        prefix_len = 0;
+        prefix[prefix_len++] = '[';
+        for (i = 0; ('\0' != log_chan_name[next][i]) && (prefix_len < (sizeof(prefix) - 2)); i++)
+        {
+            prefix[prefix_len++] = log_chan_name[next][i];
+        }
+        prefix[prefix_len++] = ']';
+        prefix[prefix_len++] = ' ';
+
+        for (i = 0; i < rec[next].text_len; i++)
+        {
+            if ((TRUE == line_start) &&
+                (FALSE == log_chan_out(dst_ptr, len, &pos, prefix, prefix_len)))
+            {
+                return (pos);
+            }
+            if (FALSE == log_chan_out(dst_ptr, len, &pos, &rec[next].text_ptr[i], 1))
+            {
+                return (pos);
+            }
+            line_start = ('\n' == rec[next].text_ptr[i]);
+        }
+
+        rec_valid[next] = log_chan_rec_next(buf_ptr[next], buf_len[next], &offset[next], &rec[next]);
+    }
+
+    return (pos);
+}
+
+/**
+* @brief
+*   Register the high priority channels with the crash dump.
+*
+* @return
+*   None
+*
+* @note
+*   Called before the runtime CCB is registered, so the fatal and boot
+*   history is written first when the crash dump runs out of room.
+*/
+PUBLIC VOID log_chan_crash_dump_register(VOID)
+{
+    if (0 != EXPLORER_LOG_CHAN_FATAL_SIZE)
+    {
+        crash_dump_register(CRASH_DUMP_SET_0, "LOG_FATAL", &log_chan_fatal_crash_dump, CRASH_DUMP_ASCII, EXPLORER_LOG_CHAN_FATAL_SIZE);
+    }
+    if (0 != EXPLORER_LOG_CHAN_BOOT_SIZE)
+    {
+        crash_dump_register(CRASH_DUMP_SET_0, "LOG_BOOT", &log_chan_boot_crash_dump, CRASH_DUMP_ASCII, EXPLORER_LOG_CHAN_BOOT_SIZE);
+    }
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
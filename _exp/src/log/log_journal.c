@@ -0,0 +1,613 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LOG_JOURNAL
+* @{
+* @file
+* @brief
+*   Append-only SPI flash log journal implementation.
+*
+* @note
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "log_journal.h"
+#include "spi_flash.h"
+#include "spi_flash_api.h"
+#include "spi_flash_plat.h"
+#include "crc32_api.h"
+#include "top_plat.h"
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+/* Flash address of a subsector or of an offset within one */
+#define LOG_JOURNAL_ADDR(journal_ptr, subsector, offset) \
+    ((journal_ptr)->base_addr + ((subsector) * LOG_JOURNAL_SUBSECTOR_SIZE) + (offset))
+
+/* Flash space taken by a record with a payload of len bytes */
+#define LOG_JOURNAL_RECORD_SIZE(len) \
+    ((sizeof(log_journal_hdr_struct) + (len) + LOG_JOURNAL_PAGE_SIZE - 1) & ~(LOG_JOURNAL_PAGE_SIZE - 1))
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Local Variables
+*/
+
+/* page staging buffer, shared by every journal */
+PRIVATE UINT8 log_journal_page_buf[LOG_JOURNAL_PAGE_SIZE];
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Program one page of the journal from log_journal_page_buf.
+*
+* @param [in] flash_addr - virtual SPI flash address of the page
+*
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR log_journal_page_program(UINT32 flash_addr)
+{
+    PMCFW_ERROR rc;
+    spi_flash_dev_enum dev;
+    spi_flash_dev_info_struct dev_info;
+    top_plat_lock_struct lock_struct;
+
+    rc = spi_flash_dev_info_get(SPI_FLASH_PORT,
+                                SPI_FLASH_CS,
+                                &dev,
+                                &dev_info);
+
+    if (PMC_SUCCESS != rc)
+    {
+        return (rc);
+    }
+
+    /* disable interrupts and disable multi-VPE operation */
+    top_plat_critical_region_enter(&lock_struct);
+
+    rc = spi_flash_write_pages(SPI_FLASH_PORT,
+                               SPI_FLASH_CS,
+                               log_journal_page_buf,
+                               (UINT8*)(flash_addr & GPBC_FLASH_PHYS_ADDR_MASK),
+                               LOG_JOURNAL_PAGE_SIZE,
+                               dev_info.page_size,
+                               dev_info.max_time_page_prog);
+
+    /* restore interrupts and enable multi-VPE operation */
+    top_plat_critical_region_exit(lock_struct);
+
+    return (rc);
+}
+
+/**
+* @brief
+*   Validate the record at an offset of a subsector.
+*
+* @param [in]  journal_ptr - journal context
+* @param [in]  subsector   - subsector index
+* @param [in]  offset      - record offset within the subsector
+* @param [out] hdr_ptr     - record header
+*
+* @return
+*   TRUE if a complete record with a good CRC is found
+*
+* @note
+*   The record is read with ECC errors masked since it may be erased or
+*   only partially programmed.
+*/
+PRIVATE BOOL log_journal_record_check(log_journal_struct *journal_ptr,
+                                      UINT32 subsector,
+                                      UINT32 offset,
+                                      log_journal_hdr_struct *hdr_ptr)
+{
+    UINT32 addr = LOG_JOURNAL_ADDR(journal_ptr, subsector, offset);
+    UINT32 remaining;
+    UINT32 count;
+    UINT32 crc;
+
+    if (FALSE == spi_flash_plat_checked_read((UINT8*)hdr_ptr, (UINT8*)addr, sizeof(log_journal_hdr_struct)))
+    {
+        return (FALSE);
+    }
+
+    if ((LOG_JOURNAL_MAGIC != hdr_ptr->magic) ||
+        (0 == hdr_ptr->seq) ||
+        (0 == hdr_ptr->len) ||
+        (hdr_ptr->len > LOG_JOURNAL_MAX_PAYLOAD) ||
+        ((offset + LOG_JOURNAL_RECORD_SIZE(hdr_ptr->len)) > LOG_JOURNAL_SUBSECTOR_SIZE))
+    {
+        return (FALSE);
+    }
+
+    crc = pmc_crc32((UINT8*)&hdr_ptr->seq, 2 * sizeof(UINT32), 0, TRUE, FALSE);
+
+    /* check the payload one page buffer at a time */
+    addr += sizeof(log_journal_hdr_struct);
+    remaining = hdr_ptr->len;
+    while (remaining > 0)
+    {
+        count = (remaining > LOG_JOURNAL_PAGE_SIZE) ? LOG_JOURNAL_PAGE_SIZE : remaining;
+
+        if (FALSE == spi_flash_plat_checked_read(log_journal_page_buf, (UINT8*)addr, count))
+        {
+            return (FALSE);
+        }
+
+        remaining -= count;
+        crc = pmc_crc32(log_journal_page_buf, count, crc, FALSE, (0 == remaining));
+        addr += count;
+    }
+
+    return (crc == hdr_ptr->crc);
+}
+
+/**
+* @brief
+*   Rebuild the subsector state of a journal from flash.
+*
+* @param [in,out] journal_ptr - journal context
+*
+* @return
+*   None
+*
+* @note
+*   The head is set to the subsector holding the newest record and marked
+*   full, so the next append erases the following (oldest) subsector
+*   rather than programming after a record that may have been torn.
+*/
+PRIVATE VOID log_journal_mount(log_journal_struct *journal_ptr)
+{
+    log_journal_hdr_struct hdr;
+    UINT32 max_seq = 0;
+    UINT32 offset;
+    UINT32 i;
+
+    journal_ptr->head = journal_ptr->num_subsectors - 1;
+
+    for (i = 0; i < journal_ptr->num_subsectors; i++)
+    {
+        journal_ptr->first_seq[i] = 0;
+        journal_ptr->last_seq[i] = 0;
+        journal_ptr->payload_size[i] = 0;
+
+        /* records of a subsector are contiguous and in sequence order */
+        offset = 0;
+        while (((offset + sizeof(log_journal_hdr_struct)) <= LOG_JOURNAL_SUBSECTOR_SIZE) &&
+               (TRUE == log_journal_record_check(journal_ptr, i, offset, &hdr)) &&
+               (hdr.seq > journal_ptr->last_seq[i]))
+        {
+            if (0 == journal_ptr->first_seq[i])
+            {
+                journal_ptr->first_seq[i] = hdr.seq;
+            }
+            journal_ptr->last_seq[i] = hdr.seq;
+            journal_ptr->payload_size[i] += hdr.len;
+            offset += LOG_JOURNAL_RECORD_SIZE(hdr.len);
+        }
+        journal_ptr->end_offset[i] = offset;
+
+        if (journal_ptr->last_seq[i] > max_seq)
+        {
+            max_seq = journal_ptr->last_seq[i];
+            journal_ptr->head = i;
+        }
+    }
+
+    journal_ptr->next_seq = max_seq + 1;
+    journal_ptr->wr_offset = LOG_JOURNAL_SUBSECTOR_SIZE;
+    journal_ptr->mounted = TRUE;
+}
+
+/**
+* @brief
+*   Move the head to the next subsector, erasing it.
+*
+* @param [in,out] journal_ptr - journal context
+*
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR log_journal_head_advance(log_journal_struct *journal_ptr)
+{
+    UINT32 next = (journal_ptr->head + 1) % journal_ptr->num_subsectors;
+    PMCFW_ERROR rc;
+
+    /* forget the subsector before erasing it in case the erase fails */
+    journal_ptr->first_seq[next] = 0;
+    journal_ptr->last_seq[next] = 0;
+    journal_ptr->end_offset[next] = 0;
+    journal_ptr->payload_size[next] = 0;
+
+    rc = journal_ptr->erase_fn_ptr((UINT8*)LOG_JOURNAL_ADDR(journal_ptr, next, 0), LOG_JOURNAL_SUBSECTOR_SIZE);
+
+    if (PMC_SUCCESS != rc)
+    {
+        return (rc);
+    }
+
+    journal_ptr->head = next;
+    journal_ptr->wr_offset = 0;
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Write one record at the head of the journal.
+*
+* @param [in,out] journal_ptr - journal context
+* @param [in]     src_ptr     - payload
+* @param [in]     len         - payload length, at most LOG_JOURNAL_MAX_PAYLOAD
+*
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PRIVATE PMCFW_ERROR log_journal_record_write(log_journal_struct *journal_ptr,
+                                             UINT8 *src_ptr,
+                                             UINT32 len)
+{
+    log_journal_hdr_struct hdr;
+    UINT32 addr;
+    UINT32 page_offset;
+    UINT32 count;
+    UINT32 done = 0;
+    PMCFW_ERROR rc;
+
+    if ((journal_ptr->wr_offset + LOG_JOURNAL_RECORD_SIZE(len)) > LOG_JOURNAL_SUBSECTOR_SIZE)
+    {
+        rc = log_journal_head_advance(journal_ptr);
+
+        if (PMC_SUCCESS != rc)
+        {
+            return (rc);
+        }
+    }
+
+    hdr.magic = LOG_JOURNAL_MAGIC;
+    hdr.seq = journal_ptr->next_seq;
+    hdr.len = len;
+    hdr.crc = pmc_crc32((UINT8*)&hdr.seq, 2 * sizeof(UINT32), 0, TRUE, FALSE);
+    hdr.crc = pmc_crc32(src_ptr, len, hdr.crc, FALSE, TRUE);
+
+    addr = LOG_JOURNAL_ADDR(journal_ptr, journal_ptr->head, journal_ptr->wr_offset);
+
+    /* program each page of the record once, the header leads the first page */
+    memcpy(log_journal_page_buf, &hdr, sizeof(hdr));
+    page_offset = sizeof(hdr);
+    while (done < len)
+    {
+        count = LOG_JOURNAL_PAGE_SIZE - page_offset;
+        if (count > (len - done))
+        {
+            count = len - done;
+        }
+
+        memcpy(&log_journal_page_buf[page_offset], &src_ptr[done], count);
+        memset(&log_journal_page_buf[page_offset + count], 0xFF, LOG_JOURNAL_PAGE_SIZE - page_offset - count);
+        done += count;
+
+        rc = log_journal_page_program(addr);
+
+        if (PMC_SUCCESS != rc)
+        {
+            /* do not program after a partial record */
+            journal_ptr->wr_offset = LOG_JOURNAL_SUBSECTOR_SIZE;
+            return (rc);
+        }
+
+        addr += LOG_JOURNAL_PAGE_SIZE;
+        page_offset = 0;
+    }
+
+    if (0 == journal_ptr->first_seq[journal_ptr->head])
+    {
+        journal_ptr->first_seq[journal_ptr->head] = hdr.seq;
+    }
+    journal_ptr->last_seq[journal_ptr->head] = hdr.seq;
+    journal_ptr->payload_size[journal_ptr->head] += len;
+    journal_ptr->wr_offset += LOG_JOURNAL_RECORD_SIZE(len);
+    journal_ptr->end_offset[journal_ptr->head] = journal_ptr->wr_offset;
+    journal_ptr->next_seq++;
+
+    return (PMC_SUCCESS);
+}
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize a journal context. Flash is not accessed until the journal
+*   is first used.
+*
+* @param [out] journal_ptr  - journal context
+* @param [in]  base_addr    - virtual SPI flash address, subsector aligned
+* @param [in]  size         - journal size in bytes, a multiple of the subsector size
+* @param [in]  erase_fn_ptr - subsector erase function
+*
+* @return
+*   None
+*
+*/
+PUBLIC VOID log_journal_init(log_journal_struct *journal_ptr,
+                             UINT32 base_addr,
+                             UINT32 size,
+                             log_journal_erase_fn_ptr_type erase_fn_ptr)
+{
+    PMCFW_ASSERT((0 == (base_addr % LOG_JOURNAL_SUBSECTOR_SIZE)) &&
+                 (0 == (size % LOG_JOURNAL_SUBSECTOR_SIZE)) &&
+                 ((size / LOG_JOURNAL_SUBSECTOR_SIZE) >= 2) &&
+                 ((size / LOG_JOURNAL_SUBSECTOR_SIZE) <= LOG_JOURNAL_MAX_SUBSECTORS),
+                 PMCFW_ERR_INVALID_PARAMETERS);
+
+    journal_ptr->base_addr = base_addr;
+    journal_ptr->num_subsectors = size / LOG_JOURNAL_SUBSECTOR_SIZE;
+    journal_ptr->erase_fn_ptr = erase_fn_ptr;
+    journal_ptr->mounted = FALSE;
+}
+
+/**
+* @brief
+*   Append data to the journal, split into as many records as needed.
+*
+* @param [in,out] journal_ptr - journal context
+* @param [in]     src_ptr     - data to append
+* @param [in]     len         - number of bytes to append
+*
+* @return
+*   PMC_SUCCESS if no error, error code otherwise
+*
+* @note
+*   The oldest subsector is erased, and its records lost, whenever the
+*   head subsector is full.
+*/
+PUBLIC PMCFW_ERROR log_journal_append(log_journal_struct *journal_ptr,
+                                      UINT8 *src_ptr,
+                                      UINT32 len)
+{
+    UINT32 count;
+    PMCFW_ERROR rc;
+
+    if (FALSE == journal_ptr->mounted)
+    {
+        log_journal_mount(journal_ptr);
+    }
+
+    while (len > 0)
+    {
+        count = (len > LOG_JOURNAL_MAX_PAYLOAD) ? LOG_JOURNAL_MAX_PAYLOAD : len;
+
+        rc = log_journal_record_write(journal_ptr, src_ptr, count);
+
+        if (PMC_SUCCESS != rc)
+        {
+            return (rc);
+        }
+
+        src_ptr += count;
+        len -= count;
+    }
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Get the number of payload bytes held by the journal.
+*
+* @param [in,out] journal_ptr - journal context
+*
+* @return
+*   journal size in bytes
+*
+*/
+PUBLIC UINT32 log_journal_size_get(log_journal_struct *journal_ptr)
+{
+    UINT32 size = 0;
+    UINT32 i;
+
+    if (FALSE == journal_ptr->mounted)
+    {
+        log_journal_mount(journal_ptr);
+    }
+
+    for (i = 0; i < journal_ptr->num_subsectors; i++)
+    {
+        size += journal_ptr->payload_size[i];
+    }
+
+    return (size);
+}
+
+/**
+* @brief
+*   Read from the journal as a byte stream of the record payloads in
+*   sequence order.
+*
+* @param [in,out] journal_ptr - journal context
+* @param [out]    dst_ptr     - destination buffer
+* @param [in]     offset      - stream offset to read from
+* @param [in]     len         - number of bytes to read
+*
+* @return
+*   PMC_SUCCESS if no error, LOG_JOURNAL_ERR_RANGE if the range is not
+*   within the journal, LOG_JOURNAL_ERR_READ on a flash ECC error
+*
+*/
+PUBLIC PMCFW_ERROR log_journal_read(log_journal_struct *journal_ptr,
+                                    UINT8 *dst_ptr,
+                                    UINT32 offset,
+                                    UINT32 len)
+{
+    log_journal_hdr_struct hdr;
+    UINT32 prev_seq = 0;
+    UINT32 subsector;
+    UINT32 rec_offset;
+    UINT32 count;
+    UINT32 addr;
+    UINT32 i;
+
+    if ((offset > log_journal_size_get(journal_ptr)) ||
+        (len > (log_journal_size_get(journal_ptr) - offset)))
+    {
+        return (LOG_JOURNAL_ERR_RANGE);
+    }
+
+    while (len > 0)
+    {
+        /* the next subsector in sequence order, there is one since len is in range */
+        subsector = journal_ptr->num_subsectors;
+        for (i = 0; i < journal_ptr->num_subsectors; i++)
+        {
+            if ((journal_ptr->first_seq[i] > prev_seq) &&
+                ((subsector == journal_ptr->num_subsectors) ||
+                 (journal_ptr->first_seq[i] < journal_ptr->first_seq[subsector])))
+            {
+                subsector = i;
+            }
+        }
+        prev_seq = journal_ptr->first_seq[subsector];
+
+        if (offset >= journal_ptr->payload_size[subsector])
+        {
+            offset -= journal_ptr->payload_size[subsector];
+            continue;
+        }
+
+        /* walk the records of the subsector, they were validated on mount or written since */
+        rec_offset = 0;
+        while ((len > 0) && (rec_offset < journal_ptr->end_offset[subsector]))
+        {
+            addr = LOG_JOURNAL_ADDR(journal_ptr, subsector, rec_offset);
+
+            if (FALSE == spi_flash_plat_checked_read((UINT8*)&hdr, (UINT8*)addr, sizeof(hdr)))
+            {
+                return (LOG_JOURNAL_ERR_READ);
+            }
+
+            if (offset < hdr.len)
+            {
+                count = hdr.len - offset;
+                if (count > len)
+                {
+                    count = len;
+                }
+
+                if (FALSE == spi_flash_plat_checked_read(dst_ptr,
+                                                         (UINT8*)(addr + sizeof(hdr) + offset),
+                                                         count))
+                {
+                    return (LOG_JOURNAL_ERR_READ);
+                }
+
+                dst_ptr += count;
+                len -= count;
+                offset = 0;
+            }
+            else
+            {
+                offset -= hdr.len;
+            }
+
+            rec_offset += LOG_JOURNAL_RECORD_SIZE(hdr.len);
+        }
+    }
+
+    return (PMC_SUCCESS);
+}
+
+/**
+* @brief
+*   Erase every subsector of the journal.
+*
+* @param [in,out] journal_ptr - journal context
+*
+* @return
+*   PMC_SUCCESS if no error, SPI flash error otherwise
+*
+*/
+PUBLIC PMCFW_ERROR log_journal_erase(log_journal_struct *journal_ptr)
+{
+    PMCFW_ERROR rc;
+    UINT32 i;
+
+    if (FALSE == journal_ptr->mounted)
+    {
+        journal_ptr->next_seq = 1;
+    }
+
+    for (i = 0; i < journal_ptr->num_subsectors; i++)
+    {
+        journal_ptr->first_seq[i] = 0;
+        journal_ptr->last_seq[i] = 0;
+        journal_ptr->end_offset[i] = 0;
+        journal_ptr->payload_size[i] = 0;
+    }
+
+    /* until the erase completes the flash state is unknown, appends start over in a fresh subsector */
+    journal_ptr->head = journal_ptr->num_subsectors - 1;
+    journal_ptr->wr_offset = LOG_JOURNAL_SUBSECTOR_SIZE;
+    journal_ptr->mounted = TRUE;
+
+    rc = journal_ptr->erase_fn_ptr((UINT8*)journal_ptr->base_addr,
+                                   journal_ptr->num_subsectors * LOG_JOURNAL_SUBSECTOR_SIZE);
+
+    if (PMC_SUCCESS != rc)
+    {
+        return (rc);
+    }
+
+    /* the whole journal is erased, the first subsector can be programmed directly */
+    journal_ptr->head = 0;
+    journal_ptr->wr_offset = 0;
+
+    return (PMC_SUCCESS);
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
+
@@ -39,6 +39,14 @@
 #include "spi_flash_api.h"
 #include "crash_dump_plat.h"
 #include "top_plat.h"
+#include "log_journal.h"
+#include "ech_trace.h"
+#include "ech_stats.h"
+#include "log_chan.h"
+#include "pmc_profile.h"
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+#include "app_fw_pc_prof.h"
+#endif
 
 /*
 ** Local Enumerated Types
@@ -51,6 +59,9 @@
 #define LOG_STORED_FW_LOG_IDX   1
 #define LOG_MAX_FW_LOG_IDX      2
 
+/* saved log entries appended by one log_spi_flash_chan_store() */
+#define LOG_CHAN_SAVE_ENTRIES   (EXPLORER_LOG_CHAN_SAVE_SIZE / sizeof(log_app_entry_struct))
+
 /*
 ** Local Macro Definitions
 */
@@ -63,6 +74,23 @@
 ** Local Variables
 */
 
+/* saved log journals of image A and B */
+PRIVATE log_journal_struct log_journal_img_a;
+PRIVATE log_journal_struct log_journal_img_b;
+
+/* application log position stored by the last log_spi_flash_store() */
+PRIVATE BOOL   log_stored_valid = FALSE;
+PRIVATE UINT32 log_stored_wr_idx;
+PRIVATE UINT16 log_stored_wr_idx_wrap;
+
+/* newest log channel record stored by log_spi_flash_chan_store() */
+PRIVATE BOOL   log_chan_stored_valid[LOG_CHAN_NUM];
+PRIVATE UINT32 log_chan_stored_seq[LOG_CHAN_NUM];
+
+/* channel copy and saved log entries of log_spi_flash_chan_store() */
+PRIVATE CHAR log_chan_save_buf[LOG_CHAN_SIZE_MAX];
+PRIVATE log_app_entry_struct log_chan_save_entry[LOG_CHAN_SAVE_ENTRIES];
+
 /*
 ** Function Prototypes and Pointers to Functions in RAM
 **
@@ -190,6 +218,102 @@ PRIVATE PMCFW_ERROR _log_spi_flash_partition_erase(UINT8* spi_flash_addr,
 } /* log_spi_flash_clear */
 PMC_END_RAM_PROGRAM
 
+/**
+* @brief
+*   log journal erase function, calls the RAM resident partition erase
+*
+* @param
+*   spi_flash_addr - virtual SPI flash address
+*   num_bytes - amount of SPI flash to erase
+*
+*  @return
+*   Success - PMC_SUCCESS
+*   Failure - failure specific code
+*
+*/
+PRIVATE PMCFW_ERROR log_journal_plat_erase(UINT8* spi_flash_addr,
+                                           UINT32 num_bytes)
+{
+    return (log_spi_flash_partition_erase(spi_flash_addr, num_bytes));
+
+} /* log_journal_plat_erase */
+
+/**
+* @brief
+*   get the saved log journal of a firmware image
+*
+* @param
+*   image - EXP_FW_IMAGE_A or EXP_FW_IMAGE_B
+*
+*  @return
+*   journal context
+*
+*/
+PRIVATE log_journal_struct* log_journal_get(UINT32 image)
+{
+    if (EXP_FW_IMAGE_A == image)
+    {
+        return (&log_journal_img_a);
+    }
+
+    return (&log_journal_img_b);
+
+} /* log_journal_get */
+
+/**
+* @brief
+*   get the saved log journal of the active firmware image
+*
+*  @return
+*   journal context
+*
+*/
+PRIVATE log_journal_struct* log_journal_active_get(VOID)
+{
+    /* determine the active image to append to the correct journal */
+    if (SPI_FLASH_ACTIVE_IMG_A == (*(UINT32*)SPI_FLASH_FW_ACT_IMG_FLAG_ADDR & SPI_FLASH_ACTIVE_IMG_MASK))
+    {
+        /* firmware image A is the active image */
+        return (log_journal_get(EXP_FW_IMAGE_A));
+    }
+
+    /* firmware image B is the active image */
+    return (log_journal_get(EXP_FW_IMAGE_B));
+
+} /* log_journal_active_get */
+
+/**
+* @brief
+*   append a range of application log entries to a saved log journal
+*
+* @param
+*   journal_ptr - journal context
+*   log_hdr_ptr - application log header
+*   first_idx - index of the first entry
+*   end_idx - index following the last entry
+*
+*  @return
+*   Success - PMC_SUCCESS
+*   Failure - failure specific code
+*
+*/
+PRIVATE PMCFW_ERROR log_journal_entries_append(log_journal_struct* journal_ptr,
+                                               log_cfg_struct* log_hdr_ptr,
+                                               UINT32 first_idx,
+                                               UINT32 end_idx)
+{
+    if (end_idx <= first_idx)
+    {
+        /* nothing to append */
+        return (PMC_SUCCESS);
+    }
+
+    return (log_journal_append(journal_ptr,
+                               (UINT8*)&log_hdr_ptr->app_log_array[first_idx],
+                               (end_idx - first_idx) * sizeof(log_app_entry_struct)));
+
+} /* log_journal_entries_append */
+
 /**
 * @brief
 *   read RAM firmware log from newest entries
@@ -258,14 +382,19 @@ PRIVATE VOID log_ram_read()
 
 /**
 * @brief
-*   read saved crash dump log data
+*   read saved crash dump log data or the saved log journal
+*
+* @param[in] journal - TRUE to read the log journal, FALSE to read the
+*                      crash dump
 *
 *  @return
 *   Nothing
 *
 * @note
+*   The journal is read as a stream of log_app_entry_struct entries,
+*   oldest first.
 */
-PRIVATE VOID log_saved_read()
+PRIVATE VOID log_saved_read(BOOL journal)
 {
     exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
     exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
@@ -273,6 +402,10 @@ PRIVATE VOID log_saved_read()
     exp_fw_log_rsp_parms_struct* rsp_parms_ptr = (exp_fw_log_rsp_parms_struct*)&rsp_ptr->parms;
     UINT8* src_data_ptr;
     UINT8* ext_data_ptr = ech_ext_data_ptr_get();
+    log_journal_struct* journal_ptr = log_journal_get(cmd_parms_ptr->image);
+    UINT32 log_size;
+    UINT32 num_bytes;
+    PMCFW_ERROR rc;
 
     /* determine the active image to get the crash dump SPI start address */
     if (cmd_parms_ptr->image == EXP_FW_IMAGE_A)
@@ -290,8 +423,21 @@ PRIVATE VOID log_saved_read()
         src_data_ptr = (UINT8*)SPI_FLASH_FW_IMG_B_CFG_LOG_CRASH_DUMP_ADDR;
     }
 
+    if (TRUE == journal)
+    {
+        log_size = log_journal_size_get(journal_ptr);
+    }
+    else if (CRASH_DUMP_HEADER_KEY == *(UINT32*)src_data_ptr)
+    {
+        log_size = SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_SIZE;
+    }
+    else
+    {
+        log_size = 0;
+    }
+
     /* determine if there's any data in the log */          
-    if (CRASH_DUMP_HEADER_KEY != *(UINT32*)src_data_ptr)
+    if (0 == log_size)
     {
         /* log is empty */
 
@@ -306,7 +452,7 @@ PRIVATE VOID log_saved_read()
         /* set the extended data flag */
         rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
     }
-    else if (cmd_parms_ptr->offset > SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_SIZE)
+    else if (cmd_parms_ptr->offset > log_size)
     {
         /* offset beyond end of logfile, invalid address request */
 
@@ -338,26 +484,62 @@ PRIVATE VOID log_saved_read()
     }
     else
     {
+        num_bytes = cmd_parms_ptr->num_bytes;
+        rc = PMC_SUCCESS;
+
         /* clear the extended data buffer */
         memset(ext_data_ptr,
                0x00,
-               cmd_parms_ptr->num_bytes);
+               num_bytes);
 
-        /* copy SPI crash dump logfile data from flash to extended data buffer */
-        crash_dump_plat_full_read(ext_data_ptr, 
-                                  (UINT32)(src_data_ptr + cmd_parms_ptr->offset),
-                                  cmd_parms_ptr->num_bytes);
+        if (FALSE == journal)
+        {
+            /* copy SPI crash dump logfile data from flash to extended data buffer */
+            crash_dump_plat_full_read(ext_data_ptr, 
+                                      (UINT32)(src_data_ptr + cmd_parms_ptr->offset),
+                                      num_bytes);
+        }
+        else
+        {
+            /* the journal can only return the data it holds */
+            if (num_bytes > (log_size - cmd_parms_ptr->offset))
+            {
+                num_bytes = log_size - cmd_parms_ptr->offset;
+            }
+
+            /* copy journal data from flash to extended data buffer */
+            rc = log_journal_read(journal_ptr,
+                                  ext_data_ptr,
+                                  cmd_parms_ptr->offset,
+                                  num_bytes);
+        }
 
-        /* set response parameters */
-        rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
-        rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
-        rsp_parms_ptr->num_bytes_returned = cmd_parms_ptr->num_bytes;
+        if (PMC_SUCCESS != rc)
+        {
+            /* set failure status */
+            rsp_parms_ptr->status = EXP_FW_API_FAILURE;
+            rsp_parms_ptr->err_code = rc;
+            rsp_parms_ptr->num_bytes_returned = 0;
 
-        /* set the extended data response length */
-        rsp_ptr->ext_data_len = cmd_parms_ptr->num_bytes;
+            /* set the extended data response length */
+            rsp_ptr->ext_data_len = 0;
 
-        /* set the extended data flag */
-        rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+            /* set the extended data flag */
+            rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
+        }
+        else
+        {
+            /* set response parameters */
+            rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
+            rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
+            rsp_parms_ptr->num_bytes_returned = num_bytes;
+
+            /* set the extended data response length */
+            rsp_ptr->ext_data_len = num_bytes;
+
+            /* set the extended data flag */
+            rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+        }
     }
 
     /* set the response operand, same as command operand */
@@ -426,7 +608,7 @@ PRIVATE VOID log_ram_erase(VOID)
 
 /**
 * @brief
-*   Erase the crash dump log file saved in flash.
+*   Erase the crash dump log file and the log journal saved in flash.
 *
 * @return
 *   Nothing
@@ -468,6 +650,11 @@ PRIVATE VOID log_saved_erase(VOID)
     */
     rc = crash_dump_plat_partition_zero_fill(cd_spi_addr);
 
+    if (PMC_SUCCESS == rc)
+    {
+        rc = log_journal_erase(log_journal_get(cmd_parms_ptr->image));
+    }
+
     if (PMC_SUCCESS != rc)
     {
         bc_printf("failed\n");
@@ -500,6 +687,193 @@ PRIVATE VOID log_saved_erase(VOID)
 
 }
 
+/**
+* @brief
+*   Read the per-command trace into the extended data buffer.
+*
+* @return
+*   Nothing
+*
+* @note
+*   See ech_trace.h for the layout. The trace is small enough to be returned
+*   in one response.
+*/
+PRIVATE VOID log_cmd_trace_read(VOID)
+{
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_log_cmd_parms_struct* cmd_parms_ptr = (exp_fw_log_cmd_parms_struct*)&cmd_ptr->parms;
+    exp_fw_log_rsp_parms_struct* rsp_parms_ptr = (exp_fw_log_rsp_parms_struct*)&rsp_ptr->parms;
+    ech_trace_cursor_struct cursor;
+    UINT32 size;
+
+    size = ech_trace_read_start(&cursor);
+    if (size > ech_ext_data_size_get())
+    {
+        size = ech_ext_data_size_get();
+    }
+    size = ech_trace_read(&cursor, 0, ech_ext_data_ptr_get(), size);
+
+    /* set response parameters */
+    rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
+    rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
+    rsp_parms_ptr->num_bytes_returned = size;
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = size;
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* set the response operand, same as command operand */
+    rsp_parms_ptr->op = cmd_parms_ptr->op;
+
+    /* send the response */
+    ech_oc_rsp_proc();
+
+} /* log_cmd_trace_read */
+
+/**
+* @brief
+*   Read the per-command statistics into the extended data buffer.
+*
+* @param[in] clear - clear the statistics once read
+*
+* @return
+*   Nothing
+*
+* @note
+*   See ech_stats.h for the layout.
+*/
+PRIVATE VOID log_cmd_stats_read(BOOL clear)
+{
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_log_cmd_parms_struct* cmd_parms_ptr = (exp_fw_log_cmd_parms_struct*)&cmd_ptr->parms;
+    exp_fw_log_rsp_parms_struct* rsp_parms_ptr = (exp_fw_log_rsp_parms_struct*)&rsp_ptr->parms;
+    ech_stats_cursor_struct cursor;
+    UINT32 size;
+
+    size = ech_stats_read_start(&cursor);
+    if (size > ech_ext_data_size_get())
+    {
+        size = ech_ext_data_size_get();
+    }
+    size = ech_stats_read(&cursor, 0, ech_ext_data_ptr_get(), size);
+
+    if (TRUE == clear)
+    {
+        ech_stats_clear();
+    }
+
+    /* set response parameters */
+    rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
+    rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
+    rsp_parms_ptr->num_bytes_returned = size;
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = size;
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* set the response operand, same as command operand */
+    rsp_parms_ptr->op = cmd_parms_ptr->op;
+
+    /* send the response */
+    ech_oc_rsp_proc();
+
+} /* log_cmd_stats_read */
+
+/**
+* @brief
+*   Read the log channels merged in time order into the extended data
+*   buffer.
+*
+* @return
+*   Nothing
+*
+* @note
+*   See log_chan.h. The channels are copied to the end of the extended
+*   data buffer and merged at its start.
+*/
+PRIVATE VOID log_chan_log_read(VOID)
+{
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_log_cmd_parms_struct* cmd_parms_ptr = (exp_fw_log_cmd_parms_struct*)&cmd_ptr->parms;
+    exp_fw_log_rsp_parms_struct* rsp_parms_ptr = (exp_fw_log_rsp_parms_struct*)&rsp_ptr->parms;
+    CHAR* ext_data_ptr = (CHAR*)ech_ext_data_ptr_get();
+    UINT32 ext_data_size = ech_ext_data_size_get();
+    UINT32 size;
+
+    PMCFW_ASSERT(ext_data_size > LOG_CHAN_TOTAL_SIZE, PMCFW_ERR_FAIL);
+
+    size = log_chan_read(ext_data_ptr,
+                         ext_data_size - LOG_CHAN_TOTAL_SIZE,
+                         &ext_data_ptr[ext_data_size - LOG_CHAN_TOTAL_SIZE],
+                         LOG_CHAN_TOTAL_SIZE);
+
+    /* set response parameters */
+    rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
+    rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
+    rsp_parms_ptr->num_bytes_returned = size;
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = size;
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* set the response operand, same as command operand */
+    rsp_parms_ptr->op = cmd_parms_ptr->op;
+
+    /* send the response */
+    ech_oc_rsp_proc();
+
+} /* log_chan_log_read */
+
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+/**
+* @brief
+*   Read the PC-sampling profile into the extended data buffer.
+*
+* @return
+*   Nothing
+*
+* @note
+*   See app_fw_pc_prof.h for the layout. Sampling is not stopped.
+*/
+PRIVATE VOID log_pc_profile_read(VOID)
+{
+    exp_cmd_struct* cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
+    exp_fw_log_cmd_parms_struct* cmd_parms_ptr = (exp_fw_log_cmd_parms_struct*)&cmd_ptr->parms;
+    exp_fw_log_rsp_parms_struct* rsp_parms_ptr = (exp_fw_log_rsp_parms_struct*)&rsp_ptr->parms;
+    UINT32 size;
+
+    size = app_fw_pc_prof_read(ech_ext_data_ptr_get(), ech_ext_data_size_get());
+
+    /* set response parameters */
+    rsp_parms_ptr->status = EXP_FW_API_SUCCESS;
+    rsp_parms_ptr->err_code = LOG_OP_SUCCESS;
+    rsp_parms_ptr->num_bytes_returned = size;
+
+    /* set the extended data response length */
+    rsp_ptr->ext_data_len = size;
+
+    /* set the extended data flag */
+    rsp_ptr->flags = EXP_FW_EXTENDED_DATA;
+
+    /* set the response operand, same as command operand */
+    rsp_parms_ptr->op = cmd_parms_ptr->op;
+
+    /* send the response */
+    ech_oc_rsp_proc();
+
+} /* log_pc_profile_read */
+#endif
+
 /**
 * @brief
 *   Firmware log command handler function.
@@ -536,7 +910,7 @@ PRIVATE VOID log_cmd_process(VOID)
         case EXP_FW_LOG_OP_READ_SAVED_LOG:
         {
             /* request to read saved crash dump logfile */
-            log_saved_read();
+            log_saved_read(FALSE);
         }
         break;
 
@@ -547,6 +921,50 @@ PRIVATE VOID log_cmd_process(VOID)
         }
         break;
 
+        case EXP_FW_LOG_OP_READ_CMD_TRACE:
+        {
+            /* request to read the per-command trace */
+            log_cmd_trace_read();
+        }
+        break;
+
+        case EXP_FW_LOG_OP_READ_CMD_STATS:
+        {
+            /* request to read the per-command statistics */
+            log_cmd_stats_read(FALSE);
+        }
+        break;
+
+        case EXP_FW_LOG_OP_READ_CLR_CMD_STATS:
+        {
+            /* request to read and clear the per-command statistics */
+            log_cmd_stats_read(TRUE);
+        }
+        break;
+
+        case EXP_FW_LOG_OP_READ_CHANNEL_LOG:
+        {
+            /* request to read the merged log channels */
+            log_chan_log_read();
+        }
+        break;
+
+        case EXP_FW_LOG_OP_READ_SAVED_JOURNAL:
+        {
+            /* request to read the saved log journal */
+            log_saved_read(TRUE);
+        }
+        break;
+
+#if (EXPLORER_PC_PROFILER_ENABLE == 1)
+        case EXP_FW_LOG_OP_READ_PC_PROFILE:
+        {
+            /* request to read the PC-sampling profile */
+            log_pc_profile_read();
+        }
+        break;
+#endif
+
         default:
         {
             exp_rsp_struct* rsp_ptr = ech_rsp_ptr_get();
@@ -607,6 +1025,16 @@ PUBLIC void log_mem_clear(UINT32 log_mem_size,
 */
 PUBLIC VOID log_plat_init(VOID)
 {
+    /* saved log journals are mounted on first use */
+    log_journal_init(&log_journal_img_a,
+                     SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_ADDR,
+                     SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_SIZE,
+                     log_journal_plat_erase);
+    log_journal_init(&log_journal_img_b,
+                     SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_ADDR,
+                     SPI_FLASH_FW_IMG_B_CFG_LOG_JOURNAL_SIZE,
+                     log_journal_plat_erase);
+
     /* register log command handler */
     ech_api_func_register(EXP_FW_LOG, log_cmd_process);
 
@@ -623,16 +1051,20 @@ PUBLIC VOID log_plat_init(VOID)
 *   Success - PMC_SUCCESS
 *   Failure - failure specific code
 *
+* @note
+*   The application log entries added since the previous call are appended
+*   to the saved log journal of the active image. The whole log is appended
+*   on the first call, or when entries were overwritten in between. The new
+*   log channel records follow, see log_spi_flash_chan_store().
 */
 PUBLIC PMCFW_ERROR log_spi_flash_store(VOID)
 {
     PMCFW_ERROR rc;
     UINT8* log_mem_ptr;
-    UINT32 log_size;
     log_cfg_struct* log_hdr_ptr;
-    spi_flash_dev_enum dev;
-    spi_flash_dev_info_struct dev_info;
-    UINT8* spi_log_ptr;
+    log_journal_struct* journal_ptr;
+    UINT32 wr_idx;
+    UINT16 wr_idx_wrap;
     top_plat_lock_struct lock_struct;
 
     /* get reference to the firmware log */
@@ -645,68 +1077,195 @@ PUBLIC PMCFW_ERROR log_spi_flash_store(VOID)
     }
 
     log_hdr_ptr = (log_cfg_struct*)log_mem_ptr;
-    log_size = sizeof(log_cfg_struct) + (log_hdr_ptr->wr_idx * sizeof(log_app_entry_struct));
 
-    /* determine the active image to erase the correct stored log */
-    if ((UINT32*)SPI_FLASH_FW_ACT_IMG_FLAG_ADDR == SPI_FLASH_ACTIVE_IMG_A)
+    /* sample the write position consistently */
+    top_plat_critical_region_enter(&lock_struct);
+    wr_idx = log_hdr_ptr->wr_idx;
+    wr_idx_wrap = log_hdr_ptr->wr_idx_wrap;
+    top_plat_critical_region_exit(lock_struct);
+
+    /* append to the journal of the active image */
+    journal_ptr = log_journal_active_get();
+
+    if ((TRUE == log_stored_valid) &&
+        (wr_idx_wrap == log_stored_wr_idx_wrap) &&
+        (wr_idx >= log_stored_wr_idx))
     {
-        /* firmware image A is the active image */
+        /* only new entries */
+        rc = log_journal_entries_append(journal_ptr, log_hdr_ptr, log_stored_wr_idx, wr_idx);
+    }
+    else if ((TRUE == log_stored_valid) &&
+             (wr_idx_wrap == (UINT16)(log_stored_wr_idx_wrap + 1)) &&
+             (wr_idx <= log_stored_wr_idx))
+    {
+        /* new entries wrapped around the end of the log */
+        rc = log_journal_entries_append(journal_ptr, log_hdr_ptr, log_stored_wr_idx, log_hdr_ptr->size_in_entries);
 
-        /* get reference to image A SPI flash log*/
-        spi_log_ptr = (UINT8*)SPI_FLASH_FW_IMG_A_CFG_LOG_ADDR;
+        if (PMC_SUCCESS == rc)
+        {
+            rc = log_journal_entries_append(journal_ptr, log_hdr_ptr, 0, wr_idx);
+        }
     }
     else
     {
-        /* firmware image B is the active image */
+        /* whole log, oldest entry first */
+        rc = PMC_SUCCESS;
+
+        if (0 != wr_idx_wrap)
+        {
+            rc = log_journal_entries_append(journal_ptr, log_hdr_ptr, wr_idx, log_hdr_ptr->size_in_entries);
+        }
 
-        /* get reference to image B SPI flash log*/
-        spi_log_ptr = (UINT8*)SPI_FLASH_FW_IMG_B_CFG_LOG_ADDR;
+        if (PMC_SUCCESS == rc)
+        {
+            rc = log_journal_entries_append(journal_ptr, log_hdr_ptr, 0, wr_idx);
+        }
     }
 
-    /* erase the log partition in SPI flash */
-    rc = log_spi_flash_partition_erase(spi_log_ptr, log_size);
+    /* a failed append is retried in full by the next call */
+    log_stored_valid = (PMC_SUCCESS == rc);
+    log_stored_wr_idx = wr_idx;
+    log_stored_wr_idx_wrap = wr_idx_wrap;
 
-    if (rc != PMC_SUCCESS)
+    if (PMC_SUCCESS == rc)
     {
-        /* log partition erase failed */
-        return (rc);
+        rc = log_spi_flash_chan_store();
     }
-    /* get SPI flash device info */
-    rc = spi_flash_dev_info_get(SPI_FLASH_PORT,
-                                SPI_FLASH_CS,
-                                &dev,
-                                &dev_info);
 
-    if (rc != PMC_SUCCESS)
+    return (rc);
+
+} /* log_spi_flash_store */
+
+/**
+* @brief
+*   append log entries built outside the application log to the saved log
+*   of the active image.
+*
+* @param
+*   entry_ptr - entries
+*   num_entries - number of entries
+*
+* @return
+*   Success - PMC_SUCCESS
+*   Failure - failure specific code
+*
+* @note
+*   The entries are read back with the saved log, in the order appended.
+*/
+PUBLIC PMCFW_ERROR log_spi_flash_entries_append(log_app_entry_struct* entry_ptr,
+                                                UINT32 num_entries)
+{
+    if (0 == num_entries)
     {
-        /* error acquiring SPi flash device info */
-        return (rc);
+        /* nothing to append */
+        return (PMC_SUCCESS);
     }
 
-    /* disable interrupts and disable multi-VPE operation */
-    top_plat_critical_region_enter(&lock_struct);
+    return (log_journal_append(log_journal_active_get(),
+                               (UINT8*)entry_ptr,
+                               num_entries * sizeof(log_app_entry_struct)));
 
-    /* write the log one page at a time */
-    rc = spi_flash_write_pages(SPI_FLASH_PORT,
-                               SPI_FLASH_CS,
-                               log_mem_ptr,
-                               spi_log_ptr,
-                               log_size,
-                               dev_info.page_size,
-                               dev_info.max_time_page_prog);
+} /* log_spi_flash_entries_append */
 
-    /* restore interrupts and enable multi-VPE operation */
-    top_plat_critical_region_exit(lock_struct);
+/**
+* @brief
+*   store the new records of the log channels to SPI flash.
+*
+* @param
+*   none
+*
+* @return
+*   Success - PMC_SUCCESS
+*   Failure - failure specific code
+*
+* @note
+*   The records printed since the previous call are appended to the saved
+*   log of the active image in one append, see log_chan.h for the entries.
+*   Channels are taken in priority order, fatal and boot first, and the
+*   append is bounded by EXPLORER_LOG_CHAN_SAVE_SIZE, so a noisy channel
+*   can only use the room left by the channels before it. Records that do
+*   not fit are stored by the next call, unless overwritten in between.
+*/
+PUBLIC PMCFW_ERROR log_spi_flash_chan_store(VOID)
+{
+    log_chan_rec_struct rec;
+    UINT32 stored_seq[LOG_CHAN_NUM];
+    BOOL stored_valid[LOG_CHAN_NUM];
+    UINT32 num_entries = 0;
+    UINT32 chan;
+    UINT32 len;
+    UINT32 offset;
+    UINT32 rec_entries;
+    UINT32 chunk;
+    UINT32 i;
+    BOOL full = FALSE;
+    PMCFW_ERROR rc;
 
-    if (PMC_SUCCESS != rc)
+    for (chan = 0; chan < LOG_CHAN_NUM; chan++)
     {
-        return (rc);
+        stored_seq[chan] = log_chan_stored_seq[chan];
+        stored_valid[chan] = log_chan_stored_valid[chan];
+
+        if (TRUE == full)
+        {
+            continue;
+        }
+
+        len = log_chan_get((UINT8)chan, log_chan_save_buf, sizeof(log_chan_save_buf));
+        offset = 0;
+
+        while (TRUE == log_chan_rec_next(log_chan_save_buf, len, &offset, &rec))
+        {
+            if ((TRUE == stored_valid[chan]) &&
+                ((INT32)(rec.seq - stored_seq[chan]) <= 0))
+            {
+                /* stored by a previous call */
+                continue;
+            }
+
+            rec_entries = (rec.text_len + LOG_CHAN_ENTRY_TEXT_SIZE - 1) / LOG_CHAN_ENTRY_TEXT_SIZE;
+            if ((num_entries + rec_entries) > LOG_CHAN_SAVE_ENTRIES)
+            {
+                full = TRUE;
+                break;
+            }
+
+            for (i = 0; i < rec_entries; i++)
+            {
+                log_app_entry_struct* entry_ptr = &log_chan_save_entry[num_entries++];
+
+                chunk = rec.text_len - (i * LOG_CHAN_ENTRY_TEXT_SIZE);
+                if (chunk > LOG_CHAN_ENTRY_TEXT_SIZE)
+                {
+                    chunk = LOG_CHAN_ENTRY_TEXT_SIZE;
+                }
+
+                entry_ptr->ts_u = rec.seq;
+                entry_ptr->ts_l = i;
+                entry_ptr->log_code = (PMCFW_MID_LOG_APP << 16) | LOG_CHAN_LOG_CODE | chan;
+
+                /* the five log words hold the text in memory order */
+                memset(&entry_ptr->log_word0, 0, LOG_CHAN_ENTRY_TEXT_SIZE);
+                memcpy(&entry_ptr->log_word0, &rec.text_ptr[i * LOG_CHAN_ENTRY_TEXT_SIZE], chunk);
+            }
+
+            stored_seq[chan] = rec.seq;
+            stored_valid[chan] = TRUE;
+        }
     }
 
-    /* return success */
-    return (PMC_SUCCESS);
+    rc = log_spi_flash_entries_append(log_chan_save_entry, num_entries);
 
-} /* log_spi_flash_store */
+    /* records of a failed append are retried by the next call */
+    if (PMC_SUCCESS == rc)
+    {
+        memcpy(log_chan_stored_seq, stored_seq, sizeof(log_chan_stored_seq));
+        memcpy(log_chan_stored_valid, stored_valid, sizeof(log_chan_stored_valid));
+    }
+
+    return (rc);
+
+} /* log_spi_flash_chan_store */
 
 /**
 * @brief
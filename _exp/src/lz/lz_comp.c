@@ -0,0 +1,326 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LZ_COMP
+* @{
+* @file
+* @brief
+*   Block compressor implementation.
+*
+* @note
+*   Positions are counted over the dictionary followed by the block, so
+*   a match may start in the dictionary and run into the block.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "lz_comp.h"
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+/* Byte at a position of the dictionary followed by the block */
+#define LZ_COMP_BYTE(ctx_ptr, src_ptr, pos) \
+    (((pos) < (ctx_ptr)->dict_len) ? (ctx_ptr)->dict_ptr[(pos)] : (src_ptr)[(pos) - (ctx_ptr)->dict_len])
+
+/* Multiplicative hash of 4 bytes */
+#define LZ_COMP_HASH(ctx_ptr, val)  (((val) * 2654435761U) >> (32 - (ctx_ptr)->hash_log2))
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Private Functions
+*/
+
+/**
+* @brief
+*   Read the LZ_DECOMP_MIN_MATCH bytes at a position.
+*
+* @param[in] ctx_ptr - compressor context
+* @param[in] src_ptr - block
+* @param[in] pos     - position
+*
+* @return
+*   bytes packed into a word
+*/
+PRIVATE UINT32 lz_comp_word_get(lz_comp_struct *ctx_ptr, const UINT8 *src_ptr, UINT32 pos)
+{
+    return ((UINT32)LZ_COMP_BYTE(ctx_ptr, src_ptr, pos)) |
+           ((UINT32)LZ_COMP_BYTE(ctx_ptr, src_ptr, pos + 1) << 8) |
+           ((UINT32)LZ_COMP_BYTE(ctx_ptr, src_ptr, pos + 2) << 16) |
+           ((UINT32)LZ_COMP_BYTE(ctx_ptr, src_ptr, pos + 3) << 24);
+}
+
+/**
+* @brief
+*   Append the extension bytes of a length.
+*
+* @param[out]    dst_ptr  - output buffer
+* @param[in]     dst_size - size of the output buffer
+* @param[in,out] out_ptr  - number of bytes in the output buffer
+* @param[in]     len      - length left after the token nibble
+*
+* @return
+*   FALSE if the output buffer is full
+*/
+PRIVATE BOOL lz_comp_len_put(UINT8 *dst_ptr, UINT32 dst_size, UINT32 *out_ptr, UINT32 len)
+{
+    while (len >= 0xFF)
+    {
+        if (*out_ptr == dst_size)
+        {
+            return (FALSE);
+        }
+        dst_ptr[(*out_ptr)++] = 0xFF;
+        len -= 0xFF;
+    }
+
+    if (*out_ptr == dst_size)
+    {
+        return (FALSE);
+    }
+    dst_ptr[(*out_ptr)++] = (UINT8)len;
+
+    return (TRUE);
+}
+
+/**
+* @brief
+*   Append one sequence.
+*
+* @param[out]    dst_ptr   - output buffer
+* @param[in]     dst_size  - size of the output buffer
+* @param[in,out] out_ptr   - number of bytes in the output buffer
+* @param[in]     lit_ptr   - literals
+* @param[in]     lit_len   - number of literals
+* @param[in]     match_len - match length, 0 for the final sequence
+* @param[in]     offset    - match offset
+*
+* @return
+*   FALSE if the output buffer is full
+*/
+PRIVATE BOOL lz_comp_sequence_put(UINT8 *dst_ptr,
+                                  UINT32 dst_size,
+                                  UINT32 *out_ptr,
+                                  const UINT8 *lit_ptr,
+                                  UINT32 lit_len,
+                                  UINT32 match_len,
+                                  UINT32 offset)
+{
+    UINT32 lit_nib = (lit_len < LZ_DECOMP_LEN_EXT) ? lit_len : LZ_DECOMP_LEN_EXT;
+    UINT32 match_nib = 0;
+
+    if (0 != match_len)
+    {
+        match_len -= LZ_DECOMP_MIN_MATCH;
+        match_nib = (match_len < LZ_DECOMP_LEN_EXT) ? match_len : LZ_DECOMP_LEN_EXT;
+    }
+
+    if (*out_ptr == dst_size)
+    {
+        return (FALSE);
+    }
+    dst_ptr[(*out_ptr)++] = (UINT8)((lit_nib << 4) | match_nib);
+
+    if ((LZ_DECOMP_LEN_EXT == lit_nib) &&
+        (FALSE == lz_comp_len_put(dst_ptr, dst_size, out_ptr, lit_len - LZ_DECOMP_LEN_EXT)))
+    {
+        return (FALSE);
+    }
+
+    if ((dst_size - *out_ptr) < lit_len)
+    {
+        return (FALSE);
+    }
+    memcpy(&dst_ptr[*out_ptr], lit_ptr, lit_len);
+    *out_ptr += lit_len;
+
+    if (0 == offset)
+    {
+        /* final sequence, literals only */
+        return (TRUE);
+    }
+
+    if ((dst_size - *out_ptr) < 2)
+    {
+        return (FALSE);
+    }
+    dst_ptr[(*out_ptr)++] = (UINT8)(offset & 0xFF);
+    dst_ptr[(*out_ptr)++] = (UINT8)(offset >> 8);
+
+    if (LZ_DECOMP_LEN_EXT == match_nib)
+    {
+        return (lz_comp_len_put(dst_ptr, dst_size, out_ptr, match_len - LZ_DECOMP_LEN_EXT));
+    }
+
+    return (TRUE);
+}
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize a compressor context.
+*
+* @param[out] ctx_ptr     - compressor context
+* @param[in]  dict_ptr    - preset dictionary, NULL if none
+* @param[in]  dict_len    - dictionary length, at most window_size
+* @param[in]  hash_ptr    - hash table of 2^hash_log2 entries
+* @param[in]  hash_log2   - log2 of the number of hash table entries
+* @param[in]  window_size - decoder window size, largest match offset
+*
+* @return
+*   None
+*/
+PUBLIC VOID lz_comp_init(lz_comp_struct *ctx_ptr,
+                         const UINT8 *dict_ptr,
+                         UINT32 dict_len,
+                         UINT16 *hash_ptr,
+                         UINT32 hash_log2,
+                         UINT32 window_size)
+{
+    PMCFW_ASSERT((dict_len <= window_size) && (hash_log2 > 0) && (hash_log2 < 32), PMCFW_ERR_INVALID_PARAMETERS);
+
+    ctx_ptr->dict_ptr    = dict_ptr;
+    ctx_ptr->dict_len    = (NULL == dict_ptr) ? 0 : dict_len;
+    ctx_ptr->hash_ptr    = hash_ptr;
+    ctx_ptr->hash_log2   = hash_log2;
+    ctx_ptr->window_size = window_size;
+}
+
+/**
+* @brief
+*   Compress one block.
+*
+* @param[in]  ctx_ptr  - compressor context
+* @param[in]  src_ptr  - block to compress
+* @param[in]  src_len  - block length, dictionary plus block at most LZ_COMP_MAX_SPAN
+* @param[out] dst_ptr  - output buffer
+* @param[in]  dst_size - size of the output buffer
+*
+* @return
+*   Length of the sequence stream, 0 if it does not fit in dst_size. The
+*   caller is expected to store the block uncompressed in that case.
+*
+* @note
+*   The hash table is reset for every block so blocks decode
+*   independently of each other.
+*/
+PUBLIC UINT32 lz_comp_block(lz_comp_struct *ctx_ptr,
+                            const UINT8 *src_ptr,
+                            UINT32 src_len,
+                            UINT8 *dst_ptr,
+                            UINT32 dst_size)
+{
+    UINT32 end = ctx_ptr->dict_len + src_len;
+    UINT32 anchor = ctx_ptr->dict_len;
+    UINT32 pos;
+    UINT32 cand;
+    UINT32 word;
+    UINT32 hash;
+    UINT32 len;
+    UINT32 out = 0;
+
+    PMCFW_ASSERT(end <= LZ_COMP_MAX_SPAN, PMCFW_ERR_INVALID_PARAMETERS);
+
+    memset(ctx_ptr->hash_ptr, 0xFF, (1 << ctx_ptr->hash_log2) * sizeof(UINT16));
+
+    /* index the dictionary so the block can reference it */
+    for (pos = 0; (pos + LZ_DECOMP_MIN_MATCH) <= ctx_ptr->dict_len; pos++)
+    {
+        word = lz_comp_word_get(ctx_ptr, src_ptr, pos);
+        ctx_ptr->hash_ptr[LZ_COMP_HASH(ctx_ptr, word)] = (UINT16)pos;
+    }
+
+    pos = ctx_ptr->dict_len;
+    while ((pos + LZ_DECOMP_MIN_MATCH) <= end)
+    {
+        word = lz_comp_word_get(ctx_ptr, src_ptr, pos);
+        hash = LZ_COMP_HASH(ctx_ptr, word);
+        cand = ctx_ptr->hash_ptr[hash];
+        ctx_ptr->hash_ptr[hash] = (UINT16)pos;
+
+        if ((LZ_COMP_HASH_EMPTY == cand) ||
+            ((pos - cand) > ctx_ptr->window_size) ||
+            (word != lz_comp_word_get(ctx_ptr, src_ptr, cand)))
+        {
+            pos++;
+            continue;
+        }
+
+        len = LZ_DECOMP_MIN_MATCH;
+        while (((pos + len) < end) &&
+               (LZ_COMP_BYTE(ctx_ptr, src_ptr, cand + len) == LZ_COMP_BYTE(ctx_ptr, src_ptr, pos + len)))
+        {
+            len++;
+        }
+
+        if (FALSE == lz_comp_sequence_put(dst_ptr,
+                                          dst_size,
+                                          &out,
+                                          &src_ptr[anchor - ctx_ptr->dict_len],
+                                          pos - anchor,
+                                          len,
+                                          pos - cand))
+        {
+            return (0);
+        }
+
+        pos += len;
+        anchor = pos;
+    }
+
+    /* trailing literals, a block ending on a match needs no final sequence */
+    if ((anchor < end) &&
+        (FALSE == lz_comp_sequence_put(dst_ptr,
+                                       dst_size,
+                                       &out,
+                                       &src_ptr[anchor - ctx_ptr->dict_len],
+                                       end - anchor,
+                                       0,
+                                       0)))
+    {
+        return (0);
+    }
+
+    return (out);
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
+
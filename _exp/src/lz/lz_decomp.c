@@ -0,0 +1,508 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup LZ_DECOMP
+* @{
+* @file
+* @brief
+*   Streaming LZ decompressor implementation.
+*
+* @note
+*   The decoder never allocates memory. All state lives in the caller's
+*   lz_decomp_struct and history buffer, so it can be used from the
+*   flashloader and from boot paths alike.
+*/
+
+/*
+* Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "lz_decomp.h"
+
+/*
+* Local Enumerated Types
+*/
+
+/*
+* Local Macro Definitions
+*/
+
+/*
+* Local Constants
+*/
+
+/*
+* Local Structures and Unions
+*/
+
+/*
+* Private Functions
+*/
+
+/*
+* Public Functions
+*/
+
+/**
+* @brief
+*   Initialize a streaming decoder context.
+*
+* @param[out] ctx_ptr      - decoder context
+* @param[in]  window_ptr   - history buffer used for back references
+* @param[in]  window_size  - size of the history buffer, must be a power of 2
+* @param[in]  out_expected - number of bytes the stream decodes to
+*
+* @return
+*   None
+*
+* @note
+*   The packer must not emit offsets larger than window_size.
+*/
+PUBLIC VOID lz_decomp_init(lz_decomp_struct *ctx_ptr,
+                           UINT8 *window_ptr,
+                           UINT32 window_size,
+                           UINT32 out_expected)
+{
+    PMCFW_ASSERT((window_size != 0) && (0 == (window_size & (window_size - 1))), PMCFW_ERR_INVALID_PARAMETERS);
+
+    ctx_ptr->window_ptr    = window_ptr;
+    ctx_ptr->window_mask   = window_size - 1;
+    ctx_ptr->dict_len      = 0;
+    ctx_ptr->out_total     = 0;
+    ctx_ptr->out_expected  = out_expected;
+    ctx_ptr->literal_len   = 0;
+    ctx_ptr->match_len     = 0;
+    ctx_ptr->match_offset  = 0;
+    ctx_ptr->match_len_ext = FALSE;
+    ctx_ptr->state         = LZ_DECOMP_STATE_TOKEN;
+}
+
+/**
+* @brief
+*   Preload the history window with a dictionary the stream was
+*   compressed against. Must be called after lz_decomp_init() and before
+*   the first lz_decomp_run().
+*
+* @param[in,out] ctx_ptr  - decoder context
+* @param[in]     dict_ptr - dictionary
+* @param[in]     dict_len - dictionary length, at most the window size
+*
+* @return
+*   None
+*
+* @note
+*   Matches may then reach back into the dictionary as if it had been
+*   decoded just before the stream.
+*/
+PUBLIC VOID lz_decomp_dict_set(lz_decomp_struct *ctx_ptr,
+                               const UINT8 *dict_ptr,
+                               UINT32 dict_len)
+{
+    PMCFW_ASSERT(dict_len <= (ctx_ptr->window_mask + 1), PMCFW_ERR_INVALID_PARAMETERS);
+
+    memcpy(ctx_ptr->window_ptr, dict_ptr, dict_len);
+    ctx_ptr->dict_len = dict_len;
+}
+
+/**
+* @brief
+*   Decode as much of the input as fits into the output buffer.
+*
+* @param[in,out] ctx_ptr     - decoder context
+* @param[in,out] in_pptr     - pointer to the next input byte, advanced past consumed input
+* @param[in,out] in_len_ptr  - number of input bytes available, reduced by consumed input
+* @param[out]    out_ptr     - output buffer
+* @param[in]     out_size    - size of the output buffer
+* @param[out]    out_len_ptr - number of bytes written to out_ptr
+*
+* @return
+*   LZ_DECOMP_STATUS_NEED_INPUT when all input was consumed,
+*   LZ_DECOMP_STATUS_OUTPUT_FULL when out_ptr was filled,
+*   LZ_DECOMP_STATUS_DONE once out_expected bytes were produced,
+*   otherwise an error status for a corrupt stream.
+*
+* @note
+*   Input following the end of the stream is left unconsumed.
+*/
+PUBLIC lz_decomp_status_enum lz_decomp_run(lz_decomp_struct *ctx_ptr,
+                                           const UINT8 **in_pptr,
+                                           UINT32 *in_len_ptr,
+                                           UINT8 *out_ptr,
+                                           UINT32 out_size,
+                                           UINT32 *out_len_ptr)
+{
+    const UINT8 *in_ptr = *in_pptr;
+    UINT32 in_len = *in_len_ptr;
+    UINT32 out_len = 0;
+    UINT8 *window_ptr = ctx_ptr->window_ptr;
+    UINT32 window_mask = ctx_ptr->window_mask;
+    lz_decomp_status_enum status = LZ_DECOMP_STATUS_NEED_INPUT;
+    BOOL running = TRUE;
+    UINT32 byte;
+    UINT32 count;
+    UINT32 i;
+
+    while (TRUE == running)
+    {
+        switch (ctx_ptr->state)
+        {
+            case LZ_DECOMP_STATE_TOKEN:
+                if (ctx_ptr->out_total == ctx_ptr->out_expected)
+                {
+                    ctx_ptr->state = LZ_DECOMP_STATE_DONE;
+                    break;
+                }
+
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                byte = *in_ptr++;
+                in_len--;
+
+                ctx_ptr->literal_len   = byte >> 4;
+                ctx_ptr->match_len     = (byte & 0xF) + LZ_DECOMP_MIN_MATCH;
+                ctx_ptr->match_len_ext = ((byte & 0xF) == LZ_DECOMP_LEN_EXT);
+                ctx_ptr->state = (LZ_DECOMP_LEN_EXT == ctx_ptr->literal_len) ? LZ_DECOMP_STATE_LITERAL_LEN : LZ_DECOMP_STATE_LITERALS;
+                break;
+
+            case LZ_DECOMP_STATE_LITERAL_LEN:
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                byte = *in_ptr++;
+                in_len--;
+
+                ctx_ptr->literal_len += byte;
+                if (0xFF != byte)
+                {
+                    ctx_ptr->state = LZ_DECOMP_STATE_LITERALS;
+                }
+                break;
+
+            case LZ_DECOMP_STATE_LITERALS:
+                if (0 == ctx_ptr->literal_len)
+                {
+                    /* the final sequence of a stream carries literals only */
+                    ctx_ptr->state = (ctx_ptr->out_total == ctx_ptr->out_expected) ? LZ_DECOMP_STATE_DONE : LZ_DECOMP_STATE_OFFSET_LO;
+                    break;
+                }
+
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                if (out_len == out_size)
+                {
+                    status = LZ_DECOMP_STATUS_OUTPUT_FULL;
+                    running = FALSE;
+                    break;
+                }
+
+                count = ctx_ptr->literal_len;
+                if (count > in_len)
+                {
+                    count = in_len;
+                }
+                if (count > (out_size - out_len))
+                {
+                    count = out_size - out_len;
+                }
+
+                if ((ctx_ptr->out_total + count) > ctx_ptr->out_expected)
+                {
+                    status = LZ_DECOMP_STATUS_ERR_OVERRUN;
+                    running = FALSE;
+                    break;
+                }
+
+                for (i = 0; i < count; i++)
+                {
+                    byte = in_ptr[i];
+                    window_ptr[(ctx_ptr->dict_len + ctx_ptr->out_total + i) & window_mask] = (UINT8)byte;
+                    out_ptr[out_len + i] = (UINT8)byte;
+                }
+
+                in_ptr += count;
+                in_len -= count;
+                out_len += count;
+                ctx_ptr->out_total += count;
+                ctx_ptr->literal_len -= count;
+                break;
+
+            case LZ_DECOMP_STATE_OFFSET_LO:
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                ctx_ptr->match_offset = *in_ptr++;
+                in_len--;
+                ctx_ptr->state = LZ_DECOMP_STATE_OFFSET_HI;
+                break;
+
+            case LZ_DECOMP_STATE_OFFSET_HI:
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                ctx_ptr->match_offset |= (UINT32)(*in_ptr++) << 8;
+                in_len--;
+
+                /* the offset must point inside both the window and the data decoded so far */
+                if ((0 == ctx_ptr->match_offset) ||
+                    (ctx_ptr->match_offset > (window_mask + 1)) ||
+                    (ctx_ptr->match_offset > (ctx_ptr->dict_len + ctx_ptr->out_total)))
+                {
+                    status = LZ_DECOMP_STATUS_ERR_OFFSET;
+                    running = FALSE;
+                    break;
+                }
+
+                ctx_ptr->state = (TRUE == ctx_ptr->match_len_ext) ? LZ_DECOMP_STATE_MATCH_LEN : LZ_DECOMP_STATE_MATCH_COPY;
+                break;
+
+            case LZ_DECOMP_STATE_MATCH_LEN:
+                if (0 == in_len)
+                {
+                    status = LZ_DECOMP_STATUS_NEED_INPUT;
+                    running = FALSE;
+                    break;
+                }
+
+                byte = *in_ptr++;
+                in_len--;
+
+                ctx_ptr->match_len += byte;
+                if (0xFF != byte)
+                {
+                    ctx_ptr->state = LZ_DECOMP_STATE_MATCH_COPY;
+                }
+                break;
+
+            case LZ_DECOMP_STATE_MATCH_COPY:
+                if (0 == ctx_ptr->match_len)
+                {
+                    ctx_ptr->state = LZ_DECOMP_STATE_TOKEN;
+                    break;
+                }
+
+                if (out_len == out_size)
+                {
+                    status = LZ_DECOMP_STATUS_OUTPUT_FULL;
+                    running = FALSE;
+                    break;
+                }
+
+                count = ctx_ptr->match_len;
+                if (count > (out_size - out_len))
+                {
+                    count = out_size - out_len;
+                }
+
+                if ((ctx_ptr->out_total + count) > ctx_ptr->out_expected)
+                {
+                    status = LZ_DECOMP_STATUS_ERR_OVERRUN;
+                    running = FALSE;
+                    break;
+                }
+
+                /* byte by byte, a match may overlap the bytes it produces */
+                for (i = 0; i < count; i++)
+                {
+                    byte = window_ptr[(ctx_ptr->dict_len + ctx_ptr->out_total - ctx_ptr->match_offset) & window_mask];
+                    window_ptr[(ctx_ptr->dict_len + ctx_ptr->out_total) & window_mask] = (UINT8)byte;
+                    out_ptr[out_len++] = (UINT8)byte;
+                    ctx_ptr->out_total++;
+                }
+
+                ctx_ptr->match_len -= count;
+                break;
+
+            case LZ_DECOMP_STATE_DONE:
+            default:
+                status = LZ_DECOMP_STATUS_DONE;
+                running = FALSE;
+                break;
+        }
+    }
+
+    *in_pptr = in_ptr;
+    *in_len_ptr = in_len;
+    *out_len_ptr = out_len;
+
+    return status;
+}
+
+/**
+* @brief
+*   Decode a complete stream into a buffer holding the whole output.
+*
+* @param[in]  in_ptr   - stream
+* @param[in]  in_len   - stream length
+* @param[in]  dict_ptr - dictionary the stream was compressed against, NULL if none
+* @param[in]  dict_len - dictionary length
+* @param[out] out_ptr  - output buffer
+* @param[in]  out_len  - number of bytes the stream decodes to
+*
+* @return
+*   LZ_DECOMP_STATUS_DONE once out_len bytes were produced,
+*   LZ_DECOMP_STATUS_NEED_INPUT if the stream is truncated,
+*   otherwise an error status for a corrupt stream.
+*
+* @note
+*   Matches are copied from the output itself, or from the dictionary for
+*   the part of a match that reaches back before the start of the output,
+*   so no history window is needed and the dictionary is not copied. Match
+*   offsets may be up to 65535 bytes.
+*/
+PUBLIC lz_decomp_status_enum lz_decomp_buf(const UINT8 *in_ptr,
+                                           UINT32 in_len,
+                                           const UINT8 *dict_ptr,
+                                           UINT32 dict_len,
+                                           UINT8 *out_ptr,
+                                           UINT32 out_len)
+{
+    const UINT8 *in_end_ptr = in_ptr + in_len;
+    UINT32 out_pos = 0;
+    UINT32 literal_len;
+    UINT32 match_len;
+    UINT32 offset;
+    UINT32 count;
+    UINT32 byte;
+    UINT32 i;
+
+    while (out_pos < out_len)
+    {
+        if (in_ptr == in_end_ptr)
+        {
+            return LZ_DECOMP_STATUS_NEED_INPUT;
+        }
+
+        byte = *in_ptr++;
+        literal_len = byte >> 4;
+        match_len = (byte & 0xF) + LZ_DECOMP_MIN_MATCH;
+
+        if (LZ_DECOMP_LEN_EXT == literal_len)
+        {
+            do
+            {
+                if (in_ptr == in_end_ptr)
+                {
+                    return LZ_DECOMP_STATUS_NEED_INPUT;
+                }
+                byte = *in_ptr++;
+                literal_len += byte;
+            } while (0xFF == byte);
+        }
+
+        if (literal_len > (UINT32)(in_end_ptr - in_ptr))
+        {
+            return LZ_DECOMP_STATUS_NEED_INPUT;
+        }
+        if (literal_len > (out_len - out_pos))
+        {
+            return LZ_DECOMP_STATUS_ERR_OVERRUN;
+        }
+
+        memcpy(&out_ptr[out_pos], in_ptr, literal_len);
+        in_ptr += literal_len;
+        out_pos += literal_len;
+
+        /* the final sequence of a stream carries literals only */
+        if (out_pos == out_len)
+        {
+            break;
+        }
+
+        if (2 > (UINT32)(in_end_ptr - in_ptr))
+        {
+            return LZ_DECOMP_STATUS_NEED_INPUT;
+        }
+        offset = in_ptr[0] | ((UINT32)in_ptr[1] << 8);
+        in_ptr += 2;
+
+        if (LZ_DECOMP_MIN_MATCH + LZ_DECOMP_LEN_EXT == match_len)
+        {
+            do
+            {
+                if (in_ptr == in_end_ptr)
+                {
+                    return LZ_DECOMP_STATUS_NEED_INPUT;
+                }
+                byte = *in_ptr++;
+                match_len += byte;
+            } while (0xFF == byte);
+        }
+
+        if ((0 == offset) || (offset > (dict_len + out_pos)))
+        {
+            return LZ_DECOMP_STATUS_ERR_OFFSET;
+        }
+        if (match_len > (out_len - out_pos))
+        {
+            return LZ_DECOMP_STATUS_ERR_OVERRUN;
+        }
+
+        /* part of the match before the start of the output comes from the dictionary */
+        if (offset > out_pos)
+        {
+            count = offset - out_pos;
+            if (count > match_len)
+            {
+                count = match_len;
+            }
+
+            memcpy(&out_ptr[out_pos], &dict_ptr[dict_len - (offset - out_pos)], count);
+            out_pos += count;
+            match_len -= count;
+        }
+
+        /* byte by byte, a match may overlap the bytes it produces */
+        for (i = 0; i < match_len; i++)
+        {
+            out_ptr[out_pos] = out_ptr[out_pos - offset];
+            out_pos++;
+        }
+    }
+
+    return LZ_DECOMP_STATUS_DONE;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
+
@@ -38,6 +38,7 @@
 #include "bc_printf.h"
 #include "uart.h"
 #include "char_io.h"
+#include "log_chan.h"
 
 /*
 ** Local Enumerated Types
@@ -216,8 +217,9 @@ PUBLIC UINT32 bc_printf(const CHAR *format, ...)
         return 0;
     }
 
-    /* Only print to UART in runtime */
-    if (printf_current_channel_id == CHAR_IO_CHANNEL_ID_RUNTIME)
+    /* Only print to UART in runtime, and not for a channel kept out of it */
+    if ((printf_current_channel_id == CHAR_IO_CHANNEL_ID_RUNTIME) &&
+        (TRUE == log_chan_uart_get()))
     {
         /* print to the UART */
         bc_hw_print(buffer, length);
@@ -226,6 +228,9 @@ PUBLIC UINT32 bc_printf(const CHAR *format, ...)
     /* print to current log buffer */
     char_io_put(printf_current_channel_id, buffer, length);
 
+    /* and to the log channel of the subsystem printing */
+    log_chan_put(buffer, length, (printf_current_channel_id == CHAR_IO_CHANNEL_ID_CRASH));
+
     return length;
 
 } /* End: bc_printf */
@@ -298,6 +303,9 @@ PUBLIC UINT32 bc_sprintf(const CHAR *format, ...)
     /* print to current log buffer */
     char_io_put(printf_current_channel_id, buffer, length);
 
+    /* and to the log channel of the subsystem printing */
+    log_chan_put(buffer, length, (printf_current_channel_id == CHAR_IO_CHANNEL_ID_CRASH));
+
     return length;
 } /* End: bc_sprintf */
 
@@ -56,8 +56,12 @@
 #include "ocmb_config_guide_mchp.h"
 #include "ocmb_config_guide.h"
 #include "bc_printf.h"
+#include "bc_log.h"
+#include "log_chan.h"
 #include "top_plat.h"
 #include "ocmb_erep.h"
+#include "opsw_timer.h"
+#include "app_fw_sched.h"
 
 /*
 ** Global Variables
@@ -108,6 +112,9 @@ PRIVATE BOOL serdes_cal_timer_init;
 /* Variable to hold the last time that the periodic cal was run */
 PRIVATE UINT_TIME sys_timer_last_cal;
 
+/* Results of the periodic cal */
+PRIVATE serdes_plat_cal_status_struct serdes_cal_status;
+
 /*
 ** Private Functions
 */
@@ -158,7 +165,7 @@ PRIVATE UINT32 serdes_plat_low_level_init_sequence_1(UINT32 lane, UINT32 frequen
     
         default:
         {
-            bc_printf("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED, invalid frequency\n", lane);
+            BC_LOG_ERR("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED, invalid frequency\n", lane);
             return EXP_SERDES_TRAINING_FREQ_UNSUPPORTED;
         }
     }
@@ -166,7 +173,7 @@ PRIVATE UINT32 serdes_plat_low_level_init_sequence_1(UINT32 lane, UINT32 frequen
     if (TRUE != rc)
     {
         /* CSU_1 initialization failed */
-        bc_printf("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED\n", lane);
+        BC_LOG_ERR("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED\n", lane);
         return EXP_SERDES_TRAINING_CSU_FAILED_1;
     }
 
@@ -193,7 +200,7 @@ PRIVATE UINT32 serdes_plat_low_level_init_sequence_1(UINT32 lane, UINT32 frequen
 
         default:
         {
-            bc_printf("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED, invalid frequency\n", lane);
+            BC_LOG_ERR("[%d] SERDES_FH_CSU_init_1_2XgXX FAILED, invalid frequency\n", lane);
             return EXP_SERDES_TRAINING_FREQ_UNSUPPORTED;
         }
     }
@@ -201,7 +208,7 @@ PRIVATE UINT32 serdes_plat_low_level_init_sequence_1(UINT32 lane, UINT32 frequen
     if (TRUE != rc)
     {
         /* CSU_2 initialization failed */
-        bc_printf("[%d] SERDES_FH_CSU_init_2_2XgXXX FAILED\n", lane);
+        BC_LOG_ERR("[%d] SERDES_FH_CSU_init_2_2XgXXX FAILED\n", lane);
         return EXP_SERDES_TRAINING_CSU_FAILED_2;
     }
     return (PMC_SUCCESS);
@@ -409,12 +416,12 @@ PRIVATE UINT32 serdes_plat_low_level_init_sequence_2(UINT32 lane, BOOL dfe_state
         
     if (TRUE != rc)
     {
-        bc_printf("[%d] EXP_SERDES_TRAINING_CALIB_FAILED\n", lane);
+        BC_LOG_ERR("[%d] EXP_SERDES_TRAINING_CALIB_FAILED\n", lane);
         return EXP_SERDES_TRAINING_CALIB_FAILED;
     }
     else
     {
-        bc_printf("[%d] EXP_SERDES_TRAINING_CALIB_PASSED\n", lane);
+        BC_LOG_DEBUG("[%d] EXP_SERDES_TRAINING_CALIB_PASSED\n", lane);
     }
 
     /* initialize PGA */        
@@ -621,12 +628,19 @@ PUBLIC VOID serdes_plat_periodic_cal_init(BOOL serdes_cal_prbs)
 *   Nothing
 *
 * @note
+*   The lanes are calibrated one at a time with a scheduler yield point
+*   in between, so a host command waits for one lane rather than for all
+*   of them.
 */
 PUBLIC VOID serdes_plat_cal_update(VOID)
 {
 
     UINT32 rc;
+    UINT32 lane_rc;
+    UINT32 lane;
     UINT8 lane_bitmask;
+    UINT8 cal_bitmask;
+    UINT8 prev_chan;
 
     UINT_TIME curr_time = sys_timer_read();
 
@@ -640,16 +654,60 @@ PUBLIC VOID serdes_plat_cal_update(VOID)
         sys_timer_last_cal = curr_time;
 
         lane_bitmask = ech_lane_active_pattern_bitmask_get();
-        
-        rc = SERDES_FH_IQ_Offset_Calibration(lane_bitmask);
+        cal_bitmask = 0;
+        rc = PMC_SUCCESS;
+
+        for (lane = 0; lane < SERDES_LANES; lane++)
+        {
+            if (0 == (lane_bitmask & (1 << lane)))
+            {
+                continue;
+            }
+
+            if (0 != cal_bitmask)
+            {
+                /* let host commands in between the lanes */
+                app_fw_sched_yield();
+
+                /* a host command may have stopped the calibration or the lane */
+                if (serdes_cal_timer_disable)
+                {
+                    break;
+                }
+                if (0 == (ech_lane_active_pattern_bitmask_get() & (1 << lane)))
+                {
+                    continue;
+                }
+            }
+
+            prev_chan = log_chan_enter(LOG_CHAN_SERDES);
+            lane_rc = SERDES_FH_IQ_Offset_Calibration((UINT8)(1 << lane));
+            log_chan_exit(prev_chan);
+
+            cal_bitmask |= (UINT8)(1 << lane);
+            if ((PMC_SUCCESS != lane_rc) && (PMC_SUCCESS == rc))
+            {
+                rc = lane_rc;
+            }
+        }
+
+        prev_chan = log_chan_enter(LOG_CHAN_SERDES);
+
+        serdes_cal_status.run_count++;
+        serdes_cal_status.last_rc = rc;
+        serdes_cal_status.last_lane_bitmask = cal_bitmask;
+        serdes_cal_status.last_seconds = opsw_timer0_read();
 
         if (rc != PMC_SUCCESS)
         {
+            serdes_cal_status.fail_count++;
             /* Use doorbell 3 to indicate a failure to the host */
-            bc_printf("SERDES_FH_IQ_Offset_Calibration failed: ERR!!! rc=0x%x\n",rc);
+            BC_LOG_RL(BC_LOG_LEVEL_ERR, 3, 600, "SERDES_FH_IQ_Offset_Calibration failed: ERR!!! rc=0x%x\n",rc);
             ocmb_erep_db_ring(ocmb_erep_db_3);
         }
 
+        log_chan_exit(prev_chan);
+
     }
 
 }
@@ -704,7 +762,7 @@ PUBLIC UINT32 serdes_plat_adapt_step1(BOOL dfe_state, BOOL adpt_state, UINT8 lan
 
             if( (FALSE == dfe_state)  && (FALSE == adpt_state) )
             {
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n",i);
                 rc = SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                             SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             }
@@ -713,13 +771,13 @@ PUBLIC UINT32 serdes_plat_adapt_step1(BOOL dfe_state, BOOL adpt_state, UINT8 lan
             {
                 if (force_start) 
                 {
-                    bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_Force_start_dfe_disable \n", i);
+                    BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_Force_start_dfe_disable \n", i);
                     rc = SERDES_FH_TXRX_Adaptation1_Force_start_dfe_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                    SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
                 }
                 else
                 {
-                    bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_dfe_disable \n", i);
+                    BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_dfe_disable \n", i);
                     rc = SERDES_FH_TXRX_Adaptation1_FW_start_dfe_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                          SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
                 }
@@ -729,7 +787,7 @@ PUBLIC UINT32 serdes_plat_adapt_step1(BOOL dfe_state, BOOL adpt_state, UINT8 lan
             else if( (TRUE == dfe_state)  && (FALSE == adpt_state) )
             {
 
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n",i);
                 rc = SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                             SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             }
@@ -737,25 +795,25 @@ PUBLIC UINT32 serdes_plat_adapt_step1(BOOL dfe_state, BOOL adpt_state, UINT8 lan
             {
                 if (force_start) 
                 {
-                    bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_Force_start_normal \n", i);
+                    BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_Force_start_normal \n", i);
                     rc = SERDES_FH_TXRX_Adaptation1_Force_start_normal(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                        SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
                 }
                 else
                 {
-                    bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_normal \n", i);
+                    BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_normal \n", i);
                     rc = SERDES_FH_TXRX_Adaptation1_FW_start_normal(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                                     SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
                 }
             }
             if (TRUE != rc)
             {
-                bc_printf("[%d] EXP_SERDES_TRAINING_ADAPT1_FAILED\n", i);
+                BC_LOG_ERR("[%d] EXP_SERDES_TRAINING_ADAPT1_FAILED\n", i);
                 return EXP_SERDES_TRAINING_ADAPT1_FAILED;
             }
             else
             {
-                bc_printf("[%d] EXP_SERDES_TRAINING_ADAPT_PASSED (step 1)\n", i);
+                BC_LOG_DEBUG("[%d] EXP_SERDES_TRAINING_ADAPT_PASSED (step 1)\n", i);
             }
         }
     }
@@ -799,11 +857,11 @@ PUBLIC UINT32 serdes_plat_adapt_step2(BOOL dfe_state , BOOL adpt_state, UINT8 la
 
             if (reg_val == 1)
             {
-                bc_printf("[ADAPT_DONE_V0] Success for lane %d.\n", i);
+                BC_LOG_DEBUG("[ADAPT_DONE_V0] Success for lane %d.\n", i);
             }
             else
             {
-                bc_printf("[ADAPT_DONE_V0] FAILURE for lane %d.\n", i);
+                BC_LOG_ERR("[ADAPT_DONE_V0] FAILURE for lane %d.\n", i);
             }
         }
     }
@@ -818,7 +876,7 @@ PUBLIC UINT32 serdes_plat_adapt_step2(BOOL dfe_state , BOOL adpt_state, UINT8 la
 
             if( (FALSE == dfe_state)  && (FALSE == adpt_state) )
             {
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation2_adaptation_disable \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation2_adaptation_disable \n",i);
                 rc = SERDES_FH_TXRX_Adaptation2_adaptation_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                             SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             }
@@ -826,7 +884,7 @@ PUBLIC UINT32 serdes_plat_adapt_step2(BOOL dfe_state , BOOL adpt_state, UINT8 la
             else if( (FALSE == dfe_state)  && (TRUE == adpt_state) )
             {
 
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation2_dfe_disable \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation2_dfe_disable \n",i);
                 rc = SERDES_FH_TXRX_Adaptation2_dfe_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                             SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             }
@@ -834,26 +892,26 @@ PUBLIC UINT32 serdes_plat_adapt_step2(BOOL dfe_state , BOOL adpt_state, UINT8 la
             else if( (TRUE == dfe_state)  && (FALSE == adpt_state) )
             {
 
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation2_adaptation_disable \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation2_adaptation_disable \n",i);
                 rc = SERDES_FH_TXRX_Adaptation2_adaptation_disable(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                                         SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
 
             }
             else
             {
-                bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation2_normal \n",i);
+                BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation2_normal \n",i);
                 rc =SERDES_FH_TXRX_Adaptation2_normal(SERDES_ADSP_PCBI_BASE_ADDR + lane_offset,
                                             SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             }
             
             if (TRUE != rc)
             {
-                bc_printf("[%d] EXP_SERDES_TRAINING_ADAPT2_FAILED (step 2)\n", i);
+                BC_LOG_ERR("[%d] EXP_SERDES_TRAINING_ADAPT2_FAILED (step 2)\n", i);
                 return EXP_SERDES_TRAINING_ADAPT2_FAILED;
             }
             else
             {
-                bc_printf("[%d] EXP_SERDES_TRAINING_ADAPT2_PASSED (step 2)\n", i);
+                BC_LOG_DEBUG("[%d] EXP_SERDES_TRAINING_ADAPT2_PASSED (step 2)\n", i);
             }
         }
     }
@@ -892,7 +950,7 @@ PUBLIC UINT32 serdes_plat_low_level_init(UINT8 lane_bitmask,
     {
         if (lane_bitmask & (1 << current_lane))
         {
-            bc_printf("[%d] TWI_BOOT_CONFIG: serdes_plat_low_level_init_sequence_1\n", current_lane);
+            BC_LOG_DEBUG("[%d] TWI_BOOT_CONFIG: serdes_plat_low_level_init_sequence_1\n", current_lane);
             /* apply the first initialization sequence on all lanes */
             rc = serdes_plat_low_level_init_sequence_1(current_lane, frequency);
 
@@ -908,11 +966,11 @@ PUBLIC UINT32 serdes_plat_low_level_init(UINT8 lane_bitmask,
     {
         if (lane_bitmask & (1 << current_lane))
         {
-            bc_printf("[%d] TWI_BOOT_CONFIG: serdes_plat_low_level_init_sequence_2\n", current_lane);
+            BC_LOG_DEBUG("[%d] TWI_BOOT_CONFIG: serdes_plat_low_level_init_sequence_2\n", current_lane);
             rc = serdes_plat_low_level_init_sequence_2(current_lane, dfe_state);
             if (PMC_SUCCESS != rc)
             {
-                bc_printf("[%d] serdes_plat_low_level_init_sequence_2 failed", current_lane);
+                BC_LOG_ERR("[%d] serdes_plat_low_level_init_sequence_2 failed", current_lane);
                 return (rc);
             }
         }
@@ -996,7 +1054,7 @@ PUBLIC UINT32 serdes_plat_lane_inversion_config(UINT8 lane_bitmask, UINT8 * lane
             rc = SERDES_FH_RX_alignment((SERDES_CHANNEL_PCBI_BASE_ADDR + lane_offset));
             if (TRUE != rc)
             {
-                bc_printf("[%d] SERDES_FH_RX_alignment Error!!!\n", i);
+                BC_LOG_ERR("[%d] SERDES_FH_RX_alignment Error!!!\n", i);
                 return EXP_TWI_BOOT_CFG_SERDES_FH_RX_ALIGNMENT_FAIL;
             }
         }
@@ -1097,12 +1155,12 @@ PUBLIC UINT32 serdes_plat_pattmon_config(UINT8 lane_bitmask, UINT32 ber_dwell_ms
                 if (meas_err_cnt_per_ms[current_lane] > ber_per_ms_threshold && pattmon_test > 0) 
                 {
                     /* The pattern monitor did not detect PRBS in non-inverted or inverted */
-                    bc_printf("    WARNING: Pattern monitor did not detect PRBS on lane %lu\n", current_lane);
+                    BC_LOG_WARN("    WARNING: Pattern monitor did not detect PRBS on lane %lu\n", current_lane);
                 }
                 else if (meas_err_cnt_per_ms[current_lane] > SERDES_BER_21G33_PER_MS_1e_4 && 0 == pattmon_test) 
                 {
                     /* Invert the pattern monitor and try again */
-                    bc_printf("    Inverting PRBS monitor on lane %lu\n", current_lane);
+                    BC_LOG_DEBUG("    Inverting PRBS monitor on lane %lu\n", current_lane);
 
                     lane_offset = current_lane * SERDES_LANE_REG_OFFSET;
                     serdes_api_lane_invert_set(lane_offset);
@@ -1156,7 +1214,7 @@ PUBLIC UINT32 serdes_plat_low_level_standalone_init(UINT8 lane_bitmask, BOOL dfe
                                  &patt[0]);
             if (TRUE !=rc)
             {
-                bc_printf("[%d] EXP_SERDES_FH_PATTERNGEN_ENABLE_FAIL \n", i);
+                BC_LOG_ERR("[%d] EXP_SERDES_FH_PATTERNGEN_ENABLE_FAIL \n", i);
                 return EXP_SERDES_FH_PATTERNGEN_ENABLE_FAIL;
             }
         }
@@ -1175,12 +1233,12 @@ PUBLIC UINT32 serdes_plat_low_level_standalone_init(UINT8 lane_bitmask, BOOL dfe
 
     if (TRUE != rc)
     {
-        bc_printf("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL \n", 4);
+        BC_LOG_ERR("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL \n", 4);
         return SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL;
     }
     else
     {
-        bc_printf("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_PASSED (step 1)\n", 4);
+        BC_LOG_DEBUG("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_PASSED (step 1)\n", 4);
     }
 
     for(i=0; i < SERDES_LANES; i++)
@@ -1189,10 +1247,10 @@ PUBLIC UINT32 serdes_plat_low_level_standalone_init(UINT8 lane_bitmask, BOOL dfe
         {
             if(i == SERDES_LANE_4)
             {
-                bc_printf("Skipping lane 4\n");
+                BC_LOG_DEBUG("Skipping lane 4\n");
                 continue;
             }
-            bc_printf("Lane ID= %d\n",i);
+            BC_LOG_DEBUG("Lane ID= %d\n",i);
 
             /* set the offset for the lane being configured */
             lane_offset = i * SERDES_LANE_REG_OFFSET;
@@ -1201,12 +1259,12 @@ PUBLIC UINT32 serdes_plat_low_level_standalone_init(UINT8 lane_bitmask, BOOL dfe
                                                                SERDES_MTSB_CTRL_PCBI_BASE_ADDR + lane_offset);
             if (TRUE != rc)
             {
-                bc_printf("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL (step 1)\n", i);
+                BC_LOG_ERR("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL (step 1)\n", i);
                 return SERDES_FH_TXRX_ADAPTATION_1_PE_FAIL;
             }
             else
             {
-                bc_printf("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_PASSED (step 1)\n", i);
+                BC_LOG_DEBUG("[%d] SERDES_FH_TXRX_ADAPTATION_1_PE_PASSED (step 1)\n", i);
             }
         }
     }
@@ -1250,7 +1308,7 @@ PUBLIC UINT8 serdes_plat_loopback_test(UINT8 lane_bitmask)
                                  &patt[0]);
             if (TRUE !=rc)
             {
-                bc_printf("[%d] EXP_SERDES_FH_PATTERNMON_ENABLE_FAIL \n", i);
+                BC_LOG_ERR("[%d] EXP_SERDES_FH_PATTERNMON_ENABLE_FAIL \n", i);
                 return EXP_SERDES_FH_PATTERNMON_ENABLE_FAIL;
             }
         }
@@ -1275,7 +1333,7 @@ PUBLIC UINT8 serdes_plat_loopback_test(UINT8 lane_bitmask)
             rc = SERDES_FH_pattmon(SERDES_CHANNEL_PCBI_BASE_ADDR + lane_offset);
             if (rc == FALSE)
             {
-                bc_printf("Serdes Loopback test failed for lane = %d\n", i);
+                BC_LOG_ERR("Serdes Loopback test failed for lane = %d\n", i);
                 return_code = EXP_TWI_BOOT_CFG_SERDES_LOOPBACK_LANE_ID_FAIL;
             }
             else
@@ -1336,6 +1394,26 @@ PUBLIC BOOL serdes_plat_initialized_get(VOID)
     return serdes_initialized;
 }
 
+/**
+* @brief
+*    Get the state and the results of the periodic serdes calibration,
+*    without accessing the SerDes.
+*
+* @param [out] status_ptr - calibration status
+*
+* @return
+*   Nothing
+*
+* @note
+*   Safe from either VPE, the counters may be one calibration apart.
+*/
+PUBLIC VOID serdes_plat_cal_status_get(serdes_plat_cal_status_struct *status_ptr)
+{
+    *status_ptr = serdes_cal_status;
+    status_ptr->enabled = (serdes_cal_timer_init && !serdes_cal_timer_disable);
+    status_ptr->initialized = serdes_initialized;
+}
+
 /**
 * @brief
 *    Get SERDES FFE pre-cursor value.
@@ -743,4 +743,48 @@ PUBLIC VOID spi_flash_plat_image_info_get(spi_flash_plat_auth_info_struct * spi_
     *spi_flash_plat_auth_info = auth_info_struct;
 }
 
+/**
+* @brief
+*   Read SPI flash through the memory map and report whether the data
+*   read had an uncorrectable ECC error. Erased and partially programmed
+*   locations do not hold a valid ECC, so this is used to probe flash
+*   that may not have been written yet.
+*        
+* @param [out] dst_ptr            - destination buffer
+* @param [in]  spi_flash_addr_ptr - SPI flash address to read from
+* @param [in]  num_bytes          - number of bytes to read
+*  
+* @return
+*   TRUE if the data was read without an uncorrectable ECC error
+* 
+* @note
+*   The uncorrectable ECC interrupt is masked for the duration of the
+*   read so probing unwritten flash does not cause FW to assert.
+*/
+PUBLIC BOOL spi_flash_plat_checked_read(UINT8* dst_ptr, UINT8* spi_flash_addr_ptr, UINT32 num_bytes)
+{
+    BOOL uecc_detected;
+    top_plat_lock_struct lock_struct;
+
+    /* disable interrupts and disable multi-VPE operation */
+    top_plat_critical_region_enter(&lock_struct);
+
+    spb_spi_uecc_int_en(SPI_FLASH_PORT, FALSE);
+
+    /* clear any stale error before the read */
+    (VOID)spb_spi_ecc_err_check(SPI_FLASH_PORT);
+
+    memcpy(dst_ptr, spi_flash_addr_ptr, num_bytes);
+
+    uecc_detected = spb_spi_ecc_err_check(SPI_FLASH_PORT);
+
+    spb_spi_uecc_int_en(SPI_FLASH_PORT, TRUE);
+
+    /* restore interrupts and enable multi-VPE operation */
+    top_plat_critical_region_exit(lock_struct);
+
+    return (FALSE == uecc_detected);
+
+} /* spi_flash_plat_checked_read */
+
 
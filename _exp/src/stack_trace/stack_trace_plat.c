@@ -31,11 +31,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "cpuhal.h"
+#include "app_fw.h"
+#include "stack_trace_plat.h"
 
 /*
 ** Constants
 */
 
+/* Physical address mask applied to PCs and table addresses */
+#define STACK_TRACE_PHY_MASK    0x1FFFFFFF
+
 /*
 ** Structures and Unions
 */
@@ -48,10 +53,54 @@
 ** Global variables
 */
 
+/* Reserved by app_fw.ld and filled in by sym_table_gen.py after linking */
+EXTERN UINT8 __ghsbegin_sym_table[];
+EXTERN UINT8 __ghsend_sym_table[];
+
 /*
 ** Private functions
 */
 
+/*******************************************************************************
+* FUNCTION: stack_trace_sym_table_get()
+* ______________________________________________________________________________
+*
+* DESCRIPTION:
+*   Locate the function symbol table of the running image.
+*
+* INPUTS:
+*   None.
+*
+* OUTPUTS:
+*   None.
+*
+* RETURNS:
+*   Table header, NULL if the image carries no valid table.
+*
+*******************************************************************************/
+PRIVATE const stack_trace_sym_table_hdr_struct* stack_trace_sym_table_get(VOID)
+{
+    UINT32 size = (UINT32)__ghsend_sym_table - (UINT32)__ghsbegin_sym_table;
+    const stack_trace_sym_table_hdr_struct* hdr_ptr;
+
+    /* the image is position independent, the table moves with it */
+    hdr_ptr = (const stack_trace_sym_table_hdr_struct*)((UINT32)__ghsbegin_sym_table + exp_plat_get_pic_offset());
+
+    if ((size < sizeof(stack_trace_sym_table_hdr_struct)) ||
+        (STACK_TRACE_SYM_TABLE_MAGIC != hdr_ptr->magic) ||
+        (hdr_ptr->pool_offset > size) ||
+        (hdr_ptr->pool_size > (size - hdr_ptr->pool_offset)) ||
+        (hdr_ptr->num_entries > ((hdr_ptr->pool_offset - sizeof(stack_trace_sym_table_hdr_struct)) /
+                                 sizeof(stack_trace_sym_entry_struct))) ||
+        (0 == hdr_ptr->pool_size) ||
+        ('\0' != ((const CHAR*)hdr_ptr)[hdr_ptr->pool_offset + hdr_ptr->pool_size - 1]))
+    {
+        return NULL;
+    }
+
+    return hdr_ptr;
+} /* stack_trace_sym_table_get() */
+
 /*
 ** Public functions
 */
@@ -70,12 +119,62 @@
 *   None.
 *
 * RETURNS:
-*   Empty string because this information is not stored in Explorer.
+*   Name of the function containing pc, empty string if pc is not in a
+*   known function or the image carries no symbol table.
+*
+* NOTES:
+*   Called from the fatal handler, so it neither allocates nor writes any
+*   state. The lookup is a binary search over the table in SPI flash.
 *
 *******************************************************************************/
-PUBLIC const CHAR* stack_trace_get_function_name(UINT32 pc)
+PUBLIC CHAR* stack_trace_get_function_name(UINT32 pc)
 {
-    return "";
+    const stack_trace_sym_table_hdr_struct* hdr_ptr = stack_trace_sym_table_get();
+    const stack_trace_sym_entry_struct* entry_ptr;
+    UINT32 addr;
+    UINT32 lo;
+    UINT32 hi;
+    UINT32 mid;
+
+    if (NULL == hdr_ptr)
+    {
+        return "";
+    }
+
+    /* code in SPI flash runs at its link address plus the PIC offset */
+    addr = (pc - exp_plat_get_pic_offset()) & STACK_TRACE_PHY_MASK;
+    if ((addr < hdr_ptr->rom_start) || (addr >= hdr_ptr->rom_end))
+    {
+        /* code copied to RAM runs at its link address */
+        addr = pc & STACK_TRACE_PHY_MASK;
+    }
+
+    entry_ptr = (const stack_trace_sym_entry_struct*)(hdr_ptr + 1);
+
+    /* find the last entry starting at or below addr */
+    lo = 0;
+    hi = hdr_ptr->num_entries;
+    while (lo < hi)
+    {
+        mid = lo + ((hi - lo) / 2);
+        if (entry_ptr[mid].addr <= addr)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if ((0 == lo) ||
+        (STACK_TRACE_SYM_NO_NAME == entry_ptr[lo - 1].name_offset) ||
+        (entry_ptr[lo - 1].name_offset >= hdr_ptr->pool_size))
+    {
+        return "";
+    }
+
+    return ((CHAR*)hdr_ptr + hdr_ptr->pool_offset + entry_ptr[lo - 1].name_offset);
 } /* stack_trace_get_function_name() */
 
 /*******************************************************************************
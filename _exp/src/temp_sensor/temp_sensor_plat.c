@@ -54,6 +54,7 @@
 #include "top_plat.h"
 #include "pvt.h"
 #include "pmc_profile.h"
+#include "app_fw_sched.h"
 
 
 /*
@@ -116,10 +117,55 @@ PRIVATE UINT16 temp_sensor_update_interval_ms;
 
 PRIVATE volatile UINT32 temperature_update_flags = 0;
 
+/* Last value written to the OCMB thermal registers, per sensor */
+PRIVATE volatile temp_sensor_plat_reading_struct temp_sensor_reading[TEMP_SENSOR_PLAT_NUM];
+
 /*
 ** Private Functions
 */
 
+/**
+* @brief
+*   Record the value written to the OCMB thermal registers of a sensor
+*
+* @param[in] sensor     - sensor
+* @param[in] temp       - temperature as written to the register
+* @param[in] temp_valid - temperature is valid
+* @param[in] present    - sensor is present
+* @param[in] error      - sensor read failed
+*
+* @return
+*   Nothing
+*
+* @note
+*   Called in the same critical region as the register update.
+*/
+PRIVATE VOID temp_sensor_plat_reading_set(temp_sensor_plat_sensor_enum sensor,
+                                          UINT16 temp,
+                                          BOOL temp_valid,
+                                          BOOL present,
+                                          BOOL error)
+{
+    UINT8 flags = 0;
+
+    if (temp_valid)
+    {
+        flags |= TEMP_SENSOR_PLAT_FLAG_VALID;
+    }
+    if (present)
+    {
+        flags |= TEMP_SENSOR_PLAT_FLAG_PRESENT;
+    }
+    if (error)
+    {
+        flags |= TEMP_SENSOR_PLAT_FLAG_ERROR;
+    }
+
+    temp_sensor_reading[sensor].temp = temp;
+    temp_sensor_reading[sensor].flags = flags;
+    temp_sensor_reading[sensor].seconds = opsw_timer0_read();
+}
+
 /**
 * @brief
 *   Interrupt handler for the on board temperature sensor update timer
@@ -133,6 +179,7 @@ PRIVATE VOID temp_sensor_plat_temp_update_int_handler(VOID *int_num)
 {
     /* Set flag to update temperature sensors */
     temperature_update_flags |= TEMP_SENSOR_UPDATE_FLAG;
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_TEMP_SENSOR);
 
     /* Clear the interrupt */
     cicint_int_clear(TEMP_SENSOR_UPDATE_TIMER_INT);
@@ -153,9 +200,9 @@ PRIVATE VOID temp_sensor_plat_timer_int_init(VOID)
     opsw_timer1_temp_polling_init();
 
     /* Register and enable the timer interrupts */
-    cicint_int_register(TEMP_SENSOR_UPDATE_TIMER_INT,
-                        (cicint_cback_fcn_ptr)temp_sensor_plat_temp_update_int_handler,
-                        (VOID*)TEMP_SENSOR_UPDATE_TIMER_INT);
+    exp_gic_int_register(TEMP_SENSOR_UPDATE_TIMER_INT,
+                         (cicint_cback_fcn_ptr)temp_sensor_plat_temp_update_int_handler,
+                         (VOID*)TEMP_SENSOR_UPDATE_TIMER_INT);
 
     cicint_int_enable(TEMP_SENSOR_UPDATE_TIMER_INT);
 }
@@ -551,6 +598,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register */
                 ocmb_api_temp_dimm0_update(dimm0_temp, TRUE, TRUE, FALSE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM0, dimm0_temp, TRUE, TRUE, FALSE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -562,6 +610,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register with error bit */
                 ocmb_api_temp_dimm0_update(0, FALSE, TRUE, TRUE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM0, 0, FALSE, TRUE, TRUE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -576,11 +625,15 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
             /* Update the OCMB thermal data register with present bit unset */
             ocmb_api_temp_dimm0_update(0, FALSE, FALSE, FALSE);
+            temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM0, 0, FALSE, FALSE, FALSE);
 
             /* restore interrupts and enable multi-VPE operation */
             top_plat_critical_region_exit(lock_struct);
         }
 
+        /* let host commands in between the TWI reads */
+        app_fw_sched_yield();
+
         if (temp_sensor_onboard_dimm1_config.present)
         {
 
@@ -600,6 +653,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register */
                 ocmb_api_temp_dimm1_update(dimm1_temp, TRUE, TRUE, FALSE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM1, dimm1_temp, TRUE, TRUE, FALSE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -611,6 +665,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register with error bit */
                 ocmb_api_temp_dimm1_update(0, FALSE, TRUE, TRUE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM1, 0, FALSE, TRUE, TRUE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -625,11 +680,14 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
             /* Update the OCMB thermal data register with present bit unset */
             ocmb_api_temp_dimm1_update(0, FALSE, FALSE, FALSE);
+            temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_DIMM1, 0, FALSE, FALSE, FALSE);
 
             /* restore interrupts and enable multi-VPE operation */
             top_plat_critical_region_exit(lock_struct);
         }
 
+        app_fw_sched_yield();
+
         if (temp_sensor_onchip_config.present)
         {
 #if (EXPLORER_ON_CHIP_TEMP_TWI_ACCESS_DISABLE == 0)
@@ -653,6 +711,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register */
                 ocmb_api_temp_onchip_update(chip_temp, TRUE, TRUE, FALSE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_ONCHIP, chip_temp, TRUE, TRUE, FALSE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -664,6 +723,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
                 /* Update the OCMB thermal data register with error bit */
                 ocmb_api_temp_onchip_update(0, FALSE, TRUE, TRUE);
+                temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_ONCHIP, 0, FALSE, TRUE, TRUE);
 
                 /* restore interrupts and enable multi-VPE operation */
                 top_plat_critical_region_exit(lock_struct);
@@ -676,6 +736,7 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
             /* Update the OCMB thermal data register with present bit unset */
             ocmb_api_temp_onchip_update(0, FALSE, FALSE, FALSE);
+            temp_sensor_plat_reading_set(TEMP_SENSOR_PLAT_ONCHIP, 0, FALSE, FALSE, FALSE);
 
             /* restore interrupts and enable multi-VPE operation */
             top_plat_critical_region_exit(lock_struct);
@@ -683,8 +744,36 @@ PUBLIC VOID temp_sensor_plat_update(VOID)
 
         /* Clear temperature sensor update flag */
         temperature_update_flags &= ~TEMP_SENSOR_UPDATE_FLAG;
+
+        /* the DDR PHY delay line update policy follows the DIMM temperature */
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_DDR_DL_UPDATE);
     }
 }
+
+/**
+* @brief
+*   Get the last value written to the OCMB thermal registers of a sensor,
+*   without accessing the sensor or the registers
+*
+* @param[in]  sensor      - sensor
+* @param[out] reading_ptr - reading, all 0 if the sensor was never updated
+*
+* @return
+*   None.
+*
+* @note
+*   Safe from either VPE.
+*/
+PUBLIC VOID temp_sensor_plat_reading_get(temp_sensor_plat_sensor_enum sensor,
+                                         temp_sensor_plat_reading_struct *reading_ptr)
+{
+    PMCFW_ASSERT(sensor < TEMP_SENSOR_PLAT_NUM, PMCFW_ERR_INVALID_PARAMETERS);
+
+    reading_ptr->temp = temp_sensor_reading[sensor].temp;
+    reading_ptr->flags = temp_sensor_reading[sensor].flags;
+    reading_ptr->reserved = 0;
+    reading_ptr->seconds = temp_sensor_reading[sensor].seconds;
+}
 /** @} end group */
 
 
@@ -0,0 +1,211 @@
+#********************************************************************************
+# MICROCHIP PM8596 EXPLORER FIRMWARE
+#
+# Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# --------------------------------------------------------------------------
+# DESCRIPTION  :  Seed inputs of test_ech_parse
+#
+# NOTES        :  python3 ech_seed.py [exp_api.h] [out_dir]
+#
+#                 Writes the host transactions of the bring-up, debug and
+#                 OpenCAPI flows as test_ech_parse records (see the file
+#                 description of test_ech_parse.c). The transactions are
+#                 built from the command layouts of exp_api.h, which the
+#                 command ids are read from, not captured from a bus.
+#                 Rerun it when the command set changes and check in the
+#                 output.
+#
+#*******************************************************************************/
+import os
+import re
+import struct
+import sys
+import zlib
+
+# Record types of test_ech_parse.c
+REC_TWI = 0
+REC_OC = 1
+REC_OC_CRC = 2
+REC_DEFERRED = 3
+
+# Register window of host_ech.c, outside and inside the OCMB space
+REG_ADDR = 0xB0000010
+OCMB_REG_ADDR = 0xA8000000
+
+EXP_FW_EXTENDED_DATA_BITMSK = 0x1
+
+
+def enum_read(path, name):
+    """Return {enumerator: value} of the typedef enum called name."""
+    text = open(path).read()
+    body = re.search(r"typedef enum\s*{([^}]*)}\s*" + name + ";", text).group(1)
+    body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)
+    values = {}
+    value = -1
+    for item in body.split(","):
+        item = item.strip()
+        if not item:
+            continue
+        if "=" in item:
+            item, expr = [s.strip() for s in item.split("=")]
+            value = int(expr, 0)
+        else:
+            value += 1
+        values[item] = value
+    return values
+
+
+class Seed:
+    """Records of one input."""
+
+    def __init__(self, twi, oc):
+        self.twi = twi
+        self.oc = oc
+        self.data = bytearray()
+
+    def write(self, data):
+        self.data += struct.pack("<BH", REC_TWI, len(data)) + bytes(data)
+
+    def cmd(self, name, payload=b""):
+        data = bytes([self.twi[name]])
+        if payload or name not in ("EXP_FW_TWI_CMD_STATUS", "EXP_FW_TWI_POLL_ABORT",
+                                   "EXP_FW_READ_ACTIVE_LOGS", "EXP_FW_READ_BOOT_PROFILE"):
+            data += bytes([len(payload)]) + bytes(payload)
+        return data
+
+    def deferred(self):
+        self.data += bytes([REC_DEFERRED])
+
+    def oc_cmd(self, name, parms=b"", ext=b"", fix_crc=True, req_id=1):
+        flags = EXP_FW_EXTENDED_DATA_BITMSK if ext else 0
+        ext_crc = zlib.crc32(ext) if ext else 0
+        # exp_cmd_struct: id, flags, req_id, ext_data_len, ext_data_crc,
+        # host_spad_area, ech_spad_area, padding[12], parms[28], crc
+        cmd = struct.pack("<BBHIIII12x", self.oc[name], flags, req_id, len(ext), ext_crc, 0, 0)
+        cmd += bytes(parms).ljust(28, b"\0")
+        cmd += struct.pack("<I", zlib.crc32(cmd) if fix_crc else 0)
+        rec = REC_OC_CRC if fix_crc else REC_OC
+        self.data += bytes([rec]) + cmd + struct.pack("<H", len(ext)) + bytes(ext)
+
+
+def be32(value):
+    return struct.pack(">I", value)
+
+
+def seeds(twi, oc):
+    out = {}
+
+    s = Seed(twi, oc)
+    for _ in range(4):
+        s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["status_poll"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_TWI_FFE_SETTINGS", b"\x00\x00\x00\x10\x00\x00\x00\x08"))
+    s.write(s.cmd("EXP_FW_TWI_CMD_BOOT_CONFIG", b"\x00\x00\x00\x00"))
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    s.deferred()
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    s.write(s.cmd("EXP_FW_TWI_CMD_BOOT_CONFIG", b"\x00\x00\x01\x01"))
+    s.deferred()
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["boot_config"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_WRITE", be32(REG_ADDR) + be32(0x12345678)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_ADDR_LATCH", be32(REG_ADDR)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_READ", be32(0)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_READ", be32(0)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["reg_rw"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_WRITE", be32(OCMB_REG_ADDR) + be32(0xA5A5A5A5)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_WRITE", be32(OCMB_REG_ADDR + 4) + be32(0x5A5A5A5A)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_ADDR_LATCH", be32(OCMB_REG_ADDR + 4)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_READ", be32(0)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_REG_ADDR_LATCH", be32(0x00000002)))
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["reg_ocmb"] = s
+
+    s = Seed(twi, oc)
+    latch = s.cmd("EXP_FW_TWI_CMD_REG_ADDR_LATCH", be32(REG_ADDR))
+    s.write(latch[:1])
+    s.write(latch[1:3])
+    s.write(latch[3:] + s.cmd("EXP_FW_TWI_CMD_REG_READ", be32(0))[:2])
+    s.write(be32(0))
+    out["split"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS") + s.cmd("EXP_FW_TWI_POLL_ABORT") +
+            s.cmd("EXP_FW_TWI_CMD_REG_ADDR_LATCH", be32(REG_ADDR)) +
+            s.cmd("EXP_FW_TWI_CMD_REG_READ", be32(0)))
+    s.write(bytes([0xEE]) + s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["batch"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_CDR_OFFSET_FROM_CAL_SET", b"\x00\x04"))
+    s.write(s.cmd("EXP_FW_CDR_BANDWIDTH_SET", b"\x07\x03"))
+    s.write(s.cmd("EXP_FW_CONT_SERDES_CAL_DISABLE", b"\x01"))
+    s.write(s.cmd("EXP_FW_PRBS_CAL_STATUS_READ"))
+    s.write(s.cmd("EXP_FW_PQM_FORCE_DELAY_LINE_UPDATE"))
+    s.deferred()
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    out["serdes"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_READ_ACTIVE_LOGS"))
+    for _ in range(3):
+        s.write(s.cmd("EXP_FW_READ_CMD_TRACE", b"\x00"))
+    s.write(s.cmd("EXP_FW_READ_CMD_STATS", b"\x01"))
+    s.write(s.cmd("EXP_FW_READ_SAVED_DDR_PARAMS", b"\x00"))
+    s.write(s.cmd("EXP_FW_READ_TELEMETRY", b"\x00"))
+    s.write(s.cmd("EXP_FW_READ_BOOT_PROFILE"))
+    out["debug_read"] = s
+
+    s = Seed(twi, oc)
+    s.oc_cmd("EXP_FW_DDR_PHY_INIT", parms=b"\x00")
+    s.oc_cmd("EXP_FW_DDR_PHY_INIT", ext=bytes(range(256)) * 4, req_id=2)
+    s.oc_cmd("EXP_FW_ADAPTER_PROPERTIES_GET", req_id=3)
+    s.oc_cmd("EXP_FW_LOG", parms=b"\x01", req_id=4)
+    s.oc_cmd("EXP_FW_DDR_PHY_INIT", fix_crc=False, req_id=5)
+    out["oc"] = s
+
+    s = Seed(twi, oc)
+    s.write(s.cmd("EXP_FW_TWI_CMD_STATUS"))
+    s.oc_cmd("EXP_FW_TEMP_SENSOR_PASS_THROUGH_READ", parms=b"\x10\x00")
+    s.write(s.cmd("EXP_FW_READ_CMD_TRACE", b"\x00"))
+    s.oc_cmd("EXP_FW_DDR_PHY_INIT", ext=b"\x5a" * 64, req_id=7)
+    s.write(s.cmd("EXP_FW_READ_CMD_STATS", b"\x00"))
+    out["mixed"] = s
+
+    return out
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    header = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "../../../inc/exp_api.h")
+    out_dir = sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, "ech")
+
+    twi = enum_read(header, "exp_twi_cmd_enum")
+    oc = enum_read(header, "exp_cmd_enum")
+
+    os.makedirs(out_dir, exist_ok=True)
+    for name, seed in seeds(twi, oc).items():
+        with open(os.path.join(out_dir, name + ".bin"), "wb") as f:
+            f.write(seed.data)
+
+
+if __name__ == "__main__":
+    main()
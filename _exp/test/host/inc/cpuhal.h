@@ -0,0 +1,52 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host replacement of the CPU HAL header.
+*
+* @note
+*   The firmware cpuhal.h defines its CP0 and cache accessors as MIPS
+*   assembly, which only builds with the target compiler. Host builds get
+*   the constants and prototypes of the accessors the tested modules use,
+*   and the stubs define them.
+*/
+
+#ifndef _CPUHAL_H
+#define _CPUHAL_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmcfw_err.h"
+#include "cpuhal_asm.h"
+
+/*
+** Function Prototypes
+*/
+
+EXTERN UINT32 hal_cp0_counter_get(VOID);
+EXTERN UINT32 hal_sys_cpu_id_get(VOID);
+
+#endif /* _CPUHAL_H */
+
+/** @} end addtogroup */
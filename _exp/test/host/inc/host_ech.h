@@ -0,0 +1,85 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host side of the Explorer command interfaces, for tests of the
+*   OpenCAPI and TWI command parsers.
+*
+* @note
+*   The TWI slave port is modelled at the twi_slv_* API: each write of the
+*   host is returned by the next twi_slv_poll() and the last response put
+*   by the firmware is kept. The OpenCAPI command, response and extended
+*   data buffers are RAM and the doorbell is a flag.
+*
+*   Register reads and writes of the TWI commands are allowed in two
+*   windows mapped at their firmware addresses, one in the OCMB register
+*   space and one outside it. Any other address is rejected by the
+*   address checks, so a parser fault that reaches an unchecked address
+*   crashes the test. The command handlers behind the parsers are stubs
+*   that consume their command and report success.
+*/
+
+#ifndef _HOST_ECH_H
+#define _HOST_ECH_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+#include "pmc_hw_base.h"
+#include "exp_api.h"
+
+/*
+** Constants
+*/
+
+/* TWI slave port of the firmware */
+#define HOST_ECH_TWI_PORT           1
+
+/* Register windows */
+#define HOST_ECH_REG_WIN_SIZE       4096
+#define HOST_ECH_OCMB_REG_ADDR      OCMB_REGS_BASE_ADDR
+#define HOST_ECH_REG_ADDR           0xB0000000
+
+/* Size of the OpenCAPI extended data buffer, sram_ext_data_buf_size */
+#define HOST_ECH_EXT_DATA_SIZE      (64 * 1024)
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID host_ech_reset(VOID);
+EXTERN BOOL host_ech_reg_win_mapped(VOID);
+EXTERN VOID host_ech_twi_write(const UINT8 *data_ptr, UINT32 len);
+EXTERN UINT32 host_ech_twi_rsp_get(UINT8 *buf_ptr, UINT32 len);
+EXTERN UINT32 host_ech_twi_rsp_count(VOID);
+EXTERN BOOL host_ech_twi_deferred_run(VOID);
+EXTERN UINT32 host_ech_twi_dispatch_count(VOID);
+EXTERN exp_cmd_struct *host_ech_oc_cmd_ptr(VOID);
+EXTERN UINT8 *host_ech_oc_ext_data_ptr(VOID);
+EXTERN VOID host_ech_oc_doorbell(VOID);
+EXTERN UINT32 host_ech_oc_rsp_count(VOID);
+EXTERN exp_rsp_struct *host_ech_oc_rsp_ptr(VOID);
+
+#endif /* _HOST_ECH_H */
+
+/** @} end addtogroup */
@@ -0,0 +1,75 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   RAM model of the SPI flash for host tests.
+*
+* @note
+*   The model keeps the state of each page so the test sees what the
+*   flash ECC would report: erased and partially programmed pages fail a
+*   checked read, a plain read of them is an uncorrectable ECC error and a
+*   page may only be programmed once per erase. Both are counted as test
+*   failures.
+*
+*   Every subsector erase and page program is one operation. A power cut
+*   can be armed to tear the Nth operation from now: the page or subsector
+*   is left partially written and every later operation fails until
+*   host_flash_power_on() is called, as if the device had reset.
+*/
+
+#ifndef _HOST_FLASH_H
+#define _HOST_FLASH_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+** Constants
+*/
+
+#define HOST_FLASH_SIZE             (8 * 1024 * 1024)
+#define HOST_FLASH_PAGE_SIZE        256
+#define HOST_FLASH_SUBSECTOR_SIZE   (4 * 1024)
+
+/* Power cut not armed */
+#define HOST_FLASH_NO_CUT           0xFFFFFFFF
+
+/* Error returned by flash operations while the power is off */
+#define HOST_FLASH_ERR_POWER        0xDEAD0001
+
+/*
+** Function Prototypes
+*/
+
+EXTERN VOID host_flash_reset(VOID);
+EXTERN VOID host_flash_power_cut_set(UINT32 ops);
+EXTERN VOID host_flash_power_on(VOID);
+EXTERN BOOL host_flash_power_is_off(VOID);
+EXTERN UINT32 host_flash_op_count(VOID);
+EXTERN BOOL host_flash_page_is_programmed(UINT32 addr);
+EXTERN VOID host_flash_corrupt(UINT32 addr);
+
+#endif /* _HOST_FLASH_H */
+
+/** @} end addtogroup */
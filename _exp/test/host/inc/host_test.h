@@ -0,0 +1,74 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Helpers shared by the host tests and benchmarks.
+*
+* @note
+*   Firmware modules are built for the host against the stubs in
+*   test/host/stub. A test counts its failed checks and returns
+*   host_test_result() from main(), so the makefile stops at the first
+*   failing test.
+*/
+
+#ifndef _HOST_TEST_H
+#define _HOST_TEST_H
+
+/*
+** Include Files
+*/
+
+#include "pmcfw_types.h"
+
+/*
+** Constants
+*/
+
+/* Console log of the host bc_printf(), the size of the APP_FW_LOG_SIZE log */
+#define HOST_LOG_SIZE       4096
+#define HOST_LOG_LINE_MAX   256
+
+/*
+** Macro Definitions
+*/
+
+/* Count a failed check, print where it failed and carry on */
+#define HOST_CHECK(cond)    host_check((BOOL)(0 != (cond)), #cond, __FILE__, __LINE__)
+
+/*
+** Function Prototypes
+*/
+
+EXTERN BOOL host_check(BOOL cond, const CHAR *expr_ptr, const CHAR *file_ptr, UINT32 line);
+EXTERN INT32 host_test_result(const CHAR *name_ptr);
+EXTERN UINT64 host_time_ns(VOID);
+EXTERN UINT64 host_cycles(VOID);
+EXTERN VOID host_log_stats_get(UINT32 *msgs_ptr, UINT32 *bytes_ptr);
+EXTERN VOID host_log_stats_reset(VOID);
+EXTERN VOID host_critical_region_reset(VOID);
+EXTERN VOID host_srand(UINT32 seed);
+EXTERN UINT32 host_rand(VOID);
+EXTERN UINT8 *host_file_read(const CHAR *path_ptr, UINT32 *len_ptr);
+
+#endif /* _HOST_TEST_H */
+
+/** @} end addtogroup */
+
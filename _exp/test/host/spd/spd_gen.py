@@ -0,0 +1,159 @@
+#********************************************************************************
+# MICROCHIP PM8596 EXPLORER FIRMWARE
+#
+# Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# --------------------------------------------------------------------------
+# DESCRIPTION  :  DDR4 SPD images of test_exp_ddr_ctrlr_spd
+#
+# NOTES        :  python3 spd_gen.py [out_dir]
+#
+#                 Writes 512 byte DDR4 SPD images of the DIMMs of the
+#                 bringup configurations in exp_ddr_ctrlr_plat.c, and of a
+#                 3DS RDIMM at DDR4-2933, which needs the fine timebase.
+#                 The base configuration section is encoded as the JEDEC
+#                 DDR4 SPD (Annex L) gives it, from the timings of the
+#                 bringup configurations and the JEDEC speed bins. The
+#                 images are not read from DIMMs. Only bytes 0 to 127 are
+#                 filled, the module specific section is left blank.
+#                 Rerun it when a DIMM is added and check in the output.
+#
+#*******************************************************************************/
+import os
+import sys
+
+SPD_SIZE = 512
+MTB_PS = 125
+
+# Byte 3 module types
+UDIMM = 0x02
+RDIMM = 0x01
+
+# Byte 4 density codes
+DENSITY = {4: 0x4, 8: 0x5, 16: 0x6}
+
+# Byte 12 device width codes
+WIDTH = {4: 0, 8: 1, 16: 2}
+
+
+def crc16(data):
+    """CRC of the SPD base configuration section."""
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def mtb_ftb(ps):
+    """Medium timebase count and fine correction byte of a time in ps.
+    The count is rounded up and the correction is negative, as JEDEC
+    encodes times that are not a multiple of 125 ps."""
+    mtb = (ps + MTB_PS - 1) // MTB_PS
+    return mtb, (ps - mtb * MTB_PS) & 0xFF
+
+
+def spd(dimm):
+    s = bytearray(SPD_SIZE)
+    s[0] = 0x23                         # 384 bytes used, 512 total
+    s[1] = 0x11                         # SPD revision 1.1
+    s[2] = 0x0C                         # DDR4 SDRAM
+    s[3] = dimm["module"]
+    s[4] = DENSITY[dimm["density_gb"]] | (0x40 if dimm["width"] == 16 else 0x80)   # 2 or 4 bank groups of 4
+    s[5] = ((dimm["row_bits"] - 12) << 3) | (dimm["col_bits"] - 9)
+    s[6] = dimm.get("package", 0x00)
+    s[12] = ((dimm["ranks"] - 1) << 3) | WIDTH[dimm["width"]]
+    s[13] = 0x0B if dimm["ecc"] else 0x03   # 64 bit primary bus, 8 bit ECC
+    s[17] = 0x00                        # MTB 125 ps, FTB 1 ps
+
+    s[18], s[125] = mtb_ftb(dimm["tCKmin"])
+    s[19], s[124] = mtb_ftb(1600)       # tCKAVGmax 1.6 ns
+
+    cl_mask = 0
+    for cl in dimm["cl"]:
+        cl_mask |= 1 << (cl - 7)
+    s[20:24] = cl_mask.to_bytes(4, "little")
+
+    s[24], s[123] = mtb_ftb(dimm["tAA"])
+    s[25], s[122] = mtb_ftb(dimm["tRCD"])
+    s[26], s[121] = mtb_ftb(dimm["tRP"])
+    tras = dimm["tRAS"] // MTB_PS
+    trc, s[120] = mtb_ftb(dimm["tRC"])
+    s[27] = ((trc >> 8) << 4) | (tras >> 8)
+    s[28] = tras & 0xFF
+    s[29] = trc & 0xFF
+    for off, name in ((30, "tRFC1"), (32, "tRFC2"), (34, "tRFC4")):
+        s[off:off + 2] = (dimm[name] // MTB_PS).to_bytes(2, "little")
+    tfaw = dimm["tFAW"] // MTB_PS
+    s[36] = tfaw >> 8
+    s[37] = tfaw & 0xFF
+    s[38], s[119] = mtb_ftb(dimm["tRRD_S"])
+    s[39], s[118] = mtb_ftb(dimm["tRRD_L"])
+    s[40], s[117] = mtb_ftb(dimm["tCCD_L"])
+    twr = dimm["tWR"] // MTB_PS
+    s[41] = twr >> 8
+    s[42] = twr & 0xFF
+    twtr_s = dimm["tWTR_S"] // MTB_PS
+    twtr_l = dimm["tWTR_L"] // MTB_PS
+    s[43] = ((twtr_l >> 8) << 4) | (twtr_s >> 8)
+    s[44] = twtr_s & 0xFF
+    s[45] = twtr_l & 0xFF
+
+    crc = crc16(s[0:126])
+    s[126] = crc & 0xFF
+    s[127] = crc >> 8
+    return s
+
+
+# Timings of the bringup configurations, in ps
+BRINGUP = dict(tAA=13750, tRCD=13750, tRP=13750, tRAS=32000, tRC=45750,
+               tRFC1=350000, tRFC2=260000, tRFC4=160000, tFAW=21000,
+               tRRD_S=2500, tRRD_L=4900, tCCD_L=5000,
+               tWR=15000, tWTR_S=2500, tWTR_L=7500)
+
+DIMMS = {
+    "udimm_x8_1r_2666": dict(BRINGUP, module=UDIMM, density_gb=8, width=8, ranks=1, ecc=True,
+                             row_bits=16, col_bits=10, tCKmin=750, cl=range(10, 21),
+                             tRRD_S=3000),
+    "udimm_x8_2r_3200": dict(BRINGUP, module=UDIMM, density_gb=8, width=8, ranks=2, ecc=False,
+                             row_bits=16, col_bits=10, tCKmin=625, cl=range(10, 25)),
+    "rdimm_x4_2r_3200": dict(BRINGUP, module=RDIMM, density_gb=8, width=4, ranks=2, ecc=True,
+                             row_bits=17, col_bits=10, tCKmin=625, cl=range(10, 25),
+                             tRAS=32500, tFAW=10000),
+    "udimm_x16_1r_2666": dict(BRINGUP, module=UDIMM, density_gb=8, width=16, ranks=1, ecc=False,
+                              row_bits=16, col_bits=10, tCKmin=750, cl=range(10, 21),
+                              tRC=47000, tFAW=30000, tRRD_S=5300, tRRD_L=6400),
+    "udimm_x8_1r_3200": dict(BRINGUP, module=UDIMM, density_gb=8, width=8, ranks=1, ecc=True,
+                             row_bits=16, col_bits=10, tCKmin=625, cl=range(10, 25)),
+    # DDR4-2933AA 16Gb x4, 2 high 3DS, 2 package ranks
+    "rdimm_3ds_x4_2r_2933": dict(module=RDIMM, density_gb=16, width=4, ranks=2, ecc=True,
+                                 row_bits=18, col_bits=10, package=0x92,
+                                 tCKmin=682, cl=[20, 21, 22, 24],
+                                 tAA=13640, tRCD=13640, tRP=13640, tRAS=32000, tRC=45640,
+                                 tRFC1=550000, tRFC2=350000, tRFC4=260000, tFAW=10875,
+                                 tRRD_S=2500, tRRD_L=4900, tCCD_L=5000,
+                                 tWR=15000, tWTR_S=2500, tWTR_L=7500),
+}
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    os.makedirs(out_dir, exist_ok=True)
+    for name, dimm in DIMMS.items():
+        with open(os.path.join(out_dir, name + ".bin"), "wb") as f:
+            f.write(spd(dimm))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,808 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host side of the Explorer command interfaces: the TWI slave port, the
+*   OpenCAPI buffers and doorbell, and stubs of the modules the command
+*   parsers call. See host_ech.h.
+*/
+
+/*
+** Include Files
+*/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "pmcfw_common.h"
+#include "exp_api.h"
+#include "ech.h"
+#include "ech_loc.h"
+#include "ech_twi_common.h"
+#include "ech_pqm.h"
+#include "ech_trace.h"
+#include "ech_stats.h"
+#include "ech_telemetry.h"
+#include "app_fw_boot_prof.h"
+#include "app_fw_sched.h"
+#include "log_chan.h"
+#include "char_io.h"
+#include "ccb_api.h"
+#include "mem.h"
+#include "ocmb.h"
+#include "serdes_plat.h"
+#include "serdes_api.h"
+#include "serdes_cg_supplement.h"
+#include "twi.h"
+#include "twi_api.h"
+#include "wdt.h"
+#include "cpuhal.h"
+#include "host_test.h"
+#include "host_ech.h"
+
+/*
+** Local Constants
+*/
+
+/* Sizes of the records returned by the trace, statistics, log and telemetry reads */
+#define HOST_ECH_TRACE_SIZE         1000
+#define HOST_ECH_STATS_SIZE         700
+#define HOST_ECH_LOG_SIZE           600
+#define HOST_ECH_TELEMETRY_SIZE     300
+
+/* Memory for ech_oc_init() */
+#define HOST_ECH_HEAP_SIZE          4096
+
+/*
+** Private Data
+*/
+
+/* TWI slave port: pending host write and last response */
+PRIVATE UINT8 host_ech_twi_wr[EXP_TWI_MAX_BUF_SIZE];
+PRIVATE UINT32 host_ech_twi_wr_len = 0;
+PRIVATE BOOL host_ech_twi_wr_pending = FALSE;
+PRIVATE UINT8 host_ech_twi_rsp[EXP_TWI_MAX_BUF_SIZE];
+PRIVATE UINT32 host_ech_twi_rsp_len = 0;
+PRIVATE UINT32 host_ech_twi_rsps = 0;
+PRIVATE BOOL host_ech_twi_deferred = FALSE;
+
+/* OpenCAPI buffers and doorbell */
+PRIVATE exp_cmd_struct host_ech_cmd;
+PRIVATE exp_rsp_struct host_ech_rsp;
+PRIVATE UINT8 host_ech_ext_data[HOST_ECH_EXT_DATA_SIZE];
+PRIVATE BOOL host_ech_doorbell = FALSE;
+PRIVATE UINT32 host_ech_rsps = 0;
+PRIVATE ech_ctrl_struct *host_ech_ctrl_ptr = NULL;
+
+/* State kept by ech.c */
+PRIVATE UINT32 host_ech_latched_reg_addr = 0;
+PRIVATE UINT8 host_ech_ext_err_code = 0;
+
+/* Register windows */
+PRIVATE BOOL host_ech_reg_mapped = FALSE;
+
+/* TWI commands dispatched by the parser */
+PRIVATE UINT32 host_ech_twi_dispatches = 0;
+
+/* Read positions of the synthetic records */
+PRIVATE UINT32 host_ech_log_rd = 0;
+
+PRIVATE UINT8 host_ech_heap[HOST_ECH_HEAP_SIZE] __attribute__((aligned(HAL_MEM_NUMBYTES_CACHE_LINE)));
+PRIVATE UINT32 host_ech_heap_used = 0;
+
+/* Lengths of the PQM commands, kept by ech_pqm.c */
+PRIVATE const UINT8 host_ech_pqm_len[EXP_FW_TWI_CMD_MAX] =
+{
+    [EXP_FW_PQM_LANE_SET]                           = EXP_TWI_PQM_LANE_SET_CMD_LEN,
+    [EXP_FW_PQM_LANE_GET]                           = EXP_TWI_PQM_LANE_GET_CMD_LEN,
+    [EXP_FW_PQM_FREQ_SET]                           = EXP_TWI_PQM_FREQ_SET_CMD_LEN,
+    [EXP_FW_PQM_FREQ_GET]                           = EXP_TWI_PQM_FREQ_GET_CMD_LEN,
+    [EXP_FW_PQM_LANE_TRAINING]                      = EXP_TWI_PQM_LANE_TRAIN_CMD_LEN,
+    [EXP_FW_PQM_TRAINING_RESET]                     = EXP_TWI_PQM_LANE_RETRAIN_CMD_LEN,
+    [EXP_FW_PQM_RX_ADAPTATION_OBJ_START]            = EXP_TWI_PQM_RX_ADAPAT_OBJ_START_CMD_LEN,
+    [EXP_FW_PQM_RX_ADAPTATION_OBJ_READ]             = EXP_TWI_PQM_RX_ADAPAT_OBJ_READ_CMD_LEN,
+    [EXP_FW_PQM_RX_CALIBRATION_VALUE_START]         = EXP_TWI_PQM_RX_CALIB_VALUE_START_CMD_LEN,
+    [EXP_FW_PQM_RX_CALIBRATION_VALUE_READ]          = EXP_TWI_PQM_RX_CALIB_VALUE_READ_CMD_LEN,
+    [EXP_FW_PQM_CSU_CALIBRATION_VALUE_STATUS_START] = EXP_TWI_PQM_CSU_CALIB_VALUE_STATUS_START_CMD_LEN,
+    [EXP_FW_PQM_CSU_CALIBRATION_VALUE_STATUS_READ]  = EXP_TWI_PQM_CSU_CALIB_VALUE_STATUS_READ_CMD_LEN,
+    [EXP_FW_PQM_PRBS_PATTERN_MODE_SET]              = EXP_TWI_PQM_PRBS_PATTERN_MODE_SET_CMD_LEN,
+    [EXP_FW_PQM_PRBS_USER_DEFINED_PATTERN_SET]      = EXP_TWI_PQM_PRBS_USER_PATTERN_SET_CMD_LEN,
+    [EXP_FW_PQM_PRBS_MONITOR_CONTROL]               = EXP_TWI_PQM_PRBS_MONITOR_CONTROL_CMD_LEN,
+    [EXP_FW_PQM_PRBS_GENERATOR_CONTROL]             = EXP_TWI_PQM_PRBS_GENERATOR_CONTROL_CMD_LEN,
+    [EXP_FW_PQM_PRBS_ERR_COUNT_START]               = EXP_TWI_PQM_PRBS_ERR_COUNT_START_CMD_LEN,
+    [EXP_FW_PQM_PRBS_ERR_COUNT_READ]                = EXP_TWI_PQM_PRBS_ERR_COUNT_READ_CMD_LEN,
+    [EXP_FW_PQM_HORIZONTAL_BATHTUB_GET_START]       = EXP_TWI_PQM_HORZ_BATHTUB_GET_START_CMD_LEN,
+    [EXP_FW_PQM_HORIZONTAL_BATHTUB_GET_READ]        = EXP_TWI_PQM_HORZ_BATHTUB_GET_READ_CMD_LEN,
+    [EXP_FW_PQM_VERTICAL_BATHTUB_GET_START]         = EXP_TWI_PQM_VERT_BATHTUB_GET_START_CMD_LEN,
+    [EXP_FW_PQM_VERTICAL_BATHTUB_GET_READ]          = EXP_TWI_PQM_VERT_BATHTUB_GET_READ_CMD_LEN,
+    [EXP_FW_PQM_2D_BATHTUB_GET_START]               = EXP_TWI_PQM_TWOD_BATHTUB_GET_START_CMD_LEN,
+    [EXP_FW_PQM_2D_BATHTUB_GET_READ]                = EXP_TWI_PQM_TWOD_BATHTUB_GET_READ_CMD_LEN,
+};
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Check that a register access is inside one of the windows.
+*
+* @param[in] addr - firmware register address
+*
+* @return
+*   TRUE if the address may be accessed.
+*/
+PRIVATE BOOL host_ech_reg_addr_in_win(UINT32 addr)
+{
+    if ((FALSE == host_ech_reg_mapped) || (0 != (addr & 0x3)))
+    {
+        return FALSE;
+    }
+
+    return ((addr - HOST_ECH_OCMB_REG_ADDR) < HOST_ECH_REG_WIN_SIZE) ||
+           ((addr - HOST_ECH_REG_ADDR) < HOST_ECH_REG_WIN_SIZE);
+}
+
+/**
+* @brief
+*   Map a register window at its firmware address.
+*
+* @param[in] addr - firmware address of the window
+*
+* @return
+*   TRUE if mapped.
+*/
+PRIVATE BOOL host_ech_reg_win_map(UINT32 addr)
+{
+    VOID *ptr = mmap((VOID *)(uintptr_t)addr,
+                     HOST_ECH_REG_WIN_SIZE,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                     -1,
+                     0);
+
+    return (ptr == (VOID *)(uintptr_t)addr);
+}
+
+/**
+* @brief
+*   Fill a read of a synthetic record with a pattern of its offsets.
+*
+* @param[in]  size    - record size
+* @param[in]  offset  - offset of the read
+* @param[out] buf_ptr - destination
+* @param[in]  len     - bytes requested
+*
+* @return
+*   Bytes copied.
+*/
+PRIVATE UINT32 host_ech_record_read(UINT32 size, UINT32 offset, UINT8 *buf_ptr, UINT32 len)
+{
+    UINT32 i;
+
+    if (offset >= size)
+    {
+        return 0;
+    }
+    if (len > (size - offset))
+    {
+        len = size - offset;
+    }
+    for (i = 0; i < len; i++)
+    {
+        buf_ptr[i] = (UINT8)(offset + i);
+    }
+
+    return len;
+}
+
+/*
+** Firmware Replacements
+*/
+
+/* TWI slave port */
+
+PUBLIC VOID twi_init(const twi_oper_mode_enum oper_mode)
+{
+}
+
+PUBLIC VOID twi_port_init(const UINT port_id, const twi_port_cfg_struct * const cfg_ptr)
+{
+}
+
+PUBLIC PMCFW_ERROR twi_port_dummy_data_send(const UINT port_id, UINT8 data)
+{
+    return PMC_SUCCESS;
+}
+
+PUBLIC PMCFW_ERROR twi_slv_poll(const UINT port_id, UINT32 * const activity_ptr)
+{
+    HOST_CHECK(HOST_ECH_TWI_PORT == port_id);
+    *activity_ptr = (TRUE == host_ech_twi_wr_pending) ? TWI_SLAVE_ACTIVITY_RX_REQ : TWI_SLAVE_ACTIVITY_NONE;
+
+    return PMC_SUCCESS;
+}
+
+PUBLIC PMCFW_ERROR twi_slv_data_len_get(const UINT port_id, UINT32 * const len_ptr)
+{
+    *len_ptr = host_ech_twi_wr_len;
+
+    return PMC_SUCCESS;
+}
+
+PUBLIC PMCFW_ERROR twi_slv_data_get(const UINT port_id, UINT8 * const data_ptr, const UINT32 length)
+{
+    HOST_CHECK(length == host_ech_twi_wr_len);
+    memcpy(data_ptr, host_ech_twi_wr, length);
+    host_ech_twi_wr_pending = FALSE;
+
+    return PMC_SUCCESS;
+}
+
+PUBLIC PMCFW_ERROR twi_slv_data_put(const UINT port_id, const UINT8 * const data_ptr, const UINT32 len)
+{
+    HOST_CHECK(HOST_ECH_TWI_PORT == port_id);
+    HOST_CHECK(len <= EXP_TWI_MAX_BUF_SIZE);
+    host_ech_twi_rsp_len = (len <= EXP_TWI_MAX_BUF_SIZE) ? len : EXP_TWI_MAX_BUF_SIZE;
+    memcpy(host_ech_twi_rsp, data_ptr, host_ech_twi_rsp_len);
+    host_ech_twi_rsps++;
+
+    return PMC_SUCCESS;
+}
+
+/* OpenCAPI buffers and doorbell, ech.c */
+
+PUBLIC exp_cmd_struct* ech_cmd_ptr_get(VOID)
+{
+    return &host_ech_cmd;
+}
+
+PUBLIC exp_rsp_struct* ech_rsp_ptr_get(VOID)
+{
+    return &host_ech_rsp;
+}
+
+PUBLIC UINT32 ech_rsp_size_get(VOID)
+{
+    return sizeof(host_ech_rsp);
+}
+
+PUBLIC UINT8* ech_ext_data_ptr_get(VOID)
+{
+    return host_ech_ext_data;
+}
+
+PUBLIC UINT32 ech_ext_data_size_get(VOID)
+{
+    return sizeof(host_ech_ext_data);
+}
+
+PUBLIC BOOL ech_cmd_rxd_flag_get(VOID)
+{
+    return host_ech_doorbell;
+}
+
+PUBLIC VOID ech_cmd_rxd_clr(VOID)
+{
+    host_ech_doorbell = FALSE;
+}
+
+PUBLIC VOID ech_cmd_txd_flag_set(VOID)
+{
+    host_ech_rsps++;
+}
+
+PUBLIC ech_ctrl_struct* ech_ctrl_ptr_get(VOID)
+{
+    return host_ech_ctrl_ptr;
+}
+
+PUBLIC VOID ech_ctrl_ptr_set(ech_ctrl_struct* ctrl_ptr)
+{
+    host_ech_ctrl_ptr = ctrl_ptr;
+}
+
+PUBLIC void *mem_alloc(const UINT32 mem_section, const UINT32 mem_size, const UINT32 byte_align, const BOOL lock_in_l2, UINT32 *bytes_wasted_ptr)
+{
+    VOID *ptr;
+
+    HOST_CHECK((host_ech_heap_used + mem_size) <= HOST_ECH_HEAP_SIZE);
+    ptr = &host_ech_heap[host_ech_heap_used];
+    host_ech_heap_used += (mem_size + HAL_MEM_NUMBYTES_CACHE_LINE - 1) & ~(HAL_MEM_NUMBYTES_CACHE_LINE - 1);
+
+    return ptr;
+}
+
+/* Register access checks and state, ech.c and ocmb */
+
+PUBLIC BOOL ech_reg_addr_validate(UINT32 addr)
+{
+    return host_ech_reg_addr_in_win(addr);
+}
+
+PUBLIC BOOL ocmb_reg_addr_valid(UINT32 addr)
+{
+    return host_ech_reg_addr_in_win(addr);
+}
+
+PUBLIC BOOL ocmb_reg_addr_write_only(UINT32 addr)
+{
+    return FALSE;
+}
+
+PUBLIC BOOL ocmb_left_address_validate(UINT32 addr)
+{
+    return (TRUE == host_ech_reg_addr_in_win(addr)) && (0 == (addr & 0x4));
+}
+
+PUBLIC BOOL ocmb_right_address_validate(UINT32 addr)
+{
+    return (TRUE == host_ech_reg_addr_in_win(addr)) && (0 != (addr & 0x4));
+}
+
+PUBLIC VOID ech_latched_reg_addr_set(UINT32 reg_addr)
+{
+    host_ech_latched_reg_addr = reg_addr;
+}
+
+PUBLIC UINT32 ech_latched_reg_addr_get(VOID)
+{
+    return host_ech_latched_reg_addr;
+}
+
+PUBLIC VOID ech_extended_error_code_set(UINT32 error_code)
+{
+    host_ech_ext_err_code = (UINT8)error_code;
+}
+
+PUBLIC UINT8 ech_extended_error_code_get(VOID)
+{
+    return host_ech_ext_err_code;
+}
+
+/* Command handlers behind the parsers */
+
+PUBLIC UINT32 ech_twi_boot_config_proc(UINT8* rx_buf, UINT32 rx_index)
+{
+    HOST_CHECK(EXP_FW_TWI_CMD_BOOT_CONFIG == rx_buf[EXP_TWI_CMD_OFFSET]);
+
+    return EXP_TWI_SUCCESS;
+}
+
+PUBLIC UINT32 ech_pqm_force_delay_line_update(UINT8* rx_buf_ptr, UINT32 rx_index)
+{
+    HOST_CHECK(EXP_FW_PQM_FORCE_DELAY_LINE_UPDATE == rx_buf_ptr[EXP_TWI_CMD_OFFSET]);
+
+    return EXP_TWI_SUCCESS;
+}
+
+PUBLIC BOOL ech_twi_pqm_get(VOID)
+{
+    return TRUE;
+}
+
+PUBLIC VOID ech_pqm_cmd_rx_index_increment(UINT8* rx_buf_ptr, UINT32 rx_index)
+{
+    HOST_CHECK(0 != host_ech_pqm_len[rx_buf_ptr[rx_index]]);
+    ech_twi_rx_index_inc(host_ech_pqm_len[rx_buf_ptr[rx_index]]);
+}
+
+PUBLIC VOID ech_pqm_cmd_proc(UINT8* rx_buf_ptr, UINT32 rx_index)
+{
+    ech_twi_status_byte_set(EXP_TWI_SUCCESS);
+    ech_pqm_cmd_rx_index_increment(rx_buf_ptr, rx_index);
+}
+
+PUBLIC BOOL ech_serdes_prbs_cal_state_get(VOID)
+{
+    return TRUE;
+}
+
+PUBLIC VOID ech_serdes_prbs_cal_data_get(UINT8 * pattmon_detected_bitmask, UINT8 * cal_converged_bitmask)
+{
+    *pattmon_detected_bitmask = 0xFF;
+    *cal_converged_bitmask = 0xFF;
+}
+
+PUBLIC BOOL ech_serdes_cdr_prop_gain_set(UINT8 prop_gain)
+{
+    return (prop_gain < 16);
+}
+
+PUBLIC BOOL ech_serdes_cdr_integ_gain_set(UINT8 integ_gain)
+{
+    return (integ_gain < 16);
+}
+
+PUBLIC UINT32 SERDES_FH_CDR_Offset_Force_Offset(UINT8 lane_bitmask, INT8 cdr_index_offset, UINT8 * applied_bitmask)
+{
+    *applied_bitmask = lane_bitmask;
+
+    return PMC_SUCCESS;
+}
+
+PUBLIC UINT32 serdes_api_fuse_val_stat_1_read(VOID)
+{
+    return 0;
+}
+
+PUBLIC VOID serdes_plat_cal_disable(BOOL cal_disable)
+{
+}
+
+PUBLIC VOID serdes_plat_ffe_precursor_set(UINT32 precursor)
+{
+}
+
+PUBLIC VOID serdes_plat_ffe_postcursor_set(UINT32 postcursor)
+{
+}
+
+PUBLIC VOID serdes_plat_ffe_calibration_set(UINT32 calibration)
+{
+}
+
+/* Records read over TWI */
+
+PUBLIC UINT32 ech_trace_read_start(ech_trace_cursor_struct *cursor_ptr)
+{
+    memset(cursor_ptr, 0, sizeof(*cursor_ptr));
+
+    return HOST_ECH_TRACE_SIZE;
+}
+
+PUBLIC UINT32 ech_trace_read(ech_trace_cursor_struct *cursor_ptr, UINT32 offset, UINT8 *buf_ptr, UINT32 len)
+{
+    return host_ech_record_read(HOST_ECH_TRACE_SIZE, offset, buf_ptr, len);
+}
+
+PUBLIC UINT32 ech_stats_read_start(ech_stats_cursor_struct *cursor_ptr)
+{
+    memset(cursor_ptr, 0, sizeof(*cursor_ptr));
+
+    return HOST_ECH_STATS_SIZE;
+}
+
+PUBLIC UINT32 ech_stats_read(ech_stats_cursor_struct *cursor_ptr, UINT32 offset, UINT8 *buf_ptr, UINT32 len)
+{
+    return host_ech_record_read(HOST_ECH_STATS_SIZE, offset, buf_ptr, len);
+}
+
+PUBLIC VOID ech_stats_clear(VOID)
+{
+}
+
+PUBLIC UINT32 ech_telemetry_snapshot_build(UINT8 *buf_ptr, UINT32 len)
+{
+    return host_ech_record_read(HOST_ECH_TELEMETRY_SIZE, 0, buf_ptr, len);
+}
+
+PUBLIC UINT32 app_fw_boot_prof_get(app_fw_boot_prof_struct *prof_ptr)
+{
+    memset(prof_ptr, 0, sizeof(*prof_ptr));
+
+    return sizeof(*prof_ptr);
+}
+
+PUBLIC UINT32 char_io_loc_buffer_info_get(UINT8 channel_id, void **addr_pptr)
+{
+    *addr_pptr = host_ech_heap;
+
+    return HOST_ECH_LOG_SIZE;
+}
+
+PUBLIC void* char_io_ccb_ctrl_get(UINT8 channel_id)
+{
+    return &host_ech_log_rd;
+}
+
+PUBLIC UINT32 ccb_get(void *ccb_ctrl_ptr, CHAR *dst_ptr, UINT32 num_bytes_requested)
+{
+    UINT32 len = host_ech_record_read(HOST_ECH_LOG_SIZE, host_ech_log_rd, (UINT8 *)dst_ptr, num_bytes_requested);
+
+    host_ech_log_rd += len;
+
+    return len;
+}
+
+/* Trace, log channels and the rest of the run time */
+
+PUBLIC VOID ech_trace_rx(UINT8 src, UINT8 cmd_id, UINT16 req_id, UINT32 t_rx)
+{
+}
+
+PUBLIC VOID ech_trace_defer(VOID)
+{
+}
+
+PUBLIC VOID ech_trace_dispatch(UINT8 src)
+{
+    if (ECH_TRACE_SRC_TWI == src)
+    {
+        host_ech_twi_dispatches++;
+    }
+}
+
+PUBLIC VOID ech_trace_return(UINT8 src)
+{
+}
+
+PUBLIC VOID ech_trace_done(UINT8 src, UINT32 ext_data_len, UINT32 rc)
+{
+}
+
+PUBLIC UINT8 log_chan_enter(UINT8 chan)
+{
+    return 0;
+}
+
+PUBLIC VOID log_chan_exit(UINT8 prev_chan)
+{
+}
+
+PUBLIC UINT8 log_chan_oc_cmd_chan_get(UINT8 cmd_id)
+{
+    return 0;
+}
+
+PUBLIC UINT8 log_chan_twi_cmd_chan_get(UINT8 cmd_id)
+{
+    return 0;
+}
+
+PUBLIC VOID app_fw_sched_task_ready(app_fw_sched_task_enum task_id)
+{
+    HOST_CHECK(APP_FW_SCHED_TASK_TWI_DEFERRED == task_id);
+    host_ech_twi_deferred = TRUE;
+}
+
+PUBLIC VOID wdt_hardware_tmr_kick(VOID)
+{
+}
+
+PUBLIC UINT32 hal_cp0_counter_get(VOID)
+{
+    return (UINT32)host_cycles();
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Reset the host side and the parser state, and map the register
+*   windows on the first call.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_ech_reset(VOID)
+{
+    static BOOL mapped = FALSE;
+
+    if (FALSE == mapped)
+    {
+        host_ech_reg_mapped = host_ech_reg_win_map(HOST_ECH_OCMB_REG_ADDR) &&
+                              host_ech_reg_win_map(HOST_ECH_REG_ADDR);
+        mapped = TRUE;
+    }
+
+    host_ech_twi_wr_pending = FALSE;
+    host_ech_twi_wr_len = 0;
+    host_ech_twi_rsp_len = 0;
+    host_ech_twi_rsps = 0;
+    host_ech_twi_deferred = FALSE;
+    host_ech_doorbell = FALSE;
+    host_ech_rsps = 0;
+    host_ech_latched_reg_addr = 0;
+    host_ech_ext_err_code = 0;
+    host_ech_log_rd = 0;
+    host_ech_twi_dispatches = 0;
+    host_ech_heap_used = 0;
+    memset(&host_ech_cmd, 0, sizeof(host_ech_cmd));
+    memset(&host_ech_rsp, 0, sizeof(host_ech_rsp));
+
+    /* parser state of ech_twi_common.c */
+    ech_twi_rx_len = 0;
+    ech_twi_rx_index = 0;
+    memset(&ech_def_handler, 0, sizeof(ech_def_handler));
+
+    ech_oc_init();
+}
+
+/**
+* @brief
+*   Check whether the register windows are mapped. If not, every register
+*   access of a TWI command fails its address check.
+*
+* @return
+*   TRUE if mapped.
+*/
+PUBLIC BOOL host_ech_reg_win_mapped(VOID)
+{
+    return host_ech_reg_mapped;
+}
+
+/**
+* @brief
+*   Write to the TWI slave port. The firmware receives the data at its
+*   next poll, a write not yet received is replaced.
+*
+* @param[in] data_ptr - data
+* @param[in] len      - length, up to EXP_TWI_MAX_BUF_SIZE
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_ech_twi_write(const UINT8 *data_ptr, UINT32 len)
+{
+    PMCFW_ASSERT(len <= EXP_TWI_MAX_BUF_SIZE, PMCFW_ERR_NUMBER_OUT_OF_RANGE);
+
+    memcpy(host_ech_twi_wr, data_ptr, len);
+    host_ech_twi_wr_len = len;
+    host_ech_twi_wr_pending = TRUE;
+}
+
+/**
+* @brief
+*   Read the last TWI response.
+*
+* @param[out] buf_ptr - destination, may be NULL
+* @param[in]  len     - size of the destination
+*
+* @return
+*   Length of the response.
+*/
+PUBLIC UINT32 host_ech_twi_rsp_get(UINT8 *buf_ptr, UINT32 len)
+{
+    if (NULL != buf_ptr)
+    {
+        memcpy(buf_ptr, host_ech_twi_rsp, (len < host_ech_twi_rsp_len) ? len : host_ech_twi_rsp_len);
+    }
+
+    return host_ech_twi_rsp_len;
+}
+
+/**
+* @brief
+*   Number of TWI responses put since the reset.
+*
+* @return
+*   Count
+*/
+PUBLIC UINT32 host_ech_twi_rsp_count(VOID)
+{
+    return host_ech_twi_rsps;
+}
+
+/**
+* @brief
+*   Number of TWI commands the parser dispatched since the reset.
+*
+* @return
+*   Count
+*/
+PUBLIC UINT32 host_ech_twi_dispatch_count(VOID)
+{
+    return host_ech_twi_dispatches;
+}
+
+/**
+* @brief
+*   Run a deferred TWI command as app_fw_twi_deferred_task() does on VPE0,
+*   if one was signalled.
+*
+* @return
+*   TRUE if a command was run.
+*/
+PUBLIC BOOL host_ech_twi_deferred_run(VOID)
+{
+    if (FALSE == host_ech_twi_deferred)
+    {
+        return FALSE;
+    }
+    host_ech_twi_deferred = FALSE;
+
+    HOST_CHECK(TRUE == ech_def_handler.deferred_cmd_flag);
+    HOST_CHECK((NULL != ech_def_handler.cmd_buf) &&
+               (NULL != ech_def_handler.deferred_cmd_handler) &&
+               (NULL != ech_def_handler.callback_handler));
+    if ((NULL == ech_def_handler.cmd_buf) ||
+        (NULL == ech_def_handler.deferred_cmd_handler) ||
+        (NULL == ech_def_handler.callback_handler))
+    {
+        return FALSE;
+    }
+
+    ech_def_handler.callback_handler((*ech_def_handler.deferred_cmd_handler)(ech_def_handler.cmd_buf, ech_def_handler.cmd_buf_idx));
+    ech_def_handler.cmd_buf = NULL;
+    ech_def_handler.deferred_cmd_handler = NULL;
+    ech_def_handler.callback_handler = NULL;
+    ech_def_handler.deferred_cmd_flag = FALSE;
+
+    return TRUE;
+}
+
+/**
+* @brief
+*   Command buffer the host writes OpenCAPI commands to.
+*
+* @return
+*   Pointer to the command
+*/
+PUBLIC exp_cmd_struct *host_ech_oc_cmd_ptr(VOID)
+{
+    return &host_ech_cmd;
+}
+
+/**
+* @brief
+*   Extended data buffer of the OpenCAPI commands and responses.
+*
+* @return
+*   Pointer to HOST_ECH_EXT_DATA_SIZE bytes
+*/
+PUBLIC UINT8 *host_ech_oc_ext_data_ptr(VOID)
+{
+    return host_ech_ext_data;
+}
+
+/**
+* @brief
+*   Ring the doorbell of a command written to the command buffer.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_ech_oc_doorbell(VOID)
+{
+    host_ech_doorbell = TRUE;
+}
+
+/**
+* @brief
+*   Number of OpenCAPI responses sent since the reset.
+*
+* @return
+*   Count
+*/
+PUBLIC UINT32 host_ech_oc_rsp_count(VOID)
+{
+    return host_ech_rsps;
+}
+
+/**
+* @brief
+*   Response buffer of the OpenCAPI commands.
+*
+* @return
+*   Pointer to the response
+*/
+PUBLIC exp_rsp_struct *host_ech_oc_rsp_ptr(VOID)
+{
+    return &host_ech_rsp;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,438 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   RAM model of the SPI flash behind the spi_flash API, the platform
+*   erase and checked read functions. Addresses
+*   are masked with GPBC_FLASH_PHYS_ADDR_MASK, so virtual and physical
+*   flash addresses both work.
+*/
+
+/*
+** Include Files
+*/
+
+#include <string.h>
+#include "pmcfw_common.h"
+#include "pmc_hw_base.h"
+#include "spi_flash_api.h"
+#include "spi_flash_plat.h"
+#include "host_test.h"
+#include "host_flash.h"
+
+/*
+** Local Constants
+*/
+
+#define HOST_FLASH_PAGES        (HOST_FLASH_SIZE / HOST_FLASH_PAGE_SIZE)
+
+/* page states */
+#define HOST_FLASH_ERASED       0
+#define HOST_FLASH_PROGRAMMED   1
+#define HOST_FLASH_TORN         2
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT8 host_flash_data[HOST_FLASH_SIZE];
+PRIVATE UINT8 host_flash_state[HOST_FLASH_PAGES];
+PRIVATE UINT32 host_flash_ops = 0;
+PRIVATE UINT32 host_flash_cut = HOST_FLASH_NO_CUT;
+PRIVATE BOOL host_flash_off = FALSE;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Convert a flash address to an offset into the model.
+*
+* @param[in] addr_ptr - virtual or physical flash address
+* @param[in] len      - access length
+*
+* @return
+*   Offset, the access must be within the model.
+*/
+PRIVATE UINT32 host_flash_offset(const UINT8 *addr_ptr, UINT32 len)
+{
+    UINT32 offset = (UINT32)(uintptr_t)addr_ptr & GPBC_FLASH_PHYS_ADDR_MASK;
+
+    PMCFW_ASSERT((offset < HOST_FLASH_SIZE) && (len <= (HOST_FLASH_SIZE - offset)),
+                 PMCFW_ERR_INVALID_PARAMETERS);
+
+    return offset;
+}
+
+/**
+* @brief
+*   Count an erase or program operation and apply the power cut.
+*
+* @return
+*   TRUE if the operation completes, FALSE if it is torn by the power cut.
+*/
+PRIVATE BOOL host_flash_op(VOID)
+{
+    host_flash_ops++;
+
+    if (0 == host_flash_cut)
+    {
+        host_flash_cut = HOST_FLASH_NO_CUT;
+        host_flash_off = TRUE;
+        return FALSE;
+    }
+    if (HOST_FLASH_NO_CUT != host_flash_cut)
+    {
+        host_flash_cut--;
+    }
+
+    return TRUE;
+}
+
+/**
+* @brief
+*   Erase one subsector, or tear the erase.
+*
+* @param[in] offset - offset within the subsector
+*
+* @return
+*   PMC_SUCCESS, HOST_FLASH_ERR_POWER if the power is or goes off.
+*/
+PRIVATE PMCFW_ERROR host_flash_subsector_erase(UINT32 offset)
+{
+    UINT32 base = offset & ~(HOST_FLASH_SUBSECTOR_SIZE - 1);
+    UINT32 i;
+
+    if (TRUE == host_flash_off)
+    {
+        return HOST_FLASH_ERR_POWER;
+    }
+
+    if (FALSE == host_flash_op())
+    {
+        /* part of the subsector is erased, the rest keeps stale data without valid ECC */
+        for (i = 0; i < HOST_FLASH_SUBSECTOR_SIZE; i++)
+        {
+            if (0 == (host_rand() & 1))
+            {
+                host_flash_data[base + i] = 0xFF;
+            }
+        }
+        memset(&host_flash_state[base / HOST_FLASH_PAGE_SIZE], HOST_FLASH_TORN, HOST_FLASH_SUBSECTOR_SIZE / HOST_FLASH_PAGE_SIZE);
+        return HOST_FLASH_ERR_POWER;
+    }
+
+    memset(&host_flash_data[base], 0xFF, HOST_FLASH_SUBSECTOR_SIZE);
+    memset(&host_flash_state[base / HOST_FLASH_PAGE_SIZE], HOST_FLASH_ERASED, HOST_FLASH_SUBSECTOR_SIZE / HOST_FLASH_PAGE_SIZE);
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Program part of one page, or tear the program.
+*
+* @param[in] src_ptr - data
+* @param[in] offset  - offset of the data
+* @param[in] len     - length, within the page
+*
+* @return
+*   PMC_SUCCESS, HOST_FLASH_ERR_POWER if the power is or goes off.
+*/
+PRIVATE PMCFW_ERROR host_flash_page_program(const UINT8 *src_ptr, UINT32 offset, UINT32 len)
+{
+    UINT32 page = offset / HOST_FLASH_PAGE_SIZE;
+
+    if (TRUE == host_flash_off)
+    {
+        return HOST_FLASH_ERR_POWER;
+    }
+
+    /* ECC does not allow a page to be programmed twice */
+    HOST_CHECK(HOST_FLASH_ERASED == host_flash_state[page]);
+
+    if (FALSE == host_flash_op())
+    {
+        memcpy(&host_flash_data[offset], src_ptr, host_rand() % len);
+        host_flash_state[page] = HOST_FLASH_TORN;
+        return HOST_FLASH_ERR_POWER;
+    }
+
+    memcpy(&host_flash_data[offset], src_ptr, len);
+    host_flash_state[page] = HOST_FLASH_PROGRAMMED;
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Check whether every page of a range holds valid ECC.
+*
+* @param[in] offset - offset of the range
+* @param[in] len    - length of the range
+*
+* @return
+*   TRUE if every page of the range is programmed.
+*/
+PRIVATE BOOL host_flash_range_programmed(UINT32 offset, UINT32 len)
+{
+    UINT32 page;
+
+    for (page = offset / HOST_FLASH_PAGE_SIZE; (len > 0) && (page <= ((offset + len - 1) / HOST_FLASH_PAGE_SIZE)); page++)
+    {
+        if (HOST_FLASH_PROGRAMMED != host_flash_state[page])
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+** Firmware Replacements
+*/
+
+PRIVATE PMCFW_ERROR host_flash_dev_info_get(UINT8 port_id, UINT8 cs_id, spi_flash_dev_enum *dev_ptr, spi_flash_dev_info_struct *dev_info_ptr)
+{
+    memset(dev_info_ptr, 0, sizeof(*dev_info_ptr));
+    dev_info_ptr->sectors = HOST_FLASH_SIZE / (64 * 1024);
+    dev_info_ptr->subsectors_per_sector = (64 * 1024) / HOST_FLASH_SUBSECTOR_SIZE;
+    dev_info_ptr->pages_per_subsector = HOST_FLASH_SUBSECTOR_SIZE / HOST_FLASH_PAGE_SIZE;
+    dev_info_ptr->page_size = HOST_FLASH_PAGE_SIZE;
+
+    return PMC_SUCCESS;
+}
+
+PRIVATE PMCFW_ERROR host_flash_write_pages(UINT8 port_id, UINT8 cs_id, UINT8 *src_ptr, UINT8 *dst_ptr, UINT32 len, UINT32 page_size, UINT32 timeout)
+{
+    UINT32 offset = host_flash_offset(dst_ptr, len);
+    UINT32 count;
+    PMCFW_ERROR rc;
+
+    while (len > 0)
+    {
+        count = HOST_FLASH_PAGE_SIZE - (offset % HOST_FLASH_PAGE_SIZE);
+        if (count > len)
+        {
+            count = len;
+        }
+
+        rc = host_flash_page_program(src_ptr, offset, count);
+        if (PMC_SUCCESS != rc)
+        {
+            return rc;
+        }
+
+        src_ptr += count;
+        offset += count;
+        len -= count;
+    }
+
+    return PMC_SUCCESS;
+}
+
+PRIVATE PMCFW_ERROR host_flash_read(UINT8 port_id, UINT8 cs_id, const UINT8 *src_ptr, UINT8 *dst_ptr, UINT32 len)
+{
+    UINT32 offset = host_flash_offset(src_ptr, len);
+
+    /* an uncorrectable ECC error asserts on the target */
+    HOST_CHECK(TRUE == host_flash_range_programmed(offset, len));
+    memcpy(dst_ptr, &host_flash_data[offset], len);
+
+    return PMC_SUCCESS;
+}
+
+PRIVATE PMCFW_ERROR host_flash_subsector_params_get(UINT8 port_id, UINT8 cs_id, const UINT8 *addr_ptr, UINT8 **sector_ptr, UINT32 *len)
+{
+    UINT32 offset = host_flash_offset(addr_ptr, 1);
+
+    *sector_ptr = (UINT8 *)(uintptr_t)(offset & ~(HOST_FLASH_SUBSECTOR_SIZE - 1));
+    *len = HOST_FLASH_SUBSECTOR_SIZE;
+
+    return PMC_SUCCESS;
+}
+
+PRIVATE PMCFW_ERROR host_flash_subsector_erase_wait(UINT8 port_id, UINT8 cs_id, UINT8 *addr_ptr, UINT32 timeout)
+{
+    return host_flash_subsector_erase(host_flash_offset(addr_ptr, 1));
+}
+
+PUBLIC spi_flash_dev_info_get_fn_ptr_type spi_flash_dev_info_get_fn_ptr = host_flash_dev_info_get;
+PUBLIC spi_flash_write_pages_fn_ptr_type spi_flash_write_pages_fn_ptr = host_flash_write_pages;
+PUBLIC spi_flash_read_fn_ptr_type spi_flash_read_fn_ptr = host_flash_read;
+PUBLIC spi_flash_subsector_params_get_fn_ptr_type spi_flash_subsector_params_get_fn_ptr = host_flash_subsector_params_get;
+PUBLIC spi_flash_subsector_erase_wait_fn_ptr_type spi_flash_subsector_erase_wait_fn_ptr = host_flash_subsector_erase_wait;
+
+/**
+* @brief
+*   Erase whole subsectors, see spi_flash_plat.c.
+*
+* @param[in] spi_flash_addr_ptr - subsector aligned flash address
+* @param[in] num_bytes          - multiple of the subsector size
+*
+* @return
+*   PMC_SUCCESS, HOST_FLASH_ERR_POWER if the power is or goes off.
+*/
+PUBLIC PMCFW_ERROR spi_flash_plat_erase(UINT8* spi_flash_addr_ptr, UINT32 num_bytes)
+{
+    UINT32 offset = host_flash_offset(spi_flash_addr_ptr, num_bytes);
+    PMCFW_ERROR rc;
+
+    HOST_CHECK((0 == (offset % HOST_FLASH_SUBSECTOR_SIZE)) && (0 == (num_bytes % HOST_FLASH_SUBSECTOR_SIZE)));
+
+    for ( ; num_bytes > 0; num_bytes -= HOST_FLASH_SUBSECTOR_SIZE, offset += HOST_FLASH_SUBSECTOR_SIZE)
+    {
+        rc = host_flash_subsector_erase(offset);
+        if (PMC_SUCCESS != rc)
+        {
+            return rc;
+        }
+    }
+
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   Read flash that may not be written, see spi_flash_plat.c.
+*
+* @param[out] dst_ptr            - destination buffer
+* @param[in]  spi_flash_addr_ptr - flash address
+* @param[in]  num_bytes          - number of bytes
+*
+* @return
+*   TRUE if every page read holds valid ECC.
+*/
+PUBLIC BOOL spi_flash_plat_checked_read(UINT8* dst_ptr, UINT8* spi_flash_addr_ptr, UINT32 num_bytes)
+{
+    UINT32 offset = host_flash_offset(spi_flash_addr_ptr, num_bytes);
+
+    memcpy(dst_ptr, &host_flash_data[offset], num_bytes);
+
+    return host_flash_range_programmed(offset, num_bytes);
+}
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Power up the model with the whole flash erased.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_flash_reset(VOID)
+{
+    memset(host_flash_data, 0xFF, sizeof(host_flash_data));
+    memset(host_flash_state, HOST_FLASH_ERASED, sizeof(host_flash_state));
+    host_flash_ops = 0;
+    host_flash_cut = HOST_FLASH_NO_CUT;
+    host_flash_off = FALSE;
+}
+
+/**
+* @brief
+*   Arm a power cut.
+*
+* @param[in] ops - number of operations that complete before the one
+*                  which is torn, HOST_FLASH_NO_CUT to disarm
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_flash_power_cut_set(UINT32 ops)
+{
+    host_flash_cut = ops;
+}
+
+/**
+* @brief
+*   Restore the power after a cut. Flash contents are kept.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_flash_power_on(VOID)
+{
+    host_flash_cut = HOST_FLASH_NO_CUT;
+    host_flash_off = FALSE;
+    host_critical_region_reset();
+}
+
+/**
+* @brief
+*   Check whether an armed power cut has happened.
+*
+* @return
+*   TRUE if the power is off.
+*/
+PUBLIC BOOL host_flash_power_is_off(VOID)
+{
+    return host_flash_off;
+}
+
+/**
+* @brief
+*   Number of erase and program operations since host_flash_reset().
+*
+* @return
+*   Operation count.
+*/
+PUBLIC UINT32 host_flash_op_count(VOID)
+{
+    return host_flash_ops;
+}
+
+/**
+* @brief
+*   Check whether the page holding an address is programmed.
+*
+* @param[in] addr - flash address
+*
+* @return
+*   TRUE if the page holds valid ECC.
+*/
+PUBLIC BOOL host_flash_page_is_programmed(UINT32 addr)
+{
+    return host_flash_range_programmed(host_flash_offset((UINT8 *)(uintptr_t)addr, 1), 1);
+}
+
+/**
+* @brief
+*   Flip a bit of programmed flash, the ECC still reads it as valid.
+*
+* @param[in] addr - flash address
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_flash_corrupt(UINT32 addr)
+{
+    host_flash_data[host_flash_offset((UINT8 *)(uintptr_t)addr, 1)] ^= 0x01;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,399 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host replacements of the firmware run time: asserts, console output,
+*   the boot ROM CRC32, the critical region and the test helpers of
+*   host_test.h.
+*
+* @note
+*   Console output of the modules under test is dropped unless HOST_VERBOSE
+*   is set in the environment.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include "pmcfw_common.h"
+#include "bc_printf.h"
+#include "crc32_api.h"
+#include "cmdsvr_func_api.h"
+#include "top_plat.h"
+#include "host_test.h"
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT32 host_fail_count = 0;
+PRIVATE UINT32 host_check_count = 0;
+PRIVATE UINT32 host_rand_state = 0x2545F491;
+
+/* Circular console log and its counters */
+PRIVATE CHAR host_log_ring[HOST_LOG_SIZE];
+PRIVATE UINT32 host_log_wr = 0;
+PRIVATE UINT32 host_log_msgs = 0;
+PRIVATE UINT32 host_log_bytes = 0;
+PRIVATE INT32 host_log_verbose = -1;
+
+/* Critical region entered, regions do not nest */
+PRIVATE BOOL host_locked = FALSE;
+
+/*
+** Public Functions
+*/
+
+/**
+* @brief
+*   Firmware assert. Fatal on the host, a fuzzer reports it as a crash.
+*
+* @param[in] error_code - error code of the assert
+* @param[in] file_ptr   - source file
+* @param[in] line       - source line
+*
+* @return
+*   Does not return.
+*/
+PUBLIC VOID pmcfw_assert_function(PMCFW_ERROR error_code, CHAR *file_ptr, UINT32 line)
+{
+    fprintf(stderr, "PMCFW_ASSERT 0x%08x at %s:%u\n", (unsigned)error_code, file_ptr, (unsigned)line);
+    abort();
+}
+
+/**
+* @brief
+*   Console output of the modules under test. Like the firmware, each
+*   message is formatted and copied into a circular log, whose size is
+*   that of the firmware log.
+*
+* @param[in] format - printf format
+*
+* @return
+*   Number of characters formatted.
+*/
+PUBLIC UINT32 bc_printf(const CHAR *format, ...)
+{
+    CHAR line[HOST_LOG_LINE_MAX];
+    va_list args;
+    INT32 len;
+    UINT32 count;
+    UINT32 i;
+
+    va_start(args, format);
+    len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (len < 0)
+    {
+        return 0;
+    }
+
+    count = ((UINT32)len < sizeof(line)) ? (UINT32)len : (sizeof(line) - 1);
+    for (i = 0; i < count; i++)
+    {
+        host_log_ring[host_log_wr] = line[i];
+        host_log_wr = (host_log_wr + 1) % HOST_LOG_SIZE;
+    }
+    host_log_msgs++;
+    host_log_bytes += (UINT32)len;
+
+    if (host_log_verbose < 0)
+    {
+        host_log_verbose = (NULL != getenv("HOST_VERBOSE")) ? 1 : 0;
+    }
+    if (0 != host_log_verbose)
+    {
+        fputs(line, stdout);
+    }
+
+    return (UINT32)len;
+}
+
+/**
+* @brief
+*   Messages and bytes logged by bc_printf().
+*
+* @param[out] msgs_ptr  - number of messages
+* @param[out] bytes_ptr - number of bytes
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_log_stats_get(UINT32 *msgs_ptr, UINT32 *bytes_ptr)
+{
+    *msgs_ptr = host_log_msgs;
+    *bytes_ptr = host_log_bytes;
+}
+
+/**
+* @brief
+*   Clear the bc_printf() counters.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_log_stats_reset(VOID)
+{
+    host_log_msgs = 0;
+    host_log_bytes = 0;
+}
+
+/**
+* @brief
+*   Command server registration, commands are not run on the host.
+*
+* @param[in] func_list - commands
+* @param[in] num_cmds  - number of commands
+*
+* @return
+*   PMC_SUCCESS
+*/
+PUBLIC PMCFW_ERROR cmdsvr_func_list_register(const cmdsvr_cmd_def_struct * const func_list,
+                                             const UINT32 num_cmds)
+{
+    return PMC_SUCCESS;
+}
+
+/**
+* @brief
+*   CRC32 (IEEE 802.3, reflected) of the boot ROM, which may be computed
+*   over several calls.
+*
+* @param[in] msg_ptr   - data
+* @param[in] byte_cnt  - number of bytes
+* @param[in] oldchksum - seed if init, else the result of the previous call
+* @param[in] init      - first call of a sequence
+* @param[in] last      - last call of a sequence
+*
+* @return
+*   CRC32, or the intermediate value if not last.
+*
+* @note
+*   Table driven, so benchmarks of CRC checked commands measure the
+*   command and not a bitwise CRC.
+*/
+PRIVATE UINT32 host_crc32(const UINT8 *msg_ptr, UINT32 byte_cnt, UINT32 oldchksum, BOOL init, BOOL last)
+{
+    static UINT32 table[256];
+    UINT32 crc;
+    UINT32 i;
+    UINT32 j;
+
+    if (0 == table[1])
+    {
+        for (i = 0; i < 256; i++)
+        {
+            crc = i;
+            for (j = 0; j < 8; j++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+            table[i] = crc;
+        }
+    }
+
+    crc = (TRUE == init) ? ~oldchksum : oldchksum;
+    while (byte_cnt-- > 0)
+    {
+        crc = (crc >> 8) ^ table[(crc ^ *msg_ptr++) & 0xFF];
+    }
+
+    return (TRUE == last) ? ~crc : crc;
+}
+
+PUBLIC pmc_crc32_fn_ptr_type pmc_crc32_fn_ptr = host_crc32;
+
+PUBLIC void top_plat_critical_region_enter(top_plat_lock_struct * lock_struct_ptr)
+{
+    HOST_CHECK(FALSE == host_locked);
+    host_locked = TRUE;
+}
+
+PUBLIC void top_plat_critical_region_exit(top_plat_lock_struct lock_struct)
+{
+    HOST_CHECK(TRUE == host_locked);
+    host_locked = FALSE;
+}
+
+/**
+* @brief
+*   Leave the critical region, when a test abandons code inside it.
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_critical_region_reset(VOID)
+{
+    host_locked = FALSE;
+}
+
+/**
+* @brief
+*   Record the result of a check.
+*
+* @param[in] cond     - check result
+* @param[in] expr_ptr - checked expression
+* @param[in] file_ptr - source file
+* @param[in] line     - source line
+*
+* @return
+*   cond
+*/
+PUBLIC BOOL host_check(BOOL cond, const CHAR *expr_ptr, const CHAR *file_ptr, UINT32 line)
+{
+    host_check_count++;
+    if (!cond)
+    {
+        host_fail_count++;
+        printf("  FAIL %s:%u: %s\n", file_ptr, (unsigned)line, expr_ptr);
+    }
+
+    return cond;
+}
+
+/**
+* @brief
+*   Print the result of a test.
+*
+* @param[in] name_ptr - test name
+*
+* @return
+*   Exit code of the test, 0 if every check passed.
+*/
+PUBLIC INT32 host_test_result(const CHAR *name_ptr)
+{
+    printf("%s: %s, %u checks, %u failed\n",
+           name_ptr,
+           (0 == host_fail_count) ? "PASS" : "FAIL",
+           (unsigned)host_check_count,
+           (unsigned)host_fail_count);
+
+    return ((0 == host_fail_count) ? 0 : 1);
+}
+
+/**
+* @brief
+*   Monotonic time for benchmarks.
+*
+* @return
+*   Time in ns.
+*/
+PUBLIC UINT64 host_time_ns(VOID)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((UINT64)ts.tv_sec * 1000000000ULL) + (UINT64)ts.tv_nsec;
+}
+
+/**
+* @brief
+*   CPU cycle counter for benchmarks, the time stamp counter on x86 and
+*   ns elsewhere.
+*
+* @return
+*   Cycles.
+*/
+PUBLIC UINT64 host_cycles(VOID)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return host_time_ns();
+#endif
+}
+
+/**
+* @brief
+*   Seed the test random number generator, so failures can be reproduced.
+*
+* @param[in] seed - seed, 0 is replaced by the default seed
+*
+* @return
+*   Nothing
+*/
+PUBLIC VOID host_srand(UINT32 seed)
+{
+    host_rand_state = (0 == seed) ? 0x2545F491 : seed;
+}
+
+/**
+* @brief
+*   Test random number generator (xorshift32).
+*
+* @return
+*   Next random number.
+*/
+PUBLIC UINT32 host_rand(VOID)
+{
+    host_rand_state ^= host_rand_state << 13;
+    host_rand_state ^= host_rand_state >> 17;
+    host_rand_state ^= host_rand_state << 5;
+
+    return host_rand_state;
+}
+
+/**
+* @brief
+*   Read a whole file.
+*
+* @param[in]  path_ptr - file name
+* @param[out] len_ptr  - file length
+*
+* @return
+*   File contents, allocated with malloc(), or NULL if it can not be read.
+*/
+PUBLIC UINT8 *host_file_read(const CHAR *path_ptr, UINT32 *len_ptr)
+{
+    FILE *f = fopen(path_ptr, "rb");
+    UINT8 *buf_ptr = NULL;
+    long len;
+
+    if (NULL == f)
+    {
+        return NULL;
+    }
+
+    if ((0 == fseek(f, 0, SEEK_END)) && ((len = ftell(f)) >= 0) && (0 == fseek(f, 0, SEEK_SET)))
+    {
+        buf_ptr = malloc((size_t)len + 1);
+        if ((NULL != buf_ptr) && ((size_t)len != fread(buf_ptr, 1, (size_t)len, f)))
+        {
+            free(buf_ptr);
+            buf_ptr = NULL;
+        }
+        *len_ptr = (UINT32)len;
+    }
+    fclose(f);
+
+    return buf_ptr;
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+
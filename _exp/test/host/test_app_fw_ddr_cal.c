@@ -0,0 +1,707 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Power fail test of the saved DDR PHY calibration slots of app_fw_ddr.c
+*   on the RAM flash model.
+*
+* @note
+*   The save and the reload are compiled out of the default build
+*   (EXPLORER_DDR_TRAIN_PARMS_SAVE_DISABLE, APP_FW_DISABLE_DDR_SPI_RELOAD),
+*   the test enables both and includes app_fw_ddr.c to reach the slot
+*   functions.
+*
+*   A reference run saves a series of calibrations, one per boot, and
+*   counts the flash operations of each save. The series is then repeated
+*   with the power cut at every erase and page program of every save.
+*   After each cut the next boot must find the calibration of the save
+*   before, with its generation, and load it; a save on that boot must
+*   then become the newest. Corrupted slots must fall back to the other
+*   slot.
+*
+*   app_fw_ddr_phy_bringup_init() is then run over a series of boots with
+*   the training inputs changed between them. The PHY calls are recorded:
+*   unchanged inputs restore the saved results, changed drive or Vref
+*   inputs restore the saved 1D timing and rerun training with 2D, and
+*   changed rank or frequency inputs train fully. The DFI BIST check of
+*   restored results must visit the addresses in order, fall back to full
+*   training at the first run with word errors, and stop when its time
+*   budget runs out without failing.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "pmc_profile.h"
+#include "app_fw.h"
+#include "host_test.h"
+#include "host_flash.h"
+
+/* build the save and the reload of the calibration */
+#undef EXPLORER_DDR_TRAIN_PARMS_SAVE_DISABLE
+#define EXPLORER_DDR_TRAIN_PARMS_SAVE_DISABLE   0
+#undef APP_FW_DISABLE_DDR_SPI_RELOAD
+#define APP_FW_DISABLE_DDR_SPI_RELOAD           0
+
+#include "app_fw_ddr.c"
+
+/*
+** Local Constants
+*/
+
+/* Saves per run, a few more than the slots so each slot is written over */
+#define TEST_SAVES                  5
+
+/* ddr_phy_init() arguments */
+#define TEST_PHY_INIT_ARGS          5
+
+/* DFI BIST runs of a restore check of all ranks */
+#define TEST_BIST_RUNS_MAX          (APP_FW_DDR_VERIFY_NUM_CS * APP_FW_DDR_VERIFY_NUM_BG * APP_FW_DDR_VERIFY_NUM_POINTS)
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Path taken by app_fw_ddr_phy_bringup_init().
+*/
+typedef enum
+{
+    TEST_BRINGUP_RESTORE,       /**< Saved results restored */
+    TEST_BRINGUP_RETRAIN_2D,    /**< Saved timing restored, trained with 2D */
+    TEST_BRINGUP_FULL,          /**< Fully trained */
+} test_bringup_enum;
+
+/**
+* @brief
+*   PHY calls made by a bringup.
+*/
+typedef struct
+{
+    UINT32 restore_calls;                       /**< ddr_api_saved_margin_results_load() */
+    UINT32 restore_seed;                        /**< Timing it was given */
+    UINT32 phy_init_calls;                      /**< ddr_phy_init() */
+    UINT32 phy_init_args[TEST_PHY_INIT_ARGS];   /**< Its arguments */
+    UINT32 phy_init_seed;                       /**< ddrTimingData it started from */
+    UINT32 train_calls;                         /**< ddr_api_fw_train() */
+    UINT32 bist_runs;                           /**< ddrRunBistSequence() */
+    ddr_bist_setup_t bist_setup;                /**< Last ddrBistSetup() */
+    ddr_bist_setup_t bist[TEST_BIST_RUNS_MAX];  /**< Setup of each run */
+} test_calls_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE app_fw_ddr_calibration_data_struct test_data[TEST_SAVES];
+PRIVATE app_fw_ddr_calibration_data_struct test_loaded;
+PRIVATE UINT32 test_ops[TEST_SAVES];
+PRIVATE CHAR test_boot_partition = 'A';
+PRIVATE test_calls_struct test_calls;
+
+/* Timing results of the next training, told apart by their seed */
+PRIVATE UINT32 test_timing_seed;
+
+/* DFI BIST run with word errors, 0 for none, and the time each run takes */
+PRIVATE UINT32 test_bist_fail_run;
+PRIVATE UINT32 test_bist_run_us;
+PRIVATE UINT32 test_counter;
+
+/*
+** Firmware Stubs
+*/
+
+PUBLIC ddr_timing_data_t ddrTimingData;
+PUBLIC user_input_msdg_t user_input_msdg_array[DDR_PHY_NUM_USER_INPUT_MSDG_CONFIG];
+
+PRIVATE UINT_TIME test_count_to_us(UINT_TIME count)
+{
+    return count;
+}
+
+PUBLIC sys_timer_count_to_us_fn_ptr_type sys_timer_count_to_us_fn_ptr = test_count_to_us;
+
+PUBLIC UINT32 hal_cp0_counter_get(VOID)
+{
+    return test_counter;
+}
+
+PUBLIC UINT32 flash_partition_boot_partition_id_get(VOID)
+{
+    return (UINT32)test_boot_partition;
+}
+
+PUBLIC uint32_t ddrBistInit(uint8_t ps, ddr_bist_setup_t *setup)
+{
+    return 0;
+}
+
+PUBLIC VOID ddrBistSetup(ddr_bist_setup_t *setup)
+{
+    test_calls.bist_setup = *setup;
+}
+
+PUBLIC uint32_t ddrRunBistSequence(ddr_bist_pattern_e pattern, uint32_t timeout, ddr_bist_result_t *result)
+{
+    if (test_calls.bist_runs < TEST_BIST_RUNS_MAX)
+    {
+        test_calls.bist[test_calls.bist_runs] = test_calls.bist_setup;
+    }
+    test_calls.bist_runs++;
+    test_counter += test_bist_run_us;
+
+    if (test_bist_fail_run == test_calls.bist_runs)
+    {
+        result->numWordErrors = 3;
+    }
+    return 0;
+}
+
+PUBLIC VOID ddrCleanupBist(VOID)
+{
+}
+
+PUBLIC uint32_t ddr_api_init(const user_input_msdg_t *msdg_ptr)
+{
+    return PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddr_api_fw_phy_reset(VOID)
+{
+    return PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddr_api_fw_train(VOID)
+{
+    test_calls.train_calls++;
+    return PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddr_api_cal_results_get(ddr_timing_data_t *timing_ptr, ddr_vref_data_t *vref_ptr)
+{
+    /* the seed leads the timing */
+    memset(timing_ptr, 0, sizeof(*timing_ptr));
+    memcpy(timing_ptr, &test_timing_seed, sizeof(test_timing_seed));
+    return PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddr_api_saved_margin_results_load(const ddr_timing_data_t *timing_ptr, const ddr_vref_data_t *vref_ptr)
+{
+    test_calls.restore_calls++;
+    memcpy(&test_calls.restore_seed, timing_ptr, sizeof(test_calls.restore_seed));
+    return PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddr_phy_init(uint32_t run_dev_init, uint32_t run_training, uint32_t train_2d, uint32_t restore_vref, uint32_t restore_timing)
+{
+    test_calls.phy_init_calls++;
+    test_calls.phy_init_args[0] = run_dev_init;
+    test_calls.phy_init_args[1] = run_training;
+    test_calls.phy_init_args[2] = train_2d;
+    test_calls.phy_init_args[3] = restore_vref;
+    test_calls.phy_init_args[4] = restore_timing;
+    memcpy(&test_calls.phy_init_seed, &ddrTimingData, sizeof(test_calls.phy_init_seed));
+    return PMC_SUCCESS;
+}
+
+PUBLIC VOID ddr_exp_cmdsvr_register(VOID)
+{
+}
+
+PUBLIC VOID exp_ddr_ctrlr_cmdsvr_register(VOID)
+{
+}
+
+PUBLIC VOID exp_ddr_ctrlr_init(VOID)
+{
+}
+
+PUBLIC const exp_ddr_ctrlr_spd_struct *exp_ddr_ctrlr_spd_info_get(UINT32 *data_rate_ptr)
+{
+    return NULL;
+}
+
+PUBLIC PMCFW_ERROR exp_ddr_ctrlr_spd_phy_config(const exp_ddr_ctrlr_spd_struct *spd_ptr, UINT32 data_rate, user_input_msdg_t *msdg_ptr)
+{
+    return PMC_SUCCESS;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Reboot: restore the power and forget the slot found by the last boot.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_reboot(VOID)
+{
+    host_flash_power_on();
+    app_fw_ddr_cal_slot = APP_FW_DDR_CAL_SLOT_NONE;
+}
+
+/**
+* @brief
+*   Check what a boot finds after a number of completed saves.
+*
+* @param[in] saves - saves completed, the calibration of the last one
+*                    must be found
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_boot_check(UINT32 saves)
+{
+    UINT32 generation = 0;
+    UINT32 slot;
+    UINT32 len = 0;
+
+    slot = app_fw_ddr_cal_slot_newest(&generation);
+
+    if (0 == saves)
+    {
+        HOST_CHECK(APP_FW_DDR_CAL_SLOT_NONE == slot);
+        HOST_CHECK(APP_FW_DDR_ERR_CALIBRATION_CRC == app_fw_ddr_calibration_load(&test_loaded));
+        return;
+    }
+
+    /* the slots alternate, the generation counts the saves */
+    HOST_CHECK(((saves - 1) % APP_FW_DDR_CAL_NUM_SLOTS) == slot);
+    HOST_CHECK(saves == generation);
+
+    HOST_CHECK(PMC_SUCCESS == app_fw_ddr_calibration_load(&test_loaded));
+    HOST_CHECK(0 == memcmp(&test_loaded, &test_data[saves - 1], sizeof(test_loaded)));
+
+    /* the host reads the same slot */
+    memset(&test_loaded, 0, sizeof(test_loaded));
+    HOST_CHECK(PMC_SUCCESS == app_fw_ddr_calibration_read(0, sizeof(test_loaded) + 64, &test_loaded, &len));
+    HOST_CHECK(sizeof(test_loaded) == len);
+    HOST_CHECK(0 == memcmp(&test_loaded, &test_data[saves - 1], sizeof(test_loaded)));
+}
+
+/**
+* @brief
+*   Save a calibration on its own boot.
+*
+* @param[in] index - calibration to save
+*
+* @return
+*   Result of the save.
+*/
+PRIVATE PMCFW_ERROR test_save(UINT32 index)
+{
+    test_reboot();
+    return app_fw_ddr_calibration_save(&test_data[index]);
+}
+
+/**
+* @brief
+*   Save the series without a power cut and count the flash operations
+*   of each save.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_reference(VOID)
+{
+    UINT32 start;
+    UINT32 i;
+
+    host_flash_reset();
+    test_reboot();
+    test_boot_check(0);
+
+    for (i = 0; i < TEST_SAVES; i++)
+    {
+        start = host_flash_op_count();
+        HOST_CHECK(PMC_SUCCESS == test_save(i));
+        test_ops[i] = host_flash_op_count() - start;
+
+        test_reboot();
+        test_boot_check(i + 1);
+    }
+
+    /* an erase, the data pages and the commit page */
+    HOST_CHECK(test_ops[0] == (2 + ((sizeof(app_fw_ddr_calibration_data_struct) + APP_FW_DDR_CAL_PAGE_SIZE - 1) /
+                                    APP_FW_DDR_CAL_PAGE_SIZE)));
+}
+
+/**
+* @brief
+*   Cut the power at every flash operation of every save of the series.
+*
+* @return
+*   Number of power cuts made.
+*/
+PRIVATE UINT32 test_power_cuts(VOID)
+{
+    UINT32 cuts = 0;
+    UINT32 save;
+    UINT32 op;
+    UINT32 i;
+
+    for (save = 0; save < TEST_SAVES; save++)
+    {
+        for (op = 0; op < test_ops[save]; op++)
+        {
+            host_flash_reset();
+            for (i = 0; i < save; i++)
+            {
+                HOST_CHECK(PMC_SUCCESS == test_save(i));
+            }
+
+            test_reboot();
+            host_flash_power_cut_set(op);
+            HOST_CHECK(PMC_SUCCESS != app_fw_ddr_calibration_save(&test_data[save]));
+            HOST_CHECK(TRUE == host_flash_power_is_off());
+
+            /* the calibration of the save before is still the newest */
+            test_reboot();
+            test_boot_check(save);
+
+            /* the next boot saves again */
+            HOST_CHECK(PMC_SUCCESS == test_save(save));
+            test_reboot();
+            test_boot_check(save + 1);
+
+            cuts++;
+        }
+    }
+
+    return cuts;
+}
+
+/**
+* @brief
+*   A corrupted newest slot falls back to the other slot, then to none.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_corrupt(VOID)
+{
+    UINT32 base = app_fw_ddr_training_data_addr_get();
+    UINT32 newest = (TEST_SAVES - 1) % APP_FW_DDR_CAL_NUM_SLOTS;
+    UINT32 older = (TEST_SAVES - 2) % APP_FW_DDR_CAL_NUM_SLOTS;
+
+    /* the data of the newest slot */
+    test_reference();
+    host_flash_corrupt(base + (newest * APP_FW_DDR_CAL_SLOT_SIZE) + APP_FW_DDR_CAL_DATA_OFFSET + 100);
+    test_reboot();
+    test_boot_check(TEST_SAVES - 1);
+
+    /* a save after it goes to the corrupted slot */
+    HOST_CHECK(PMC_SUCCESS == test_save(TEST_SAVES - 1));
+    test_reboot();
+    HOST_CHECK(PMC_SUCCESS == app_fw_ddr_calibration_load(&test_loaded));
+    HOST_CHECK(0 == memcmp(&test_loaded, &test_data[TEST_SAVES - 1], sizeof(test_loaded)));
+
+    /* the commit pages of both slots */
+    test_reference();
+    host_flash_corrupt(base + (newest * APP_FW_DDR_CAL_SLOT_SIZE) + 4);
+    test_reboot();
+    test_boot_check(TEST_SAVES - 1);
+    host_flash_corrupt(base + (older * APP_FW_DDR_CAL_SLOT_SIZE) + 4);
+    test_reboot();
+    test_boot_check(0);
+}
+
+/**
+* @brief
+*   The slots of the image B configuration are separate from those of
+*   image A.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_partition(VOID)
+{
+    test_reference();
+
+    test_boot_partition = 'B';
+    test_reboot();
+    test_boot_check(0);
+    HOST_CHECK(PMC_SUCCESS == test_save(0));
+    test_reboot();
+    test_boot_check(1);
+
+    test_boot_partition = 'A';
+    test_reboot();
+    test_boot_check(TEST_SAVES);
+}
+
+/**
+* @brief
+*   Check the addresses of the DFI BIST runs of a bringup.
+*
+* @param[in] cs_mask - ranks present
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_bist_check(UINT32 cs_mask)
+{
+    const app_fw_ddr_verify_point_struct *point_ptr;
+    ddr_bist_setup_t *setup_ptr;
+    UINT32 run = 0;
+    UINT32 point;
+    UINT32 bg;
+    UINT32 cs;
+
+    /* address first, then bank group, then rank */
+    for (point = 0; point < APP_FW_DDR_VERIFY_NUM_POINTS; point++)
+    {
+        point_ptr = &app_fw_ddr_verify_points[point];
+
+        for (bg = 0; bg < APP_FW_DDR_VERIFY_NUM_BG; bg++)
+        {
+            for (cs = 0; cs < APP_FW_DDR_VERIFY_NUM_CS; cs++)
+            {
+                if ((0 == (cs_mask & (1 << cs))) || (run >= test_calls.bist_runs))
+                {
+                    continue;
+                }
+
+                setup_ptr = &test_calls.bist[run++];
+                HOST_CHECK(cs == setup_ptr->rankIndex);
+                HOST_CHECK(bg == setup_ptr->bg);
+                HOST_CHECK(point_ptr->bank == setup_ptr->bank);
+                HOST_CHECK(point_ptr->row == setup_ptr->rowAddr);
+                HOST_CHECK(point_ptr->col == setup_ptr->startColAddr);
+            }
+        }
+    }
+    HOST_CHECK(run == test_calls.bist_runs);
+}
+
+/**
+* @brief
+*   Boot with the current training inputs and check the path taken.
+*
+* @param[in] path       - expected path
+* @param[in] runs       - expected DFI BIST runs
+* @param[in] fallback   - TRUE if the DFI BIST check must fail into full
+*                         training
+* @param[in] seed       - seed of the saved timing that must be restored,
+*                         unused for full training
+* @param[in] generation - generation of the newest calibration after the
+*                         boot
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_bringup_check(test_bringup_enum path, UINT32 runs, BOOL fallback, UINT32 seed, UINT32 generation)
+{
+    /* run_dev_init, run_training, train_2d, restore_vref, restore_timing */
+    const UINT32 retrain_args[TEST_PHY_INIT_ARGS] = { TRUE, TRUE, TRUE, FALSE, TRUE };
+    UINT32 newest = 0;
+
+    test_reboot();
+    memset(&test_calls, 0, sizeof(test_calls));
+    memset(&ddrTimingData, 0, sizeof(ddrTimingData));
+    test_timing_seed++;
+
+    HOST_CHECK(PMC_SUCCESS == app_fw_ddr_phy_bringup_init());
+
+    switch (path)
+    {
+        case TEST_BRINGUP_RESTORE:
+            HOST_CHECK(1 == test_calls.restore_calls);
+            HOST_CHECK(seed == test_calls.restore_seed);
+            HOST_CHECK(0 == test_calls.phy_init_calls);
+            break;
+
+        case TEST_BRINGUP_RETRAIN_2D:
+            HOST_CHECK(0 == test_calls.restore_calls);
+            HOST_CHECK(1 == test_calls.phy_init_calls);
+            HOST_CHECK(0 == memcmp(retrain_args, test_calls.phy_init_args, sizeof(retrain_args)));
+            HOST_CHECK(seed == test_calls.phy_init_seed);
+            break;
+
+        default:
+            HOST_CHECK(0 == test_calls.restore_calls);
+            HOST_CHECK(0 == test_calls.phy_init_calls);
+            break;
+    }
+
+    HOST_CHECK(((TEST_BRINGUP_FULL == path) || fallback) == (1 == test_calls.train_calls));
+    HOST_CHECK(runs == test_calls.bist_runs);
+    test_bist_check(user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG].CsPresent);
+
+    /* a restore saves nothing, training saves its results */
+    test_reboot();
+    app_fw_ddr_cal_slot_newest(&newest);
+    HOST_CHECK(generation == newest);
+    HOST_CHECK(PMC_SUCCESS == app_fw_ddr_calibration_load(&test_loaded));
+    if ((TEST_BRINGUP_RESTORE != path) || fallback)
+    {
+        HOST_CHECK(0 == memcmp(&test_loaded.timing_data, &test_timing_seed, sizeof(test_timing_seed)));
+    }
+}
+
+/**
+* @brief
+*   Boots with unchanged, 2D and 1D training inputs changed.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_bringup(VOID)
+{
+    user_input_msdg_t *msdg_ptr = &user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG];
+    UINT32 runs = APP_FW_DDR_VERIFY_NUM_BG * APP_FW_DDR_VERIFY_NUM_POINTS;
+
+    host_flash_reset();
+    test_bist_fail_run = 0;
+    test_bist_run_us = 0;
+    memset(msdg_ptr, 0, sizeof(*msdg_ptr));
+    msdg_ptr->CsPresent = 0x1;
+    msdg_ptr->Frequency[0] = 1333;
+    msdg_ptr->PhyOdtImpedance[0] = 60;
+    msdg_ptr->InitVrefDQ[0] = 0x10;
+    test_timing_seed = 0;
+
+    /* nothing saved, trained with seed 1 */
+    test_bringup_check(TEST_BRINGUP_FULL, 0, FALSE, 0, 1);
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, FALSE, 1, 1);
+
+    /* drive, then Vref: from the timing saved before, trained with seeds 3 and 4 */
+    msdg_ptr->PhyOdtImpedance[0] = 48;
+    test_bringup_check(TEST_BRINGUP_RETRAIN_2D, runs, FALSE, 1, 2);
+    msdg_ptr->InitVrefDQ[0] = 0x18;
+    test_bringup_check(TEST_BRINGUP_RETRAIN_2D, runs, FALSE, 3, 3);
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, FALSE, 4, 3);
+
+    /* rank, then frequency together with a drive input */
+    msdg_ptr->CsPresent = 0x3;
+    test_bringup_check(TEST_BRINGUP_FULL, 0, FALSE, 0, 4);
+    msdg_ptr->Frequency[0] = 1600;
+    msdg_ptr->PhyOdtImpedance[0] = 60;
+    test_bringup_check(TEST_BRINGUP_FULL, 0, FALSE, 0, 5);
+    runs *= 2;
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, FALSE, 7, 5);
+}
+
+/**
+* @brief
+*   DFI BIST word errors and the time budget of the restore check.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_verify(VOID)
+{
+    user_input_msdg_t *msdg_ptr = &user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG];
+    UINT32 runs;
+
+    /* two ranks, a calibration saved with seed 1 */
+    host_flash_reset();
+    memset(msdg_ptr, 0, sizeof(*msdg_ptr));
+    msdg_ptr->CsPresent = 0x3;
+    msdg_ptr->Frequency[0] = 1333;
+    test_timing_seed = 0;
+    test_bist_fail_run = 0;
+    test_bist_run_us = 0;
+    test_bringup_check(TEST_BRINGUP_FULL, 0, FALSE, 0, 1);
+
+    /* word errors at the 5th address stop the check, then full training with seed 2 */
+    test_bist_fail_run = 5;
+    test_bringup_check(TEST_BRINGUP_RESTORE, 5, TRUE, 1, 2);
+
+    /* and at the first address after a 2D retrain, full training with seed 3 */
+    test_bist_fail_run = 1;
+    msdg_ptr->InitVrefDQ[0] = 0x18;
+    test_bringup_check(TEST_BRINGUP_RETRAIN_2D, 1, TRUE, 2, 3);
+
+    /*
+    ** The budget runs out after the run that reaches it. The addresses
+    ** not reached are not failures, so the restore stands; the first runs
+    ** cover every rank and bank group.
+    */
+    test_bist_fail_run = 0;
+    test_bist_run_us = 700;
+    runs = (EXPLORER_DDR_RESTORE_BIST_BUDGET_US + test_bist_run_us - 1) / test_bist_run_us;
+    HOST_CHECK(runs < (2 * APP_FW_DDR_VERIFY_NUM_BG * APP_FW_DDR_VERIFY_NUM_POINTS));
+    HOST_CHECK(runs >= (2 * APP_FW_DDR_VERIFY_NUM_BG));
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, FALSE, 3, 3);
+
+    /* a failing address after the budget is not reached */
+    test_bist_fail_run = runs + 1;
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, FALSE, 3, 3);
+
+    /* a run that fails as the budget runs out still counts */
+    test_bist_fail_run = runs;
+    test_bringup_check(TEST_BRINGUP_RESTORE, runs, TRUE, 3, 4);
+
+    printf("restore check: %u us budget, %u of %u addresses at %u us per run\n",
+           (unsigned)EXPLORER_DDR_RESTORE_BIST_BUDGET_US,
+           (unsigned)runs,
+           (unsigned)(2 * APP_FW_DDR_VERIFY_NUM_BG * APP_FW_DDR_VERIFY_NUM_POINTS),
+           (unsigned)test_bist_run_us);
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 cuts;
+    UINT32 i;
+    UINT32 j;
+
+    host_srand(0);
+
+    /* calibrations that differ in every field */
+    for (i = 0; i < TEST_SAVES; i++)
+    {
+        for (j = 0; j < sizeof(test_data[i]); j++)
+        {
+            ((UINT8 *)&test_data[i])[j] = (UINT8)host_rand();
+        }
+    }
+
+    test_reference();
+    cuts = test_power_cuts();
+    test_corrupt();
+    test_partition();
+    test_bringup();
+    test_verify();
+
+    printf("%u byte calibration, %u flash operations per save, %u power cuts\n",
+           (unsigned)sizeof(app_fw_ddr_calibration_data_struct),
+           (unsigned)test_ops[0],
+           (unsigned)cuts);
+
+    return host_test_result("test_app_fw_ddr_cal");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
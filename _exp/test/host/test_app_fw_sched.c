@@ -0,0 +1,389 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the VPE0 main loop scheduler and a simulation of the host
+*   command latency while the periodic serdes calibration runs.
+*
+* @note
+*   Usage: test_app_fw_sched [<lane calibration us> ...]
+*
+*   The scheduler runs on a simulated clock of 1 us per tick. The tasks
+*   advance the clock by the time their work would take on the target.
+*   Host commands arrive at random, a uniform 0..4 ms apart, and the
+*   latency from arrival to the start of the host command task is
+*   recorded. The serdes calibration task calibrates 8 lanes, either in
+*   one call as before or one lane at a time with a yield point in
+*   between as serdes_plat_cal_update() does. The time one lane takes is
+*   not known from the host, it is a parameter of the simulation.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "sys_timer_api.h"
+#include "app_fw_sched.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+/* Lanes calibrated by the periodic serdes calibration */
+#define TEST_LANES                  8
+
+/* Simulated time per latency run */
+#define TEST_SIM_US                 (20 * 1000 * 1000)
+
+/* Host command service time and largest gap between arrivals */
+#define TEST_HOST_CMD_US            20
+#define TEST_HOST_GAP_MAX_US        4000
+
+/* Serdes calibration task period, as in app_fw_main.c */
+#define TEST_SERDES_CAL_PERIOD_US   (100 * 1000)
+
+/* Default lane calibration times */
+#define TEST_DEFAULT_LANE_US        { 250, 1000, 4000 }
+
+/* Trace of task runs */
+#define TEST_TRACE_MAX              32
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT_TIME test_now;
+
+PRIVATE CHAR test_trace[TEST_TRACE_MAX + 1];
+PRIVATE UINT32 test_trace_len;
+
+PRIVATE BOOL test_cal_yield;
+PRIVATE UINT32 test_lane_us;
+PRIVATE UINT_TIME test_arrival;
+PRIVATE UINT64 test_latency_sum;
+PRIVATE UINT32 test_latency_max;
+PRIVATE UINT32 test_cmd_count;
+
+/*
+** Private Functions
+*/
+
+PRIVATE UINT_TIME test_timer_read(VOID)
+{
+    return test_now;
+}
+
+PRIVATE UINT_TIME test_timer_diff(UINT_TIME time1, UINT_TIME time2)
+{
+    return time2 - time1;
+}
+
+PRIVATE UINT_TIME test_timer_us(UINT_TIME count)
+{
+    return count;
+}
+
+PRIVATE UINT_TIME test_timer_us_to_count(UINT32 time_us)
+{
+    return time_us;
+}
+
+/*
+** Firmware Replacements
+*/
+
+PUBLIC sys_timer_rd_fn_ptr sys_timer_read = test_timer_read;
+PUBLIC sys_timer_diff_fn_ptr_type sys_timer_diff_fn_ptr = test_timer_diff;
+PUBLIC sys_timer_us_to_count_fn_ptr_type sys_timer_us_to_count_fn_ptr = test_timer_us_to_count;
+PUBLIC sys_timer_count_to_us_fn_ptr_type sys_timer_count_to_us_fn_ptr = test_timer_us;
+
+/*
+** Order tests, each task appends its letter to the trace
+*/
+
+PRIVATE VOID test_trace_add(CHAR c)
+{
+    if (test_trace_len < TEST_TRACE_MAX)
+    {
+        test_trace[test_trace_len++] = c;
+        test_trace[test_trace_len] = '\0';
+    }
+}
+
+PRIVATE VOID test_task_host(VOID)
+{
+    test_trace_add('H');
+}
+
+PRIVATE VOID test_task_deferred(VOID)
+{
+    test_trace_add('D');
+}
+
+PRIVATE VOID test_task_housekeeping(VOID)
+{
+    test_trace_add('K');
+}
+
+PRIVATE VOID test_task_background(VOID)
+{
+    static BOOL signalled = FALSE;
+
+    test_trace_add('B');
+
+    /* work arriving for every task, itself included, during the first run */
+    if (FALSE == signalled)
+    {
+        signalled = TRUE;
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_UART_SHELL);
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_SERDES_CAL);
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_HOST_CMD);
+        app_fw_sched_task_ready(APP_FW_SCHED_TASK_BOOT_PROF);
+    }
+
+    app_fw_sched_yield();
+    test_trace_add('b');
+}
+
+/**
+* @brief
+*   Run the main loop until no task has work.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_run_idle(VOID)
+{
+    UINT32 i;
+
+    for (i = 0; (i < 100) && (TRUE == app_fw_sched_run()); i++)
+    {
+    }
+}
+
+/**
+* @brief
+*   Tasks run in priority order, tasks of equal priority in registration
+*   order, and a yield point only runs tasks of higher priority.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_order(VOID)
+{
+    test_now = 0;
+    app_fw_sched_init();
+
+    /* registered out of priority order */
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_SERDES_CAL, "bg", test_task_background, NULL, APP_FW_SCHED_PRIO_BACKGROUND, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_UART_SHELL, "hk", test_task_housekeeping, NULL, APP_FW_SCHED_PRIO_HOUSEKEEPING, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_HOST_CMD, "host", test_task_host, NULL, APP_FW_SCHED_PRIO_HOST, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_TWI_DEFERRED, "def", test_task_deferred, NULL, APP_FW_SCHED_PRIO_DEFERRED, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_BOOT_PROF, "bg2", test_task_deferred, NULL, APP_FW_SCHED_PRIO_BACKGROUND, 0, 0);
+
+    test_trace_len = 0;
+    test_trace[0] = '\0';
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_SERDES_CAL);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_UART_SHELL);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_TWI_DEFERRED);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_HOST_CMD);
+    test_run_idle();
+
+    /*
+    ** the yield runs the host and housekeeping tasks but not the other
+    ** background task, the signal the running task got is kept
+    */
+    HOST_CHECK(0 == strcmp(test_trace, "HDKB" "HK" "b" "Bb" "D"));
+    if (0 != strcmp(test_trace, "HDKB" "HK" "b" "Bb" "D"))
+    {
+        printf("  trace %s\n", test_trace);
+    }
+}
+
+/**
+* @brief
+*   A held task does not run, from the main loop or from a yield point,
+*   and runs on its signal once released.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_hold(VOID)
+{
+    test_now = 0;
+    app_fw_sched_init();
+
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_TWI_DEFERRED, "def", test_task_deferred, NULL, APP_FW_SCHED_PRIO_DEFERRED, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_UART_SHELL, "hk", test_task_housekeeping, NULL, APP_FW_SCHED_PRIO_HOUSEKEEPING, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_DDR_TRAIN, "bg", test_task_background, NULL, APP_FW_SCHED_PRIO_BACKGROUND, 0, 0);
+
+    test_trace_len = 0;
+    test_trace[0] = '\0';
+    app_fw_sched_task_hold(APP_FW_SCHED_TASK_TWI_DEFERRED, TRUE);
+    app_fw_sched_task_hold(APP_FW_SCHED_TASK_UART_SHELL, TRUE);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_TWI_DEFERRED);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_UART_SHELL);
+    app_fw_sched_task_ready(APP_FW_SCHED_TASK_DDR_TRAIN);
+    test_run_idle();
+    HOST_CHECK(0 == strcmp(test_trace, "Bb"));
+
+    /* the signals got while held are kept */
+    app_fw_sched_task_hold(APP_FW_SCHED_TASK_UART_SHELL, FALSE);
+    test_run_idle();
+    HOST_CHECK(0 == strcmp(test_trace, "Bb" "K"));
+
+    app_fw_sched_task_hold(APP_FW_SCHED_TASK_TWI_DEFERRED, FALSE);
+    test_run_idle();
+    HOST_CHECK(0 == strcmp(test_trace, "Bb" "K" "D"));
+    if (0 != strcmp(test_trace, "Bb" "K" "D"))
+    {
+        printf("  trace %s\n", test_trace);
+    }
+}
+
+/*
+** Latency simulation
+*/
+
+PRIVATE BOOL test_poll_host(VOID)
+{
+    return (test_now >= test_arrival);
+}
+
+PRIVATE VOID test_task_host_cmd(VOID)
+{
+    UINT32 latency = test_now - test_arrival;
+
+    test_latency_sum += latency;
+    test_cmd_count++;
+    if (latency > test_latency_max)
+    {
+        test_latency_max = latency;
+    }
+
+    test_now += TEST_HOST_CMD_US;
+    test_arrival = test_now + (host_rand() % TEST_HOST_GAP_MAX_US);
+}
+
+PRIVATE VOID test_task_serdes_cal(VOID)
+{
+    UINT32 lane;
+
+    if (FALSE == test_cal_yield)
+    {
+        test_now += TEST_LANES * test_lane_us;
+        return;
+    }
+
+    for (lane = 0; lane < TEST_LANES; lane++)
+    {
+        if (0 != lane)
+        {
+            app_fw_sched_yield();
+        }
+        test_now += test_lane_us;
+    }
+}
+
+/**
+* @brief
+*   Simulate the main loop and report the host command latency.
+*
+* @param[in] lane_us - time to calibrate one lane
+* @param[in] yield   - yield between the lanes
+*
+* @return
+*   Largest latency in us.
+*/
+PRIVATE UINT32 test_latency(UINT32 lane_us, BOOL yield)
+{
+    test_now = 1;
+    test_lane_us = lane_us;
+    test_cal_yield = yield;
+    test_arrival = 0;
+    test_latency_sum = 0;
+    test_latency_max = 0;
+    test_cmd_count = 0;
+    host_srand(lane_us);
+
+    app_fw_sched_init();
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_HOST_CMD, "host_cmd", test_task_host_cmd, test_poll_host, APP_FW_SCHED_PRIO_HOST, 0, 0);
+    app_fw_sched_task_register(APP_FW_SCHED_TASK_SERDES_CAL, "serdes_cal", test_task_serdes_cal, NULL, APP_FW_SCHED_PRIO_BACKGROUND, TEST_SERDES_CAL_PERIOD_US, 0);
+
+    while (test_now < TEST_SIM_US)
+    {
+        if (FALSE == app_fw_sched_run())
+        {
+            test_now++;
+        }
+    }
+
+    printf("  lane cal %5u us, %-14s host cmd latency mean %6.1f us, max %6u us (%u cmds)\n",
+           (unsigned)lane_us,
+           (TRUE == yield) ? "lane yield," : "one call,",
+           (double)test_latency_sum / (double)test_cmd_count,
+           (unsigned)test_latency_max,
+           (unsigned)test_cmd_count);
+
+    return test_latency_max;
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 lane_us[] = TEST_DEFAULT_LANE_US;
+    UINT32 max_one;
+    UINT32 max_yield;
+    UINT32 us;
+    int i;
+
+    test_order();
+    test_hold();
+
+    printf("serdes calibration of %u lanes every %u ms, host commands %u us, 0..%u us apart\n",
+           TEST_LANES, TEST_SERDES_CAL_PERIOD_US / 1000, TEST_HOST_CMD_US, TEST_HOST_GAP_MAX_US);
+
+    for (i = 0; i < (int)((argc > 1) ? (argc - 1) : (int)PMC_ARRAY_SIZE(lane_us)); i++)
+    {
+        us = (argc > 1) ? (UINT32)strtoul(argv[i + 1], NULL, 0) : lane_us[i];
+
+        max_one = test_latency(us, FALSE);
+        max_yield = test_latency(us, TRUE);
+
+        /* a command waits for at most one lane and the commands queued ahead of it */
+        HOST_CHECK(max_one >= ((TEST_LANES - 1) * us));
+        HOST_CHECK(max_yield <= (us + TEST_HOST_GAP_MAX_US));
+    }
+
+    return host_test_result("test_app_fw_sched");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,304 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the log rate limiter and benchmark of the leveled and
+*   rate limited logging against plain bc_printf().
+*
+* @note
+*   The host bc_printf() formats into a circular log the size of the
+*   firmware log, so the cycles measured are for formatting and copying a
+*   message, not for the UART. Cycles are x86 time stamp counter ticks.
+*   The benchmark uses call sites converted in serdes_plat.c:
+*
+*   - The per-lane adaptation traces, now BC_LOG_DEBUG() and compiled
+*     out at the default EXPLORER_LOG_LEVEL.
+*   - The periodic IQ offset calibration failure, logged every 5 s while
+*     it fails, now BC_LOG_RL() with 3 messages per 10 minutes.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "opsw_timer.h"
+#include "bc_log.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+#define TEST_LANES                  8
+
+/* Passes of the per-lane trace */
+#define TEST_TRACE_PASSES           20000
+
+/* Periodic calibration failure: every 5 s for a day */
+#define TEST_CAL_PERIOD_S           5
+#define TEST_CAL_DAY_S              (24 * 60 * 60)
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT32 test_seconds;
+
+/* keeps the compiler from dropping the loops */
+PRIVATE volatile UINT32 test_sink;
+
+/*
+** Firmware Replacements
+*/
+
+PUBLIC UINT32 opsw_timer0_read(VOID)
+{
+    return test_seconds;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Token bucket of one call site.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_rl(VOID)
+{
+    bc_log_rl_struct rl = BC_LOG_RL_INIT(3, 30);
+    UINT32 msgs;
+    UINT32 bytes;
+    UINT32 logged = 0;
+    UINT32 i;
+
+    test_seconds = 1000;
+    rl.refill_s = test_seconds;
+
+    /* a burst of 3, then nothing until tokens are refilled */
+    for (i = 0; i < 10; i++)
+    {
+        if (TRUE == bc_log_rl_check(&rl))
+        {
+            logged++;
+        }
+    }
+    HOST_CHECK(3 == logged);
+    HOST_CHECK(7 == rl.suppressed);
+
+    /* one token every 10 s, the summary line is logged with the message */
+    test_seconds += 9;
+    HOST_CHECK(FALSE == bc_log_rl_check(&rl));
+    host_log_stats_reset();
+    test_seconds += 1;
+    HOST_CHECK(TRUE == bc_log_rl_check(&rl));
+    host_log_stats_get(&msgs, &bytes);
+    HOST_CHECK((1 == msgs) && (strlen("(8 messages suppressed)\n") == bytes));
+    HOST_CHECK(0 == rl.suppressed);
+    HOST_CHECK(FALSE == bc_log_rl_check(&rl));
+
+    /* part of a token accrued is kept: 5 s + 5 s make one */
+    test_seconds += 5;
+    HOST_CHECK(FALSE == bc_log_rl_check(&rl));
+    test_seconds += 5;
+    HOST_CHECK(TRUE == bc_log_rl_check(&rl));
+
+    /* the bucket does not fill beyond the burst */
+    test_seconds += 1000;
+    for (logged = 0, i = 0; i < 10; i++)
+    {
+        if (TRUE == bc_log_rl_check(&rl))
+        {
+            logged++;
+        }
+    }
+    HOST_CHECK(3 == logged);
+}
+
+/**
+* @brief
+*   Per-lane adaptation trace, as logged before and after.
+*
+* @param[in] leveled - use the converted call sites
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_trace_pass(BOOL leveled)
+{
+    UINT32 i;
+
+    for (i = 0; i < TEST_LANES; i++)
+    {
+        if (TRUE == leveled)
+        {
+            BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n", i);
+            BC_LOG_DEBUG("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_normal \n", i);
+            BC_LOG_DEBUG("[%d] EXP_SERDES_TRAINING_ADAPT_PASSED (step 1)\n", i);
+        }
+        else
+        {
+            bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n", i);
+            bc_printf("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_normal \n", i);
+            bc_printf("[%d] EXP_SERDES_TRAINING_ADAPT_PASSED (step 1)\n", i);
+        }
+        test_sink += i;
+    }
+}
+
+/**
+* @brief
+*   Periodic calibration failure, as logged before and after.
+*
+* @param[in] limited - use the converted call site
+* @param[in] rc      - calibration result
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_cal_fail(BOOL limited, UINT32 rc)
+{
+    if (TRUE == limited)
+    {
+        BC_LOG_RL(BC_LOG_LEVEL_ERR, 3, 600, "SERDES_FH_IQ_Offset_Calibration failed: ERR!!! rc=0x%x\n", rc);
+    }
+    else
+    {
+        bc_printf("SERDES_FH_IQ_Offset_Calibration failed: ERR!!! rc=0x%x\n", rc);
+    }
+}
+
+/**
+* @brief
+*   Benchmark of the per-lane trace.
+*
+* @param[in] leveled - use the converted call sites
+*
+* @return
+*   Log bytes per pass.
+*/
+PRIVATE UINT32 test_bench_trace(BOOL leveled)
+{
+    UINT64 start;
+    UINT64 cycles;
+    UINT32 msgs;
+    UINT32 bytes;
+    UINT32 pass;
+
+    host_log_stats_reset();
+    start = host_cycles();
+    for (pass = 0; pass < TEST_TRACE_PASSES; pass++)
+    {
+        test_trace_pass(leveled);
+    }
+    cycles = host_cycles() - start;
+    host_log_stats_get(&msgs, &bytes);
+
+    printf("  lane trace, %-12s %8.0f cycles, %3u messages, %4u log bytes per 8 lane pass\n",
+           (TRUE == leveled) ? "BC_LOG_DEBUG" : "bc_printf",
+           (double)cycles / TEST_TRACE_PASSES,
+           (unsigned)(msgs / TEST_TRACE_PASSES),
+           (unsigned)(bytes / TEST_TRACE_PASSES));
+
+    return bytes / TEST_TRACE_PASSES;
+}
+
+/**
+* @brief
+*   Benchmark of a day of calibration failures.
+*
+* @param[in] limited - use the converted call site
+*
+* @return
+*   Log bytes per day.
+*/
+PRIVATE UINT32 test_bench_cal_fail(BOOL limited)
+{
+    UINT64 start;
+    UINT64 cycles;
+    UINT32 calls = 0;
+    UINT32 msgs;
+    UINT32 bytes;
+
+    host_log_stats_reset();
+    start = host_cycles();
+    for (test_seconds = 0; test_seconds < TEST_CAL_DAY_S; test_seconds += TEST_CAL_PERIOD_S)
+    {
+        test_cal_fail(limited, 0x12345678);
+        calls++;
+    }
+    cycles = host_cycles() - start;
+    host_log_stats_get(&msgs, &bytes);
+
+    printf("  cal failure, %-10s %8.0f cycles per call, %5u messages, %6u log bytes per day,",
+           (TRUE == limited) ? "BC_LOG_RL" : "bc_printf",
+           (double)cycles / calls,
+           (unsigned)msgs,
+           (unsigned)bytes);
+    printf(" log wraps every %.1f h\n", (0 == bytes) ? 0.0 : (24.0 * HOST_LOG_SIZE / bytes));
+
+    return bytes;
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 before;
+    UINT32 after;
+
+    test_rl();
+
+    printf("log level %d, per-lane trace strings %u bytes in the image before, %u after\n",
+           BC_LOG_LEVEL,
+           (unsigned)(sizeof("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_adaptation_disable \n") +
+                      sizeof("[%d] Calling SERDES_FH_TXRX_Adaptation1_FW_start_normal \n") +
+                      sizeof("[%d] EXP_SERDES_TRAINING_ADAPT_PASSED (step 1)\n")),
+           (BC_LOG_LEVEL >= BC_LOG_LEVEL_DEBUG) ? 1u : 0u);
+
+    /* warm up */
+    (VOID)test_bench_trace(FALSE);
+
+    before = test_bench_trace(FALSE);
+    after = test_bench_trace(TRUE);
+    HOST_CHECK(0 != before);
+    HOST_CHECK((BC_LOG_LEVEL >= BC_LOG_LEVEL_DEBUG) || (0 == after));
+
+    before = test_bench_cal_fail(FALSE);
+    after = test_bench_cal_fail(TRUE);
+
+    /* 3 per 10 minutes plus a summary line with each */
+    HOST_CHECK(after < (before / 25));
+
+    return host_test_result("test_bc_log");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,652 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Test of the compressed crash dumps of crash_dump_plat.c on the RAM
+*   flash model.
+*
+* @note
+*   The test takes the place of the crash dump library: each crash erases
+*   the partition through the platform layer, flushes a few sets of
+*   register dump text, sparse words and random data, then the header
+*   entries. The test includes crash_dump_plat.c to read back the earlier
+*   crash dumps as well as the newest.
+*
+*   - Crashes are repeated until the partition is full. Every crash dump
+*     kept must read back through lz_comp and lz_decomp, whole sections
+*     and random ranges, and several must be kept before the partition is
+*     erased for a new one.
+*   - Block words and frame headers are corrupted. The read must stay
+*     within the partition, keep the blocks before the corruption and
+*     return zeros after it.
+*   - The power is cut at every flash operation of a crash. The next boot
+*     must read the crash dump before, and the next crash must not
+*     program a page twice and must read back.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "pmc_profile.h"
+#include "host_test.h"
+#include "host_flash.h"
+
+#include "crash_dump_plat.c"
+
+/*
+** Local Constants
+*/
+
+#define TEST_PART_ADDR              SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_ADDR
+#define TEST_PART_SIZE              SPI_FLASH_FW_IMG_A_CFG_LOG_CRASH_DUMP_SIZE
+#define TEST_EXT_DATA_SIZE          (64 * 1024)
+#define TEST_HEAP_SIZE              (16 * 1024)
+
+/* Sections of a crash dump, flushed in sets */
+#define TEST_SECTIONS               4
+#define TEST_SETS                   3
+#define TEST_RAW_MAX                (48 * 1024)
+
+/* Crashes of the retention run, more than fit before an erase */
+#define TEST_CRASHES                24
+
+/* Random ranges read back from each crash dump */
+#define TEST_RANGES                 32
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   A crash dump written by the test.
+*/
+typedef struct
+{
+    UINT8 raw[TEST_RAW_MAX];                    /**< Raw data section */
+    UINT32 raw_size;                            /**< Raw data size */
+    crash_dump_header hdr[TEST_SECTIONS];       /**< Header entries */
+    UINT32 rec_offset;                          /**< Offset in the partition */
+} test_dump_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT8 test_ext_data[TEST_EXT_DATA_SIZE];
+PRIVATE UINT8 test_heap[TEST_HEAP_SIZE];
+PRIVATE UINT32 test_heap_used;
+PRIVATE test_dump_struct test_dump[TEST_CRASHES];
+PRIVATE UINT8 test_read_buf[TEST_RAW_MAX + 1];
+
+/* Set of each section and its name */
+PRIVATE const UINT32 test_section_set[TEST_SECTIONS] = { 0, 0, 1, 2 };
+PRIVATE const CHAR * const test_section_name[TEST_SECTIONS] = { "RESET_INFO", "CRASH_CCB", "REG_DUMP", "TRACE_BUF" };
+
+/*
+** Firmware Stubs
+*/
+
+PUBLIC UINT32 flash_partition_boot_partition_id_get(VOID)
+{
+    return 'A';
+}
+
+PUBLIC UINT8* ech_ext_data_ptr_get(VOID)
+{
+    return test_ext_data;
+}
+
+PUBLIC UINT32 ech_ext_data_size_get(VOID)
+{
+    return sizeof(test_ext_data);
+}
+
+PUBLIC void *mem_alloc(const UINT32 mem_section, const UINT32 mem_size, const UINT32 byte_align, const BOOL lock_in_l2, UINT32 *bytes_wasted_ptr)
+{
+    VOID *ptr;
+
+    HOST_CHECK((test_heap_used + mem_size) <= TEST_HEAP_SIZE);
+    ptr = &test_heap[test_heap_used];
+    test_heap_used += (mem_size + 31) & ~31;
+
+    return ptr;
+}
+
+PUBLIC VOID bc_printf_channel_set(UINT8 channel_id)
+{
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Boot: restore the power and initialize the platform layer, which
+*   selects the newest crash dump.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_boot(VOID)
+{
+    host_flash_power_on();
+    test_heap_used = 0;
+    head_crash_dump_section = NULL;
+    tail_crash_dump_section = NULL;
+    crash_dump_plat_init();
+}
+
+/**
+* @brief
+*   Fill a section with register dump text.
+*
+* @param[out] dst_ptr - section data
+* @param[in]  size    - section size
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_text_fill(UINT8 *dst_ptr, UINT32 size)
+{
+    CHAR line[64];
+    UINT32 len;
+    UINT32 done;
+
+    for (done = 0; done < size; done += len)
+    {
+        if (0 == (host_rand() % 4))
+        {
+            len = (UINT32)snprintf(line, sizeof(line), "[%u] 0x%08X 0x%08X 0x00000000 0x00000000\n",
+                                   (unsigned)(host_rand() % 8), (unsigned)host_rand(), (unsigned)(host_rand() & 0xFF));
+        }
+        else
+        {
+            len = (UINT32)snprintf(line, sizeof(line), "DDR_PHY_REG_%04X] = 0x%08X\n",
+                                   (unsigned)(host_rand() & 0xFFFF), (unsigned)(host_rand() & 0x00FF00FF));
+        }
+        len = min(len, size - done);
+        memcpy(&dst_ptr[done], line, len);
+    }
+}
+
+/**
+* @brief
+*   Create the data of a crash dump.
+*
+* @param[out] dump_ptr - crash dump
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_dump_create(test_dump_struct *dump_ptr)
+{
+    UINT32 size[TEST_SECTIONS];
+    UINT32 offset = 0;
+    UINT32 i;
+    UINT32 j;
+
+    size[0] = 1024 + (host_rand() % 2048);
+    size[1] = 1024;
+    size[2] = 8192 + (host_rand() % 8192);
+    size[3] = 4096 + (host_rand() % 8192);
+
+    memset(dump_ptr->hdr, 0, sizeof(dump_ptr->hdr));
+
+    for (i = 0; i < TEST_SECTIONS; i++)
+    {
+        dump_ptr->hdr[i].header_key = CRASH_DUMP_HEADER_KEY;
+        strncpy(dump_ptr->hdr[i].name, test_section_name[i], SECTION_NAME_LEN - 1);
+        dump_ptr->hdr[i].start_offset = offset;
+        dump_ptr->hdr[i].size = size[i];
+
+        switch (i)
+        {
+            case 1:
+                /* control block, a few words set */
+                dump_ptr->hdr[i].type = CRASH_DUMP_RAW;
+                memset(&dump_ptr->raw[offset], 0, size[i]);
+                for (j = 0; j < 16; j++)
+                {
+                    dump_ptr->raw[offset + (host_rand() % size[i])] = (UINT8)host_rand();
+                }
+                break;
+
+            case 3:
+                /* trace buffer, does not compress */
+                dump_ptr->hdr[i].type = CRASH_DUMP_RAW;
+                for (j = 0; j < size[i]; j++)
+                {
+                    dump_ptr->raw[offset + j] = (UINT8)host_rand();
+                }
+                break;
+
+            default:
+                dump_ptr->hdr[i].type = CRASH_DUMP_ASCII;
+                test_text_fill(&dump_ptr->raw[offset], size[i]);
+                break;
+        }
+
+        offset += size[i];
+    }
+
+    dump_ptr->raw_size = offset;
+}
+
+/**
+* @brief
+*   Write a crash dump the way the crash dump library does.
+*
+* @param[in,out] dump_ptr - crash dump, its offset in the partition is set
+*
+* @return
+*   PMC_SUCCESS or the first error.
+*/
+PRIVATE PMCFW_ERROR test_crash(test_dump_struct *dump_ptr)
+{
+    PMCFW_ERROR rc;
+    UINT32 set;
+    UINT32 set_offset = 0;
+    UINT32 offset = 0;
+    UINT32 i;
+
+    rc = crash_dump_plat_active_partition_erase();
+    dump_ptr->rec_offset = crash_dump_lz_rec_offset;
+
+    /* the target crashes once per boot, the test may crash again */
+    header_buffer.write_ptr = header_buffer.start_ptr;
+
+    for (set = 0; (PMC_SUCCESS == rc) && (set < TEST_SETS); set++)
+    {
+        crash_dump_plat_ram_buf_ptr_reset();
+
+        for (i = 0; i < TEST_SECTIONS; i++)
+        {
+            if (set == test_section_set[i])
+            {
+                rc |= crash_dump_plat_data_put(dump_ptr->hdr[i].size, &dump_ptr->raw[dump_ptr->hdr[i].start_offset]);
+                offset += dump_ptr->hdr[i].size;
+            }
+        }
+
+        if (PMC_SUCCESS == rc)
+        {
+            rc = crash_dump_plat_data_flush(offset - set_offset, set_offset);
+        }
+        set_offset = offset;
+    }
+
+    for (i = 0; (PMC_SUCCESS == rc) && (i < TEST_SECTIONS); i++)
+    {
+        rc = crash_dump_plat_header_put(&dump_ptr->hdr[i]);
+    }
+
+    if (PMC_SUCCESS == rc)
+    {
+        rc = crash_dump_plat_header_flush();
+    }
+
+    if (PMC_SUCCESS == rc)
+    {
+        rc = crash_dump_plat_partition_pad_fill(offset);
+    }
+
+    return rc;
+}
+
+/**
+* @brief
+*   Select a crash dump to read back.
+*
+* @param[in] rec_offset - offset of the crash dump in the partition
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_dump_select(UINT32 rec_offset)
+{
+    crash_dump_lz_rec_offset = rec_offset;
+    spi_flash_header_address = TEST_PART_ADDR + rec_offset;
+}
+
+/**
+* @brief
+*   Read back a crash dump: header entries, sections and random ranges.
+*
+* @param[in] dump_ptr - crash dump
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_dump_check(const test_dump_struct *dump_ptr)
+{
+    crash_dump_header hdr;
+    UINT32 i;
+
+    test_dump_select(dump_ptr->rec_offset);
+
+    for (i = 0; i < TEST_SECTIONS; i++)
+    {
+        HOST_CHECK(PMC_SUCCESS == crash_dump_plat_header_entry_get(i, &hdr));
+        HOST_CHECK(0 == memcmp(&hdr, &dump_ptr->hdr[i], sizeof(hdr)));
+
+        HOST_CHECK(PMC_SUCCESS == crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf)));
+        HOST_CHECK(0 == memcmp(test_read_buf, &dump_ptr->raw[hdr.start_offset], hdr.size));
+    }
+    HOST_CHECK(CRASH_DUMP_INVALID_HEADER_IDX == crash_dump_plat_header_entry_get(TEST_SECTIONS, &hdr));
+
+    /* ranges across blocks, sets and the end of the data */
+    for (i = 0; i < TEST_RANGES; i++)
+    {
+        hdr.start_offset = host_rand() % dump_ptr->raw_size;
+        hdr.size = 1 + (host_rand() % (dump_ptr->raw_size - hdr.start_offset));
+
+        (VOID)crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf));
+        HOST_CHECK(0 == memcmp(test_read_buf, &dump_ptr->raw[hdr.start_offset], hdr.size));
+    }
+}
+
+/**
+* @brief
+*   Get the flash address of a block word of the selected crash dump.
+*
+* @param[in] frame - frame index, one frame per set
+* @param[in] block - block index within the frame
+*
+* @return
+*   Flash address of the block word.
+*/
+PRIVATE UINT32 test_block_word_addr(UINT32 frame, UINT32 block)
+{
+    crash_dump_plat_frame_header frame_hdr;
+    UINT32 frame_addr = spi_flash_header_address + CRASH_DUMP_HEADER_SECTION_SIZE;
+    UINT32 addr;
+    UINT32 block_word;
+    UINT32 i;
+
+    for ( ; ; frame--)
+    {
+        HOST_CHECK(TRUE == spi_flash_plat_checked_read((UINT8*)&frame_hdr, (UINT8*)frame_addr, sizeof(frame_hdr)));
+        addr = frame_addr + sizeof(frame_hdr);
+
+        for (i = 0; (i * CRASH_DUMP_PLAT_LZ_BLOCK_SIZE) < frame_hdr.raw_size; i++)
+        {
+            if ((0 == frame) && (block == i))
+            {
+                return addr;
+            }
+
+            HOST_CHECK(TRUE == spi_flash_plat_checked_read((UINT8*)&block_word, (UINT8*)addr, sizeof(block_word)));
+            addr += sizeof(block_word) + (block_word & ~CRASH_DUMP_PLAT_LZ_BLOCK_STORED);
+        }
+
+        HOST_CHECK(0 != frame);
+        frame_addr += (addr - frame_addr + CRASH_DUMP_LZ_PAGE_SIZE - 1) & ~(CRASH_DUMP_LZ_PAGE_SIZE - 1);
+    }
+}
+
+/**
+* @brief
+*   Write crash dumps until the partition is erased for a new one, and
+*   read back every crash dump kept.
+*
+* @return
+*   Number of crash dumps kept before the erase.
+*/
+PRIVATE UINT32 test_retention(VOID)
+{
+    UINT32 kept = 0;
+    UINT32 first = 0;
+    UINT32 i;
+    UINT32 j;
+
+    host_flash_reset();
+    test_boot();
+
+    for (i = 0; i < TEST_CRASHES; i++)
+    {
+        test_dump_create(&test_dump[i]);
+        HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[i]));
+
+        /* erased for the new crash dump */
+        if (0 == test_dump[i].rec_offset)
+        {
+            if ((0 != i) && (0 == kept))
+            {
+                kept = i - first;
+            }
+            first = i;
+        }
+        else
+        {
+            HOST_CHECK(test_dump[i].rec_offset > test_dump[i - 1].rec_offset);
+        }
+
+        /* the next boot reads the newest */
+        test_boot();
+        HOST_CHECK(test_dump[i].rec_offset == crash_dump_lz_rec_offset);
+
+        for (j = first; j <= i; j++)
+        {
+            test_dump_check(&test_dump[j]);
+        }
+    }
+
+    return kept;
+}
+
+/**
+* @brief
+*   Corrupt flash under a single crash dump and read it back.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_corrupt(VOID)
+{
+    test_dump_struct *dump_ptr = &test_dump[0];
+    crash_dump_header hdr;
+    UINT32 block_word;
+    UINT32 addr;
+    UINT32 block;
+    UINT32 keep;
+    UINT32 i;
+
+    for (block = 0; block < 2; block++)
+    {
+        /* payload length beyond the partition, in the second set */
+        host_flash_reset();
+        test_boot();
+        test_dump_create(dump_ptr);
+        HOST_CHECK(PMC_SUCCESS == test_crash(dump_ptr));
+
+        addr = test_block_word_addr(1, block);
+        host_flash_corrupt(addr + 2);
+
+        hdr.start_offset = 0;
+        hdr.size = dump_ptr->raw_size;
+        HOST_CHECK(PMC_SUCCESS == crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf)));
+
+        keep = dump_ptr->hdr[2].start_offset + (block * CRASH_DUMP_PLAT_LZ_BLOCK_SIZE);
+        HOST_CHECK(0 == memcmp(test_read_buf, dump_ptr->raw, keep));
+        for (i = keep; i < dump_ptr->raw_size; i++)
+        {
+            if (0 != test_read_buf[i])
+            {
+                break;
+            }
+        }
+        HOST_CHECK(dump_ptr->raw_size == i);
+    }
+
+    /* a stored block must hold the raw length, the first set is one random block */
+    host_flash_reset();
+    test_boot();
+    test_dump_create(dump_ptr);
+    for (i = 0; i < dump_ptr->hdr[2].start_offset; i++)
+    {
+        dump_ptr->raw[i] = (UINT8)host_rand();
+    }
+    HOST_CHECK(PMC_SUCCESS == test_crash(dump_ptr));
+
+    addr = test_block_word_addr(0, 0);
+    HOST_CHECK(TRUE == spi_flash_plat_checked_read((UINT8*)&block_word, (UINT8*)addr, sizeof(block_word)));
+    HOST_CHECK((CRASH_DUMP_PLAT_LZ_BLOCK_STORED | dump_ptr->hdr[2].start_offset) == block_word);
+    host_flash_corrupt(addr);
+
+    hdr = dump_ptr->hdr[0];
+    HOST_CHECK(PMC_SUCCESS == crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf)));
+    for (i = 0; i < hdr.size; i++)
+    {
+        HOST_CHECK(0 == test_read_buf[i]);
+    }
+
+    /* raw size of the frame beyond the data section */
+    host_flash_reset();
+    test_boot();
+    test_dump_create(dump_ptr);
+    HOST_CHECK(PMC_SUCCESS == test_crash(dump_ptr));
+    host_flash_corrupt(spi_flash_header_address + CRASH_DUMP_HEADER_SECTION_SIZE + offsetof(crash_dump_plat_frame_header, raw_size) + 3);
+
+    hdr = dump_ptr->hdr[0];
+    HOST_CHECK(PMC_SUCCESS == crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf)));
+    for (i = 0; i < hdr.size; i++)
+    {
+        HOST_CHECK(0 == test_read_buf[i]);
+    }
+    HOST_CHECK(PMC_SUCCESS == crash_dump_plat_header_entry_get(0, &hdr));
+
+    /* a header entry pointing beyond the data section */
+    hdr.start_offset = 0xFFFFF000;
+    hdr.size = 0x2000;
+    HOST_CHECK(PMC_SUCCESS == crash_dump_plat_data_section_get(&hdr, test_read_buf, sizeof(test_read_buf)));
+}
+
+/**
+* @brief
+*   Cut the power at every flash operation of a crash that follows two
+*   kept crash dumps.
+*
+* @return
+*   Number of flash operations of the crash.
+*/
+PRIVATE UINT32 test_cut(VOID)
+{
+    UINT32 header_ops = CRASH_DUMP_HEADER_SECTION_SIZE / HOST_FLASH_PAGE_SIZE;
+    BOOL complete;
+    UINT32 ops;
+    UINT32 start;
+    UINT32 cut;
+
+    host_srand(2);
+    host_flash_reset();
+    test_boot();
+    test_dump_create(&test_dump[0]);
+    test_dump_create(&test_dump[1]);
+    test_dump_create(&test_dump[2]);
+    test_dump_create(&test_dump[3]);
+
+    HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[0]));
+    HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[1]));
+    start = host_flash_op_count();
+    HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[2]));
+    ops = host_flash_op_count() - start;
+
+    for (cut = 0; cut < ops; cut++)
+    {
+        host_flash_reset();
+        test_boot();
+        HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[0]));
+        HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[1]));
+
+        host_flash_power_cut_set(cut);
+        HOST_CHECK(PMC_SUCCESS != test_crash(&test_dump[2]));
+        HOST_CHECK(TRUE == host_flash_power_is_off());
+
+        /*
+        ** the header is written last, the boot finds the crash dump before
+        ** unless the cut is past the page holding the header entries
+        */
+        complete = (cut > (ops - header_ops));
+        test_boot();
+        HOST_CHECK(test_dump[(TRUE == complete) ? 2 : 1].rec_offset == crash_dump_lz_rec_offset);
+        test_dump_check(&test_dump[0]);
+        test_dump_check(&test_dump[1]);
+        if (TRUE == complete)
+        {
+            test_dump_check(&test_dump[2]);
+        }
+
+        /*
+        ** the next crash goes after the torn one, or in its place when
+        ** nothing of it can be read
+        */
+        HOST_CHECK(PMC_SUCCESS == test_crash(&test_dump[3]));
+        HOST_CHECK(test_dump[3].rec_offset >= test_dump[2].rec_offset);
+        if (TRUE == complete)
+        {
+            HOST_CHECK(test_dump[3].rec_offset > test_dump[2].rec_offset);
+        }
+        test_boot();
+        HOST_CHECK(test_dump[3].rec_offset == crash_dump_lz_rec_offset);
+        test_dump_check(&test_dump[0]);
+        test_dump_check(&test_dump[1]);
+        test_dump_check(&test_dump[3]);
+    }
+
+    return ops;
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 kept;
+    UINT32 ops;
+
+    host_srand(0);
+    kept = test_retention();
+
+    /* the uncompressed layout held a single crash dump */
+    HOST_CHECK(kept >= 4);
+
+    host_srand(1);
+    test_corrupt();
+
+    ops = test_cut();
+
+    printf("crash dump: %u crash dumps kept, power cut at each of %u flash operations\n",
+           (unsigned)kept, (unsigned)ops);
+
+    return host_test_result("test_crash_dump_lz");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
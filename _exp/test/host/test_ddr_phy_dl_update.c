@@ -0,0 +1,513 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the delay line and ZQ update policy of ddr_phy_dl_update.c.
+*
+* @note
+*   Usage: test_ddr_phy_dl_update [<trace> ...]
+*
+*   The DIMM temperature sensors, the timer and the PHY library calls are
+*   stubbed. A temperature trace is replayed through
+*   ddr_phy_dl_update_task(), one reading per call, and the update each
+*   reading must fire (none, delay line, delay line and ZQ, deferred or
+*   failed) is checked against the pmc_profile.h thresholds. The sensor
+*   decode, the ZQ calibration of each rank, the gating while the PHY is
+*   not trained or trains, and the forced update are checked too.
+*
+*   A trace file, "<seconds> <degrees C>" per line as dl_update_sim.py
+*   reads it, is replayed the same way and each update is printed as
+*   "<seconds> dl" or "<seconds> dl+zq", so test_dl_update_sim.py can
+*   compare the firmware with the simulation. The test includes
+*   ddr_phy_dl_update.c to restart the policy between traces.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "ddr_phy_dl_update.c"
+
+/*
+** Local Constants
+*/
+
+/* Temperature in 1/16 degree C */
+#define TEST_C(c)                   ((INT16)((c) * 16))
+
+/* Update fired by a reading */
+#define TEST_NONE                   0
+#define TEST_DL                     1
+#define TEST_DL_ZQ                  2
+#define TEST_DEFERRED               3
+#define TEST_FAIL                   4
+
+/* Error of a failed delay line update */
+#define TEST_DL_ERR                 0x77
+
+/* Trace file line */
+#define TEST_LINE_MAX               128
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Reading of a trace and the update it must fire.
+*/
+typedef struct
+{
+    UINT32 seconds;             /**< Timer0 seconds of the reading */
+    INT16  temp;                /**< 1/16 degree C */
+    UINT8  update;              /**< TEST_xxx */
+} test_reading_struct;
+
+/*
+** Private Data
+*/
+
+/*
+** Thresholds of pmc_profile.h: delay line at 4 C, ZQ at 8 C, 10 s apart.
+** The references follow each update, a failed update leaves them and
+** restarts the interval.
+*/
+PRIVATE const test_reading_struct test_trace[] =
+{
+    {   0, TEST_C(40),         TEST_NONE     },    /* references */
+    {   5, TEST_C(40) + 63,    TEST_NONE     },    /* 1/16 C below the threshold */
+    {  10, TEST_C(44),         TEST_DL       },    /* at the threshold, 10 s after the references */
+    {  15, TEST_C(48.5),       TEST_DEFERRED },    /* ZQ due too, 5 s after the update */
+    {  20, TEST_C(48.5),       TEST_DL_ZQ    },
+    {  25, TEST_C(44.5),       TEST_DEFERRED },
+    {  30, TEST_C(44.5),       TEST_DL       },    /* 4 C down, 4 C from the ZQ reference */
+    {  40, TEST_C(40.5),       TEST_DL_ZQ    },
+    {  50, TEST_C(36),         TEST_DL       },
+    {  60, TEST_C(-2),         TEST_DL_ZQ    },    /* below 0 C */
+    {  70, TEST_C(-2),         TEST_NONE     },
+    {  80, TEST_C(2),          TEST_DL       },
+    {  90, TEST_C(6),          TEST_FAIL     },    /* test_dl_fail_seconds */
+    {  95, TEST_C(6),          TEST_DEFERRED },    /* the failed update restarted the interval */
+    { 100, TEST_C(6),          TEST_DL_ZQ    },    /* 8 C from the ZQ reference of 60 s */
+    { 200, TEST_C(9.9375),     TEST_NONE     },
+};
+
+/* Seconds of the reading whose delay line update fails */
+PRIVATE UINT32 test_dl_fail_seconds = 90;
+
+/* Sensor readings, as the JEDEC register with the bytes swapped */
+PRIVATE temp_sensor_plat_reading_struct test_sensor[TEMP_SENSOR_PLAT_DIMM1 + 1];
+
+/* Stub state */
+PRIVATE UINT32 test_seconds;
+PRIVATE BOOL test_initialized;
+PRIVATE BOOL test_busy;
+PRIVATE UINT32 test_dl_calls;
+PRIVATE UINT32 test_zq_calls;
+PRIVATE UINT32 test_zq_cs_mask;
+PRIVATE BOOL test_bist_cmd;
+
+/*
+** Firmware Stubs
+*/
+
+PUBLIC user_input_msdg_t user_input_msdg_array[DDR_PHY_NUM_USER_INPUT_MSDG_CONFIG];
+
+PUBLIC VOID temp_sensor_plat_reading_get(temp_sensor_plat_sensor_enum sensor,
+                                         temp_sensor_plat_reading_struct *reading_ptr)
+{
+    *reading_ptr = test_sensor[sensor];
+}
+
+PUBLIC UINT32 opsw_timer0_read(VOID)
+{
+    return test_seconds;
+}
+
+PUBLIC BOOL ddr_phy_plat_initialized_get(VOID)
+{
+    return test_initialized;
+}
+
+PUBLIC BOOL ddr_phy_train_busy_get(VOID)
+{
+    return test_busy;
+}
+
+PUBLIC uint32_t ddrBistInit(uint8_t ps, ddr_bist_setup_t *setup)
+{
+    test_bist_cmd = TRUE;
+    return 0;
+}
+
+PUBLIC VOID ddrBistSetup(ddr_bist_setup_t *setup)
+{
+}
+
+PUBLIC VOID ddrEnterPubMode(VOID)
+{
+}
+
+PUBLIC uint32_t ddrphy_force_dl_update(VOID)
+{
+    HOST_CHECK(TRUE == test_bist_cmd);
+    test_dl_calls++;
+    return (test_dl_fail_seconds == test_seconds) ? TEST_DL_ERR : PMC_SUCCESS;
+}
+
+PUBLIC uint32_t ddrBistZQCS(int csn)
+{
+    HOST_CHECK(TRUE == test_bist_cmd);
+    test_zq_calls++;
+    test_zq_cs_mask |= (1 << csn);
+    return PMC_SUCCESS;
+}
+
+PUBLIC VOID ddrExitBistCmd(VOID)
+{
+    test_bist_cmd = FALSE;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Set a DIMM sensor reading.
+*
+* @param[in] sensor - TEMP_SENSOR_PLAT_DIMMx
+* @param[in] valid  - TRUE if the reading is valid
+* @param[in] temp   - 1/16 degree C
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_sensor_set(UINT32 sensor, BOOL valid, INT16 temp)
+{
+    /* 13 bit two's complement, alarm bits set to check they are masked */
+    UINT16 raw = (UINT16)(0xE000 | ((UINT16)temp & DDR_PHY_DL_UPDATE_TEMP_MASK));
+
+    test_sensor[sensor].temp = (UINT16)((raw >> 8) | (raw << 8));
+    test_sensor[sensor].flags = TEMP_SENSOR_PLAT_FLAG_PRESENT | (valid ? TEMP_SENSOR_PLAT_FLAG_VALID : 0);
+    test_sensor[sensor].seconds = test_seconds;
+}
+
+/**
+* @brief
+*   Restart the policy as after training.
+*
+* @param[in] cs_present - ranks of the DIMM
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_reset(UINT32 cs_present)
+{
+    memset(&ddr_phy_dl_update_status, 0, sizeof(ddr_phy_dl_update_status));
+    memset(test_sensor, 0, sizeof(test_sensor));
+    user_input_msdg_array[DDR_PHY_DEFAULT_USER_INPUT_MSDG].CsPresent = cs_present;
+    test_seconds = 0;
+    test_initialized = TRUE;
+    test_busy = FALSE;
+    test_dl_calls = 0;
+    test_zq_calls = 0;
+    test_zq_cs_mask = 0;
+}
+
+/**
+* @brief
+*   Replay a reading of DIMM 0.
+*
+* @param[in] seconds - Timer0 seconds
+* @param[in] temp    - 1/16 degree C
+*
+* @return
+*   TEST_xxx, the update fired.
+*/
+PRIVATE UINT32 test_reading(UINT32 seconds, INT16 temp)
+{
+    ddr_phy_dl_update_status_struct before;
+    ddr_phy_dl_update_status_struct after;
+
+    test_seconds = seconds;
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM0, TRUE, temp);
+
+    ddr_phy_dl_update_status_get(&before);
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&after);
+
+    HOST_CHECK(FALSE == test_bist_cmd);
+    HOST_CHECK((before.eval_count + 1) == after.eval_count);
+    HOST_CHECK(temp == after.temp);
+
+    if (after.fail_count != before.fail_count)
+    {
+        HOST_CHECK(TEST_DL_ERR == after.last_rc);
+        HOST_CHECK(before.dl_ref_temp == after.dl_ref_temp);
+        return TEST_FAIL;
+    }
+    if (after.deferred_count != before.deferred_count)
+    {
+        return TEST_DEFERRED;
+    }
+    if (after.dl_count == before.dl_count)
+    {
+        return TEST_NONE;
+    }
+
+    HOST_CHECK(temp == after.dl_ref_temp);
+    HOST_CHECK(seconds == after.last_seconds);
+    if (after.zq_count == before.zq_count)
+    {
+        return TEST_DL;
+    }
+    HOST_CHECK(temp == after.zq_ref_temp);
+    return TEST_DL_ZQ;
+}
+
+/**
+* @brief
+*   Replay the trace and check the update of each reading.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_policy(VOID)
+{
+    ddr_phy_dl_update_status_struct status;
+    UINT32 counts[TEST_FAIL + 1];
+    UINT32 update;
+    UINT32 i;
+
+    memset(counts, 0, sizeof(counts));
+    test_reset(0x5);
+
+    for (i = 0; i < (sizeof(test_trace) / sizeof(test_trace[0])); i++)
+    {
+        update = test_reading(test_trace[i].seconds, test_trace[i].temp);
+        if (update != test_trace[i].update)
+        {
+            printf("  %u s: update %u, expected %u\n",
+                   (unsigned)test_trace[i].seconds, (unsigned)update, (unsigned)test_trace[i].update);
+        }
+        HOST_CHECK(update == test_trace[i].update);
+        counts[test_trace[i].update]++;
+    }
+
+    /* the PHY was called for each update, ZQ of ranks 0 and 2 */
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(TRUE == status.enabled);
+    HOST_CHECK((counts[TEST_DL] + counts[TEST_DL_ZQ]) == status.dl_count);
+    HOST_CHECK(counts[TEST_DL_ZQ] == status.zq_count);
+    HOST_CHECK(counts[TEST_DEFERRED] == status.deferred_count);
+    HOST_CHECK(counts[TEST_FAIL] == status.fail_count);
+    HOST_CHECK((status.dl_count + status.fail_count) == test_dl_calls);
+    HOST_CHECK((2 * status.zq_count) == test_zq_calls);
+    HOST_CHECK(0x5 == test_zq_cs_mask);
+    HOST_CHECK(PMC_SUCCESS == status.last_rc);
+
+    printf("  %u readings: %u delay line, %u with ZQ, %u deferred, %u failed\n",
+           (unsigned)(sizeof(test_trace) / sizeof(test_trace[0])),
+           (unsigned)status.dl_count, (unsigned)status.zq_count,
+           (unsigned)status.deferred_count, (unsigned)status.fail_count);
+}
+
+/**
+* @brief
+*   Hottest valid DIMM, no evaluation without a reading or a trained PHY,
+*   forced updates.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_gating(VOID)
+{
+    ddr_phy_dl_update_status_struct status;
+    UINT32 deferred;
+
+    test_reset(0x1);
+
+    /* no valid reading */
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM0, FALSE, TEST_C(30));
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(0 == status.eval_count);
+    HOST_CHECK(FALSE == status.ref_valid);
+
+    /* the hottest of both DIMMs, then of the valid one */
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM0, TRUE, TEST_C(-5));
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM1, TRUE, TEST_C(-3.5));
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(TEST_C(-3.5) == status.temp);
+    HOST_CHECK(TEST_C(-3.5) == status.dl_ref_temp);
+
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM1, TRUE, TEST_C(70));
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(TEST_C(70) == status.temp);
+
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM1, FALSE, TEST_C(70));
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(TEST_C(-5) == status.temp);
+    HOST_CHECK(3 == status.eval_count);
+
+    /* nothing runs before training or while EXP_FW_DDR_PHY_INIT trains */
+    test_seconds = 100;
+    test_sensor_set(TEMP_SENSOR_PLAT_DIMM0, TRUE, TEST_C(60));
+    test_initialized = FALSE;
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(FALSE == status.enabled);
+    HOST_CHECK(3 == status.eval_count);
+
+    test_initialized = TRUE;
+    test_busy = TRUE;
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(FALSE == status.enabled);
+    HOST_CHECK(3 == status.eval_count);
+    HOST_CHECK(DDR_PHY_TRAIN_ERR_BUSY == ddr_phy_dl_update_force());
+    HOST_CHECK(0 == test_dl_calls);
+
+    /* a forced update moves the delay line reference, not the ZQ one */
+    test_busy = FALSE;
+    HOST_CHECK(PMC_SUCCESS == ddr_phy_dl_update_force());
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(1 == status.forced_count);
+    HOST_CHECK(TEST_C(60) == status.dl_ref_temp);
+    HOST_CHECK(TEST_C(-3.5) == status.zq_ref_temp);
+    HOST_CHECK(100 == status.last_seconds);
+    HOST_CHECK((1 == test_dl_calls) && (0 == test_zq_calls));
+
+    /* and restarts the interval, the ZQ calibration it left due waits */
+    deferred = status.deferred_count;
+    test_seconds = 105;
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK((deferred + 1) == status.deferred_count);
+    test_seconds = 110;
+    ddr_phy_dl_update_task();
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK((1 == status.dl_count) && (1 == status.zq_count));
+    HOST_CHECK(TEST_C(60) == status.zq_ref_temp);
+}
+
+/**
+* @brief
+*   Replay a trace file and print the updates.
+*
+* @param[in] path_ptr - trace, "<seconds> <degrees C>" per line
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_file(const CHAR *path_ptr)
+{
+    ddr_phy_dl_update_status_struct status;
+    CHAR line[TEST_LINE_MAX];
+    CHAR *field_ptr;
+    FILE *file_ptr;
+    double seconds;
+    double temp;
+    UINT32 readings = 0;
+    UINT32 update;
+
+    file_ptr = fopen(path_ptr, "r");
+    if (NULL == file_ptr)
+    {
+        printf("  %s: cannot open\n", path_ptr);
+        HOST_CHECK(FALSE);
+        return;
+    }
+
+    test_reset(0x1);
+    test_dl_fail_seconds = 0xFFFFFFFF;
+
+    while (NULL != fgets(line, sizeof(line), file_ptr))
+    {
+        /* as dl_update_sim.py: '#' comments, blank or comma separated */
+        field_ptr = strchr(line, '#');
+        if (NULL != field_ptr)
+        {
+            *field_ptr = '\0';
+        }
+        for (field_ptr = line; '\0' != *field_ptr; field_ptr++)
+        {
+            *field_ptr = (',' == *field_ptr) ? ' ' : *field_ptr;
+        }
+        if (2 != sscanf(line, "%lf %lf", &seconds, &temp))
+        {
+            continue;
+        }
+
+        update = test_reading((UINT32)seconds, (INT16)((temp * 16) + ((temp < 0) ? -0.5 : 0.5)));
+        readings++;
+
+        if ((TEST_DL == update) || (TEST_DL_ZQ == update))
+        {
+            printf("%u %s\n", (unsigned)seconds, (TEST_DL_ZQ == update) ? "dl+zq" : "dl");
+        }
+    }
+    fclose(file_ptr);
+
+    ddr_phy_dl_update_status_get(&status);
+    HOST_CHECK(readings == status.eval_count);
+    printf("readings %u deferred %u\n", (unsigned)readings, (unsigned)status.deferred_count);
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    int arg;
+
+    if (argc > 1)
+    {
+        for (arg = 1; arg < argc; arg++)
+        {
+            test_file(argv[arg]);
+        }
+        return host_test_result("test_ddr_phy_dl_update");
+    }
+
+    printf("delay line update at %u/16 C, ZQ at %u/16 C, %u s apart\n",
+           (unsigned)EXPLORER_DDR_DL_UPDATE_TEMP_DELTA,
+           (unsigned)EXPLORER_DDR_ZQ_UPDATE_TEMP_DELTA,
+           (unsigned)EXPLORER_DDR_DL_UPDATE_MIN_INTERVAL_S);
+
+    test_policy();
+    test_gating();
+
+    return host_test_result("test_ddr_phy_dl_update");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,535 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the 2D eye capture encoding of ddr_phy_eye.c.
+*
+* @note
+*   Captures are encoded, read back in chunks through
+*   ddr_phy_eye_session_read() and decoded by the decoder of this test,
+*   written from the stream format of ddr_phy_eye.h. Each eye must come
+*   back in the expected record format with its rows unchanged, or as the
+*   bitmap of its rows.
+*
+*   - Empty, smooth (delta) and noisy (raw) eyes of a read and a write
+*     capture that fit the buffer.
+*   - The same capture with the bitmap requested.
+*   - A capture of noisy eyes only, which does not fit: the eyes that no
+*     longer fit are bitmaps and DDR_PHY_EYE_FLAG_REDUCED is set.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "ddr_api.h"
+#include "ddr_phy_eye.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+/* Chunk of a read-out, odd so records straddle chunks */
+#define TEST_CHUNK_SIZE             61
+
+/* Eye contents */
+#define TEST_EYE_EMPTY              0
+#define TEST_EYE_SMOOTH             1
+#define TEST_EYE_NOISY              2
+
+/* Sizes of a raw and a bitmap record, including the format byte */
+#define TEST_RAW_REC_SIZE           (1 + (2 * DDR_PHY_EYE_NUM_STEPS * sizeof(UINT16)))
+#define TEST_BITMAP_REC_SIZE        (1 + sizeof(UINT32))
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Decoded eye.
+*/
+typedef struct
+{
+    UINT8  fmt;                                 /**< DDR_PHY_EYE_FMT_xxx */
+    UINT32 bitmap;                              /**< DDR_PHY_EYE_FMT_BITMAP */
+    UINT16 eye_min[DDR_PHY_EYE_NUM_STEPS];      /**< Other formats */
+    UINT16 eye_max[DDR_PHY_EYE_NUM_STEPS];
+} test_eye_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE train_2d_read_eye_msdg_t test_read;
+PRIVATE train_2d_write_eye_msdg_t test_write;
+PRIVATE user_response_msdg_t test_response;
+
+/* Stream read back and its decode */
+PRIVATE UINT8 test_stream[EXPLORER_DDR_PHY_EYE_BUF_SIZE];
+PRIVATE test_eye_struct test_eyes[DDR_PHY_EYE_NUM_EYES];
+
+/*
+** Firmware Stubs
+*/
+
+PUBLIC user_response_msdg_t *ddrphy_training_results_get(VOID)
+{
+    return &test_response;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Read a little endian UINT16 of the stream.
+*
+* @param[in,out] pos_ptr - stream offset, advanced past the value
+*
+* @return
+*   Value
+*/
+PRIVATE UINT16 test_u16_get(UINT32 *pos_ptr)
+{
+    UINT16 val = (UINT16)(test_stream[*pos_ptr] | (test_stream[*pos_ptr + 1] << 8));
+
+    *pos_ptr += sizeof(UINT16);
+    return val;
+}
+
+/**
+* @brief
+*   Decode a delta encoded row.
+*
+* @param[in,out] pos_ptr - stream offset, advanced past the row
+* @param[out]    row_ptr - DDR_PHY_EYE_NUM_STEPS values
+*
+* @return
+*   TRUE if the tokens make up the row exactly.
+*/
+PRIVATE BOOL test_row_decode(UINT32 *pos_ptr, UINT16 *row_ptr)
+{
+    INT32 delta = 0;
+    UINT32 i = 1;
+    UINT32 run;
+    UINT8 token;
+
+    row_ptr[0] = test_u16_get(pos_ptr);
+
+    while (i < DDR_PHY_EYE_NUM_STEPS)
+    {
+        token = test_stream[(*pos_ptr)++];
+
+        if (token < DDR_PHY_EYE_TOKEN_REPEAT)
+        {
+            /* signed 7 bit delta */
+            delta = (token & 0x40) ? ((INT32)token - 0x80) : (INT32)token;
+            row_ptr[i] = (UINT16)(row_ptr[i - 1] + delta);
+            i++;
+        }
+        else if (token < DDR_PHY_EYE_TOKEN_ABS)
+        {
+            for (run = (token & 0x3F) + 1; run > 0; run--)
+            {
+                if (i >= DDR_PHY_EYE_NUM_STEPS)
+                {
+                    return FALSE;
+                }
+                row_ptr[i] = (UINT16)(row_ptr[i - 1] + delta);
+                i++;
+            }
+        }
+        else if (DDR_PHY_EYE_TOKEN_ABS == token)
+        {
+            row_ptr[i++] = test_u16_get(pos_ptr);
+            delta = 0;
+        }
+        else
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+* @brief
+*   Read the session in chunks and decode it.
+*
+* @param[in]  len         - stream length returned by the encode
+* @param[in]  centers_ptr - center values of the capture
+* @param[in]  centers_len - their length
+* @param[out] hdr_ptr     - stream header
+*
+* @return
+*   TRUE if the stream is well formed and ends with the last eye.
+*/
+PRIVATE BOOL test_stream_decode(UINT32 len,
+                                const UINT8 *centers_ptr,
+                                UINT32 centers_len,
+                                ddr_phy_eye_hdr_struct *hdr_ptr)
+{
+    UINT32 pos = 0;
+    UINT32 num_bytes;
+    UINT32 i;
+    UINT32 j;
+
+    memset(test_stream, 0, sizeof(test_stream));
+    memset(test_eyes, 0, sizeof(test_eyes));
+
+    do
+    {
+        HOST_CHECK(PMC_SUCCESS == ddr_phy_eye_session_read(pos, &test_stream[pos], TEST_CHUNK_SIZE, &num_bytes));
+        pos += num_bytes;
+    } while ((0 != num_bytes) && (pos < sizeof(test_stream)));
+
+    HOST_CHECK(DDR_PHY_EYE_ERR_OFFSET == ddr_phy_eye_session_read(len + 1, test_stream, 1, &num_bytes));
+    if ((len != pos) || (len < sizeof(*hdr_ptr)))
+    {
+        return FALSE;
+    }
+
+    memcpy(hdr_ptr, test_stream, sizeof(*hdr_ptr));
+    HOST_CHECK(DDR_PHY_EYE_MAGIC == hdr_ptr->magic);
+    HOST_CHECK(DDR_PHY_EYE_VERSION == hdr_ptr->version);
+    HOST_CHECK(DDR_PHY_EYE_NUM_STEPS == hdr_ptr->num_steps);
+    HOST_CHECK(DDR_PHY_EYE_NUM_EYES == (hdr_ptr->num_ranks * hdr_ptr->num_dbytes * hdr_ptr->num_bits));
+    HOST_CHECK(DDR_PHY_EYE_NUM_EYES == hdr_ptr->num_eyes);
+    HOST_CHECK(test_response.version_number == hdr_ptr->msg_version);
+    HOST_CHECK(len == hdr_ptr->stream_len);
+
+    pos = sizeof(*hdr_ptr);
+    if ((centers_len != hdr_ptr->centers_len) ||
+        (0 != memcmp(&test_stream[pos], centers_ptr, centers_len)))
+    {
+        return FALSE;
+    }
+    pos += centers_len;
+
+    for (i = 0; (i < DDR_PHY_EYE_NUM_EYES) && (pos < len); i++)
+    {
+        test_eyes[i].fmt = test_stream[pos++];
+
+        switch (test_eyes[i].fmt)
+        {
+            case DDR_PHY_EYE_FMT_EMPTY:
+                break;
+
+            case DDR_PHY_EYE_FMT_BITMAP:
+                test_eyes[i].bitmap = test_u16_get(&pos);
+                test_eyes[i].bitmap |= (UINT32)test_u16_get(&pos) << 16;
+                break;
+
+            case DDR_PHY_EYE_FMT_DELTA:
+                if ((FALSE == test_row_decode(&pos, test_eyes[i].eye_min)) ||
+                    (FALSE == test_row_decode(&pos, test_eyes[i].eye_max)))
+                {
+                    return FALSE;
+                }
+                break;
+
+            case DDR_PHY_EYE_FMT_RAW:
+                for (j = 0; j < DDR_PHY_EYE_NUM_STEPS; j++)
+                {
+                    test_eyes[i].eye_min[j] = test_u16_get(&pos);
+                }
+                for (j = 0; j < DDR_PHY_EYE_NUM_STEPS; j++)
+                {
+                    test_eyes[i].eye_max[j] = test_u16_get(&pos);
+                }
+                break;
+
+            default:
+                return FALSE;
+        }
+    }
+
+    return ((DDR_PHY_EYE_NUM_EYES == i) && (len == pos));
+}
+
+/**
+* @brief
+*   Fill an eye.
+*
+* @param[out] eye_ptr - eye
+* @param[in]  content - TEST_EYE_xxx
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_eye_fill(train_2d_eye_min_max_msdg_t *eye_ptr, UINT32 content)
+{
+    UINT16 base = (UINT16)(host_rand() & 0xFF);
+    UINT32 i;
+
+    for (i = 0; i < DDR_PHY_EYE_NUM_STEPS; i++)
+    {
+        switch (content)
+        {
+            case TEST_EYE_EMPTY:
+                eye_ptr->eye_min[i] = 0;
+                eye_ptr->eye_max[i] = 0;
+                break;
+
+            case TEST_EYE_SMOOTH:
+                /* closed at the edges, flat and sloped in between, a jump at the center */
+                eye_ptr->eye_min[i] = (UINT16)(base + ((i < 8) ? (40 - (5 * i)) : 0));
+                eye_ptr->eye_max[i] = (UINT16)((i < 3) || (i > 27) ? 0 : (base + 300 - (2 * i) + ((15 == i) ? 200 : 0)));
+                break;
+
+            default:
+                eye_ptr->eye_min[i] = (UINT16)host_rand();
+                eye_ptr->eye_max[i] = (UINT16)host_rand();
+                break;
+        }
+    }
+}
+
+/**
+* @brief
+*   Pass/fail bitmap of an eye, as ddr_phy_eye.h defines it.
+*
+* @param[in] eye_ptr - eye
+*
+* @return
+*   Bit n set if delay step n passes.
+*/
+PRIVATE UINT32 test_eye_bitmap(const train_2d_eye_min_max_msdg_t *eye_ptr)
+{
+    UINT32 bitmap = 0;
+    UINT32 i;
+
+    for (i = 0; i < DDR_PHY_EYE_NUM_STEPS; i++)
+    {
+        if ((0 != eye_ptr->eye_max[i]) && (eye_ptr->eye_max[i] >= eye_ptr->eye_min[i]))
+        {
+            bitmap |= (1UL << i);
+        }
+    }
+
+    return bitmap;
+}
+
+/**
+* @brief
+*   Check a decoded eye against the capture.
+*
+* @param[in] dec_ptr - decoded eye
+* @param[in] eye_ptr - captured eye
+* @param[in] fmt     - expected record format
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_eye_check(const test_eye_struct *dec_ptr, const train_2d_eye_min_max_msdg_t *eye_ptr, UINT8 fmt)
+{
+    HOST_CHECK(fmt == dec_ptr->fmt);
+
+    if (DDR_PHY_EYE_FMT_BITMAP == dec_ptr->fmt)
+    {
+        HOST_CHECK(test_eye_bitmap(eye_ptr) == dec_ptr->bitmap);
+    }
+    else
+    {
+        /* an empty eye decodes to zeroes */
+        HOST_CHECK(0 == memcmp(dec_ptr->eye_min, (const VOID *)eye_ptr->eye_min, sizeof(dec_ptr->eye_min)));
+        HOST_CHECK(0 == memcmp(dec_ptr->eye_max, (const VOID *)eye_ptr->eye_max, sizeof(dec_ptr->eye_max)));
+    }
+}
+
+/**
+* @brief
+*   Record format of an eye encoded in full.
+*
+* @param[in] content - TEST_EYE_xxx
+* @param[in] bitmap  - TRUE if bitmaps were requested
+*
+* @return
+*   DDR_PHY_EYE_FMT_xxx
+*/
+PRIVATE UINT8 test_eye_fmt(UINT32 content, BOOL bitmap)
+{
+    if (TEST_EYE_EMPTY == content)
+    {
+        return DDR_PHY_EYE_FMT_EMPTY;
+    }
+    if (TRUE == bitmap)
+    {
+        return DDR_PHY_EYE_FMT_BITMAP;
+    }
+    return (TEST_EYE_SMOOTH == content) ? DDR_PHY_EYE_FMT_DELTA : DDR_PHY_EYE_FMT_RAW;
+}
+
+/**
+* @brief
+*   Encode and decode a capture that fits the buffer, in full and as
+*   bitmaps.
+*
+* @param[in] type - DDR_PHY_EYE_TYPE_xxx
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_mixed(UINT8 type)
+{
+    train_2d_eye_min_max_msdg_t *eyes_ptr;
+    UINT8 *capture_ptr;
+    UINT32 capture_len;
+    UINT32 content[DDR_PHY_EYE_NUM_EYES];
+    UINT32 eyes_size = DDR_PHY_EYE_NUM_EYES * sizeof(train_2d_eye_min_max_msdg_t);
+    ddr_phy_eye_hdr_struct hdr;
+    UINT32 len;
+    UINT32 pass;
+    UINT32 i;
+
+    if (DDR_PHY_EYE_TYPE_READ == type)
+    {
+        capture_ptr = (UINT8 *)&test_read;
+        capture_len = sizeof(test_read);
+        eyes_ptr = &test_read.VrefDAC0[0][0][0];
+    }
+    else
+    {
+        capture_ptr = (UINT8 *)&test_write;
+        capture_len = sizeof(test_write);
+        eyes_ptr = &test_write.VrefDQ[0][0][0];
+    }
+
+    /* rank 0 smooth, the first DBYTEs of rank 1 noisy, the rest disabled */
+    for (i = 0; i < capture_len; i++)
+    {
+        capture_ptr[i] = (UINT8)host_rand();
+    }
+    for (i = 0; i < DDR_PHY_EYE_NUM_EYES; i++)
+    {
+        content[i] = TEST_EYE_EMPTY;
+        if (i < (DDR_PHY_EYE_NUM_DBYTES * DDR_PHY_EYE_NUM_BITS))
+        {
+            content[i] = TEST_EYE_SMOOTH;
+        }
+        else if (i < ((DDR_PHY_EYE_NUM_DBYTES + 4) * DDR_PHY_EYE_NUM_BITS))
+        {
+            content[i] = TEST_EYE_NOISY;
+        }
+        test_eye_fill(&eyes_ptr[i], content[i]);
+    }
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        len = ddr_phy_eye_session_encode(type, (0 == pass) ? 0 : DDR_PHY_EYE_FLAG_BITMAP, 0x1234, capture_ptr);
+        HOST_CHECK(len <= EXPLORER_DDR_PHY_EYE_BUF_SIZE);
+        HOST_CHECK(TRUE == test_stream_decode(len, &capture_ptr[eyes_size], capture_len - eyes_size, &hdr));
+        HOST_CHECK(type == hdr.type);
+        HOST_CHECK(0x1234 == hdr.train_rc);
+        HOST_CHECK(((0 == pass) ? 0 : DDR_PHY_EYE_FLAG_BITMAP) == hdr.flags);
+
+        for (i = 0; i < DDR_PHY_EYE_NUM_EYES; i++)
+        {
+            test_eye_check(&test_eyes[i], &eyes_ptr[i], test_eye_fmt(content[i], (0 != pass)));
+        }
+
+        printf("  %s capture, %s %5u bytes\n",
+               (DDR_PHY_EYE_TYPE_READ == type) ? "read " : "write",
+               (0 == pass) ? "full:   " : "bitmaps:",
+               (unsigned)len);
+    }
+}
+
+/**
+* @brief
+*   A capture of noisy eyes falls back to bitmaps for the eyes that no
+*   longer fit.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_full(VOID)
+{
+    train_2d_eye_min_max_msdg_t *eyes_ptr = &test_write.VrefDQ[0][0][0];
+    UINT32 eyes_size = DDR_PHY_EYE_NUM_EYES * sizeof(train_2d_eye_min_max_msdg_t);
+    ddr_phy_eye_hdr_struct hdr;
+    UINT32 raw = 0;
+    UINT32 len;
+    UINT32 i;
+
+    for (i = 0; i < DDR_PHY_EYE_NUM_EYES; i++)
+    {
+        test_eye_fill(&eyes_ptr[i], TEST_EYE_NOISY);
+    }
+
+    len = ddr_phy_eye_session_encode(DDR_PHY_EYE_TYPE_WRITE, 0, 0, (UINT8 *)&test_write);
+    HOST_CHECK(TRUE == test_stream_decode(len, (UINT8 *)&test_write + eyes_size, sizeof(test_write) - eyes_size, &hdr));
+    HOST_CHECK(DDR_PHY_EYE_FLAG_REDUCED == hdr.flags);
+
+    /* raw while they fit with a bitmap kept for each eye after, then bitmaps */
+    while ((raw < DDR_PHY_EYE_NUM_EYES) && (DDR_PHY_EYE_FMT_RAW == test_eyes[raw].fmt))
+    {
+        raw++;
+    }
+    HOST_CHECK(0 != raw);
+    for (i = 0; i < DDR_PHY_EYE_NUM_EYES; i++)
+    {
+        test_eye_check(&test_eyes[i], &eyes_ptr[i], (i < raw) ? DDR_PHY_EYE_FMT_RAW : DDR_PHY_EYE_FMT_BITMAP);
+    }
+
+    /* no room was left for one more raw eye */
+    HOST_CHECK(len <= EXPLORER_DDR_PHY_EYE_BUF_SIZE);
+    HOST_CHECK((len + TEST_RAW_REC_SIZE - TEST_BITMAP_REC_SIZE) > EXPLORER_DDR_PHY_EYE_BUF_SIZE);
+
+    printf("  write capture, noisy:   %5u bytes, %u of %u eyes raw\n",
+           (unsigned)len, (unsigned)raw, (unsigned)DDR_PHY_EYE_NUM_EYES);
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 num_bytes;
+    UINT8 byte;
+
+    host_srand(0);
+    test_response.version_number = 0x55AA0001;
+
+    printf("eye captures of %u eyes, %u byte buffer\n",
+           (unsigned)DDR_PHY_EYE_NUM_EYES, (unsigned)EXPLORER_DDR_PHY_EYE_BUF_SIZE);
+
+    HOST_CHECK(DDR_PHY_EYE_ERR_NO_SESSION == ddr_phy_eye_session_read(0, &byte, 1, &num_bytes));
+    HOST_CHECK(0 == num_bytes);
+
+    test_mixed(DDR_PHY_EYE_TYPE_READ);
+    test_mixed(DDR_PHY_EYE_TYPE_WRITE);
+    test_full();
+
+    return host_test_result("test_ddr_phy_eye");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,310 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test and load time benchmark of the packed DDR PHY PMU training
+*   firmware images, ddr_phy_pmu_image.c.
+*
+* @note
+*   Usage: test_ddr_phy_pmu_image <PHY firmware directory>
+*
+*   The blob written by pmu_image_pack.py is linked into the test as a raw
+*   binary, as app_fw.ld links it into the image. Every image is requested
+*   through platform_dram_binary_get(), as the PHY library does, and must
+*   match the raw image of the firmware directory.
+*
+*   The load time of each image is measured with the decode from the blob
+*   and with a memcpy() of the raw image into the same buffer, which is
+*   what the load costs before the PHY library writes it out when the
+*   images are stored unpacked. Both are host figures, the ratio of the
+*   two is what carries over to the target.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "app_fw.h"
+#include "sys_timer_api.h"
+#include "ddr_phy_pmu_image.h"
+#include "ddr_phy_train.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+/* Minimum time per load time measurement */
+#define TEST_BENCH_NS               100000000ULL
+
+/* Images per DIMM type and training phase */
+#define TEST_MEMS                   2
+
+/*
+** Local Structures and Unions
+*/
+
+typedef struct
+{
+    const CHAR *dir_ptr;    /* subdirectory of the variant */
+    UINT32 dimm_type;       /* DDR_PHY_PMU_IMAGE_DIMM_xxx */
+    UINT32 train_2d;        /* 1 for the 2D training firmware */
+} test_variant_struct;
+
+/*
+** Private Data
+*/
+
+/* Variants in the directory order of the blob */
+PRIVATE const test_variant_struct test_variants[] =
+{
+    { "ddr4",          DDR_PHY_PMU_IMAGE_DIMM_UDIMM,  0 },
+    { "ddr4_2d",       DDR_PHY_PMU_IMAGE_DIMM_UDIMM,  1 },
+    { "ddr4_rdimm",    DDR_PHY_PMU_IMAGE_DIMM_RDIMM,  0 },
+    { "ddr4_rdimm2d",  DDR_PHY_PMU_IMAGE_DIMM_RDIMM,  1 },
+    { "ddr4_lrdimm",   DDR_PHY_PMU_IMAGE_DIMM_LRDIMM, 0 },
+    { "ddr4_lrdimm2d", DDR_PHY_PMU_IMAGE_DIMM_LRDIMM, 1 },
+};
+
+PRIVATE const CHAR * const test_mems[TEST_MEMS] = { "imem", "dmem" };
+
+/* Arguments of the last ddr_phy_train_pmu_load() call */
+PRIVATE UINT32 test_load_calls;
+PRIVATE UINT32 test_load_2d;
+PRIVATE BOOL test_load_dmem;
+
+/* Image buffer of the memcpy() measurement */
+PRIVATE UINT8 test_copy_buf[EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE];
+
+/*
+** Firmware Stubs
+*/
+
+/* The blob, linked from obj/ddr_phy_pmu_images.bin, see the makefile */
+EXTERN UINT8 __ghsbegin_ddr_phy_pmu_images[];
+EXTERN UINT8 __ghsend_ddr_phy_pmu_images[];
+
+PUBLIC UINT32 exp_plat_get_pic_offset(void)
+{
+    return 0;
+}
+
+PUBLIC UINT32 hal_cp0_counter_get(VOID)
+{
+    return (UINT32)host_cycles();
+}
+
+PRIVATE UINT_TIME test_count_to_us(UINT_TIME count)
+{
+    return count;
+}
+
+PUBLIC sys_timer_count_to_us_fn_ptr_type sys_timer_count_to_us_fn_ptr = test_count_to_us;
+
+PUBLIC VOID ddr_phy_train_pmu_load(UINT32 train_2d, BOOL dmem)
+{
+    test_load_calls++;
+    test_load_2d = train_2d;
+    test_load_dmem = dmem;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Request an image as the PHY library does.
+*
+* @param[in]  variant_ptr - DIMM type and training phase
+* @param[in]  mem         - 0 for IMEM, 1 for DMEM
+* @param[out] len_ptr     - image length
+*
+* @return
+*   Decoded image.
+*/
+PRIVATE UINT8 *test_image_get(const test_variant_struct *variant_ptr, UINT32 mem, UINT32 *len_ptr)
+{
+    UINT8 *image_ptr = NULL;
+
+    if (0 == mem)
+    {
+        platform_dram_binary_get(variant_ptr->dimm_type, variant_ptr->train_2d, &image_ptr, len_ptr, NULL, NULL);
+    }
+    else
+    {
+        platform_dram_binary_get(variant_ptr->dimm_type, variant_ptr->train_2d, NULL, NULL, &image_ptr, len_ptr);
+    }
+
+    return image_ptr;
+}
+
+/**
+* @brief
+*   Nanoseconds per load of an image, decoded or copied.
+*
+* @param[in] variant_ptr - DIMM type and training phase
+* @param[in] mem         - 0 for IMEM, 1 for DMEM
+* @param[in] raw_ptr     - raw image to copy, NULL to decode the image
+* @param[in] raw_len     - raw image length
+*
+* @return
+*   Time per load.
+*/
+PRIVATE double test_load_time(const test_variant_struct *variant_ptr, UINT32 mem, const UINT8 *raw_ptr, UINT32 raw_len)
+{
+    UINT64 start = host_time_ns();
+    UINT64 elapsed;
+    UINT32 runs = 0;
+    UINT32 len;
+
+    do
+    {
+        if (NULL == raw_ptr)
+        {
+            (VOID)test_image_get(variant_ptr, mem, &len);
+        }
+        else
+        {
+            memcpy(test_copy_buf, raw_ptr, raw_len);
+            __asm__ volatile("" : : "r"(test_copy_buf) : "memory");
+        }
+        runs++;
+        elapsed = host_time_ns() - start;
+    } while (elapsed < TEST_BENCH_NS);
+
+    return (double)elapsed / runs;
+}
+
+/**
+* @brief
+*   Check and measure the loads of one variant.
+*
+* @param[in]  fw_dir_ptr  - PHY firmware directory
+* @param[in]  variant_ptr - DIMM type and training phase
+* @param[out] raw_sum_ptr - raw image lengths, added to
+* @param[out] dec_sum_ptr - decode times, added to
+* @param[out] cpy_sum_ptr - copy times, added to
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_variant(const CHAR *fw_dir_ptr,
+                          const test_variant_struct *variant_ptr,
+                          UINT32 *raw_sum_ptr,
+                          double *dec_sum_ptr,
+                          double *cpy_sum_ptr)
+{
+    CHAR path[512];
+    UINT32 mem;
+
+    for (mem = 0; mem < TEST_MEMS; mem++)
+    {
+        UINT8 *raw_ptr;
+        UINT8 *image_ptr;
+        UINT32 raw_len = 0;
+        UINT32 len = 0;
+        double dec_ns;
+        double cpy_ns;
+
+        snprintf(path, sizeof(path), "%s/%s/%s_pmu_train_%s.bin",
+                 fw_dir_ptr, variant_ptr->dir_ptr, variant_ptr->dir_ptr, test_mems[mem]);
+        raw_ptr = host_file_read(path, &raw_len);
+        if (!HOST_CHECK(NULL != raw_ptr))
+        {
+            continue;
+        }
+
+        /* the image must decode bit exact, and report the phase of the load */
+        test_load_calls = 0;
+        image_ptr = test_image_get(variant_ptr, mem, &len);
+        HOST_CHECK(1 == test_load_calls);
+        HOST_CHECK(variant_ptr->train_2d == test_load_2d);
+        HOST_CHECK((0 != mem) == test_load_dmem);
+        HOST_CHECK(NULL != image_ptr);
+        HOST_CHECK(raw_len == len);
+        HOST_CHECK((NULL != image_ptr) && (raw_len == len) && (0 == memcmp(image_ptr, raw_ptr, raw_len)));
+
+        dec_ns = test_load_time(variant_ptr, mem, NULL, raw_len);
+        cpy_ns = test_load_time(variant_ptr, mem, raw_ptr, raw_len);
+
+        printf("  %-33s %6u bytes  decode %7.1f us %7.1f MB/s  memcpy %6.1f us\n",
+               strrchr(path, '/') + 1,
+               (unsigned)raw_len,
+               dec_ns / 1000.0,
+               (raw_len * 1000.0) / dec_ns,
+               cpy_ns / 1000.0);
+
+        *raw_sum_ptr += raw_len;
+        *dec_sum_ptr += dec_ns;
+        *cpy_sum_ptr += cpy_ns;
+
+        free(raw_ptr);
+    }
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 blob_len = (UINT32)(__ghsend_ddr_phy_pmu_images - __ghsbegin_ddr_phy_pmu_images);
+    UINT32 raw_sum = 0;
+    double dec_sum = 0.0;
+    double cpy_sum = 0.0;
+    UINT32 i;
+
+    if (!HOST_CHECK(2 == argc))
+    {
+        return host_test_result("test_ddr_phy_pmu_image");
+    }
+
+    /* the decode buffer holds the largest image */
+    HOST_CHECK(blob_len >= sizeof(ddr_phy_pmu_image_hdr_struct));
+    HOST_CHECK(((ddr_phy_pmu_image_hdr_struct *)__ghsbegin_ddr_phy_pmu_images)->max_raw_len <=
+               EXPLORER_DDR_PHY_PMU_IMAGE_BUF_SIZE);
+
+    printf("load time per image:\n");
+    for (i = 0; i < (sizeof(test_variants) / sizeof(test_variants[0])); i++)
+    {
+        test_variant(argv[1], &test_variants[i], &raw_sum, &dec_sum, &cpy_sum);
+    }
+
+    /* 1D and 2D training of one DIMM type load four images */
+    printf("  %-33s %6u -> %u bytes, decode %.1f us, memcpy %.1f us, +%.1f us per training on average\n",
+           "all images",
+           (unsigned)raw_sum,
+           (unsigned)blob_len,
+           dec_sum / 1000.0,
+           cpy_sum / 1000.0,
+           (dec_sum - cpy_sum) * 4.0 / (DDR_PHY_PMU_IMAGE_MAX * 1000.0));
+
+    return host_test_result("test_ddr_phy_pmu_image");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
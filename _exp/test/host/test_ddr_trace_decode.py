@@ -0,0 +1,208 @@
+#********************************************************************************
+# MICROCHIP PM8596 EXPLORER FIRMWARE
+#
+# Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# --------------------------------------------------------------------------
+# DESCRIPTION  :  Unit test and benchmark of ddr_trace_decode.py
+#
+# NOTES        :  python3 test_ddr_trace_decode.py <build dir>
+#                                                 <ddrphy_trace_strings.h>
+#
+#                 Resolves trace and PMU lines against the checked-in
+#                 ddrphy_trace_strings.h and a PMU .strings file written
+#                 by the test. The expected indexes are counted from the
+#                 enum independently of the resolver. The benchmark times
+#                 the dictionary lookup of the resolver against a linear
+#                 scan of the same table.
+#
+#*******************************************************************************/
+import os
+import re
+import sys
+import tempfile
+import time
+
+checks = 0
+fails = 0
+
+
+def check(cond, what):
+    """Count a check, print it when it fails."""
+    global checks, fails
+    checks += 1
+    if not cond:
+        fails += 1
+        print('FAIL: %s' % what)
+
+
+def enum_index(path, name):
+    """Return the position of name in trace_entry_enum."""
+    text = open(path, 'r', encoding='latin-1').read()
+    body = re.search(r'typedef enum\s*{([^}]*)}\s*trace_entry_enum;', text).group(1)
+    names = [s.strip() for s in body.split(',') if s.strip()]
+    return names.index(name)
+
+
+def line(index, args):
+    """Return the trace line of trace_print() for an entry index."""
+    return '[0x%08x] %s' % (index, args)
+
+
+def test_table(d, table, path):
+    """Entries of the header land at their enum position."""
+    check(len(table) > 9000, 'table size %d' % len(table))
+
+    i = enum_index(path, 'DDRPHY_SETMSDGC_ENUM_0')
+    check(table.get(i) == ('', 'Start of ddrphy_setMsdg()\n'), 'entry %d' % i)
+
+    i = enum_index(path, 'DDRPHY_DFIBISTC_ENUM_17')
+    check(table.get(i) == ('%04x %08x %08x', 'DDR DEBUG:     Bit Failures = 0x%04x_%08x_%08x\n'),
+          'entry %d' % i)
+
+    i = enum_index(path, 'DDRPHY_DFIBISTC_ENUM_99')
+    check(table.get(i) == ('"%s"', '// Printing MRL Training Status = %s\n'), 'entry %d' % i)
+
+
+def test_trace_lines(d, table, path):
+    """Indexed trace lines resolve, others pass through unchanged."""
+    bist = enum_index(path, 'DDRPHY_DFIBISTC_ENUM_0')
+    fail = enum_index(path, 'DDRPHY_DFIBISTC_ENUM_17')
+    mrl = enum_index(path, 'DDRPHY_DFIBISTC_ENUM_99')
+    start = enum_index(path, 'DDRPHY_SETMSDGC_ENUM_0')
+
+    cases = [
+        (line(bist, '1 a ff'), 'DDR DEBUG:     ddrSetBistMask(0x1, 0xa, 0xff)'),
+        (line(fail, '1f 0000beef 12345678'), 'DDR DEBUG:     Bit Failures = 0x001f_0000beef_12345678'),
+        (line(mrl, '"PASS"'), '// Printing MRL Training Status = PASS'),
+        (line(start, ''), 'Start of ddrphy_setMsdg()'),
+        ('0.512 ' + line(bist, '0 0 1'), '0.512 DDR DEBUG:     ddrSetBistMask(0x0, 0x0, 0x1)'),
+        (line(bist, '1 2'), line(bist, '1 2')),
+        (line(bist, 'zz 1 2'), line(bist, 'zz 1 2')),
+        (line(0x7FFFFFFF, '1'), line(0x7FFFFFFF, '1')),
+        ('[0x123] 1', '[0x123] 1'),
+        ('DDR PHY training done', 'DDR PHY training done'),
+        ('', ''),
+    ]
+    for text, expect in cases:
+        out = d.line_resolve(text, table, {})
+        check(out == expect, '%r -> %r, expected %r' % (text, out, expect))
+
+
+def test_pmu_lines(d, table):
+    """PMU mailbox lines resolve by the second, then the first id."""
+    fd, path = tempfile.mkstemp(suffix='.strings')
+    with os.fdopen(fd, 'w') as f:
+        f.write('00010000 PMU1: start of training\n')
+        f.write('00020001 PMU1: rank %d delay 0x%04x\n')
+        f.write('\n')
+        f.write('not-an-id ignored\n')
+        f.write('00030000\n')
+    pmu = d.pmu_table_load([path])
+    os.remove(path)
+
+    check(len(pmu) == 3, 'pmu table size %d' % len(pmu))
+    cases = [
+        ('"[PMU_TRN_STR] 0x00000000 0x00010000 "', 'PMU1: start of training'),
+        ('"[PMU_TRN_STR] 0x00000000 0x00020001 " 1 0x1f', 'PMU1: rank 1 delay 0x001f'),
+        ('"[PMU_TRN_STR] 0x00020001 0x00099999 " 3 16', 'PMU1: rank 3 delay 0x0010'),
+        ('"[PMU_TRN_STR] 0x00000000 0x00030000 "', ''),
+        ('"[PMU_TRN_STR] 0x00000000 0x00099999 " 1', '"[PMU_TRN_STR] 0x00000000 0x00099999 " 1'),
+    ]
+    for text, expect in cases:
+        out = d.line_resolve(text, table, pmu)
+        check(out == expect, '%r -> %r, expected %r' % (text, out, expect))
+
+
+def test_c_format(d):
+    """printf conversions of the message formats."""
+    cases = [
+        ('%d %u', [-1, -1], '-1 4294967295'),
+        ('%5d|%-4x|%08X', [42, 10, 0xbeef], '   42|a   |0000BEEF'),
+        ('%ld %lx %hhx', [7, 255, 3], '7 ff 3'),
+        ('100%%', [], '100%'),
+        ('%s=%d', ['vref'], 'vref=0'),
+        ('%c', [65], '65'),
+    ]
+    for fmt, args, expect in cases:
+        out = d.c_format(fmt, list(args))
+        check(out == expect, '%r %r -> %r, expected %r' % (fmt, args, out, expect))
+
+
+def scan_resolve(d, line_text, entries):
+    """Resolve a trace line by a linear scan of the table, as without the dictionary."""
+    m = d.TRACE_LINE_RE.search(line_text)
+    if not m:
+        return line_text
+    index = int(m.group(1), 16)
+    for key, entry in entries:
+        if key == index:
+            args = d.args_parse(entry[0], m.group(2))
+            if args is not None:
+                return line_text[:m.start()] + d.c_format(entry[1], args).rstrip('\n')
+            break
+    return line_text
+
+
+def test_bench(d, table):
+    """Lines per second of the dictionary lookup and of a linear scan."""
+    keys = sorted(table)
+    lines = []
+    for n in range(2000):
+        index = keys[(n * 7919) % len(keys)]
+        fw_format = table[index][0]
+        args = ' '.join('"x"' if m.group(1) == 's' else '1'
+                        for m in d.C_SPEC_RE.finditer(fw_format) if m.group(1) != '%')
+        lines.append(line(index, args))
+    entries = list(table.items())
+
+    start = time.perf_counter()
+    dict_out = [d.line_resolve(l, table, {}) for l in lines]
+    dict_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    scan_out = [scan_resolve(d, l, entries) for l in lines]
+    scan_time = time.perf_counter() - start
+
+    check(dict_out == scan_out, 'dictionary and scan results differ')
+    resolved = sum(1 for a, b in zip(lines, dict_out) if a != b)
+    check(resolved > len(lines) * 9 // 10, 'resolved %d of %d' % (resolved, len(lines)))
+
+    print('resolve rate:')
+    print('  %-22s %9.0f lines/s, %6.0f us/line' % ('dictionary', len(lines) / dict_time,
+                                                     dict_time * 1e6 / len(lines)))
+    print('  %-22s %9.0f lines/s, %6.0f us/line' % ('linear scan', len(lines) / scan_time,
+                                                     scan_time * 1e6 / len(lines)))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print('usage: test_ddr_trace_decode.py <build dir> <ddrphy_trace_strings.h>')
+        return 2
+    sys.path.insert(0, sys.argv[1])
+    import ddr_trace_decode as d
+    path = sys.argv[2]
+
+    table = d.trace_table_load(path)
+    test_table(d, table, path)
+    test_trace_lines(d, table, path)
+    test_pmu_lines(d, table)
+    test_c_format(d)
+    test_bench(d, table)
+
+    print('test_ddr_trace_decode: %s, %d checks, %d failed' %
+          ('FAIL' if fails else 'PASS', checks, fails))
+    return 1 if fails else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#********************************************************************************
+# MICROCHIP PM8596 EXPLORER FIRMWARE
+#
+# Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# --------------------------------------------------------------------------
+# DESCRIPTION  :  Check of the policy model of dl_update_sim.py against
+#                 the firmware
+#
+# NOTES        :  python3 test_dl_update_sim.py <build dir>
+#                                               <test_ddr_phy_dl_update>
+#
+#                 Writes the synthetic trace of the simulation and a
+#                 random walk with steps and negative readings, replays
+#                 each through ddr_phy_dl_update.c built for the host and
+#                 compares the updates and deferrals with the model. The
+#                 defaults of the model are compared with the pmc_profile.h
+#                 values printed by the host test.
+#
+#*******************************************************************************/
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+
+checks = 0
+fails = 0
+
+
+def check(cond, what):
+    """Count a check, print it when it fails."""
+    global checks, fails
+    checks += 1
+    if not cond:
+        fails += 1
+        print('FAIL: %s' % what)
+
+
+def trace_walk(seed):
+    """Return a random walk, [(seconds, temp)] with temp in 1/16 degree C."""
+    rng = random.Random(seed)
+    trace = []
+    t = 0
+    temp = 0
+    for _ in range(5000):
+        t += rng.choice((1, 2, 5, 5, 5, 9, 10, 11, 30))
+        temp += rng.randint(-24, 24)
+        if rng.random() < 0.01:
+            temp += rng.choice((-1, 1)) * rng.randint(64, 320)
+        temp = max(-40 * 16, min(125 * 16, temp))
+        trace.append((t, temp))
+    return trace
+
+
+def firmware(test_path, trace):
+    """Replay a trace through the host build, return ([(seconds, zq)], deferred)."""
+    fd, path = tempfile.mkstemp(suffix='.trace')
+    try:
+        with os.fdopen(fd, 'w') as f:
+            f.write('# seconds, degrees C\n')
+            for t, temp in trace:
+                f.write('%d, %.4f\n' % (t, temp / 16.0))
+        out = subprocess.run([test_path, path], stdout=subprocess.PIPE,
+                             universal_newlines=True).stdout
+    finally:
+        os.remove(path)
+
+    updates = []
+    deferred = None
+    for line in out.splitlines():
+        m = re.match(r'(\d+) (dl|dl\+zq)$', line)
+        if m:
+            updates.append((int(m.group(1)), 'dl+zq' == m.group(2)))
+        m = re.match(r'readings (\d+) deferred (\d+)$', line)
+        if m:
+            check(int(m.group(1)) == len(trace), 'firmware read %s of %d' % (m.group(1), len(trace)))
+            deferred = int(m.group(2))
+    check(re.search(r': PASS,', out) is not None, 'firmware replay: %s' % out.splitlines()[-1:])
+    return updates, deferred
+
+
+def test_defaults(d, test_path):
+    """The defaults of the model are the firmware thresholds."""
+    out = subprocess.run([test_path], stdout=subprocess.PIPE, universal_newlines=True).stdout
+    m = re.search(r'delay line update at (\d+)/16 C, ZQ at (\d+)/16 C, (\d+) s apart', out)
+    check(m is not None, 'no thresholds from %s' % test_path)
+    if m:
+        check(int(m.group(1)) == d.DEFAULT_DL_DELTA_C * d.TEMP_LSB_PER_C,
+              'delay line threshold %s/16 C, model %d C' % (m.group(1), d.DEFAULT_DL_DELTA_C))
+        check(int(m.group(2)) == d.DEFAULT_ZQ_DELTA_C * d.TEMP_LSB_PER_C,
+              'ZQ threshold %s/16 C, model %d C' % (m.group(2), d.DEFAULT_ZQ_DELTA_C))
+        check(int(m.group(3)) == d.DEFAULT_MIN_INTERVAL_S,
+              'minimum interval %s s, model %d s' % (m.group(3), d.DEFAULT_MIN_INTERVAL_S))
+
+
+def test_trace(d, test_path, name, trace, deferrals):
+    """The model and the firmware update at the same readings."""
+    c = d.simulate(trace, d.DEFAULT_DL_DELTA_C * d.TEMP_LSB_PER_C,
+                   d.DEFAULT_ZQ_DELTA_C * d.TEMP_LSB_PER_C, d.DEFAULT_MIN_INTERVAL_S)
+    updates, deferred = firmware(test_path, trace)
+
+    check(len(c['updates']) > 10, '%s: only %d updates' % (name, len(c['updates'])))
+    check(c['zq'] > 0, '%s: no ZQ calibration' % name)
+    check(not deferrals or c['deferred'] > 0, '%s: nothing deferred' % name)
+    check(len(updates) == len(c['updates']),
+          '%s: firmware %d updates, model %d' % (name, len(updates), len(c['updates'])))
+    for fw, model in zip(updates, c['updates']):
+        if fw != model:
+            check(False, '%s: firmware %s, model %s' % (name, fw, model))
+            break
+    check(deferred == c['deferred'], '%s: firmware %s deferred, model %d' %
+          (name, deferred, c['deferred']))
+    print('  %-10s %5d readings: %4d updates, %3d with ZQ, %4d deferred' %
+          (name, len(trace), len(c['updates']), c['zq'], c['deferred']))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print('usage: test_dl_update_sim.py <build dir> <test_ddr_phy_dl_update>')
+        return 2
+    sys.path.insert(0, sys.argv[1])
+    import dl_update_sim as d
+    test_path = sys.argv[2]
+
+    test_defaults(d, test_path)
+    test_trace(d, test_path, 'synthetic', d.trace_synthetic(), False)
+    for seed in range(3):
+        test_trace(d, test_path, 'walk %d' % seed, trace_walk(seed), True)
+
+    print('test_dl_update_sim: %s, %d checks, %d failed' %
+          ('FAIL' if fails else 'PASS', checks, fails))
+    return 1 if fails else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
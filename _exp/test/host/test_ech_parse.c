@@ -0,0 +1,768 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Test, fuzz target and replay benchmark of the OpenCAPI and TWI
+*   command parsers: ech_oc.c, ech_twi_common.c and the TWI dispatch of
+*   app_fw_ech_twi_handler.c, on the host side of host_ech.c.
+*
+* @note
+*   An input is a series of records, each one event on the interfaces:
+*
+*   - 0x00, length (2 bytes, little endian), data: a TWI write.
+*   - 0x01, command (64 bytes), length (2 bytes), data: an OpenCAPI
+*     command and its extended data, CRCs as given.
+*   - 0x02, as 0x01 but the CRCs are computed, so the command gets past
+*     the CRC checks.
+*   - 0x03: VPE0 runs the deferred TWI command.
+*
+*   The record type is taken modulo 4 and lengths are clipped to the
+*   buffers and to the input, so any byte string is an input. After each
+*   record the parser state and responses are checked.
+*
+*   With file arguments, main() runs the unit checks, replays the files,
+*   runs mutations of them and measures the replay rate. With --replay
+*   it only replays the files given, for afl-fuzz. Built with HOST_FUZZ
+*   it is a libFuzzer target instead, see the makefile.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "crc32_api.h"
+#include "exp_api.h"
+#include "ech.h"
+#include "ech_twi_common.h"
+#include "host_test.h"
+#include "host_ech.h"
+
+/*
+** Local Constants
+*/
+
+/* Record types */
+#define TEST_REC_TWI                0
+#define TEST_REC_OC                 1
+#define TEST_REC_OC_CRC             2
+#define TEST_REC_DEFERRED           3
+#define TEST_REC_TYPES              4
+
+/* Largest input, inputs are cut to it */
+#define TEST_INPUT_MAX              (16 * 1024)
+
+/* Mutations of the corpus run by the test */
+#define TEST_MUTATIONS              20000
+
+/* Length of each benchmark */
+#define TEST_BENCH_NS               200000000ULL
+
+/* Register used by the checks, in the window outside the OCMB space */
+#define TEST_REG_ADDR               (HOST_ECH_REG_ADDR + 0x10)
+
+/*
+** Private Data
+*/
+
+/* Unit checks and benchmarks, not in the libFuzzer build */
+#if !defined(HOST_FUZZ)
+PRIVATE UINT8 test_rsp[EXP_TWI_MAX_BUF_SIZE];
+PRIVATE UINT8 test_mutant[TEST_INPUT_MAX];
+#endif
+
+/* OpenCAPI handler calls */
+PRIVATE UINT32 test_oc_calls = 0;
+
+/* OpenCAPI commands posted by test_input_run() */
+PRIVATE UINT32 test_oc_posted = 0;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   OpenCAPI command handler, registered for the even command ids. Echoes
+*   the first parameter and the extended data length.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_oc_handler(VOID)
+{
+    exp_cmd_struct *cmd_ptr = ech_cmd_ptr_get();
+    exp_rsp_struct *rsp_ptr = ech_rsp_ptr_get();
+
+    test_oc_calls++;
+
+    rsp_ptr->parms[0] = EXP_FW_API_SUCCESS;
+    rsp_ptr->parms[1] = cmd_ptr->parms[0];
+    rsp_ptr->flags = EXP_FW_NO_EXTENDED_DATA;
+    rsp_ptr->ext_data_len = 0;
+    if (EXP_FW_EXTENDED_DATA_BITMSK == (cmd_ptr->flags & EXP_FW_EXTENDED_DATA_BITMSK))
+    {
+        rsp_ptr->flags = EXP_FW_EXTENDED_DATA_BITMSK;
+        rsp_ptr->ext_data_len = cmd_ptr->ext_data_len;
+    }
+
+    ech_oc_rsp_proc();
+}
+
+/**
+* @brief
+*   Reset the parsers and register the OpenCAPI handlers.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_reset(VOID)
+{
+    UINT32 i;
+
+    host_ech_reset();
+    for (i = EXP_FW_NULL_CMD + 2; i < EXP_FW_MAX_CMD; i += 2)
+    {
+        ech_api_func_register((exp_cmd_enum)i, test_oc_handler);
+    }
+    test_oc_posted = 0;
+}
+
+/**
+* @brief
+*   Write to the TWI slave port and let VPE1 poll it once.
+*
+* @param[in] data_ptr - data
+* @param[in] len      - length
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_twi(const UINT8 *data_ptr, UINT32 len)
+{
+    host_ech_twi_write(data_ptr, len);
+    ech_twi_slave_proc(HOST_ECH_TWI_PORT);
+
+    /* everything received is parsed, or an incomplete command is held */
+    HOST_CHECK(ech_twi_rx_len <= EXP_TWI_MAX_BUF_SIZE);
+    HOST_CHECK(((0 == ech_twi_rx_index) && (0 == ech_twi_rx_len)) ||
+               (ech_twi_rx_index < ech_twi_rx_len));
+}
+
+/**
+* @brief
+*   Post an OpenCAPI command and let VPE0 process it.
+*
+* @param[in] cmd_ptr  - command
+* @param[in] data_ptr - extended data
+* @param[in] len      - extended data length
+* @param[in] fix_crc  - compute the CRCs
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_oc(const exp_cmd_struct *cmd_ptr, const UINT8 *data_ptr, UINT32 len, BOOL fix_crc)
+{
+    exp_cmd_struct *host_cmd_ptr = host_ech_oc_cmd_ptr();
+    exp_rsp_struct *rsp_ptr = host_ech_oc_rsp_ptr();
+    UINT8 *ext_ptr = host_ech_oc_ext_data_ptr();
+    UINT32 rsps = host_ech_oc_rsp_count();
+
+    *host_cmd_ptr = *cmd_ptr;
+    memcpy(ext_ptr, data_ptr, (len < HOST_ECH_EXT_DATA_SIZE) ? len : HOST_ECH_EXT_DATA_SIZE);
+
+    if (TRUE == fix_crc)
+    {
+        if (host_cmd_ptr->ext_data_len <= HOST_ECH_EXT_DATA_SIZE)
+        {
+            host_cmd_ptr->ext_data_crc = pmc_crc32(ext_ptr, host_cmd_ptr->ext_data_len, 0, TRUE, TRUE);
+        }
+        host_cmd_ptr->crc = pmc_crc32((UINT8 *)host_cmd_ptr, sizeof(exp_cmd_struct) - sizeof(host_cmd_ptr->crc), 0, TRUE, TRUE);
+    }
+
+    host_ech_oc_doorbell();
+    HOST_CHECK(TRUE == ech_oc_cmd_proc());
+    test_oc_posted++;
+
+    /* one response per command, with a valid CRC and the id of the command */
+    HOST_CHECK((rsps + 1) == host_ech_oc_rsp_count());
+    HOST_CHECK(rsp_ptr->id == host_cmd_ptr->id);
+    HOST_CHECK(rsp_ptr->req_id == host_cmd_ptr->req_id);
+    HOST_CHECK(rsp_ptr->crc == pmc_crc32((UINT8 *)rsp_ptr, sizeof(exp_rsp_struct) - sizeof(rsp_ptr->crc), 0, TRUE, TRUE));
+    HOST_CHECK(FALSE == ech_oc_cmd_proc());
+}
+
+/**
+* @brief
+*   Run an input, see the file description.
+*
+* @param[in] data_ptr - input
+* @param[in] len      - input length
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_input_run(const UINT8 *data_ptr, UINT32 len)
+{
+    exp_cmd_struct cmd;
+    UINT32 pos = 0;
+    UINT32 n;
+    UINT8 type;
+
+    while (pos < len)
+    {
+        type = data_ptr[pos++] % TEST_REC_TYPES;
+
+        if (TEST_REC_DEFERRED == type)
+        {
+            (VOID)host_ech_twi_deferred_run();
+            continue;
+        }
+
+        if (TEST_REC_TWI != type)
+        {
+            memset(&cmd, 0, sizeof(cmd));
+            n = ((len - pos) < sizeof(cmd)) ? (len - pos) : sizeof(cmd);
+            memcpy(&cmd, &data_ptr[pos], n);
+            pos += n;
+        }
+
+        n = 0;
+        if ((len - pos) >= 2)
+        {
+            n = data_ptr[pos] | (data_ptr[pos + 1] << 8);
+            pos += 2;
+        }
+        if (n > (len - pos))
+        {
+            n = len - pos;
+        }
+
+        if (TEST_REC_TWI == type)
+        {
+            if (n > EXP_TWI_MAX_BUF_SIZE)
+            {
+                n = EXP_TWI_MAX_BUF_SIZE;
+            }
+            test_twi(&data_ptr[pos], n);
+        }
+        else
+        {
+            test_oc(&cmd, &data_ptr[pos], n, (TEST_REC_OC_CRC == type));
+        }
+        pos += n;
+    }
+}
+
+#if !defined(HOST_FUZZ)
+
+/**
+* @brief
+*   Send a TWI command and return the response it put.
+*
+* @param[in] data_ptr - command
+* @param[in] len      - length
+*
+* @return
+*   Length of the response, 0 if there was none.
+*/
+PRIVATE UINT32 test_twi_rsp(const UINT8 *data_ptr, UINT32 len)
+{
+    UINT32 rsps = host_ech_twi_rsp_count();
+
+    memset(test_rsp, 0, sizeof(test_rsp));
+    test_twi(data_ptr, len);
+    if (rsps == host_ech_twi_rsp_count())
+    {
+        return 0;
+    }
+
+    return host_ech_twi_rsp_get(test_rsp, sizeof(test_rsp));
+}
+
+/**
+* @brief
+*   Status byte returned by the status command.
+*
+* @return
+*   EXP_TWI_xxx status
+*/
+PRIVATE UINT8 test_twi_status(VOID)
+{
+    static const UINT8 status[] = { EXP_FW_TWI_CMD_STATUS };
+
+    HOST_CHECK(EXP_TWI_STATUS_RSP_LEN == test_twi_rsp(status, sizeof(status)));
+
+    return test_rsp[EXP_TWI_RSP_DATA_OFFSET + 2];
+}
+
+/**
+* @brief
+*   Checks of the TWI commands.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_twi_cmds(VOID)
+{
+    static const UINT8 boot_cfg[] = { EXP_FW_TWI_CMD_BOOT_CONFIG, 4, 0x00, 0x00, 0x00, 0x00 };
+    static const UINT8 latch[] = { EXP_FW_TWI_CMD_REG_ADDR_LATCH, 4,
+                                   (TEST_REG_ADDR >> 24) & 0xFF, (TEST_REG_ADDR >> 16) & 0xFF,
+                                   (TEST_REG_ADDR >> 8) & 0xFF, TEST_REG_ADDR & 0xFF };
+    static const UINT8 write[] = { EXP_FW_TWI_CMD_REG_WRITE, 8,
+                                   (TEST_REG_ADDR >> 24) & 0xFF, (TEST_REG_ADDR >> 16) & 0xFF,
+                                   (TEST_REG_ADDR >> 8) & 0xFF, TEST_REG_ADDR & 0xFF,
+                                   0x12, 0x34, 0x56, 0x78 };
+    static const UINT8 read[] = { EXP_FW_TWI_CMD_REG_READ, 4, 0, 0, 0, 0 };
+    static const UINT8 unsupported[] = { 0xEE, EXP_FW_TWI_CMD_STATUS };
+    UINT8 buf[EXP_TWI_MAX_BUF_SIZE];
+    UINT32 rsps;
+    UINT32 i;
+
+    test_reset();
+
+    /* status */
+    HOST_CHECK(EXP_TWI_STATUS_RSP_LEN == test_twi_rsp(buf, (buf[0] = EXP_FW_TWI_CMD_STATUS, 1)));
+    HOST_CHECK(EXP_TWI_STATUS_RSP_DATA_LEN == test_rsp[EXP_TWI_RSP_LEN_OFFSET]);
+
+    if (TRUE == host_ech_reg_win_mapped())
+    {
+        /* register write, then latch and read back */
+        test_twi(write, sizeof(write));
+        HOST_CHECK(EXP_TWI_SUCCESS == test_twi_status());
+        HOST_CHECK(0x12345678 == *(volatile UINT32 *)(uintptr_t)TEST_REG_ADDR);
+        test_twi(latch, sizeof(latch));
+        HOST_CHECK(EXP_TWI_REG_READ_RSP_LEN == test_twi_rsp(read, sizeof(read)));
+        HOST_CHECK((0x12 == test_rsp[1]) && (0x34 == test_rsp[2]) && (0x56 == test_rsp[3]) && (0x78 == test_rsp[4]));
+
+        /* a command split over two writes */
+        *(volatile UINT32 *)(uintptr_t)TEST_REG_ADDR = 0x9ABCDEF0;
+        test_twi(latch, 3);
+        HOST_CHECK(0 != ech_twi_rx_len);
+        test_twi(&latch[3], sizeof(latch) - 3);
+        HOST_CHECK(EXP_TWI_REG_READ_RSP_LEN == test_twi_rsp(read, sizeof(read)));
+        HOST_CHECK((0x9A == test_rsp[1]) && (0xF0 == test_rsp[4]));
+    }
+    else
+    {
+        printf("  register windows not mapped, register accesses not tested\n");
+    }
+
+    /* a read without a latched address fails, the latch is used once */
+    HOST_CHECK(EXP_TWI_REG_READ_RSP_LEN == test_twi_rsp(read, sizeof(read)));
+    HOST_CHECK(EXP_TWI_ERROR == test_twi_status());
+    test_reset();
+    HOST_CHECK(EXP_TWI_REG_READ_RSP_LEN == test_twi_rsp(read, sizeof(read)));
+    HOST_CHECK(EXP_TWI_ERROR == test_twi_status());
+
+    /* boot config is busy until VPE0 has run it */
+    test_twi(boot_cfg, sizeof(boot_cfg));
+    HOST_CHECK(EXP_TWI_BUSY == test_twi_status());
+    HOST_CHECK(TRUE == host_ech_twi_deferred_run());
+    HOST_CHECK(EXP_TWI_SUCCESS == test_twi_status());
+
+    /* an unsupported command drops the rest of the write */
+    HOST_CHECK(0 == test_twi_rsp(unsupported, sizeof(unsupported)));
+    HOST_CHECK(EXP_TWI_UNSUPPORTED == test_twi_status());
+    HOST_CHECK(0 == ech_twi_rx_len);
+
+    /* held bytes that can not fit with a full write are dropped */
+    test_twi(latch, 3);
+    memset(buf, EXP_FW_TWI_POLL_ABORT, sizeof(buf));
+    rsps = host_ech_twi_dispatch_count();
+    test_twi(buf, sizeof(buf));
+    HOST_CHECK((rsps + sizeof(buf)) == host_ech_twi_dispatch_count());
+
+    /* commands past the first 256 bytes of a write are parsed where they are */
+    memset(buf, EXP_FW_TWI_POLL_ABORT, sizeof(buf));
+    for (i = 256; i < sizeof(buf); i++)
+    {
+        buf[i] = EXP_FW_TWI_CMD_STATUS;
+    }
+    rsps = host_ech_twi_rsp_count();
+    test_twi(buf, sizeof(buf));
+    HOST_CHECK((rsps + (sizeof(buf) - 256)) == host_ech_twi_rsp_count());
+}
+
+/**
+* @brief
+*   Checks of the OpenCAPI commands.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_oc_cmds(VOID)
+{
+    exp_rsp_struct *rsp_ptr = host_ech_oc_rsp_ptr();
+    exp_cmd_struct cmd;
+    UINT8 data[64];
+    UINT32 calls;
+
+    test_reset();
+    memset(&cmd, 0, sizeof(cmd));
+    memset(data, 0x5A, sizeof(data));
+
+    /* registered command, with and without extended data */
+    cmd.id = EXP_FW_DDR_PHY_INIT;
+    cmd.req_id = 0x1234;
+    cmd.parms[0] = 0x77;
+    calls = test_oc_calls;
+    test_oc(&cmd, data, 0, TRUE);
+    HOST_CHECK((calls + 1) == test_oc_calls);
+    HOST_CHECK((EXP_FW_API_SUCCESS == rsp_ptr->parms[0]) && (0x77 == rsp_ptr->parms[1]));
+    cmd.flags = EXP_FW_EXTENDED_DATA_BITMSK;
+    cmd.ext_data_len = sizeof(data);
+    test_oc(&cmd, data, sizeof(data), TRUE);
+    HOST_CHECK((calls + 2) == test_oc_calls);
+    HOST_CHECK(rsp_ptr->ext_data_crc == pmc_crc32(host_ech_oc_ext_data_ptr(), sizeof(data), 0, TRUE, TRUE));
+
+    /* bad extended data CRC */
+    cmd.ext_data_crc = ~pmc_crc32(data, sizeof(data), 0, TRUE, TRUE);
+    cmd.crc = pmc_crc32((UINT8 *)&cmd, sizeof(cmd) - sizeof(cmd.crc), 0, TRUE, TRUE);
+    test_oc(&cmd, data, sizeof(data), FALSE);
+    HOST_CHECK((EXP_FW_API_FAILURE == rsp_ptr->parms[0]) && (EXP_FW_API_CMD_DATA_CRC_ERR == rsp_ptr->parms[1]));
+
+    /* extended data longer than its buffer */
+    cmd.ext_data_len = HOST_ECH_EXT_DATA_SIZE + 1;
+    test_oc(&cmd, data, sizeof(data), TRUE);
+    HOST_CHECK((EXP_FW_API_FAILURE == rsp_ptr->parms[0]) && (EXP_FW_API_CMD_DATA_LEN_ERR == rsp_ptr->parms[1]));
+
+    /* bad header CRC */
+    cmd.ext_data_len = sizeof(data);
+    cmd.crc = 0;
+    test_oc(&cmd, data, sizeof(data), FALSE);
+    HOST_CHECK((EXP_FW_API_FAILURE == rsp_ptr->parms[0]) && (EXP_FW_API_CMD_CRC_ERR == rsp_ptr->parms[1]));
+
+    /* no handler registered, and out of range ids */
+    cmd.id = EXP_FW_PHY_STEP_BY_STEP_INIT;
+    test_oc(&cmd, data, sizeof(data), TRUE);
+    HOST_CHECK((EXP_FW_API_FAILURE == rsp_ptr->parms[0]) && (EXP_FW_API_CMD_ERR == rsp_ptr->parms[1]));
+    cmd.id = EXP_FW_NULL_CMD;
+    test_oc(&cmd, data, sizeof(data), TRUE);
+    HOST_CHECK(EXP_FW_API_CMD_ERR == rsp_ptr->parms[1]);
+    cmd.id = 0xFF;
+    test_oc(&cmd, data, sizeof(data), TRUE);
+    HOST_CHECK(EXP_FW_API_CMD_ERR == rsp_ptr->parms[1]);
+    HOST_CHECK((calls + 2) == test_oc_calls);
+}
+
+/**
+* @brief
+*   Mutate an input: flip, replace, insert or delete bytes, or splice in
+*   part of another input.
+*
+* @param[in]  data_ptr  - input
+* @param[in]  len       - input length
+* @param[in]  other_ptr - input to splice from
+* @param[in]  other_len - its length
+* @param[out] out_ptr   - mutated input, TEST_INPUT_MAX bytes
+*
+* @return
+*   Length of the mutated input.
+*/
+PRIVATE UINT32 test_mutate(const UINT8 *data_ptr, UINT32 len,
+                           const UINT8 *other_ptr, UINT32 other_len,
+                           UINT8 *out_ptr)
+{
+    UINT32 edits = 1 + (host_rand() % 8);
+    UINT32 pos;
+    UINT32 n;
+
+    len = (len < TEST_INPUT_MAX) ? len : TEST_INPUT_MAX;
+    memcpy(out_ptr, data_ptr, len);
+
+    while ((edits-- > 0) && (0 != len))
+    {
+        pos = host_rand() % len;
+
+        switch (host_rand() % 5)
+        {
+            case 0:
+                out_ptr[pos] ^= (UINT8)(1 << (host_rand() % 8));
+                break;
+
+            case 1:
+                out_ptr[pos] = (UINT8)host_rand();
+                break;
+
+            case 2:
+                if (len < TEST_INPUT_MAX)
+                {
+                    memmove(&out_ptr[pos + 1], &out_ptr[pos], len - pos);
+                    out_ptr[pos] = (UINT8)host_rand();
+                    len++;
+                }
+                break;
+
+            case 3:
+                memmove(&out_ptr[pos], &out_ptr[pos + 1], len - pos - 1);
+                len--;
+                break;
+
+            default:
+                n = host_rand() % (other_len + 1);
+                if ((pos + n) > TEST_INPUT_MAX)
+                {
+                    n = TEST_INPUT_MAX - pos;
+                }
+                memcpy(&out_ptr[pos], &other_ptr[host_rand() % (other_len - n + 1)], n);
+                len = ((pos + n) > len) ? (pos + n) : len;
+                break;
+        }
+    }
+
+    return len;
+}
+
+/**
+* @brief
+*   Replay rate of a set of inputs.
+*
+* @param[in] name_ptr - benchmark name
+* @param[in] data_ptr - inputs
+* @param[in] len_ptr  - input lengths
+* @param[in] num      - number of inputs
+* @param[in] reset    - reset the parsers before each input, otherwise
+*                       only before the first pass
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_bench(const CHAR *name_ptr, UINT8 * const *data_ptr, const UINT32 *len_ptr, UINT32 num, BOOL reset)
+{
+    UINT64 start;
+    UINT64 ns;
+    UINT64 cmds = 0;
+    UINT32 passes = 0;
+    UINT32 i;
+
+    test_reset();
+    start = host_time_ns();
+    do
+    {
+        for (i = 0; i < num; i++)
+        {
+            if (TRUE == reset)
+            {
+                cmds += host_ech_twi_dispatch_count() + test_oc_posted;
+                test_reset();
+            }
+            test_input_run(data_ptr[i], len_ptr[i]);
+        }
+        passes++;
+        ns = host_time_ns() - start;
+    } while (ns < TEST_BENCH_NS);
+    cmds += host_ech_twi_dispatch_count() + test_oc_posted;
+
+    printf("  %-22s %9.0f cmds/s, %6.0f ns/cmd, %u passes\n",
+           name_ptr,
+           (double)cmds * 1e9 / (double)ns,
+           (double)ns / (double)cmds,
+           (unsigned)passes);
+}
+
+/**
+* @brief
+*   Make an OpenCAPI record with the CRCs computed, replayed as given.
+*
+* @param[out] rec_ptr - record, 1 + 64 + 2 + len bytes
+* @param[in]  len     - extended data length
+*
+* @return
+*   Length of the record.
+*/
+PRIVATE UINT32 test_bench_oc_rec(UINT8 *rec_ptr, UINT32 len)
+{
+    exp_cmd_struct cmd;
+    UINT8 *ext_ptr = &rec_ptr[1 + sizeof(cmd) + 2];
+    UINT32 i;
+
+    for (i = 0; i < len; i++)
+    {
+        ext_ptr[i] = (UINT8)i;
+    }
+
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.id = EXP_FW_DDR_PHY_INIT;
+    if (0 != len)
+    {
+        cmd.flags = EXP_FW_EXTENDED_DATA_BITMSK;
+        cmd.ext_data_len = len;
+        cmd.ext_data_crc = pmc_crc32(ext_ptr, len, 0, TRUE, TRUE);
+    }
+    cmd.crc = pmc_crc32((UINT8 *)&cmd, sizeof(cmd) - sizeof(cmd.crc), 0, TRUE, TRUE);
+
+    rec_ptr[0] = TEST_REC_OC;
+    memcpy(&rec_ptr[1], &cmd, sizeof(cmd));
+    rec_ptr[1 + sizeof(cmd)] = len & 0xFF;
+    rec_ptr[2 + sizeof(cmd)] = (len >> 8) & 0xFF;
+
+    return 1 + sizeof(cmd) + 2 + len;
+}
+
+/**
+* @brief
+*   Replay benchmarks of the corpus and of single transactions. The
+*   transactions run back to back on one parser state, the way a host
+*   polls.
+*
+* @param[in] data_ptr - corpus inputs
+* @param[in] len_ptr  - their lengths
+* @param[in] num      - number of inputs
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_bench_all(UINT8 * const *data_ptr, const UINT32 *len_ptr, UINT32 num)
+{
+    static UINT8 status[] = { TEST_REC_TWI, 1, 0, EXP_FW_TWI_CMD_STATUS };
+    static UINT8 reg_read[] = { TEST_REC_TWI, 12, 0,
+                                EXP_FW_TWI_CMD_REG_ADDR_LATCH, 4,
+                                (TEST_REG_ADDR >> 24) & 0xFF, (TEST_REG_ADDR >> 16) & 0xFF,
+                                (TEST_REG_ADDR >> 8) & 0xFF, TEST_REG_ADDR & 0xFF,
+                                EXP_FW_TWI_CMD_REG_READ, 4, 0, 0, 0, 0 };
+    static UINT8 oc[1 + sizeof(exp_cmd_struct) + 2];
+    static UINT8 oc_4k[1 + sizeof(exp_cmd_struct) + 2 + 4096];
+    UINT8 *one_ptr;
+    UINT32 one_len;
+
+    printf("replay rate:\n");
+    test_bench("corpus", data_ptr, len_ptr, num, TRUE);
+    one_ptr = status;
+    one_len = sizeof(status);
+    test_bench("TWI status", &one_ptr, &one_len, 1, FALSE);
+    if (TRUE == host_ech_reg_win_mapped())
+    {
+        one_ptr = reg_read;
+        one_len = sizeof(reg_read);
+        test_bench("TWI latch and read", &one_ptr, &one_len, 1, FALSE);
+    }
+    one_ptr = oc;
+    one_len = test_bench_oc_rec(oc, 0);
+    test_bench("OpenCAPI", &one_ptr, &one_len, 1, FALSE);
+    one_ptr = oc_4k;
+    one_len = test_bench_oc_rec(oc_4k, 4096);
+    test_bench("OpenCAPI, 4 KB data", &one_ptr, &one_len, 1, FALSE);
+}
+
+#endif
+
+/*
+** Public Functions
+*/
+
+#if defined(HOST_FUZZ)
+
+/**
+* @brief
+*   libFuzzer entry point.
+*
+* @param[in] data_ptr - input
+* @param[in] len      - input length
+*
+* @return
+*   0
+*/
+int LLVMFuzzerTestOneInput(const UINT8 *data_ptr, size_t len)
+{
+    test_reset();
+    test_input_run(data_ptr, (len < TEST_INPUT_MAX) ? (UINT32)len : TEST_INPUT_MAX);
+
+    /* a failed check is a crash to the fuzzer */
+    PMCFW_ASSERT(0 == host_test_result(NULL), PMCFW_ERR_FAIL);
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    UINT8 *data_ptr[argc];
+    UINT32 len[argc];
+    UINT32 num = 0;
+    UINT32 other;
+    UINT32 mutant_len;
+    UINT32 i;
+    BOOL replay = FALSE;
+    int arg = 1;
+
+    if ((argc > 1) && (0 == strcmp(argv[1], "--replay")))
+    {
+        replay = TRUE;
+        arg++;
+    }
+
+    for (; arg < argc; arg++)
+    {
+        data_ptr[num] = host_file_read(argv[arg], &len[num]);
+        if (NULL == data_ptr[num])
+        {
+            return 1;
+        }
+        num++;
+    }
+
+    if (FALSE == replay)
+    {
+        test_twi_cmds();
+        test_oc_cmds();
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        test_reset();
+        test_input_run(data_ptr[i], len[i]);
+    }
+
+    if ((FALSE == replay) && (0 != num))
+    {
+        host_srand(0);
+        for (i = 0; i < TEST_MUTATIONS; i++)
+        {
+            other = host_rand() % num;
+            mutant_len = test_mutate(data_ptr[i % num], len[i % num],
+                                     data_ptr[other], len[other],
+                                     test_mutant);
+            test_reset();
+            test_input_run(test_mutant, mutant_len);
+        }
+        printf("%u corpus inputs, %u mutations\n", (unsigned)num, (unsigned)TEST_MUTATIONS);
+
+        test_bench_all(data_ptr, len, num);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        free(data_ptr[i]);
+    }
+
+    return host_test_result("test_ech_parse");
+}
+
+#endif
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,557 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the DDR4 SPD parser and timing calculator.
+*
+* @note
+*   Usage: test_exp_ddr_ctrlr_spd <spd image> [<spd image> ...]
+*
+*   The images are written by spd/spd_gen.py. Each one is decoded at the
+*   data rate of its DIMM and the configuration, the timings in clocks and
+*   the PHY user input fields are checked against the values worked out
+*   by hand from the JEDEC speed bins. Every DIMM of the table must be
+*   given. Corrupt and unsupported SPDs must be rejected.
+*
+*   Each entry of the hard-coded configuration table of
+*   exp_ddr_ctrlr_plat.c is also compared with the calculation from the
+*   image of its DIMM, and only the differences listed here may show.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "exp_ddr_ctrlr_spd.h"
+#include "exp_ddr_ctrlr_spd_table.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+/* SPD bytes changed by the error checks */
+#define TEST_SPD_DRAM_TYPE          2
+#define TEST_SPD_CL_FIRST           20
+#define TEST_SPD_CRC                126
+
+/* field of exp_ddr_ctrlr_spd_config_struct */
+#define TEST_FIELD(name)            { #name, offsetof(exp_ddr_ctrlr_spd_config_struct, name), \
+                                      sizeof(((exp_ddr_ctrlr_spd_config_struct *)0)->name) }
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   Expected decode of an SPD image.
+*/
+typedef struct
+{
+    const CHAR *name_ptr;       /**< Image file name without .bin */
+    UINT32 data_rate;           /**< MT/s */
+    UINT8  dram_size;
+    UINT8  dram_width;
+    UINT8  ranks;
+    UINT8  rdimm;
+    UINT8  die_count;
+    UINT8  v3ds_height;
+    UINT8  row_bits;
+    UINT32 tRRD_S;              /**< ps, after the 4 clock minimum */
+    exp_ddr_ctrlr_spd_clk_struct clk;
+    BOOL   found;
+} test_dimm_struct;
+
+/**
+* @brief
+*   Field checked by exp_ddr_ctrlr_spd_config_compare().
+*/
+typedef struct
+{
+    const CHAR *name_ptr;       /**< Field name */
+    UINT32 offset;              /**< Offset in the configuration */
+    UINT32 size;                /**< 2 or 4 bytes */
+} test_field_struct;
+
+/**
+* @brief
+*   Hard-coded table entry and the image of its DIMM.
+*/
+typedef struct
+{
+    ocmb_spd_config_index_enum index;   /**< Table entry */
+    const CHAR *name_ptr;               /**< Image file name without .bin */
+} test_table_struct;
+
+/**
+* @brief
+*   Known difference between a table entry and the calculation.
+*/
+typedef struct
+{
+    ocmb_spd_config_index_enum index;   /**< Table entry */
+    const CHAR *field_ptr;              /**< Field name */
+    UINT32 table;                       /**< Value in the table */
+    UINT32 calc;                        /**< Value from the SPD */
+} test_table_diff_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE test_dimm_struct test_dimm[] =
+{
+    /*   name                    rate  Gb  w  rk rd die 3ds row  tRRD_S */
+    {
+        "udimm_x8_1r_2666",      2666, 8,  8, 1, 0,  9, 0, 16,  3000,
+        /*  tCK  CL  CWL tRCD tRP tRAS tRC  tRFC1 tRFC2 tRFC4 tFAW RRD_S RRD_L CCD_L tWR WTR_S WTR_L */
+        {   750, 19, 14, 19,  19, 43,  61,  467,  347,  214,  28,  4,    7,    7,    20,  4,    10 },
+        FALSE
+    },
+    {
+        "udimm_x8_2r_3200",      3200, 8,  8, 2, 0,  8, 0, 16,  2500,
+        {   625, 22, 16, 22,  22, 52,  74,  560,  416,  256,  34,  4,    8,    8,    24,  4,    12 },
+        FALSE
+    },
+    {
+        "rdimm_x4_2r_3200",      3200, 8,  4, 2, 1, 18, 0, 17,  2500,
+        {   625, 22, 16, 22,  22, 52,  74,  560,  416,  256,  16,  4,    8,    8,    24,  4,    12 },
+        FALSE
+    },
+    {
+        "udimm_x16_1r_2666",     2666, 8, 16, 1, 0,  4, 0, 16,  5300,
+        {   750, 19, 14, 19,  19, 43,  63,  467,  347,  214,  40,  8,    9,    7,    20,  4,    10 },
+        FALSE
+    },
+    {
+        "udimm_x8_1r_3200",      3200, 8,  8, 1, 0,  9, 0, 16,  2500,
+        {   625, 22, 16, 22,  22, 52,  74,  560,  416,  256,  34,  4,    8,    8,    24,  4,    12 },
+        FALSE
+    },
+    {
+        /* tCK and tAA need the fine timebase, tRRD_S is raised to 4 clocks */
+        "rdimm_3ds_x4_2r_2933",  2933, 16, 4, 2, 1, 18, 2, 18,  2728,
+        {   682, 20, 16, 20,  20, 47,  67,  807,  514,  382,  16,  4,    8,    8,    22,  4,    11 },
+        FALSE
+    },
+};
+
+/* fields compared, in the order of exp_ddr_ctrlr_spd_config_compare() */
+PRIVATE const test_field_struct test_field[] =
+{
+    TEST_FIELD(dram_size),
+    TEST_FIELD(dram_width),
+    TEST_FIELD(ranks),
+    TEST_FIELD(rdimm),
+    TEST_FIELD(die_count),
+    TEST_FIELD(v3ds_height),
+    TEST_FIELD(clk_freq),
+    TEST_FIELD(cl),
+    TEST_FIELD(cwl),
+    TEST_FIELD(tRCD),
+    TEST_FIELD(tRP),
+    TEST_FIELD(tRAS),
+    TEST_FIELD(tRC),
+    TEST_FIELD(tRFC1),
+    TEST_FIELD(tRFC2),
+    TEST_FIELD(tRFC4),
+    TEST_FIELD(tFAW),
+    TEST_FIELD(tRRD_S),
+    TEST_FIELD(tRRD_L),
+    TEST_FIELD(tCCD_L),
+    TEST_FIELD(tWR),
+    TEST_FIELD(tWTR_S),
+    TEST_FIELD(tWTR_L),
+};
+
+/* the emulation entry describes an 8Gb x8 1R DIMM at 3200 */
+PRIVATE const test_table_struct test_table[] =
+{
+    { OCMB_PALLADIUM_SPD_CONFIG,         "udimm_x8_1r_3200"  },
+    { OCMB_UDIMM_SPD_CONFIG_x8_1R_2666,  "udimm_x8_1r_2666"  },
+    { OCMB_UDIMM_SPD_CONFIG_x8_2R_3200,  "udimm_x8_2r_3200"  },
+    { OCMB_RDIMM_SPD_CONFIG_x4_2R_3200,  "rdimm_x4_2r_3200"  },
+    { OCMB_UDIMM_SPD_CONFIG_x16_1R_2666, "udimm_x16_1r_2666" },
+    { OCMB_UDIMM_SPD_CONFIG_x8_1R_3200,  "udimm_x8_1r_3200"  },
+};
+
+/* what the SPD corrects in the hard-coded table */
+PRIVATE const test_table_diff_struct test_table_diff[] =
+{
+    /* emulation model: 16Gb refresh, CL and tRCD/tRP below the 3200 speed bin */
+    /*  entry                              field          table   calc */
+    { OCMB_PALLADIUM_SPD_CONFIG,         "die_count",      10,      9      },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "cl",             20,      22     },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRCD",           12500,   13750  },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRP",            12500,   13750  },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRFC1",          550000,  350000 },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRFC2",          350000,  260000 },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRFC4",          260000,  160000 },
+    { OCMB_PALLADIUM_SPD_CONFIG,         "tRRD_S",         3000,    2500   },
+    /* a planar DIMM has no 3DS stack */
+    { OCMB_UDIMM_SPD_CONFIG_x8_1R_2666,  "v3ds_height",    1,       0      },
+    /* the table counts the dies of both ranks */
+    { OCMB_UDIMM_SPD_CONFIG_x8_2R_3200,  "die_count",      16,      8      },
+};
+
+/* table entries checked */
+PRIVATE UINT32 test_table_found;
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Read a field of a configuration.
+*
+* @param[in] config_ptr - configuration
+* @param[in] field_ptr  - field
+*
+* @return
+*   Field value
+*/
+PRIVATE UINT32 test_field_get(const exp_ddr_ctrlr_spd_config_struct *config_ptr,
+                              const test_field_struct *field_ptr)
+{
+    const UINT8 *ptr = (const UINT8 *)config_ptr + field_ptr->offset;
+
+    if (sizeof(UINT16) == field_ptr->size)
+    {
+        return (*(const UINT16 *)ptr);
+    }
+    return (*(const UINT32 *)ptr);
+}
+
+/**
+* @brief
+*   Compare the table entries of a DIMM with the calculation from its SPD.
+*
+* @param[in] spd_ptr  - SPD image
+* @param[in] len      - image length
+* @param[in] name_ptr - image file name without .bin
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_table_check(const UINT8 *spd_ptr, UINT32 len, const CHAR *name_ptr)
+{
+    const exp_ddr_ctrlr_spd_config_struct *table_ptr;
+    exp_ddr_ctrlr_spd_struct info;
+    exp_ddr_ctrlr_spd_config_struct calc;
+    UINT32 table;
+    UINT32 value;
+    UINT32 diffs;
+    UINT32 expected;
+    UINT32 i;
+    UINT32 j;
+    UINT32 k;
+
+    for (i = 0; i < (sizeof(test_table) / sizeof(test_table[0])); i++)
+    {
+        if (0 != strcmp(name_ptr, test_table[i].name_ptr))
+        {
+            continue;
+        }
+
+        /* as exp_ddr_ctrlr_spd_config_init() does */
+        table_ptr = &ocmb_spd_config_array[test_table[i].index];
+        calc = *table_ptr;
+        HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_parse(spd_ptr, len, &info));
+        HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_timing_calc(&info, table_ptr->clk_freq * 2, &calc, NULL));
+
+        diffs = 0;
+        for (j = 0; j < (sizeof(test_field) / sizeof(test_field[0])); j++)
+        {
+            table = test_field_get(table_ptr, &test_field[j]);
+            value = test_field_get(&calc, &test_field[j]);
+
+            for (k = 0; k < (sizeof(test_table_diff) / sizeof(test_table_diff[0])); k++)
+            {
+                if ((test_table[i].index == test_table_diff[k].index) &&
+                    (0 == strcmp(test_field[j].name_ptr, test_table_diff[k].field_ptr)))
+                {
+                    break;
+                }
+            }
+
+            if (k < (sizeof(test_table_diff) / sizeof(test_table_diff[0])))
+            {
+                HOST_CHECK((test_table_diff[k].table == table) && (test_table_diff[k].calc == value));
+                diffs++;
+            }
+            else if (table != value)
+            {
+                printf("  entry %u %s: table %u, calculated %u\n",
+                       (unsigned)test_table[i].index, test_field[j].name_ptr,
+                       (unsigned)table, (unsigned)value);
+                HOST_CHECK(FALSE);
+            }
+        }
+
+        /* every listed difference is still there */
+        for (expected = 0, k = 0; k < (sizeof(test_table_diff) / sizeof(test_table_diff[0])); k++)
+        {
+            expected += (test_table[i].index == test_table_diff[k].index) ? 1 : 0;
+        }
+        HOST_CHECK(expected == diffs);
+        HOST_CHECK(diffs == exp_ddr_ctrlr_spd_config_compare(&calc, table_ptr));
+
+        test_table_found |= (1 << i);
+    }
+}
+
+/**
+* @brief
+*   Check the decode of an SPD image against its table entry.
+*
+* @param[in] spd_ptr  - SPD image
+* @param[in] len      - image length
+* @param[in] dimm_ptr - expected decode
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_dimm_check(const UINT8 *spd_ptr, UINT32 len, const test_dimm_struct *dimm_ptr)
+{
+    const exp_ddr_ctrlr_spd_clk_struct *exp_ptr = &dimm_ptr->clk;
+    exp_ddr_ctrlr_spd_struct info;
+    exp_ddr_ctrlr_spd_config_struct config;
+    exp_ddr_ctrlr_spd_clk_struct clk;
+    user_input_msdg_t msdg;
+
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_parse(spd_ptr, len, &info));
+    HOST_CHECK(dimm_ptr->row_bits == info.row_bits);
+    HOST_CHECK(10 == info.col_bits);
+
+    memset(&config, 0, sizeof(config));
+    memset(&clk, 0, sizeof(clk));
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_timing_calc(&info, dimm_ptr->data_rate, &config, &clk));
+
+    /* organization */
+    HOST_CHECK(dimm_ptr->dram_size == config.dram_size);
+    HOST_CHECK(dimm_ptr->dram_width == config.dram_width);
+    HOST_CHECK(dimm_ptr->ranks == config.ranks);
+    HOST_CHECK(dimm_ptr->rdimm == config.rdimm);
+    HOST_CHECK(dimm_ptr->die_count == config.die_count);
+    HOST_CHECK(dimm_ptr->v3ds_height == config.v3ds_height);
+
+    /* clock, latencies and the times the controller is given */
+    HOST_CHECK((dimm_ptr->data_rate / 2) == config.clk_freq);
+    HOST_CHECK(exp_ptr->cl == config.cl);
+    HOST_CHECK(exp_ptr->cwl == config.cwl);
+    HOST_CHECK(dimm_ptr->tRRD_S == config.tRRD_S);
+    HOST_CHECK(config.tRCD == info.tRCD);
+    HOST_CHECK(config.tRFC1 == info.tRFC1);
+
+    /* timings in clocks */
+    HOST_CHECK(0 == memcmp(exp_ptr, &clk, sizeof(clk)));
+    if (0 != memcmp(exp_ptr, &clk, sizeof(clk)))
+    {
+        printf("  %s: CL%u CWL%u tRCD %u tRP %u tRAS %u tRC %u tRFC %u/%u/%u tFAW %u "
+               "tRRD %u/%u tCCD_L %u tWR %u tWTR %u/%u\n",
+               dimm_ptr->name_ptr, clk.cl, clk.cwl, clk.tRCD, clk.tRP, clk.tRAS, clk.tRC,
+               clk.tRFC1, clk.tRFC2, clk.tRFC4, clk.tFAW, clk.tRRD_S, clk.tRRD_L,
+               clk.tCCD_L, clk.tWR, clk.tWTR_S, clk.tWTR_L);
+    }
+
+    /* a configuration compares equal to itself, and each field is reported */
+    HOST_CHECK(0 == exp_ddr_ctrlr_spd_config_compare(&config, &config));
+
+    /* PHY user input */
+    memset(&msdg, 0, sizeof(msdg));
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_phy_config(&info, dimm_ptr->data_rate, &msdg));
+    HOST_CHECK(dimm_ptr->rdimm == msdg.DimmType);
+    HOST_CHECK(((1 << dimm_ptr->ranks) - 1) == msdg.CsPresent);
+    HOST_CHECK(dimm_ptr->dram_width == msdg.DramDataWidth);
+    HOST_CHECK(dimm_ptr->v3ds_height == msdg.Height3DS);
+    HOST_CHECK(info.tAA == msdg.SpdtAAmin);
+    HOST_CHECK(0 != (msdg.SpdCLSupported & (1 << (exp_ptr->cl - 7))));
+    HOST_CHECK(((1000000 + exp_ptr->tCK - 1) / exp_ptr->tCK) == msdg.Frequency[0]);
+
+    /* a DIMM slower than the next speed bin is refused there */
+    if (dimm_ptr->data_rate < 3200)
+    {
+        HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_DATA_RATE == exp_ddr_ctrlr_spd_timing_calc(&info, 3200, &config, NULL));
+    }
+}
+
+/**
+* @brief
+*   Corrupt and unsupported SPDs, and the JEDEC rounding.
+*
+* @param[in] spd_ptr - valid SPD image
+* @param[in] len     - image length
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_errors(const UINT8 *spd_ptr, UINT32 len)
+{
+    exp_ddr_ctrlr_spd_struct info;
+    exp_ddr_ctrlr_spd_config_struct config;
+    exp_ddr_ctrlr_spd_config_struct ref;
+    UINT8 spd[EXP_DDR_CTRLR_SPD_BASE_SIZE];
+    UINT32 crc;
+    UINT32 i;
+    UINT32 j;
+
+    memcpy(spd, spd_ptr, sizeof(spd));
+
+    /* short, bad CRC, not DDR4 */
+    HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_LEN == exp_ddr_ctrlr_spd_parse(spd, sizeof(spd) - 1, &info));
+    spd[TEST_SPD_CRC] ^= 1;
+    HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_CRC == exp_ddr_ctrlr_spd_parse(spd, sizeof(spd), &info));
+    spd[TEST_SPD_CRC] ^= 1;
+
+    /* recompute the CRC after each change, as a DIMM would carry it */
+    spd[TEST_SPD_DRAM_TYPE] = 0x0B;
+    for (crc = 0, i = 0; i < TEST_SPD_CRC; i++)
+    {
+        crc ^= (UINT32)spd[i] << 8;
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    spd[TEST_SPD_CRC] = crc & 0xFF;
+    spd[TEST_SPD_CRC + 1] = (crc >> 8) & 0xFF;
+    HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_DRAM_TYPE == exp_ddr_ctrlr_spd_parse(spd, sizeof(spd), &info));
+
+    /* no CAS latency meets tAA */
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_parse(spd_ptr, len, &info));
+    info.cl_mask &= (1 << (18 - info.cl_base)) - 1;
+    HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_CAS_LATENCY == exp_ddr_ctrlr_spd_timing_calc(&info, 2666, &config, NULL));
+
+    /* not a speed bin */
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_parse(spd_ptr, len, &info));
+    HOST_CHECK(EXP_DDR_CTRLR_SPD_ERR_DATA_RATE == exp_ddr_ctrlr_spd_timing_calc(&info, 2600, &config, NULL));
+
+    /* each differing field is counted */
+    HOST_CHECK(PMC_SUCCESS == exp_ddr_ctrlr_spd_timing_calc(&info, 2666, &config, NULL));
+    ref = config;
+    ref.cl++;
+    ref.tRFC1 = 0;
+    HOST_CHECK(2 == exp_ddr_ctrlr_spd_config_compare(&config, &ref));
+
+    /*
+    ** JEDEC rounding: 15 clocks of 937.5 ps is 14.06 ns in the SPD, which
+    ** is 15.005 clocks of the truncated tCK of 937 ps
+    */
+    HOST_CHECK(15 == exp_ddr_ctrlr_spd_ps_to_clk(14060, 937));
+    HOST_CHECK(16 == exp_ddr_ctrlr_spd_ps_to_clk(14100, 937));
+    HOST_CHECK(20 == exp_ddr_ctrlr_spd_ps_to_clk(15000, 750));
+    HOST_CHECK(21 == exp_ddr_ctrlr_spd_ps_to_clk(15020, 750));
+}
+
+/**
+* @brief
+*   Check an SPD image, named after its table entry.
+*
+* @param[in] path_ptr - image file
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_file(const CHAR *path_ptr)
+{
+    const CHAR *name_ptr = strrchr(path_ptr, '/');
+    UINT8 *spd_ptr;
+    UINT32 len;
+    UINT32 i;
+
+    name_ptr = (NULL == name_ptr) ? path_ptr : (name_ptr + 1);
+
+    spd_ptr = host_file_read(path_ptr, &len);
+    if (NULL == spd_ptr)
+    {
+        HOST_CHECK(FALSE);
+        return;
+    }
+
+    for (i = 0; i < (sizeof(test_dimm) / sizeof(test_dimm[0])); i++)
+    {
+        if ((0 == strncmp(name_ptr, test_dimm[i].name_ptr, strlen(test_dimm[i].name_ptr))) &&
+            (0 == strcmp(&name_ptr[strlen(test_dimm[i].name_ptr)], ".bin")))
+        {
+            test_dimm_check(spd_ptr, len, &test_dimm[i]);
+            test_dimm[i].found = TRUE;
+
+            /* test_dimm[] names are those of the images */
+            test_table_check(spd_ptr, len, test_dimm[i].name_ptr);
+
+            if (0 == strcmp(test_dimm[i].name_ptr, "udimm_x8_1r_2666"))
+            {
+                test_errors(spd_ptr, len);
+            }
+            break;
+        }
+    }
+
+    if (i == (sizeof(test_dimm) / sizeof(test_dimm[0])))
+    {
+        printf("  %s: no expected values\n", name_ptr);
+        HOST_CHECK(FALSE);
+    }
+
+    free(spd_ptr);
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        test_file(argv[arg]);
+    }
+
+    for (i = 0; i < (sizeof(test_dimm) / sizeof(test_dimm[0])); i++)
+    {
+        if (FALSE == test_dimm[i].found)
+        {
+            printf("  %s.bin not given\n", test_dimm[i].name_ptr);
+        }
+        HOST_CHECK(TRUE == test_dimm[i].found);
+    }
+
+    /* every table entry has its image */
+    HOST_CHECK(((1 << (sizeof(test_table) / sizeof(test_table[0]))) - 1) == test_table_found);
+
+    printf("%u SPD images decoded\n", (unsigned)(argc - 1));
+
+    return host_test_result("test_exp_ddr_ctrlr_spd");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
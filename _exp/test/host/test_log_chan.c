@@ -0,0 +1,424 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test of the log channels of log_chan.c.
+*
+* @note
+*   The CCBs are replaced by a model that keeps the last bytes written,
+*   and log_chan_get() returns them oldest first, starting with the tail
+*   of a record once the channel wrapped. The test includes log_chan.c to
+*   start the sequence number just below its wrap.
+*
+*   - Messages of both VPEs, nested channels and the crash channel must
+*     be read back merged in the order they were printed.
+*   - A message printed in pieces stays on one line, unless a message of
+*     another channel comes between the pieces.
+*   - Channels that wrapped many times must read back the records they
+*     still hold in full, merged in sequence order, and the read-out must
+*     be cut at the newest end.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "host_test.h"
+#include "log_chan.c"
+
+/*
+** Local Constants
+*/
+
+/* CCB model */
+#define TEST_CCB_MAX                LOG_CHAN_NUM
+#define TEST_CCB_SIZE_MAX           (4 * 1024)
+
+/* Messages of the wrap test, and the text of the longest one */
+#define TEST_WRAP_MSGS              2000
+#define TEST_WRAP_TEXT_MAX          80
+
+/* Merged read-out */
+#define TEST_OUT_SIZE               (16 * 1024)
+
+/*
+** Local Structures and Unions
+*/
+
+/**
+* @brief
+*   CCB model, keeps the last size bytes written.
+*/
+typedef struct
+{
+    CHAR   buf[TEST_CCB_SIZE_MAX];  /**< Contents, circular */
+    UINT32 size;                    /**< Size of the CCB */
+    UINT32 wr;                      /**< Index of the next byte written, the oldest byte */
+} test_ccb_struct;
+
+/**
+* @brief
+*   Message printed by the wrap test.
+*/
+typedef struct
+{
+    UINT32 seq;                         /**< Sequence number of the record */
+    UINT8  chan;                        /**< Channel */
+    UINT32 end;                         /**< Bytes written to the channel up to the end of the record */
+    UINT32 len;                         /**< Record length */
+    CHAR   text[TEST_WRAP_TEXT_MAX];    /**< Message */
+} test_msg_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE test_ccb_struct test_ccb[TEST_CCB_MAX];
+PRIVATE UINT32 test_ccb_num;
+PRIVATE UINT32 test_vpe;
+
+PRIVATE test_msg_struct test_msg[TEST_WRAP_MSGS];
+PRIVATE CHAR test_scratch[LOG_CHAN_TOTAL_SIZE];
+PRIVATE CHAR test_out[TEST_OUT_SIZE];
+PRIVATE CHAR test_expect[TEST_OUT_SIZE];
+
+/*
+** Firmware Replacements
+*/
+
+PUBLIC void *ccb_buffer_init(UINT32 buffer_size)
+{
+    test_ccb_struct *ccb_ptr = &test_ccb[test_ccb_num++];
+
+    PMCFW_ASSERT((test_ccb_num <= TEST_CCB_MAX) && (buffer_size <= TEST_CCB_SIZE_MAX), PMCFW_ERR_FAIL);
+    memset(ccb_ptr, 0, sizeof(*ccb_ptr));
+    ccb_ptr->size = buffer_size;
+
+    return ccb_ptr;
+}
+
+PUBLIC void ccb_put(void *ccb_ctrl_ptr, const CHAR* data_buffer, UINT32 data_size)
+{
+    test_ccb_struct *ccb_ptr = (test_ccb_struct *)ccb_ctrl_ptr;
+    UINT32 i;
+
+    for (i = 0; i < data_size; i++)
+    {
+        ccb_ptr->buf[ccb_ptr->wr] = data_buffer[i];
+        ccb_ptr->wr = (ccb_ptr->wr + 1) % ccb_ptr->size;
+    }
+}
+
+PUBLIC UINT32 ccb_info_get(void *ccb_ctrl_ptr, void **addr_pptr)
+{
+    test_ccb_struct *ccb_ptr = (test_ccb_struct *)ccb_ctrl_ptr;
+
+    *addr_pptr = ccb_ptr->buf;
+
+    return ccb_ptr->size;
+}
+
+PUBLIC UINT32 ccb_get(void *ccb_ctrl_ptr, CHAR *dst_ptr, UINT32 num_bytes_requested)
+{
+    test_ccb_struct *ccb_ptr = (test_ccb_struct *)ccb_ctrl_ptr;
+    UINT32 len = min(num_bytes_requested, ccb_ptr->size);
+    UINT32 i;
+
+    for (i = 0; i < len; i++)
+    {
+        dst_ptr[i] = ccb_ptr->buf[(ccb_ptr->wr + i) % ccb_ptr->size];
+    }
+
+    return len;
+}
+
+PUBLIC UINT32 hal_sys_cpu_id_get(VOID)
+{
+    return test_vpe;
+}
+
+PUBLIC UINT8 *crash_dump_plat_ram_buf_wr_ptr_get(void)
+{
+    return NULL;
+}
+
+PUBLIC void crash_dump_plat_ram_buf_wr_ptr_update(UINT32 size)
+{
+}
+
+PUBLIC PMCFW_ERROR crash_dump_register(crash_dump_set_id_enum cd_set_id,
+                                       char *name,
+                                       crash_dump_function_ptr *dump_fcn,
+                                       crash_dump_type type,
+                                       UINT32 dump_size)
+{
+    return PMC_SUCCESS;
+}
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Start with empty channels, in the boot channel on both VPEs.
+*
+* @param[in] seq - sequence number of the first record
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_init(UINT32 seq)
+{
+    test_ccb_num = 0;
+    test_vpe = 0;
+    log_chan_cur[0] = LOG_CHAN_NONE;
+    log_chan_cur[1] = LOG_CHAN_NONE;
+    log_chan_default = LOG_CHAN_BOOT;
+    log_chan_next_seq = seq;
+    memset(log_chan_ccb_ctrl, 0, sizeof(log_chan_ccb_ctrl));
+    log_chan_init();
+}
+
+/**
+* @brief
+*   Print a message, as bc_printf() does.
+*
+* @param[in] vpe    - VPE printing it
+* @param[in] text   - message
+* @param[in] crash  - printed on the crash channel
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_put(UINT32 vpe, const CHAR *text, BOOL crash)
+{
+    test_vpe = vpe;
+    log_chan_put(text, (UINT32)strlen(text), crash);
+}
+
+/**
+* @brief
+*   Read the merged channels and compare them with the expected text.
+*
+* @param[in] expect - expected read-out
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_read_check(const CHAR *expect)
+{
+    UINT32 len;
+
+    memset(test_out, 0, sizeof(test_out));
+    len = log_chan_read(test_out, sizeof(test_out), test_scratch, sizeof(test_scratch));
+
+    HOST_CHECK(strlen(expect) == len);
+    if (0 != strcmp(expect, test_out))
+    {
+        HOST_CHECK(0 == strcmp(expect, test_out));
+        printf("expected:\n%s\nread:\n%s\n", expect, test_out);
+    }
+}
+
+/**
+* @brief
+*   Messages of both VPEs in nested channels, merged in print order.
+*
+* @param[in] seq - sequence number of the first record
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_merge(UINT32 seq)
+{
+    UINT8 prev0;
+    UINT8 prev1;
+    UINT8 prev2;
+
+    test_init(seq);
+
+    test_put(0, "boot 0\n", FALSE);
+    prev0 = log_chan_enter(LOG_CHAN_DDR);
+    test_put(0, "ddr 0\n", FALSE);
+
+    /* the other VPE prints in its own channel */
+    test_vpe = 1;
+    prev1 = log_chan_enter(LOG_CHAN_ECH);
+    test_put(1, "ech 0\n", FALSE);
+    test_put(0, "ddr 1\n", FALSE);
+
+    /* a nested channel, restored on exit */
+    test_vpe = 0;
+    prev2 = log_chan_enter(LOG_CHAN_FLASH);
+    test_put(0, "flash 0\n", FALSE);
+    log_chan_exit(prev2);
+    test_put(0, "ddr 2\n", FALSE);
+
+    /* the crash channel goes to the fatal channel */
+    test_put(1, "fatal 0\n", TRUE);
+    test_put(1, "ech 1\n", FALSE);
+
+    test_vpe = 1;
+    log_chan_exit(prev1);
+    test_vpe = 0;
+    log_chan_exit(prev0);
+    test_put(0, "boot 1\n", FALSE);
+
+    /* after boot, messages outside any channel are not kept */
+    log_chan_boot_done();
+    test_put(0, "dropped\n", FALSE);
+    test_put(1, "dropped\n", FALSE);
+
+    test_read_check("[boot] boot 0\n"
+                    "[ddr] ddr 0\n"
+                    "[ech] ech 0\n"
+                    "[ddr] ddr 1\n"
+                    "[flash] flash 0\n"
+                    "[ddr] ddr 2\n"
+                    "[fatal] fatal 0\n"
+                    "[ech] ech 1\n"
+                    "[boot] boot 1\n");
+}
+
+/**
+* @brief
+*   Messages printed in pieces.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_pieces(VOID)
+{
+    test_init(0);
+
+    test_put(0, "training ", FALSE);
+    test_put(0, "rank 0 ", FALSE);
+    test_put(0, "done\n", FALSE);
+
+    /* a piece of another channel in between ends the line */
+    test_put(0, "serdes ", FALSE);
+    test_put(0, "fatal\n", TRUE);
+    test_put(0, "lane 3\nsecond line\n", FALSE);
+
+    test_read_check("[boot] training rank 0 done\n"
+                    "[boot] serdes \n"
+                    "[fatal] fatal\n"
+                    "[boot] lane 3\n"
+                    "[boot] second line\n");
+}
+
+/**
+* @brief
+*   Wrap the channels many times. Each channel must read back the records
+*   it holds in full, merged in sequence order, and a read-out too small
+*   for the log must be its oldest part.
+*
+* @param[in] seq - sequence number of the first record
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_wrap(UINT32 seq)
+{
+    static const UINT8 chans[] = { LOG_CHAN_BOOT, LOG_CHAN_DDR, LOG_CHAN_DDR, LOG_CHAN_DDR, LOG_CHAN_SERDES, LOG_CHAN_ECH };
+    UINT32 written[LOG_CHAN_NUM];
+    test_msg_struct *msg_ptr;
+    UINT32 expect_len = 0;
+    UINT32 kept = 0;
+    UINT32 len;
+    UINT32 i;
+    UINT32 j;
+    UINT8 prev;
+
+    test_init(seq);
+    memset(written, 0, sizeof(written));
+    host_srand(seq);
+
+    for (i = 0; i < TEST_WRAP_MSGS; i++)
+    {
+        msg_ptr = &test_msg[i];
+        msg_ptr->seq = seq + i;
+        msg_ptr->chan = chans[host_rand() % sizeof(chans)];
+        snprintf(msg_ptr->text, sizeof(msg_ptr->text), "msg %u %.*s\n",
+                 (unsigned)i, (int)(host_rand() % 40), "........................................");
+        msg_ptr->len = LOG_CHAN_REC_HDR_SIZE + (UINT32)strlen(msg_ptr->text);
+        written[msg_ptr->chan] += msg_ptr->len;
+        msg_ptr->end = written[msg_ptr->chan];
+
+        prev = log_chan_enter(msg_ptr->chan);
+        test_put(0, msg_ptr->text, FALSE);
+        log_chan_exit(prev);
+    }
+
+    /* a record is kept while all of it is in the last size bytes of its channel */
+    test_expect[0] = '\0';
+    for (i = 0; i < TEST_WRAP_MSGS; i++)
+    {
+        msg_ptr = &test_msg[i];
+        if ((written[msg_ptr->chan] - (msg_ptr->end - msg_ptr->len)) <= log_chan_size[msg_ptr->chan])
+        {
+            expect_len += (UINT32)snprintf(&test_expect[expect_len], sizeof(test_expect) - expect_len,
+                                           "[%s] %s", log_chan_name[msg_ptr->chan], msg_ptr->text);
+            kept++;
+        }
+    }
+    HOST_CHECK(expect_len < sizeof(test_expect));
+    HOST_CHECK(kept > 0);
+    for (j = 0; j < LOG_CHAN_NUM; j++)
+    {
+        HOST_CHECK((0 == written[j]) || (LOG_CHAN_BOOT == j) || (written[j] > (4 * log_chan_size[j])));
+    }
+    test_read_check(test_expect);
+
+    /* a read-out too small keeps the oldest part */
+    for (i = 1; i < expect_len; i += 97)
+    {
+        memset(test_out, 0, sizeof(test_out));
+        len = log_chan_read(test_out, i, test_scratch, sizeof(test_scratch));
+        HOST_CHECK(len <= i);
+        HOST_CHECK(0 == memcmp(test_out, test_expect, len));
+        HOST_CHECK((i - len) < TEST_WRAP_TEXT_MAX);
+    }
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    test_merge(0);
+    test_merge(0xFFFFFFFC);
+    test_pieces();
+    test_wrap(1);
+    test_wrap(0xFFFFFF00);
+
+    printf("log channels: %u records merged across %u channels\n", (unsigned)TEST_WRAP_MSGS, (unsigned)LOG_CHAN_NUM);
+
+    return host_test_result("test_log_chan");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,302 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Power fail test of the flash log journal on the RAM flash model.
+*
+* @note
+*   A reference run appends a fixed series of random sized blocks to a
+*   four subsector journal, so it wraps, and counts the flash operations.
+*   The run is then repeated with the power cut at every erase and page
+*   program. After each cut the journal is mounted from flash and must
+*   hold a contiguous tail of the data appended, ending within the append
+*   that was interrupted, and at least the data the reference run kept
+*   from before that append. A further append must follow it.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "spi_flash_plat.h"
+#include "log_journal.h"
+#include "host_test.h"
+#include "host_flash.h"
+
+/*
+** Local Constants
+*/
+
+#define TEST_JOURNAL_ADDR           SPI_FLASH_FW_IMG_A_CFG_LOG_JOURNAL_ADDR
+#define TEST_JOURNAL_SIZE           (4 * LOG_JOURNAL_SUBSECTOR_SIZE)
+
+/* Appends per run and the largest one, which spans two records */
+#define TEST_APPENDS                48
+#define TEST_APPEND_MAX             6000
+
+#define TEST_STREAM_MAX             (TEST_APPENDS * TEST_APPEND_MAX)
+
+/* Append made after recovery */
+#define TEST_TAIL_LEN               100
+
+/*
+** Private Data
+*/
+
+PRIVATE log_journal_struct test_journal;
+PRIVATE UINT8 test_stream[TEST_STREAM_MAX];
+PRIVATE UINT8 test_tail[TEST_TAIL_LEN];
+PRIVATE UINT32 test_len[TEST_APPENDS];
+PRIVATE UINT32 test_end[TEST_APPENDS];
+PRIVATE UINT32 test_ref_size[TEST_APPENDS];
+PRIVATE UINT8 test_read_buf[TEST_JOURNAL_SIZE];
+PRIVATE UINT8 test_read2_buf[TEST_JOURNAL_SIZE];
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Power up: forget the journal state and read the whole journal from
+*   flash.
+*
+* @param[out] buf_ptr - journal contents, TEST_JOURNAL_SIZE bytes
+*
+* @return
+*   Journal size in bytes.
+*/
+PRIVATE UINT32 test_mount_read(UINT8 *buf_ptr)
+{
+    UINT32 size;
+
+    memset(&test_journal, 0xA5, sizeof(test_journal));
+    log_journal_init(&test_journal, TEST_JOURNAL_ADDR, TEST_JOURNAL_SIZE, spi_flash_plat_erase);
+
+    size = log_journal_size_get(&test_journal);
+    HOST_CHECK(size <= TEST_JOURNAL_SIZE);
+    if (size > TEST_JOURNAL_SIZE)
+    {
+        return 0;
+    }
+
+    HOST_CHECK(PMC_SUCCESS == log_journal_read(&test_journal, buf_ptr, 0, size));
+    HOST_CHECK(LOG_JOURNAL_ERR_RANGE == log_journal_read(&test_journal, buf_ptr, size, 1));
+
+    return size;
+}
+
+/**
+* @brief
+*   Erase the journal and append the test series.
+*
+* @param[in] count - number of appends to make
+*
+* @return
+*   Number of appends completed, -1 if the erase failed.
+*/
+PRIVATE INT32 test_append_series(UINT32 count)
+{
+    UINT32 start = 0;
+    UINT32 i;
+
+    log_journal_init(&test_journal, TEST_JOURNAL_ADDR, TEST_JOURNAL_SIZE, spi_flash_plat_erase);
+
+    if (PMC_SUCCESS != log_journal_erase(&test_journal))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (PMC_SUCCESS != log_journal_append(&test_journal, &test_stream[start], test_len[i]))
+        {
+            return (INT32)i;
+        }
+        start = test_end[i];
+    }
+
+    return (INT32)count;
+}
+
+/**
+* @brief
+*   Reference run without power cuts. Records the journal size after each
+*   append and checks the journal always holds a tail of the stream.
+*
+* @return
+*   Number of flash operations of the run.
+*/
+PRIVATE UINT32 test_reference(VOID)
+{
+    UINT32 start = 0;
+    UINT32 size;
+    UINT32 i;
+
+    host_flash_reset();
+    log_journal_init(&test_journal, TEST_JOURNAL_ADDR, TEST_JOURNAL_SIZE, spi_flash_plat_erase);
+    HOST_CHECK(PMC_SUCCESS == log_journal_erase(&test_journal));
+    HOST_CHECK(0 == log_journal_size_get(&test_journal));
+
+    for (i = 0; i < TEST_APPENDS; i++)
+    {
+        HOST_CHECK(PMC_SUCCESS == log_journal_append(&test_journal, &test_stream[start], test_len[i]));
+        start = test_end[i];
+
+        size = log_journal_size_get(&test_journal);
+        test_ref_size[i] = size;
+        HOST_CHECK((size >= test_len[i]) && (size <= start));
+        HOST_CHECK(PMC_SUCCESS == log_journal_read(&test_journal, test_read_buf, 0, size));
+        HOST_CHECK(0 == memcmp(test_read_buf, &test_stream[start - size], size));
+    }
+
+    /* the journal wrapped */
+    HOST_CHECK(test_ref_size[TEST_APPENDS - 1] < start);
+
+    /* a remount finds the same data */
+    size = test_ref_size[TEST_APPENDS - 1];
+    HOST_CHECK(size == test_mount_read(test_read2_buf));
+    HOST_CHECK(0 == memcmp(test_read_buf, test_read2_buf, size));
+
+    return host_flash_op_count();
+}
+
+/**
+* @brief
+*   Run the series with the power cut at one flash operation and check
+*   what the journal holds after power up.
+*
+* @param[in] cut - number of operations completed before the cut
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_cut(UINT32 cut)
+{
+    INT32 done;
+    UINT32 acked;
+    UINT32 attempted;
+    UINT32 required;
+    UINT32 size;
+    UINT32 size2;
+    UINT32 end;
+    BOOL found = FALSE;
+
+    host_flash_reset();
+    host_flash_power_cut_set(cut);
+    done = test_append_series(TEST_APPENDS);
+    HOST_CHECK(TRUE == host_flash_power_is_off());
+    HOST_CHECK(done < TEST_APPENDS);
+    host_flash_power_on();
+
+    size = test_mount_read(test_read_buf);
+
+    if (done < 0)
+    {
+        /* the journal erase was interrupted */
+        acked = 0;
+        attempted = 0;
+        required = 0;
+    }
+    else
+    {
+        acked = (0 == done) ? 0 : test_end[done - 1];
+        attempted = test_end[done];
+        required = acked;
+        if (test_ref_size[done] > test_len[done])
+        {
+            required = acked - (test_ref_size[done] - test_len[done]);
+        }
+    }
+
+    /* a tail of the stream ending within the interrupted append */
+    HOST_CHECK(size <= attempted);
+    for (end = acked; (FALSE == found) && (end <= attempted); end++)
+    {
+        found = ((size <= end) && (0 == memcmp(test_read_buf, &test_stream[end - size], size)));
+    }
+    end--;
+    HOST_CHECK(TRUE == found);
+
+    /* nothing the reference run kept from before the append is lost */
+    if (TRUE == found)
+    {
+        HOST_CHECK((end - size) <= required);
+    }
+
+    /* appending resumes after the recovered data */
+    HOST_CHECK(PMC_SUCCESS == log_journal_append(&test_journal, test_tail, TEST_TAIL_LEN));
+    size2 = test_mount_read(test_read2_buf);
+    HOST_CHECK((size2 >= TEST_TAIL_LEN) && ((size2 - TEST_TAIL_LEN) <= size));
+    if ((size2 >= TEST_TAIL_LEN) && ((size2 - TEST_TAIL_LEN) <= size))
+    {
+        HOST_CHECK(0 == memcmp(&test_read2_buf[size2 - TEST_TAIL_LEN], test_tail, TEST_TAIL_LEN));
+        HOST_CHECK(0 == memcmp(test_read2_buf, &test_read_buf[size - (size2 - TEST_TAIL_LEN)], size2 - TEST_TAIL_LEN));
+    }
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    UINT32 ops;
+    UINT32 start = 0;
+    UINT32 cut;
+    UINT32 i;
+
+    host_srand(0);
+
+    for (i = 0; i < TEST_APPENDS; i++)
+    {
+        test_len[i] = (0 == (host_rand() % 4)) ? (1 + (host_rand() % TEST_APPEND_MAX)) : (1 + (host_rand() % 300));
+        test_end[i] = start + test_len[i];
+        start = test_end[i];
+    }
+    for (i = 0; i < start; i++)
+    {
+        test_stream[i] = (UINT8)host_rand();
+    }
+    for (i = 0; i < TEST_TAIL_LEN; i++)
+    {
+        test_tail[i] = (UINT8)host_rand();
+    }
+
+    ops = test_reference();
+
+    for (cut = 0; cut < ops; cut++)
+    {
+        test_cut(cut);
+    }
+
+    printf("log journal: %u bytes appended, %u kept, power cut at each of %u flash operations\n",
+           (unsigned)start, (unsigned)test_ref_size[TEST_APPENDS - 1], (unsigned)ops);
+
+    return host_test_result("test_log_journal");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
@@ -0,0 +1,300 @@
+/********************************************************************************
+* MICROCHIP PM8596 EXPLORER FIRMWARE
+*
+* Copyright (c) 2021 Microchip Technology Inc. All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not
+* use this file except in compliance with the License. You may obtain a copy of
+* the License at http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+* WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+* License for the specific language governing permissions and limitations under
+* the License.
+********************************************************************************/
+
+
+/**
+* @addtogroup HOST_TEST
+* @{
+* @file
+* @brief
+*   Host test and benchmark of the streaming LZ decoder used by compressed
+*   firmware upgrades.
+*
+* @note
+*   Usage: test_lz_decomp <raw file> <packed file> [<raw file> <packed file> ...]
+*
+*   The packed files are written by fw_image_pack.py. Each one is decoded
+*   with input and output split at random points, as the flashloader sees
+*   it packet by packet, and must match the raw file. The compression ratio
+*   and the decode throughput with the flashloader's 256 byte page buffer
+*   are reported per file.
+*/
+
+/*
+** Include Files
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pmcfw_common.h"
+#include "lz_decomp.h"
+#include "host_test.h"
+
+/*
+** Local Constants
+*/
+
+/* Header written by fw_image_pack.py */
+#define TEST_PACK_MAGIC             "EXPZ"
+#define TEST_PACK_HDR_SIZE          16
+
+/* Page buffer of flashloader_plat_flash_buffer_write() */
+#define TEST_PAGE_SIZE              256
+
+/* Output buffer beyond the decoded length */
+#define TEST_SLACK                  1024
+
+/* Random split passes per file */
+#define TEST_SPLIT_PASSES           8
+
+/* Minimum decode time per throughput measurement */
+#define TEST_BENCH_NS               200000000ULL
+
+/*
+** Local Structures and Unions
+*/
+
+typedef struct
+{
+    UINT32 window_log2;
+    UINT32 raw_len;
+    UINT32 comp_len;
+    const UINT8 *stream_ptr;
+} test_pack_struct;
+
+/*
+** Private Data
+*/
+
+PRIVATE UINT8 test_window[1 << 16];
+
+/*
+** Private Functions
+*/
+
+/**
+* @brief
+*   Parse the header of a packed image.
+*
+* @param[in]  buf_ptr  - packed image
+* @param[in]  len      - packed image length
+* @param[out] pack_ptr - header fields
+*
+* @return
+*   TRUE if the header is valid.
+*/
+PRIVATE BOOL test_pack_parse(const UINT8 *buf_ptr, UINT32 len, test_pack_struct *pack_ptr)
+{
+    if ((len < TEST_PACK_HDR_SIZE) || (0 != memcmp(buf_ptr, TEST_PACK_MAGIC, 4)))
+    {
+        return FALSE;
+    }
+
+    pack_ptr->window_log2 = buf_ptr[5];
+    memcpy(&pack_ptr->raw_len, &buf_ptr[8], sizeof(UINT32));
+    memcpy(&pack_ptr->comp_len, &buf_ptr[12], sizeof(UINT32));
+    pack_ptr->stream_ptr = &buf_ptr[TEST_PACK_HDR_SIZE];
+
+    return ((pack_ptr->window_log2 <= 16) && (pack_ptr->comp_len <= (len - TEST_PACK_HDR_SIZE)));
+}
+
+/**
+* @brief
+*   Decode a stream fed in chunks into an output buffer filled in chunks.
+*
+* @param[in]  pack_ptr  - packed image
+* @param[out] out_ptr   - decoded image
+* @param[in]  out_cap   - size of out_ptr, more than raw_len so that an
+*                         overrun can be seen
+* @param[in]  in_chunk  - maximum input chunk, 0 for random chunks
+* @param[in]  out_chunk - maximum output chunk, 0 for random chunks
+*
+* @return
+*   Final decoder status.
+*/
+PRIVATE lz_decomp_status_enum test_decode(const test_pack_struct *pack_ptr,
+                                          UINT8 *out_ptr,
+                                          UINT32 out_cap,
+                                          UINT32 in_chunk,
+                                          UINT32 out_chunk)
+{
+    lz_decomp_struct ctx;
+    lz_decomp_status_enum status = LZ_DECOMP_STATUS_NEED_INPUT;
+    const UINT8 *in_ptr = pack_ptr->stream_ptr;
+    UINT32 in_left = pack_ptr->comp_len;
+    UINT32 out_pos = 0;
+
+    lz_decomp_init(&ctx, test_window, 1 << pack_ptr->window_log2, pack_ptr->raw_len);
+
+    while (LZ_DECOMP_STATUS_DONE != status)
+    {
+        UINT32 in_len = (0 != in_chunk) ? in_chunk : 1 + (host_rand() % 700);
+        UINT32 out_size = (0 != out_chunk) ? out_chunk : 1 + (host_rand() % 300);
+        const UINT8 *chunk_ptr = in_ptr;
+        UINT32 out_len;
+
+        if (in_len > in_left)
+        {
+            in_len = in_left;
+        }
+        if (out_size > (out_cap - out_pos))
+        {
+            out_size = out_cap - out_pos;
+        }
+
+        status = lz_decomp_run(&ctx, &chunk_ptr, &in_len, &out_ptr[out_pos], out_size, &out_len);
+        out_pos += out_len;
+        in_left -= (UINT32)(chunk_ptr - in_ptr);
+        in_ptr = chunk_ptr;
+
+        if ((LZ_DECOMP_STATUS_ERR_OFFSET == status) ||
+            (LZ_DECOMP_STATUS_ERR_OVERRUN == status) ||
+            ((LZ_DECOMP_STATUS_NEED_INPUT == status) && (0 == in_left)) ||
+            ((LZ_DECOMP_STATUS_OUTPUT_FULL == status) && (out_pos == out_cap)))
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+/**
+* @brief
+*   Check and measure the decoding of one packed image.
+*
+* @param[in] raw_name_ptr  - raw file
+* @param[in] pack_name_ptr - packed file
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_file(const CHAR *raw_name_ptr, const CHAR *pack_name_ptr)
+{
+    test_pack_struct pack;
+    UINT32 raw_len = 0;
+    UINT32 pack_len = 0;
+    UINT8 *raw_ptr = host_file_read(raw_name_ptr, &raw_len);
+    UINT8 *pack_ptr = host_file_read(pack_name_ptr, &pack_len);
+    UINT8 *out_ptr;
+    UINT64 start;
+    UINT64 elapsed;
+    UINT32 runs = 0;
+    UINT32 pass;
+
+    if (!HOST_CHECK((NULL != raw_ptr) && (NULL != pack_ptr)) ||
+        !HOST_CHECK(test_pack_parse(pack_ptr, pack_len, &pack)) ||
+        !HOST_CHECK(pack.raw_len == raw_len))
+    {
+        free(raw_ptr);
+        free(pack_ptr);
+        return;
+    }
+
+    out_ptr = malloc(raw_len + TEST_SLACK);
+
+    /* random packet and page boundaries */
+    for (pass = 0; pass < TEST_SPLIT_PASSES; pass++)
+    {
+        memset(out_ptr, 0xA5, raw_len);
+        HOST_CHECK(LZ_DECOMP_STATUS_DONE == test_decode(&pack, out_ptr, raw_len + TEST_SLACK, 0, 0));
+        HOST_CHECK(0 == memcmp(out_ptr, raw_ptr, raw_len));
+    }
+
+    /* throughput with whole packets in and flashloader pages out */
+    start = host_time_ns();
+    do
+    {
+        HOST_CHECK(LZ_DECOMP_STATUS_DONE == test_decode(&pack, out_ptr, raw_len + TEST_SLACK, 4096, TEST_PAGE_SIZE));
+        runs++;
+        elapsed = host_time_ns() - start;
+    } while (elapsed < TEST_BENCH_NS);
+
+    printf("  %-34s %7u -> %8u bytes (%5.1f%%) decode %7.1f MB/s\n",
+           strrchr(raw_name_ptr, '/') ? strrchr(raw_name_ptr, '/') + 1 : raw_name_ptr,
+           (unsigned)raw_len,
+           (unsigned)pack_len,
+           100.0 * pack_len / (raw_len ? raw_len : 1),
+           ((double)raw_len * runs * 1000.0) / (double)elapsed);
+
+    free(out_ptr);
+    free(raw_ptr);
+    free(pack_ptr);
+}
+
+/**
+* @brief
+*   Corrupt streams must be reported, never decoded out of bounds.
+*
+* @return
+*   Nothing
+*/
+PRIVATE VOID test_corrupt(VOID)
+{
+    /* literal 'abcd', then a match at offset 8 before the start of the output */
+    static const UINT8 bad_offset[] = { 0x40, 'a', 'b', 'c', 'd', 0x08, 0x00 };
+    /* offset 0 */
+    static const UINT8 zero_offset[] = { 0x40, 'a', 'b', 'c', 'd', 0x00, 0x00 };
+    /* literal run longer than the expected output */
+    static const UINT8 overrun[] = { 0x80, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+    test_pack_struct pack;
+    UINT8 out[64];
+
+    pack.window_log2 = 12;
+    pack.raw_len = 12;
+
+    pack.stream_ptr = bad_offset;
+    pack.comp_len = sizeof(bad_offset);
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OFFSET == test_decode(&pack, out, sizeof(out), 1, 1));
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OFFSET == lz_decomp_buf(bad_offset, sizeof(bad_offset), NULL, 0, out, 12));
+
+    pack.stream_ptr = zero_offset;
+    pack.comp_len = sizeof(zero_offset);
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OFFSET == test_decode(&pack, out, sizeof(out), 7, 64));
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OFFSET == lz_decomp_buf(zero_offset, sizeof(zero_offset), NULL, 0, out, 12));
+
+    pack.stream_ptr = overrun;
+    pack.comp_len = sizeof(overrun);
+    pack.raw_len = 4;
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OVERRUN == test_decode(&pack, out, sizeof(out), 9, 64));
+    HOST_CHECK(LZ_DECOMP_STATUS_ERR_OVERRUN == lz_decomp_buf(overrun, sizeof(overrun), NULL, 0, out, 4));
+}
+
+/*
+** Public Functions
+*/
+
+int main(int argc, char **argv)
+{
+    int i;
+
+    host_srand(0);
+
+    test_corrupt();
+
+    for (i = 1; (i + 1) < argc; i += 2)
+    {
+        test_file(argv[i], argv[i + 1]);
+    }
+
+    return host_test_result("test_lz_decomp");
+}
+
+/* End of File */
+
+/** @} end addtogroup */
+